@@ -7,7 +7,10 @@
  * Features:
  *
  * - Texture mapped renderer, like on OS/X with ATSU Drawtext.
- * - Fast due to texture object and display list caching for fast glyph recycling.
+ * - Fast due to a persistent glyph atlas: Rasterized glyphs of all recently used fonts are packed into
+ *   a few shared alpha texture pages, text color is applied via vertex color, so whole strings are drawn
+ *   as one batch of textured quads, and switching fonts, sizes, styles or colors doesn't re-rasterize.
+ * - Small LRU cache of loaded font faces, so alternating between a few fonts doesn't reload them.
  * - Good text layouting.
  * - Supports all Freetype-2 supported fonts, e.g., vectorgraphics TrueType fonts.
  * - Anti-Aliased drawing via Alpha-Blending.
@@ -70,6 +73,11 @@
 // Include all GLFT and QT stuff:
 #include "OGLFT.h"
 
+// GL_CLAMP_TO_EDGE is OpenGL 1.2, which some old gl.h headers don't define:
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+
 // Include fontconfig stuff:
 #include "fontconfig/fontconfig.h"
 #include "fontconfig/fcfreetype.h"
@@ -89,10 +97,238 @@ double _fontSize = 0.0;
 GLfloat _fgcolor[4];
 GLfloat _bgcolor[4];
 
+// Currently selected font face, owned by the face cache below:
 OGLFT::TranslucentTexture	*faceT = NULL;
 OGLFT::MonochromeTexture	*faceM = NULL;
 static FT_Face ft_face = NULL;
 
+// Maximum number of font faces kept loaded in the LRU face cache:
+#define PSYCH_MAX_CACHED_FACES 8
+
+// Width and height of one glyph atlas texture page, and maximum number of pages:
+#define PSYCH_ATLAS_PAGESIZE 1024
+#define PSYCH_MAX_ATLAS_PAGES 4
+
+// Fonts with a pixel size above this don't use the atlas, but get drawn by OGLFT directly:
+#define PSYCH_MAX_ATLAS_FONTSIZE 192
+
+// One loaded font face, together with the settings it was created for:
+typedef struct PsychFaceCacheEntry {
+	char						fontName[4096];
+	unsigned int				fontStyle;
+	double						fontSize;
+	int							antiAliasing;
+	bool						useOwnFontmapper;
+	unsigned int				faceId;
+	unsigned int				lastUse;
+	FT_Face						ft_face;
+	OGLFT::TranslucentTexture	*faceT;
+	OGLFT::MonochromeTexture	*faceM;
+} PsychFaceCacheEntry;
+
+// One glyph in the atlas: Quad corners relative to the pen position, texture
+// coordinates within its atlas page and pen advance. page is -1 for empty glyphs
+// like spaces, which only advance the pen:
+typedef struct PsychAtlasGlyph {
+	int		page;
+	GLfloat	x0, y0, x1, y1;
+	GLfloat	s0, t0, s1, t1;
+	GLfloat	advx, advy;
+} PsychAtlasGlyph;
+
+// Glyphs are keyed by faceId of their face cache entry (font, size, style, antialiasing) and glyph index:
+typedef std::map< std::pair<unsigned int, FT_UInt>, PsychAtlasGlyph > PsychGlyphMap;
+
+static PsychFaceCacheEntry	_faceCache[PSYCH_MAX_CACHED_FACES];
+static int					_faceCacheCount = 0;
+static unsigned int			_faceUseCounter = 0;
+static unsigned int			_nextFaceId = 1;
+static unsigned int			_currentFaceId = 0;
+
+static PsychGlyphMap		_glyphAtlas;
+static GLuint				_atlasPages[PSYCH_MAX_ATLAS_PAGES];
+static int					_atlasPageCount = 0;
+static int					_atlasCurrentPage = 0;
+static int					_atlasPenX = 0;
+static int					_atlasPenY = 0;
+static int					_atlasRowHeight = 0;
+static std::vector<GLfloat>	_atlasBatch[PSYCH_MAX_ATLAS_PAGES];
+static std::vector<GLubyte>	_atlasScratch;
+
+// Release all font and OpenGL resources of face cache entry 'slot':
+static void PsychReleaseCachedFace(int slot)
+{
+	PsychFaceCacheEntry *entry = &_faceCache[slot];
+	PsychGlyphMap::iterator it;
+
+	if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: Destroying cached font face %s, size %f, style %i.\n", entry->fontName, (float) entry->fontSize, entry->fontStyle);
+
+	if (entry->faceT) delete(entry->faceT);
+	entry->faceT = NULL;
+
+	if (entry->faceM) delete(entry->faceM);
+	entry->faceM = NULL;
+
+	if (entry->ft_face) FT_Done_Face(entry->ft_face);
+	entry->ft_face = NULL;
+
+	// Drop its glyphs from the atlas. Their space in the atlas pages is only
+	// reclaimed once the atlas runs full and gets reset:
+	for (it = _glyphAtlas.begin(); it != _glyphAtlas.end();) {
+		if (it->first.first == entry->faceId) {
+			_glyphAtlas.erase(it++);
+		}
+		else {
+			++it;
+		}
+	}
+
+	if (entry->faceId == _currentFaceId) {
+		faceT = NULL;
+		faceM = NULL;
+		ft_face = NULL;
+		_currentFaceId = 0;
+	}
+
+	entry->faceId = 0;
+}
+
+// Forget all glyphs in the atlas and restart packing at the first page. The
+// texture pages themselves are kept for reuse:
+static void PsychResetGlyphAtlas(void)
+{
+	_glyphAtlas.clear();
+	_atlasCurrentPage = 0;
+	_atlasPenX = 0;
+	_atlasPenY = 0;
+	_atlasRowHeight = 0;
+}
+
+// Find space for a w x h pixels glyph in the atlas, creating new pages as needed.
+// Returns page index and position in *x, *y, or -1 if the atlas is full:
+static int PsychPackAtlasGlyph(int w, int h, int* x, int* y)
+{
+	// Next row if glyph doesn't fit into the current one, next page if no row left.
+	// One pixel of padding around each glyph avoids sampling of neighbouring glyphs:
+	if (_atlasPenX + w + 1 > PSYCH_ATLAS_PAGESIZE) {
+		_atlasPenX = 0;
+		_atlasPenY += _atlasRowHeight;
+		_atlasRowHeight = 0;
+	}
+
+	if (_atlasPenY + h + 1 > PSYCH_ATLAS_PAGESIZE) {
+		if (_atlasCurrentPage + 1 >= PSYCH_MAX_ATLAS_PAGES) return(-1);
+		_atlasCurrentPage++;
+		_atlasPenX = 0;
+		_atlasPenY = 0;
+		_atlasRowHeight = 0;
+	}
+
+	// Need to create the page texture first?
+	if (_atlasCurrentPage >= _atlasPageCount) {
+		// Create a cleared alpha texture, so the padding is transparent:
+		_atlasScratch.assign(PSYCH_ATLAS_PAGESIZE * PSYCH_ATLAS_PAGESIZE, 0);
+		glGenTextures(1, &_atlasPages[_atlasPageCount]);
+		glBindTexture(GL_TEXTURE_2D, _atlasPages[_atlasPageCount]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, PSYCH_ATLAS_PAGESIZE, PSYCH_ATLAS_PAGESIZE, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &_atlasScratch[0]);
+		_atlasPageCount++;
+		if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: Created glyph atlas page %i.\n", _atlasPageCount);
+	}
+
+	*x = _atlasPenX + 1;
+	*y = _atlasPenY + 1;
+	_atlasPenX += w + 1;
+	if (h + 1 > _atlasRowHeight) _atlasRowHeight = h + 1;
+
+	return(_atlasCurrentPage);
+}
+
+// Return atlas entry for glyph 'glyph_index' of the current face, rasterizing
+// and uploading it into the atlas on first use. Returns NULL if the glyph can't
+// be loaded, or if the atlas is full, in which case *atlasFull is set to true:
+static const PsychAtlasGlyph* PsychGetAtlasGlyph(FT_UInt glyph_index, bool* atlasFull)
+{
+	PsychAtlasGlyph glyph;
+	PsychGlyphMap::iterator it;
+	FT_Bitmap *bitmap;
+	int w, h, x, y, r, c;
+
+	*atlasFull = false;
+
+	it = _glyphAtlas.find(std::make_pair(_currentFaceId, glyph_index));
+	if (it != _glyphAtlas.end()) return(&(it->second));
+
+	// Not yet in atlas: Rasterize it, same as OGLFT would do:
+	if (FT_Load_Glyph(ft_face, glyph_index, FT_LOAD_DEFAULT)) return(NULL);
+	if (FT_Render_Glyph(ft_face->glyph, (faceT) ? ft_render_mode_normal : ft_render_mode_mono)) return(NULL);
+
+	bitmap = &(ft_face->glyph->bitmap);
+	w = bitmap->width;
+	h = bitmap->rows;
+
+	glyph.advx = ft_face->glyph->advance.x / 64.f;
+	glyph.advy = ft_face->glyph->advance.y / 64.f;
+	glyph.x0 = (GLfloat) ft_face->glyph->bitmap_left;
+	glyph.y1 = (GLfloat) ft_face->glyph->bitmap_top;
+	glyph.x1 = glyph.x0 + w;
+	glyph.y0 = glyph.y1 - h;
+	glyph.page = -1;
+	glyph.s0 = glyph.t0 = glyph.s1 = glyph.t1 = 0;
+
+	if ((w > 0) && (h > 0) && (w < PSYCH_ATLAS_PAGESIZE) && (h < PSYCH_ATLAS_PAGESIZE)) {
+		glyph.page = PsychPackAtlasGlyph(w, h, &x, &y);
+		if (glyph.page < 0) {
+			*atlasFull = true;
+			return(NULL);
+		}
+
+		// Convert bitmap into a tightly packed 8 bit alpha image. Row 0 is the top of the glyph:
+		_atlasScratch.resize(w * h);
+		for (r = 0; r < h; r++) {
+			for (c = 0; c < w; c++) {
+				if (faceT) {
+					_atlasScratch[r * w + c] = bitmap->buffer[r * bitmap->pitch + c];
+				}
+				else {
+					_atlasScratch[r * w + c] = (bitmap->buffer[r * bitmap->pitch + (c >> 3)] & (0x80 >> (c & 7))) ? 255 : 0;
+				}
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, _atlasPages[glyph.page]);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_ALPHA, GL_UNSIGNED_BYTE, &_atlasScratch[0]);
+
+		glyph.s0 = (GLfloat) x / PSYCH_ATLAS_PAGESIZE;
+		glyph.s1 = (GLfloat) (x + w) / PSYCH_ATLAS_PAGESIZE;
+		glyph.t0 = (GLfloat) y / PSYCH_ATLAS_PAGESIZE;
+		glyph.t1 = (GLfloat) (y + h) / PSYCH_ATLAS_PAGESIZE;
+	}
+
+	_glyphAtlas[std::make_pair(_currentFaceId, glyph_index)] = glyph;
+
+	return(&(_glyphAtlas[std::make_pair(_currentFaceId, glyph_index)]));
+}
+
+// Draw all queued glyph quads, one draw call per used atlas page:
+static void PsychFlushAtlasBatches(void)
+{
+	int i;
+
+	for (i = 0; i < _atlasPageCount; i++) {
+		if (_atlasBatch[i].empty()) continue;
+
+		glBindTexture(GL_TEXTURE_2D, _atlasPages[i]);
+		glVertexPointer(2, GL_FLOAT, 4 * sizeof(GLfloat), &(_atlasBatch[i][0]));
+		glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(GLfloat), &(_atlasBatch[i][2]));
+		glDrawArrays(GL_QUADS, 0, (GLsizei) (_atlasBatch[i].size() / 4));
+		_atlasBatch[i].clear();
+	}
+}
+
 extern "C" {
 
 int PsychInitText(void);
@@ -126,22 +362,52 @@ void PsychSetTextAntiAliasing(int antiAliasing)
 
 int PsychRebuildFont(void)
 {
-	// Destroy old font object, if any:
-	if (faceT || faceM) {
-		// Delete OGLFT face object:
-		if (faceT) delete(faceT);
-		faceT = NULL;
-		
-		if (faceM) delete(faceM);
-		faceM = NULL;
+	int i, slot;
+	PsychFaceCacheEntry *entry;
+
+	// Face for current font settings already loaded and cached?
+	for (i = 0; i < _faceCacheCount; i++) {
+		entry = &_faceCache[i];
+		if ((entry->faceId > 0) && (entry->fontStyle == _fontStyle) && (entry->fontSize == _fontSize) &&
+			(entry->antiAliasing == _antiAliasing) && (entry->useOwnFontmapper == _useOwnFontmapper) &&
+			!strcmp(entry->fontName, _fontName)) {
+			// Yes: Just select it, its glyphs are still in the atlas:
+			faceT = entry->faceT;
+			faceM = entry->faceM;
+			ft_face = entry->ft_face;
+			_currentFaceId = entry->faceId;
+			entry->lastUse = ++_faceUseCounter;
+			_needsRebuild = false;
+
+			return(0);
+		}
+	}
 
-		if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: Destroying old font face...\n");
-		
-		// Delete underlying FreeType representation:
-		FT_Done_Face(ft_face);
-		ft_face = NULL;
+	// No: Need to load a new one. Find a free slot in the cache, or evict the least recently used face:
+	slot = -1;
+	for (i = 0; i < _faceCacheCount; i++) {
+		if (_faceCache[i].faceId == 0) slot = i;
 	}
 
+	if (slot < 0) {
+		if (_faceCacheCount < PSYCH_MAX_CACHED_FACES) {
+			slot = _faceCacheCount++;
+		}
+		else {
+			slot = 0;
+			for (i = 1; i < _faceCacheCount; i++) {
+				if (_faceCache[i].lastUse < _faceCache[slot].lastUse) slot = i;
+			}
+			PsychReleaseCachedFace(slot);
+		}
+	}
+
+	// Deselect current face. It stays alive in the cache:
+	faceT = NULL;
+	faceM = NULL;
+	ft_face = NULL;
+	_currentFaceId = 0;
+
 	if (_useOwnFontmapper) {
 		FcResult result = FcResultMatch; // Must init this due to weirdness in libfontconfig...
 		FcPattern* target = NULL;
@@ -249,6 +515,10 @@ int PsychRebuildFont(void)
 		// Test the created face to make sure it will work correctly:
 		if (!faceT->isValid()) {
 			if (_verbosity > 1) fprintf(stderr, "libptbdrawtext_ftgl: Freetype did not recognize %s as a font file.\n", _fontName);
+			delete(faceT);
+			faceT = NULL;
+			FT_Done_Face(ft_face);
+			ft_face = NULL;
 			return(1);
 		}
 	}
@@ -257,10 +527,28 @@ int PsychRebuildFont(void)
 		// Test the created face to make sure it will work correctly:
 		if (!faceM->isValid()) {
 			if (_verbosity > 1) fprintf(stderr, "libptbdrawtext_ftgl: Freetype did not recognize %s as a font file.\n", _fontName);
+			delete(faceM);
+			faceM = NULL;
+			FT_Done_Face(ft_face);
+			ft_face = NULL;
 			return(1);
 		}
 	}
 
+	// Store new face in the cache and select it:
+	entry = &_faceCache[slot];
+	strcpy(entry->fontName, _fontName);
+	entry->fontStyle = _fontStyle;
+	entry->fontSize = _fontSize;
+	entry->antiAliasing = _antiAliasing;
+	entry->useOwnFontmapper = _useOwnFontmapper;
+	entry->faceId = _nextFaceId++;
+	entry->lastUse = ++_faceUseCounter;
+	entry->ft_face = ft_face;
+	entry->faceT = faceT;
+	entry->faceM = faceM;
+	_currentFaceId = entry->faceId;
+
 	// Ready!
 	_needsRebuild = false;
 	
@@ -339,7 +627,11 @@ int PsychDrawText(double xStart, double yStart, int textLen, double* text)
 {
 	int i;
 	GLuint ti;
-	QChar* myUniChars = new QChar[textLen];
+	FT_UInt glyph_index;
+	GLfloat penx, peny;
+	const PsychAtlasGlyph* glyph;
+	std::vector<GLfloat>* batch;
+	bool atlasFull;
 	
 	// On first invocation after init we need to generate a useless texture object.
 	// This is a weird workaround for some weird bug somewhere in FTGL...
@@ -352,18 +644,9 @@ int PsychDrawText(double xStart, double yStart, int textLen, double* text)
 	// change. Reload/Rebuild font face if so, check for errors:
 	if (_needsRebuild && PsychRebuildFont()) return(1);
 
-	// Synthesize Unicode QString from double vector:
-	for(i = 0; i < textLen; i++) {
-		myUniChars[i] = QChar((unsigned int) text[i]); 
-	}	
-	QString	uniCodeText = QString(myUniChars, textLen);  
-	delete [] myUniChars;
-	
 	glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS);
 	glPushAttrib(GL_ALL_ATTRIB_BITS);
 	glPixelStorei( GL_UNPACK_ALIGNMENT, 1);
-	glEnable( GL_TEXTURE_2D );
-	glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
 	
 	glMatrixMode(GL_PROJECTION);
 	glPushMatrix();
@@ -371,14 +654,6 @@ int PsychDrawText(double xStart, double yStart, int textLen, double* text)
 	gluOrtho2D(_vxs, _vxs + _vw, _vys, _vys + _vh);
 	glMatrixMode(GL_MODELVIEW);
 	
-	// Set text color: This will be filtered by OGLFT for redundant settings:
-	if (faceT) {
-		faceT->setForegroundColor( _fgcolor[0], _fgcolor[1], _fgcolor[2], _fgcolor[3]);
-	}
-	else {
-		faceM->setForegroundColor( _fgcolor[0], _fgcolor[1], _fgcolor[2], _fgcolor[3]);
-	}
-
 	// Rendering of background quad requested? -- True if background alpha > 0.
 	if (_bgcolor[3] > 0) {
 		// Yes. Compute bounding box of "to be drawn" text and render a quad in background color:
@@ -388,12 +663,71 @@ int PsychDrawText(double xStart, double yStart, int textLen, double* text)
 		glRectf(xmin + xStart, ymin + yStart, xmax + xStart, ymax + yStart);
 	}
 	
-	// Draw the text at selected start location:
-	if (faceT) {
-		faceT->draw(xStart, yStart, uniCodeText);
+	glEnable( GL_TEXTURE_2D );
+
+	if (_fontSize > PSYCH_MAX_ATLAS_FONTSIZE) {
+		// Huge font: Glyphs would waste too much atlas space, let OGLFT draw them with per-glyph textures:
+		// Synthesize Unicode QString from double vector:
+		QChar* myUniChars = new QChar[textLen];
+		for(i = 0; i < textLen; i++) {
+			myUniChars[i] = QChar((unsigned int) text[i]); 
+		}	
+		QString	uniCodeText = QString(myUniChars, textLen);  
+		delete [] myUniChars;
+
+		glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+
+		// Set text color: This will be filtered by OGLFT for redundant settings:
+		if (faceT) {
+			faceT->setForegroundColor( _fgcolor[0], _fgcolor[1], _fgcolor[2], _fgcolor[3]);
+			faceT->draw(xStart, yStart, uniCodeText);
+		}
+		else {
+			faceM->setForegroundColor( _fgcolor[0], _fgcolor[1], _fgcolor[2], _fgcolor[3]);
+			faceM->draw(xStart, yStart, uniCodeText);
+		}
 	}
 	else {
-		faceM->draw(xStart, yStart, uniCodeText);
+		// Atlas rendering: Glyph coverage is in the alpha channel of the atlas, text color
+		// gets applied as vertex color, so color changes don't need any re-rasterization:
+		glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+		glColor4fv(&(_fgcolor[0]));
+		glDisableClientState(GL_COLOR_ARRAY);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+		// Layout the string, same as OGLFT would do, and queue one textured quad per glyph:
+		penx = (GLfloat) xStart;
+		peny = (GLfloat) yStart;
+		for (i = 0; i < textLen; i++) {
+			glyph_index = FT_Get_Char_Index(ft_face, (FT_ULong) (unsigned int) text[i]);
+			if (glyph_index == 0) continue;
+
+			glyph = PsychGetAtlasGlyph(glyph_index, &atlasFull);
+			if (atlasFull) {
+				// Atlas full: Draw what we have so far, then start over with an empty atlas:
+				if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: Glyph atlas full, resetting it.\n");
+				PsychFlushAtlasBatches();
+				PsychResetGlyphAtlas();
+				glyph = PsychGetAtlasGlyph(glyph_index, &atlasFull);
+			}
+
+			if (glyph == NULL) continue;
+
+			if (glyph->page >= 0) {
+				batch = &_atlasBatch[glyph->page];
+				batch->push_back(penx + glyph->x0); batch->push_back(peny + glyph->y0); batch->push_back(glyph->s0); batch->push_back(glyph->t1);
+				batch->push_back(penx + glyph->x1); batch->push_back(peny + glyph->y0); batch->push_back(glyph->s1); batch->push_back(glyph->t1);
+				batch->push_back(penx + glyph->x1); batch->push_back(peny + glyph->y1); batch->push_back(glyph->s1); batch->push_back(glyph->t0);
+				batch->push_back(penx + glyph->x0); batch->push_back(peny + glyph->y1); batch->push_back(glyph->s0); batch->push_back(glyph->t0);
+			}
+
+			penx += glyph->advx;
+			peny += glyph->advy;
+		}
+
+		// Draw the whole string:
+		PsychFlushAtlasBatches();
 	}
 	
 	glMatrixMode(GL_PROJECTION);
@@ -441,6 +775,10 @@ int PsychInitText(void)
 	faceT = NULL;
 	faceM = NULL;
 	ft_face = NULL;
+	_currentFaceId = 0;
+	_faceCacheCount = 0;
+	_atlasPageCount = 0;
+	PsychResetGlyphAtlas();
 
 	// Try to initialize libfontconfig - our fontMapper library for font matching and selection:
 	if (!FcInit()) {
@@ -462,21 +800,28 @@ int PsychInitText(void)
 
 int PsychShutdownText(void)
 {
-	if (faceT || faceM) {
-		if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: In shutdown: faceT = %p faceM = %p\n", faceT, faceM);
+	int i;
+
+	if (_faceCacheCount > 0) {
+		if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: In shutdown: %i cached faces, %i atlas pages.\n", _faceCacheCount, _atlasPageCount);
 	
-		// Delete OGLFT face objects:
-		if (faceT) delete(faceT);
-		faceT = NULL;
-		
-		if (faceM) delete(faceM);
-		faceM = NULL;
+		// Delete all cached OGLFT and Freetype face objects:
+		for (i = 0; i < _faceCacheCount; i++) {
+			if (_faceCache[i].faceId > 0) PsychReleaseCachedFace(i);
+		}
+		_faceCacheCount = 0;
 
-		// Delete Freetype face object:
-		if (ft_face) FT_Done_Face(ft_face);
-		ft_face = NULL;
 		if (_verbosity > 3) fprintf(stderr, "libptbdrawtext_ftgl: Shutting down.\n");
 	}
+
+	// Delete glyph atlas:
+	if (_atlasPageCount > 0) glDeleteTextures(_atlasPageCount, &_atlasPages[0]);
+	_atlasPageCount = 0;
+	PsychResetGlyphAtlas();
+
+	faceT = NULL;
+	faceM = NULL;
+	ft_face = NULL;
 	
 	_needsRebuild = true;
 	_firstCall = false;
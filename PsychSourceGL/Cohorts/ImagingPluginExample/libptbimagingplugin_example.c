@@ -0,0 +1,129 @@
+/*
+ * libptbimagingplugin_example.c: Source of libptbimagingplugin_example, a minimal native C plugin for
+ * 'CFunction' slots of the Screen() imaging pipeline hook chains, as defined in PsychImagingPluginAPI.h.
+ *
+ * It serves as a starting point for writing own plugins and is used by PsychTests/ImagingPipelineCPluginTest.m
+ * to verify the plugin interface.
+ *
+ * The plugin copies the 'srcfbo1' input image into the 'dstfbo' output image and multiplies the red, green
+ * and blue color channels by per-channel gain factors. The gains are parsed from the configString of the slot,
+ * e.g., 'Gain=0.5 1.0 0.25', once at the first call and then kept in the private per-slot 'pluginData' until
+ * the slot gets detached. Without a 'Gain=' spec, the image is copied unmodified.
+ *
+ * Usage, e.g., as final output formatter of an onscreen window with imaging pipeline:
+ *
+ * Screen('HookFunction', win, 'AppendCFunction', 'FinalOutputFormattingBlit', 'ExampleGain', 'libptbimagingplugin_example.so.1', 'Gain=0.5 1 1');
+ * Screen('HookFunction', win, 'Enable', 'FinalOutputFormattingBlit');
+ *
+ * Building for Linux:
+ *
+ * gcc -O2 -fPIC -I../../Source/Common/Screen -shared -o libptbimagingplugin_example.so.1 libptbimagingplugin_example.c -l GL
+ *
+ * Building for OS/X:
+ *
+ * gcc -O2 -I../../Source/Common/Screen -framework OpenGL -dynamiclib -o libptbimagingplugin_example.dylib libptbimagingplugin_example.c
+ *
+ * Building for MS-Windows with MSVC:
+ *
+ * cl /O2 /LD /I..\..\Source\Common\Screen libptbimagingplugin_example.c opengl32.lib /Fe:libptbimagingplugin_example.dll
+ *
+ * Then copy the library into the Psychtoolbox/PsychBasic/PsychPlugins/ folder, or pass its full path
+ * to Screen('HookFunction').
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#define PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define PLUGIN_EXPORT
+#endif
+
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include "PsychImagingPluginAPI.h"
+
+#ifndef GL_TEXTURE_RECTANGLE_EXT
+#define GL_TEXTURE_RECTANGLE_EXT 0x84F5
+#endif
+
+// Private per-slot state, kept in params->pluginData:
+typedef struct ExamplePluginState {
+	float	gain[3];
+} ExamplePluginState;
+
+PLUGIN_EXPORT int PsychImagingPluginMain(PsychImagingPluginParams* params)
+{
+	ExamplePluginState* state = (ExamplePluginState*) params->pluginData;
+	const char* strp;
+	int w, h;
+
+	// Refuse to work with a Screen which uses an incompatible parameter block:
+	if (params->apiVersion != PSYCH_IMAGING_PLUGIN_API_VERSION) {
+		printf("libptbimagingplugin_example: Unsupported plugin interface version %i, need %i.\n", params->apiVersion, PSYCH_IMAGING_PLUGIN_API_VERSION);
+		return(1);
+	}
+
+	// Slot removed or window closing: Release our state and we're done.
+	if (params->command == kPsychImagingPluginDetach) {
+		free(state);
+		params->pluginData = NULL;
+		return(0);
+	}
+
+	// First call for this slot? Parse configuration into new per-slot state:
+	if (state == NULL) {
+		state = (ExamplePluginState*) calloc(1, sizeof(ExamplePluginState));
+		if (state == NULL) return(1);
+
+		state->gain[0] = state->gain[1] = state->gain[2] = 1.0f;
+		if ((strp = strstr(params->configString, "Gain=")) &&
+			(sscanf(strp, "Gain=%f %f %f", &state->gain[0], &state->gain[1], &state->gain[2]) != 3)) {
+			printf("libptbimagingplugin_example: Invalid 'Gain=' spec in configString '%s'.\n", params->configString);
+			free(state);
+			return(1);
+		}
+
+		params->pluginData = (void*) state;
+	}
+
+	// Need an input image as texture, not a multisampled renderbuffer:
+	if ((params->srcfbo1.coltexid == 0) || (params->srcfbo1.multisample > 0)) {
+		printf("libptbimagingplugin_example: Slot '%s' in hook chain '%s' has no usable input image.\n", params->idString, params->hookName);
+		return(1);
+	}
+
+	// Input texture is bound to unit 0 already. Draw it 1:1 into dstfbo, modulated by the gains. Textures
+	// are bottom-up, whereas the pixel coordinate system has its origin in the top-left corner:
+	w = params->srcfbo1.width;
+	h = params->srcfbo1.height;
+
+	glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+	glEnable(GL_TEXTURE_RECTANGLE_EXT);
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	glColor4f(state->gain[0], state->gain[1], state->gain[2], 1.0f);
+
+	glBegin(GL_QUADS);
+	glTexCoord2f(0, (float) h);
+	glVertex2f(0, 0);
+	glTexCoord2f(0, 0);
+	glVertex2f(0, (float) h);
+	glTexCoord2f((float) w, 0);
+	glVertex2f((float) w, (float) h);
+	glTexCoord2f((float) w, (float) h);
+	glVertex2f((float) w, 0);
+	glEnd();
+
+	// Restore enable state, texture environment and current color:
+	glPopAttrib();
+
+	return(0);
+}
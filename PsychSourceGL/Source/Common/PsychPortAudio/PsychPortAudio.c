@@ -29,9 +29,15 @@
 
 
 #include "PsychPortAudio.h"
+#include <errno.h>
 
 #if PSYCH_SYSTEM == PSYCH_OSX
 #include "pa_mac_core.h"
+#include <mach/mach.h>
+#endif
+
+#if PSYCH_SYSTEM == PSYCH_LINUX
+#include <semaphore.h>
 #endif
 
 #if PSYCH_SYSTEM == PSYCH_WINDOWS
@@ -95,6 +101,92 @@ static const char *synopsisSYNOPSIS[MAX_SYNOPSIS_STRINGS];
 // in the mixing/modulation stage.
 #define PA_ANTICLAMPGAIN 0.9999999
 
+// Use SSE2 vectorized mixer kernels for master devices? SSE2 must be enabled at compile time.
+// AVX kernels are only built if the compiler allows to enable AVX for individual functions,
+// and are only used if runtime detection confirms support by the cpu and operating system:
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PSYCH_PA_USE_SSE2 1
+#include <emmintrin.h>
+
+#if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))))
+#define PSYCH_PA_USE_AVX 1
+#define PSYCH_PA_AVX_TARGET __attribute__((target("avx")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (_MSC_FULL_VER >= 160040219)
+#define PSYCH_PA_USE_AVX 1
+#define PSYCH_PA_AVX_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+// Maximum number of worker threads for parallel rendering of slaves per master device:
+#define MAX_PSYCH_AUDIO_WORKER_THREADS 64
+
+// Minimum capacity in sample frames of the private scratch buffers of slaves for parallel rendering:
+#define PSYCH_PA_WORKER_MINFRAMES 4096
+
+// Number of sample frames per chunk for evaluation of parameter automation ramps:
+#define PSYCH_PA_AUTOMATION_CHUNK 256
+
+// Number of tabulated fractional positions per sample period of the resampler filter kernels:
+#define PSYCH_PA_RESAMPLER_PHASES 256
+
+// Maximum supported ratio of buffer sample rate to device sample rate for downsampling by the resampler:
+#define PSYCH_PA_RESAMPLER_MAXRATIO 8
+
+// Maximum number of cached resampler filter banks which are stretched for downsampling at a specific ratio:
+#define PSYCH_PA_RESAMPLER_MAXSTRETCHED 32
+
+// Number of records in the callback timing telemetry ring of a device. Must be a power of two:
+#define PSYCH_PA_TIMING_RECORDS 4096
+
+// Number of xrun contexts kept by the callback timing telemetry of a device:
+#define PSYCH_PA_TIMING_XRUNS 32
+
+// Number of bins of the callback duration histogram of the timing telemetry:
+#define PSYCH_PA_TIMING_BINS 24
+
+// Size of the header of WAV files written by 'CaptureToFile'. Sound data starts at this file offset:
+#define PSYCH_PA_CAPTUREFILE_HEADERSIZE 4096
+
+// Atomic operations for lock-free synchronization between the callback thread and slave worker threads:
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+#define PsychPAAtomicIncrement(p)			InterlockedIncrement((volatile LONG*) (p))
+#define PsychPAAtomicCAS(p, oldval, newval)	InterlockedCompareExchange((volatile LONG*) (p), (newval), (oldval))
+#define PsychPAMemoryBarrier()				MemoryBarrier()
+#else
+#define PsychPAAtomicIncrement(p)			__sync_add_and_fetch((p), 1)
+#define PsychPAAtomicCAS(p, oldval, newval)	__sync_val_compare_and_swap((p), (oldval), (newval))
+#define PsychPAMemoryBarrier()				__sync_synchronize()
+#endif
+
+// Counting semaphores to wake up slave worker threads from the callback thread. Posting never blocks:
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+typedef HANDLE psych_pa_semaphore;
+#define PsychPAInitSemaphore(s)		((*(s) = CreateSemaphore(NULL, 0, 0x7fffffff, NULL)) ? 0 : 1)
+#define PsychPAPostSemaphore(s)		ReleaseSemaphore(*(s), 1, NULL)
+#define PsychPAWaitSemaphore(s)		WaitForSingleObject(*(s), INFINITE)
+#define PsychPADestroySemaphore(s)	CloseHandle(*(s))
+#elif PSYCH_SYSTEM == PSYCH_OSX
+typedef semaphore_t psych_pa_semaphore;
+#define PsychPAInitSemaphore(s)		semaphore_create(mach_task_self(), (s), SYNC_POLICY_FIFO, 0)
+#define PsychPAPostSemaphore(s)		semaphore_signal(*(s))
+#define PsychPAWaitSemaphore(s)		semaphore_wait(*(s))
+#define PsychPADestroySemaphore(s)	semaphore_destroy(mach_task_self(), *(s))
+#else
+typedef sem_t psych_pa_semaphore;
+#define PsychPAInitSemaphore(s)		sem_init((s), 0, 0)
+#define PsychPAPostSemaphore(s)		sem_post(s)
+#define PsychPAWaitSemaphore(s)		while ((sem_wait(s) != 0) && (errno == EINTR)) {}
+#define PsychPADestroySemaphore(s)	sem_destroy(s)
+#endif
+
+// Mixer kernel levels, see PsychPAMixSlaveChannels():
+#define kPsychPAMixScalar	0
+#define kPsychPAMixSSE2		1
+#define kPsychPAMixAVX		2
+
 // Uncomment this define MUTEX_LOCK_TIME_STATS to enable tracing of
 // mutex lock hold times for low-level debugging and tuning:
 //#define MUTEX_LOCK_TIME_STATS 1
@@ -106,10 +198,95 @@ typedef struct PsychPASchedule {
 	psych_int64	loopEndFrame;		// End of playloop in frames.
 	int bufferhandle;					// Handle of the playout buffer to use. Zero is the standard playbuffer as set by 'FillBuffer'. Negative handles
 										// may have special meaning in future implementations.
+	unsigned int	buffergeneration;	// Generation of the dynamic buffer 'bufferhandle' at the time the slot was added.
 	double			tWhen;				// Time in seconds, either absolute or relative spec, depending on command.
 	unsigned int	command;			// Command code: 0 = Normal playback buffer. 1 = Pause & Restart playback, 2 = Schedule end of playback, ..
+	// Precompiled playback parameters, see PsychPACompileScheduleSlot():
+	float*			playoutbuffer;		// Sound data of the slot, NULL for command slots or slots whose buffer is invalid.
+	psych_int64		outsbsize;			// Size of playback loop in samples.
+	psych_int64		outsboffset;		// Start of playback loop in samples.
+	psych_int64		playpositionlimit;	// Upper limit of played out samples, from loop size and repetitions.
+	double			sampleRate;			// Sample rate of the sound data, 0 = Sample rate of the device.
+	struct PsychPAResamplerBank*	resampler;	// Resampler filter bank for sampleRate, NULL if no conversion is needed.
 } PsychPASchedule;
 
+// Breakpoint of a parameter automation track, see PSYCHPORTAUDIOAddToAutomation():
+typedef struct PsychPAAutomationPoint {
+	double			when;				// Time of breakpoint, in units given by 'unit'.
+	float			value;				// Value of the automated parameter at time 'when'.
+	unsigned int	shape;				// Shape of segment leading up to this breakpoint: 0 = Linear ramp, 1 = Exponential ramp, 2 = Step at 'when'.
+	unsigned int	unit;				// Unit of 'when': 0 = System time in secs, 1 = Secs since start of playback, 2 = Sample frames since start of playback.
+} PsychPAAutomationPoint;
+
+// Automation track for one parameter of a device, see PSYCHPORTAUDIOUseAutomation():
+typedef struct PsychPAAutomationTrack {
+	PsychPAAutomationPoint*	points;		// Ringbuffer of breakpoints.
+	unsigned int	size;				// Capacity of 'points'.
+	unsigned int	readpos;			// Running index of next pending breakpoint. Only advanced by paCallback.
+	unsigned int	writepos;			// Running index of next free breakpoint slot. Only advanced by 'AddToAutomation'.
+	double			segStart;			// System time of start of current ramp segment, or -1 if no segment is started yet.
+	float			segValue;			// Parameter value at segStart.
+} PsychPAAutomationTrack;
+
+// Filter bank of the resampler, see PSYCHPORTAUDIOUseResampler():
+typedef struct PsychPAResamplerBank {
+	int		taps;						// Number of filter taps. Always a multiple of 4.
+	int		offset;						// Offset in sample frames from the first tap to the current sample frame of the buffer.
+	int		quality;					// Quality level of the bank, or of the bank it was stretched from.
+	double	ratio;						// Ratio of buffer to device sample rate the bank is stretched for, 1 if not stretched.
+	float*	coeffs;						// PSYCH_PA_RESAMPLER_PHASES + 1 rows of 'taps' coefficients, NULL if not yet created.
+} PsychPAResamplerBank;
+
+// Telemetry record of one invocation of paCallback, see PSYCHPORTAUDIOGetTimingStats():
+typedef struct PsychPATimingRecord {
+	double			tStart;				// System time of invocation.
+	float			duration;			// Duration of the callback in seconds.
+	float			predictedLatency;	// Predicted latency from invocation to output of the first sample in seconds.
+	unsigned int	frames;				// Number of sample frames requested.
+	unsigned short	slaves;				// Number of active slaves a master device executed in this callback.
+	unsigned short	flags;				// PortAudio status flags of the callback.
+} PsychPATimingRecord;
+
+// Context of a buffer over-/underrun: Record of the callback reporting it, and of the callback preceding it:
+typedef struct PsychPAXRunRecord {
+	PsychPATimingRecord	xrun;
+	PsychPATimingRecord	previous;
+} PsychPAXRunRecord;
+
+// Callback timing telemetry of a device. Only written by paCallback, read lock-free by 'GetTimingStats':
+typedef struct PsychPATimingStats {
+	PsychPATimingRecord	records[PSYCH_PA_TIMING_RECORDS];	// Ring of records of the most recent callbacks.
+	PsychPAXRunRecord	xruns[PSYCH_PA_TIMING_XRUNS];		// Ring of contexts of the most recent xruns.
+	unsigned int	histogram[PSYCH_PA_TIMING_BINS];		// Histogram of callback durations since last reset.
+	double			totalDuration;		// Sum of callback durations since last reset.
+	float			maxDuration;		// Maximum callback duration since last reset.
+	volatile unsigned int	writepos;	// Running count of written records.
+	volatile unsigned int	xrunpos;	// Running count of written xrun contexts.
+	volatile unsigned int	firstpos;	// Value of writepos at last reset.
+	volatile unsigned int	firstxrun;	// Value of xrunpos at last reset.
+	volatile int	resetRequest;		// Set by 'GetTimingStats' to request a reset of the statistics by paCallback.
+} PsychPATimingStats;
+
+// Slave worker thread of a master device, see PsychPAStartSlaveWorkers():
+typedef struct PsychPAWorker {
+	struct PsychPADevice*	dev;		// Master device for which the worker renders slaves.
+	psych_thread	thread;				// Thread handle.
+} PsychPAWorker;
+
+// Writer thread which streams captured sound data of a device into a file, see PSYCHPORTAUDIOCaptureToFile():
+typedef struct PsychPACaptureWriter {
+	psych_thread	thread;				// Thread handle.
+	psych_condition	signal;				// Condition variable to wake up the writer for shutdown. Used with the device mutex.
+	FILE*			file;				// Output file.
+	int				format;				// File format: 0 = WAV/RF64, 1 = Raw float.
+	volatile int	shutdown;			// Set to 1 to ask the writer to write out all pending data and exit.
+	volatile int	error;				// errno of a failed write, 0 if none.
+	psych_int64		chunkSamples;		// Size of one write in samples.
+	float*			stageBuffer;		// Staging buffer of chunkSamples samples, holding a copy of the chunk which is written.
+	double			pollSecs;			// Interval in seconds for checking for a new chunk of captured data.
+	psych_int64		dataBytes;			// Total amount of sound data written to the file in bytes.
+} PsychPACaptureWriter;
+
 // Our device record:
 typedef struct PsychPADevice {
 	psych_mutex	mutex;			// Mutex lock for the PsychPADevice struct.
@@ -171,6 +348,7 @@ typedef struct PsychPADevice {
 	int*	slaves;				// Array of pahandle's of all attached slave devices, ie., an array with slaveCount valid (non -1) entries. NULL on slaves.
 	int	pamaster;			// pahandle of master device for a slave. -1 on master devices.
 	int	slaveDirty;			// Flag: 0 means that a slave didn't do anything, so no mixdown/merge by master required. 1 means: Do mixdown/merge.
+	volatile int	slavesProcessed;	// On masters: Number of active slaves executed in the current callback, for callback timing telemetry.
 	float*	slaveOutBuffer;		// Temporary output buffer for slaves to store their output data. Used as input for output mix/merge. NULL on non-masters.
 	float*	slaveInBuffer;		// Temporary input buffer for slaves to receive their input data. Used as output from distributor. NULL on non-masters.
 	float*	slaveGainBuffer;	// Temporary output buffer for AM modulator slaves to store their gain output data. NULL on non AMModulators for slaves.
@@ -182,6 +360,57 @@ typedef struct PsychPADevice {
 	// Mixer volume related:
 	float*	outChannelVolumes;	// Array of per-outputchannel volume settings on slave devices, NULL and not used on non-slave devices.
 	float	masterVolume;		// Master volume setting for all non-slave audio devices, i.e., masters and regular devices. Unused on slaves.
+
+	// Parallel slave rendering on master devices, see PsychPAStartSlaveWorkers():
+	PsychPAWorker*	workerThreads;		// Array of slave worker threads on masters. NULL if slaves are rendered serially in the callback thread.
+	int		workerCount;				// Number of threads in workerThreads.
+	psych_pa_semaphore	workerWakeup;	// Semaphore to wake up sleeping workerThreads. Posted once per needed worker for each batch of slave jobs.
+	volatile int	workerShutdown;		// Set to 1 to ask worker threads to exit.
+	volatile int	workerGeneration;	// Sequence number of current batch of slave jobs. Incremented for each batch.
+	int*	slaveJobs;					// Array of slave pahandles to render in current batch.
+	volatile int	slaveJobCount;		// Number of slave jobs in current batch.
+	volatile int	slaveJobNext;		// Index of next job to claim in the lower 16 bits, workerGeneration of batch in the upper bits.
+	volatile int	slaveJobsDone;		// Number of completed jobs in current batch. The callback thread spins on this as barrier before mixdown.
+	int		workerFallback;				// Set by paCallback if worker threads missed the barrier deadline: Render slaves serially until next 'Start'.
+	int		deferScheduleUnref;			// On slaves: Set while rendered by a worker thread, so consumed schedule slots keep their buffer reference for now.
+	int		scheduleUnrefPending;		// On slaves: Some consumed schedule slots still hold a buffer reference, see PsychPAConsumeScheduleSlot().
+	const float*	workerIn;			// Input buffer of master for the current batch.
+	const PaStreamCallbackTimeInfo* workerTimeInfo;	// timeInfo of master callback for the current batch.
+	PaStreamCallbackFlags	workerStatusFlags;		// statusFlags of master callback for the current batch.
+	psych_int64	workerBufferFrames;	// On slaves: Capacity in frames of the private slave*Buffer's used during parallel rendering. On masters: Capacity to allocate for slaves.
+
+	// Lock-free ring buffer playback, see PSYCHPORTAUDIOUseRingBuffer():
+	float*	ringBuffer;					// Ring buffer for playback in ring buffer mode. NULL if ring buffer mode is disabled.
+	unsigned int	ringCapacity;		// Capacity of ringBuffer in samples. Always a power of two.
+	volatile unsigned int	ringReadPos;	// Running count of samples consumed from ringBuffer. Only written by paCallback.
+	volatile unsigned int	ringWritePos;	// Running count of samples pushed into ringBuffer. Only written by 'PushAudio'.
+	psych_int64	ringUnderruns;			// Number of callbacks which ran out of ring buffer data before their buffer was filled.
+	psych_int64	ringUnderrunFrames;		// Total number of silence frames inserted due to ring buffer underruns.
+
+	// Parameter automation, see PSYCHPORTAUDIOUseAutomation():
+	PsychPAAutomationTrack*	automation;	// Array of automation tracks, NULL if automation is disabled.
+	int		automationTracks;			// Number of tracks: Track 0 = masterVolume, tracks 1 to outchannels = outChannelVolumes of slaves.
+	float*	automationMixGains;			// On slaves: Per-channel mixing gains while automation of outChannelVolumes is active.
+	float*	mixGains;					// On slaves: Per-channel gains to apply when mixing slave output, either outChannelVolumes or automationMixGains.
+
+	// Sample rate conversion, see PSYCHPORTAUDIOUseResampler():
+	PsychPAResamplerBank*	resampler;	// Filter bank of the resampler, NULL if resampling is disabled.
+	float*	resampleScratch;			// Scratch memory of the resampler for sample window, filter weights and per-channel sums.
+	double	resamplePhase;				// Fractional position of the resampler between the current and next sample frame of the buffer.
+	double	outputbufferSampleRate;		// Sample rate of the standard playback buffer, 0 = Sample rate of device.
+	double	playoutSampleRate;			// Sample rate of the buffer currently played back, 0 = Sample rate of device. Only written by paCallback.
+	PsychPAResamplerBank*	outputbufferResampler;	// Resampler filter bank for outputbufferSampleRate, NULL if no conversion is needed.
+	PsychPAResamplerBank*	playoutResampler;		// Resampler filter bank for playoutSampleRate. Only written by paCallback.
+
+	// Callback timing telemetry, see PSYCHPORTAUDIOGetTimingStats():
+	PsychPATimingStats*	timing;			// Telemetry records and statistics, NULL if telemetry was never enabled.
+	volatile int	timingEnabled;		// 1 = Record telemetry in paCallback, 0 = Don't.
+
+	// Streaming of captured sound data to a file, see PSYCHPORTAUDIOCaptureToFile():
+	PsychPACaptureWriter*	captureWriter;	// Writer thread, NULL if captured data isn't streamed to a file.
+	psych_int64	captureFileFrames;		// Number of sample frames written to the capture file.
+	psych_int64	captureFileOverflows;	// Number of capture buffer overflows, because the writer couldn't keep up.
+	psych_int64	captureFileLostFrames;	// Number of sample frames lost due to capture buffer overflows.
 } PsychPADevice;
 
 PsychPADevice audiodevices[MAX_PSYCH_AUDIO_DEVS];
@@ -192,6 +421,17 @@ psych_bool    uselocking = TRUE;		// Use Mutex locking and signalling code for t
 psych_bool    lockToCore1 = TRUE;		// Lock all engine threads to run on cpu core 1 on Windows to work around broken TSC sync on multi-cores?
 psych_bool    pulseaudio_autosuspend = TRUE;    // Should we try to suspend the Pulseaudio sound server on Linux while we're active?
 psych_bool    pulseaudio_isSuspended = FALSE;   // Is PulseAudio suspended by us?
+int           mixSIMDMaxLevel = kPsychPAMixScalar; // Best mixer kernel level supported by build and machine.
+int           mixSIMDLevel = kPsychPAMixScalar;    // Mixer kernel level to use for master devices.
+int           slaveWorkerThreads = 0;           // Number of worker threads for parallel slave rendering on new master devices. 0 = Render serially.
+
+// Resampler filter banks for quality levels 1 to 3, created on first use, and their number of taps and Kaiser window parameter:
+PsychPAResamplerBank resamplerBanks[4];
+static const int resamplerTaps[4] = { 0, 16, 32, 64 };
+static const double resamplerBeta[4] = { 0.0, 6.0, 8.0, 10.0 };
+
+// Resampler filter banks stretched for downsampling, created on first use for each quality level and sample rate ratio:
+PsychPAResamplerBank stretchedResamplerBanks[PSYCH_PA_RESAMPLER_MAXSTRETCHED];
 
 double debugdummy1, debugdummy2;
 
@@ -203,13 +443,35 @@ struct PsychPABuffer_Struct {
 	float*	 outputbuffer;		// Pointer to float memory buffer with sound output data.
 	psych_int64 outputbuffersize;	// Size of output buffer in bytes.
 	psych_int64 outchannels;	// Number of channels.
+	psych_int64 capacity;		// Size of allocated memory of outputbuffer in bytes. Can be bigger than outputbuffersize for recycled memory.
+	double sampleRate;			// Sample rate of the sound in Hz for the resampler, 0 = Sample rate of the playback device.
+	int inuse;					// 1 = Header describes a live buffer. 0 = Header is free, possibly retaining memory for recycling.
+	int refcount;				// Number of pending schedule slots which reference this buffer.
+	unsigned int generation;	// Incremented each time the buffer is deleted, so stale schedule slots can detect reuse of their handle.
+	int nextFree;				// Handle of next header in the free list this header is queued in, or 0 for end of list.
 };
 
 typedef struct PsychPABuffer_Struct PsychPABuffer;
 
+// Audio buffers are allocated in slabs of PSYCH_AUDIO_BUFFERLIST_INCREMENT buffer headers each.
+// Slabs are never moved in memory once allocated, so a handle maps to its header in O(1) without
+// any need to relocate the list when it grows:
+#define PSYCH_AUDIO_BUFFERLIST_MAXSLABS 1024
+#define PsychPABufferHeader(handle) (&(bufferSlabs[(handle) / PSYCH_AUDIO_BUFFERLIST_INCREMENT][(handle) % PSYCH_AUDIO_BUFFERLIST_INCREMENT]))
+
+// Deleted buffers retain their memory for reuse by new buffers of similar size, up to this many bytes in total:
+#define PSYCH_AUDIO_BUFFERPOOL_MAXRETAINED (256 * 1024 * 1024)
+
+// Number of size classes of retained memory. Size class n holds buffers with 2^n <= capacity < 2^(n+1) bytes:
+#define PSYCH_AUDIO_BUFFERPOOL_BINS 64
+
 psych_mutex	bufferListmutex;			// Mutex lock for the audio bufferList.
-PsychPABuffer*  bufferList;				// Pointer to start of audio bufferList.
-int	bufferListCount;					// Number of slots allocated in bufferList.
+PsychPABuffer*  bufferSlabs[PSYCH_AUDIO_BUFFERLIST_MAXSLABS];	// Slabs of buffer headers.
+int	bufferListCount;					// Number of headers allocated in all slabs.
+int	bufferListNext;						// Next never used handle.
+int	bufferFreeHeaders;					// Head of list of free headers without retained memory, 0 if none.
+int	bufferFreeBins[PSYCH_AUDIO_BUFFERPOOL_BINS];	// Heads of lists of free headers with retained memory, per size class, 0 if none.
+psych_int64 bufferPoolRetained;			// Total amount of retained memory in bytes.
 
 // Scan all schedules of all active and open audio devices to check if
 // given audiobuffer is referenced. Invalidate reference, if so:
@@ -242,74 +504,122 @@ psych_bool PsychPAInvalidateBufferReferences(int handle)
 	return(anylocked);
 }
 
+// Map a buffer size in bytes to its size class in the pool of retained memory:
+static int PsychPABufferSizeClass(psych_int64 size)
+{
+	int bin = 0;
+	while ((size >>= 1) > 0) bin++;
+	return((bin < PSYCH_AUDIO_BUFFERPOOL_BINS) ? bin : PSYCH_AUDIO_BUFFERPOOL_BINS - 1);
+}
+
+// Return a free buffer header without memory attached, either a recycled one or a new one.
+// Grows the slab directory if needed. Must be called with bufferListmutex held. Returns 0
+// if out of memory or handles:
+static int PsychPAGetFreeBufferHeader(void)
+{
+	PsychPABuffer* buffer;
+	int handle, bin;
+
+	// Recycled header available?
+	if (bufferFreeHeaders > 0) {
+		handle = bufferFreeHeaders;
+		bufferFreeHeaders = PsychPABufferHeader(handle)->nextFree;
+		return(handle);
+	}
+
+	// First call? Handle zero is never returned, as zero denotes the special
+	// per-audiodevice playback buffer:
+	if (bufferListNext <= 0) bufferListNext = 1;
+
+	// Need a new slab of headers?
+	if (bufferListNext >= bufferListCount) {
+		if ((bufferListCount / PSYCH_AUDIO_BUFFERLIST_INCREMENT < PSYCH_AUDIO_BUFFERLIST_MAXSLABS) &&
+			(NULL != (buffer = (PsychPABuffer*) calloc(PSYCH_AUDIO_BUFFERLIST_INCREMENT, sizeof(PsychPABuffer))))) {
+			bufferSlabs[bufferListCount / PSYCH_AUDIO_BUFFERLIST_INCREMENT] = buffer;
+			bufferListCount += PSYCH_AUDIO_BUFFERLIST_INCREMENT;
+		}
+		else {
+			// Out of handles or memory: Steal a header from the retained memory pool, if any:
+			for (bin = PSYCH_AUDIO_BUFFERPOOL_BINS - 1; bin >= 0; bin--) {
+				if (bufferFreeBins[bin] > 0) {
+					handle = bufferFreeBins[bin];
+					buffer = PsychPABufferHeader(handle);
+					bufferFreeBins[bin] = buffer->nextFree;
+					bufferPoolRetained -= buffer->capacity;
+					free(buffer->outputbuffer);
+					buffer->outputbuffer = NULL;
+					buffer->capacity = 0;
+					return(handle);
+				}
+			}
+
+			return(0);
+		}
+	}
+
+	return(bufferListNext++);
+}
+
 // Create a new audiobuffer for 'outchannels' audio channels and 'nrFrames' samples
-// per channel. Init header, allocate zero-filled memory, enqeue in bufferList.
-// Resize/Grow bufferList if neccessary. Return handle to buffer.
+// per channel. Init header, allocate zero-filled memory, either by recycling the memory
+// of a deleted buffer of similar size, or by allocating new memory. Return handle to buffer.
 int PsychPACreateAudioBuffer(psych_int64 outchannels, psych_int64 nrFrames)
 {
-	PsychPABuffer* tmpptr;
-	int i, handle;
-	
-	// Does a bufferList exist?
-	if ((bufferListCount <= 0) || (bufferList == NULL)) {
-		// First call. Allocate and zero-fill initial bufferList:
-		bufferList = (PsychPABuffer*) calloc(PSYCH_AUDIO_BUFFERLIST_INCREMENT, sizeof(PsychPABuffer));
-		if (NULL == bufferList) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffers when trying to create internal bufferlist!");
-
-		bufferListCount = PSYCH_AUDIO_BUFFERLIST_INCREMENT;
-	} 
-
-	// Search a free slot in bufferList: We start at slot 1, ie., we skip slot 0.
-	// This because we don't want to ever return a handle of zero, as zero denotes the
-	// special per-audiodevice playback buffer.
-	i = 1; while ((i < bufferListCount) && (NULL != bufferList[i].outputbuffer)) i++;
-
-	// Success?
-	if ((i >= bufferListCount)) {
-		// Nope. Could not find free slot. Need to resize the bufferList with more capacity.
-		
-		// Need to lock bufferList lock to do this:
-		PsychLockMutex(&bufferListmutex);
-		
-		// Reallocate bufferList: This may relocate the bufferList:
-		tmpptr = (PsychPABuffer*) realloc((void*) bufferList, (bufferListCount + PSYCH_AUDIO_BUFFERLIST_INCREMENT) * sizeof(PsychPABuffer) );		
-		if (NULL == tmpptr) {
-			// Failed! Unlock mutex:
+	PsychPABuffer* buffer;
+	psych_int64 size = outchannels * nrFrames * sizeof(float);
+	int i, bin, handle, prev;
+
+	// Need to lock bufferList lock to do this:
+	PsychLockMutex(&bufferListmutex);
+
+	// Search a few entries of the size class of the new buffer for a deleted buffer with enough
+	// retained memory. Any candidate wastes less than half of its memory:
+	bin = PsychPABufferSizeClass(size);
+	handle = 0;
+	for (i = 0, prev = 0, handle = bufferFreeBins[bin]; (handle > 0) && (i < 8); i++, prev = handle, handle = PsychPABufferHeader(handle)->nextFree) {
+		if (PsychPABufferHeader(handle)->capacity >= size) break;
+	}
+
+	if ((handle > 0) && (i < 8)) {
+		// Found one: Dequeue it and clear the used part of its memory to silence:
+		buffer = PsychPABufferHeader(handle);
+		if (prev > 0) PsychPABufferHeader(prev)->nextFree = buffer->nextFree;
+		else bufferFreeBins[bin] = buffer->nextFree;
+		bufferPoolRetained -= buffer->capacity;
+		memset(buffer->outputbuffer, 0, (size_t) size);
+	}
+	else {
+		// Nope. Get an empty header and allocate new memory:
+		handle = PsychPAGetFreeBufferHeader();
+		if (handle <= 0) {
 			PsychUnlockMutex(&bufferListmutex);
-			
-			// Error out. The old allocation and parameters are still valid:
 			PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffers when trying to grow internal bufferlist!");
 		}
-		
-		// Assign new pointer and size:
-		bufferList = tmpptr;
-		tmpptr = &(bufferList[i]);
-		bufferListCount += PSYCH_AUDIO_BUFFERLIST_INCREMENT;
-		
-		// Initialize new segment of list to zero:
-		memset((void*) tmpptr, 0, PSYCH_AUDIO_BUFFERLIST_INCREMENT * sizeof(PsychPABuffer));
 
-		// Done resizing bufferlist. Unlock mutex:
-		PsychUnlockMutex(&bufferListmutex);
+		buffer = PsychPABufferHeader(handle);
+		if (NULL == (buffer->outputbuffer = (float*) calloc(1, (size_t) size))) {
+			// Out of memory: Release bufferList header and error out:
+			buffer->nextFree = bufferFreeHeaders;
+			bufferFreeHeaders = handle;
+			PsychUnlockMutex(&bufferListmutex);
+			PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffer when trying to allocate actual buffer!");
+		}
 
-		// Ready. 'i' now points to first free slot in new segment of extended bufferList.
+		buffer->capacity = size;
 	}
-	
-	// Assign slotid of bufferList slot in handle:
-	handle = i;
 
-	// Invalidate all potential stale references to the new 'handle' in all schedules:
-	PsychPAInvalidateBufferReferences(handle);
+	// Init header. The generation counter is left as is, so stale references from schedule slots
+	// to a previous buffer with this handle do not match the new buffer:
+	buffer->outputbuffersize = size;
+	buffer->outchannels = outchannels;
+	buffer->sampleRate = 0;
+	buffer->refcount = 0;
+	buffer->locked = 0;
+	buffer->nextFree = 0;
+	buffer->inuse = 1;
+
+	PsychUnlockMutex(&bufferListmutex);
 
-	// Allocate actual data buffer:
-	bufferList[handle].outputbuffersize = outchannels * nrFrames * sizeof(float);
-	bufferList[handle].outchannels = outchannels;
-	
-	if (NULL == ( bufferList[handle].outputbuffer = (float*) calloc(1, (size_t) bufferList[handle].outputbuffersize) )) {
-		// Out of memory: Release bufferList header and error out:
-		PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffer when trying to allocate actual buffer!");
-	}
-	
 	// Ok, we're ready with an empty, silence filled audiobuffer. Return its handle:
 	return(handle);
 }
@@ -327,15 +637,22 @@ void PsychPADeleteAllAudioBuffers(void)
 		// Invalidate all referencing slots in all schedules:
 		PsychPAInvalidateBufferReferences(-1);
 		
-		// Free all audio buffers:
-		for (i = 0; i < bufferListCount; i++) {
-			if (NULL != bufferList[i].outputbuffer) free(bufferList[i].outputbuffer);
+		// Free all audio buffers, including retained memory of deleted ones:
+		for (i = 1; i < bufferListNext; i++) {
+			if (NULL != PsychPABufferHeader(i)->outputbuffer) free(PsychPABufferHeader(i)->outputbuffer);
 		}
 		
-		// Release memory for bufferheader array itself:
-		free(bufferList);
-		bufferList = NULL;
+		// Release memory for bufferheader slabs themselves:
+		for (i = 0; i < bufferListCount / PSYCH_AUDIO_BUFFERLIST_INCREMENT; i++) {
+			free(bufferSlabs[i]);
+			bufferSlabs[i] = NULL;
+		}
+
 		bufferListCount = 0;
+		bufferListNext = 0;
+		bufferFreeHeaders = 0;
+		memset(bufferFreeBins, 0, sizeof(bufferFreeBins));
+		bufferPoolRetained = 0;
 
 		// Unlock list:
 		PsychUnlockMutex(&bufferListmutex);
@@ -347,11 +664,167 @@ void PsychPADeleteAllAudioBuffers(void)
 PsychPABuffer* PsychPAGetAudioBuffer(int handle)
 {
 	// Does buffer with given handle exist?
-	if ((handle < 0) || (handle >= bufferListCount) || (bufferList[handle].outputbuffer == NULL)) {
+	if ((handle <= 0) || (handle >= bufferListNext) || !(PsychPABufferHeader(handle)->inuse)) {
 		PsychErrorExitMsg(PsychError_user, "Invalid audio bufferhandle provided! The handle doesn't correspond to an existing audiobuffer.");
 	}
 	
-	return( &(bufferList[handle]) );
+	return(PsychPABufferHeader(handle));
+}
+
+// Return the live audiobuffer referenced by schedule slot 'slot', or NULL if the slot doesn't reference
+// a dynamic buffer, or if the buffer it referenced got deleted meanwhile. Must be called with bufferListmutex held:
+static PsychPABuffer* PsychPAGetSlotBuffer(PsychPASchedule* slot)
+{
+	PsychPABuffer* buffer;
+
+	if ((slot->bufferhandle <= 0) || (slot->bufferhandle >= bufferListNext)) return(NULL);
+
+	buffer = PsychPABufferHeader(slot->bufferhandle);
+	return((buffer->inuse && (buffer->generation == slot->buffergeneration)) ? buffer : NULL);
+}
+
+// Add a reference from pending schedule slot 'slot' to its audiobuffer. Must be called with bufferListmutex held:
+static void PsychPAReferenceSlotBuffer(PsychPASchedule* slot)
+{
+	PsychPABuffer* buffer = PsychPAGetSlotBuffer(slot);
+	if (buffer) buffer->refcount++;
+}
+
+// Drop the reference of schedule slot 'slot' to its audiobuffer. Must be called with bufferListmutex held:
+static void PsychPAUnreferenceSlotBuffer(PsychPASchedule* slot)
+{
+	PsychPABuffer* buffer = PsychPAGetSlotBuffer(slot);
+	if (buffer && (buffer->refcount > 0)) buffer->refcount--;
+}
+
+// Drop the references of all pending slots, and of consumed slots whose reference is still marked for
+// release, in the schedule of device 'dev', e.g., before the schedule gets cleared or released:
+static void PsychPAUnreferenceScheduleBuffers(PsychPADevice* dev)
+{
+	unsigned int j;
+
+	if (NULL == dev->schedule) return;
+
+	PsychLockMutex(&bufferListmutex);
+	for (j = 0; j < dev->schedule_size; j++) {
+		if (dev->schedule[j].mode & (2 | 8)) PsychPAUnreferenceSlotBuffer(&(dev->schedule[j]));
+	}
+	dev->scheduleUnrefPending = 0;
+	PsychUnlockMutex(&bufferListmutex);
+}
+
+// Release all buffer references of consumed schedule slots of device 'dev' which were marked for
+// release by PsychPAConsumeScheduleSlot(). Must be called with bufferListmutex held:
+static void PsychPAReleaseDeferredScheduleRefs(PsychPADevice* dev)
+{
+	unsigned int j;
+
+	for (j = 0; j < dev->schedule_size; j++) {
+		if (dev->schedule[j].mode & 8) {
+			PsychPAUnreferenceSlotBuffer(&(dev->schedule[j]));
+			dev->schedule[j].mode &= ~8;
+		}
+	}
+
+	dev->scheduleUnrefPending = 0;
+}
+
+// Mark pending schedule slot 'slot' of device 'dev' as consumed, dropping its reference to its audiobuffer.
+// Called from paCallback, which must never block on the bufferListmutex: If the mutex is held by some other
+// thread, or while 'dev' is rendered by a slave worker thread, the reference is only marked for release by
+// flag 8 in slot->mode. Marked references get released by the next caller which gets the mutex, by the
+// master after a batch of slave jobs, or when the slot gets reused or the schedule gets released:
+static void PsychPAConsumeScheduleSlot(PsychPADevice* dev, PsychPASchedule* slot)
+{
+	if (slot->bufferhandle > 0) {
+		if (!dev->deferScheduleUnref && (PsychTryLockMutex(&bufferListmutex) == 0)) {
+			PsychPAUnreferenceSlotBuffer(slot);
+			if (dev->scheduleUnrefPending) PsychPAReleaseDeferredScheduleRefs(dev);
+			PsychUnlockMutex(&bufferListmutex);
+		}
+		else {
+			slot->mode |= 8;
+			dev->scheduleUnrefPending = 1;
+		}
+	}
+
+	slot->mode &= ~2;
+}
+
+static PsychPAResamplerBank* PsychPAGetResamplerBankForRate(PsychPADevice* dev, double rate);
+
+// Precompile the playback parameters of schedule slot 'slot' of device 'dev': Resolve its audio buffer, clamp
+// its playback loop to the buffer and compute the loop size and playposition limit, so PsychPAProcessSchedule()
+// only has to fetch them on each slot transition. A slot whose buffer is gone gets a NULL playoutbuffer and
+// will be skipped. Must be called with bufferListmutex held, while the slot is not processed by paCallback:
+static void PsychPACompileScheduleSlot(PsychPADevice* dev, PsychPASchedule* slot)
+{
+	PsychPABuffer* buffer;
+	psych_int64 outchannels = dev->outchannels;
+	psych_int64 loopStartFrame, loopEndFrame, outsbsize = 0;
+	float* data = NULL;
+
+	slot->sampleRate = 0;
+	slot->resampler = NULL;
+
+	if (slot->command == 0) {
+		if (slot->bufferhandle <= 0) {
+			// Default device playoutbuffer:
+			data = dev->outputbuffer;
+			outsbsize = dev->outputbuffersize / sizeof(float);
+			slot->sampleRate = dev->outputbufferSampleRate;
+		}
+		else if (((buffer = PsychPAGetSlotBuffer(slot)) != NULL) && (buffer->outchannels == outchannels)) {
+			// Dynamic buffer which is still alive and matches our channel count:
+			data = buffer->outputbuffer;
+			outsbsize = buffer->outputbuffersize / sizeof(float);
+			slot->sampleRate = buffer->sampleRate;
+		}
+	}
+
+	if ((NULL == data) || (outsbsize < outchannels)) {
+		// Command slot or invalid buffer:
+		slot->playoutbuffer = NULL;
+		slot->outsbsize = 0;
+		slot->outsboffset = 0;
+		slot->playpositionlimit = 0;
+		return;
+	}
+
+	// Validate boundaries of playback loop:
+	loopStartFrame = slot->loopStartFrame;
+	loopEndFrame = slot->loopEndFrame;
+	if (loopStartFrame * outchannels >= outsbsize) loopStartFrame = (outsbsize / outchannels) - 1;
+	if (loopStartFrame < 0) loopStartFrame = 0;
+	if (loopEndFrame * outchannels >= outsbsize) loopEndFrame = (outsbsize / outchannels) - 1;
+	if (loopEndFrame < 0) loopEndFrame = 0;
+	if (loopEndFrame < loopStartFrame) loopEndFrame = loopStartFrame;
+
+	// Remap defined playback loop to "corrected" outsbsize and offset for later copy-op:
+	slot->playoutbuffer = data;
+	slot->resampler = PsychPAGetResamplerBankForRate(dev, slot->sampleRate);
+	slot->outsbsize = (loopEndFrame - loopStartFrame + 1) * outchannels;
+	slot->outsboffset = loopStartFrame * outchannels;
+
+	// Compute playpositionlimit, the upper limit of played out samples from loop duration and repetitions,
+	// and make sure it ends on integral sample frame boundaries:
+	slot->playpositionlimit = (psych_int64) (slot->repetitions * slot->outsbsize);
+	slot->playpositionlimit -= slot->playpositionlimit % outchannels;
+}
+
+// (Re-)Compile all pending slots of the schedule of device 'dev', e.g., before start of playback, as buffers may
+// have been deleted or refilled with different size meanwhile. Called with the device mutex held:
+static void PsychPACompileSchedule(PsychPADevice* dev)
+{
+	unsigned int j;
+
+	if (NULL == dev->schedule) return;
+
+	PsychLockMutex(&bufferListmutex);
+	for (j = 0; j < dev->schedule_size; j++) {
+		if (dev->schedule[j].mode & 2) PsychPACompileScheduleSlot(dev, &(dev->schedule[j]));
+	}
+	PsychUnlockMutex(&bufferListmutex);
 }
 
 // Scan all schedules of all active and open audio devices to check which
@@ -363,7 +836,7 @@ psych_bool PsychPAUpdateBufferReferences(void)
 	psych_bool anylocked = FALSE;
 	
 	// First we reset all locked flags of all buffers:
-	for (i = 0; i < bufferListCount; i++) bufferList[i].locked = 0;
+	for (i = 1; i < bufferListNext; i++) PsychPABufferHeader(i)->locked = 0;
 	
 	// Scan all open audio devices:
 	for(i = 0; i < MAX_PSYCH_AUDIO_DEVS; i++) {
@@ -374,9 +847,9 @@ psych_bool PsychPAUpdateBufferReferences(void)
 				// Active schedule. Scan it and mark all referenced buffers as locked:
 				for (j = 0; j < audiodevices[i].schedule_size; j++) {
 					// Slot active and with valid bufferhandle?
-					if ((audiodevices[i].schedule[j].mode & 2) && (audiodevices[i].schedule[j].bufferhandle > 0)) {
+					if ((audiodevices[i].schedule[j].mode & 2) && (audiodevices[i].schedule[j].bufferhandle > 0) && (audiodevices[i].schedule[j].bufferhandle < bufferListNext)) {
 						// Mark used and active audiobuffer as locked:
-						bufferList[ audiodevices[i].schedule[j].bufferhandle ].locked = 1;
+						PsychPABufferHeader(audiodevices[i].schedule[j].bufferhandle)->locked = 1;
 						anylocked = TRUE;
 					}
 				}
@@ -393,25 +866,49 @@ int PsychPADeleteAudioBuffer(int handle, int waitmode)
 {
 	// Retrieve buffer:
 	PsychPABuffer* buffer = PsychPAGetAudioBuffer(handle);
-	
-	// Make sure all buffer locked flags are up to date:
-	PsychPAUpdateBufferReferences();
-	
-	// Buffer locked?
-	if (buffer->locked) {
-		// Yes :-( In 'waitmode' zero we fail:
-		if (waitmode == 0) return(0);
-		
-		// In waitmode 1, we retry spin-waiting until buffer available:
-		while (buffer->locked) {
-			PsychYieldIntervalSeconds(yieldInterval);
-			PsychPAUpdateBufferReferences();
+	int bin;
+
+	// Buffer referenced by pending slots of some schedule? Otherwise it can't be in use and we can
+	// skip the scan of all schedules:
+	if (buffer->refcount > 0) {
+		// Make sure all buffer locked flags are up to date:
+		PsychPAUpdateBufferReferences();
+
+		// Buffer locked?
+		if (buffer->locked) {
+			// Yes :-( In 'waitmode' zero we fail:
+			if (waitmode == 0) return(0);
+
+			// In waitmode 1, we retry spin-waiting until buffer available:
+			while (buffer->locked) {
+				PsychYieldIntervalSeconds(yieldInterval);
+				PsychPAUpdateBufferReferences();
+			}
 		}
 	}
-	
-	// Delete buffer:
-	if (NULL != buffer->outputbuffer) free(buffer->outputbuffer);
-	memset(buffer, 0, sizeof(PsychPABuffer));
+
+	// Delete buffer: Bump its generation, so remaining references from schedules of idle devices become invalid:
+	PsychLockMutex(&bufferListmutex);
+	buffer->generation++;
+	buffer->inuse = 0;
+	buffer->refcount = 0;
+	buffer->locked = 0;
+
+	// Retain its memory for reuse if the pool isn't full, otherwise release it:
+	if (bufferPoolRetained + buffer->capacity <= PSYCH_AUDIO_BUFFERPOOL_MAXRETAINED) {
+		bin = PsychPABufferSizeClass(buffer->capacity);
+		buffer->nextFree = bufferFreeBins[bin];
+		bufferFreeBins[bin] = handle;
+		bufferPoolRetained += buffer->capacity;
+	}
+	else {
+		free(buffer->outputbuffer);
+		buffer->outputbuffer = NULL;
+		buffer->capacity = 0;
+		buffer->nextFree = bufferFreeHeaders;
+		bufferFreeHeaders = handle;
+	}
+	PsychUnlockMutex(&bufferListmutex);
 	
 	// Success:
 	return(1);
@@ -521,1844 +1018,3712 @@ void PALogger(const char* msg)
 	return;
 }
 
+// Mixer kernels used by master devices to mix/merge/modulate slave output into their own
+// output buffers. These run once per active slave and callback, so with many slaves they
+// dominate the cost of the master callback. We have vectorized kernels for the most common
+// channel mapping layouts (identity, contiguous block of channels, stereo pairs) and fall
+// back to the scalar code for arbitrary mappings. The SSE2 kernels are available on all
+// builds with SSE2 enabled at compile time, the AVX kernels are selected at runtime, if the
+// cpu and operating system support them. Results are identical for all kernels, as they all
+// apply the same arithmetic operations in the same order to each sample.
 
-// Called exclusively from paCallback, with device-mutex held.
-// Check if a schedule is defined. If not, return repetition, playloop and bufferparameters
-// from the device struct, ie., old behaviour. If yes, check if an update of the schedule is
-// needed (ie., progressing to the next slot) and do so if needed. Return parameters from
-// current slot, or an abort signal if end of schedule reached.
-//
-// Return codes:
-// 0 = Valid buffer and playback parameters assigned. Proceed with audio playback as scheduled.
-// 1 = Regular end of playback or schedule reached. Finish playback.
-// 2 = Error abort, something is totally frelled.
-// 4 = Abort bufferfill operation for this host audio buffer via zerofill, but don't switch to idle mode / don't stop engine.
-//     Instead switch back to hot-standby so playback can be picked up again at a later point in time.
-//	   This is used to reschedule start of playback for a following slot at a later time.
-int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float** ret_playoutbuffer, psych_int64* ret_outsbsize, psych_int64* ret_outsboffset, double* ret_repeatCount, psych_int64* ret_playpositionlimit)
+// Operation to perform for each target sample 'dst' with source sample 'src' and per-channel 'gain':
+#define kPsychPAMixAdd		0	// dst = dst + src * gain	- Regular mixing of slave output.
+#define kPsychPAMixModulate	1	// dst = dst * (src * gain)	- AM modulation of master output by a modulator slave.
+#define kPsychPAMixAssign	2	// dst = src * gain			- Distribution of gain values from a modulator into a slaves buffer.
+
+#define PSYCH_PA_MIXOP(op, d, s) (((op) == kPsychPAMixAdd) ? ((d) + (s)) : (((op) == kPsychPAMixModulate) ? ((d) * (s)) : (s)))
+
+#if PSYCH_PA_USE_SSE2
+#define PSYCH_PA_SSE2_MIXOP(op, d, s) (((op) == kPsychPAMixAdd) ? _mm_add_ps((d), (s)) : (((op) == kPsychPAMixModulate) ? _mm_mul_ps((d), (s)) : (s)))
+
+// Mix a densely packed block of 'count' samples from 'src' into 'dst'. 'pattern' contains the gains
+// for 4 consecutive samples, so the channel count of src and dst must be a divisor of 4:
+static void PsychPAMixFlatSSE2(float* dst, const float* src, const float* pattern, psych_int64 count, int op)
 {
-	psych_int64   loopStartFrame, loopEndFrame;
-	psych_int64  outsbsize, outsboffset;
-	psych_int64  outchannels = dev->outchannels;
-	unsigned int  slotid, cmd;
-	double		  repeatCount;
-	double		  reqTime;
-	psych_int64  playpositionlimit;
-	
-	// NULL-Schedule?
-	if (dev->schedule == NULL) {
-		// Yes: Assign settings from dev-struct:
-		*ret_playoutbuffer = dev->outputbuffer;
-		outsbsize = dev->outputbuffersize / sizeof(float);
+	psych_int64 i;
+	__m128 g = _mm_loadu_ps(pattern);
 
-		// Fetch boundaries of playback loop:
-		loopStartFrame = dev->loopStartFrame;
-		loopEndFrame = dev->loopEndFrame;
-		repeatCount = dev->repeatCount;
+	for (i = 0; i + 4 <= count; i += 4) {
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(&src[i]), g);
+		_mm_storeu_ps(&dst[i], PSYCH_PA_SSE2_MIXOP(op, _mm_loadu_ps(&dst[i]), s));
+	}
 
-		// Revalidate boundaries of playback loop:
-		if (loopStartFrame * outchannels >= outsbsize) loopStartFrame = (outsbsize / outchannels) - 1;
-		if (loopStartFrame < 0) loopStartFrame = 0;
-		if (loopEndFrame * outchannels >= outsbsize) loopEndFrame = (outsbsize / outchannels) - 1;
-		if (loopEndFrame < 0) loopEndFrame = 0;
-		if (loopEndFrame < loopStartFrame) loopEndFrame = loopStartFrame;
-		
-		// Remap defined playback loop to "corrected" outsbsize and offset for later copy-op:
-		outsbsize   = (loopEndFrame - loopStartFrame + 1) * outchannels;
-		outsboffset = loopStartFrame * outchannels;
-		
-		// Compute playpositionlimit, the upper limit of played out samples from loop duration and repeatCount...
-		playpositionlimit = ((psych_int64) (repeatCount * outsbsize));
-		// ...and make sure it ends on integral sample frame boundaries:
-		playpositionlimit -= playpositionlimit % outchannels;
+	for (; i < count; i++) dst[i] = PSYCH_PA_MIXOP(op, dst[i], src[i] * pattern[i & 3]);
+}
 
-		// Check if loop and repetition constraints are still valid:
-		if ( !((repeatCount == -1) || (*playposition < playpositionlimit)) || (NULL == *ret_playoutbuffer)) {
-			// No. Signal regular end of playback:
-			return(1);
+// Mix 'srcchannels' >= 4 slave channels into a contiguous block of master channels, starting at 'base':
+static void PsychPAMixContiguousSSE2(float* dst, psych_int64 dstchannels, psych_int64 base, const float* src, psych_int64 srcchannels, const float* gains, psych_int64 nframes, int op)
+{
+	psych_int64 j, k;
+	float *d;
+
+	for (j = 0; j < nframes; j++) {
+		d = &dst[(j * dstchannels) + base];
+		for (k = 0; k + 4 <= srcchannels; k += 4) {
+			__m128 s = _mm_mul_ps(_mm_loadu_ps(&src[k]), _mm_loadu_ps(&gains[k]));
+			_mm_storeu_ps(&d[k], PSYCH_PA_SSE2_MIXOP(op, _mm_loadu_ps(&d[k]), s));
 		}
+		for (; k < srcchannels; k++) d[k] = PSYCH_PA_MIXOP(op, d[k], src[k] * gains[k]);
+		src += srcchannels;
 	}
-	else {
-		// No: Real schedule:
-		
-		do {
-			// Find current slot (with wraparound):
-			slotid = dev->schedule_pos % dev->schedule_size;
-			
-			// Current slot valid and pending?
-			if ((dev->schedule[slotid].mode & 2) == 0) {
-				// No: End of schedule reached - Signal regular abort request and that's it:
-				return(1);
-			}
-			
-			// Current slot is valid: Assign it:
-			cmd = dev->schedule[slotid].command;
-			if (cmd > 0) {
-				// Special command buffer: Doesn't contain sound, but some special
-				// control commands. Process it, then advance to next slot...
-				
-				// This makes sure we repeat the loop, advancing to the next slot:
-				*ret_playoutbuffer = NULL;
-				outsbsize = 0;
+}
 
-				// Compute absolute deadline from given tWhen timespec and type of timespec:
-				if (cmd & 4)  reqTime = dev->schedule[slotid].tWhen;						// Absolute system time specified.
-                // Relative to last requested start time. We use last true start time as fallback if the requested start time is undefined:
-				if (cmd & 8)  reqTime = ((dev->reqStartTime > 0.0) ? dev->reqStartTime : dev->startTime) + dev->schedule[slotid].tWhen;
-				if (cmd & 16) reqTime = dev->startTime + dev->schedule[slotid].tWhen;		// Relative to last true start time.
-				// TODO: The following two "end time" related ones are pretty broken - Can't
-				// work the way i want it to work, as relevant information is not available at
-				// the time we'd need it, ie., at this point in execution flow...
-				// Need to think about this, or scrap the idea of end-time related timeoffsets...
-				if (cmd & 32) reqTime = dev->reqStopTime + dev->schedule[slotid].tWhen;		// Relative to last requested end time.
-				if (cmd & 64) reqTime = dev->estStopTime + dev->schedule[slotid].tWhen;		// Relative to last true end time.
-				
-				// Pause-playback-and-restart command?
-				if (cmd & 1) {
-					// Yes. We should abort playback at this point, ie. fill the remainder
-					// of the audiobuffer with silence. Then we shall switch back to hot-standby
-					// and reschedule ourselves for restart of playback at a given target reqTime:
-					dev->reqStartTime = reqTime;
+// Mix a stereo slave into a pair of adjacent master channels, starting at 'base'. Processes two
+// sample frames per iteration, gathering the two target channel pairs via 64-bit loads/stores:
+static void PsychPAMixStereoSSE2(float* dst, psych_int64 dstchannels, psych_int64 base, const float* src, const float* gains, psych_int64 nframes, int op)
+{
+	psych_int64 j;
+	float *d0, *d1;
+	__m128 g = _mm_set_ps(gains[1], gains[0], gains[1], gains[0]);
+
+	for (j = 0; j + 2 <= nframes; j += 2) {
+		__m128 d, s;
+		d0 = &dst[(j * dstchannels) + base];
+		d1 = d0 + dstchannels;
+		d = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*) d0), (const __m64*) d1);
+		s = _mm_mul_ps(_mm_loadu_ps(&src[j * 2]), g);
+		d = PSYCH_PA_SSE2_MIXOP(op, d, s);
+		_mm_storel_pi((__m64*) d0, d);
+		_mm_storeh_pi((__m64*) d1, d);
+	}
+
+	// Odd trailing frame:
+	if (j < nframes) {
+		d0 = &dst[(j * dstchannels) + base];
+		d0[0] = PSYCH_PA_MIXOP(op, d0[0], src[j * 2] * gains[0]);
+		d0[1] = PSYCH_PA_MIXOP(op, d0[1], src[j * 2 + 1] * gains[1]);
+	}
+}
+#endif
 
-					// Manually invalidate this slot and advance schedule to next one:
-					*playposition = 0;
-					// Only disable if the flag 4 aka "don't auto-disable" isn't set:
-					if (!(dev->schedule[slotid].mode & 4)) dev->schedule[slotid].mode &= ~2;
-					dev->schedule_pos++;
+#if PSYCH_PA_USE_AVX
+#define PSYCH_PA_AVX_MIXOP(op, d, s) (((op) == kPsychPAMixAdd) ? _mm256_add_ps((d), (s)) : (((op) == kPsychPAMixModulate) ? _mm256_mul_ps((d), (s)) : (s)))
 
-					// Return with special code 4 to reschedule:
-					return(4);
-				}
+// AVX version of PsychPAMixFlatSSE2: 'pattern' has gains for 8 consecutive samples:
+static PSYCH_PA_AVX_TARGET void PsychPAMixFlatAVX(float* dst, const float* src, const float* pattern, psych_int64 count, int op)
+{
+	psych_int64 i;
+	__m256 g = _mm256_loadu_ps(pattern);
 
-				// Reschedule end-of-playback command?
-				if (cmd & 2) {
-					// Yes. We should end playback at given target reqTime, then go idle:
-					dev->reqStopTime = reqTime;
+	for (i = 0; i + 8 <= count; i += 8) {
+		__m256 s = _mm256_mul_ps(_mm256_loadu_ps(&src[i]), g);
+		_mm256_storeu_ps(&dst[i], PSYCH_PA_AVX_MIXOP(op, _mm256_loadu_ps(&dst[i]), s));
+	}
+	_mm256_zeroupper();
 
-					// Nothing further to do here. Will auto-advance to next schedule slot after
-					// this one, possibly outputting further sound...
-				}
-				
-				// End of command buffer processing.
-			} // Regular audio buffer: First assign outbuffer size and pointer...
-			else if (dev->schedule[slotid].bufferhandle <= 0) {
-				// Default device playoutbuffer:
-				*ret_playoutbuffer = dev->outputbuffer;
-				outsbsize = dev->outputbuffersize / sizeof(float);
-			}
-			else
-			{
-				// Dynamic buffer: Dereference bufferhandle and fetch buffer data for later use:
-				
-				// Need to lock bufferList lock to do this:
-				PsychLockMutex(&bufferListmutex);
+	for (; i < count; i++) dst[i] = PSYCH_PA_MIXOP(op, dst[i], src[i] * pattern[i & 7]);
+}
 
-				if (bufferList && (dev->schedule[slotid].bufferhandle < bufferListCount)) {
-					// Fetch pointer to actual audio data buffer:
-					*ret_playoutbuffer = bufferList[dev->schedule[slotid].bufferhandle].outputbuffer;
-					
-					// Retrieve buffersize in samples:
-					outsbsize = bufferList[dev->schedule[slotid].bufferhandle].outputbuffersize / sizeof(float);
-					
-					// Another child protection:
-					if (outchannels != bufferList[dev->schedule[slotid].bufferhandle].outchannels) {
-						*ret_playoutbuffer = NULL;
-						outsbsize = 0;
-					}
-				}
-				else {
-					*ret_playoutbuffer = NULL;
-					outsbsize = 0;
-				}
-				
-				// Unlock bufferList mutex again:
-				PsychUnlockMutex(&bufferListmutex);
-			}
+// AVX version of PsychPAMixContiguousSSE2 for 'srcchannels' >= 8:
+static PSYCH_PA_AVX_TARGET void PsychPAMixContiguousAVX(float* dst, psych_int64 dstchannels, psych_int64 base, const float* src, psych_int64 srcchannels, const float* gains, psych_int64 nframes, int op)
+{
+	psych_int64 j, k;
+	float *d;
+
+	for (j = 0; j < nframes; j++) {
+		d = &dst[(j * dstchannels) + base];
+		for (k = 0; k + 8 <= srcchannels; k += 8) {
+			__m256 s = _mm256_mul_ps(_mm256_loadu_ps(&src[k]), _mm256_loadu_ps(&gains[k]));
+			_mm256_storeu_ps(&d[k], PSYCH_PA_AVX_MIXOP(op, _mm256_loadu_ps(&d[k]), s));
+		}
+		for (; k < srcchannels; k++) d[k] = PSYCH_PA_MIXOP(op, d[k], src[k] * gains[k]);
+		src += srcchannels;
+	}
+	_mm256_zeroupper();
+}
 
-			// ... then loop and repeat parameters:
-			loopStartFrame = dev->schedule[slotid].loopStartFrame;
-			loopEndFrame   = dev->schedule[slotid].loopEndFrame;
-			repeatCount    = dev->schedule[slotid].repetitions;
-			
-			// Revalidate boundaries of playback loop:
-			if (loopStartFrame * outchannels >= outsbsize) loopStartFrame = (outsbsize / outchannels) - 1;
-			if (loopStartFrame < 0) loopStartFrame = 0;
-			if (loopEndFrame * outchannels >= outsbsize) loopEndFrame = (outsbsize / outchannels) - 1;
-			if (loopEndFrame < 0) loopEndFrame = 0;
-			if (loopEndFrame < loopStartFrame) loopEndFrame = loopStartFrame;
-			
-			// Remap defined playback loop to "corrected" outsbsize and offset for later copy-op:
-			outsbsize = (psych_int64) ((loopEndFrame - loopStartFrame + 1) * outchannels);
-			outsboffset = (psych_int64) (loopStartFrame * outchannels);
-			
-			// Compute playpositionlimit, the upper limit of played out samples from loop duration and repeatCount...
-			playpositionlimit = ((psych_int64) (repeatCount * outsbsize));
-			// ...and make sure it ends on integral sample frame boundaries:
-			playpositionlimit -= playpositionlimit % outchannels;
-			
-			// Check if loop and repetition constraints as well as actual audio buffer for this slot are still valid:
-			if ( !((repeatCount == -1) || (*playposition < playpositionlimit)) || (NULL == *ret_playoutbuffer) ) {
-				// Constraints violated. This slot is used up: Reset playposition and advance to next slot:
-				*playposition = 0;
-				// Only disable if the flag 4 aka "don't auto-disable" isn't set:
-				if (!(dev->schedule[slotid].mode & 4)) dev->schedule[slotid].mode &= ~2;
-				dev->schedule_pos++;
-			}
-			else {
-				// Constraints ok, break out of do-while slot advance loop:
-				break;
-			}
-		} while(TRUE);
+static PSYCH_PA_AVX_TARGET void PsychPAFillFloatsAVX(float* buf, float value, psych_int64 count)
+{
+	psych_int64 i;
+	__m256 v = _mm256_set1_ps(value);
+
+	for (i = 0; i + 8 <= count; i += 8) _mm256_storeu_ps(&buf[i], v);
+	_mm256_zeroupper();
+	for (; i < count; i++) buf[i] = value;
+}
+#endif
+
+// Detect best mixer kernel level supported by the build, cpu and operating system:
+static int PsychPADetectMixSIMDLevel(void)
+{
+	int level = kPsychPAMixScalar;
+
+	#if PSYCH_PA_USE_SSE2
+	level = kPsychPAMixSSE2;
+	#endif
+
+	#if PSYCH_PA_USE_AVX
+	{
+		#if defined(_MSC_VER)
+		int cpuinfo[4];
+		__cpuid(cpuinfo, 1);
+		// AVX supported by cpu, and AVX register state saving (OSXSAVE + XCR0 bits 1 and 2) enabled by the OS?
+		if ((cpuinfo[2] & (1 << 28)) && (cpuinfo[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6)) level = kPsychPAMixAVX;
+		#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx")) level = kPsychPAMixAVX;
+		#endif
 	}
-	
-	*ret_outsbsize = outsbsize;
-	*ret_outsboffset = outsboffset;
-	*ret_repeatCount = repeatCount;
-	*ret_playpositionlimit = playpositionlimit;
+	#endif
 
-	// Safety check: If playoutbuffer is NULL at this point, then somethings screwed
-	// and we request abort of playback:
-	if (NULL == *ret_playoutbuffer) return(2);
+	return(level);
+}
 
-	// Return 0 exit to signal a valid update:
-	return(0);
+// Fill 'count' floats in 'buf' with 'value'. Used to prefill slave output and gain buffers with neutral gain:
+static void PsychPAFillFloats(float* buf, float value, psych_int64 count)
+{
+	psych_int64 i = 0;
+
+	#if PSYCH_PA_USE_AVX
+	if (mixSIMDLevel >= kPsychPAMixAVX) {
+		PsychPAFillFloatsAVX(buf, value, count);
+		return;
+	}
+	#endif
+
+	#if PSYCH_PA_USE_SSE2
+	if (mixSIMDLevel >= kPsychPAMixSSE2) {
+		__m128 v = _mm_set1_ps(value);
+		for (; i + 4 <= count; i += 4) _mm_storeu_ps(&buf[i], v);
+	}
+	#endif
+
+	for (; i < count; i++) buf[i] = value;
 }
 
-/* paCallback: PortAudo I/O processing callback. 
- *
- * This callback is called by PortAudios playback/capture engine whenever
- * it needs new data for playback or has new data from capture. We are expected
- * to take the inputBuffer's content and store it in our own recording buffers,
- * and push data from our playback buffer queue into the outputBuffer.
- *
- * timeInfo tells us useful timing information, so we can estimate latencies,
- * compensate for them, and so on...
- *
- * This callback is part of a realtime/interrupt/system context so don't do
- * things like calling PortAudio functions, allocating memory, file i/o or
- * other unbounded operations!
- */
-static int paCallback( const void *inputBuffer, void *outputBuffer,
-                             unsigned long framesPerBuffer,
-                             const PaStreamCallbackTimeInfo* timeInfo,
-                             PaStreamCallbackFlags statusFlags,
-                             void *userData )
+// Mix, modulate or assign 'nframes' sample frames of 'srcchannels' channel slave data in 'src' into the 'dstchannels'
+// channel buffer 'dst', routing slave channel k to target channel mappings[k] and applying per-channel gains[k] to
+// each source sample. 'op' is one of kPsychPAMixAdd, kPsychPAMixModulate or kPsychPAMixAssign:
+static void PsychPAMixSlaveChannels(float* dst, psych_int64 dstchannels, const float* src, psych_int64 srcchannels, const int* mappings, const float* gains, psych_int64 nframes, int op)
 {
-	// Assign all variables, especially our dev device structure
-	// with info about this stream:
-	PsychPADevice* dev = (PsychPADevice*) userData;
-	float *out = (float*) outputBuffer;
-	float *in = (float*) inputBuffer;
-	float *playoutbuffer;
-	float *tmpBuffer, *mixBuffer;
-	float masterVolume, neutralValue;
-	psych_int64  j, k;
-	psych_int64 i, silenceframes, committedFrames, max_i;
-	psych_int64 inchannels, outchannels;
-	psych_int64  playposition, outsbsize, insbsize, recposition;
-	psych_int64  outsboffset;
-	unsigned int reqstate;
-	double now, firstsampleonset, onsetDelta, offsetDelta, captureStartTime, tMonotonic;
-	double repeatCount;	
-	psych_int64 playpositionlimit;
-	PaHostApiTypeId hA;
-	psych_bool stopEngine;
-	psych_bool isMaster, isSlave;
-	int slaveId, modulatorSlave, parc, numSlavesHandled;
+	psych_int64 j, k;
+	float *d;
 
-	// Device struct attached to stream? If no device struct
-	// is attached, we can't continue and tell the engine to abort
-	// processing of this stream:
-	if (dev == NULL) return(paAbort);
-	
-	// Define our role:
-	isMaster = (dev->opmode & kPortAudioIsMaster) ? TRUE : FALSE;
-	isSlave = (dev->opmode & kPortAudioIsSlave) ? TRUE : FALSE;
-	
-	// Query host API: Done without mutex held, as it doesn't change during device lifetime:
-	hA=dev->hostAPI;
+	if ((nframes <= 0) || (srcchannels <= 0)) return;
 
-	// Only compute timestamps from raw data if we're not a slave:
-	if (!isSlave) {
-		// Buffer timestamp computation code:
-		//
-		// This is executed at each callback iteration to provide PTB timebase onset times for
-		// the very first sample in this output buffer.
-		//
-		// The code is time-critical: To be executed as soon as possible after paCallback invocation,
-		// therefore at the beginning of control-flow before trying to lock (and potentially stall at) the device mutex!
-		//
-		// Executing without the mutex locked is safe: It only modifies/reads local variables, and only
-		// reads a few device struct variables which are all guaranteed to remain constant while the
-		// engine is running.
-		
-#if PSYCH_SYSTEM == PSYCH_WINDOWS
-		// Super ugly hack for the most broken system in existence: Force
-		// the audio thread to cpu core 1, hope that repeated redundant
-		// calls don't create scheduling overhead or excessive other overhead.
-		// The explanation for this can be found in Source/Windows/Base/PsychTimeGlue.c
-		if (lockToCore1) SetThreadAffinityMask(GetCurrentThread(), 1);
-#endif
-		
-		// Retrieve current system time:
-		PsychGetAdjustedPrecisionTimerSeconds(&now);
-		
-		// FIXME: PortAudio stable sets timeInfo->currentTime == 0 --> Breakage!!!
-		// That's why we currently have our own PortAudio version.
-		
-		#if PSYCH_SYSTEM == PSYCH_LINUX
-		if (hA == paALSA) {
-			// ALSA on Linux can return timestamps in CLOCK_MONOTONIC time
-			// instead of our standard GetSecs() [gettimeofday] timesbase.
-			// It is up to the audio driver and its config, which one is returned.
-			//
-			// This effect was first noticed during testing on Ubuntu 10.04 LTS,
-			// so this will be part of all PTB releases after 8.5.2010.
-			//
-			// Therefore we need to check if CLOCK_MONOTONIC time is returned
-			// and remap such timestamps to our standard GetSecs timebase before
-			// further processing.
+	#if PSYCH_PA_USE_SSE2
+	if (mixSIMDLevel >= kPsychPAMixSSE2) {
+		psych_int64 base = mappings[0];
+		float pattern[8];
 
-			// Get current CLOCK_MONOTONIC time:
-			tMonotonic = PsychOSGetLinuxMonotonicTime();
-			
-			// Returned current time timestamp closer to tMonotonic than to GetSecs time?
-			if (fabs(timeInfo->currentTime - tMonotonic) < fabs(timeInfo->currentTime - now)) {
-				// Timestamps are in monotonic time! Need to remap.
-				// tMonotonic shall be the offset between GetSecs and monotonic time,
-				// i.e., the offset that needs to be added to monotonic timestamps to
-				// remap them to GetSecs time:
-				tMonotonic = now - tMonotonic;
-				
-				// Correct all PortAudio timestamps by adding corrective offset:
-				((PaStreamCallbackTimeInfo*) timeInfo)->currentTime += tMonotonic;
-				((PaStreamCallbackTimeInfo*) timeInfo)->outputBufferDacTime += tMonotonic;
-				((PaStreamCallbackTimeInfo*) timeInfo)->inputBufferAdcTime += tMonotonic;
-			}
-		}
-		#endif
-		
-		if (hA==paCoreAudio || hA==paDirectSound || hA==paMME || hA==paALSA) {
-			// On these systems, DAC-time is already returned in the system timebase,
-			// at least with our modified version of PortAudio, so a simple
-			// query will return the onset time of the first sample. Well,
-			// looks as if we need to add the device inherent latency, because
-			// this describes everything up to the point where DMA transfer is
-			// initiated, but not device inherent latency. This additional latency
-			// is added via latencyBias, which is initialized in the Open-Function
-			// via a low-level driver query to CoreAudio:
-			if (dev->opmode & kPortAudioPlayBack) {
-				// Playback enabled: Use DAC time as basis for timing:
-				firstsampleonset = (double) timeInfo->outputBufferDacTime + dev->latencyBias;
+		// Are the slave channels mapped to a contiguous block of target channels?
+		for (k = 1; k < srcchannels; k++) if (mappings[k] != base + k) break;
+
+		if (k == srcchannels) {
+			// Yes. Identity mapping of all channels, with a channel count that divides the vector width?
+			// Then we can process the buffers as flat sample arrays with a repeating gain pattern:
+			if ((base == 0) && (srcchannels == dstchannels) && (8 % srcchannels == 0)) {
+				for (k = 0; k < 8; k++) pattern[k] = gains[k % srcchannels];
+
+				#if PSYCH_PA_USE_AVX
+				if (mixSIMDLevel >= kPsychPAMixAVX) {
+					PsychPAMixFlatAVX(dst, src, pattern, nframes * srcchannels, op);
+					return;
+				}
+				#endif
+
+				if (4 % srcchannels == 0) {
+					PsychPAMixFlatSSE2(dst, src, pattern, nframes * srcchannels, op);
+					return;
+				}
 			}
-			else {
-				// Recording (only): Use ADC time as basis for timing:
-				firstsampleonset = (double) timeInfo->inputBufferAdcTime + dev->latencyBias;
+
+			// Stereo slave mapped to a pair of adjacent target channels?
+			if (srcchannels == 2) {
+				PsychPAMixStereoSSE2(dst, dstchannels, base, src, gains, nframes, op);
+				return;
 			}
-			
-			// Compute estimated capturetime in captureStartTime. This is only important in
-			// full-duplex mode, redundant in pure half-duplex capture mode:
-			captureStartTime = (double) timeInfo->inputBufferAdcTime;
-		}
-		else {
-			// ASIO or unknown. ASIO needs to be checked, which category is correct.
-			// Not yet verified how these other audio APIs behave. Play safe
-			// and perform timebase remapping: This also needs our special fixed
-			// PortAudio version where currentTime actually has a value:
-			if (dev->opmode & kPortAudioPlayBack) {
-				// Playback enabled: Use DAC time as basis for timing:
-				// Assign predicted (remapped to our time system) audio onset time for this buffer:
-				firstsampleonset = now + ((double) (timeInfo->outputBufferDacTime - timeInfo->currentTime)) + dev->latencyBias;
+
+			// Wide enough block of channels to vectorize across channels within each frame?
+			#if PSYCH_PA_USE_AVX
+			if ((mixSIMDLevel >= kPsychPAMixAVX) && (srcchannels >= 8)) {
+				PsychPAMixContiguousAVX(dst, dstchannels, base, src, srcchannels, gains, nframes, op);
+				return;
 			}
-			else {
-				// Recording (only): Use ADC time as basis for timing:
-				// Assign predicted (remapped to our time system) audio onset time for this buffer:
-				firstsampleonset = now + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime)) + dev->latencyBias;
+			#endif
+
+			if (srcchannels >= 4) {
+				PsychPAMixContiguousSSE2(dst, dstchannels, base, src, srcchannels, gains, nframes, op);
+				return;
 			}
-			
-			// Compute estimated capturetime in captureStartTime. This is only important in
-			// full-duplex mode, redundant in pure half-duplex capture mode:
-			captureStartTime = now + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime));
 		}
-		
-		if (FALSE) {
-			// Debug code to compare our two timebases against each other: On OS/X,
-			// luckily both timebases are identical, ie. our UpTime() timebase used
-			// everywhere in PTB and the CoreAudio AudioHostClock() are identical.
-			psych_uint64 ticks;
-			double  tickssec;
-			PsychGetPrecisionTimerTicksPerSecond(&tickssec);
-			PsychGetPrecisionTimerTicks(&ticks);
-			printf("AudioHostClock: %lf   vs. System clock: %lf\n", ((double) (psych_int64) ticks) / tickssec, now); 
+	}
+	#endif
+
+	// Scalar fallback for arbitrary channel mappings:
+	for (j = 0; j < nframes; j++) {
+		d = &dst[j * dstchannels];
+		// Iterate over all source channels in the slave buffer:
+		for (k = 0; k < srcchannels; k++) {
+			d[mappings[k]] = PSYCH_PA_MIXOP(op, d[mappings[k]], *(src++) * gains[k]);
+		}
+	}
+}
+
+
+// Convert 'count' user supplied sound samples from either double() matrix 'indata' or single() matrix 'indatafloat'
+// into our internal float format in 'dst', premultiplied with PA_ANTICLAMPGAIN. The SSE2 path performs exactly the
+// same double precision multiply and rounding to float as the scalar path, so results are bit-identical:
+static void PsychPACopyInSamples(float* dst, const double* indata, const float* indatafloat, psych_int64 count)
+{
+	psych_int64 i = 0;
+
+	#if PSYCH_PA_USE_SSE2
+	__m128d gain = _mm_set1_pd(PA_ANTICLAMPGAIN);
+	__m128 s;
+
+	if (indata) {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(&dst[i], _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(&indata[i]), gain)),
+												 _mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(&indata[i + 2]), gain))));
 		}
-		
-		// End of timestamp computation:
-		// If audio capture is active, then captureStartTime contains the running estimate of when the first input sample
-		// in inbuffer was hitting the audio input - This will be used in state 1 aka hotstandby when deciding to actually start "real" capture.
-		//
-		// now contains system time when entering this callback - Time in PTB timebase.
-		//
-		// Most importantly: firstsampleonset contains the estimated onset time (in PTB timebase) of the first sample that
-		// we will store in the outputbuffer during this callback invocation. This timestamp is used in multiple places below,
-		// e.g., in hotstandby mode (state == 1) to decide when to start actual playback by switching to state 2 and emitting
-		// samples to the outputbuffer. Also used if a specific reqEndTime is selected, ie., a sound offset at a scheduled
-		// offset time to compute when to stop. It's also used for checking for skipped buffers and other problems...		
 	}
 	else {
-		// We're a slave device: Just fetch precooked timestamps from our master:
-		firstsampleonset = audiodevices[dev->pamaster].firstsampleonset;
-		captureStartTime = audiodevices[dev->pamaster].cst;
-		now = audiodevices[dev->pamaster].now;
+		for (; i + 4 <= count; i += 4) {
+			s = _mm_loadu_ps(&indatafloat[i]);
+			_mm_storeu_ps(&dst[i], _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(_mm_cvtps_pd(s), gain)),
+												 _mm_cvtpd_ps(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(s, s)), gain))));
+		}
 	}
-	
-	// Cache cooked timestamps:
-	dev->firstsampleonset = firstsampleonset;
-	dev->cst = captureStartTime;
-	dev->now = now;
-	
-	// Acquire device lock: We'll likely hold it until exit from paCallback:
-	PsychPALockDeviceMutex(dev);
-	
-	// Cache requested state:
-	reqstate = dev->reqstate;
+	#endif
 
-	// Count total number of calls:
-	dev->paCalls++;
-	
-	// Call number of timestamp failures:
-	if (timeInfo->currentTime == 0) dev->noTime++;
-	
-	// Keep track of maximum number of frames requested:
-	if (dev->batchsize < (psych_int64) framesPerBuffer) dev->batchsize = (psych_int64) framesPerBuffer;
-	
-	// Keep track of buffer over-/underflows:
-	if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) dev->xruns++;
+	if (indata) {
+		for (; i < count; i++) dst[i] = (float) (PA_ANTICLAMPGAIN * indata[i]);
+	}
+	else {
+		for (; i < count; i++) dst[i] = (float) (PA_ANTICLAMPGAIN * indatafloat[i]);
+	}
+}
 
-	// Reset number of already committed sample frames for this buffer fill iteration to zero:
-	// This is a running count of how much of the current output buffer has been filled with
-	// sound content (ie., not simply zero silence padding frames):
-	committedFrames = 0;
+// Copy 'count' internal float sound samples from 'src' to either a double() output matrix 'outdata' or a
+// single() output matrix 'outdatafloat'. The single() case is a plain memcpy():
+static void PsychPACopyOutSamples(double* outdata, float* outdatafloat, const float* src, psych_int64 count)
+{
+	psych_int64 i = 0;
 
-	// NULL-out pointer to buffer with sound data to play. It will get initialized later on
-	// in PsychPAProcessSchedule():
-	playoutbuffer = NULL;
+	#if PSYCH_PA_USE_SSE2
+	__m128 s;
+	#endif
 
-	// Query number of output channels:
-	outchannels = (psych_int64) dev->outchannels;
+	if (outdatafloat) {
+		memcpy(outdatafloat, src, (size_t) count * sizeof(float));
+		return;
+	}
 
-	// Query number of output channels:
-	inchannels = (psych_int64) dev->inchannels;
-	
-	// Query number of repetitions:
-	repeatCount = dev->repeatCount;
-	
-	// Get our current playback position in samples (not frames or bytes!!):
-	playposition = dev->playposition;
-	recposition = dev->recposition;
+	#if PSYCH_PA_USE_SSE2
+	for (; i + 4 <= count; i += 4) {
+		s = _mm_loadu_ps(&src[i]);
+		_mm_storeu_pd(&outdata[i], _mm_cvtps_pd(s));
+		_mm_storeu_pd(&outdata[i + 2], _mm_cvtps_pd(_mm_movehl_ps(s, s)));
+	}
+	#endif
 
-	// Compute size of soundbuffers in samples:
-	outsbsize = dev->outputbuffersize / sizeof(float);
-	insbsize = dev->inputbuffersize / sizeof(float);
-	
-	// Cache masterVolume locally for higher efficiency in integration loops:
-	masterVolume = dev->masterVolume;
-	
-	// Assign 1 as neutral value for AM modulator slaves, as 1 is the neutral
-	// element for gain-modulation (multiplication), as opposed to zero as neutral
-	// element for mixing and for outputting "silence":
-	neutralValue = (dev->opmode & kPortAudioIsAMModulator) ? 1.0 : 0;
+	for (; i < count; i++) outdata[i] = (double) src[i];
+}
 
-	// Requested logical playback state is "stopped" or "aborting" ? If so, abort.
-	if ((reqstate == 0) || (reqstate == 3)) {		
-		// Set estimated stop time to last committed sample time, unless it is already set from
-		// a previous callback invocation:
-		if (dev->estStopTime == 0) dev->estStopTime = dev->currentTime;
+// Generate a linear ramp of 'count' values, starting at 'start' and incrementing by 'step' per value:
+static void PsychPARampLinear(float* ramp, float start, float step, psych_int64 count)
+{
+	psych_int64 j = 0;
 
-		// Acknowledge request by resetting it:
-		dev->reqstate = 255;
-		
-		// Update "true" state to inactive:
-		dev->state = 0;
+	#if PSYCH_PA_USE_SSE2
+	__m128 idx = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+	__m128 four = _mm_set1_ps(4.0f);
+	__m128 vstart = _mm_set1_ps(start);
+	__m128 vstep = _mm_set1_ps(step);
 
-		// Signal state change:
-		PsychPASignalChange(dev);
+	for (; j + 4 <= count; j += 4) {
+		_mm_storeu_ps(&ramp[j], _mm_add_ps(vstart, _mm_mul_ps(vstep, idx)));
+		idx = _mm_add_ps(idx, four);
+	}
+	#endif
 
-		// Release mutex here, because dev->runMode never changes below us, and
-		// all other ops are on local variables:
-		PsychPAUnlockDeviceMutex(dev);
-		
-		// Prime the outputbuffer with silence, so playback is effectively stopped:
-		if (outputBuffer && !isSlave) memset(outputBuffer, 0, (size_t) framesPerBuffer * outchannels * sizeof(float));
+	for (; j < count; j++) ramp[j] = start + step * (float) j;
+}
 
-		if (dev->runMode == 0) {
-			// Runmode 0: We shall really stop the engine:
-			
-			// Either paComplete gracefully, playing out pending buffers, or
-			// request a hard paAbort if abortion is requested:
-			return((reqstate == 0) ? paComplete : paAbort);
-		}
-		else {
-			// Runmode 1: We just "idle", ie., set our state to "idle" and return with
-			// no further operations. Future invocations of the callback will also turn
-			// into no-ops due to the nominal idle state:
-			return(paContinue);
-		}
+// Generate an exponential ramp of 'count' values, starting at 'start' and multiplied by 'factor' per value:
+static void PsychPARampExponential(float* ramp, float start, float factor, psych_int64 count)
+{
+	psych_int64 j = 0;
+
+	#if PSYCH_PA_USE_SSE2
+	__m128 v = _mm_set_ps(start * factor * factor * factor, start * factor * factor, start * factor, start);
+	__m128 f4 = _mm_set1_ps(factor * factor * factor * factor);
+
+	for (; j + 4 <= count; j += 4) {
+		_mm_storeu_ps(&ramp[j], v);
+		v = _mm_mul_ps(v, f4);
 	}
 
-	// Are we in a nominally "idle" / inactive state?
-	if (dev->state == 0) {
-		// We are effectively idle, but the engine shall keep running. This is usually
-		// the case in runMode > 0. Here we "simulate" idle state by simply outputting
-		// silence and then returning control to PortAudio:
-		
-		// Set estimated stop time to last committed sample time, unless it is already set from
-		// a previous callback invocation:
-		if (dev->estStopTime == 0) dev->estStopTime = dev->currentTime;
-		
-		// Release mutex here, as memset() only operates on "local" data:
-		PsychPAUnlockDeviceMutex(dev);
-		
-		// Prime the outputbuffer with silence to simulate a stopped audio device:
-		if (outputBuffer && !isSlave) memset(outputBuffer, 0, (size_t) framesPerBuffer * outchannels * sizeof(float));
+	// Continue scalar tail from first lane of next vector:
+	start = _mm_cvtss_f32(v);
+	#endif
 
-		// Done:
-		return(paContinue);
+	for (; j < count; j++) {
+		ramp[j] = start;
+		start *= factor;
 	}
+}
 
-	// This point is only reached in hot-standby or active playback/capture/feedback modes:
+// Multiply 'nframes' sample frames of 'channels' channel audio in 'buf' with the per-frame gains in 'ramp'.
+// All channels are multiplied if 'channel' is negative, otherwise only channel 'channel':
+static void PsychPAApplyRamp(float* buf, psych_int64 channels, int channel, const float* ramp, psych_int64 nframes)
+{
+	psych_int64 j = 0, k;
 
-	// Are we already playing back and/or capturing real audio data,
-	// or are we still on hot-standby? PsychPortAudio tries to start
-	// playback/capture of a sound exactly at a requested point in
-	// system time (i.e. the first sound sample should hit the speaker
-	// as closely as possible to that point in time) by use of the
-	// following trick: When the user script executes PsychPortAudio('Start'),
-	// our routine immediately starts processing of the portaudio stream,
-	// starting up the audio hardwares DACs/ADCs and Portaudios engine.
-	// After a short latency, our paCallback() (this routine) gets called
-	// by the realtime audio scheduler, requesting or providing audio sample
-	// data. In the provided timeInfo - variable, we are provided with the
-	// current playback time of the audio device (in seconds since stream start)
-	// and an estimate of when our first provided sample will hit the speakers.
-	// We convert these timestamps into system time, so we'll know how far the user
-	// provided onset deadline is away. If the deadline is far away, so the samples
-	// for this callback iteration would hit the speaker too early, we simply return
-	// a zero filled outputbuffer --> We output silence. If the deadline is somewhere
-	// in the middle of this outputbuffer, we fill the appropriate amount of bufferspace
-	// with zeros, then copy in our first real samples into the remaining buffer.
-	// After that, we switch to real playback, all future calls will provide PA
-	// with real sampledata. Assuming the sound onset estimate provided by PA is
-	// correct, this should allow accurate sound onset. It all depends on the
-	// latency estimate...
-	
-	// Hot standby?
-	if (dev->state == 1) {
-		// Hot standby: Compare running buffer timestamps 'now', 'firstsampleonset' and 'captureStartTime'
-		// to requested sound onset time and decide if and when to start playback and capture:
-		
-		// Store our measured/updated PortAudio + HostAPI + Driver + Hardware latency:
-		// We'll update the running estimate until transition from hot standby to active:
-		dev->predictedLatency = firstsampleonset - now;
+	#if PSYCH_PA_USE_SSE2
+	__m128 r;
 
-		// Ditto for capture starttime:
-		if (dev->opmode & kPortAudioCapture) {
-			// Store estimated capturetime in captureStartTime. This is only important in
-			// full-duplex mode, redundant in pure half-duplex capture mode.
-			// If we're not a regular input capture device, but a output capture device,
-			// then our effective captureStartTime is the *playback* starttime, as we're
-			// capturing what is fed to the outputs/speakers, not what comes from the inputs!
-			dev->captureStartTime = (dev->opmode & kPortAudioIsOutputCapture) ? firstsampleonset : captureStartTime;
+	if ((channel < 0) && (channels == 1)) {
+		for (; j + 4 <= nframes; j += 4) _mm_storeu_ps(&buf[j], _mm_mul_ps(_mm_loadu_ps(&buf[j]), _mm_loadu_ps(&ramp[j])));
+	}
+	else if ((channel < 0) && (channels == 2)) {
+		for (; j + 4 <= nframes; j += 4) {
+			r = _mm_loadu_ps(&ramp[j]);
+			_mm_storeu_ps(&buf[2 * j], _mm_mul_ps(_mm_loadu_ps(&buf[2 * j]), _mm_unpacklo_ps(r, r)));
+			_mm_storeu_ps(&buf[2 * j + 4], _mm_mul_ps(_mm_loadu_ps(&buf[2 * j + 4]), _mm_unpackhi_ps(r, r)));
 		}
-		
-		// Compute difference between requested onset time and presentation time
-		// of the first sample of this callbacks returned buffer:
-		onsetDelta = dev->reqStartTime - firstsampleonset;
-		
-		// Time left until onset and in playback mode?
-		if ((onsetDelta > 0) && (dev->opmode & kPortAudioPlayBack)) {
-			// Some time left: A full buffer duration?
-			if (onsetDelta >= ((double) framesPerBuffer / (double) dev->streaminfo->sampleRate)) {
-				// At least one buffer away...
-				
-				// Release mutex, as remainder only operates on locals:
-				PsychPAUnlockDeviceMutex(dev);
-				
-				// At least one buffer away. Fill our buffer with zeros, aka silence:
-				if (!isSlave) memset(outputBuffer, 0, (size_t) framesPerBuffer * outchannels * sizeof(float));
-				
-				// Ready. Tell engine to continue stream processing, i.e., call us again...
-				return(paContinue);
-			}
-			else {
-				// A bit time left, but less than a full buffer. Need to pad the head of
-				// this buffer with zeros, aka silence, then fill the rest with real data:
-				silenceframes = (psych_int64) (onsetDelta * ((double) dev->streaminfo->sampleRate));
+	}
+	#endif
 
-				// Fill in some silence:
-				if (neutralValue == 0) {
-					// Fast-path: Zerofill for silence...
-					memset(outputBuffer, 0, (size_t) silenceframes * outchannels * sizeof(float));
-					out+= (silenceframes * outchannels);
-				}
-				else {
-					// Slow-path: Usually a 1.0 fill for AM modulator mode:
-					for (i = 0; i < silenceframes * outchannels; i++) *(out++) = neutralValue;
-				}
+	if (channel < 0) {
+		for (; j < nframes; j++) for (k = 0; k < channels; k++) buf[j * channels + k] *= ramp[j];
+	}
+	else {
+		for (; j < nframes; j++) buf[j * channels + channel] *= ramp[j];
+	}
+}
 
-				// Decrement remaining real audio data count:
-				framesPerBuffer-= (unsigned long) silenceframes;
+// Compute 'count' values of automation track 'track' of device 'dev' into 'ramp', for the sample frames
+// starting at system time 'tStart', spaced 'dt' seconds apart. '*value' is the current value of the automated
+// parameter on entry, and the value at the end of the computed span on return. Breakpoints are consumed as
+// they are reached. A track without pending breakpoints simply holds the current value:
+static void PsychPAEvaluateAutomation(PsychPADevice* dev, PsychPAAutomationTrack* track, double tStart, double dt, psych_int64 count, float* ramp, float* value)
+{
+	PsychPAAutomationPoint* point;
+	double tPoint, tFrame, tSeg, frames;
+	psych_int64 j, jEnd;
+
+	j = 0;
+	while (j < count) {
+		// No more pending breakpoints? Hold current value for the rest of the span:
+		if (track->readpos == track->writepos) {
+			PsychPAFillFloats(&ramp[j], *value, count - j);
+			break;
+		}
 
-				// Advance silenceframes into the buffer:
-				committedFrames+=silenceframes;
+		point = &(track->points[track->readpos % track->size]);
 
-				// dev->startTime now exactly corresponds to onset of first non-silence sample at dev->reqStartTime.
-				// At least if everything works properly.
-				dev->startTime = dev->reqStartTime;
-				
-				// Mark us as running:
-				dev->state = 2;
-				
-				// Signal state change:
-				PsychPASignalChange(dev);				
+		// Resolve time of breakpoint into system time:
+		switch (point->unit) {
+			case 1:
+				tPoint = dev->startTime + point->when;
+			break;
+
+			case 2:
+				tPoint = dev->startTime + point->when / dev->streaminfo->sampleRate;
+			break;
+
+			default:
+				tPoint = point->when;
+		}
+
+		// Start of a new segment, e.g., first breakpoint after an idle period? Then it starts at the current frame:
+		tFrame = tStart + (double) j * dt;
+		if (track->segStart < 0) {
+			track->segStart = tFrame;
+			track->segValue = *value;
+		}
+
+		// Find first frame at or after the breakpoint, clamped to the end of the span:
+		frames = ceil((tPoint - tStart) / dt);
+		jEnd = (frames <= (double) j) ? j : ((frames >= (double) count) ? count : (psych_int64) frames);
+
+		// Compute the segment leading up to the breakpoint:
+		if (jEnd > j) {
+			tSeg = tPoint - track->segStart;
+			if ((point->shape == 2) || (tSeg <= 0)) {
+				// Step: Hold the current value until the breakpoint is reached:
+				PsychPAFillFloats(&ramp[j], *value, jEnd - j);
 			}
+			else if ((point->shape == 1) && (track->segValue * point->value > 0)) {
+				// Exponential ramp from segValue to value of breakpoint:
+				PsychPARampExponential(&ramp[j], (float) (track->segValue * pow(point->value / track->segValue, (tFrame - track->segStart) / tSeg)),
+									   (float) pow(point->value / track->segValue, dt / tSeg), jEnd - j);
+			}
+			else {
+				// Linear ramp from segValue to value of breakpoint. Also used for exponential segments
+				// which would cross or touch zero:
+				PsychPARampLinear(&ramp[j], (float) (track->segValue + (point->value - track->segValue) * (tFrame - track->segStart) / tSeg),
+								  (float) ((point->value - track->segValue) * dt / tSeg), jEnd - j);
+			}
+
+			*value = ramp[jEnd - 1];
+			j = jEnd;
 		}
-		else {
-			// Ooops! We are late! Store real estimated onset in the startTime field and
-			// then hurry up! If we are in "capture only" mode, we disregard the 'when'
-			// deadline and always start immediately.
-			dev->startTime = firstsampleonset;
 
-			// Mark us as running:
-			dev->state = 2;
-			
-			// Signal state change:
-			PsychPASignalChange(dev);			
+		// Breakpoint reached within this span? Then its value holds from now on and starts the next segment:
+		if (jEnd < count) {
+			*value = point->value;
+			track->segStart = tPoint;
+			track->segValue = point->value;
+			track->readpos++;
 		}
 	}
+}
 
-	// Master device implementation. Dispatch into all attached slave device callbacks,
-	// distribute captured data to the slaves, collect and merge or mix output data from
-	// the slaves:
-	if (isMaster) {
-		// Scratch buffers for slave callbacks already allocated?
-		if ((dev->opmode & kPortAudioCapture) && (dev->slaveInBuffer == NULL)) {
-			// Allocate input distribution buffer:
-			dev->slaveInBuffer = (float*) malloc(sizeof(float) * dev->batchsize * inchannels);
-			if (NULL == dev->slaveInBuffer) {
-				// Out of memory! Perform an emergency abort:
-				dev->reqstate = 255;
-				dev->state = 0;				
-				PsychPASignalChange(dev);
-				PsychPAUnlockDeviceMutex(dev);			
-				return(paAbort);
-			}
+// Apply all active parameter automation tracks of device 'dev' to 'nframes' sample frames of output in 'buf',
+// whose first frame is played at system time 'tStart'. Track 0 is applied to all channels and updates the
+// masterVolume, tracks 1 to outchannels of slaves are applied to the corresponding single channel and update
+// outChannelVolumes. Must be called with the device mutex held, and only for the same set of active tracks as
+// determined at the start of the playback processing in paCallback:
+static void PsychPAApplyAutomation(PsychPADevice* dev, float* buf, psych_int64 nframes, double tStart)
+{
+	float ramp[PSYCH_PA_AUTOMATION_CHUNK];
+	double dt = 1.0 / dev->streaminfo->sampleRate;
+	psych_int64 j, count;
+	float value;
+	int t;
+
+	for (t = 0; t < dev->automationTracks; t++) {
+		// Skip idle tracks:
+		if (dev->automation[t].readpos == dev->automation[t].writepos) continue;
+
+		value = (t == 0) ? dev->masterVolume : dev->outChannelVolumes[t - 1];
+
+		// Process in chunks, so we can use a ramp buffer on the stack:
+		for (j = 0; j < nframes; j += count) {
+			count = (nframes - j < PSYCH_PA_AUTOMATION_CHUNK) ? nframes - j : PSYCH_PA_AUTOMATION_CHUNK;
+			PsychPAEvaluateAutomation(dev, &(dev->automation[t]), tStart + (double) j * dt, dt, count, ramp, &value);
+			PsychPAApplyRamp(&buf[j * dev->outchannels], dev->outchannels, t - 1, ramp, count);
 		}
 
-		if ((dev->opmode & kPortAudioPlayBack) && (dev->slaveOutBuffer == NULL)) {
-			// Allocate output receive buffer and output gain receive buffer:
-			dev->slaveOutBuffer = (float*) malloc(sizeof(float) * dev->batchsize * outchannels);
-			dev->slaveGainBuffer = (float*) malloc(sizeof(float) * dev->batchsize * outchannels);
-			if ((NULL == dev->slaveOutBuffer) || (NULL == dev->slaveGainBuffer)) {
-				// Out of memory! Perform an emergency abort:
-				dev->reqstate = 255;
-				dev->state = 0;				
-				PsychPASignalChange(dev);
-				PsychPAUnlockDeviceMutex(dev);			
-				return(paAbort);
-			}
+		// Store final value of the span as new parameter setting:
+		if (t == 0) {
+			dev->masterVolume = value;
 		}
+		else {
+			dev->outChannelVolumes[t - 1] = value;
+		}
+	}
+}
 
-		// Have scratch buffers ready. Clear output intermix buffer:
-		memset(outputBuffer, 0, dev->batchsize * outchannels * sizeof(float));
-
-		// Iterate over all slave device callbacks: Or at least until all registered slaves are handled.
-		numSlavesHandled = 0;
-		for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount); i++) {
-			// Valid slave slot?
-			slaveId = dev->slaves[i];
+// Release all parameter automation tracks of device 'dev', if any:
+static void PsychPADeleteAutomation(PsychPADevice* dev)
+{
+	int t;
 
-			// We skip invalid slots and output capturer slaves:
-			if ((slaveId > -1) && !(audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) {
-				// Valid slave:
+	if (dev->automation) {
+		for (t = 0; t < dev->automationTracks; t++) free(dev->automation[t].points);
+		free(dev->automation);
+		dev->automation = NULL;
+		dev->automationTracks = 0;
+	}
 
-				// Is this device an AM modulator attached to a slave?
-				if (audiodevices[slaveId].opmode & kPortAudioIsAMModulatorForSlave) {
-					// Yes. Mark it as handled, then skip it. It will be called as part
-					// of processing of its parent slave:
-					numSlavesHandled++;
-					continue;
-				}
+	if (dev->automationMixGains) {
+		free(dev->automationMixGains);
+		dev->automationMixGains = NULL;
+	}
 
-				// This is a "real" audio slave, not a modulator or such:
-
-				// Gain modulator slave for this real slave attached, valid and active?
-				// If this is the case, we need to unconditionally execute it here, regardless
-				// of what the actual 'slaveId' device is up to. Otherwise we can run into
-				// time sync issues and ugly deadlocks in the calling code:
-				modulatorSlave = audiodevices[slaveId].modulatorSlave;
-				if ((modulatorSlave > -1) && (audiodevices[modulatorSlave].stream) &&
-					(audiodevices[modulatorSlave].opmode & kPortAudioIsAMModulatorForSlave) && (audiodevices[modulatorSlave].state > 0)) {
-					// Yes. Execute it:
-					audiodevices[modulatorSlave].slaveDirty = 0;
-
-					// Prefill buffer with neutral 1.0:
-					tmpBuffer = dev->slaveGainBuffer;
-					for (j = 0; j < dev->batchsize * audiodevices[modulatorSlave].outchannels; j++) *(tmpBuffer++) = 1.0;
-
-					// This will potentially fill the slaveGainBuffer with gain modulation values.
-					// The passed slaveInBuffer is meaningless for a modulator slave and only contains random junk...
-					paCallback( (const void*) dev->slaveInBuffer, (void*) dev->slaveGainBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[modulatorSlave]));
-				}
-				else {
-					// No. Either no modulator slave or slave not currently active. Signal this
-					// by setting modulatorSlave to a -1 value:
-					modulatorSlave = -1;
-				}
+	dev->mixGains = dev->outChannelVolumes;
+}
 
-				// Skip actual slaves processing if its state is zero == completely inactive.
-				if (audiodevices[slaveId].state > 0) {
-					// Slave is active, need to process it:
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window of the resampler:
+static double PsychPABesselI0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	int k;
 
-					// Reset dirty flag for this slave:
-					audiodevices[slaveId].slaveDirty = 0;
+	for (k = 1; k < 100; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12) break;
+	}
 
-					// Is this a playback slave?
-					if (audiodevices[slaveId].opmode & kPortAudioPlayBack) {
-						// Prefill slaves output buffer with 1.0, a neutral gain value for playback slaves
-						// without a AM modulator attached. The same prefill is needed with AM modulator,
-						// this time to make the modulator itself happy:
-						tmpBuffer = dev->slaveOutBuffer;
-						for (j = 0; j < dev->batchsize * audiodevices[slaveId].outchannels; j++) *(tmpBuffer++) = 1.0;
-
-						// Ok, the outbuffer is filled with a neutral 1.0 gain value. This will work
-						// even if no per-slave gain modulation is provided by a modulator slave.
-
-						// Is a modulator slave active and did it write any gain AM values?
-						if ((modulatorSlave > -1) && (audiodevices[modulatorSlave].slaveDirty)) {
-							// Yes. Need to distribute them to proper channels in slaveOutBuffer:
-							tmpBuffer = dev->slaveGainBuffer;
-							mixBuffer = dev->slaveOutBuffer;
-							for (j = 0; j < dev->batchsize; j++) {
-								// Iterate over all target channels in the slave device outputbuffer:
-								for (k = 0; k < audiodevices[modulatorSlave].outchannels; k++) {
-									// Modulate current sample in intermixbuffer via multiplication:
-									mixBuffer[(j * audiodevices[slaveId].outchannels) + audiodevices[modulatorSlave].outputmappings[k]] = *(tmpBuffer++) * audiodevices[modulatorSlave].outChannelVolumes[k];
-								}
-							}				
-						}
-					}	// Ok, the slaveOutBuffer for this playback slave is prefilled with valid gain modulation data to apply to the actual sound output.
+	return(sum);
+}
 
-					// Capture enabled on slave? If so, we need to distribute our captured audio data to it:
-					if (audiodevices[slaveId].opmode & kPortAudioCapture) {
-						tmpBuffer = dev->slaveInBuffer;
-						// For each sampleFrame in the input buffer:
-						for (j = 0; j < dev->batchsize; j++) {
-							// Iterate over all target channels in the slave devices inputbuffer:
-							for (k = 0; k < audiodevices[slaveId].inchannels; k++) {
-								// And fetch from corrsponding source channel of our device:
-								*(tmpBuffer++) = in[(j * inchannels) + audiodevices[slaveId].inputmappings[k]];
-							}
-						}
-					}
-					
-					// Temporary input buffer is filled for slave callback: Execute it.
-					paCallback( (const void*) dev->slaveInBuffer, (void*) dev->slaveOutBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[slaveId]));
-					
-					// Check if the paCallback actually filled anything into the dev->slaveOutBuffer:
-					if ((audiodevices[slaveId].opmode & kPortAudioPlayBack) && audiodevices[slaveId].slaveDirty) {
-						// Slave has written meaningful data to its output buffer. Merge & mix it:
-						
-						// Process from first non-silence sample slot (after silenceframes prefix) until end of buffer:
-						tmpBuffer = &(dev->slaveOutBuffer[committedFrames * audiodevices[slaveId].outchannels]);
-						mixBuffer = (float*) outputBuffer;
-						
-						// Special AM-Modulator slave?
-						if (audiodevices[slaveId].opmode & kPortAudioIsAMModulator) {
-							// Yes: This slave doesn't provide audio data for mixing, but instead
-							// a time-series of gain modulation samples for amplitude modulation.
-							// Multiply the master channels samples with the slaves "gain samples"
-							// to apply AM modulation:
-							for (j = committedFrames; j < dev->batchsize; j++) {
-								// Iterate over all target channels in the slave device outputbuffer:
-								for (k = 0; k < audiodevices[slaveId].outchannels; k++) {
-									// Modulate current sample in intermixbuffer via multiplication:
-									mixBuffer[(j * outchannels) + audiodevices[slaveId].outputmappings[k]] *= *(tmpBuffer++) * audiodevices[slaveId].outChannelVolumes[k];
-								}
-							}
-						}
-						else {
-							// Regular mix: Mix all output channels of the slave into the proper target channels
-							// of the master by simple addition. Apply per-channel volume settings of the slave
-							// during mix:
-							for (j = committedFrames; j < dev->batchsize; j++) {
-								// Iterate over all target channels in the slave device outputbuffer:
-								for (k = 0; k < audiodevices[slaveId].outchannels; k++) {
-									// Mix current sample via addition:
-									mixBuffer[(j * outchannels) + audiodevices[slaveId].outputmappings[k]] += *(tmpBuffer++) * audiodevices[slaveId].outChannelVolumes[k];
-								}
-							}
-						}
-					}
-				}
-				
-				// One more slave handled:
-				numSlavesHandled++;
-			}
-		}	// Next slave...
+// Return filter bank for resampler quality level 'quality', creating it on first use. The kernel is a Kaiser
+// windowed sinc with cutoff slightly below the Nyquist frequency of the buffer, tabulated at PSYCH_PA_RESAMPLER_PHASES
+// fractional positions between two sample frames and interpolated linearly in between. It is used for upsampling,
+// and as prototype for the stretched banks for downsampling, see PsychPAGetResamplerBankForRate(). Returns NULL if
+// out of memory:
+static PsychPAResamplerBank* PsychPAGetResamplerBank(int quality)
+{
+	PsychPAResamplerBank* bank = &resamplerBanks[quality];
+	int p, j, taps = resamplerTaps[quality];
+	double t, x, sum, beta = resamplerBeta[quality];
+	const double pi = 3.14159265358979323846, rolloff = 0.92;
+	float* row;
+
+	if (bank->coeffs) return(bank);
+
+	bank->coeffs = (float*) malloc((PSYCH_PA_RESAMPLER_PHASES + 1) * taps * sizeof(float));
+	if (NULL == bank->coeffs) return(NULL);
+	bank->taps = taps;
+	bank->offset = taps / 2 - 1;
+	bank->quality = quality;
+	bank->ratio = 1.0;
+
+	for (p = 0; p <= PSYCH_PA_RESAMPLER_PHASES; p++) {
+		row = &(bank->coeffs[p * taps]);
+		sum = 0.0;
+		for (j = 0; j < taps; j++) {
+			// Offset of tap j to the interpolated position at fraction p / PSYCH_PA_RESAMPLER_PHASES behind the center frame:
+			t = (double) (j - taps / 2 + 1) - (double) p / (double) PSYCH_PA_RESAMPLER_PHASES;
+			x = 2.0 * t / (double) taps;
+			row[j] = (float) (((t == 0.0) ? rolloff : sin(pi * rolloff * t) / (pi * t)) *
+							  ((fabs(x) < 1.0) ? PsychPABesselI0(beta * sqrt(1.0 - x * x)) / PsychPABesselI0(beta) : 0.0));
+			sum += row[j];
+		}
 
-		// Done merging sound data from slaves. Mastercode can now process special output capture slaves
-		// and other special post-mix slaves:
-		for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount); i++) {
-			// Valid slave slot?
-			slaveId = dev->slaves[i];
-			
-			// We skip invalid slots and anything except output capturer slaves:
-			if ((slaveId > -1) && (audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) {
-				// Valid slave: Skip its processing if its state is zero == completely inactive.
-				if (audiodevices[slaveId].state > 0) {
-					// Reset dirty flag for this slave: Not strictly needed for output capture slaves...
-					audiodevices[slaveId].slaveDirty = 0;
-					
-					// Output capture enabled on slave? If so, we need to distribute our output audio data to it:
-					if ((audiodevices[slaveId].opmode & kPortAudioCapture) && (audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) {
-						// Our target buffer is the slaveOutBuffer here, because it is guaranteed to exist and
-						// have sufficient capacity:
-						tmpBuffer = dev->slaveOutBuffer;
-						
-						// Our input is the mixBuffer from previous mixes:
-						mixBuffer = (float*) outputBuffer;
-						
-						// For each sampleFrame in the mixBuffer:
-						for (j = 0; j < dev->batchsize; j++) {
-							// Iterate over all target channels in the slave devices inputbuffer:
-							for (k = 0; k < audiodevices[slaveId].inchannels; k++) {
-								// And fetch from corrsponding mixBuffer channel of our device, applying the same
-								// masterVolume setting that the master output device will apply later:
-								*(tmpBuffer++) = masterVolume * mixBuffer[(j * outchannels) + audiodevices[slaveId].inputmappings[k]];
-							}
-						}
-					}
-					
-					// Temporary input buffer is filled for slave callback: dev->slaveOutBuffer acts as the input
-					// buffer for the callback, as it contains the properly formatted data from our mixBuffer. It
-					// also acts as output buffer from the slave, so that slaves with playback enabled are happy.
-					// However, this is a pure dummy-sink, the data written by the slave isn't used for anything,
-					// but simply discarded, as output capture slaves have no meaningful sink for their output.
-					paCallback( (const void*) dev->slaveOutBuffer, (void*) dev->slaveOutBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[slaveId]));
-				}
-				
-				// One more slave handled:
-				numSlavesHandled++;
-			}
-		}	// Next outputcapture-slave...
-		// Done processing slaves. Mastercode can now continue just as slave or regular device code would do.
+		// Normalize each phase to unity gain at DC:
+		for (j = 0; j < taps; j++) row[j] = (float) (row[j] / sum);
 	}
 
-	// This code only executes on non-masters in live monitoring mode - a mode where all
-	// sound data is fed back immediately with shortest possible latency
-	// from input to output, without any involvement of Matlab/Octave code:
-	if (!isMaster && (dev->opmode & kPortAudioMonitoring)) {
-		// Copy input buffer to output buffer:
-		memcpy(out, &(in[committedFrames * inchannels]), framesPerBuffer * outchannels * sizeof(float));
+	return(bank);
+}
 
-		// Store updated positions in device structure:
-		dev->playposition = playposition + (framesPerBuffer * outchannels);
-		dev->recposition = dev->playposition;
+// Evaluate the tabulated kernel of unstretched 'bank' at offset 't' in sample frames from its center:
+static float PsychPAResamplerKernel(const PsychPAResamplerBank* bank, double t)
+{
+	double ft = floor(t), pf;
+	int p, j = (int) ft + bank->taps / 2;
+	const float* row;
 
-		// Compute output time of last fed back sample from this iteration:
-		committedFrames += framesPerBuffer;
-		dev->currentTime = firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate);
+	if ((j < 0) || (j >= bank->taps)) return(0.0f);
 
-		// Mark our output buffer as dirty:
-		dev->slaveDirty = 1;
+	pf = (ft + 1.0 - t) * PSYCH_PA_RESAMPLER_PHASES;
+	p = (int) pf;
+	row = &(bank->coeffs[p * bank->taps + j]);
+	if (p >= PSYCH_PA_RESAMPLER_PHASES) return(row[0]);
 
-		// Return from callback:
-		PsychPAUnlockDeviceMutex(dev);
-		return(paContinue);
+	return(row[0] + (float) (pf - p) * (row[bank->taps] - row[0]));
+}
+
+// Return the resampler filter bank of device 'dev' for playback of buffers with sample rate 'rate', or NULL if the
+// buffers need no conversion, or if out of memory. For upsampling, this is the filter bank of the devices quality
+// level. For downsampling, the kernel must be stretched by the ratio of buffer to device sample rate, to cut off
+// below the Nyquist frequency of the device. Stretched banks get tabulated here on first use for each quality level
+// and ratio, and are kept until shutdown, so paCallback only interpolates between two tabulated phases, as for
+// upsampling. Must not be called from paCallback:
+static PsychPAResamplerBank* PsychPAGetResamplerBankForRate(PsychPADevice* dev, double rate)
+{
+	PsychPAResamplerBank* base = dev->resampler;
+	PsychPAResamplerBank* bank;
+	double step, frac, sum;
+	int i, p, j, taps;
+	float* row;
+
+	if ((NULL == base) || (rate <= 0) || (rate == (double) dev->streaminfo->sampleRate)) return(NULL);
+
+	step = rate / (double) dev->streaminfo->sampleRate;
+	if (step <= 1.0) return(base);
+	if (step > PSYCH_PA_RESAMPLER_MAXRATIO) step = PSYCH_PA_RESAMPLER_MAXRATIO;
+
+	// Already tabulated?
+	for (i = 0; (i < PSYCH_PA_RESAMPLER_MAXSTRETCHED) && stretchedResamplerBanks[i].coeffs; i++) {
+		if ((stretchedResamplerBanks[i].quality == base->quality) && (stretchedResamplerBanks[i].ratio == step)) return(&stretchedResamplerBanks[i]);
 	}
-	
-	// This code retrieves and stores captured sound data on non-master devices, if any:
-	if (!isMaster && (dev->opmode & kPortAudioCapture)) {
-		// Check if required input buffer is there.
-		if (dev->inputbuffer == NULL) {
-			// Ouch! Perform emergency shutdown:
-			dev->reqstate = 255;
-			dev->state = 0;
 
-			PsychPASignalChange(dev);
-			PsychPAUnlockDeviceMutex(dev);			
+	if (i >= PSYCH_PA_RESAMPLER_MAXSTRETCHED) {
+		if (verbosity > 1) printf("PsychPortAudio-WARNING: Too many different sample rates for downsampling. Sound with %f Hz will play without conversion.\n", rate);
+		return(NULL);
+	}
 
-			return(paAbort);
-		}
-		
-		// This is the simple case (compared to playback processing).
-		// Just copy all available data to our internal buffer:
-		for (i=0; (i < dev->batchsize * inchannels); i++) {
-			dev->inputbuffer[recposition % insbsize] = (float) *in++;
-			recposition++;
+	// The stretched kernel spans 'step' times as many sample frames of the buffer:
+	bank = &stretchedResamplerBanks[i];
+	bank->offset = (int) ceil(step * base->taps / 2);
+	taps = (2 * bank->offset + 2 + 3) & ~3;
+	bank->coeffs = (float*) malloc((PSYCH_PA_RESAMPLER_PHASES + 1) * taps * sizeof(float));
+	if (NULL == bank->coeffs) {
+		if (verbosity > 1) printf("PsychPortAudio-WARNING: Out of memory for resampler filters. Sound with %f Hz will play without conversion.\n", rate);
+		return(NULL);
+	}
+
+	bank->taps = taps;
+	bank->quality = base->quality;
+	bank->ratio = step;
+
+	for (p = 0; p <= PSYCH_PA_RESAMPLER_PHASES; p++) {
+		row = &(bank->coeffs[p * taps]);
+		frac = (double) p / (double) PSYCH_PA_RESAMPLER_PHASES;
+		sum = 0.0;
+		for (j = 0; j < taps; j++) {
+			row[j] = PsychPAResamplerKernel(base, ((double) (j - bank->offset) - frac) / step);
+			sum += row[j];
 		}
-		
-		// Store updated recording position in device structure:
-		dev->recposition = recposition;
+
+		// Normalize each phase to unity gain at DC:
+		if (sum != 0.0) for (j = 0; j < taps; j++) row[j] = (float) (row[j] / sum);
 	}
-	
-	// This code emits actual sound data to the engine:
-	if (dev->opmode & kPortAudioPlayBack) {
-		// Set stopEngine request to false, ie. continue...
-		stopEngine = FALSE;
-		parc = 0;
-		
-		// Mark our output buffer as dirty:
-		dev->slaveDirty = 1;
-		
-		// Last chance to honor a potential playback abort request. Check once more...
-		reqstate = dev->reqstate;
 
-		// Compute time delta between requested sound stop time (sound offset time) and
-		// time of next sample in to-be-filled buffer, taking potential committedFrames for
-		// zero padding at head of buffer into account:
-		offsetDelta = dev->reqStopTime - (firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate));
+	return(bank);
+}
 
-		// Clamp to at most 10 seconds ahead, because that is more than enough even
-		// for the largest conceivable hostbuffersizes, and it prevents numeric overflow
-		// in the math below when converting to psych_int64 ints:
-		offsetDelta = (offsetDelta > 10.0) ? 10.0 : offsetDelta;
+// Interpolate the filter weights 'w' for fractional position 'frac' between two sample frames from 'bank':
+static void PsychPAResamplerWeights(float* w, const PsychPAResamplerBank* bank, double frac)
+{
+	double pf = frac * PSYCH_PA_RESAMPLER_PHASES;
+	int j = 0, taps = bank->taps, p = (int) pf;
+	float a = (float) (pf - p);
+	const float* r0 = &(bank->coeffs[p * taps]);
+	const float* r1 = (p < PSYCH_PA_RESAMPLER_PHASES) ? r0 + taps : r0;
 
-		// Convert remaining time until requested stop time into sample frames until stop:
-		offsetDelta = offsetDelta * (double)(dev->streaminfo->sampleRate);
+	#if PSYCH_PA_USE_SSE2
+	__m128 va = _mm_set1_ps(a);
+	__m128 v0;
 
-		// Convert into samples: max_i is the maximum allowable value for 'i'
-		// in order to satisfy the dev->reqStopTime:
-		max_i  = (psych_int64) (offsetDelta * (double) outchannels);
-		max_i -= max_i % outchannels;
-		
-		// Count of outputted frames in this part of the code:
-		i=0;
+	for (; j + 4 <= taps; j += 4) {
+		v0 = _mm_loadu_ps(&r0[j]);
+		_mm_storeu_ps(&w[j], _mm_add_ps(v0, _mm_mul_ps(va, _mm_sub_ps(_mm_loadu_ps(&r1[j]), v0))));
+	}
+	#endif
 
-		// Stoptime already reached or abort request from master thread received? If so, stop the engine:
-		if (reqstate == 0 || reqstate == 3 || (offsetDelta <= 0) ) stopEngine = TRUE;
+	for (; j < taps; j++) w[j] = r0[j] + a * (r1[j] - r0[j]);
+}
 
-		// Repeat until stopEngine condition, or this callbacks host output buffer is full,
-		// or max_i timeout reached for end of processing, or no more valid slots available
-		// in current schedule. Assign all relevant parameters from schedule:
-		while (!stopEngine && (i < framesPerBuffer * outchannels) && (i < max_i) &&
-			   ((parc = PsychPAProcessSchedule(dev, &playposition, &playoutbuffer, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) == 0)) {
-			// Process this slot:
+// Compute the per-channel sums 'acc' of 'count' sample frames of 'channels' channel audio in 'win', weighted with 'w':
+static void PsychPAResamplerDot(float* acc, const float* win, const float* w, int count, psych_int64 channels)
+{
+	int j = 0;
+	psych_int64 c;
 
-			if (!isMaster && !isSlave) {
-				// Non-master, non-slave device: This is a regular sound device.
-				// Copy requested number of samples for each channel into the output buffer: Take the case of
-				// "loop forever" and "loop repeatCount" times into account, as well as stop times:
-				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
-					*(out++) = playoutbuffer[outsboffset + ( playposition % outsbsize )] * masterVolume;
-					playposition++;
-				}
-			}
-			else if (!isMaster) {
-				// Non-master device: This is a slave.
-				// Copy requested number of samples for each channel into the output buffer: Take the case of
-				// "loop forever" and "loop repeatCount" times into account, as well as stop times:
-				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
-					// We multiply in order to apply possible per-channel, per-sample gain values as
-					// defined by the master - i.e., by an AM modulator that is attached to us:
-					*(out++) *= playoutbuffer[outsboffset + ( playposition % outsbsize )] * masterVolume;
-					playposition++;
+	#if PSYCH_PA_USE_SSE2
+	__m128 s, v;
+	float sums[4];
+	#endif
+
+	for (c = 0; c < channels; c++) acc[c] = 0.0f;
+
+	#if PSYCH_PA_USE_SSE2
+	if (channels == 1) {
+		s = _mm_setzero_ps();
+		for (; j + 4 <= count; j += 4) s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(&win[j]), _mm_loadu_ps(&w[j])));
+		_mm_storeu_ps(sums, s);
+		acc[0] = sums[0] + sums[1] + sums[2] + sums[3];
+	}
+	else if (channels == 2) {
+		s = _mm_setzero_ps();
+		for (; j + 4 <= count; j += 4) {
+			v = _mm_loadu_ps(&w[j]);
+			s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(&win[2 * j]), _mm_unpacklo_ps(v, v)));
+			s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(&win[2 * j + 4]), _mm_unpackhi_ps(v, v)));
+		}
+		_mm_storeu_ps(sums, s);
+		acc[0] = sums[0] + sums[2];
+		acc[1] = sums[1] + sums[3];
+	}
+	#endif
+
+	for (; j < count; j++) {
+		for (c = 0; c < channels; c++) acc[c] += w[j] * win[j * channels + c];
+	}
+}
+
+// Resample the playback loop of the current slot of device 'dev' from the sample rate of its buffer to the sample
+// rate of the device with filter bank dev->playoutResampler, writing - or on slaves multiplying - at most 'maxsamples'
+// samples into 'out', scaled by 'gain'. '*playposition' is the position in samples in the buffer, dev->resamplePhase
+// the fractional position between the current and next sample frame. Both are advanced. Returns the number of samples output:
+static psych_int64 PsychPAResampleSlot(PsychPADevice* dev, float* out, psych_int64 maxsamples, psych_bool isSlave, float gain,
+									   const float* playoutbuffer, psych_int64 outsbsize, psych_int64 outsboffset,
+									   double repeatCount, psych_int64 playpositionlimit, psych_int64* playposition)
+{
+	PsychPAResamplerBank* bank = dev->playoutResampler;
+	psych_int64 channels = dev->outchannels;
+	psych_int64 loopFrames = outsbsize / channels;
+	psych_int64 n, k, c, first, frame, adv;
+	double step = dev->playoutSampleRate / (double) dev->streaminfo->sampleRate;
+	double frac = dev->resamplePhase;
+	int j, count;
+	float* win = dev->resampleScratch;
+	float* w = win + (dev->resampler->taps * PSYCH_PA_RESAMPLER_MAXRATIO + 4) * channels;
+	float* acc = w + dev->resampler->taps * PSYCH_PA_RESAMPLER_MAXRATIO + 4;
+	const float* src;
+	float v;
+
+	if (step > PSYCH_PA_RESAMPLER_MAXRATIO) step = PSYCH_PA_RESAMPLER_MAXRATIO;
+
+	for (n = 0; (n + channels <= maxsamples) && ((repeatCount == -1) || (*playposition < playpositionlimit)); n += channels) {
+		frame = *playposition / channels;
+
+		// Interpolate the filter weights at the fractional position from the filter bank, which is
+		// already stretched for downsampling, see PsychPAGetResamplerBankForRate():
+		count = bank->taps;
+		first = frame - bank->offset;
+		PsychPAResamplerWeights(w, bank, frac);
+
+		// Use the sample frames of the filter window directly from the buffer if they are all inside the
+		// playback loop and valid. Otherwise gather them, wrapping around at loop boundaries, with silence
+		// before the start and after the end of playback of this slot:
+		if ((first >= 0) && ((first % loopFrames) + count <= loopFrames) && ((repeatCount == -1) || ((first + count) * channels <= playpositionlimit))) {
+			src = &playoutbuffer[outsboffset + (first % loopFrames) * channels];
+		}
+		else {
+			for (j = 0; j < count; j++) {
+				k = first + j;
+				for (c = 0; c < channels; c++) {
+					win[j * channels + c] = ((k >= 0) && ((repeatCount == -1) || (k * channels < playpositionlimit))) ? playoutbuffer[outsboffset + (k % loopFrames) * channels + c] : 0.0f;
 				}
 			}
-			else {
-				// Master device: We don't output our own audio data. Just apply the masterVolume
-				// gain setting common to all output channels of the device:
-				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
-					*(out++) *= masterVolume;
-					playposition++;
-				}		
-			}
+			src = win;
+		}
 
-			// Store updated playposition in device structure:
-			dev->playposition = playposition;
+		PsychPAResamplerDot(acc, src, w, count, channels);
 
-			// Abort condition?
-			if ((i >= max_i) || ((parc = PsychPAProcessSchedule(dev, &playposition, &playoutbuffer, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) > 0)) stopEngine = TRUE;
+		for (c = 0; c < channels; c++) {
+			// Clamp overshoot of the filter to the valid range of samples:
+			v = (acc[c] > PA_ANTICLAMPGAIN) ? PA_ANTICLAMPGAIN : ((acc[c] < -PA_ANTICLAMPGAIN) ? -PA_ANTICLAMPGAIN : acc[c]);
+
+			// On slaves we multiply in order to apply possible gain values from an attached AM modulator:
+			if (isSlave) out[n + c] *= v * gain;
+			else out[n + c] = v * gain;
 		}
 
-		// Store updated playposition in device structure:
-		dev->playposition = playposition;
+		// Advance by one sample period of the device:
+		frac += step;
+		adv = (psych_int64) frac;
+		frac -= (double) adv;
+		*playposition += adv * channels;
+	}
 
-		// Update total count of emitted valid non-silence sample frames:
-		committedFrames += i / outchannels;
+	dev->resamplePhase = frac;
 
-		// Compute output time of last outputted sample from this iteration:
-		dev->currentTime = firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate);
+	return(n);
+}
 
-		// Update total count of emitted samples since start of playback:
-		dev->totalplaycount+= committedFrames * outchannels;
-		
-		// Another end-of-playback check:
-		if (parc > 0) {
-			stopEngine = TRUE;
-		}
-		
-		// End of playback reached due to maximum number of possible output samples reached or abortcondition satisfied?
-		if ((i < framesPerBuffer * outchannels) || stopEngine) {
-			// Premature stop of buffer filling because abortcondition satisfied: Need to go idle or stop the whole engine:
+// Return the sample rate in Hz to use for conversion of times into sample frames of the standard playback
+// buffer of device 'dev' if 'buffer' is NULL, or of dynamic audio buffer 'buffer' otherwise:
+static double PsychPABufferSampleRate(PsychPADevice* dev, PsychPABuffer* buffer)
+{
+	double rate = (buffer) ? buffer->sampleRate : dev->outputbufferSampleRate;
+
+	return((dev->resampler && (rate > 0)) ? rate : (double) dev->streaminfo->sampleRate);
+}
+
+// Called exclusively from paCallback, with device-mutex held.
+// Check if a schedule is defined. If not, return repetition, playloop and bufferparameters
+// from the device struct, ie., old behaviour. If yes, check if an update of the schedule is
+// needed (ie., progressing to the next slot) and do so if needed. Return parameters from
+// current slot, or an abort signal if end of schedule reached.
+//
+// Return codes:
+// 0 = Valid buffer and playback parameters assigned. Proceed with audio playback as scheduled.
+// 1 = Regular end of playback or schedule reached. Finish playback.
+// 2 = Error abort, something is totally frelled.
+// 4 = Abort bufferfill operation for this host audio buffer via zerofill, but don't switch to idle mode / don't stop engine.
+//     Instead switch back to hot-standby so playback can be picked up again at a later point in time.
+//	   This is used to reschedule start of playback for a following slot at a later time.
+int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float** ret_playoutbuffer, psych_int64* ret_outsbsize, psych_int64* ret_outsboffset, double* ret_repeatCount, psych_int64* ret_playpositionlimit)
+{
+	psych_int64   loopStartFrame, loopEndFrame;
+	psych_int64  outsbsize, outsboffset;
+	psych_int64  outchannels = dev->outchannels;
+	unsigned int  slotid, cmd;
+	double		  repeatCount;
+	double		  reqTime;
+	psych_int64  playpositionlimit;
+	
+	// NULL-Schedule?
+	if (dev->schedule == NULL) {
+		// Yes: Assign settings from dev-struct:
+		*ret_playoutbuffer = dev->outputbuffer;
+		outsbsize = dev->outputbuffersize / sizeof(float);
+		dev->playoutSampleRate = dev->outputbufferSampleRate;
+		dev->playoutResampler = dev->outputbufferResampler;
+
+		// Fetch boundaries of playback loop:
+		loopStartFrame = dev->loopStartFrame;
+		loopEndFrame = dev->loopEndFrame;
+		repeatCount = dev->repeatCount;
+
+		// Revalidate boundaries of playback loop:
+		if (loopStartFrame * outchannels >= outsbsize) loopStartFrame = (outsbsize / outchannels) - 1;
+		if (loopStartFrame < 0) loopStartFrame = 0;
+		if (loopEndFrame * outchannels >= outsbsize) loopEndFrame = (outsbsize / outchannels) - 1;
+		if (loopEndFrame < 0) loopEndFrame = 0;
+		if (loopEndFrame < loopStartFrame) loopEndFrame = loopStartFrame;
+		
+		// Remap defined playback loop to "corrected" outsbsize and offset for later copy-op:
+		outsbsize   = (loopEndFrame - loopStartFrame + 1) * outchannels;
+		outsboffset = loopStartFrame * outchannels;
+		
+		// Compute playpositionlimit, the upper limit of played out samples from loop duration and repeatCount...
+		playpositionlimit = ((psych_int64) (repeatCount * outsbsize));
+		// ...and make sure it ends on integral sample frame boundaries:
+		playpositionlimit -= playpositionlimit % outchannels;
+
+		// Check if loop and repetition constraints are still valid:
+		if ( !((repeatCount == -1) || (*playposition < playpositionlimit)) || (NULL == *ret_playoutbuffer)) {
+			// No. Signal regular end of playback:
+			return(1);
+		}
+	}
+	else {
+		// No: Real schedule:
+		
+		do {
+			// Find current slot (with wraparound):
+			slotid = dev->schedule_pos % dev->schedule_size;
 			
-			// We need to zero-fill the remainder of the buffer and tell the engine
-			// to finish playback:
-			while(i < framesPerBuffer * outchannels) {
-				*out++ = neutralValue;
-				i++;
+			// Current slot valid and pending?
+			if ((dev->schedule[slotid].mode & 2) == 0) {
+				// No: End of schedule reached - Signal regular abort request and that's it:
+				return(1);
 			}
 			
-			// Signal that engine is stopped/will stop very soonish:
-			// Unless parc == 4 request a rescheduled restart, ie., switching to hot-standby
-			// instead of idle:
-			dev->state = (parc == 4) ? 1 : 0;
-			dev->reqstate = 255;
+			// Current slot is valid: Assign it:
+			cmd = dev->schedule[slotid].command;
+			if (cmd > 0) {
+				// Special command buffer: Doesn't contain sound, but some special
+				// control commands. Process it, then advance to next slot...
+				
+				// This makes sure we repeat the loop, advancing to the next slot:
+				*ret_playoutbuffer = NULL;
+				outsbsize = 0;
+				outsboffset = 0;
+				playpositionlimit = 0;
+				repeatCount = 0;
 
-			// Set estimated stop time to last committed sample time:
-			if ((dev->estStopTime == 0) && (dev->state == 0)) dev->estStopTime = dev->currentTime;
-			
-			// Signal state change:
-			PsychPASignalChange(dev);
+				// Compute absolute deadline from given tWhen timespec and type of timespec:
+				if (cmd & 4)  reqTime = dev->schedule[slotid].tWhen;						// Absolute system time specified.
+                // Relative to last requested start time. We use last true start time as fallback if the requested start time is undefined:
+				if (cmd & 8)  reqTime = ((dev->reqStartTime > 0.0) ? dev->reqStartTime : dev->startTime) + dev->schedule[slotid].tWhen;
+				if (cmd & 16) reqTime = dev->startTime + dev->schedule[slotid].tWhen;		// Relative to last true start time.
+				// TODO: The following two "end time" related ones are pretty broken - Can't
+				// work the way i want it to work, as relevant information is not available at
+				// the time we'd need it, ie., at this point in execution flow...
+				// Need to think about this, or scrap the idea of end-time related timeoffsets...
+				if (cmd & 32) reqTime = dev->reqStopTime + dev->schedule[slotid].tWhen;		// Relative to last requested end time.
+				if (cmd & 64) reqTime = dev->estStopTime + dev->schedule[slotid].tWhen;		// Relative to last true end time.
+				
+				// Pause-playback-and-restart command?
+				if (cmd & 1) {
+					// Yes. We should abort playback at this point, ie. fill the remainder
+					// of the audiobuffer with silence. Then we shall switch back to hot-standby
+					// and reschedule ourselves for restart of playback at a given target reqTime:
+					dev->reqStartTime = reqTime;
 
-			// Safe to unlock, as dev->runMode never changes below us:
-			PsychPAUnlockDeviceMutex(dev);
+					// Manually invalidate this slot and advance schedule to next one:
+					*playposition = 0;
+					dev->resamplePhase = 0;
+					// Only disable if the flag 4 aka "don't auto-disable" isn't set:
+					if (!(dev->schedule[slotid].mode & 4)) PsychPAConsumeScheduleSlot(dev, &(dev->schedule[slotid]));
+					dev->schedule_pos++;
 
-			if ((dev->runMode == 0) && (dev->state == 0)) {
-				// Either paComplete gracefully, playing out pending buffers, or
-				// request a hard paAbort if abortion is requested:
-				return((reqstate == 3) ? paAbort : paComplete);
+					// Return with special code 4 to reschedule:
+					return(4);
+				}
+
+				// Reschedule end-of-playback command?
+				if (cmd & 2) {
+					// Yes. We should end playback at given target reqTime, then go idle:
+					dev->reqStopTime = reqTime;
+
+					// Nothing further to do here. Will auto-advance to next schedule slot after
+					// this one, possibly outputting further sound...
+				}
+				
+				// End of command buffer processing.
 			}
 			else {
-				// Runmode 1 or greater: Have set our state to "idle" already. Just
-				// continue:
-				return(paContinue);
+				// Regular audio buffer: Buffer, playback loop and limits were precompiled by
+				// PsychPACompileScheduleSlot(), so a slot transition is cheap and lock-free:
+				*ret_playoutbuffer = dev->schedule[slotid].playoutbuffer;
+				outsbsize = dev->schedule[slotid].outsbsize;
+				outsboffset = dev->schedule[slotid].outsboffset;
+				playpositionlimit = dev->schedule[slotid].playpositionlimit;
+				repeatCount = dev->schedule[slotid].repetitions;
+				dev->playoutSampleRate = dev->schedule[slotid].sampleRate;
+				dev->playoutResampler = dev->schedule[slotid].resampler;
 			}
-		}
+			
+			// Check if loop and repetition constraints as well as actual audio buffer for this slot are still valid:
+			if ( !((repeatCount == -1) || (*playposition < playpositionlimit)) || (NULL == *ret_playoutbuffer) ) {
+				// Constraints violated. This slot is used up: Reset playposition and advance to next slot:
+				*playposition = 0;
+				dev->resamplePhase = 0;
+				// Only disable if the flag 4 aka "don't auto-disable" isn't set:
+				if (!(dev->schedule[slotid].mode & 4)) PsychPAConsumeScheduleSlot(dev, &(dev->schedule[slotid]));
+				dev->schedule_pos++;
+			}
+			else {
+				// Constraints ok, break out of do-while slot advance loop:
+				break;
+			}
+		} while(TRUE);
 	}
-		
-	// Tell engine to continue stream processing, i.e., call us again...
-	PsychPAUnlockDeviceMutex(dev);
-    return(paContinue);
-}
-
-void PsychPACloseStream(int id)
-{
-	int pamaster, i;
-	PaStream* stream = audiodevices[id].stream;
 	
-	// Valid and active device?
-	if (stream) {
-		// Need different destruction procedures for normals vs. masters vs. slaves:
-		if (audiodevices[id].opmode & kPortAudioIsSlave) {
-			// Virtual slave device.
-			pamaster = audiodevices[id].pamaster;
-			
-			// First we need to get the lock of the masterdevice to prevent it
-			// from operating on its list of slaves or from calling the to-be-deleted
-			// slave:
-			PsychPALockDeviceMutex(&(audiodevices[pamaster]));
-			
-			// At this point we have the mutex and neither the master nor our slave are operating.
-			// We also know that nobody is waiting on any finalization or state-change signals from
-			// the slave device, because the only thread that could wait on such events is the
-			// main interpreter-thread on which we are executing at this moment -- obviously we're
-			// not blocked. The slave is not really operating on hardware that needs to be shut down
-			// and the slave is not operating on its own thread, so no thread cleanup to do either.
-			//
-			// Simply put, we can simply detach ourselves from the master, then skip destruction steps
-			// for real audio devices and continue with release operations for our data structures,
-			// buffers and sync primitives.
-			
-			// Find our slot in the master:
-			for (i=0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (audiodevices[pamaster].slaves[i] != id); i++);
+	*ret_outsbsize = outsbsize;
+	*ret_outsboffset = outsboffset;
+	*ret_repeatCount = repeatCount;
+	*ret_playpositionlimit = playpositionlimit;
 
-			// Detach us from master queue:
-			audiodevices[pamaster].slaves[i] = -1;
-			audiodevices[pamaster].slaveCount--;
+	// Safety check: If playoutbuffer is NULL at this point, then somethings screwed
+	// and we request abort of playback:
+	if (NULL == *ret_playoutbuffer) return(2);
 
-			// Detach master from us:
-			audiodevices[id].pamaster = -1;
+	// Return 0 exit to signal a valid update:
+	return(0);
+}
 
-			// If we're an AM modulator for another slave, we need to detach
-			// from that slave:
-			if (audiodevices[id].opmode & kPortAudioIsAMModulatorForSlave) {
-				for (i = 0; i < MAX_PSYCH_AUDIO_DEVS; i++) if (audiodevices[i].modulatorSlave == id) { audiodevices[i].modulatorSlave = -1; }
+static int paCallback( const void *inputBuffer, void *outputBuffer,
+                             unsigned long framesPerBuffer,
+                             const PaStreamCallbackTimeInfo* timeInfo,
+                             PaStreamCallbackFlags statusFlags,
+                             void *userData );
+
+// Render one slave device 'slaveId' of master device 'dev' by executing its paCallback, and
+// the paCallback of its AM modulator slave, if any. 'in' is the input buffer of the master.
+// 'slaveInBuffer', 'slaveOutBuffer' and 'slaveGainBuffer' are scratch buffers to distribute
+// captured data to the slave, and to receive the slaves output and gain modulation data.
+// Called with the masters mutex held, either from the masters paCallback, or from one of
+// the masters slave worker threads during parallel rendering of slaves:
+static void PsychPARenderSlave(PsychPADevice* dev, int slaveId, const float* in, float* slaveInBuffer, float* slaveOutBuffer, float* slaveGainBuffer,
+							   const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags)
+{
+	psych_int64 j, k;
+	float *tmpBuffer;
+	int modulatorSlave;
+
+	// Gain modulator slave for this real slave attached, valid and active?
+	// If this is the case, we need to unconditionally execute it here, regardless
+	// of what the actual 'slaveId' device is up to. Otherwise we can run into
+	// time sync issues and ugly deadlocks in the calling code:
+	modulatorSlave = audiodevices[slaveId].modulatorSlave;
+	if ((modulatorSlave > -1) && (audiodevices[modulatorSlave].stream) &&
+		(audiodevices[modulatorSlave].opmode & kPortAudioIsAMModulatorForSlave) && (audiodevices[modulatorSlave].state > 0)) {
+		// Yes. Execute it:
+		audiodevices[modulatorSlave].slaveDirty = 0;
+		PsychPAAtomicIncrement(&(dev->slavesProcessed));
+
+		// Prefill buffer with neutral 1.0:
+		PsychPAFillFloats(slaveGainBuffer, 1.0, dev->batchsize * audiodevices[modulatorSlave].outchannels);
+
+		// This will potentially fill the slaveGainBuffer with gain modulation values.
+		// The passed slaveInBuffer is meaningless for a modulator slave and only contains random junk...
+		paCallback( (const void*) slaveInBuffer, (void*) slaveGainBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[modulatorSlave]));
+	}
+	else {
+		// No. Either no modulator slave or slave not currently active. Signal this
+		// by setting modulatorSlave to a -1 value:
+		modulatorSlave = -1;
+	}
+
+	// Skip actual slaves processing if its state is zero == completely inactive.
+	if (audiodevices[slaveId].state > 0) {
+		// Slave is active, need to process it:
+		PsychPAAtomicIncrement(&(dev->slavesProcessed));
+
+		// Reset dirty flag for this slave:
+		audiodevices[slaveId].slaveDirty = 0;
+
+		// Is this a playback slave?
+		if (audiodevices[slaveId].opmode & kPortAudioPlayBack) {
+			// Prefill slaves output buffer with 1.0, a neutral gain value for playback slaves
+			// without a AM modulator attached. The same prefill is needed with AM modulator,
+			// this time to make the modulator itself happy:
+			PsychPAFillFloats(slaveOutBuffer, 1.0, dev->batchsize * audiodevices[slaveId].outchannels);
+
+			// Ok, the outbuffer is filled with a neutral 1.0 gain value. This will work
+			// even if no per-slave gain modulation is provided by a modulator slave.
+
+			// Is a modulator slave active and did it write any gain AM values?
+			if ((modulatorSlave > -1) && (audiodevices[modulatorSlave].slaveDirty)) {
+				// Yes. Need to distribute them to proper channels in slaveOutBuffer:
+				PsychPAMixSlaveChannels(slaveOutBuffer, audiodevices[slaveId].outchannels, slaveGainBuffer, audiodevices[modulatorSlave].outchannels,
+										audiodevices[modulatorSlave].outputmappings, audiodevices[modulatorSlave].mixGains, dev->batchsize, kPsychPAMixAssign);
 			}
+		}	// Ok, the slaveOutBuffer for this playback slave is prefilled with valid gain modulation data to apply to the actual sound output.
+
+		// Capture enabled on slave? If so, we need to distribute our captured audio data to it:
+		if (audiodevices[slaveId].opmode & kPortAudioCapture) {
+			tmpBuffer = slaveInBuffer;
+			// For each sampleFrame in the input buffer:
+			for (j = 0; j < dev->batchsize; j++) {
+				// Iterate over all target channels in the slave devices inputbuffer:
+				for (k = 0; k < audiodevices[slaveId].inchannels; k++) {
+					// And fetch from corrsponding source channel of our device:
+					*(tmpBuffer++) = in[(j * dev->inchannels) + audiodevices[slaveId].inputmappings[k]];
+				}
+			}
+		}
 
-			// Detached :-) -- Master can continue with whatever...
-			PsychPAUnlockDeviceMutex(&audiodevices[pamaster]);
-			
-			// Continue with data structure destruction etc.
+		// Temporary input buffer is filled for slave callback: Execute it.
+		paCallback( (const void*) slaveInBuffer, (void*) slaveOutBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[slaveId]));
+	}
+	else {
+		// Inactive slave hasn't written anything:
+		audiodevices[slaveId].slaveDirty = 0;
+	}
+}
+
+// Merge & mix output of slave 'slaveId', as rendered into 'slaveOutBuffer' by PsychPARenderSlave(), into
+// the output buffer 'mixBuffer' of master 'dev', starting at sample frame 'committedFrames':
+static void PsychPAMixSlaveOutput(PsychPADevice* dev, int slaveId, float* mixBuffer, const float* slaveOutBuffer, psych_int64 committedFrames)
+{
+	// Check if the slaves paCallback actually filled anything into the slaveOutBuffer:
+	if ((audiodevices[slaveId].opmode & kPortAudioPlayBack) && audiodevices[slaveId].slaveDirty) {
+		// Slave has written meaningful data to its output buffer. Merge & mix it:
+
+		// Process from first non-silence sample slot (after silenceframes prefix) until end of buffer:
+		slaveOutBuffer = &(slaveOutBuffer[committedFrames * audiodevices[slaveId].outchannels]);
+		mixBuffer = &(mixBuffer[committedFrames * dev->outchannels]);
+
+		// Special AM-Modulator slave?
+		if (audiodevices[slaveId].opmode & kPortAudioIsAMModulator) {
+			// Yes: This slave doesn't provide audio data for mixing, but instead
+			// a time-series of gain modulation samples for amplitude modulation.
+			// Multiply the master channels samples with the slaves "gain samples"
+			// to apply AM modulation:
+			PsychPAMixSlaveChannels(mixBuffer, dev->outchannels, slaveOutBuffer, audiodevices[slaveId].outchannels,
+									audiodevices[slaveId].outputmappings, audiodevices[slaveId].mixGains, dev->batchsize - committedFrames, kPsychPAMixModulate);
 		}
 		else {
-			// Regular or master audio device: Real hardware with real need for
-			// Portaudio shutdown.
-			
-			// Stop, shutdown and release audio stream:
-			Pa_StopStream(stream);
-			
-			// Unregister the stream finished callback:
-			Pa_SetStreamFinishedCallback(stream, NULL);
-			
-			// Our device thread, callbacks and hardware are stopped, all mutexes are unlocked,
-			// all our potential slaves are inactive as well. We can safely destroy our slaves,
-			// if any, ie., if we are a master:
-			if ((audiodevices[id].slaveCount > 0) && (audiodevices[id].slaves)) {
-				// Iterate over our slaves and close them:
-				for (i=0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) {
-					if (audiodevices[id].slaves[i] > -1) PsychPACloseStream(audiodevices[id].slaves[i]);
-				}
-				
-				// Sanity-check:
-				if (audiodevices[id].slaveCount > 0) printf("PsychPortAudio: CRITICAL! To be deleted master device %i has non-zero slaveCount %i after destroying slaves! BUG!!\n", id, audiodevices[id].slaveCount);
+			// Regular mix: Mix all output channels of the slave into the proper target channels
+			// of the master by simple addition. Apply per-channel volume settings of the slave
+			// during mix:
+			PsychPAMixSlaveChannels(mixBuffer, dev->outchannels, slaveOutBuffer, audiodevices[slaveId].outchannels,
+									audiodevices[slaveId].outputmappings, audiodevices[slaveId].mixGains, dev->batchsize - committedFrames, kPsychPAMixAdd);
+		}
+	}
+}
 
-				// No slaves anymore. Done with master specific destruction.
-			}
-			
-			// Destruction for both master- and regular audio devices:
-			
-			// Close and destroy the hardware portaudio stream:
-			Pa_CloseStream(stream);
-		}
-		
-		// Common destruct path for all types of devices:
-		
-		// Release stream reference to now dead stream:
-		audiodevices[id].stream = NULL;
-		
-		// Free associated sound outputbuffer:
-		if(audiodevices[id].outputbuffer) {
-			free(audiodevices[id].outputbuffer);
-			audiodevices[id].outputbuffer = NULL;
-			audiodevices[id].outputbuffersize = 0;
-		}				
+// Claim and render slave jobs of the current batch of master 'dev', until no unclaimed jobs are left.
+// 'generation' is the workerGeneration of the batch for which the caller wants to process jobs.
+// Each job is claimed by atomically incrementing the job index in slaveJobNext, which only succeeds
+// if the batch is still current, so a worker thread which wakes up late can't steal jobs from a
+// later batch. Each finished job increments slaveJobsDone.
+static void PsychPAProcessSlaveJobs(PsychPADevice* dev, int generation)
+{
+	int next, job, slaveId;
 
-		// Free associated sound inputbuffer:
-		if(audiodevices[id].inputbuffer) {
-			free(audiodevices[id].inputbuffer);
-			audiodevices[id].inputbuffer = NULL;
-			audiodevices[id].inputbuffersize = 0;
-		}
+	while (1) {
+		next = dev->slaveJobNext;
+		PsychPAMemoryBarrier();
 
-		// Free associated schedule, if any:
-		if(audiodevices[id].schedule) {
-			free(audiodevices[id].schedule);
-			audiodevices[id].schedule = NULL;
-			audiodevices[id].schedule_size = 0;
-		}				
+		// Batch no longer current, or no jobs left?
+		job = next & 0xffff;
+		if (((next >> 16) != (generation & 0x7fff)) || (job >= dev->slaveJobCount)) break;
 
-		// Free associated sound intermixbuffers:
-		if(audiodevices[id].slaveOutBuffer) {
-			free(audiodevices[id].slaveOutBuffer);
-			audiodevices[id].slaveOutBuffer = NULL;
-		}				
+		// Try to claim the job. Retry if some other thread was faster:
+		if (PsychPAAtomicCAS(&(dev->slaveJobNext), next, next + 1) != next) continue;
 
-		if(audiodevices[id].slaveGainBuffer) {
-			free(audiodevices[id].slaveGainBuffer);
-			audiodevices[id].slaveGainBuffer = NULL;
-		}				
+		// Got job 'job': Render the slave into its private buffers:
+		slaveId = dev->slaveJobs[job];
+		PsychPARenderSlave(dev, slaveId, dev->workerIn, audiodevices[slaveId].slaveInBuffer, audiodevices[slaveId].slaveOutBuffer,
+						   audiodevices[slaveId].slaveGainBuffer, dev->workerTimeInfo, dev->workerStatusFlags);
 
-		if(audiodevices[id].slaveInBuffer) {
-			free(audiodevices[id].slaveInBuffer);
-			audiodevices[id].slaveInBuffer = NULL;
-		}				
+		// Job done:
+		PsychPAAtomicIncrement(&(dev->slaveJobsDone));
+	}
+}
 
-		// Free slave array:
-		if(audiodevices[id].slaves) {
-			free(audiodevices[id].slaves);
-			audiodevices[id].slaves = NULL;
-		}				
-		
-		// Free in-/outputmapping:
-		if(audiodevices[id].inputmappings) {
-			free(audiodevices[id].inputmappings);
-			audiodevices[id].inputmappings = NULL;
-		}				
+// Main routine of slave worker threads of master 'dev': Sleep until woken up for a new batch of
+// slave jobs by the master callback, then help with rendering of the batch:
+static void* PsychPASlaveWorkerMain(void* arg)
+{
+	PsychPAWorker* worker = (PsychPAWorker*) arg;
+	PsychPADevice* dev = worker->dev;
+	int rc;
 
-		if(audiodevices[id].outputmappings) {
-			free(audiodevices[id].outputmappings);
-			audiodevices[id].outputmappings = NULL;
-		}				
+	// Switch ourselves to realtime priority, just as the audio callback thread:
+	if ((rc = PsychSetThreadPriority(NULL, ((PSYCH_SYSTEM == PSYCH_WINDOWS) ? 10 : 2), 0)) != 0) {
+		if (verbosity > 1) printf("PsychPortAudio-WARNING: Failed to switch slave worker thread to realtime priority [%i]. Parallel slave rendering may cause xruns.\n", rc);
+	}
 
-		// Free vector of outChannelVolumes:
-		if(audiodevices[id].outChannelVolumes) {
-			free(audiodevices[id].outChannelVolumes);
-			audiodevices[id].outChannelVolumes = NULL;
-		}				
+	while (1) {
+		// Wait for a new batch of jobs, or for shutdown:
+		PsychPAWaitSemaphore(&(dev->workerWakeup));
+		if (dev->workerShutdown) break;
 
-		// If we use locking, we need to destroy the per-device mutex:
-		if (uselocking && PsychDestroyMutex(&(audiodevices[id].mutex))) printf("PsychPortAudio: CRITICAL! Failed to release Mutex object for pahandle %i! Prepare for trouble!\n", id);
+		// Help with the current batch. If we woke up late and the batch is already done, there's nothing to claim:
+		PsychPAMemoryBarrier();
+		PsychPAProcessSlaveJobs(dev, dev->workerGeneration);
+	}
 
-		// If we use locking, this will destroy the associated event variable:
-		PsychPADestroySignal(&(audiodevices[id]));
+	return(NULL);
+}
 
-		// One device less:
-		audiodevicecount--;
+// Allocate private scratch buffers for parallel rendering of slave 'slave' of master 'dev', with the
+// capacity selected by PsychPAStartSlaveWorkers(). Called at slave open time, not from paCallback:
+static void PsychPAAllocSlaveWorkerBuffers(PsychPADevice* dev, PsychPADevice* slave)
+{
+	psych_int64 frames = dev->workerBufferFrames;
+
+	slave->slaveInBuffer = (dev->opmode & kPortAudioCapture) ? (float*) malloc(sizeof(float) * frames * dev->inchannels) : NULL;
+	slave->slaveOutBuffer = (dev->opmode & kPortAudioPlayBack) ? (float*) malloc(sizeof(float) * frames * dev->outchannels) : NULL;
+	slave->slaveGainBuffer = (dev->opmode & kPortAudioPlayBack) ? (float*) malloc(sizeof(float) * frames * dev->outchannels) : NULL;
+	slave->workerBufferFrames = frames;
+
+	if (((dev->opmode & kPortAudioCapture) && (NULL == slave->slaveInBuffer)) ||
+		((dev->opmode & kPortAudioPlayBack) && ((NULL == slave->slaveOutBuffer) || (NULL == slave->slaveGainBuffer)))) {
+		free(slave->slaveInBuffer);
+		free(slave->slaveOutBuffer);
+		free(slave->slaveGainBuffer);
+		slave->slaveInBuffer = NULL;
+		slave->slaveOutBuffer = NULL;
+		slave->slaveGainBuffer = NULL;
+		slave->workerBufferFrames = 0;
+		PsychErrorExitMsg(PsychError_outofMemory, "Insufficient memory for slave scratch buffers for parallel rendering!");
 	}
-	
-	return;
 }
 
-void InitializeSynopsis(void)
+// Render all real slaves of master 'dev' in parallel on the calling callback thread and the masters
+// worker threads, then mix their output into 'mixBuffer' in the same order as the serial code would.
+// Each slave renders into its own private scratch buffers, preallocated at slave open time. Called from
+// the masters paCallback with the masters mutex held. Returns the number of handled slaves, or -1 without
+// doing anything if a slave lacks scratch buffers of sufficient capacity for this callback, in which case
+// the caller must render the slaves serially.
+static int PsychPARenderSlavesParallel(PsychPADevice* dev, const float* in, float* mixBuffer, psych_int64 committedFrames,
+									   const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags)
 {
-	int i=0;
-	const char **synopsis = synopsisSYNOPSIS;  //abbreviate the long name
-	
-	synopsis[i++] = "PsychPortAudio - A sound driver built around the PortAudio sound library:\n";
-	synopsis[i++] = "\nGeneral information:\n";
-	synopsis[i++] = "version = PsychPortAudio('Version');";
-	synopsis[i++] = "oldlevel = PsychPortAudio('Verbosity' [,level]);";
-	synopsis[i++] = "count = PsychPortAudio('GetOpenDeviceCount');";
-	synopsis[i++] = "devices = PsychPortAudio('GetDevices' [,devicetype] [, deviceIndex]);";
-	synopsis[i++] = "\nGeneral settings:\n";
-	synopsis[i++] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend]);";
-	synopsis[i++] = "oldRunMode = PsychPortAudio('RunMode', pahandle [,runMode]);";
-	synopsis[i++] = "\n\nDevice setup and shutdown:\n";
-	synopsis[i++] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
-	synopsis[i++] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels]);";
-	synopsis[i++] = "PsychPortAudio('Close' [, pahandle]);";
-	synopsis[i++] = "oldOpMode = PsychPortAudio('SetOpMode', pahandle [, opModeOverride]);";
-	synopsis[i++] = "oldbias = PsychPortAudio('LatencyBias', pahandle [,biasSecs]);";
-	synopsis[i++] =	"[oldMasterVolume, oldChannelVolumes] = PsychPortAudio('Volume', pahandle [, masterVolume][, channelVolumes]);";
-	synopsis[i++] = "enable = PsychPortAudio('DirectInputMonitoring', pahandle, enable [, inputChannel = -1][, outputChannel = 0][, gainLevel = 0.0][, stereoPan = 0.5]);";
-	synopsis[i++] = "[underflow, nextSampleStartIndex, nextSampleETASecs] = PsychPortAudio('FillBuffer', pahandle, bufferdata [, streamingrefill=0][, startIndex=Append]);";
-	synopsis[i++] =	"bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata);";
-	synopsis[i++] =	"PsychPortAudio('DeleteBuffer'[, bufferhandle] [, waitmode]);";
-	synopsis[i++] =	"PsychPortAudio('RefillBuffer', pahandle [, bufferhandle=0], bufferdata [, startIndex=0]);";
-	synopsis[i++] = "PsychPortAudio('SetLoop', pahandle[, startSample=0][, endSample=max][, UnitIsSeconds=0]);";
-	synopsis[i++] = "startTime = PsychPortAudio('Start', pahandle [, repetitions=1] [, when=0] [, waitForStart=0] [, stopTime=inf] [, resume=0]);";
-	synopsis[i++] = "startTime = PsychPortAudio('RescheduleStart', pahandle, when [, waitForStart=0] [, repetitions] [, stopTime]);";
-	synopsis[i++] = "status = PsychPortAudio('GetStatus' pahandle);";
-	synopsis[i++] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, singleType=0]);";
-	synopsis[i++] = "[startTime endPositionSecs xruns estStopTime] = PsychPortAudio('Stop', pahandle [,waitForEndOfPlayback=0] [, blockUntilStopped=1] [, repetitions] [, stopTime]);";
-	synopsis[i++] =	"PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
-	synopsis[i++] =	"[success, freeslots] = PsychPortAudio('AddToSchedule', pahandle [, bufferHandle=0][, repetitions=1][, startSample=0][, endSample=max][, UnitIsSeconds=0][, specialFlags=0]);";
+	int i, slaveId, modulatorSlave, count, generation, numSlavesHandled, spins;
+	double tnow, tdeadline;
+
+	// Build list of jobs: One per real slave, skipping invalid slots, output capturer slaves
+	// and AM modulators attached to slaves, which get rendered as part of their parent slave:
+	count = 0;
+	numSlavesHandled = 0;
+	for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount); i++) {
+		slaveId = dev->slaves[i];
+		if ((slaveId < 0) || (audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) continue;
+
+		numSlavesHandled++;
+		if (audiodevices[slaveId].opmode & kPortAudioIsAMModulatorForSlave) continue;
+
+		// Private scratch buffers of sufficient capacity? Otherwise render serially:
+		if (audiodevices[slaveId].workerBufferFrames < dev->batchsize) return(-1);
+
+		dev->slaveJobs[count++] = slaveId;
+	}
+
+	// Workers must not touch the global bufferListmutex while rendering the slaves and their modulators:
+	for (i = 0; i < count; i++) {
+		slaveId = dev->slaveJobs[i];
+		audiodevices[slaveId].deferScheduleUnref = 1;
+		modulatorSlave = audiodevices[slaveId].modulatorSlave;
+		if (modulatorSlave > -1) audiodevices[modulatorSlave].deferScheduleUnref = 1;
+	}
+
+	// Publish new batch: Job list and parameters first, then the job index with the new generation:
+	generation = (dev->workerGeneration + 1) & 0x7fff;
+	dev->workerIn = in;
+	dev->workerTimeInfo = timeInfo;
+	dev->workerStatusFlags = statusFlags;
+	dev->slaveJobCount = count;
+	dev->slaveJobsDone = 0;
+	PsychPAMemoryBarrier();
+	dev->slaveJobNext = generation << 16;
+	dev->workerGeneration = generation;
+	PsychPAMemoryBarrier();
+
+	// Wake up as many worker threads as can help, unless there's only a single job, which we can do faster
+	// ourselves. Posting the semaphore doesn't take any lock and never blocks:
+	for (i = 0; (i < dev->workerCount) && (i < count - 1); i++) PsychPAPostSemaphore(&(dev->workerWakeup));
+
+	// Help with processing the batch:
+	PsychPAProcessSlaveJobs(dev, generation);
+
+	// Barrier: All unclaimed jobs were rendered by ourselves, so only wait for the jobs which are still in
+	// progress on worker threads. Spin for at most a quarter of the duration of this buffer. If the workers
+	// are slower than that, they don't help, but only add latency, e.g., because the system is overloaded
+	// or they don't get realtime priority. Then render slaves serially in all future callbacks until the
+	// next 'Start'. We still need their output for this buffer, so keep spinning until they are done, as
+	// paCallback must never sleep or yield:
+	spins = 0;
+	tdeadline = -1;
+	while (dev->slaveJobsDone < count) {
+		if (!dev->workerFallback && ((++spins & 0x3ff) == 0)) {
+			PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+			if (tdeadline < 0) {
+				tdeadline = tnow + 0.25 * (double) dev->batchsize / dev->streaminfo->sampleRate;
+			}
+			else if (tnow > tdeadline) {
+				dev->workerFallback = 1;
+			}
+		}
 
-	synopsis[i++] = NULL;  //this tells PsychDisplayScreenSynopsis where to stop
-	if (i > MAX_SYNOPSIS_STRINGS) {
-		PrintfExit("%s: increase dimension of synopsis[] from %ld to at least %ld and recompile.",__FILE__,(long)MAX_SYNOPSIS_STRINGS,(long)i);
+		#if PSYCH_PA_USE_SSE2
+		_mm_pause();
+		#endif
+	}
+	PsychPAMemoryBarrier();
+
+	for (i = 0; i < count; i++) {
+		slaveId = dev->slaveJobs[i];
+		audiodevices[slaveId].deferScheduleUnref = 0;
+		modulatorSlave = audiodevices[slaveId].modulatorSlave;
+		if (modulatorSlave > -1) audiodevices[modulatorSlave].deferScheduleUnref = 0;
+	}
+
+	// Release buffer references of schedule slots consumed by the slaves during the batch, under a single lock.
+	// If some other thread holds the lock, don't wait for it, but leave the references marked for release:
+	if (PsychTryLockMutex(&bufferListmutex) == 0) {
+		for (i = 0; i < count; i++) {
+			slaveId = dev->slaveJobs[i];
+			if (audiodevices[slaveId].scheduleUnrefPending) PsychPAReleaseDeferredScheduleRefs(&(audiodevices[slaveId]));
+			modulatorSlave = audiodevices[slaveId].modulatorSlave;
+			if ((modulatorSlave > -1) && audiodevices[modulatorSlave].scheduleUnrefPending) PsychPAReleaseDeferredScheduleRefs(&(audiodevices[modulatorSlave]));
+		}
+		PsychUnlockMutex(&bufferListmutex);
 	}
+
+	// Mixdown of all slave outputs, in slave order:
+	for (i = 0; i < count; i++) {
+		slaveId = dev->slaveJobs[i];
+		PsychPAMixSlaveOutput(dev, slaveId, mixBuffer, audiodevices[slaveId].slaveOutBuffer, committedFrames);
+	}
+
+	return(numSlavesHandled);
 }
 
-PaHostApiIndex PsychPAGetLowestLatencyHostAPI(void)
+// Start 'slaveWorkerThreads' worker threads for parallel rendering of slaves on master device 'dev':
+static void PsychPAStartSlaveWorkers(PsychPADevice* dev)
 {
-	PaHostApiIndex ai;
-	
-	#if PSYCH_SYSTEM == PSYCH_OSX
-		// CoreAudio or nothing ;-)
-		return(Pa_HostApiTypeIdToHostApiIndex(paCoreAudio));
-	#endif
-	
-	#if PSYCH_SYSTEM == PSYCH_LINUX
-		// Try ALSA first...
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paALSA))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// Then JACK...
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paJACK))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// Then OSS...
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paOSS))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// then give up!
-		printf("PTB-ERROR: Could not find an operational audio subsystem on this Linux machine! Soundcard and driver installed and enabled?!?\n");
-		return(paHostApiNotFound);
-	#endif
-	
+	int i, rc;
+
+	dev->workerThreads = NULL;
+	dev->workerCount = 0;
+
+	if (slaveWorkerThreads <= 0) return;
+
 	#if PSYCH_SYSTEM == PSYCH_WINDOWS
-		// Try ASIO first. It's supposed to be the lowest latency API on soundcards that suppport it.
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paASIO))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// Then WDM kernel streaming (Win2000, XP, maybe Vista). This is the best working free builtin
-		// replacement for the proprietary ASIO interface.
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paWDMKS))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// Then Vistas new WASAPI, which is supposed to replace WDMKS, but is still early alpha quality in PortAudio:
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paWASAPI))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// Then DirectSound: Bad, but not a complete disaster if the sound card has DS native drivers: 
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paDirectSound))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// Then Windows MME, a complete disaster, but better than silence...?!? 
-		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paMME))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
-		// then give up!
-		printf("PTB-ERROR: Could not find an operational audio subsystem on this Windows machine! Soundcard and driver installed and enabled?!?\n");
-		return(paHostApiNotFound);
+	if (lockToCore1) {
+		if (verbosity > 2) printf("PsychPortAudio-INFO: Parallel slave rendering disabled, because all engine threads are locked to cpu core 1. See 'EngineTunables'.\n");
+		return;
+	}
 	#endif
-	
-	printf("PTB-FATAL-ERROR: Impossible point in code execution reached! (End of PsychPAGetLowestLatencyHostAPI()\n");
-	return(paHostApiNotFound);
+
+	dev->slaveJobs = (int*) malloc(sizeof(int) * MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE);
+	dev->workerThreads = (PsychPAWorker*) calloc(slaveWorkerThreads, sizeof(PsychPAWorker));
+	if ((NULL == dev->slaveJobs) || (NULL == dev->workerThreads)) {
+		free(dev->slaveJobs);
+		free(dev->workerThreads);
+		dev->slaveJobs = NULL;
+		dev->workerThreads = NULL;
+		PsychErrorExitMsg(PsychError_outofMemory, "Insufficient memory for setup of slave worker threads!");
+	}
+
+	if (PsychPAInitSemaphore(&(dev->workerWakeup)) != 0) {
+		free(dev->slaveJobs);
+		free(dev->workerThreads);
+		dev->slaveJobs = NULL;
+		dev->workerThreads = NULL;
+		PsychErrorExitMsg(PsychError_system, "Failed to create wakeup semaphore for slave worker threads!");
+	}
+
+	dev->workerShutdown = 0;
+	dev->workerGeneration = 0;
+	dev->slaveJobCount = 0;
+	dev->slaveJobNext = 0;
+	dev->slaveJobsDone = 0;
+	dev->workerFallback = 0;
+
+	// Capacity of the private scratch buffers of slaves, allocated when they get opened: Big enough for
+	// the stream latency, which bounds the size of callback batches, and at least the maximum 'buffersize':
+	dev->workerBufferFrames = PSYCH_PA_WORKER_MINFRAMES;
+	if (dev->streaminfo && (dev->workerBufferFrames < (psych_int64) ceil(dev->streaminfo->outputLatency * dev->streaminfo->sampleRate))) {
+		dev->workerBufferFrames = (psych_int64) ceil(dev->streaminfo->outputLatency * dev->streaminfo->sampleRate);
+	}
+
+	for (i = 0; i < slaveWorkerThreads; i++) {
+		dev->workerThreads[i].dev = dev;
+		if ((rc = PsychCreateThread(&(dev->workerThreads[i].thread), NULL, PsychPASlaveWorkerMain, (void*) &(dev->workerThreads[i]))) != 0) {
+			if (verbosity > 1) printf("PsychPortAudio-WARNING: Failed to create slave worker thread %i [%i]. Using only %i worker threads.\n", i, rc, i);
+			break;
+		}
+		dev->workerCount++;
+	}
+
+	if (verbosity > 3) printf("PTB-INFO: Using %i worker threads for parallel rendering of slave devices.\n", dev->workerCount);
 }
 
-PsychError PSYCHPORTAUDIODisplaySynopsis(void)
+// Stop and destroy all slave worker threads of master 'dev'. The masters stream must be stopped:
+static void PsychPAStopSlaveWorkers(PsychPADevice* dev)
 {
 	int i;
-	
-	for (i = 0; synopsisSYNOPSIS[i] != NULL; i++)
-		printf("%s\n",synopsisSYNOPSIS[i]);
-	
-	return(PsychError_none);
+
+	if (NULL == dev->workerThreads) return;
+
+	// Ask all workers to exit and wake them up:
+	dev->workerShutdown = 1;
+	PsychPAMemoryBarrier();
+	for (i = 0; i < dev->workerCount; i++) PsychPAPostSemaphore(&(dev->workerWakeup));
+
+	for (i = 0; i < dev->workerCount; i++) PsychDeleteThread(&(dev->workerThreads[i].thread));
+
+	PsychPADestroySemaphore(&(dev->workerWakeup));
+
+	free(dev->workerThreads);
+	dev->workerThreads = NULL;
+	dev->workerCount = 0;
+
+	free(dev->slaveJobs);
+	dev->slaveJobs = NULL;
 }
 
-// Module exit function: Stop and close all audio streams, terminate PortAudio...
-PsychError PsychPortAudioExit(void)
+// Store 'v' as little-endian 16, 32 or 64 bit value at 'p', as needed for WAV file headers:
+static void PsychPAPutLE16(unsigned char* p, unsigned int v)
 {
-	PaError err;
-	int i;
-	
-	if (pa_initialized) {
-		for(i=0; i<MAX_PSYCH_AUDIO_DEVS; i++) {
-			// Close i'th stream, if it is open:
-			PsychPACloseStream(i);
-		}
-		audiodevicecount = 0;
-		
-		// Delete all audio buffers and the bufferlist itself:
-		PsychPADeleteAllAudioBuffers();
-		
-		// Release audiobufferlist mutex lock:
-		PsychDestroyMutex(&bufferListmutex);
-		
-		// Shutdown PortAudio itself:
-		err = Pa_Terminate();
-		if (err) {
-			printf("PTB-FATAL-ERROR: PsychPortAudio: Shutdown of PortAudio subsystem failed. Depending on the quality\n");
-			printf("PTB-FATAL-ERROR: of your operating system, this may leave the sound system of your machine dead or confused.\n");
-			printf("PTB-FATAL-ERROR: Exit and restart Matlab/Octave. Windows users additionally may want to reboot...\n");
-			printf("PTB-FATAL-ERRRO: PortAudio reported the following error: %s\n\n", Pa_GetErrorText(err)); 
-		}
-		else {
-			pa_initialized = FALSE;
-		}
+	p[0] = (unsigned char) (v & 0xff);
+	p[1] = (unsigned char) ((v >> 8) & 0xff);
+}
 
-		// Restart suspended PulseAudio server if it was suspended by us:
-		if (pulseaudio_isSuspended) {
-			// Call external "pactl" utility via shell to ask
-			// the server to resume all sinks and sources.
-			// These calls should fail silently if either the
-			// pactl utility isn't installed or no sound
-			// server is running:
-			if (verbosity > 4) printf("PTB-INFO: Trying to resume potentially suspended PulseAudio server.\n");
-			PsychRuntimeEvaluateString("system('pactl suspend-sink 0');");
-			PsychRuntimeEvaluateString("system('pactl suspend-source 0');");
-			pulseaudio_isSuspended = FALSE;
-		}
-	}
+static void PsychPAPutLE32(unsigned char* p, unsigned int v)
+{
+	PsychPAPutLE16(p, v & 0xffff);
+	PsychPAPutLE16(p + 2, (v >> 16) & 0xffff);
+}
 
-	// Detach our callback function for low-level debug output:
-	PaUtil_SetDebugPrintFunction(NULL);
-	
-	return(PsychError_none);
+static void PsychPAPutLE64(unsigned char* p, psych_uint64 v)
+{
+	PsychPAPutLE32(p, (unsigned int) (v & 0xffffffff));
+	PsychPAPutLE32(p + 4, (unsigned int) (v >> 32));
 }
 
-void PsychPortAudioInitialize(void)
+// Build the PSYCH_PA_CAPTUREFILE_HEADERSIZE bytes header of a WAV capture file with 'dataBytes' bytes of 32 bit float sound data.
+// Files up to 4 GB are RIFF WAVE files, bigger files are RF64 files which store the sizes in a 'ds64' chunk. The space for the
+// 'ds64' chunk is reserved in RIFF files by a 'JUNK' chunk. A second 'JUNK' chunk pads the header, so sound data starts at an
+// offset which is aligned to file system blocks:
+static void PsychPABuildCaptureFileHeader(unsigned char* header, int channels, double sampleRate, psych_uint64 dataBytes)
 {
-	PaError err;
-	int i;
-	
-	// PortAudio already initialized?
-	if (!pa_initialized) {
-		// No - Initialize:
+	psych_uint64 riffBytes = PSYCH_PA_CAPTUREFILE_HEADERSIZE - 8 + dataBytes;
+	psych_bool rf64 = (riffBytes > 0xffffffff) ? TRUE : FALSE;
+	unsigned int fmtBytes = (channels > 2) ? 40 : 16;
+	unsigned int pos;
+
+	memset(header, 0, PSYCH_PA_CAPTUREFILE_HEADERSIZE);
+	memcpy(header, (rf64) ? "RF64" : "RIFF", 4);
+	PsychPAPutLE32(header + 4, (rf64) ? 0xffffffff : (unsigned int) riffBytes);
+	memcpy(header + 8, "WAVE", 4);
+
+	// 'ds64' chunk with the 64 bit sizes, or 'JUNK' placeholder for it:
+	memcpy(header + 12, (rf64) ? "ds64" : "JUNK", 4);
+	PsychPAPutLE32(header + 16, 28);
+	if (rf64) {
+		PsychPAPutLE64(header + 20, riffBytes);
+		PsychPAPutLE64(header + 28, dataBytes);
+		PsychPAPutLE64(header + 36, dataBytes / (sizeof(float) * channels));
+	}
+
+	// 'fmt ' chunk: WAVE_FORMAT_IEEE_FLOAT, or WAVE_FORMAT_EXTENSIBLE with float subformat for more than 2 channels:
+	memcpy(header + 48, "fmt ", 4);
+	PsychPAPutLE32(header + 52, fmtBytes);
+	PsychPAPutLE16(header + 56, (channels > 2) ? 0xfffe : 3);
+	PsychPAPutLE16(header + 58, channels);
+	PsychPAPutLE32(header + 60, (unsigned int) sampleRate);
+	PsychPAPutLE32(header + 64, (unsigned int) sampleRate * channels * sizeof(float));
+	PsychPAPutLE16(header + 68, channels * sizeof(float));
+	PsychPAPutLE16(header + 70, 32);
+	if (channels > 2) {
+		PsychPAPutLE16(header + 72, 22);
+		PsychPAPutLE16(header + 74, 32);
+		PsychPAPutLE32(header + 76, 0);
+		memcpy(header + 80, "\x03\x00\x00\x00\x00\x00\x10\x00\x80\x00\x00\xaa\x00\x38\x9b\x71", 16);
+	}
+
+	// 'JUNK' padding up to the 'data' chunk at the end of the header:
+	pos = 56 + fmtBytes;
+	memcpy(header + pos, "JUNK", 4);
+	PsychPAPutLE32(header + pos + 4, PSYCH_PA_CAPTUREFILE_HEADERSIZE - 8 - (pos + 8));
+	memcpy(header + PSYCH_PA_CAPTUREFILE_HEADERSIZE - 8, "data", 4);
+	PsychPAPutLE32(header + PSYCH_PA_CAPTUREFILE_HEADERSIZE - 4, (rf64) ? 0xffffffff : (unsigned int) dataBytes);
+}
 
-		// Suspend possibly running PulseAudio sound server if requested.
-		// We do this before PortAudio initialization, so the PulseAudio
-		// server can't interfere with device enumeration as done during
-		// PortAudio init. This is a Linux only thing...
-		if (pulseaudio_autosuspend && (PSYCH_SYSTEM == PSYCH_LINUX)) {
-			// Call external "pactl" utility via runtime to ask
-			// the server to suspend all sinks and sources,
-			// hopefully releasing the underlying low-level audio
-			// devices for use by use. These calls should fail silently
-			// if either the pactl utility isn't installed or no sound
-			// server is running:
-			if (verbosity > 4) printf("PTB-INFO: Trying to suspend potentially running PulseAudio server.\n");
-			PsychRuntimeEvaluateString("system('pactl suspend-sink 1');");
-			PsychRuntimeEvaluateString("system('pactl suspend-source 1');");
-			pulseaudio_isSuspended = TRUE;
-		}
+// Write pending captured sound data of device 'dev' from its inputbuffer to its capture file. Called by the writer thread
+// with the device mutex held. Copies one chunk of at most writer->chunkSamples samples into the writers staging buffer under
+// the lock, so paCallback can't overwrite the data while it is written, then writes the copy with the lock dropped. Only
+// writes whole chunks, unless 'flush' is set. Returns the number of written samples, or -1 on write error:
+static psych_int64 PsychPADrainCaptureFile(PsychPADevice* dev, PsychPACaptureWriter* writer, psych_bool flush)
+{
+	psych_int64 insbsize, readposition, avail, lost, offset, chunk, count;
 
-        #if PSYCH_SYSTEM == PSYCH_WINDOWS
-        // Sanity check dynamic portaudio_x86.dll loading on Windows:
-        if (NULL == LoadLibrary("portaudio_x86.dll")) {
-            // Failed:
-            printf("\n\nPTB-ERROR: Tried to initialize PsychPortAudio's PortAudio engine. This didn't work,\n");
-            printf("PTB-ERROR: because i couldn't find or load the required portaudio_x86.dll library.\n");
-            printf("PTB-ERROR: Please make sure to call the InitializePsychSound function before first use of\n");
-            printf("PTB-ERROR: PsychPortAudio, otherwise this error will happen.\n\n");
-			PsychErrorExitMsg(PsychError_user, "Failed to initialize due to portaudio_x86.dll loading problem. Call InitializePsychSound first! Aborted.");
-        }
-        #endif
-        
-		// Setup callback function for low-level debug output:
-		PaUtil_SetDebugPrintFunction(PALogger);
+	insbsize = dev->inputbuffersize / sizeof(float);
+	readposition = dev->readposition;
+	avail = dev->recposition - readposition;
 
-		if ((err=Pa_Initialize())!=paNoError) {
-			printf("PTB-ERROR: Portaudio initialization failed with following port audio error: %s \n", Pa_GetErrorText(err));
-			PsychErrorExitMsg(PsychError_system, "Failed to initialize PortAudio subsystem.");
-		}
-		else {
-			if(verbosity>2) {
-				printf("PTB-INFO: Using specially modified PortAudio engine, based on offical version: %s\n", Pa_GetVersionText());
-			}
-		}
-		
-		for(i=0; i<MAX_PSYCH_AUDIO_DEVS; i++) {
-			audiodevices[i].stream = NULL;
-		}
-		
-		audiodevicecount=0;
+	// Never fetch the last sampleframe while the engine is running, it may be incomplete. See 'GetAudioData':
+	if (dev->state > 0) {
+		avail = avail - (avail % dev->inchannels);
+		avail-= dev->inchannels;
+	}
 
-		// Init audio bufferList to empty and Mutex to unlocked:
-		bufferListCount = 0;
-		bufferList = NULL;
-		PsychInitMutex(&bufferListmutex);
+	if ((avail <= 0) || (insbsize <= 0)) return(0);
 
-		// On Vista systems and later, we assume everything will be fine wrt. to timing and multi-core
-		// systems, but still perform consistency checks at each call to PsychGetPrecisionTimerSeconds().
-		// Therefore we don't lock our threads to a single core by default. On pre-Vista systems, we
-		// lock all threads to core 1 by default:
-		lockToCore1 = (PsychIsMSVista()) ? FALSE : TRUE;
+	// Capture ringbuffer overflowed? Skip the samples which got overwritten before we could copy them:
+	if (avail > insbsize) {
+		lost = avail - insbsize;
+		lost += (dev->inchannels - (lost % dev->inchannels)) % dev->inchannels;
 
-		pa_initialized = TRUE;
+		readposition += lost;
+		avail -= lost;
+		dev->readposition = readposition;
+		dev->captureFileOverflows++;
+		dev->captureFileLostFrames += lost / dev->inchannels;
 	}
-}
 
-/* PsychPortAudio('Open') - Open and initialize an audio device via PortAudio.
- */
-PsychError PSYCHPORTAUDIOOpen(void) 
-{
- 	static char useString[] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
-	//															1			 2		 3					4		5			6			  7					  8					  9
-	static char synopsisString[] = 
-		"Open a PortAudio audio device and initialize it. Returns a 'pahandle' device handle for the device. "
-		"All parameters are optional and have reasonable defaults. 'deviceid' Index to select amongst multiple "
-		"logical audio devices supported by PortAudio. Defaults to whatever the systems default sound device is. "
-		"Different device id's may select the same physical device, but controlled by a different low-level sound "
-		"system. E.g., Windows has about five different sound subsystems. 'mode' Mode of operation. Defaults to "
-		"1 == sound playback only. Can be set to 2 == audio capture, or 3 for simultaneous capture and playback of sound. "
-		"Note however that mode 3 (full duplex) does not work reliably on all sound hardware. On some hardware this mode "
-		"may crash Matlab! There is also a special monitoring mode == 7, which only works for full duplex devices "
-		"when using the same number of input- and outputchannels. This mode allows direct feedback of captured sounds "
-		"back to the speakers with minimal latency and without involvement of your script at all, however no sound "
-		"can be captured during this time and your code mostly doesn't have any control over timing etc. \n"
-		"You can also define a audio device as a master device by adding the value 8 to mode. Master devices themselves "
-		"are not directly used to playback or capture sound. Instead one can create (multiple) slave devices that are "
-		"attached to a master device. Each slave can be controlled independently to playback or record sound through "
-		"a subset of the channels of the master device. This basically allows to virtualize a soundcard. See "
-		"help for subfunction 'OpenSlave' for more info.\n"
-		"'reqlatencyclass' Allows to select how aggressive PsychPortAudio should be about minimizing sound latency "
-		"and getting good deterministic timing, i.e. how to trade off latency vs. system load and playing nicely "
-		"with other sound applications on the system. Level 0 means: Don't care about latency, this mode works always "
-		"and with all settings, plays nicely with other sound applications. Level 1 (the default) means: Try to get "
-		"the lowest latency that is possible under the constraint of reliable playback, freedom of choice for all parameters and "
-		"interoperability with other applications. Level 2 means: Take full control over the audio device, even if this "
-		"causes other sound applications to fail or shutdown. Level 3 means: As level 2, but request the most aggressive "
-		"settings for the given device. Level 4: Same as 3, but fail if device can't meet the strictest requirements. "
-		"'freq' Requested playback/capture rate in samples per second (Hz). Defaults to a value that depends on the "
-		"requested latency mode. 'channels' Number of audio channels to use, defaults to 2 for stereo. If you perform "
-		"simultaneous playback and recording, you can provide a 2 element vector for 'channels', specifying different "
-		"numbers of output channels and input channels. The first element in such a vector defines the number of playback "
-		"channels, the 2nd element defines capture channels. E.g., [2, 1] would define 2 playback channels (stereo) and 1 "
-		"recording channel. See the optional 'selectchannels' argument for selection of physical device channels on multi- "
-		"channel cards.\n"
-		"'buffersize' "
-		"requested size and number of internal audio buffers, smaller numbers mean lower latency but higher system load "
-		"and some risk of overloading, which would cause audio dropouts. 'suggestedLatency' optional requested latency in "
-		"seconds. PortAudio selects internal operating parameters depending on sampleRate, suggestedLatency and buffersize "
-		"as well as device internal properties to optimize for low latency output. Best left alone, only here as manual "
-		"override in case all the auto-tuning cleverness fails.\n "
-		"'selectchannels' optional matrix with mappings of logical channels to device channels: If you only want to use "
-		"a subset of the channels present on your sound card, e.g., only 2 playback channels on a 16 channel soundcard, "
-		"then you'd set the 'channels' argument to 2. The 'selectchannels' argument allows you to select, e.g.,  which "
-		"two of the 16 channels to use for playback. 'selectchannels' is a one row by 'channels' matrix with mappings "
-		"for pure playback or pure capture. For full-duplex mode (playback and capture), 'selectchannels' must be a "
-		"2 rows by max(channels) column matrix. row 1 will define playback channel mappings, whereas row 2 will then "
-		"define capture channel mappings. In any case, the number in the i'th column will define which physical device "
-		"channel will be used for playback or capture of the i'th PsychPortAudio channel (the i'th row of your sound "
-		"matrix). Numbering of physical device channels starts with zero! Example: Both, playback and simultaneous "
-		"recording are requested and 'channels' equals 2, ie, two playback channels and two capture channels. If you'd "
-		"specify 'selectchannels' as [0, 6 ; 12, 14], then playback would happen to device channels zero and six, "
-		"sound would be captured from device channels 12 and 14. Please note that channel selection is currently "
-		"only supported on MS-Windows with ASIO sound cards. The parameter is silently ignored for non-ASIO operation.\n\n"
-		"'specialFlags' Optional flags: Default to zero, can be or'ed or added together with the following flags/settings:\n"
-		"1 = Never prime output stream. By default the output stream is primed. Don't bother if you don't know what this means.\n"
-		"2 = Always clamp audio data to the valid -1.0 to 1.0 range. Clamping is enabled by default.\n"
-		"4 = Never clamp audio data.\n"
-		"8 = Always dither output audio data. By default, dithering is enabled in normal mode, and disabled in low-latency mode. "
-		"Dithering adds a stochastic noise pattern to the least significant bit of each output sample to reduce the impact of "
-		"audio quantization artifacts. Dithering can improve signal to noise ratio and quality of output sound, but it is more "
-		"compute intense and it could change very low-level properties of the audio signal, because what you hear is not exactly "
-		"what you specified.\n"
-		"16 = Never dither audio data, not even in normal mode.\n\n";
+	// Write only whole chunks, to get few big writes:
+	if (avail > writer->chunkSamples) avail = writer->chunkSamples;
+	if (!flush && (avail < writer->chunkSamples)) return(0);
+	if (avail <= 0) return(0);
 
-	static char seeAlsoString[] = "Close GetDeviceSettings ";	 
-  	
-	int freq, buffersize, latencyclass, mode, deviceid, i, numel, specialFlags;
-	int* nrchannels;
-	int  mynrchannels[2];
-	int  m, n, p;
-	double* mychannelmap;
-	double suggestedLatency, lowlatency;
-	PaDeviceIndex paDevice;
-	PaHostApiIndex paHostAPI;
-	PaStreamParameters outputParameters;
-	PaStreamParameters inputParameters;
-	const PaDeviceInfo* inputDevInfo, *outputDevInfo, *referenceDevInfo;
-	PaStreamFlags sflags;
-	PaError err;
-	PaStream *stream = NULL;
-	
-	#if PSYCH_SYSTEM == PSYCH_OSX
-		paMacCoreStreamInfo hostapisettings;
-	#endif
-	
-	#if PSYCH_SYSTEM == PSYCH_WINDOWS
-		// Additional data structures for setup of logical -> device channel
-		// mappings on ASIO multi-channel hardware:
-		PaAsioStreamInfo  inhostapisettings;
-		PaAsioStreamInfo  outhostapisettings;
-		int				  outputmappings[MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE];
-		int				  inputmappings[MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE];
-	#endif
-	
-	// Setup online help: 
-	PsychPushHelp(useString, synopsisString, seeAlsoString);
-	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
-	
-	PsychErrorExit(PsychCapNumInputArgs(9));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	// Copy the chunk out of the ringbuffer, taking wraparound into account, and consume it:
+	count = 0;
+	while (count < avail) {
+		offset = (readposition + count) % insbsize;
+		chunk = (avail - count < insbsize - offset) ? avail - count : insbsize - offset;
+		memcpy(&(writer->stageBuffer[count]), &(dev->inputbuffer[offset]), (size_t) chunk * sizeof(float));
+		count += chunk;
+	}
 
-	if (audiodevicecount >= MAX_PSYCH_AUDIO_DEVS) PsychErrorExitMsg(PsychError_user, "Maximum number of simultaneously open audio devices reached.");
-	 
-	freq = 0;
-	buffersize = 0;
-	latencyclass = 1;
-	mode = kPortAudioPlayBack;
-	deviceid = -1;
-	specialFlags = 0;
-	
-	// Make sure PortAudio is online:
-	PsychPortAudioInitialize();
-	
-	// Sanity check: Any hardware found?
-	if (Pa_GetDeviceCount() == 0) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system! Either your machine doesn't have audio hardware, or somethings seriously screwed.");
-	
-	// We default to generic system settings for host api specific settings:
-	outputParameters.hostApiSpecificStreamInfo = NULL;
-	inputParameters.hostApiSpecificStreamInfo  = NULL;
+	dev->readposition = readposition + avail;
 
-	// Request optional deviceid:
-	PsychCopyInIntegerArg(1, kPsychArgOptional, &deviceid);
-	if (deviceid < -1) PsychErrorExitMsg(PsychError_user, "Invalid deviceid provided. Valid values are -1 to maximum number of devices.");
+	// Write with the lock dropped:
+	PsychPAUnlockDeviceMutex(dev);
+	count = (psych_int64) fwrite(writer->stageBuffer, sizeof(float), (size_t) avail, writer->file);
+	if (count != avail) writer->error = (errno) ? errno : EIO;
+	PsychPALockDeviceMutex(dev);
 
-	// Request optional mode of operation:
-	PsychCopyInIntegerArg(2, kPsychArgOptional, &mode);
-	if (mode < 1 || mode > 15 || mode & kPortAudioIsAMModulator || mode & kPortAudioIsAMModulatorForSlave || mode & kPortAudioIsOutputCapture || ((mode & kPortAudioMonitoring) && ((mode & kPortAudioFullDuplex) != kPortAudioFullDuplex))) {
-		PsychErrorExitMsg(PsychError_user, "Invalid mode for regular- or master-audio device provided: Outside valid range or invalid combination of flags.");
-	}
+	// Update the statistics:
+	writer->dataBytes += count * sizeof(float);
+	dev->captureFileFrames += count / dev->inchannels;
 
-	// Request optional latency class:
-	PsychCopyInIntegerArg(3, kPsychArgOptional, &latencyclass);
-	if (latencyclass < 0 || latencyclass > 4) PsychErrorExitMsg(PsychError_user, "Invalid reqlatencyclass provided. Valid values are 0 to 4.");
+	return((count != avail) ? -1 : avail);
+}
 
-	if (deviceid == -1) {
-		// Default devices requested:
-		if ((latencyclass == 0) && (PSYCH_SYSTEM != PSYCH_LINUX)) {
-			// High latency mode on non-Linux. Simply pick system default devices.
-			// We don't pick these on Linux, because we'd end up with the ancient
-			// OSS, which is almost always a suboptimal choice for our purpose, even
-			// in high-latency mode.
-			outputParameters.device = Pa_GetDefaultOutputDevice(); /* Default output device. */
-			inputParameters.device  = Pa_GetDefaultInputDevice(); /* Default input device. */
-		}
-		else {
-			// Low latency mode: Try to find the host API which is supposed to be the fastest on
-			// a platform, then pick its default devices:
-			paHostAPI = PsychPAGetLowestLatencyHostAPI();
-			outputParameters.device = Pa_GetHostApiInfo(paHostAPI)->defaultOutputDevice;
-			inputParameters.device  = Pa_GetHostApiInfo(paHostAPI)->defaultInputDevice;
-		}
-	}
-	else {
-		// Specific device requested: In valid range?
-		if (deviceid >= Pa_GetDeviceCount() || deviceid < 0) {
-			PsychErrorExitMsg(PsychError_user, "Invalid deviceid provided. Higher than the number of devices - 1 or lower than zero.");
+// Main routine of the capture file writer thread of device 'dev': Write captured sound data in chunks whenever
+// a chunk is available, until shutdown is requested, then write out all remaining data:
+static void* PsychPACaptureWriterMain(void* arg)
+{
+	PsychPADevice* dev = (PsychPADevice*) arg;
+	PsychPACaptureWriter* writer = dev->captureWriter;
+
+	PsychPALockDeviceMutex(dev);
+
+	while (!writer->shutdown && !writer->error) {
+		if (PsychPADrainCaptureFile(dev, writer, FALSE) == 0) {
+			// Less than a chunk pending: Sleep for about half a chunk, or until shutdown is requested:
+			if (uselocking) {
+				PsychTimedWaitCondition(&(writer->signal), &(dev->mutex), writer->pollSecs);
+			}
+			else {
+				PsychYieldIntervalSeconds(writer->pollSecs);
+			}
 		}
-		
-		outputParameters.device = (PaDeviceIndex) deviceid;
-		inputParameters.device = (PaDeviceIndex) deviceid;
 	}
 
-	// Query properties of selected device(s):
-	inputDevInfo  = Pa_GetDeviceInfo(inputParameters.device);
-	outputDevInfo = Pa_GetDeviceInfo(outputParameters.device);
+	while (!writer->error && (PsychPADrainCaptureFile(dev, writer, TRUE) > 0));
 
-	// Select one of them as "reference" info devices: It's properties are used whenever
-	// no more specialized info is available. We use the output device (if any) as reference,
-	// otherwise fall back to the inputdevice.
-	referenceDevInfo = (outputDevInfo) ? outputDevInfo : inputDevInfo;
+	PsychPAUnlockDeviceMutex(dev);
 
-	// Sanity check: Any hardware found?
-	if (referenceDevInfo == NULL) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system - or at least not with the provided deviceid, if any!");
+	return(NULL);
+}
 
-	// Check if current set of selected/available devices is compatible with our playback mode:
-	if (((mode & kPortAudioPlayBack) || (mode & kPortAudioMonitoring)) && ((outputDevInfo == NULL) || (outputDevInfo && outputDevInfo->maxOutputChannels <= 0))) {
-		PsychErrorExitMsg(PsychError_user, "Audio output requested, but there isn't any audio output device available or you provided a deviceid for something else than an output device!");
-	}
+// Stop the capture file writer thread of device 'dev', if any, after it wrote out all pending captured data, then
+// finalize and close the file. Returns zero on success, or the errno of a failed write:
+static int PsychPAStopCaptureWriter(PsychPADevice* dev)
+{
+	PsychPACaptureWriter* writer = dev->captureWriter;
+	unsigned char header[PSYCH_PA_CAPTUREFILE_HEADERSIZE];
+	int error;
 
-	if (((mode & kPortAudioCapture) || (mode & kPortAudioMonitoring)) && ((inputDevInfo == NULL) || (inputDevInfo && inputDevInfo->maxInputChannels <= 0))) {
-		PsychErrorExitMsg(PsychError_user, "Audio input requested, but there isn't any audio input device available or you provided a deviceid for something else than an input device!");
-	}
-	
-	// Request optional frequency:
-	PsychCopyInIntegerArg(4, kPsychArgOptional, &freq);
-	if (freq < 0 || freq > 200000) PsychErrorExitMsg(PsychError_user, "Invalid frequency provided. Valid values are 0 to 200000 Hz.");
-	
-	// Request optional number of channels:
-	numel = 0; nrchannels = NULL;
-	PsychAllocInIntegerListArg(5, kPsychArgOptional, &numel, &nrchannels);
-	if (numel == 0) {
-		// No optional channelcount argument provided: Default to two for playback and recording, unless device is
-		// a mono device -- then we default to one:
-		mynrchannels[0] = (outputDevInfo && outputDevInfo->maxOutputChannels < 2) ? outputDevInfo->maxOutputChannels : 2;
-		mynrchannels[1] = (inputDevInfo && inputDevInfo->maxInputChannels < 2) ? inputDevInfo->maxInputChannels : 2;
-	}
-	else if (numel == 1) {
-		// One argument provided: Set same count for playback and recording:
-		if (*nrchannels < 1 || *nrchannels > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. Valid values are 1 to device maximum.");
-		mynrchannels[0] = *nrchannels;
-		mynrchannels[1] =  *nrchannels;		
-	}
-	else if (numel == 2) {
-		// Separate counts for playback and recording provided: Set'em up.
-		if (nrchannels[0] < 1 || nrchannels[0] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of playback channels provided. Valid values are 1 to device maximum.");
-		mynrchannels[0] = nrchannels[0];
-		if (nrchannels[1] < 1 || nrchannels[1] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of capture channels provided. Valid values are 1 to device maximum.");
-		mynrchannels[1] = nrchannels[1];
-	}
-	else {
-		// More than 2 channel counts provided? Impossible.
-		PsychErrorExitMsg(PsychError_user, "You specified a list with more than two 'channels' entries? Can only be max 2 for playback- and capture.");
+	if (NULL == writer) return(0);
+
+	PsychPALockDeviceMutex(dev);
+	writer->shutdown = 1;
+	if (uselocking) PsychSignalCondition(&(writer->signal));
+	PsychPAUnlockDeviceMutex(dev);
+
+	PsychDeleteThread(&(writer->thread));
+	if (uselocking) PsychDestroyCondition(&(writer->signal));
+
+	// Rewrite WAV header with final sizes:
+	if (writer->format == 0) {
+		PsychPABuildCaptureFileHeader(header, (int) dev->inchannels, dev->streaminfo->sampleRate, (psych_uint64) writer->dataBytes);
+		if ((fseek(writer->file, 0, SEEK_SET) != 0) || (fwrite(header, 1, sizeof(header), writer->file) != sizeof(header))) {
+			if (!writer->error) writer->error = (errno) ? errno : EIO;
+		}
 	}
 
-	// Make sure that number of capture and playback channels is the same for fast monitoring/feedback mode:
-	if ((mode & kPortAudioMonitoring) && (mynrchannels[0] != mynrchannels[1])) PsychErrorExitMsg(PsychError_user, "Fast monitoring/feedback mode selected, but number of capture and playback channels differs! They must be the same for this mode!");
+	if ((fclose(writer->file) != 0) && !writer->error) writer->error = (errno) ? errno : EIO;
 
-	// Request optional buffersize:
-	PsychCopyInIntegerArg(6, kPsychArgOptional, &buffersize);
-	if (buffersize < 0 || buffersize > 4096) PsychErrorExitMsg(PsychError_user, "Invalid buffersize provided. Valid values are 0 to 4096 samples.");
+	error = writer->error;
+	dev->captureWriter = NULL;
+	free(writer->stageBuffer);
+	free(writer);
 
-	// Request optional suggestedLatency:
-	suggestedLatency = -1.0;
-	PsychCopyInDoubleArg(7, kPsychArgOptional, &suggestedLatency);
-	if (suggestedLatency!=-1 && (suggestedLatency < 0.0 || suggestedLatency > 1.0)) PsychErrorExitMsg(PsychError_user, "Invalid suggestedLatency provided. Valid values are 0.0 to 1.0 seconds.");
+	return(error);
+}
+
+/* paProcessCallback: PortAudo I/O processing callback, invoked via paCallback().
+ *
+ * This callback is called by PortAudios playback/capture engine whenever
+ * it needs new data for playback or has new data from capture. We are expected
+ * to take the inputBuffer's content and store it in our own recording buffers,
+ * and push data from our playback buffer queue into the outputBuffer.
+ *
+ * timeInfo tells us useful timing information, so we can estimate latencies,
+ * compensate for them, and so on...
+ *
+ * This callback is part of a realtime/interrupt/system context so don't do
+ * things like calling PortAudio functions, allocating memory, file i/o or
+ * other unbounded operations!
+ */
+static int paProcessCallback( const void *inputBuffer, void *outputBuffer,
+                             unsigned long framesPerBuffer,
+                             const PaStreamCallbackTimeInfo* timeInfo,
+                             PaStreamCallbackFlags statusFlags,
+                             void *userData )
+{
+	// Assign all variables, especially our dev device structure
+	// with info about this stream:
+	PsychPADevice* dev = (PsychPADevice*) userData;
+	float *out = (float*) outputBuffer;
+	float *in = (float*) inputBuffer;
+	float *playoutbuffer;
+	float *tmpBuffer, *mixBuffer;
+	float masterVolume, neutralValue;
+	psych_int64  j, k;
+	psych_int64 i, silenceframes, committedFrames, max_i;
+	psych_int64 inchannels, outchannels;
+	psych_int64  playposition, outsbsize, insbsize, recposition;
+	psych_int64  outsboffset;
+	unsigned int reqstate;
+	double now, firstsampleonset, onsetDelta, offsetDelta, captureStartTime, tMonotonic;
+	double repeatCount;	
+	psych_int64 playpositionlimit;
+	PaHostApiTypeId hA;
+	psych_bool stopEngine;
+	psych_bool isMaster, isSlave;
+	int slaveId, parc, numSlavesHandled;
+	unsigned int ringReadPos, ringMask;
+	psych_int64 ringAvail, ringLimit;
+	psych_int64 resampled;
+
+	// Device struct attached to stream? If no device struct
+	// is attached, we can't continue and tell the engine to abort
+	// processing of this stream:
+	if (dev == NULL) return(paAbort);
 	
-	// Get optional channel map:
-	mychannelmap = NULL;
-	PsychAllocInDoubleMatArg(8, kPsychArgOptional, &m, &n, &p, &mychannelmap);
-	if (mychannelmap) {
-		// Channelmapping provided: Sanity check it.
-		if (m<1 || m>2 || p!=1 || (n!=((mynrchannels[0] > mynrchannels[1]) ? mynrchannels[0] : mynrchannels[1]))) {
-			PsychErrorExitMsg(PsychError_user, "Invalid size of 'selectchannels' matrix argument: Must be a one- or two row by max(channels) column matrix!");
-		}
+	// Define our role:
+	isMaster = (dev->opmode & kPortAudioIsMaster) ? TRUE : FALSE;
+	isSlave = (dev->opmode & kPortAudioIsSlave) ? TRUE : FALSE;
+	
+	// Query host API: Done without mutex held, as it doesn't change during device lifetime:
+	hA=dev->hostAPI;
+
+	// Only compute timestamps from raw data if we're not a slave:
+	if (!isSlave) {
+		// Buffer timestamp computation code:
+		//
+		// This is executed at each callback iteration to provide PTB timebase onset times for
+		// the very first sample in this output buffer.
+		//
+		// The code is time-critical: To be executed as soon as possible after paCallback invocation,
+		// therefore at the beginning of control-flow before trying to lock (and potentially stall at) the device mutex!
+		//
+		// Executing without the mutex locked is safe: It only modifies/reads local variables, and only
+		// reads a few device struct variables which are all guaranteed to remain constant while the
+		// engine is running.
 		
-		// Basic check ok. Build ASIO host specific mapping structure:
-		#if PSYCH_SYSTEM == PSYCH_WINDOWS
-			// Check for ASIO: This only works for ASIO host API...
-			if (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type == paASIO) {
-				// MS-Windows and connected to an ASIO device. Good. Try to assign channel mapping:
-				if (mode & kPortAudioPlayBack) {
-					// Playback mappings:
-					outputParameters.hostApiSpecificStreamInfo = (PaAsioStreamInfo*) &outhostapisettings;
-					outhostapisettings.size = sizeof(PaAsioStreamInfo);
-					outhostapisettings.hostApiType = paASIO;
-					outhostapisettings.version = 1;
-					outhostapisettings.flags = paAsioUseChannelSelectors;
-					outhostapisettings.channelSelectors = (int*) &outputmappings[0];
-					for (i=0; i<mynrchannels[0]; i++) outputmappings[i] = (int) mychannelmap[i * m];
-					if (verbosity > 3) {
-						printf("PTB-INFO: Will try to use the following logical channel -> device channel mappings for sound output to audio stream %i :\n", audiodevicecount); 
-						for (i=0; i<mynrchannels[0]; i++) printf("%i --> %i : ", i+1, outputmappings[i]);
-						printf("\n\n");
-					}
-				}
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		// Super ugly hack for the most broken system in existence: Force
+		// the audio thread to cpu core 1, hope that repeated redundant
+		// calls don't create scheduling overhead or excessive other overhead.
+		// The explanation for this can be found in Source/Windows/Base/PsychTimeGlue.c
+		if (lockToCore1) SetThreadAffinityMask(GetCurrentThread(), 1);
+#endif
+		
+		// Retrieve current system time:
+		PsychGetAdjustedPrecisionTimerSeconds(&now);
+		
+		// FIXME: PortAudio stable sets timeInfo->currentTime == 0 --> Breakage!!!
+		// That's why we currently have our own PortAudio version.
+		
+		#if PSYCH_SYSTEM == PSYCH_LINUX
+		if (hA == paALSA) {
+			// ALSA on Linux can return timestamps in CLOCK_MONOTONIC time
+			// instead of our standard GetSecs() [gettimeofday] timesbase.
+			// It is up to the audio driver and its config, which one is returned.
+			//
+			// This effect was first noticed during testing on Ubuntu 10.04 LTS,
+			// so this will be part of all PTB releases after 8.5.2010.
+			//
+			// Therefore we need to check if CLOCK_MONOTONIC time is returned
+			// and remap such timestamps to our standard GetSecs timebase before
+			// further processing.
+
+			// Get current CLOCK_MONOTONIC time:
+			tMonotonic = PsychOSGetLinuxMonotonicTime();
+			
+			// Returned current time timestamp closer to tMonotonic than to GetSecs time?
+			if (fabs(timeInfo->currentTime - tMonotonic) < fabs(timeInfo->currentTime - now)) {
+				// Timestamps are in monotonic time! Need to remap.
+				// tMonotonic shall be the offset between GetSecs and monotonic time,
+				// i.e., the offset that needs to be added to monotonic timestamps to
+				// remap them to GetSecs time:
+				tMonotonic = now - tMonotonic;
 				
-				if (mode & kPortAudioCapture) {
-					// Capture mappings:
-					inputParameters.hostApiSpecificStreamInfo = (PaAsioStreamInfo*) &inhostapisettings;
-					inhostapisettings.size = sizeof(PaAsioStreamInfo);
-					inhostapisettings.hostApiType = paASIO;
-					inhostapisettings.version = 1;
-					inhostapisettings.flags = paAsioUseChannelSelectors;
-					inhostapisettings.channelSelectors = (int*) &inputmappings[0];
-					// Index into first row of one-row matrix or 2nd row of two-row matrix:
-					for (i=0; i<mynrchannels[1]; i++) inputmappings[i] = (int) mychannelmap[(i * m) + (m-1)];
-					if (verbosity > 3) {
-						printf("PTB-INFO: Will try to use the following logical channel -> device channel mappings for sound capture from audio stream %i :\n", audiodevicecount); 
-						for (i=0; i<mynrchannels[1]; i++) printf("%i --> %i : ", i+1, inputmappings[i]);
-						printf("\n\n");
-					}
-				}
-				// Mappings setup up. The PortAudio library will sanity check this further against device constraints...
+				// Correct all PortAudio timestamps by adding corrective offset:
+				((PaStreamCallbackTimeInfo*) timeInfo)->currentTime += tMonotonic;
+				((PaStreamCallbackTimeInfo*) timeInfo)->outputBufferDacTime += tMonotonic;
+				((PaStreamCallbackTimeInfo*) timeInfo)->inputBufferAdcTime += tMonotonic;
+			}
+		}
+		#endif
+		
+		if (hA==paCoreAudio || hA==paDirectSound || hA==paMME || hA==paALSA) {
+			// On these systems, DAC-time is already returned in the system timebase,
+			// at least with our modified version of PortAudio, so a simple
+			// query will return the onset time of the first sample. Well,
+			// looks as if we need to add the device inherent latency, because
+			// this describes everything up to the point where DMA transfer is
+			// initiated, but not device inherent latency. This additional latency
+			// is added via latencyBias, which is initialized in the Open-Function
+			// via a low-level driver query to CoreAudio:
+			if (dev->opmode & kPortAudioPlayBack) {
+				// Playback enabled: Use DAC time as basis for timing:
+				firstsampleonset = (double) timeInfo->outputBufferDacTime + dev->latencyBias;
 			}
 			else {
-				// Non ASIO device: No ASIO support --> No channel mapping support.
-				if (verbosity > 2) printf("PTB-WARNING: Provided 'selectchannels' channel mapping is ignored because this is not an ASIO enabled sound device.\n");
+				// Recording (only): Use ADC time as basis for timing:
+				firstsampleonset = (double) timeInfo->inputBufferAdcTime + dev->latencyBias;
+			}
+			
+			// Compute estimated capturetime in captureStartTime. This is only important in
+			// full-duplex mode, redundant in pure half-duplex capture mode:
+			captureStartTime = (double) timeInfo->inputBufferAdcTime;
+		}
+		else {
+			// ASIO or unknown. ASIO needs to be checked, which category is correct.
+			// Not yet verified how these other audio APIs behave. Play safe
+			// and perform timebase remapping: This also needs our special fixed
+			// PortAudio version where currentTime actually has a value:
+			if (dev->opmode & kPortAudioPlayBack) {
+				// Playback enabled: Use DAC time as basis for timing:
+				// Assign predicted (remapped to our time system) audio onset time for this buffer:
+				firstsampleonset = now + ((double) (timeInfo->outputBufferDacTime - timeInfo->currentTime)) + dev->latencyBias;
+			}
+			else {
+				// Recording (only): Use ADC time as basis for timing:
+				// Assign predicted (remapped to our time system) audio onset time for this buffer:
+				firstsampleonset = now + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime)) + dev->latencyBias;
 			}
+			
+			// Compute estimated capturetime in captureStartTime. This is only important in
+			// full-duplex mode, redundant in pure half-duplex capture mode:
+			captureStartTime = now + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime));
+		}
 		
-		#else
-			// Non MS-Windows system: No ASIO support --> No channel mapping support.
-			if (verbosity > 2) printf("PTB-WARNING: Provided 'selectchannels' channel mapping is ignored because this is not MS-Windows running on an ASIO enabled sound device.\n");
-		#endif
+		if (FALSE) {
+			// Debug code to compare our two timebases against each other: On OS/X,
+			// luckily both timebases are identical, ie. our UpTime() timebase used
+			// everywhere in PTB and the CoreAudio AudioHostClock() are identical.
+			psych_uint64 ticks;
+			double  tickssec;
+			PsychGetPrecisionTimerTicksPerSecond(&tickssec);
+			PsychGetPrecisionTimerTicks(&ticks);
+			printf("AudioHostClock: %lf   vs. System clock: %lf\n", ((double) (psych_int64) ticks) / tickssec, now); 
+		}
+		
+		// End of timestamp computation:
+		// If audio capture is active, then captureStartTime contains the running estimate of when the first input sample
+		// in inbuffer was hitting the audio input - This will be used in state 1 aka hotstandby when deciding to actually start "real" capture.
+		//
+		// now contains system time when entering this callback - Time in PTB timebase.
+		//
+		// Most importantly: firstsampleonset contains the estimated onset time (in PTB timebase) of the first sample that
+		// we will store in the outputbuffer during this callback invocation. This timestamp is used in multiple places below,
+		// e.g., in hotstandby mode (state == 1) to decide when to start actual playback by switching to state 2 and emitting
+		// samples to the outputbuffer. Also used if a specific reqEndTime is selected, ie., a sound offset at a scheduled
+		// offset time to compute when to stop. It's also used for checking for skipped buffers and other problems...		
+	}
+	else {
+		// We're a slave device: Just fetch precooked timestamps from our master:
+		firstsampleonset = audiodevices[dev->pamaster].firstsampleonset;
+		captureStartTime = audiodevices[dev->pamaster].cst;
+		now = audiodevices[dev->pamaster].now;
 	}
 	
-	// Copy in optional specialFlags:
-	PsychCopyInIntegerArg(9, kPsychArgOptional, &specialFlags);
-	
-	// Set channel count:
-	outputParameters.channelCount = mynrchannels[0];	// Number of output channels.
-	inputParameters.channelCount = mynrchannels[1];		// Number of input channels.
+	// Cache cooked timestamps:
+	dev->firstsampleonset = firstsampleonset;
+	dev->cst = captureStartTime;
+	dev->now = now;
 	
-	// Fix sample format to float for now...
+	// Acquire device lock: We'll likely hold it until exit from paCallback:
+	PsychPALockDeviceMutex(dev);
+
+	// Slaves are mixed with their regular per-channel volumes, unless parameter automation
+	// below applies them itself:
+	if (isSlave) dev->mixGains = dev->outChannelVolumes;
+	
+	// Cache requested state:
+	reqstate = dev->reqstate;
+
+	// Count total number of calls:
+	dev->paCalls++;
+	
+	// Call number of timestamp failures:
+	if (timeInfo->currentTime == 0) dev->noTime++;
+	
+	// Keep track of maximum number of frames requested:
+	if (dev->batchsize < (psych_int64) framesPerBuffer) dev->batchsize = (psych_int64) framesPerBuffer;
+	
+	// Keep track of buffer over-/underflows:
+	if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) dev->xruns++;
+
+	// Reset number of already committed sample frames for this buffer fill iteration to zero:
+	// This is a running count of how much of the current output buffer has been filled with
+	// sound content (ie., not simply zero silence padding frames):
+	committedFrames = 0;
+
+	// NULL-out pointer to buffer with sound data to play. It will get initialized later on
+	// in PsychPAProcessSchedule():
+	playoutbuffer = NULL;
+
+	// Query number of output channels:
+	outchannels = (psych_int64) dev->outchannels;
+
+	// Query number of output channels:
+	inchannels = (psych_int64) dev->inchannels;
+	
+	// Query number of repetitions:
+	repeatCount = dev->repeatCount;
+	
+	// Get our current playback position in samples (not frames or bytes!!):
+	playposition = dev->playposition;
+	recposition = dev->recposition;
+
+	// Compute size of soundbuffers in samples:
+	outsbsize = dev->outputbuffersize / sizeof(float);
+	insbsize = dev->inputbuffersize / sizeof(float);
+	
+	// Cache masterVolume locally for higher efficiency in integration loops:
+	masterVolume = dev->masterVolume;
+	
+	// Assign 1 as neutral value for AM modulator slaves, as 1 is the neutral
+	// element for gain-modulation (multiplication), as opposed to zero as neutral
+	// element for mixing and for outputting "silence":
+	neutralValue = (dev->opmode & kPortAudioIsAMModulator) ? 1.0 : 0;
+
+	// Requested logical playback state is "stopped" or "aborting" ? If so, abort.
+	if ((reqstate == 0) || (reqstate == 3)) {		
+		// Set estimated stop time to last committed sample time, unless it is already set from
+		// a previous callback invocation:
+		if (dev->estStopTime == 0) dev->estStopTime = dev->currentTime;
+
+		// Acknowledge request by resetting it:
+		dev->reqstate = 255;
+		
+		// Update "true" state to inactive:
+		dev->state = 0;
+
+		// Signal state change:
+		PsychPASignalChange(dev);
+
+		// Release mutex here, because dev->runMode never changes below us, and
+		// all other ops are on local variables:
+		PsychPAUnlockDeviceMutex(dev);
+		
+		// Prime the outputbuffer with silence, so playback is effectively stopped:
+		if (outputBuffer && !isSlave) memset(outputBuffer, 0, (size_t) framesPerBuffer * outchannels * sizeof(float));
+
+		if (dev->runMode == 0) {
+			// Runmode 0: We shall really stop the engine:
+			
+			// Either paComplete gracefully, playing out pending buffers, or
+			// request a hard paAbort if abortion is requested:
+			return((reqstate == 0) ? paComplete : paAbort);
+		}
+		else {
+			// Runmode 1: We just "idle", ie., set our state to "idle" and return with
+			// no further operations. Future invocations of the callback will also turn
+			// into no-ops due to the nominal idle state:
+			return(paContinue);
+		}
+	}
+
+	// Are we in a nominally "idle" / inactive state?
+	if (dev->state == 0) {
+		// We are effectively idle, but the engine shall keep running. This is usually
+		// the case in runMode > 0. Here we "simulate" idle state by simply outputting
+		// silence and then returning control to PortAudio:
+		
+		// Set estimated stop time to last committed sample time, unless it is already set from
+		// a previous callback invocation:
+		if (dev->estStopTime == 0) dev->estStopTime = dev->currentTime;
+		
+		// Release mutex here, as memset() only operates on "local" data:
+		PsychPAUnlockDeviceMutex(dev);
+		
+		// Prime the outputbuffer with silence to simulate a stopped audio device:
+		if (outputBuffer && !isSlave) memset(outputBuffer, 0, (size_t) framesPerBuffer * outchannels * sizeof(float));
+
+		// Done:
+		return(paContinue);
+	}
+
+	// This point is only reached in hot-standby or active playback/capture/feedback modes:
+
+	// Are we already playing back and/or capturing real audio data,
+	// or are we still on hot-standby? PsychPortAudio tries to start
+	// playback/capture of a sound exactly at a requested point in
+	// system time (i.e. the first sound sample should hit the speaker
+	// as closely as possible to that point in time) by use of the
+	// following trick: When the user script executes PsychPortAudio('Start'),
+	// our routine immediately starts processing of the portaudio stream,
+	// starting up the audio hardwares DACs/ADCs and Portaudios engine.
+	// After a short latency, our paCallback() (this routine) gets called
+	// by the realtime audio scheduler, requesting or providing audio sample
+	// data. In the provided timeInfo - variable, we are provided with the
+	// current playback time of the audio device (in seconds since stream start)
+	// and an estimate of when our first provided sample will hit the speakers.
+	// We convert these timestamps into system time, so we'll know how far the user
+	// provided onset deadline is away. If the deadline is far away, so the samples
+	// for this callback iteration would hit the speaker too early, we simply return
+	// a zero filled outputbuffer --> We output silence. If the deadline is somewhere
+	// in the middle of this outputbuffer, we fill the appropriate amount of bufferspace
+	// with zeros, then copy in our first real samples into the remaining buffer.
+	// After that, we switch to real playback, all future calls will provide PA
+	// with real sampledata. Assuming the sound onset estimate provided by PA is
+	// correct, this should allow accurate sound onset. It all depends on the
+	// latency estimate...
+	
+	// Hot standby?
+	if (dev->state == 1) {
+		// Hot standby: Compare running buffer timestamps 'now', 'firstsampleonset' and 'captureStartTime'
+		// to requested sound onset time and decide if and when to start playback and capture:
+		
+		// Store our measured/updated PortAudio + HostAPI + Driver + Hardware latency:
+		// We'll update the running estimate until transition from hot standby to active:
+		dev->predictedLatency = firstsampleonset - now;
+
+		// Ditto for capture starttime:
+		if (dev->opmode & kPortAudioCapture) {
+			// Store estimated capturetime in captureStartTime. This is only important in
+			// full-duplex mode, redundant in pure half-duplex capture mode.
+			// If we're not a regular input capture device, but a output capture device,
+			// then our effective captureStartTime is the *playback* starttime, as we're
+			// capturing what is fed to the outputs/speakers, not what comes from the inputs!
+			dev->captureStartTime = (dev->opmode & kPortAudioIsOutputCapture) ? firstsampleonset : captureStartTime;
+		}
+		
+		// Compute difference between requested onset time and presentation time
+		// of the first sample of this callbacks returned buffer:
+		onsetDelta = dev->reqStartTime - firstsampleonset;
+		
+		// Time left until onset and in playback mode?
+		if ((onsetDelta > 0) && (dev->opmode & kPortAudioPlayBack)) {
+			// Some time left: A full buffer duration?
+			if (onsetDelta >= ((double) framesPerBuffer / (double) dev->streaminfo->sampleRate)) {
+				// At least one buffer away...
+				
+				// Release mutex, as remainder only operates on locals:
+				PsychPAUnlockDeviceMutex(dev);
+				
+				// At least one buffer away. Fill our buffer with zeros, aka silence:
+				if (!isSlave) memset(outputBuffer, 0, (size_t) framesPerBuffer * outchannels * sizeof(float));
+				
+				// Ready. Tell engine to continue stream processing, i.e., call us again...
+				return(paContinue);
+			}
+			else {
+				// A bit time left, but less than a full buffer. Need to pad the head of
+				// this buffer with zeros, aka silence, then fill the rest with real data:
+				silenceframes = (psych_int64) (onsetDelta * ((double) dev->streaminfo->sampleRate));
+
+				// Fill in some silence:
+				if (neutralValue == 0) {
+					// Fast-path: Zerofill for silence...
+					memset(outputBuffer, 0, (size_t) silenceframes * outchannels * sizeof(float));
+					out+= (silenceframes * outchannels);
+				}
+				else {
+					// Slow-path: Usually a 1.0 fill for AM modulator mode:
+					for (i = 0; i < silenceframes * outchannels; i++) *(out++) = neutralValue;
+				}
+
+				// Decrement remaining real audio data count:
+				framesPerBuffer-= (unsigned long) silenceframes;
+
+				// Advance silenceframes into the buffer:
+				committedFrames+=silenceframes;
+
+				// dev->startTime now exactly corresponds to onset of first non-silence sample at dev->reqStartTime.
+				// At least if everything works properly.
+				dev->startTime = dev->reqStartTime;
+				
+				// Mark us as running:
+				dev->state = 2;
+				
+				// Signal state change:
+				PsychPASignalChange(dev);				
+			}
+		}
+		else {
+			// Ooops! We are late! Store real estimated onset in the startTime field and
+			// then hurry up! If we are in "capture only" mode, we disregard the 'when'
+			// deadline and always start immediately.
+			dev->startTime = firstsampleonset;
+
+			// Mark us as running:
+			dev->state = 2;
+			
+			// Signal state change:
+			PsychPASignalChange(dev);			
+		}
+	}
+
+	// Master device implementation. Dispatch into all attached slave device callbacks,
+	// distribute captured data to the slaves, collect and merge or mix output data from
+	// the slaves:
+	if (isMaster) {
+		// No slaves executed yet in this callback:
+		dev->slavesProcessed = 0;
+
+		// Scratch buffers for slave callbacks already allocated?
+		if ((dev->opmode & kPortAudioCapture) && (dev->slaveInBuffer == NULL)) {
+			// Allocate input distribution buffer:
+			dev->slaveInBuffer = (float*) malloc(sizeof(float) * dev->batchsize * inchannels);
+			if (NULL == dev->slaveInBuffer) {
+				// Out of memory! Perform an emergency abort:
+				dev->reqstate = 255;
+				dev->state = 0;				
+				PsychPASignalChange(dev);
+				PsychPAUnlockDeviceMutex(dev);			
+				return(paAbort);
+			}
+		}
+
+		if ((dev->opmode & kPortAudioPlayBack) && (dev->slaveOutBuffer == NULL)) {
+			// Allocate output receive buffer and output gain receive buffer:
+			dev->slaveOutBuffer = (float*) malloc(sizeof(float) * dev->batchsize * outchannels);
+			dev->slaveGainBuffer = (float*) malloc(sizeof(float) * dev->batchsize * outchannels);
+			if ((NULL == dev->slaveOutBuffer) || (NULL == dev->slaveGainBuffer)) {
+				// Out of memory! Perform an emergency abort:
+				dev->reqstate = 255;
+				dev->state = 0;				
+				PsychPASignalChange(dev);
+				PsychPAUnlockDeviceMutex(dev);			
+				return(paAbort);
+			}
+		}
+
+		// Have scratch buffers ready. Clear output intermix buffer:
+		memset(outputBuffer, 0, dev->batchsize * outchannels * sizeof(float));
+
+		// Render slaves in parallel on our worker threads? Otherwise, or if this isn't possible for this
+		// callback, render them serially:
+		numSlavesHandled = -1;
+		if (dev->workerThreads && !dev->workerFallback) {
+			numSlavesHandled = PsychPARenderSlavesParallel(dev, in, (float*) outputBuffer, committedFrames, timeInfo, statusFlags);
+		}
+
+		if (numSlavesHandled < 0) {
+			// Iterate over all slave device callbacks: Or at least until all registered slaves are handled.
+			numSlavesHandled = 0;
+			for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount); i++) {
+				// Valid slave slot?
+				slaveId = dev->slaves[i];
+
+				// We skip invalid slots and output capturer slaves:
+				if ((slaveId > -1) && !(audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) {
+					// Valid slave:
+
+					// Is this device an AM modulator attached to a slave?
+					if (audiodevices[slaveId].opmode & kPortAudioIsAMModulatorForSlave) {
+						// Yes. Mark it as handled, then skip it. It will be called as part
+						// of processing of its parent slave:
+						numSlavesHandled++;
+						continue;
+					}
+
+					// This is a "real" audio slave, not a modulator or such. Execute it
+					// and its modulator, then mix its output into ours:
+					PsychPARenderSlave(dev, slaveId, in, dev->slaveInBuffer, dev->slaveOutBuffer, dev->slaveGainBuffer, timeInfo, statusFlags);
+					PsychPAMixSlaveOutput(dev, slaveId, (float*) outputBuffer, dev->slaveOutBuffer, committedFrames);
+
+					// One more slave handled:
+					numSlavesHandled++;
+				}
+			}	// Next slave...
+		}
+
+		// Done merging sound data from slaves. Mastercode can now process special output capture slaves
+		// and other special post-mix slaves:
+		for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount); i++) {
+			// Valid slave slot?
+			slaveId = dev->slaves[i];
+			
+			// We skip invalid slots and anything except output capturer slaves:
+			if ((slaveId > -1) && (audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) {
+				// Valid slave: Skip its processing if its state is zero == completely inactive.
+				if (audiodevices[slaveId].state > 0) {
+					// Reset dirty flag for this slave: Not strictly needed for output capture slaves...
+					audiodevices[slaveId].slaveDirty = 0;
+					dev->slavesProcessed++;
+					
+					// Output capture enabled on slave? If so, we need to distribute our output audio data to it:
+					if ((audiodevices[slaveId].opmode & kPortAudioCapture) && (audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) {
+						// Our target buffer is the slaveOutBuffer here, because it is guaranteed to exist and
+						// have sufficient capacity:
+						tmpBuffer = dev->slaveOutBuffer;
+						
+						// Our input is the mixBuffer from previous mixes:
+						mixBuffer = (float*) outputBuffer;
+						
+						// For each sampleFrame in the mixBuffer:
+						for (j = 0; j < dev->batchsize; j++) {
+							// Iterate over all target channels in the slave devices inputbuffer:
+							for (k = 0; k < audiodevices[slaveId].inchannels; k++) {
+								// And fetch from corrsponding mixBuffer channel of our device, applying the same
+								// masterVolume setting that the master output device will apply later:
+								*(tmpBuffer++) = masterVolume * mixBuffer[(j * outchannels) + audiodevices[slaveId].inputmappings[k]];
+							}
+						}
+					}
+					
+					// Temporary input buffer is filled for slave callback: dev->slaveOutBuffer acts as the input
+					// buffer for the callback, as it contains the properly formatted data from our mixBuffer. It
+					// also acts as output buffer from the slave, so that slaves with playback enabled are happy.
+					// However, this is a pure dummy-sink, the data written by the slave isn't used for anything,
+					// but simply discarded, as output capture slaves have no meaningful sink for their output.
+					paCallback( (const void*) dev->slaveOutBuffer, (void*) dev->slaveOutBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[slaveId]));
+				}
+				
+				// One more slave handled:
+				numSlavesHandled++;
+			}
+		}	// Next outputcapture-slave...
+		// Done processing slaves. Mastercode can now continue just as slave or regular device code would do.
+	}
+
+	// This code only executes on non-masters in live monitoring mode - a mode where all
+	// sound data is fed back immediately with shortest possible latency
+	// from input to output, without any involvement of Matlab/Octave code:
+	if (!isMaster && (dev->opmode & kPortAudioMonitoring)) {
+		// Copy input buffer to output buffer:
+		memcpy(out, &(in[committedFrames * inchannels]), framesPerBuffer * outchannels * sizeof(float));
+
+		// Store updated positions in device structure:
+		dev->playposition = playposition + (framesPerBuffer * outchannels);
+		dev->recposition = dev->playposition;
+
+		// Compute output time of last fed back sample from this iteration:
+		committedFrames += framesPerBuffer;
+		dev->currentTime = firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate);
+
+		// Mark our output buffer as dirty:
+		dev->slaveDirty = 1;
+
+		// Return from callback:
+		PsychPAUnlockDeviceMutex(dev);
+		return(paContinue);
+	}
+	
+	// This code retrieves and stores captured sound data on non-master devices, if any:
+	if (!isMaster && (dev->opmode & kPortAudioCapture)) {
+		// Check if required input buffer is there.
+		if (dev->inputbuffer == NULL) {
+			// Ouch! Perform emergency shutdown:
+			dev->reqstate = 255;
+			dev->state = 0;
+
+			PsychPASignalChange(dev);
+			PsychPAUnlockDeviceMutex(dev);			
+
+			return(paAbort);
+		}
+		
+		// This is the simple case (compared to playback processing).
+		// Just copy all available data to our internal buffer:
+		for (i=0; (i < dev->batchsize * inchannels); i++) {
+			dev->inputbuffer[recposition % insbsize] = (float) *in++;
+			recposition++;
+		}
+		
+		// Store updated recording position in device structure:
+		dev->recposition = recposition;
+	}
+	
+	// This code emits actual sound data to the engine:
+	if (dev->opmode & kPortAudioPlayBack) {
+		// Set stopEngine request to false, ie. continue...
+		stopEngine = FALSE;
+		parc = 0;
+		
+		// Mark our output buffer as dirty:
+		dev->slaveDirty = 1;
+		
+		// Last chance to honor a potential playback abort request. Check once more...
+		reqstate = dev->reqstate;
+
+		// Compute time delta between requested sound stop time (sound offset time) and
+		// time of next sample in to-be-filled buffer, taking potential committedFrames for
+		// zero padding at head of buffer into account:
+		offsetDelta = dev->reqStopTime - (firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate));
+
+		// Clamp to at most 10 seconds ahead, because that is more than enough even
+		// for the largest conceivable hostbuffersizes, and it prevents numeric overflow
+		// in the math below when converting to psych_int64 ints:
+		offsetDelta = (offsetDelta > 10.0) ? 10.0 : offsetDelta;
+
+		// Convert remaining time until requested stop time into sample frames until stop:
+		offsetDelta = offsetDelta * (double)(dev->streaminfo->sampleRate);
+
+		// Convert into samples: max_i is the maximum allowable value for 'i'
+		// in order to satisfy the dev->reqStopTime:
+		max_i  = (psych_int64) (offsetDelta * (double) outchannels);
+		max_i -= max_i % outchannels;
+		
+		// Count of outputted frames in this part of the code:
+		i=0;
+
+		// Stoptime already reached or abort request from master thread received? If so, stop the engine:
+		if (reqstate == 0 || reqstate == 3 || (offsetDelta <= 0) ) stopEngine = TRUE;
+
+		// Parameter automation active? Then masterVolume and automated per-channel volumes of slaves are
+		// applied as sample-accurate ramps by PsychPAApplyAutomation() after the output is computed:
+		if (dev->automation) {
+			if (dev->automation[0].readpos != dev->automation[0].writepos) masterVolume = 1.0;
+
+			if (isSlave && dev->automationMixGains) {
+				for (k = 0; k < outchannels; k++) {
+					dev->automationMixGains[k] = (dev->automation[k + 1].readpos != dev->automation[k + 1].writepos) ? 1.0 : dev->outChannelVolumes[k];
+				}
+				dev->mixGains = dev->automationMixGains;
+			}
+		}
+
+		// Lock-free ring buffer playback instead of buffers and schedules?
+		if (dev->ringBuffer && !isMaster && !stopEngine) {
+			// Consume as many samples as the producer has pushed, up to the end of this host buffer or
+			// the requested stop time. We don't lock against the producer: It only advances ringWritePos
+			// after it has written the samples, we only advance ringReadPos after we have read them:
+			ringLimit = ((psych_int64) framesPerBuffer * outchannels < max_i) ? (psych_int64) framesPerBuffer * outchannels : max_i;
+			ringMask = dev->ringCapacity - 1;
+			ringReadPos = dev->ringReadPos;
+			ringAvail = (psych_int64) (unsigned int) (dev->ringWritePos - ringReadPos);
+			PsychPAMemoryBarrier();
+
+			if (!isSlave) {
+				for (; (i < ringLimit) && (i < ringAvail); i++) *(out++) = dev->ringBuffer[(ringReadPos++) & ringMask] * masterVolume;
+			}
+			else {
+				// Slave: Multiply to apply possible gain values from an AM modulator that is attached to us:
+				for (; (i < ringLimit) && (i < ringAvail); i++) *(out++) *= dev->ringBuffer[(ringReadPos++) & ringMask] * masterVolume;
+			}
+
+			PsychPAMemoryBarrier();
+			dev->ringReadPos = ringReadPos;
+			playposition += i;
+
+			// Ring buffer ran dry before we could fill the buffer? Count underrun and fill remainder with silence:
+			if (i < ringLimit) {
+				dev->ringUnderruns++;
+				dev->ringUnderrunFrames += (ringLimit - i) / outchannels;
+				for (; i < ringLimit; i++) *(out++) = neutralValue;
+			}
+
+			// Store updated playposition in device structure:
+			dev->playposition = playposition;
+
+			// Stop time reached?
+			if (i >= max_i) stopEngine = TRUE;
+		}
+
+		// Repeat until stopEngine condition, or this callbacks host output buffer is full,
+		// or max_i timeout reached for end of processing, or no more valid slots available
+		// in current schedule. Assign all relevant parameters from schedule:
+		while (!stopEngine && !(dev->ringBuffer && !isMaster) && (i < framesPerBuffer * outchannels) && (i < max_i) &&
+			   ((parc = PsychPAProcessSchedule(dev, &playposition, &playoutbuffer, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) == 0)) {
+			// Process this slot:
+
+			if (!isMaster && dev->resampler && dev->playoutResampler) {
+				// Buffer has a different sample rate than the device: Convert it on the fly. Stop times and
+				// the end of the host buffer limit the number of output samples, the loop and repetition
+				// constraints of the slot limit the consumed buffer samples:
+				resampled = PsychPAResampleSlot(dev, out, (((psych_int64) framesPerBuffer * outchannels < max_i) ? (psych_int64) framesPerBuffer * outchannels : max_i) - i,
+												isSlave, masterVolume, playoutbuffer, outsbsize, outsboffset, repeatCount, playpositionlimit, &playposition);
+				out += resampled;
+				i += resampled;
+			}
+			else if (!isMaster && !isSlave) {
+				// Non-master, non-slave device: This is a regular sound device.
+				// Copy requested number of samples for each channel into the output buffer: Take the case of
+				// "loop forever" and "loop repeatCount" times into account, as well as stop times:
+				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
+					*(out++) = playoutbuffer[outsboffset + ( playposition % outsbsize )] * masterVolume;
+					playposition++;
+				}
+			}
+			else if (!isMaster) {
+				// Non-master device: This is a slave.
+				// Copy requested number of samples for each channel into the output buffer: Take the case of
+				// "loop forever" and "loop repeatCount" times into account, as well as stop times:
+				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
+					// We multiply in order to apply possible per-channel, per-sample gain values as
+					// defined by the master - i.e., by an AM modulator that is attached to us:
+					*(out++) *= playoutbuffer[outsboffset + ( playposition % outsbsize )] * masterVolume;
+					playposition++;
+				}
+			}
+			else {
+				// Master device: We don't output our own audio data. Just apply the masterVolume
+				// gain setting common to all output channels of the device:
+				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
+					*(out++) *= masterVolume;
+					playposition++;
+				}		
+			}
+
+			// Store updated playposition in device structure:
+			dev->playposition = playposition;
+
+			// Abort condition?
+			if ((i >= max_i) || ((parc = PsychPAProcessSchedule(dev, &playposition, &playoutbuffer, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) > 0)) stopEngine = TRUE;
+		}
+
+		// Store updated playposition in device structure:
+		dev->playposition = playposition;
+
+		// Apply parameter automation to the i samples we've just output, starting at frame committedFrames:
+		if (dev->automation && (i > 0)) PsychPAApplyAutomation(dev, out - i, i / outchannels, firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate));
+
+		// Update total count of emitted valid non-silence sample frames:
+		committedFrames += i / outchannels;
+
+		// Compute output time of last outputted sample from this iteration:
+		dev->currentTime = firstsampleonset + ((double) committedFrames / (double) dev->streaminfo->sampleRate);
+
+		// Update total count of emitted samples since start of playback:
+		dev->totalplaycount+= committedFrames * outchannels;
+		
+		// Another end-of-playback check:
+		if (parc > 0) {
+			stopEngine = TRUE;
+		}
+		
+		// End of playback reached due to maximum number of possible output samples reached or abortcondition satisfied?
+		if ((i < framesPerBuffer * outchannels) || stopEngine) {
+			// Premature stop of buffer filling because abortcondition satisfied: Need to go idle or stop the whole engine:
+			
+			// We need to zero-fill the remainder of the buffer and tell the engine
+			// to finish playback:
+			while(i < framesPerBuffer * outchannels) {
+				*out++ = neutralValue;
+				i++;
+			}
+			
+			// Signal that engine is stopped/will stop very soonish:
+			// Unless parc == 4 request a rescheduled restart, ie., switching to hot-standby
+			// instead of idle:
+			dev->state = (parc == 4) ? 1 : 0;
+			dev->reqstate = 255;
+
+			// Set estimated stop time to last committed sample time:
+			if ((dev->estStopTime == 0) && (dev->state == 0)) dev->estStopTime = dev->currentTime;
+			
+			// Signal state change:
+			PsychPASignalChange(dev);
+
+			// Safe to unlock, as dev->runMode never changes below us:
+			PsychPAUnlockDeviceMutex(dev);
+
+			if ((dev->runMode == 0) && (dev->state == 0)) {
+				// Either paComplete gracefully, playing out pending buffers, or
+				// request a hard paAbort if abortion is requested:
+				return((reqstate == 3) ? paAbort : paComplete);
+			}
+			else {
+				// Runmode 1 or greater: Have set our state to "idle" already. Just
+				// continue:
+				return(paContinue);
+			}
+		}
+	}
+		
+	// Tell engine to continue stream processing, i.e., call us again...
+	PsychPAUnlockDeviceMutex(dev);
+    return(paContinue);
+}
+
+// Reset the statistics of callback timing telemetry 'stats'. Called by paCallback on request, or by 'GetTimingStats' if no callbacks are running:
+static void PsychPAResetTimingStats(PsychPATimingStats* stats)
+{
+	memset(stats->histogram, 0, sizeof(stats->histogram));
+	stats->totalDuration = 0;
+	stats->maxDuration = 0;
+	stats->firstpos = stats->writepos;
+	stats->firstxrun = stats->xrunpos;
+	stats->resetRequest = 0;
+}
+
+// Record telemetry of one invocation of paCallback for device 'dev', which started at system time 'tStart' and took 'duration' secs:
+static void PsychPARecordTiming(PsychPADevice* dev, double tStart, double duration, unsigned long framesPerBuffer, PaStreamCallbackFlags statusFlags)
+{
+	PsychPATimingStats* stats = dev->timing;
+	PsychPATimingRecord* rec;
+	PsychPAXRunRecord* xrun;
+	unsigned int pos, usecs, bin;
+
+	if (stats->resetRequest) PsychPAResetTimingStats(stats);
+	pos = stats->writepos;
+
+	rec = &(stats->records[pos & (PSYCH_PA_TIMING_RECORDS - 1)]);
+	rec->tStart = tStart;
+	rec->duration = (float) duration;
+	rec->predictedLatency = (float) dev->predictedLatency;
+	rec->frames = (unsigned int) framesPerBuffer;
+	rec->slaves = (unsigned short) dev->slavesProcessed;
+	rec->flags = (unsigned short) statusFlags;
+
+	// Keep context of over-/underflows:
+	if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) {
+		xrun = &(stats->xruns[stats->xrunpos % PSYCH_PA_TIMING_XRUNS]);
+		xrun->xrun = *rec;
+		if (pos != stats->firstpos) xrun->previous = stats->records[(pos - 1) & (PSYCH_PA_TIMING_RECORDS - 1)];
+		else memset(&(xrun->previous), 0, sizeof(xrun->previous));
+		PsychPAMemoryBarrier();
+		stats->xrunpos++;
+	}
+
+	// Bin 0 counts durations below 2 usecs, bin k durations from 2^k to 2^(k+1) usecs:
+	usecs = (unsigned int) (duration * 1e6);
+	for (bin = 0; (usecs > 1) && (bin < PSYCH_PA_TIMING_BINS - 1); bin++) usecs >>= 1;
+	stats->histogram[bin]++;
+	stats->totalDuration += duration;
+	if (rec->duration > stats->maxDuration) stats->maxDuration = rec->duration;
+
+	// Publish record:
+	PsychPAMemoryBarrier();
+	stats->writepos = pos + 1;
+}
+
+/* paCallback: Entry point of PortAudio into paProcessCallback(), recording callback timing telemetry if enabled. */
+static int paCallback( const void *inputBuffer, void *outputBuffer,
+                             unsigned long framesPerBuffer,
+                             const PaStreamCallbackTimeInfo* timeInfo,
+                             PaStreamCallbackFlags statusFlags,
+                             void *userData )
+{
+	PsychPADevice* dev = (PsychPADevice*) userData;
+	double tStart, tEnd;
+	int rc;
+
+	if ((dev == NULL) || !dev->timingEnabled) return(paProcessCallback(inputBuffer, outputBuffer, framesPerBuffer, timeInfo, statusFlags, userData));
+
+	PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+	rc = paProcessCallback(inputBuffer, outputBuffer, framesPerBuffer, timeInfo, statusFlags, userData);
+	PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+
+	PsychPARecordTiming(dev, tStart, tEnd - tStart, framesPerBuffer, statusFlags);
+
+	return(rc);
+}
+
+void PsychPACloseStream(int id)
+{
+	int pamaster, i;
+	PaStream* stream = audiodevices[id].stream;
+	
+	// Valid and active device?
+	if (stream) {
+		// Need different destruction procedures for normals vs. masters vs. slaves:
+		if (audiodevices[id].opmode & kPortAudioIsSlave) {
+			// Virtual slave device.
+			pamaster = audiodevices[id].pamaster;
+			
+			// First we need to get the lock of the masterdevice to prevent it
+			// from operating on its list of slaves or from calling the to-be-deleted
+			// slave:
+			PsychPALockDeviceMutex(&(audiodevices[pamaster]));
+			
+			// At this point we have the mutex and neither the master nor our slave are operating.
+			// We also know that nobody is waiting on any finalization or state-change signals from
+			// the slave device, because the only thread that could wait on such events is the
+			// main interpreter-thread on which we are executing at this moment -- obviously we're
+			// not blocked. The slave is not really operating on hardware that needs to be shut down
+			// and the slave is not operating on its own thread, so no thread cleanup to do either.
+			//
+			// Simply put, we can simply detach ourselves from the master, then skip destruction steps
+			// for real audio devices and continue with release operations for our data structures,
+			// buffers and sync primitives.
+			
+			// Find our slot in the master:
+			for (i=0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (audiodevices[pamaster].slaves[i] != id); i++);
+
+			// Detach us from master queue:
+			audiodevices[pamaster].slaves[i] = -1;
+			audiodevices[pamaster].slaveCount--;
+
+			// Detach master from us:
+			audiodevices[id].pamaster = -1;
+
+			// If we're an AM modulator for another slave, we need to detach
+			// from that slave:
+			if (audiodevices[id].opmode & kPortAudioIsAMModulatorForSlave) {
+				for (i = 0; i < MAX_PSYCH_AUDIO_DEVS; i++) if (audiodevices[i].modulatorSlave == id) { audiodevices[i].modulatorSlave = -1; }
+			}
+
+			// Detached :-) -- Master can continue with whatever...
+			PsychPAUnlockDeviceMutex(&audiodevices[pamaster]);
+			
+			// Continue with data structure destruction etc.
+		}
+		else {
+			// Regular or master audio device: Real hardware with real need for
+			// Portaudio shutdown.
+			
+			// Stop, shutdown and release audio stream:
+			Pa_StopStream(stream);
+			
+			// Unregister the stream finished callback:
+			Pa_SetStreamFinishedCallback(stream, NULL);
+
+			// Stream is stopped, so our slave worker threads are idle. Shut them down:
+			PsychPAStopSlaveWorkers(&(audiodevices[id]));
+			
+			// Our device thread, callbacks and hardware are stopped, all mutexes are unlocked,
+			// all our potential slaves are inactive as well. We can safely destroy our slaves,
+			// if any, ie., if we are a master:
+			if ((audiodevices[id].slaveCount > 0) && (audiodevices[id].slaves)) {
+				// Iterate over our slaves and close them:
+				for (i=0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) {
+					if (audiodevices[id].slaves[i] > -1) PsychPACloseStream(audiodevices[id].slaves[i]);
+				}
+				
+				// Sanity-check:
+				if (audiodevices[id].slaveCount > 0) printf("PsychPortAudio: CRITICAL! To be deleted master device %i has non-zero slaveCount %i after destroying slaves! BUG!!\n", id, audiodevices[id].slaveCount);
+
+				// No slaves anymore. Done with master specific destruction.
+			}
+			
+			// Destruction for both master- and regular audio devices:
+			
+			// Close and destroy the hardware portaudio stream:
+			Pa_CloseStream(stream);
+		}
+		
+		// Common destruct path for all types of devices:
+		
+		// Release stream reference to now dead stream:
+		audiodevices[id].stream = NULL;
+		
+		// Free associated sound outputbuffer:
+		if(audiodevices[id].outputbuffer) {
+			free(audiodevices[id].outputbuffer);
+			audiodevices[id].outputbuffer = NULL;
+			audiodevices[id].outputbuffersize = 0;
+		}				
+
+		// Stop streaming of captured sound to a file, after writing out all pending data:
+		if (audiodevices[id].captureWriter && (i = PsychPAStopCaptureWriter(&(audiodevices[id]))) && (verbosity > 0)) {
+			printf("PsychPortAudio-ERROR: Writing captured sound data of device %i to file failed [%s]. The file is incomplete.\n", id, strerror(i));
+		}
+
+		// Free associated sound inputbuffer:
+		if(audiodevices[id].inputbuffer) {
+			free(audiodevices[id].inputbuffer);
+			audiodevices[id].inputbuffer = NULL;
+			audiodevices[id].inputbuffersize = 0;
+		}
+
+		// Free associated playback ring buffer, if any:
+		if(audiodevices[id].ringBuffer) {
+			free(audiodevices[id].ringBuffer);
+			audiodevices[id].ringBuffer = NULL;
+			audiodevices[id].ringCapacity = 0;
+		}
+
+		// Free associated schedule, if any:
+		if(audiodevices[id].schedule) {
+			PsychPAUnreferenceScheduleBuffers(&audiodevices[id]);
+			free(audiodevices[id].schedule);
+			audiodevices[id].schedule = NULL;
+			audiodevices[id].schedule_size = 0;
+		}				
+
+		// Free associated sound intermixbuffers:
+		if(audiodevices[id].slaveOutBuffer) {
+			free(audiodevices[id].slaveOutBuffer);
+			audiodevices[id].slaveOutBuffer = NULL;
+		}				
+
+		if(audiodevices[id].slaveGainBuffer) {
+			free(audiodevices[id].slaveGainBuffer);
+			audiodevices[id].slaveGainBuffer = NULL;
+		}				
+
+		if(audiodevices[id].slaveInBuffer) {
+			free(audiodevices[id].slaveInBuffer);
+			audiodevices[id].slaveInBuffer = NULL;
+		}				
+
+		// Free slave array:
+		if(audiodevices[id].slaves) {
+			free(audiodevices[id].slaves);
+			audiodevices[id].slaves = NULL;
+		}				
+		
+		// Free in-/outputmapping:
+		if(audiodevices[id].inputmappings) {
+			free(audiodevices[id].inputmappings);
+			audiodevices[id].inputmappings = NULL;
+		}				
+
+		if(audiodevices[id].outputmappings) {
+			free(audiodevices[id].outputmappings);
+			audiodevices[id].outputmappings = NULL;
+		}				
+
+		// Free callback timing telemetry:
+		audiodevices[id].timingEnabled = 0;
+		free(audiodevices[id].timing);
+		audiodevices[id].timing = NULL;
+
+		// Free resampler scratch memory. Filter banks are shared and freed at shutdown:
+		free(audiodevices[id].resampleScratch);
+		audiodevices[id].resampleScratch = NULL;
+		audiodevices[id].resampler = NULL;
+		audiodevices[id].outputbufferResampler = NULL;
+		audiodevices[id].playoutResampler = NULL;
+
+		// Free parameter automation tracks, if any:
+		PsychPADeleteAutomation(&(audiodevices[id]));
+		audiodevices[id].mixGains = NULL;
+
+		// Free vector of outChannelVolumes:
+		if(audiodevices[id].outChannelVolumes) {
+			free(audiodevices[id].outChannelVolumes);
+			audiodevices[id].outChannelVolumes = NULL;
+		}				
+
+		// If we use locking, we need to destroy the per-device mutex:
+		if (uselocking && PsychDestroyMutex(&(audiodevices[id].mutex))) printf("PsychPortAudio: CRITICAL! Failed to release Mutex object for pahandle %i! Prepare for trouble!\n", id);
+
+		// If we use locking, this will destroy the associated event variable:
+		PsychPADestroySignal(&(audiodevices[id]));
+
+		// One device less:
+		audiodevicecount--;
+	}
+	
+	return;
+}
+
+void InitializeSynopsis(void)
+{
+	int i=0;
+	const char **synopsis = synopsisSYNOPSIS;  //abbreviate the long name
+	
+	synopsis[i++] = "PsychPortAudio - A sound driver built around the PortAudio sound library:\n";
+	synopsis[i++] = "\nGeneral information:\n";
+	synopsis[i++] = "version = PsychPortAudio('Version');";
+	synopsis[i++] = "oldlevel = PsychPortAudio('Verbosity' [,level]);";
+	synopsis[i++] = "count = PsychPortAudio('GetOpenDeviceCount');";
+	synopsis[i++] = "devices = PsychPortAudio('GetDevices' [,devicetype] [, deviceIndex]);";
+	synopsis[i++] = "\nGeneral settings:\n";
+	synopsis[i++] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend, mixerSIMD, slaveWorkerThreads] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend] [, mixerSIMD] [, slaveWorkerThreads]);";
+	synopsis[i++] = "oldRunMode = PsychPortAudio('RunMode', pahandle [,runMode]);";
+	synopsis[i++] = "\n\nDevice setup and shutdown:\n";
+	synopsis[i++] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
+	synopsis[i++] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels]);";
+	synopsis[i++] = "PsychPortAudio('Close' [, pahandle]);";
+	synopsis[i++] = "oldOpMode = PsychPortAudio('SetOpMode', pahandle [, opModeOverride]);";
+	synopsis[i++] = "oldbias = PsychPortAudio('LatencyBias', pahandle [,biasSecs]);";
+	synopsis[i++] =	"[oldMasterVolume, oldChannelVolumes] = PsychPortAudio('Volume', pahandle [, masterVolume][, channelVolumes]);";
+	synopsis[i++] = "enable = PsychPortAudio('DirectInputMonitoring', pahandle, enable [, inputChannel = -1][, outputChannel = 0][, gainLevel = 0.0][, stereoPan = 0.5]);";
+	synopsis[i++] = "[underflow, nextSampleStartIndex, nextSampleETASecs] = PsychPortAudio('FillBuffer', pahandle, bufferdata [, streamingrefill=0][, startIndex=Append]);";
+	synopsis[i++] =	"bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata [, sampleRate]);";
+	synopsis[i++] =	"PsychPortAudio('DeleteBuffer'[, bufferhandle] [, waitmode]);";
+	synopsis[i++] =	"PsychPortAudio('RefillBuffer', pahandle [, bufferhandle=0], bufferdata [, startIndex=0]);";
+	synopsis[i++] = "PsychPortAudio('SetLoop', pahandle[, startSample=0][, endSample=max][, UnitIsSeconds=0]);";
+	synopsis[i++] = "startTime = PsychPortAudio('Start', pahandle [, repetitions=1] [, when=0] [, waitForStart=0] [, stopTime=inf] [, resume=0]);";
+	synopsis[i++] = "startTime = PsychPortAudio('RescheduleStart', pahandle, when [, waitForStart=0] [, repetitions] [, stopTime]);";
+	synopsis[i++] = "status = PsychPortAudio('GetStatus' pahandle);";
+	synopsis[i++] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, singleType=0][, targetBuffer=0]);";
+	synopsis[i++] = "[startTime endPositionSecs xruns estStopTime] = PsychPortAudio('Stop', pahandle [,waitForEndOfPlayback=0] [, blockUntilStopped=1] [, repetitions] [, stopTime]);";
+	synopsis[i++] =	"PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
+	synopsis[i++] =	"[success, freeslots] = PsychPortAudio('AddToSchedule', pahandle [, bufferHandle=0][, repetitions=1][, startSample=0][, endSample=max][, UnitIsSeconds=0][, specialFlags=0]);";
+	synopsis[i++] =	"PsychPortAudio('UseRingBuffer', pahandle, enableRing [, capacityFrames]);";
+	synopsis[i++] =	"[framesPushed, framesQueued, underruns] = PsychPortAudio('PushAudio', pahandle, bufferdata [, waitForSpace=1]);";
+	synopsis[i++] =	"PsychPortAudio('UseAutomation', pahandle, enableAutomation [, maxSize = 128]);";
+	synopsis[i++] =	"[success, freeslots] = PsychPortAudio('AddToAutomation', pahandle, target, when, value [, shape=0][, timeUnit=0]);";
+	synopsis[i++] =	"PsychPortAudio('UseResampler', pahandle, quality [, sampleRate]);";
+	synopsis[i++] =	"[stats, records] = PsychPortAudio('GetTimingStats', pahandle [, enable][, reset=0]);";
+	synopsis[i++] =	"[framesWritten, overflows, lostFrames] = PsychPortAudio('CaptureToFile', pahandle [, filename][, format=0][, chunkSecs=0.5]);";
+
+	synopsis[i++] = NULL;  //this tells PsychDisplayScreenSynopsis where to stop
+	if (i > MAX_SYNOPSIS_STRINGS) {
+		PrintfExit("%s: increase dimension of synopsis[] from %ld to at least %ld and recompile.",__FILE__,(long)MAX_SYNOPSIS_STRINGS,(long)i);
+	}
+}
+
+PaHostApiIndex PsychPAGetLowestLatencyHostAPI(void)
+{
+	PaHostApiIndex ai;
+	
+	#if PSYCH_SYSTEM == PSYCH_OSX
+		// CoreAudio or nothing ;-)
+		return(Pa_HostApiTypeIdToHostApiIndex(paCoreAudio));
+	#endif
+	
+	#if PSYCH_SYSTEM == PSYCH_LINUX
+		// Try ALSA first...
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paALSA))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// Then JACK...
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paJACK))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// Then OSS...
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paOSS))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// then give up!
+		printf("PTB-ERROR: Could not find an operational audio subsystem on this Linux machine! Soundcard and driver installed and enabled?!?\n");
+		return(paHostApiNotFound);
+	#endif
+	
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		// Try ASIO first. It's supposed to be the lowest latency API on soundcards that suppport it.
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paASIO))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// Then WDM kernel streaming (Win2000, XP, maybe Vista). This is the best working free builtin
+		// replacement for the proprietary ASIO interface.
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paWDMKS))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// Then Vistas new WASAPI, which is supposed to replace WDMKS, but is still early alpha quality in PortAudio:
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paWASAPI))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// Then DirectSound: Bad, but not a complete disaster if the sound card has DS native drivers: 
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paDirectSound))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// Then Windows MME, a complete disaster, but better than silence...?!? 
+		if (((ai=Pa_HostApiTypeIdToHostApiIndex(paMME))!=paHostApiNotFound) && (Pa_GetHostApiInfo(ai)->deviceCount > 0)) return(ai);
+		// then give up!
+		printf("PTB-ERROR: Could not find an operational audio subsystem on this Windows machine! Soundcard and driver installed and enabled?!?\n");
+		return(paHostApiNotFound);
+	#endif
+	
+	printf("PTB-FATAL-ERROR: Impossible point in code execution reached! (End of PsychPAGetLowestLatencyHostAPI()\n");
+	return(paHostApiNotFound);
+}
+
+PsychError PSYCHPORTAUDIODisplaySynopsis(void)
+{
+	int i;
+	
+	for (i = 0; synopsisSYNOPSIS[i] != NULL; i++)
+		printf("%s\n",synopsisSYNOPSIS[i]);
+	
+	return(PsychError_none);
+}
+
+// Module exit function: Stop and close all audio streams, terminate PortAudio...
+PsychError PsychPortAudioExit(void)
+{
+	PaError err;
+	int i;
+	
+	if (pa_initialized) {
+		for(i=0; i<MAX_PSYCH_AUDIO_DEVS; i++) {
+			// Close i'th stream, if it is open:
+			PsychPACloseStream(i);
+		}
+		audiodevicecount = 0;
+		
+		// Delete all audio buffers and the bufferlist itself:
+		PsychPADeleteAllAudioBuffers();
+		
+		// Release audiobufferlist mutex lock:
+		PsychDestroyMutex(&bufferListmutex);
+
+		// Release all cached resampler filter banks:
+		for (i = 1; i < 4; i++) {
+			free(resamplerBanks[i].coeffs);
+			resamplerBanks[i].coeffs = NULL;
+		}
+
+		for (i = 0; i < PSYCH_PA_RESAMPLER_MAXSTRETCHED; i++) {
+			free(stretchedResamplerBanks[i].coeffs);
+			stretchedResamplerBanks[i].coeffs = NULL;
+		}
+		
+		// Shutdown PortAudio itself:
+		err = Pa_Terminate();
+		if (err) {
+			printf("PTB-FATAL-ERROR: PsychPortAudio: Shutdown of PortAudio subsystem failed. Depending on the quality\n");
+			printf("PTB-FATAL-ERROR: of your operating system, this may leave the sound system of your machine dead or confused.\n");
+			printf("PTB-FATAL-ERROR: Exit and restart Matlab/Octave. Windows users additionally may want to reboot...\n");
+			printf("PTB-FATAL-ERRRO: PortAudio reported the following error: %s\n\n", Pa_GetErrorText(err)); 
+		}
+		else {
+			pa_initialized = FALSE;
+		}
+
+		// Restart suspended PulseAudio server if it was suspended by us:
+		if (pulseaudio_isSuspended) {
+			// Call external "pactl" utility via shell to ask
+			// the server to resume all sinks and sources.
+			// These calls should fail silently if either the
+			// pactl utility isn't installed or no sound
+			// server is running:
+			if (verbosity > 4) printf("PTB-INFO: Trying to resume potentially suspended PulseAudio server.\n");
+			PsychRuntimeEvaluateString("system('pactl suspend-sink 0');");
+			PsychRuntimeEvaluateString("system('pactl suspend-source 0');");
+			pulseaudio_isSuspended = FALSE;
+		}
+	}
+
+	// Detach our callback function for low-level debug output:
+	PaUtil_SetDebugPrintFunction(NULL);
+	
+	return(PsychError_none);
+}
+
+void PsychPortAudioInitialize(void)
+{
+	PaError err;
+	int i;
+	
+	// PortAudio already initialized?
+	if (!pa_initialized) {
+		// No - Initialize:
+
+		// Suspend possibly running PulseAudio sound server if requested.
+		// We do this before PortAudio initialization, so the PulseAudio
+		// server can't interfere with device enumeration as done during
+		// PortAudio init. This is a Linux only thing...
+		if (pulseaudio_autosuspend && (PSYCH_SYSTEM == PSYCH_LINUX)) {
+			// Call external "pactl" utility via runtime to ask
+			// the server to suspend all sinks and sources,
+			// hopefully releasing the underlying low-level audio
+			// devices for use by use. These calls should fail silently
+			// if either the pactl utility isn't installed or no sound
+			// server is running:
+			if (verbosity > 4) printf("PTB-INFO: Trying to suspend potentially running PulseAudio server.\n");
+			PsychRuntimeEvaluateString("system('pactl suspend-sink 1');");
+			PsychRuntimeEvaluateString("system('pactl suspend-source 1');");
+			pulseaudio_isSuspended = TRUE;
+		}
+
+        #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        // Sanity check dynamic portaudio_x86.dll loading on Windows:
+        if (NULL == LoadLibrary("portaudio_x86.dll")) {
+            // Failed:
+            printf("\n\nPTB-ERROR: Tried to initialize PsychPortAudio's PortAudio engine. This didn't work,\n");
+            printf("PTB-ERROR: because i couldn't find or load the required portaudio_x86.dll library.\n");
+            printf("PTB-ERROR: Please make sure to call the InitializePsychSound function before first use of\n");
+            printf("PTB-ERROR: PsychPortAudio, otherwise this error will happen.\n\n");
+			PsychErrorExitMsg(PsychError_user, "Failed to initialize due to portaudio_x86.dll loading problem. Call InitializePsychSound first! Aborted.");
+        }
+        #endif
+        
+		// Setup callback function for low-level debug output:
+		PaUtil_SetDebugPrintFunction(PALogger);
+
+		if ((err=Pa_Initialize())!=paNoError) {
+			printf("PTB-ERROR: Portaudio initialization failed with following port audio error: %s \n", Pa_GetErrorText(err));
+			PsychErrorExitMsg(PsychError_system, "Failed to initialize PortAudio subsystem.");
+		}
+		else {
+			if(verbosity>2) {
+				printf("PTB-INFO: Using specially modified PortAudio engine, based on offical version: %s\n", Pa_GetVersionText());
+			}
+		}
+		
+		for(i=0; i<MAX_PSYCH_AUDIO_DEVS; i++) {
+			audiodevices[i].stream = NULL;
+		}
+		
+		audiodevicecount=0;
+
+		// Select best supported mixer kernels for master devices:
+		mixSIMDMaxLevel = PsychPADetectMixSIMDLevel();
+		mixSIMDLevel = mixSIMDMaxLevel;
+
+		// Init audio bufferList to empty and Mutex to unlocked:
+		bufferListCount = 0;
+		bufferListNext = 0;
+		bufferFreeHeaders = 0;
+		memset(bufferFreeBins, 0, sizeof(bufferFreeBins));
+		bufferPoolRetained = 0;
+		PsychInitMutex(&bufferListmutex);
+
+		// On Vista systems and later, we assume everything will be fine wrt. to timing and multi-core
+		// systems, but still perform consistency checks at each call to PsychGetPrecisionTimerSeconds().
+		// Therefore we don't lock our threads to a single core by default. On pre-Vista systems, we
+		// lock all threads to core 1 by default:
+		lockToCore1 = (PsychIsMSVista()) ? FALSE : TRUE;
+
+		pa_initialized = TRUE;
+	}
+}
+
+/* PsychPortAudio('Open') - Open and initialize an audio device via PortAudio.
+ */
+PsychError PSYCHPORTAUDIOOpen(void) 
+{
+ 	static char useString[] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
+	//															1			 2		 3					4		5			6			  7					  8					  9
+	static char synopsisString[] = 
+		"Open a PortAudio audio device and initialize it. Returns a 'pahandle' device handle for the device. "
+		"All parameters are optional and have reasonable defaults. 'deviceid' Index to select amongst multiple "
+		"logical audio devices supported by PortAudio. Defaults to whatever the systems default sound device is. "
+		"Different device id's may select the same physical device, but controlled by a different low-level sound "
+		"system. E.g., Windows has about five different sound subsystems. 'mode' Mode of operation. Defaults to "
+		"1 == sound playback only. Can be set to 2 == audio capture, or 3 for simultaneous capture and playback of sound. "
+		"Note however that mode 3 (full duplex) does not work reliably on all sound hardware. On some hardware this mode "
+		"may crash Matlab! There is also a special monitoring mode == 7, which only works for full duplex devices "
+		"when using the same number of input- and outputchannels. This mode allows direct feedback of captured sounds "
+		"back to the speakers with minimal latency and without involvement of your script at all, however no sound "
+		"can be captured during this time and your code mostly doesn't have any control over timing etc. \n"
+		"You can also define a audio device as a master device by adding the value 8 to mode. Master devices themselves "
+		"are not directly used to playback or capture sound. Instead one can create (multiple) slave devices that are "
+		"attached to a master device. Each slave can be controlled independently to playback or record sound through "
+		"a subset of the channels of the master device. This basically allows to virtualize a soundcard. See "
+		"help for subfunction 'OpenSlave' for more info.\n"
+		"'reqlatencyclass' Allows to select how aggressive PsychPortAudio should be about minimizing sound latency "
+		"and getting good deterministic timing, i.e. how to trade off latency vs. system load and playing nicely "
+		"with other sound applications on the system. Level 0 means: Don't care about latency, this mode works always "
+		"and with all settings, plays nicely with other sound applications. Level 1 (the default) means: Try to get "
+		"the lowest latency that is possible under the constraint of reliable playback, freedom of choice for all parameters and "
+		"interoperability with other applications. Level 2 means: Take full control over the audio device, even if this "
+		"causes other sound applications to fail or shutdown. Level 3 means: As level 2, but request the most aggressive "
+		"settings for the given device. Level 4: Same as 3, but fail if device can't meet the strictest requirements. "
+		"'freq' Requested playback/capture rate in samples per second (Hz). Defaults to a value that depends on the "
+		"requested latency mode. 'channels' Number of audio channels to use, defaults to 2 for stereo. If you perform "
+		"simultaneous playback and recording, you can provide a 2 element vector for 'channels', specifying different "
+		"numbers of output channels and input channels. The first element in such a vector defines the number of playback "
+		"channels, the 2nd element defines capture channels. E.g., [2, 1] would define 2 playback channels (stereo) and 1 "
+		"recording channel. See the optional 'selectchannels' argument for selection of physical device channels on multi- "
+		"channel cards.\n"
+		"'buffersize' "
+		"requested size and number of internal audio buffers, smaller numbers mean lower latency but higher system load "
+		"and some risk of overloading, which would cause audio dropouts. 'suggestedLatency' optional requested latency in "
+		"seconds. PortAudio selects internal operating parameters depending on sampleRate, suggestedLatency and buffersize "
+		"as well as device internal properties to optimize for low latency output. Best left alone, only here as manual "
+		"override in case all the auto-tuning cleverness fails.\n "
+		"'selectchannels' optional matrix with mappings of logical channels to device channels: If you only want to use "
+		"a subset of the channels present on your sound card, e.g., only 2 playback channels on a 16 channel soundcard, "
+		"then you'd set the 'channels' argument to 2. The 'selectchannels' argument allows you to select, e.g.,  which "
+		"two of the 16 channels to use for playback. 'selectchannels' is a one row by 'channels' matrix with mappings "
+		"for pure playback or pure capture. For full-duplex mode (playback and capture), 'selectchannels' must be a "
+		"2 rows by max(channels) column matrix. row 1 will define playback channel mappings, whereas row 2 will then "
+		"define capture channel mappings. In any case, the number in the i'th column will define which physical device "
+		"channel will be used for playback or capture of the i'th PsychPortAudio channel (the i'th row of your sound "
+		"matrix). Numbering of physical device channels starts with zero! Example: Both, playback and simultaneous "
+		"recording are requested and 'channels' equals 2, ie, two playback channels and two capture channels. If you'd "
+		"specify 'selectchannels' as [0, 6 ; 12, 14], then playback would happen to device channels zero and six, "
+		"sound would be captured from device channels 12 and 14. Please note that channel selection is currently "
+		"only supported on MS-Windows with ASIO sound cards. The parameter is silently ignored for non-ASIO operation.\n\n"
+		"'specialFlags' Optional flags: Default to zero, can be or'ed or added together with the following flags/settings:\n"
+		"1 = Never prime output stream. By default the output stream is primed. Don't bother if you don't know what this means.\n"
+		"2 = Always clamp audio data to the valid -1.0 to 1.0 range. Clamping is enabled by default.\n"
+		"4 = Never clamp audio data.\n"
+		"8 = Always dither output audio data. By default, dithering is enabled in normal mode, and disabled in low-latency mode. "
+		"Dithering adds a stochastic noise pattern to the least significant bit of each output sample to reduce the impact of "
+		"audio quantization artifacts. Dithering can improve signal to noise ratio and quality of output sound, but it is more "
+		"compute intense and it could change very low-level properties of the audio signal, because what you hear is not exactly "
+		"what you specified.\n"
+		"16 = Never dither audio data, not even in normal mode.\n\n";
+
+	static char seeAlsoString[] = "Close GetDeviceSettings ";	 
+  	
+	int freq, buffersize, latencyclass, mode, deviceid, i, numel, specialFlags;
+	int* nrchannels;
+	int  mynrchannels[2];
+	int  m, n, p;
+	double* mychannelmap;
+	double suggestedLatency, lowlatency;
+	PaDeviceIndex paDevice;
+	PaHostApiIndex paHostAPI;
+	PaStreamParameters outputParameters;
+	PaStreamParameters inputParameters;
+	const PaDeviceInfo* inputDevInfo, *outputDevInfo, *referenceDevInfo;
+	PaStreamFlags sflags;
+	PaError err;
+	PaStream *stream = NULL;
+	
+	#if PSYCH_SYSTEM == PSYCH_OSX
+		paMacCoreStreamInfo hostapisettings;
+	#endif
+	
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		// Additional data structures for setup of logical -> device channel
+		// mappings on ASIO multi-channel hardware:
+		PaAsioStreamInfo  inhostapisettings;
+		PaAsioStreamInfo  outhostapisettings;
+		int				  outputmappings[MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE];
+		int				  inputmappings[MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE];
+	#endif
+	
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(9));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+
+	if (audiodevicecount >= MAX_PSYCH_AUDIO_DEVS) PsychErrorExitMsg(PsychError_user, "Maximum number of simultaneously open audio devices reached.");
+	 
+	freq = 0;
+	buffersize = 0;
+	latencyclass = 1;
+	mode = kPortAudioPlayBack;
+	deviceid = -1;
+	specialFlags = 0;
+	
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+	
+	// Sanity check: Any hardware found?
+	if (Pa_GetDeviceCount() == 0) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system! Either your machine doesn't have audio hardware, or somethings seriously screwed.");
+	
+	// We default to generic system settings for host api specific settings:
+	outputParameters.hostApiSpecificStreamInfo = NULL;
+	inputParameters.hostApiSpecificStreamInfo  = NULL;
+
+	// Request optional deviceid:
+	PsychCopyInIntegerArg(1, kPsychArgOptional, &deviceid);
+	if (deviceid < -1) PsychErrorExitMsg(PsychError_user, "Invalid deviceid provided. Valid values are -1 to maximum number of devices.");
+
+	// Request optional mode of operation:
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &mode);
+	if (mode < 1 || mode > 15 || mode & kPortAudioIsAMModulator || mode & kPortAudioIsAMModulatorForSlave || mode & kPortAudioIsOutputCapture || ((mode & kPortAudioMonitoring) && ((mode & kPortAudioFullDuplex) != kPortAudioFullDuplex))) {
+		PsychErrorExitMsg(PsychError_user, "Invalid mode for regular- or master-audio device provided: Outside valid range or invalid combination of flags.");
+	}
+
+	// Request optional latency class:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &latencyclass);
+	if (latencyclass < 0 || latencyclass > 4) PsychErrorExitMsg(PsychError_user, "Invalid reqlatencyclass provided. Valid values are 0 to 4.");
+
+	if (deviceid == -1) {
+		// Default devices requested:
+		if ((latencyclass == 0) && (PSYCH_SYSTEM != PSYCH_LINUX)) {
+			// High latency mode on non-Linux. Simply pick system default devices.
+			// We don't pick these on Linux, because we'd end up with the ancient
+			// OSS, which is almost always a suboptimal choice for our purpose, even
+			// in high-latency mode.
+			outputParameters.device = Pa_GetDefaultOutputDevice(); /* Default output device. */
+			inputParameters.device  = Pa_GetDefaultInputDevice(); /* Default input device. */
+		}
+		else {
+			// Low latency mode: Try to find the host API which is supposed to be the fastest on
+			// a platform, then pick its default devices:
+			paHostAPI = PsychPAGetLowestLatencyHostAPI();
+			outputParameters.device = Pa_GetHostApiInfo(paHostAPI)->defaultOutputDevice;
+			inputParameters.device  = Pa_GetHostApiInfo(paHostAPI)->defaultInputDevice;
+		}
+	}
+	else {
+		// Specific device requested: In valid range?
+		if (deviceid >= Pa_GetDeviceCount() || deviceid < 0) {
+			PsychErrorExitMsg(PsychError_user, "Invalid deviceid provided. Higher than the number of devices - 1 or lower than zero.");
+		}
+		
+		outputParameters.device = (PaDeviceIndex) deviceid;
+		inputParameters.device = (PaDeviceIndex) deviceid;
+	}
+
+	// Query properties of selected device(s):
+	inputDevInfo  = Pa_GetDeviceInfo(inputParameters.device);
+	outputDevInfo = Pa_GetDeviceInfo(outputParameters.device);
+
+	// Select one of them as "reference" info devices: It's properties are used whenever
+	// no more specialized info is available. We use the output device (if any) as reference,
+	// otherwise fall back to the inputdevice.
+	referenceDevInfo = (outputDevInfo) ? outputDevInfo : inputDevInfo;
+
+	// Sanity check: Any hardware found?
+	if (referenceDevInfo == NULL) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system - or at least not with the provided deviceid, if any!");
+
+	// Check if current set of selected/available devices is compatible with our playback mode:
+	if (((mode & kPortAudioPlayBack) || (mode & kPortAudioMonitoring)) && ((outputDevInfo == NULL) || (outputDevInfo && outputDevInfo->maxOutputChannels <= 0))) {
+		PsychErrorExitMsg(PsychError_user, "Audio output requested, but there isn't any audio output device available or you provided a deviceid for something else than an output device!");
+	}
+
+	if (((mode & kPortAudioCapture) || (mode & kPortAudioMonitoring)) && ((inputDevInfo == NULL) || (inputDevInfo && inputDevInfo->maxInputChannels <= 0))) {
+		PsychErrorExitMsg(PsychError_user, "Audio input requested, but there isn't any audio input device available or you provided a deviceid for something else than an input device!");
+	}
+	
+	// Request optional frequency:
+	PsychCopyInIntegerArg(4, kPsychArgOptional, &freq);
+	if (freq < 0 || freq > 200000) PsychErrorExitMsg(PsychError_user, "Invalid frequency provided. Valid values are 0 to 200000 Hz.");
+	
+	// Request optional number of channels:
+	numel = 0; nrchannels = NULL;
+	PsychAllocInIntegerListArg(5, kPsychArgOptional, &numel, &nrchannels);
+	if (numel == 0) {
+		// No optional channelcount argument provided: Default to two for playback and recording, unless device is
+		// a mono device -- then we default to one:
+		mynrchannels[0] = (outputDevInfo && outputDevInfo->maxOutputChannels < 2) ? outputDevInfo->maxOutputChannels : 2;
+		mynrchannels[1] = (inputDevInfo && inputDevInfo->maxInputChannels < 2) ? inputDevInfo->maxInputChannels : 2;
+	}
+	else if (numel == 1) {
+		// One argument provided: Set same count for playback and recording:
+		if (*nrchannels < 1 || *nrchannels > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. Valid values are 1 to device maximum.");
+		mynrchannels[0] = *nrchannels;
+		mynrchannels[1] =  *nrchannels;		
+	}
+	else if (numel == 2) {
+		// Separate counts for playback and recording provided: Set'em up.
+		if (nrchannels[0] < 1 || nrchannels[0] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of playback channels provided. Valid values are 1 to device maximum.");
+		mynrchannels[0] = nrchannels[0];
+		if (nrchannels[1] < 1 || nrchannels[1] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of capture channels provided. Valid values are 1 to device maximum.");
+		mynrchannels[1] = nrchannels[1];
+	}
+	else {
+		// More than 2 channel counts provided? Impossible.
+		PsychErrorExitMsg(PsychError_user, "You specified a list with more than two 'channels' entries? Can only be max 2 for playback- and capture.");
+	}
+
+	// Make sure that number of capture and playback channels is the same for fast monitoring/feedback mode:
+	if ((mode & kPortAudioMonitoring) && (mynrchannels[0] != mynrchannels[1])) PsychErrorExitMsg(PsychError_user, "Fast monitoring/feedback mode selected, but number of capture and playback channels differs! They must be the same for this mode!");
+
+	// Request optional buffersize:
+	PsychCopyInIntegerArg(6, kPsychArgOptional, &buffersize);
+	if (buffersize < 0 || buffersize > 4096) PsychErrorExitMsg(PsychError_user, "Invalid buffersize provided. Valid values are 0 to 4096 samples.");
+
+	// Request optional suggestedLatency:
+	suggestedLatency = -1.0;
+	PsychCopyInDoubleArg(7, kPsychArgOptional, &suggestedLatency);
+	if (suggestedLatency!=-1 && (suggestedLatency < 0.0 || suggestedLatency > 1.0)) PsychErrorExitMsg(PsychError_user, "Invalid suggestedLatency provided. Valid values are 0.0 to 1.0 seconds.");
+	
+	// Get optional channel map:
+	mychannelmap = NULL;
+	PsychAllocInDoubleMatArg(8, kPsychArgOptional, &m, &n, &p, &mychannelmap);
+	if (mychannelmap) {
+		// Channelmapping provided: Sanity check it.
+		if (m<1 || m>2 || p!=1 || (n!=((mynrchannels[0] > mynrchannels[1]) ? mynrchannels[0] : mynrchannels[1]))) {
+			PsychErrorExitMsg(PsychError_user, "Invalid size of 'selectchannels' matrix argument: Must be a one- or two row by max(channels) column matrix!");
+		}
+		
+		// Basic check ok. Build ASIO host specific mapping structure:
+		#if PSYCH_SYSTEM == PSYCH_WINDOWS
+			// Check for ASIO: This only works for ASIO host API...
+			if (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type == paASIO) {
+				// MS-Windows and connected to an ASIO device. Good. Try to assign channel mapping:
+				if (mode & kPortAudioPlayBack) {
+					// Playback mappings:
+					outputParameters.hostApiSpecificStreamInfo = (PaAsioStreamInfo*) &outhostapisettings;
+					outhostapisettings.size = sizeof(PaAsioStreamInfo);
+					outhostapisettings.hostApiType = paASIO;
+					outhostapisettings.version = 1;
+					outhostapisettings.flags = paAsioUseChannelSelectors;
+					outhostapisettings.channelSelectors = (int*) &outputmappings[0];
+					for (i=0; i<mynrchannels[0]; i++) outputmappings[i] = (int) mychannelmap[i * m];
+					if (verbosity > 3) {
+						printf("PTB-INFO: Will try to use the following logical channel -> device channel mappings for sound output to audio stream %i :\n", audiodevicecount); 
+						for (i=0; i<mynrchannels[0]; i++) printf("%i --> %i : ", i+1, outputmappings[i]);
+						printf("\n\n");
+					}
+				}
+				
+				if (mode & kPortAudioCapture) {
+					// Capture mappings:
+					inputParameters.hostApiSpecificStreamInfo = (PaAsioStreamInfo*) &inhostapisettings;
+					inhostapisettings.size = sizeof(PaAsioStreamInfo);
+					inhostapisettings.hostApiType = paASIO;
+					inhostapisettings.version = 1;
+					inhostapisettings.flags = paAsioUseChannelSelectors;
+					inhostapisettings.channelSelectors = (int*) &inputmappings[0];
+					// Index into first row of one-row matrix or 2nd row of two-row matrix:
+					for (i=0; i<mynrchannels[1]; i++) inputmappings[i] = (int) mychannelmap[(i * m) + (m-1)];
+					if (verbosity > 3) {
+						printf("PTB-INFO: Will try to use the following logical channel -> device channel mappings for sound capture from audio stream %i :\n", audiodevicecount); 
+						for (i=0; i<mynrchannels[1]; i++) printf("%i --> %i : ", i+1, inputmappings[i]);
+						printf("\n\n");
+					}
+				}
+				// Mappings setup up. The PortAudio library will sanity check this further against device constraints...
+			}
+			else {
+				// Non ASIO device: No ASIO support --> No channel mapping support.
+				if (verbosity > 2) printf("PTB-WARNING: Provided 'selectchannels' channel mapping is ignored because this is not an ASIO enabled sound device.\n");
+			}
+		
+		#else
+			// Non MS-Windows system: No ASIO support --> No channel mapping support.
+			if (verbosity > 2) printf("PTB-WARNING: Provided 'selectchannels' channel mapping is ignored because this is not MS-Windows running on an ASIO enabled sound device.\n");
+		#endif
+	}
+	
+	// Copy in optional specialFlags:
+	PsychCopyInIntegerArg(9, kPsychArgOptional, &specialFlags);
+	
+	// Set channel count:
+	outputParameters.channelCount = mynrchannels[0];	// Number of output channels.
+	inputParameters.channelCount = mynrchannels[1];		// Number of input channels.
+	
+	// Fix sample format to float for now...
 	outputParameters.sampleFormat = paFloat32;
 	inputParameters.sampleFormat  = paFloat32;
 
-	// Setup buffersize:
-	if (buffersize == 0) {
-		// No specific buffersize requested:
-		if (latencyclass < 3) {
-			// At levels < 3, the frames per buffer is derived from
-			// the requested latency in seconds. Portaudio will never
-			// choose a value smaller than 64 frames per buffer or smaller
-			// than what the device suggests as minimum safe value.
-			buffersize = paFramesPerBufferUnspecified;
+	// Setup buffersize:
+	if (buffersize == 0) {
+		// No specific buffersize requested:
+		if (latencyclass < 3) {
+			// At levels < 3, the frames per buffer is derived from
+			// the requested latency in seconds. Portaudio will never
+			// choose a value smaller than 64 frames per buffer or smaller
+			// than what the device suggests as minimum safe value.
+			buffersize = paFramesPerBufferUnspecified;
+		}
+		else {
+			if (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type == paCoreAudio) {
+				buffersize = 64; // Lowest setting that is safe on a fast MacBook-Pro.
+			}
+			else {
+				// ASIO/ALSA/others: Leave it unspecified to get optimal selection by lower level driver:
+				// Esp. on Windows/ASIO and with Linux/ALSA, basically any choice other than paFramesPerBufferUnspecified
+				// will just lead to trouble and less optimal results, as the sound subsystems are very good at
+				// choosing this parameter optimally if allowed, but have a hard job to cope with any user-enforced choices.
+				buffersize = paFramesPerBufferUnspecified;
+			}
+		}
+	}
+	
+	// Now we have auto-selected buffersize or user provided override...
+	
+	// Setup samplerate:
+	if (freq == 0) {
+		// No specific frequency requested:
+		if (latencyclass < 3) {
+			// At levels < 3, we select the device specific default.
+			freq = referenceDevInfo->defaultSampleRate;
+		}
+		else {
+			freq = 96000; // Go really high...
+		}
+	}
+	
+	// Now we have auto-selected frequency or user provided override...
+
+	// Set requested latency: In class 0 we choose device recommendation for dropout-free operation, in
+	// all higher (lowlat) classes we request zero latency. PortAudio will
+	// clamp this request to something safe internally.
+	switch (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type) {
+		case paCoreAudio:	// CoreAudio driver will automatically clamp to safe minimum. Around 0.7 msecs.
+		case paWDMKS:		// dto. for Windows kernel streaming.
+			lowlatency = 0.0;
+		break;
+		
+		case paMME:		// No such a thing as low latency, but easy to kill the machine with too low settings!
+			lowlatency = 0.1; // Play safe, request 100 msecs. Otherwise terrible things may happen!
+		break;
+		
+		case paDirectSound:	// DirectSound defaults to 120 msecs, which is way too much! It doesn't accept 0.0 msecs.
+			lowlatency = 0.04;	// Choose some half-way safe tradeoff: 40 msecs.
+		break;
+		
+		case paASIO:		
+			// ASIO: A value of zero would set safe (and high latency!) defaults. Too small values get
+			// clamped to a safe minimum by the driver, so we select a very small positive value, say
+			// 1 msec to get lowest possible latency for latencyclass of at least 2. In latency class 1
+			// we play a bit safer and go for 5 msecs:
+			lowlatency = (latencyclass >= 2) ? 0.001 : 0.005;
+		break;
+
+		case paALSA:	
+			// For ALSA we choose 10 msecs by default, lowering to 5 msecs if exp. requested. Experience
+			// shows that the effective latency will be only a fraction of this, so we are good.
+			// Otoh going too low could cause dropouts on the tested MacbookPro 2nd generation...
+			// This will need more lab testing and tweaking - and the user can override anyway...
+			lowlatency = (latencyclass > 2) ? 0.005 : 0.010;
+		break;
+
+		default:			// Not the safest assumption for non-verified Api's, but we'll see...
+			lowlatency = 0.0;
+	}
+	
+	if (suggestedLatency == -1.0) {
+		// None provided: Choose default based on latency mode:
+		outputParameters.suggestedLatency = (latencyclass == 0 && outputDevInfo) ? outputDevInfo->defaultHighOutputLatency : lowlatency;
+		inputParameters.suggestedLatency  = (latencyclass == 0 && inputDevInfo) ? inputDevInfo->defaultHighInputLatency : lowlatency;
+	}
+	else {
+		// Override provided: Use it.
+		outputParameters.suggestedLatency = suggestedLatency;
+		inputParameters.suggestedLatency  = suggestedLatency;
+	}
+
+	#if PSYCH_SYSTEM == PSYCH_OSX
+	// Apply OS/X CoreAudio specific optimizations:
+	if (latencyclass > 1) {
+		unsigned long flags = paMacCore_ChangeDeviceParameters;
+		if (latencyclass > 3) flags|= paMacCore_FailIfConversionRequired;
+		paSetupMacCoreStreamInfo( &hostapisettings, flags);
+		outputParameters.hostApiSpecificStreamInfo = (paMacCoreStreamInfo*) &hostapisettings;
+		inputParameters.hostApiSpecificStreamInfo = (paMacCoreStreamInfo*) &hostapisettings;
+	}
+	#endif
+	
+	// Our stream shall be primed initially with our callbacks data, not just with zeroes.
+	// In high latency-mode 0, we request sample clipping and dithering, so sound is more
+	// high quality on Windows. In low-latency mode, we don't dither by default to save computation time.
+	sflags = paPrimeOutputBuffersUsingStreamCallback;
+	sflags = (latencyclass <= 0) ? sflags : (sflags | paDitherOff);
+
+	// specialFlags 1: Don't prime outputbuffer via streamcallback:
+	if (specialFlags & 1) sflags &= ~paPrimeOutputBuffersUsingStreamCallback;
+
+	// specialFlags 2: Always clip audio data:
+	if (specialFlags & 2) sflags &= ~paClipOff;
+
+	// specialFlags 4: Never clip audio data:
+	if (specialFlags & 4) sflags |= paClipOff;
+
+	// specialFlags 8: Always dither audio data:
+	if (specialFlags & 8) sflags &= ~paDitherOff;
+
+	// specialFlags 16: Never dither audio data:
+	if (specialFlags & 16) sflags |= paDitherOff;
+
+	// Try to create & open stream:
+	err = Pa_OpenStream(
+            &stream,															/* Return stream pointer here on success. */
+            ((mode & kPortAudioCapture) ?  &inputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
+			((mode & kPortAudioPlayBack) ? &outputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
+            freq,																/* Requested sampling rate. */
+            buffersize,															/* Requested buffer size. */
+            sflags,																/* Define special stream property flags. */
+            paCallback,															/* Our processing callback. */
+            &audiodevices[audiodevicecount]);									/* Our own device info structure */
+            
+	if(err!=paNoError || stream == NULL) {
+			printf("PTB-ERROR: Failed to open audio device %i. PortAudio reports this error: %s \n", audiodevicecount, Pa_GetErrorText(err));
+			PsychErrorExitMsg(PsychError_system, "Failed to open PortAudio audio device.");
+	}
+	
+	// Setup our final device structure:
+	audiodevices[audiodevicecount].opmode = mode;
+	audiodevices[audiodevicecount].runMode = 1; // Keep engine running by default. Minimal extra cpu-load for significant reduction in startup latency.
+	audiodevices[audiodevicecount].stream = stream;
+	audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(stream);
+	audiodevices[audiodevicecount].hostAPI = Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type;
+	audiodevices[audiodevicecount].startTime = 0.0;
+	audiodevices[audiodevicecount].reqStartTime = 0.0;
+	audiodevices[audiodevicecount].reqStopTime = DBL_MAX;
+	audiodevices[audiodevicecount].estStopTime = 0;
+	audiodevices[audiodevicecount].currentTime = 0;		
+	audiodevices[audiodevicecount].state = 0;
+	audiodevices[audiodevicecount].reqstate = 255;
+	audiodevices[audiodevicecount].repeatCount = 1;
+	audiodevices[audiodevicecount].outputbuffer = NULL;
+	audiodevices[audiodevicecount].outputbuffersize = 0;
+	audiodevices[audiodevicecount].inputbuffer = NULL;
+	audiodevices[audiodevicecount].inputbuffersize = 0;
+	audiodevices[audiodevicecount].outchannels = mynrchannels[0];
+	audiodevices[audiodevicecount].inchannels = mynrchannels[1];
+	audiodevices[audiodevicecount].latencyBias = 0.0;
+	audiodevices[audiodevicecount].schedule = NULL;
+	audiodevices[audiodevicecount].schedule_size = 0;
+	audiodevices[audiodevicecount].schedule_pos = 0;
+	audiodevices[audiodevicecount].schedule_writepos = 0;
+	audiodevices[audiodevicecount].outdeviceidx = (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) ? outputParameters.device : -1;
+	audiodevices[audiodevicecount].indeviceidx  = (audiodevices[audiodevicecount].opmode & kPortAudioCapture)  ? inputParameters.device  : -1;
+	audiodevices[audiodevicecount].outputmappings = NULL;
+	audiodevices[audiodevicecount].inputmappings = NULL;
+	audiodevices[audiodevicecount].slaveCount = 0;
+	audiodevices[audiodevicecount].slavesProcessed = 0;
+	audiodevices[audiodevicecount].slaves = NULL;
+	audiodevices[audiodevicecount].pamaster = -1;
+	audiodevices[audiodevicecount].modulatorSlave = -1;
+	audiodevices[audiodevicecount].slaveOutBuffer = NULL;
+	audiodevices[audiodevicecount].slaveGainBuffer = NULL;
+	audiodevices[audiodevicecount].slaveInBuffer = NULL;
+	audiodevices[audiodevicecount].workerThreads = NULL;
+	audiodevices[audiodevicecount].workerCount = 0;
+	audiodevices[audiodevicecount].slaveJobs = NULL;
+	audiodevices[audiodevicecount].workerBufferFrames = 0;
+	audiodevices[audiodevicecount].workerFallback = 0;
+	audiodevices[audiodevicecount].deferScheduleUnref = 0;
+	audiodevices[audiodevicecount].scheduleUnrefPending = 0;
+	audiodevices[audiodevicecount].ringBuffer = NULL;
+	audiodevices[audiodevicecount].ringCapacity = 0;
+	audiodevices[audiodevicecount].ringReadPos = 0;
+	audiodevices[audiodevicecount].ringWritePos = 0;
+	audiodevices[audiodevicecount].ringUnderruns = 0;
+	audiodevices[audiodevicecount].ringUnderrunFrames = 0;
+	audiodevices[audiodevicecount].automation = NULL;
+	audiodevices[audiodevicecount].automationTracks = 0;
+	audiodevices[audiodevicecount].automationMixGains = NULL;
+	audiodevices[audiodevicecount].mixGains = NULL;
+	audiodevices[audiodevicecount].resampler = NULL;
+	audiodevices[audiodevicecount].resampleScratch = NULL;
+	audiodevices[audiodevicecount].resamplePhase = 0;
+	audiodevices[audiodevicecount].outputbufferSampleRate = 0;
+	audiodevices[audiodevicecount].playoutSampleRate = 0;
+	audiodevices[audiodevicecount].outputbufferResampler = NULL;
+	audiodevices[audiodevicecount].playoutResampler = NULL;
+	audiodevices[audiodevicecount].timing = NULL;
+	audiodevices[audiodevicecount].timingEnabled = 0;
+	audiodevices[audiodevicecount].captureWriter = NULL;
+	audiodevices[audiodevicecount].captureFileFrames = 0;
+	audiodevices[audiodevicecount].captureFileOverflows = 0;
+	audiodevices[audiodevicecount].captureFileLostFrames = 0;
+	audiodevices[audiodevicecount].outChannelVolumes = NULL;
+	audiodevices[audiodevicecount].masterVolume = 1.0;
+	audiodevices[audiodevicecount].playposition = 0;
+	audiodevices[audiodevicecount].totalplaycount = 0;
+		
+	// If this is a master, create a slave device list and init it to "empty":
+	if (mode & kPortAudioIsMaster) {
+		audiodevices[audiodevicecount].slaves = (int*) malloc(sizeof(int) * MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE);
+		if (NULL == audiodevices[audiodevicecount].slaves) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient memory during slave devicelist creation!");
+		for (i=0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) audiodevices[audiodevicecount].slaves[i] = -1;
+
+		if (mode & kPortAudioPlayBack) {
+			// Allocate a dummy outputbuffer with one sampleframe:
+			audiodevices[audiodevicecount].outputbuffersize = sizeof(float) * audiodevices[audiodevicecount].outchannels * 1;
+			audiodevices[audiodevicecount].outputbuffer = (float*) malloc(audiodevices[audiodevicecount].outputbuffersize);
+			if (audiodevices[audiodevicecount].outputbuffer==NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate audio buffer.");
+		}
+		
+		if (mode & kPortAudioCapture) {
+			// Allocate a dummy inputbuffer with one sampleframe:
+			audiodevices[audiodevicecount].inputbuffersize = sizeof(float) * audiodevices[audiodevicecount].inchannels * 1;
+			audiodevices[audiodevicecount].inputbuffer = (float*) calloc(1, audiodevices[audiodevicecount].inputbuffersize);
+			if (audiodevices[audiodevicecount].inputbuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Free system memory exhausted when trying to allocate audio recording buffer!");
+		}		
+	}
+
+	// If we use locking, we need to initialize the per-device mutex:
+	if (uselocking && PsychInitMutex(&(audiodevices[audiodevicecount].mutex))) {
+		printf("PsychPortAudio: CRITICAL! Failed to initialize Mutex object for pahandle %i! Prepare for trouble!\n", audiodevicecount);
+		PsychErrorExitMsg(PsychError_system, "Audio device mutex creation failed!");
+	}
+	
+	// If we use locking, this will create & init the associated event variable:
+	PsychPACreateSignal(&(audiodevices[audiodevicecount]));
+
+	// Masters get worker threads for parallel rendering of their slaves, if enabled:
+	if (mode & kPortAudioIsMaster) PsychPAStartSlaveWorkers(&(audiodevices[audiodevicecount]));
+	
+	// Register the stream finished callback:
+	Pa_SetStreamFinishedCallback(audiodevices[audiodevicecount].stream, PAStreamFinishedCallback);
+
+	#if PSYCH_SYSTEM == PSYCH_OSX
+		// Query low-level audio driver of the CoreAudio HAL for hardware latency:
+		// Hmm, maybe not. Don't know if it is worth the hazzle... This is a constant that
+		// doesn't change throughout the lifetime of a machine, and it only makes up for about
+		// 0.3 msecs on a typical setup. Maybe if a user really needs that 0.3 msecs extra
+		// precision, he should simply download the free HALLab from Apple's Website or Developer
+		// tools, run it once, read the displayed constant and set it manually at PortAudio startup.
+		
+		// PaMacCoreStream* corestream = (PaMacCoreStream*) audiodevices[audiodevicecount].stream;
+		// audiodevices[audiodevicecount].latencyBias = 
+	#endif
+	
+	if (verbosity > 3) {
+		printf("PTB-INFO: New audio device with handle %i opened as PortAudio stream:\n",audiodevicecount);
+
+		if (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) {
+			printf("PTB-INFO: For %i channels Playback: Audio subsystem is %s, Audio device name is ", (int) audiodevices[audiodevicecount].outchannels, Pa_GetHostApiInfo(outputDevInfo->hostApi)->name);
+			printf("%s\n", outputDevInfo->name);
+		}
+
+		if (audiodevices[audiodevicecount].opmode & kPortAudioCapture) {
+			printf("PTB-INFO: For %i channels Capture: Audio subsystem is %s, Audio device name is ", (int) audiodevices[audiodevicecount].inchannels, Pa_GetHostApiInfo(inputDevInfo->hostApi)->name);
+			printf("%s\n", inputDevInfo->name);
+		}
+		
+		printf("PTB-INFO: Real samplerate %f Hz. Input latency %f msecs, Output latency %f msecs.\n",
+				audiodevices[audiodevicecount].streaminfo->sampleRate, audiodevices[audiodevicecount].streaminfo->inputLatency * 1000.0,
+				audiodevices[audiodevicecount].streaminfo->outputLatency * 1000.0);
+	}
+
+	// Return device handle:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevicecount);
+	
+	// One more audio device...
+	audiodevicecount++;
+
+    return(PsychError_none);	
+}
+
+/* PsychPortAudio('OpenSlave') - Open and initialize a virtual audio slave device.
+ */
+PsychError PSYCHPORTAUDIOOpenSlave(void) 
+{
+ 	static char useString[] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels]);";
+	//																  1			  2		  3			  4
+	static char synopsisString[] = 
+		"Open a virtual slave audio device and initialize it. Returns a 'pahandle' device handle for the device.\n"
+		"Slave audio devices are almost always attached to a 'pamaster' audio device that you need to open and initialize "
+		"first via a call to pamaster = PsychPortAudio('Open', ...); The 'pamaster' corresponds to a real soundcard "
+		"present in your system which has been setup for a certain mode of operation, timing mode, frequency etc. "
+		"The exception is if you create an AMModulator slave (see below). It can be attached to another playback "
+		"slave device by passing the handle of that device as 'pamaster'. "
+		"To each real pamaster you can attach multiple slave devices. Each slave represents a subset of the audio channels "
+		"of the pamaster device. Each slave can be used as if it is a real independent soundcard for capture or "
+		"playback with or without its own set of playback buffers, its own schedule and mode of operation, its own "
+		"start and stop times, status etc. Under the hood, the slave device will use the defined subset of channels "
+		"of the master device to achieve this illusion of independent soundcards. Typical usage scenarios would be:\n\n"
+		"* Mixing of independent soundtracks: Create multiple slave devices, one for each soundtrack. Attach all of "
+		"them to the same set of channels on a common master device. Now you can feed each slave with its own soundtrack, "
+		"start, stop and schedule playback of each slave/soundtrack independently. Sound from all active channels of "
+		"all active slaves will be mixed together and output through the channels of the master device.\n\n"
+		"* Independent control of channels: Same as above, but the slaves don't share the same subset of channels "
+		"on the master, but each slave chooses a distinctive subset of channels, therefore no mixing will occur."
+		"\n\n"
+		"'pamaster' is the mandatory pahandle of a master audio device. The master must have been opened via "
+		"PsychPortAudio('Open', ..., mode, ...); with the mode flag value '8' included to define it as a master (see 'Open').\n\n"
+		"'mode' Mode of operation. See help of 'Open' function for valid settings. However, a mode flag of '8' for "
+		"master operation is not allowed for obvious reasons. Also, the given 'mode' flags must be a subset of the "
+		"'mode' set on the master device! E.g., you can't specify a audio capture mode flag if the master device isn't "
+		"enabled for capture as well. As an exception kPortAudioMonitoring mode is allowed to be present on a slave "
+		"while missing on the associated master device.\n"
+		"The slave-only mode flag 32 (kPortAudioIsAMModulator) defines a slave device not as a source of audio data, "
+		"but as a source of amplitude modulation (AM) envelope data. Its samples don't create sound, but gain-modulate "
+		"the sound of other slaves attached to the master to allow precisely timed AM modulation. See the help for "
+		"PsychPortAudio('Volume') for more details about AM.\n\n"
+		"The slave-only mode flag 64 (kPortAudioIsOutputCapture) defines a slave capture device that captures audio "
+		"data from the *output channels* of the master device, i.e., it records the audio stream that is sent to the "
+		"speakers. This may be useful for capturing PsychPortAudio's audio output for documentation or debug purposes.\n\n"
+		"All slave devices share the same settings for latencymode, timing, sampling frequency "
+		"and other low-level tunable parameters, because they operate on the same underlying audio hardware.\n\n"
+		"'channels' Define total number of playback and capture channels to use. See help for 'Open?' for explanation. "
+		"By default, all channels of the master are used.\n\n"
+		"'selectchannels' optional matrix with mappings of logical slave channels to logical master channels: "
+		"selectchannels' is a one row by 'channels' matrix with mappings "
+		"for pure playback or pure capture. For full-duplex mode (playback and capture), 'selectchannels' must be a "
+		"2 rows by max(channels) column matrix. row 1 will define playback channel mappings, whereas row 2 will then "
+		"define capture channel mappings. In any case, the number in the i'th column will define which master device "
+		"channel will be used for playback or capture of the i'th PsychPortAudio channel (the i'th row of your sound "
+		"matrix). Numbering of master device channels starts with one! Example: Both, playback and simultaneous "
+		"recording are requested from a master device which represents a 16 channel soundcard with all 16 channels open. "
+		"If you'd specify 'selectchannels' as [1, 6 ; 12, 14], then playback would happen to master channels one and six, "
+		"sound would be captured from master channels 12 and 14.\n\n";
+	
+	static char seeAlsoString[] = "Open Close GetDeviceSettings ";	 
+  	
+	int mode, pamaster, paparent, i, numel;
+	int* nrchannels;
+	int  mynrchannels[2];
+	int  m, n, p;
+	double* mychannelmap;
+	int modeExceptions = 0;
+	
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+
+	if (audiodevicecount >= MAX_PSYCH_AUDIO_DEVS) PsychErrorExitMsg(PsychError_user, "Maximum number of simultaneously open audio devices exceeded. You need to close some before you can open new ones.");
+	 
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	// Request mandatory pamaster device handle:
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pamaster);
+
+	// Valid device?
+	if (pamaster < 0 || pamaster >= MAX_PSYCH_AUDIO_DEVS || audiodevices[pamaster].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio master device handle 'pamaster' provided. No such master device open!");
+
+	// Request optional mode of operation:
+	if (PsychCopyInIntegerArg(2, kPsychArgOptional, &mode)) {
+		// Mode provided. Validate, but remove potential master flag first:
+		mode = mode & (~kPortAudioIsMaster);
+
+		// Being an AM modulator implies being a playback device, as we use the
+		// whole audio playback scheduling and buffer facilities:
+		if (mode & kPortAudioIsAMModulator) mode |= kPortAudioPlayBack;
+
+		// Being an output capturer implies special rules:
+		if (mode & kPortAudioIsOutputCapture) {
+			// The associated master must have output that we can capture, ie., it must be configured for playback:
+			if (!(audiodevices[pamaster].opmode & kPortAudioPlayBack)) PsychErrorExitMsg(PsychError_user, "Invalid mode: This shall be an output capture device, but master isn't configured for output/playback!");
+
+			// We are a capture device:
+			mode |= kPortAudioCapture;
+			
+			// Master doesn't need to be a capture device, as we're capturing its output, not its input:
+			modeExceptions |= kPortAudioCapture;
 		}
-		else {
-			if (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type == paCoreAudio) {
-				buffersize = 64; // Lowest setting that is safe on a fast MacBook-Pro.
-			}
-			else {
-				// ASIO/ALSA/others: Leave it unspecified to get optimal selection by lower level driver:
-				// Esp. on Windows/ASIO and with Linux/ALSA, basically any choice other than paFramesPerBufferUnspecified
-				// will just lead to trouble and less optimal results, as the sound subsystems are very good at
-				// choosing this parameter optimally if allowed, but have a hard job to cope with any user-enforced choices.
-				buffersize = paFramesPerBufferUnspecified;
-			}
+		
+		// Is mode a subset of the masters mode as required? One valid exception is kPortAudioMonitoring,
+		// which is allowed to be present on the slave but missing on the master, as well as the AMModulator
+		// mode and output capturer mode:
+		modeExceptions |= kPortAudioMonitoring | kPortAudioIsAMModulator | kPortAudioIsAMModulatorForSlave | kPortAudioIsOutputCapture;
+		if (((mode & ~modeExceptions) & audiodevices[pamaster].opmode) != (mode & ~modeExceptions)) PsychErrorExitMsg(PsychError_user, "Invalid mode provided: Mode flags are not a subset of the mode flags of the pamaster device!");
+		if ((mode < 1) || ((mode & kPortAudioMonitoring) && ((mode & kPortAudioFullDuplex) != kPortAudioFullDuplex))) {
+			PsychErrorExitMsg(PsychError_user, "Invalid mode provided: Outside valid range or invalid combination of flags.");
 		}
 	}
-	
-	// Now we have auto-selected buffersize or user provided override...
-	
-	// Setup samplerate:
-	if (freq == 0) {
-		// No specific frequency requested:
-		if (latencyclass < 3) {
-			// At levels < 3, we select the device specific default.
-			freq = referenceDevInfo->defaultSampleRate;
-		}
-		else {
-			freq = 96000; // Go really high...
-		}
+	else {
+		// No mode provided: Use settings from pamaster, minus the master flag of course.
+		mode = audiodevices[pamaster].opmode & (~kPortAudioIsMaster);
 	}
 	
-	// Now we have auto-selected frequency or user provided override...
+	// Mode set and validated: Add the slave flag to mark us as slave device:
+	mode |= kPortAudioIsSlave;
 
-	// Set requested latency: In class 0 we choose device recommendation for dropout-free operation, in
-	// all higher (lowlat) classes we request zero latency. PortAudio will
-	// clamp this request to something safe internally.
-	switch (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type) {
-		case paCoreAudio:	// CoreAudio driver will automatically clamp to safe minimum. Around 0.7 msecs.
-		case paWDMKS:		// dto. for Windows kernel streaming.
-			lowlatency = 0.0;
-		break;
-		
-		case paMME:		// No such a thing as low latency, but easy to kill the machine with too low settings!
-			lowlatency = 0.1; // Play safe, request 100 msecs. Otherwise terrible things may happen!
-		break;
+	// Is our 'pamaster' handle an actual master device?
+	if (!(audiodevices[pamaster].opmode & kPortAudioIsMaster)) {
+		// No, it is a slave device itself.
 		
-		case paDirectSound:	// DirectSound defaults to 120 msecs, which is way too much! It doesn't accept 0.0 msecs.
-			lowlatency = 0.04;	// Choose some half-way safe tradeoff: 40 msecs.
-		break;
+		// This is only allowed if we are a modulator device and the target is configured for playback. Error out if this isn't the case:
+		if (!(mode & kPortAudioIsAMModulator) || !(audiodevices[pamaster].opmode & kPortAudioPlayBack)) {
+			PsychErrorExitMsg(PsychError_user, "Provided device handle 'pamaster' is not configured as a master device. Attaching to a slave is only allowed if it is playback capable and this device is configured as an AM modulator!");
+		}
 		
-		case paASIO:		
-			// ASIO: A value of zero would set safe (and high latency!) defaults. Too small values get
-			// clamped to a safe minimum by the driver, so we select a very small positive value, say
-			// 1 msec to get lowest possible latency for latencyclass of at least 2. In latency class 1
-			// we play a bit safer and go for 5 msecs:
-			lowlatency = (latencyclass >= 2) ? 0.001 : 0.005;
-		break;
+		// We're a modulator for a slave.
+		mode |= kPortAudioIsAMModulatorForSlave;		
+	}
 
-		case paALSA:	
-			// For ALSA we choose 10 msecs by default, lowering to 5 msecs if exp. requested. Experience
-			// shows that the effective latency will be only a fraction of this, so we are good.
-			// Otoh going too low could cause dropouts on the tested MacbookPro 2nd generation...
-			// This will need more lab testing and tweaking - and the user can override anyway...
-			lowlatency = (latencyclass > 2) ? 0.005 : 0.010;
-		break;
+	// Request optional number of channels:
+	numel = 0; nrchannels = NULL;
+	PsychAllocInIntegerListArg(3, kPsychArgOptional, &numel, &nrchannels);
+	if (numel == 0) {
+		// No optional channelcount argument provided: Default to pamaster settings:
+		mynrchannels[0] = audiodevices[pamaster].outchannels;
+		mynrchannels[1] = audiodevices[pamaster].inchannels;
+		if (mode & kPortAudioIsOutputCapture) mynrchannels[1] = audiodevices[pamaster].outchannels;
+	}
+	else if (numel == 1) {
+		// One argument provided: Set same count for playback and recording:
+		if (*nrchannels < 1 || *nrchannels > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. Valid values are 1 to device maximum.");
+		if (*nrchannels > audiodevices[pamaster].outchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. More output channels than pamaster device.");
+		if (*nrchannels > audiodevices[pamaster].inchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. More input channels than pamaster device.");
 
-		default:			// Not the safest assumption for non-verified Api's, but we'll see...
-			lowlatency = 0.0;
+		mynrchannels[0] = *nrchannels;
+		mynrchannels[1] = *nrchannels;		
 	}
-	
-	if (suggestedLatency == -1.0) {
-		// None provided: Choose default based on latency mode:
-		outputParameters.suggestedLatency = (latencyclass == 0 && outputDevInfo) ? outputDevInfo->defaultHighOutputLatency : lowlatency;
-		inputParameters.suggestedLatency  = (latencyclass == 0 && inputDevInfo) ? inputDevInfo->defaultHighInputLatency : lowlatency;
+	else if (numel == 2) {
+		// Separate counts for playback and recording provided: Set'em up.
+		if (nrchannels[0] < 1 || nrchannels[0] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE || nrchannels[0] > audiodevices[pamaster].outchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of playback channels provided. Valid values are 1 to number of output channels on pamaster device.");
+		mynrchannels[0] = nrchannels[0];
+		if (mode & kPortAudioIsOutputCapture) {
+			// Output capture device:
+			if (nrchannels[1] < 1 || nrchannels[1] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE || nrchannels[1] > audiodevices[pamaster].outchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of capture channels provided. Valid values are 1 to number of output channels on pamaster device.");
+			mynrchannels[1] = nrchannels[1];
+		}
+		else {
+			// Regular capture device:
+			if (nrchannels[1] < 1 || nrchannels[1] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE || nrchannels[1] > audiodevices[pamaster].inchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of capture channels provided. Valid values are 1 to number of capture channels on pamaster device.");
+			mynrchannels[1] = nrchannels[1];
+		}
 	}
 	else {
-		// Override provided: Use it.
-		outputParameters.suggestedLatency = suggestedLatency;
-		inputParameters.suggestedLatency  = suggestedLatency;
+		// More than 2 channel counts provided? Impossible.
+		PsychErrorExitMsg(PsychError_user, "You specified a list with more than two 'channels' entries? Can only be max 2 for playback- and capture.");
 	}
 
-	#if PSYCH_SYSTEM == PSYCH_OSX
-	// Apply OS/X CoreAudio specific optimizations:
-	if (latencyclass > 1) {
-		unsigned long flags = paMacCore_ChangeDeviceParameters;
-		if (latencyclass > 3) flags|= paMacCore_FailIfConversionRequired;
-		paSetupMacCoreStreamInfo( &hostapisettings, flags);
-		outputParameters.hostApiSpecificStreamInfo = (paMacCoreStreamInfo*) &hostapisettings;
-		inputParameters.hostApiSpecificStreamInfo = (paMacCoreStreamInfo*) &hostapisettings;
-	}
-	#endif
+	// Make sure that number of capture and playback channels is the same for fast monitoring/feedback mode:
+	if ((mode & kPortAudioMonitoring) && (mynrchannels[0] != mynrchannels[1])) PsychErrorExitMsg(PsychError_user, "Fast monitoring/feedback mode selected, but number of capture and playback channels differs! They must be the same for this mode!");
+
+	// Get optional channel map:	
+	audiodevices[audiodevicecount].outputmappings = NULL;
+	audiodevices[audiodevicecount].inputmappings = NULL;
+	mychannelmap = NULL;
+	PsychAllocInDoubleMatArg(4, kPsychArgOptional, &m, &n, &p, &mychannelmap);
 	
-	// Our stream shall be primed initially with our callbacks data, not just with zeroes.
-	// In high latency-mode 0, we request sample clipping and dithering, so sound is more
-	// high quality on Windows. In low-latency mode, we don't dither by default to save computation time.
-	sflags = paPrimeOutputBuffersUsingStreamCallback;
-	sflags = (latencyclass <= 0) ? sflags : (sflags | paDitherOff);
+	if (mychannelmap) {
+		// Channelmapping provided: Sanity check it.
+		if (m<1 || m>2 || p!=1 || (n!=((mynrchannels[0] > mynrchannels[1]) ? mynrchannels[0] : mynrchannels[1]))) {
+			PsychErrorExitMsg(PsychError_user, "Invalid size of 'selectchannels' matrix argument: Must be a one- or two row by max(channels) column matrix!");
+		}
+		
+		// Basic check ok. Build mapping structure:
+		if (mode & kPortAudioPlayBack) {
+			// Assign playback mappings:
+			audiodevices[audiodevicecount].outputmappings = malloc(sizeof(int) * mynrchannels[0]);
+			for (i = 0; i < mynrchannels[0]; i++) audiodevices[audiodevicecount].outputmappings[i] = (int) mychannelmap[i * m] - 1;
 
-	// specialFlags 1: Don't prime outputbuffer via streamcallback:
-	if (specialFlags & 1) sflags &= ~paPrimeOutputBuffersUsingStreamCallback;
+			if (verbosity > 4) {
+				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound output to audio stream %i:\n", audiodevicecount); 
+				for (i=0; i < mynrchannels[0]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].outputmappings[i] + 1);
+				printf("\n\n");
+			}
 
-	// specialFlags 2: Always clip audio data:
-	if (specialFlags & 2) sflags &= ~paClipOff;
+			// Revalidate:
+			for (i = 0; i < mynrchannels[0]; i++) if (audiodevices[audiodevicecount].outputmappings[i] < 0 || audiodevices[audiodevicecount].outputmappings[i] >= audiodevices[pamaster].outchannels) {
+				printf("PTB-ERROR: Slot %i of output channel selection list contains invalid master device channel id %i [Valid between 1 and %i]!\n", i+1, audiodevices[audiodevicecount].outputmappings[i] + 1, audiodevices[pamaster].outchannels);
+				free(audiodevices[audiodevicecount].outputmappings);
+				audiodevices[audiodevicecount].outputmappings = NULL;
+				PsychErrorExitMsg(PsychError_user, "Invalid items in 'selectchannels' matrix argument!");				
+			}
+		}
+		
+		if ((mode & kPortAudioCapture) && !(mode & kPortAudioIsOutputCapture)) {
+			// Assign Capture mappings:
+			audiodevices[audiodevicecount].inputmappings = malloc(sizeof(int) * mynrchannels[1]);
+			// Index into first row of one-row matrix or 2nd row of two-row matrix:
+			for (i = 0; i < mynrchannels[1]; i++) audiodevices[audiodevicecount].inputmappings[i] = (int) mychannelmap[(i * m) + (m-1)] - 1;
 
-	// specialFlags 4: Never clip audio data:
-	if (specialFlags & 4) sflags |= paClipOff;
+			if (verbosity > 4) {
+				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound capture from audio stream %i:\n", audiodevicecount); 
+				for (i=0; i < mynrchannels[1]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1);
+				printf("\n\n");
+			}
 
-	// specialFlags 8: Always dither audio data:
-	if (specialFlags & 8) sflags &= ~paDitherOff;
+			// Revalidate:
+			for (i = 0; i < mynrchannels[1]; i++) if (audiodevices[audiodevicecount].inputmappings[i] < 0 || audiodevices[audiodevicecount].inputmappings[i] >= audiodevices[pamaster].inchannels) {
+				printf("PTB-ERROR: Slot %i of capture channel selection list contains invalid master device channel id %i [Valid between 1 and %i]!\n", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1, audiodevices[pamaster].inchannels);
+				free(audiodevices[audiodevicecount].inputmappings);
+				audiodevices[audiodevicecount].inputmappings = NULL;
+				PsychErrorExitMsg(PsychError_user, "Invalid items in 'selectchannels' matrix argument!");				
+			}
+		}
 
-	// specialFlags 16: Never dither audio data:
-	if (specialFlags & 16) sflags |= paDitherOff;
+		if (mode & kPortAudioIsOutputCapture) {
+			// Assign Output Capture mappings:
+			audiodevices[audiodevicecount].inputmappings = malloc(sizeof(int) * mynrchannels[1]);
+			// Index into first row of one-row matrix or 2nd row of two-row matrix:
+			for (i = 0; i < mynrchannels[1]; i++) audiodevices[audiodevicecount].inputmappings[i] = (int) mychannelmap[(i * m) + (m-1)] - 1;
 
-	// Try to create & open stream:
-	err = Pa_OpenStream(
-            &stream,															/* Return stream pointer here on success. */
-            ((mode & kPortAudioCapture) ?  &inputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
-			((mode & kPortAudioPlayBack) ? &outputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
-            freq,																/* Requested sampling rate. */
-            buffersize,															/* Requested buffer size. */
-            sflags,																/* Define special stream property flags. */
-            paCallback,															/* Our processing callback. */
-            &audiodevices[audiodevicecount]);									/* Our own device info structure */
-            
-	if(err!=paNoError || stream == NULL) {
-			printf("PTB-ERROR: Failed to open audio device %i. PortAudio reports this error: %s \n", audiodevicecount, Pa_GetErrorText(err));
-			PsychErrorExitMsg(PsychError_system, "Failed to open PortAudio audio device.");
+			if (verbosity > 4) {
+				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound capture from audio output stream %i:\n", audiodevicecount); 
+				for (i=0; i < mynrchannels[1]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1);
+				printf("\n\n");
+			}
+
+			// Revalidate:
+			for (i = 0; i < mynrchannels[1]; i++) if (audiodevices[audiodevicecount].inputmappings[i] < 0 || audiodevices[audiodevicecount].inputmappings[i] >= audiodevices[pamaster].outchannels) {
+				printf("PTB-ERROR: Slot %i of capture channel selection list contains invalid master device channel id %i [Valid between 1 and %i]!\n", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1, audiodevices[pamaster].outchannels);
+				free(audiodevices[audiodevicecount].inputmappings);
+				audiodevices[audiodevicecount].inputmappings = NULL;
+				PsychErrorExitMsg(PsychError_user, "Invalid items in 'selectchannels' matrix argument!");				
+			}
+		}
+
+	}
+	else {
+		// No channelmap provided: Assign one that identity-maps all master device channels:
+		if (mode & kPortAudioPlayBack) {
+			// Assign playback mappings:
+			audiodevices[audiodevicecount].outputmappings = malloc(sizeof(int) * mynrchannels[0]);
+			for (i = 0; i < mynrchannels[0]; i++) audiodevices[audiodevicecount].outputmappings[i] = i;
+
+			if (verbosity > 4) {
+				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound output to audio stream %i:\n", audiodevicecount); 
+				for (i=0; i < mynrchannels[0]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].outputmappings[i]+1);
+				printf("\n\n");
+			}
+		}
+		
+		if (mode & kPortAudioCapture) {
+			// Assign Capture mappings:
+			audiodevices[audiodevicecount].inputmappings = malloc(sizeof(int) * mynrchannels[1]);
+			// Index into first row of one-row matrix or 2nd row of two-row matrix:
+			for (i = 0; i < mynrchannels[1]; i++) audiodevices[audiodevicecount].inputmappings[i] = i;
+
+			if (verbosity > 4) {
+				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound capture from audio stream %i:\n", audiodevicecount); 
+				for (i=0; i < mynrchannels[1]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].inputmappings[i]+1);
+				printf("\n\n");
+			}
+		}	
 	}
-	
-	// Setup our final device structure:
+
+	// Setup our final device structure. Mostly settings from the master device, with
+	// a few settings specific to the slave:
 	audiodevices[audiodevicecount].opmode = mode;
-	audiodevices[audiodevicecount].runMode = 1; // Keep engine running by default. Minimal extra cpu-load for significant reduction in startup latency.
-	audiodevices[audiodevicecount].stream = stream;
-	audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(stream);
-	audiodevices[audiodevicecount].hostAPI = Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type;
+	audiodevices[audiodevicecount].runMode = 1;
+	audiodevices[audiodevicecount].stream = audiodevices[pamaster].stream;
+	audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(audiodevices[pamaster].stream);
+	audiodevices[audiodevicecount].hostAPI = audiodevices[pamaster].hostAPI;
 	audiodevices[audiodevicecount].startTime = 0.0;
 	audiodevices[audiodevicecount].reqStartTime = 0.0;
 	audiodevices[audiodevicecount].reqStopTime = DBL_MAX;
@@ -2378,43 +4743,63 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	audiodevices[audiodevicecount].schedule_size = 0;
 	audiodevices[audiodevicecount].schedule_pos = 0;
 	audiodevices[audiodevicecount].schedule_writepos = 0;
-	audiodevices[audiodevicecount].outdeviceidx = (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) ? outputParameters.device : -1;
-	audiodevices[audiodevicecount].indeviceidx  = (audiodevices[audiodevicecount].opmode & kPortAudioCapture)  ? inputParameters.device  : -1;
-	audiodevices[audiodevicecount].outputmappings = NULL;
-	audiodevices[audiodevicecount].inputmappings = NULL;
+	audiodevices[audiodevicecount].outdeviceidx = audiodevices[pamaster].outdeviceidx;
+	audiodevices[audiodevicecount].indeviceidx  = audiodevices[pamaster].indeviceidx;
 	audiodevices[audiodevicecount].slaveCount = 0;
+	audiodevices[audiodevicecount].slavesProcessed = 0;
 	audiodevices[audiodevicecount].slaves = NULL;
 	audiodevices[audiodevicecount].pamaster = -1;
-	audiodevices[audiodevicecount].modulatorSlave = -1;
+	audiodevices[audiodevicecount].modulatorSlave = -1;	
 	audiodevices[audiodevicecount].slaveOutBuffer = NULL;
 	audiodevices[audiodevicecount].slaveGainBuffer = NULL;
 	audiodevices[audiodevicecount].slaveInBuffer = NULL;
-	audiodevices[audiodevicecount].outChannelVolumes = NULL;
+	audiodevices[audiodevicecount].workerThreads = NULL;
+	audiodevices[audiodevicecount].workerCount = 0;
+	audiodevices[audiodevicecount].slaveJobs = NULL;
+	audiodevices[audiodevicecount].workerBufferFrames = 0;
+	audiodevices[audiodevicecount].workerFallback = 0;
+	audiodevices[audiodevicecount].deferScheduleUnref = 0;
+	audiodevices[audiodevicecount].scheduleUnrefPending = 0;
+	audiodevices[audiodevicecount].ringBuffer = NULL;
+	audiodevices[audiodevicecount].ringCapacity = 0;
+	audiodevices[audiodevicecount].ringReadPos = 0;
+	audiodevices[audiodevicecount].ringWritePos = 0;
+	audiodevices[audiodevicecount].ringUnderruns = 0;
+	audiodevices[audiodevicecount].ringUnderrunFrames = 0;
+	audiodevices[audiodevicecount].automation = NULL;
+	audiodevices[audiodevicecount].automationTracks = 0;
+	audiodevices[audiodevicecount].automationMixGains = NULL;
+	audiodevices[audiodevicecount].mixGains = NULL;
+	audiodevices[audiodevicecount].resampler = NULL;
+	audiodevices[audiodevicecount].resampleScratch = NULL;
+	audiodevices[audiodevicecount].resamplePhase = 0;
+	audiodevices[audiodevicecount].outputbufferSampleRate = 0;
+	audiodevices[audiodevicecount].playoutSampleRate = 0;
+	audiodevices[audiodevicecount].outputbufferResampler = NULL;
+	audiodevices[audiodevicecount].playoutResampler = NULL;
+	audiodevices[audiodevicecount].timing = NULL;
+	audiodevices[audiodevicecount].timingEnabled = 0;
+	audiodevices[audiodevicecount].captureWriter = NULL;
+	audiodevices[audiodevicecount].captureFileFrames = 0;
+	audiodevices[audiodevicecount].captureFileOverflows = 0;
+	audiodevices[audiodevicecount].captureFileLostFrames = 0;
 	audiodevices[audiodevicecount].masterVolume = 1.0;
 	audiodevices[audiodevicecount].playposition = 0;
 	audiodevices[audiodevicecount].totalplaycount = 0;
-		
-	// If this is a master, create a slave device list and init it to "empty":
-	if (mode & kPortAudioIsMaster) {
-		audiodevices[audiodevicecount].slaves = (int*) malloc(sizeof(int) * MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE);
-		if (NULL == audiodevices[audiodevicecount].slaves) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient memory during slave devicelist creation!");
-		for (i=0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) audiodevices[audiodevicecount].slaves[i] = -1;
 
-		if (mode & kPortAudioPlayBack) {
-			// Allocate a dummy outputbuffer with one sampleframe:
-			audiodevices[audiodevicecount].outputbuffersize = sizeof(float) * audiodevices[audiodevicecount].outchannels * 1;
-			audiodevices[audiodevicecount].outputbuffer = (float*) malloc(audiodevices[audiodevicecount].outputbuffersize);
-			if (audiodevices[audiodevicecount].outputbuffer==NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate audio buffer.");
-		}
-		
-		if (mode & kPortAudioCapture) {
-			// Allocate a dummy inputbuffer with one sampleframe:
-			audiodevices[audiodevicecount].inputbuffersize = sizeof(float) * audiodevices[audiodevicecount].inchannels * 1;
-			audiodevices[audiodevicecount].inputbuffer = (float*) calloc(1, audiodevices[audiodevicecount].inputbuffersize);
-			if (audiodevices[audiodevicecount].inputbuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Free system memory exhausted when trying to allocate audio recording buffer!");
-		}		
+	// Setup per-channel output volumes for slave: Each channel starts with a 1.0 setting, ie., max volume:
+	if (audiodevices[audiodevicecount].outchannels > 0) {
+		audiodevices[audiodevicecount].outChannelVolumes = (float*) malloc(sizeof(float) * audiodevices[audiodevicecount].outchannels);
+		if (audiodevices[audiodevicecount].outChannelVolumes == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Memory exhausted during audio volume vector allocation.");
+		for (i = 0; i < audiodevices[audiodevicecount].outchannels; i++) audiodevices[audiodevicecount].outChannelVolumes[i] = 1.0;
+	}
+	else {
+		audiodevices[audiodevicecount].outChannelVolumes = NULL;
 	}
 
+	// Mix slave with its per-channel output volumes:
+	audiodevices[audiodevicecount].mixGains = audiodevices[audiodevicecount].outChannelVolumes;
+
 	// If we use locking, we need to initialize the per-device mutex:
 	if (uselocking && PsychInitMutex(&(audiodevices[audiodevicecount].mutex))) {
 		printf("PsychPortAudio: CRITICAL! Failed to initialize Mutex object for pahandle %i! Prepare for trouble!\n", audiodevicecount);
@@ -2424,32 +4809,59 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	// If we use locking, this will create & init the associated event variable:
 	PsychPACreateSignal(&(audiodevices[audiodevicecount]));
 	
-	// Register the stream finished callback:
-	Pa_SetStreamFinishedCallback(audiodevices[audiodevicecount].stream, PAStreamFinishedCallback);
-
-	#if PSYCH_SYSTEM == PSYCH_OSX
-		// Query low-level audio driver of the CoreAudio HAL for hardware latency:
-		// Hmm, maybe not. Don't know if it is worth the hazzle... This is a constant that
-		// doesn't change throughout the lifetime of a machine, and it only makes up for about
-		// 0.3 msecs on a typical setup. Maybe if a user really needs that 0.3 msecs extra
-		// precision, he should simply download the free HALLab from Apple's Website or Developer
-		// tools, run it once, read the displayed constant and set it manually at PortAudio startup.
-		
-		// PaMacCoreStream* corestream = (PaMacCoreStream*) audiodevices[audiodevicecount].stream;
-		// audiodevices[audiodevicecount].latencyBias = 
-	#endif
+	// Assign parent:
+	paparent = pamaster;
 	
-	if (verbosity > 3) {
-		printf("PTB-INFO: New audio device with handle %i opened as PortAudio stream:\n",audiodevicecount);
+	// Remap the meaning of master if we are a modulator for another slave. Our pamaster is actually our parents pamaster:
+	if (mode & kPortAudioIsAMModulatorForSlave) pamaster = audiodevices[paparent].pamaster;
+	
+	// Preallocate our scratch buffers for parallel rendering, if our master uses worker threads. AM modulators
+	// of slaves and output capture slaves are not rendered by worker threads, so they don't need them:
+	if (audiodevices[pamaster].workerThreads && !(mode & (kPortAudioIsAMModulatorForSlave | kPortAudioIsOutputCapture))) {
+		PsychPAAllocSlaveWorkerBuffers(&(audiodevices[pamaster]), &(audiodevices[audiodevicecount]));
+	}
 
-		if (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) {
-			printf("PTB-INFO: For %i channels Playback: Audio subsystem is %s, Audio device name is ", (int) audiodevices[audiodevicecount].outchannels, Pa_GetHostApiInfo(outputDevInfo->hostApi)->name);
-			printf("%s\n", outputDevInfo->name);
+	// Attach us to master device: This needs to be done under master mutex protection.
+	PsychPALockDeviceMutex(&audiodevices[pamaster]);
+
+	// Maximum number of allowable slaves exceeded?
+	if (audiodevices[pamaster].slaveCount >= MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) {
+		// Ouch. Have to abort here:
+		PsychPAUnlockDeviceMutex(&audiodevices[pamaster]);
+		PsychErrorExitMsg(PsychError_user, "Can't attach slave audio device to specified master. Maximum number of allowable slaves for master exceeded!");		
+	}
+
+	// Sufficient space for slaves: Find us the first free slot and attach us:
+	for (i=0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (audiodevices[pamaster].slaves[i] > -1); i++);
+
+	// Attach us to master:
+	audiodevices[pamaster].slaves[i] = audiodevicecount;
+	audiodevices[pamaster].slaveCount++;
+
+	// Attach master to us:
+	audiodevices[audiodevicecount].pamaster = pamaster;
+
+	// If we are a modulator for another slave then attach us as modulator to that slave.
+	// No need to mutex-lock the slave, as that protection is already implied by the masters mutex:
+	if (mode & kPortAudioIsAMModulatorForSlave) audiodevices[paparent].modulatorSlave = audiodevicecount;
+
+	// Attached :-)
+	PsychPAUnlockDeviceMutex(&audiodevices[pamaster]);
+
+	if (verbosity > 4) {
+		printf("PTB-INFO: New virtual audio slave device with handle %i opened and attached to parent device handle %i [master %i].\n", audiodevicecount, paparent, pamaster);
+
+		if (audiodevices[audiodevicecount].opmode & kPortAudioIsAMModulator) {
+			printf("PTB-INFO: For %i channels amplitude modulation.\n", audiodevices[audiodevicecount].outchannels);
+		}
+		else if (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) {
+			printf("PTB-INFO: For %i channels playback.\n", audiodevices[audiodevicecount].outchannels);
 		}
 
-		if (audiodevices[audiodevicecount].opmode & kPortAudioCapture) {
-			printf("PTB-INFO: For %i channels Capture: Audio subsystem is %s, Audio device name is ", (int) audiodevices[audiodevicecount].inchannels, Pa_GetHostApiInfo(inputDevInfo->hostApi)->name);
-			printf("%s\n", inputDevInfo->name);
+		if (audiodevices[audiodevicecount].opmode & kPortAudioIsOutputCapture) {
+			printf("PTB-INFO: For %i channels capture of master output mix.\n", audiodevices[audiodevicecount].inchannels);		
+		} else if (audiodevices[audiodevicecount].opmode & kPortAudioCapture) {
+			printf("PTB-INFO: For %i channels capture.\n", audiodevices[audiodevicecount].inchannels);
 		}
 		
 		printf("PTB-INFO: Real samplerate %f Hz. Input latency %f msecs, Output latency %f msecs.\n",
@@ -2466,1156 +4878,1452 @@ PsychError PSYCHPORTAUDIOOpen(void)
     return(PsychError_none);	
 }
 
-/* PsychPortAudio('OpenSlave') - Open and initialize a virtual audio slave device.
+/* PsychPortAudio('Close') - Close an audio device via PortAudio.
  */
-PsychError PSYCHPORTAUDIOOpenSlave(void) 
+PsychError PSYCHPORTAUDIOClose(void) 
 {
- 	static char useString[] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels]);";
-	//																  1			  2		  3			  4
+ 	static char useString[] = "PsychPortAudio('Close' [, pahandle]);";
 	static char synopsisString[] = 
-		"Open a virtual slave audio device and initialize it. Returns a 'pahandle' device handle for the device.\n"
-		"Slave audio devices are almost always attached to a 'pamaster' audio device that you need to open and initialize "
-		"first via a call to pamaster = PsychPortAudio('Open', ...); The 'pamaster' corresponds to a real soundcard "
-		"present in your system which has been setup for a certain mode of operation, timing mode, frequency etc. "
-		"The exception is if you create an AMModulator slave (see below). It can be attached to another playback "
-		"slave device by passing the handle of that device as 'pamaster'. "
-		"To each real pamaster you can attach multiple slave devices. Each slave represents a subset of the audio channels "
-		"of the pamaster device. Each slave can be used as if it is a real independent soundcard for capture or "
-		"playback with or without its own set of playback buffers, its own schedule and mode of operation, its own "
-		"start and stop times, status etc. Under the hood, the slave device will use the defined subset of channels "
-		"of the master device to achieve this illusion of independent soundcards. Typical usage scenarios would be:\n\n"
-		"* Mixing of independent soundtracks: Create multiple slave devices, one for each soundtrack. Attach all of "
-		"them to the same set of channels on a common master device. Now you can feed each slave with its own soundtrack, "
-		"start, stop and schedule playback of each slave/soundtrack independently. Sound from all active channels of "
-		"all active slaves will be mixed together and output through the channels of the master device.\n\n"
-		"* Independent control of channels: Same as above, but the slaves don't share the same subset of channels "
-		"on the master, but each slave chooses a distinctive subset of channels, therefore no mixing will occur."
-		"\n\n"
-		"'pamaster' is the mandatory pahandle of a master audio device. The master must have been opened via "
-		"PsychPortAudio('Open', ..., mode, ...); with the mode flag value '8' included to define it as a master (see 'Open').\n\n"
-		"'mode' Mode of operation. See help of 'Open' function for valid settings. However, a mode flag of '8' for "
-		"master operation is not allowed for obvious reasons. Also, the given 'mode' flags must be a subset of the "
-		"'mode' set on the master device! E.g., you can't specify a audio capture mode flag if the master device isn't "
-		"enabled for capture as well. As an exception kPortAudioMonitoring mode is allowed to be present on a slave "
-		"while missing on the associated master device.\n"
-		"The slave-only mode flag 32 (kPortAudioIsAMModulator) defines a slave device not as a source of audio data, "
-		"but as a source of amplitude modulation (AM) envelope data. Its samples don't create sound, but gain-modulate "
-		"the sound of other slaves attached to the master to allow precisely timed AM modulation. See the help for "
-		"PsychPortAudio('Volume') for more details about AM.\n\n"
-		"The slave-only mode flag 64 (kPortAudioIsOutputCapture) defines a slave capture device that captures audio "
-		"data from the *output channels* of the master device, i.e., it records the audio stream that is sent to the "
-		"speakers. This may be useful for capturing PsychPortAudio's audio output for documentation or debug purposes.\n\n"
-		"All slave devices share the same settings for latencymode, timing, sampling frequency "
-		"and other low-level tunable parameters, because they operate on the same underlying audio hardware.\n\n"
-		"'channels' Define total number of playback and capture channels to use. See help for 'Open?' for explanation. "
-		"By default, all channels of the master are used.\n\n"
-		"'selectchannels' optional matrix with mappings of logical slave channels to logical master channels: "
-		"selectchannels' is a one row by 'channels' matrix with mappings "
-		"for pure playback or pure capture. For full-duplex mode (playback and capture), 'selectchannels' must be a "
-		"2 rows by max(channels) column matrix. row 1 will define playback channel mappings, whereas row 2 will then "
-		"define capture channel mappings. In any case, the number in the i'th column will define which master device "
-		"channel will be used for playback or capture of the i'th PsychPortAudio channel (the i'th row of your sound "
-		"matrix). Numbering of master device channels starts with one! Example: Both, playback and simultaneous "
-		"recording are requested from a master device which represents a 16 channel soundcard with all 16 channels open. "
-		"If you'd specify 'selectchannels' as [1, 6 ; 12, 14], then playback would happen to master channels one and six, "
-		"sound would be captured from master channels 12 and 14.\n\n";
+		"Close a PortAudio audio device. The optional 'pahandle' is the handle of the device to close. If pahandle "
+		"is omitted, all audio devices will be closed and the driver will shut down.\n";
+	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
+  	
+	int pahandle= -1;
 	
-	static char seeAlsoString[] = "Open Close GetDeviceSettings ";	 
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(1));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgOptional, &pahandle);
+	if (pahandle == -1) {
+		// Full shutdown requested:
+		PsychPortAudioExit();
+	}
+	else {
+		// Close one device:
+		if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+		PsychPACloseStream(pahandle);
+		
+		// All devices down? Shutdown PortAudio if so:
+		if (audiodevicecount == 0) PsychPortAudioExit();
+	}
+	
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('FillBuffer') - Fill audio outputbuffer of a device with data.
+ */
+PsychError PSYCHPORTAUDIOFillAudioBuffer(void) 
+{
+ 	static char useString[] = "[underflow, nextSampleStartIndex, nextSampleETASecs] = PsychPortAudio('FillBuffer', pahandle, bufferdata [, streamingrefill=0][, startIndex=Append]);";
+	//							1		   2					 3												   1		 2			   3					4
+	static char synopsisString[] = 
+		"Fill audio data playback buffer of a PortAudio audio device. 'pahandle' is the handle of the device "
+		"whose buffer is to be filled. 'bufferdata' is usually a matrix with audio data in double() or single() format. Each "
+		"row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
+		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
+		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
+		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
+		"Instead of a matrix, you can also pass in the bufferhandle of an audio buffer as 'bufferdata'. This buffer "
+		"must have been created beforehand via PsychPortAudio('CreateBuffer', ...). Its content must satisfy the "
+		"same constraints as in case of passing a Matlab matrix. The content will be copied from the given buffer "
+		"to the standard audio buffer, so it is safe to delete that source buffer if you want.\n"
+		"'streamingrefill' optional: If set to 1, ask the driver to refill the buffer immediately while playback "
+		"is active. You can think of this as appending the audio data to the audio data already present in the buffer. "
+		"This is useful for streaming playback or for creating live audio feedback loops. However, the current implementation "
+		"doesn't really append the audio data. Instead it replaces already played audio data with your new data. This means "
+		"that if you try to refill more than what has been actually played, this function will wait until enough storage space "
+		"is available. A 'streamingrefill' flag of 2 will always refill immediately, ie., without waiting for sufficient buffer "
+		"space to become available, even if this causes audible artifacts or some sound data to be overwritten. This is useful "
+		"for a few very special audio feedback tricks, only use if you really know what you're doing!\n"
+		"It will also fail if you try to refill more than the total buffer capacity. Default is to not do "
+		"streaming refills, i.e., the buffer is filled in one batch while playback is stopped. Such a refill will also "
+		"reset any playloop setting done via the 'SetLoop' subfunction to the full size of the refilled buffer.\n"
+		"If the 'streamingrefill' flag is non-zero and the optional 'startIndex' argument is provided, then the refilling "
+		"of the buffer will happen at the provided linear sample index 'startIndex'. If the argument is omitted, new data "
+		"will be appended at the end of the current soundbuffers content. The 'startIndex' argument is ignored if no streaming "
+		"refill is requested.\n"
+		"\nOptionally the function returns the following values:\n"
+		"'underflow' A flag: If 1 then the audio buffer underflowed because you didn't refill it in time, ie., some audible "
+		"glitches were present in playback and your further playback timing is screwed.\n"
+		"'nextSampleStartIndex' This is the absolute index in samples since start of playback of the sample that would "
+		"follow after the last sample you added during this 'FillBuffer' call, ie., the first sample during a successive "
+		"'FillBuffer' call.\n"
+		"'nextSampleETASecs' This value is undefined (NaN) if playback isn't running. During a streaming refill, it contains "
+		"the predicted audio onset time in seconds of the sample with index 'nextSampleStartIndex'. Please note that this "
+		"prediction can accumulate a prediction error if your buffer is so large that it contains samples that will only "
+		"playback far in the future.\n";
+
+	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
   	
-	int mode, pamaster, paparent, i, numel;
-	int* nrchannels;
-	int  mynrchannels[2];
-	int  m, n, p;
-	double* mychannelmap;
-	int modeExceptions = 0;
+	PsychPABuffer* inbuffer = NULL;
+	int inbufferhandle = 0;
+	float*  indatafloat = NULL;
+	psych_bool userfloat = FALSE;
+	psych_int64 inchannels, insamples, p;
+	psych_int64 outsamples, offset, chunk, count;
+	size_t buffersize;
+	psych_int64 totalplaycount;
+	double*	indata = NULL;
+	float*  outdata = NULL;
+	int pahandle   = -1;
+	int streamingrefill = 0;
+	int underrun = 0;
+	double currentTime, etaSecs;
+	psych_int64 startIndex = 0;
+	double tBehind = 0.0;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
 	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
 
-	if (audiodevicecount >= MAX_PSYCH_AUDIO_DEVS) PsychErrorExitMsg(PsychError_user, "Maximum number of simultaneously open audio devices exceeded. You need to close some before you can open new ones.");
-	 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	// Request mandatory pamaster device handle:
-	PsychCopyInIntegerArg(1, kPsychArgRequired, &pamaster);
-
-	// Valid device?
-	if (pamaster < 0 || pamaster >= MAX_PSYCH_AUDIO_DEVS || audiodevices[pamaster].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio master device handle 'pamaster' provided. No such master device open!");
-
-	// Request optional mode of operation:
-	if (PsychCopyInIntegerArg(2, kPsychArgOptional, &mode)) {
-		// Mode provided. Validate, but remove potential master flag first:
-		mode = mode & (~kPortAudioIsMaster);
-
-		// Being an AM modulator implies being a playback device, as we use the
-		// whole audio playback scheduling and buffer facilities:
-		if (mode & kPortAudioIsAMModulator) mode |= kPortAudioPlayBack;
-
-		// Being an output capturer implies special rules:
-		if (mode & kPortAudioIsOutputCapture) {
-			// The associated master must have output that we can capture, ie., it must be configured for playback:
-			if (!(audiodevices[pamaster].opmode & kPortAudioPlayBack)) PsychErrorExitMsg(PsychError_user, "Invalid mode: This shall be an output capture device, but master isn't configured for output/playback!");
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
 
-			// We are a capture device:
-			mode |= kPortAudioCapture;
-			
-			// Master doesn't need to be a capture device, as we're capturing its output, not its input:
-			modeExceptions |= kPortAudioCapture;
-		}
+	// Bufferhandle instead of input data matrix provided?
+	if (PsychCopyInIntegerArg(2, kPsychArgAnything, &inbufferhandle) && (inbufferhandle > 0)) {
+		// Seems so. Double check:
+		inbuffer = PsychPAGetAudioBuffer(inbufferhandle);
 		
-		// Is mode a subset of the masters mode as required? One valid exception is kPortAudioMonitoring,
-		// which is allowed to be present on the slave but missing on the master, as well as the AMModulator
-		// mode and output capturer mode:
-		modeExceptions |= kPortAudioMonitoring | kPortAudioIsAMModulator | kPortAudioIsAMModulatorForSlave | kPortAudioIsOutputCapture;
-		if (((mode & ~modeExceptions) & audiodevices[pamaster].opmode) != (mode & ~modeExceptions)) PsychErrorExitMsg(PsychError_user, "Invalid mode provided: Mode flags are not a subset of the mode flags of the pamaster device!");
-		if ((mode < 1) || ((mode & kPortAudioMonitoring) && ((mode & kPortAudioFullDuplex) != kPortAudioFullDuplex))) {
-			PsychErrorExitMsg(PsychError_user, "Invalid mode provided: Outside valid range or invalid combination of flags.");
-		}
+		// Assign properties:
+		inchannels = inbuffer->outchannels;
+		insamples  = inbuffer->outputbuffersize / sizeof(float) / inchannels;
+		p = 1;
+		indatafloat = inbuffer->outputbuffer;
 	}
 	else {
-		// No mode provided: Use settings from pamaster, minus the master flag of course.
-		mode = audiodevices[pamaster].opmode & (~kPortAudioIsMaster);
+		// Regular double matrix with sound data from runtime:
+		if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
+			// Or regular float matrix instead:
+			PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+			userfloat = TRUE;
+		}
+	}
+
+	if (inchannels != audiodevices[pahandle].outchannels) {
+		printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
+		PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
 	}
 	
-	// Mode set and validated: Add the slave flag to mark us as slave device:
-	mode |= kPortAudioIsSlave;
+	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample in your audio buffer!");
+	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
+	
+	// Get optional streaming refill flag:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &streamingrefill);
+	
+	// Full refill or streaming refill?
+	if (streamingrefill <= 0) {
+		// Standard refill with possible buffer reallocation. Engine needs to be
+		// stopped, full reset of engine at refill:
 
-	// Is our 'pamaster' handle an actual master device?
-	if (!(audiodevices[pamaster].opmode & kPortAudioIsMaster)) {
-		// No, it is a slave device itself.
+		// Wait for playback on this stream to finish, before refilling it:
+		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+		while (audiodevices[pahandle].state > 0) {
+			// Wait for a state-change before reevaluating the .state:
+			PsychPAWaitForChange(&audiodevices[pahandle]);
+		}
 		
-		// This is only allowed if we are a modulator device and the target is configured for playback. Error out if this isn't the case:
-		if (!(mode & kPortAudioIsAMModulator) || !(audiodevices[pamaster].opmode & kPortAudioPlayBack)) {
-			PsychErrorExitMsg(PsychError_user, "Provided device handle 'pamaster' is not configured as a master device. Attaching to a slave is only allowed if it is playback capable and this device is configured as an AM modulator!");
+		// Device is idle, we hold the lock. We can safely drop the lock here and still modify
+		// device data, as none of this will get touched by the engine in idle state:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		
+		// Ok, everything sane, fill the buffer:
+		buffersize = sizeof(float) * inchannels * insamples;
+		if (audiodevices[pahandle].outputbuffer && (audiodevices[pahandle].outputbuffersize != buffersize)) {
+			free(audiodevices[pahandle].outputbuffer);
+			audiodevices[pahandle].outputbuffer = NULL;
+			audiodevices[pahandle].outputbuffersize = 0;
 		}
 		
-		// We're a modulator for a slave.
-		mode |= kPortAudioIsAMModulatorForSlave;		
-	}
-
-	// Request optional number of channels:
-	numel = 0; nrchannels = NULL;
-	PsychAllocInIntegerListArg(3, kPsychArgOptional, &numel, &nrchannels);
-	if (numel == 0) {
-		// No optional channelcount argument provided: Default to pamaster settings:
-		mynrchannels[0] = audiodevices[pamaster].outchannels;
-		mynrchannels[1] = audiodevices[pamaster].inchannels;
-		if (mode & kPortAudioIsOutputCapture) mynrchannels[1] = audiodevices[pamaster].outchannels;
-	}
-	else if (numel == 1) {
-		// One argument provided: Set same count for playback and recording:
-		if (*nrchannels < 1 || *nrchannels > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. Valid values are 1 to device maximum.");
-		if (*nrchannels > audiodevices[pamaster].outchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. More output channels than pamaster device.");
-		if (*nrchannels > audiodevices[pamaster].inchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of channels provided. More input channels than pamaster device.");
+		if (audiodevices[pahandle].outputbuffer == NULL) {
+			audiodevices[pahandle].outputbuffersize = buffersize;
+			audiodevices[pahandle].outputbuffer = (float*) malloc(buffersize);
+			if (audiodevices[pahandle].outputbuffer==NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate audio buffer.");
+		}
+		
+		// Reset play position:
+		audiodevices[pahandle].playposition = 0;
+		audiodevices[pahandle].resamplePhase = 0;
 
-		mynrchannels[0] = *nrchannels;
-		mynrchannels[1] = *nrchannels;		
-	}
-	else if (numel == 2) {
-		// Separate counts for playback and recording provided: Set'em up.
-		if (nrchannels[0] < 1 || nrchannels[0] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE || nrchannels[0] > audiodevices[pamaster].outchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of playback channels provided. Valid values are 1 to number of output channels on pamaster device.");
-		mynrchannels[0] = nrchannels[0];
-		if (mode & kPortAudioIsOutputCapture) {
-			// Output capture device:
-			if (nrchannels[1] < 1 || nrchannels[1] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE || nrchannels[1] > audiodevices[pamaster].outchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of capture channels provided. Valid values are 1 to number of output channels on pamaster device.");
-			mynrchannels[1] = nrchannels[1];
+		// Buffer with an assigned sample rate as source? Then the standard buffer inherits its rate:
+		if (inbuffer && (inbuffer->sampleRate > 0)) audiodevices[pahandle].outputbufferSampleRate = inbuffer->sampleRate;
+		audiodevices[pahandle].outputbufferResampler = PsychPAGetResamplerBankForRate(&audiodevices[pahandle], audiodevices[pahandle].outputbufferSampleRate);
+		
+		outdata = audiodevices[pahandle].outputbuffer;
+		if (indata || userfloat) {
+			// Copy the data, convert it from double or single to float:
+			PsychPACopyInSamples(outdata, indata, indatafloat, inchannels * insamples);
 		}
 		else {
-			// Regular capture device:
-			if (nrchannels[1] < 1 || nrchannels[1] > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE || nrchannels[1] > audiodevices[pamaster].inchannels) PsychErrorExitMsg(PsychError_user, "Invalid number of capture channels provided. Valid values are 1 to number of capture channels on pamaster device.");
-			mynrchannels[1] = nrchannels[1];
+			// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
+			memcpy(outdata, indatafloat, buffersize);
 		}
+		
+		// Reset write position to end of buffer:
+		audiodevices[pahandle].writeposition = (psych_int64) inchannels * insamples;
+		
+		// Elapsed count of played out samples must be zero as engine is stopped and will restart sometime after this call:
+		totalplaycount = 0;
+		
+		// Current playout time undefined when playback is stopped:
+		currentTime = PsychGetNanValue();
+		
+		// Reset playback loop to full buffer:
+		audiodevices[pahandle].loopStartFrame = 0;
+		audiodevices[pahandle].loopEndFrame = (audiodevices[pahandle].outputbuffersize / sizeof(float) / audiodevices[pahandle].outchannels) - 1;
 	}
 	else {
-		// More than 2 channel counts provided? Impossible.
-		PsychErrorExitMsg(PsychError_user, "You specified a list with more than two 'channels' entries? Can only be max 2 for playback- and capture.");
-	}
-
-	// Make sure that number of capture and playback channels is the same for fast monitoring/feedback mode:
-	if ((mode & kPortAudioMonitoring) && (mynrchannels[0] != mynrchannels[1])) PsychErrorExitMsg(PsychError_user, "Fast monitoring/feedback mode selected, but number of capture and playback channels differs! They must be the same for this mode!");
+		// Streaming refill while playback is running:
 
-	// Get optional channel map:	
-	audiodevices[audiodevicecount].outputmappings = NULL;
-	audiodevices[audiodevicecount].inputmappings = NULL;
-	mychannelmap = NULL;
-	PsychAllocInDoubleMatArg(4, kPsychArgOptional, &m, &n, &p, &mychannelmap);
-	
-	if (mychannelmap) {
-		// Channelmapping provided: Sanity check it.
-		if (m<1 || m>2 || p!=1 || (n!=((mynrchannels[0] > mynrchannels[1]) ? mynrchannels[0] : mynrchannels[1]))) {
-			PsychErrorExitMsg(PsychError_user, "Invalid size of 'selectchannels' matrix argument: Must be a one- or two row by max(channels) column matrix!");
+		// Get optional startIndex for new writePosition, if any:
+		if (PsychCopyInIntegerArg64(4, kPsychArgOptional, &startIndex)) {
+			// New writePosition provided:
+			if (startIndex < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startIndex' provided. Must be greater or equal to zero.");
+			
+			// Set writePosition to given startIndex: We can do this without lock held, because writeposition is only
+			// touched by us, ie., the main thread, but never by one of the PortAudio threads:
+			audiodevices[pahandle].writeposition = (psych_int64) inchannels * (psych_int64) startIndex;
 		}
 		
-		// Basic check ok. Build mapping structure:
-		if (mode & kPortAudioPlayBack) {
-			// Assign playback mappings:
-			audiodevices[audiodevicecount].outputmappings = malloc(sizeof(int) * mynrchannels[0]);
-			for (i = 0; i < mynrchannels[0]; i++) audiodevices[audiodevicecount].outputmappings[i] = (int) mychannelmap[i * m] - 1;
+		// Engine stopped? [No need to mutex-lock, as engine can't change from state 0 to other state without our intervention]
+		if (audiodevices[pahandle].state == 0) PsychErrorExitMsg(PsychError_user, "Audiodevice not in playback mode! Can't do a streaming buffer refill while stopped.");
 
-			if (verbosity > 4) {
-				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound output to audio stream %i:\n", audiodevicecount); 
-				for (i=0; i < mynrchannels[0]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].outputmappings[i] + 1);
-				printf("\n\n");
+		// No buffer allocated? [No need to mutex-lock, see above]
+		if (audiodevices[pahandle].outputbuffer == NULL) PsychErrorExitMsg(PsychError_user, "No audio buffer allocated! You must call this method once before start of playback to initially allocate a buffer of sufficient size.");
+
+		// Buffer of sufficient size for a streaming refill of this amount?
+		buffersize = sizeof(float) * (psych_int64) inchannels * (psych_int64) insamples;
+		if (audiodevices[pahandle].outputbuffersize < buffersize) PsychErrorExitMsg(PsychError_user, "Total capacity of audio buffer is too small for a refill of this size! Allocate an initial buffer of at least the size of the biggest refill.");
+
+		// Need to lock b'cause of 'playposition':
+		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+		// Check for buffer underrun:
+		if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
+			underrun = 1;
+			tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
+		}
+
+		// Boundary conditions met. Can we refill immediately or do we need to wait for playback
+		// position to progress far enough? We skip this test if the streamingrefill flag is > 1:
+		while ((streamingrefill < 2) && (audiodevices[pahandle].state > 0) && (!underrun) && (((audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float)) - (audiodevices[pahandle].writeposition - audiodevices[pahandle].playposition) - (psych_int64) inchannels) <= (inchannels * insamples))) {
+			// Sleep a bit, drop the lock throughout sleep:
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+			// TODO: We could do better here by predicting how long it will take at least until we're ready to refill,
+			// but a perfect solution would require quite a bit of effort... ...Something for a really boring afternoon.
+			PsychYieldIntervalSeconds(yieldInterval);
+			PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+			// Recheck for buffer underrun:
+			if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
+				underrun = 1;
+				tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
 			}
+		}
 
-			// Revalidate:
-			for (i = 0; i < mynrchannels[0]; i++) if (audiodevices[audiodevicecount].outputmappings[i] < 0 || audiodevices[audiodevicecount].outputmappings[i] >= audiodevices[pamaster].outchannels) {
-				printf("PTB-ERROR: Slot %i of output channel selection list contains invalid master device channel id %i [Valid between 1 and %i]!\n", i+1, audiodevices[audiodevicecount].outputmappings[i] + 1, audiodevices[pamaster].outchannels);
-				free(audiodevices[audiodevicecount].outputmappings);
-				audiodevices[audiodevicecount].outputmappings = NULL;
-				PsychErrorExitMsg(PsychError_user, "Invalid items in 'selectchannels' matrix argument!");				
+		// Exit with lock held...
+		
+		// Have we left the while-loop because the engine stopped? In that case we won't
+		// be able to ever get the needed headroom and need to error-out:
+		if (audiodevices[pahandle].state == 0) {
+			// Ohoh...
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
+			PsychErrorExitMsg(PsychError_user, "Audiodevice no longer in playback mode (Auto stopped?!?)! Can't continue a streaming buffer refill while stopped. Check your code!");
+		}
+		
+		// Ok, device locked and enough headroom for batch streaming refill:
+		
+		// Copy the data, convert it from double or single to float, take ringbuffer wraparound into account.
+		// We copy in at most two contiguous chunks, one up to the end of the ringbuffer, one from its start:
+		outsamples = audiodevices[pahandle].outputbuffersize / sizeof(float);
+		count = (psych_int64) (buffersize / sizeof(float));
+		while (count > 0) {
+			// Offset of write position in ringbuffer and size of contiguous chunk until wraparound:
+			offset = audiodevices[pahandle].writeposition % outsamples;
+			chunk = (count < outsamples - offset) ? count : outsamples - offset;
+
+			if (indata || userfloat) {
+				PsychPACopyInSamples(&(audiodevices[pahandle].outputbuffer[offset]), indata, indatafloat, chunk);
+				if (indata) indata += chunk; else indatafloat += chunk;
+			}
+			else {
+				// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
+				memcpy(&(audiodevices[pahandle].outputbuffer[offset]), indatafloat, (size_t) chunk * sizeof(float));
+				indatafloat += chunk;
 			}
+
+			// Update sample write counter:
+			audiodevices[pahandle].writeposition += chunk;
+
+			// Decrement copy counter:
+			count -= chunk;
 		}
 		
-		if ((mode & kPortAudioCapture) && !(mode & kPortAudioIsOutputCapture)) {
-			// Assign Capture mappings:
-			audiodevices[audiodevicecount].inputmappings = malloc(sizeof(int) * mynrchannels[1]);
-			// Index into first row of one-row matrix or 2nd row of two-row matrix:
-			for (i = 0; i < mynrchannels[1]; i++) audiodevices[audiodevicecount].inputmappings[i] = (int) mychannelmap[(i * m) + (m-1)] - 1;
+		// Retrieve total count of played out samples from engine:
+		totalplaycount = audiodevices[pahandle].totalplaycount;
 
-			if (verbosity > 4) {
-				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound capture from audio stream %i:\n", audiodevicecount); 
-				for (i=0; i < mynrchannels[1]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1);
-				printf("\n\n");
-			}
+		// Retrieve corresponding timestamp of last playout:
+		currentTime = audiodevices[pahandle].currentTime;
+		
+		// Check for buffer underrun:
+		if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
+			underrun = 1;
+			tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
+		}
+		
+		// Drop lock here, no longer needed:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
 
-			// Revalidate:
-			for (i = 0; i < mynrchannels[1]; i++) if (audiodevices[audiodevicecount].inputmappings[i] < 0 || audiodevices[audiodevicecount].inputmappings[i] >= audiodevices[pamaster].inchannels) {
-				printf("PTB-ERROR: Slot %i of capture channel selection list contains invalid master device channel id %i [Valid between 1 and %i]!\n", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1, audiodevices[pamaster].inchannels);
-				free(audiodevices[audiodevicecount].inputmappings);
-				audiodevices[audiodevicecount].inputmappings = NULL;
-				PsychErrorExitMsg(PsychError_user, "Invalid items in 'selectchannels' matrix argument!");				
-			}
+		if ((underrun > 0) && (verbosity > 1)) {
+			printf("PsychPortAudio-WARNING: Underrun of audio playback buffer detected during streaming refill at approximate play position %f secs [%f msecs behind]. Sound will be skipped, timing may be wrong and audible glitches may occur!\n",
+					((double) audiodevices[pahandle].playposition / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate)) , tBehind / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate) * 1000.0);
 		}
+	}
 
-		if (mode & kPortAudioIsOutputCapture) {
-			// Assign Output Capture mappings:
-			audiodevices[audiodevicecount].inputmappings = malloc(sizeof(int) * mynrchannels[1]);
-			// Index into first row of one-row matrix or 2nd row of two-row matrix:
-			for (i = 0; i < mynrchannels[1]; i++) audiodevices[audiodevicecount].inputmappings[i] = (int) mychannelmap[(i * m) + (m-1)] - 1;
+	// Copy out underrun flag:
+	PsychCopyOutDoubleArg(1, FALSE, (double) underrun);
+	
+	// Copy out number of submitted sample frames, aka the absolute sample frame startindex for next 'Fillbuffer' call.
+	PsychCopyOutDoubleArg(2, FALSE, (double) audiodevices[pahandle].writeposition / (double) audiodevices[pahandle].outchannels);
+	
+	// Compute and return predicted estimated time of arrival for playout of first sample for next 'FillBuffer' call, aka almost of the last sample in this 'FillBuffer' call:
+	etaSecs = currentTime + ((((double) audiodevices[pahandle].writeposition - (double) totalplaycount) / (double) audiodevices[pahandle].outchannels) / (double) audiodevices[pahandle].streaminfo->sampleRate);
+	PsychCopyOutDoubleArg(3, FALSE, etaSecs);
+	
+	// Buffer ready.
+	return(PsychError_none);
+}
 
-			if (verbosity > 4) {
-				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound capture from audio output stream %i:\n", audiodevicecount); 
-				for (i=0; i < mynrchannels[1]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1);
-				printf("\n\n");
-			}
+/* PsychPortAudio('RefillBuffer') - Refill existing audio outputbuffer of a device with data.
+ */
+PsychError PSYCHPORTAUDIORefillBuffer(void) 
+{
+ 	static char useString[] = "PsychPortAudio('RefillBuffer', pahandle [, bufferhandle=0], bufferdata [, startIndex=0]);";
+	static char synopsisString[] = 
+		"Refill part of an audio data playback buffer of a PortAudio audio device. 'pahandle' is the handle of the device "
+		"whose buffer is to be filled. 'bufferhandle' is the handle of the buffer: Use a handle of zero for the standard "
+		"buffer created and accessed via 'FillBuffer'. 'bufferdata' is a matrix with audio data in double() or single() "
+		"format. Each row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
+		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
+		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
+		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
+		"Instead of a matrix, you can also pass in the bufferhandle of an audio buffer as 'bufferdata'. This buffer "
+		"must have been created beforehand via PsychPortAudio('CreateBuffer', ...). Its content must satisfy the "
+		"same constraints as in case of passing a Matlab matrix. The content will be copied from the given buffer "
+		"to the standard audio buffer, so it is safe to delete that source buffer if you want.\n"		
+		"'startIndex' optional: Defines the first sample frame within the buffer where refill should start. "
+		"By default, refilling starts at the beginning of the buffer - at sample frame 0. 'startIndex' allows to "
+		"start refilling at some offset.\n"
+		"Please note that 'RefillBuffer' can't resize an existing buffer - you can't fill in more data than the "
+		"current buffer capacity permits. If you want to add more sound, you'll need to use 'FillBuffer' or "
+		"create a new buffer of proper capacity.\n"
+		"'RefillBuffer' can be used any time on a buffer, even if the buffer is currently playing, allowing for "
+		"on-the-fly replacement of content. However be careful to avoid the currently played section, or you'll "
+		"hear audio artifacts. For streaming out audio content in a glitch-free way, you may want to use the "
+		"'streamingrefill' option of the 'FillBuffer' subfunction instead.\n";
 
-			// Revalidate:
-			for (i = 0; i < mynrchannels[1]; i++) if (audiodevices[audiodevicecount].inputmappings[i] < 0 || audiodevices[audiodevicecount].inputmappings[i] >= audiodevices[pamaster].outchannels) {
-				printf("PTB-ERROR: Slot %i of capture channel selection list contains invalid master device channel id %i [Valid between 1 and %i]!\n", i+1, audiodevices[audiodevicecount].inputmappings[i] + 1, audiodevices[pamaster].outchannels);
-				free(audiodevices[audiodevicecount].inputmappings);
-				audiodevices[audiodevicecount].inputmappings = NULL;
-				PsychErrorExitMsg(PsychError_user, "Invalid items in 'selectchannels' matrix argument!");				
-			}
+	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
+  	
+	PsychPABuffer* buffer;
+	PsychPABuffer* inbuffer;
+	
+	psych_int64 inchannels, insamples, p;
+	size_t buffersize, outbuffersize;
+	double*	indata = NULL;
+	int inbufferhandle = 0;
+	float*  indatafloat = NULL;
+	psych_bool userfloat = FALSE;
+	float*  outdata = NULL;
+	int pahandle   = -1;
+	int bufferhandle = 0;
+	psych_int64 startIndex = 0;
+	
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(3)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
+
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &bufferhandle);
+	// Check for valid bufferhandle:
+	if (bufferhandle < 0) PsychErrorExitMsg(PsychError_user, "Invalid audio 'bufferhandle' provided.");
+
+	// If it is a non-zero handle, try to dereference from dynamic buffer:
+	if (bufferhandle > 0) {
+		// Deref bufferHandle: Issue error if no buffer with such a handle exists:
+		buffer = PsychPAGetAudioBuffer(bufferhandle);
+		
+		// Validate matching output channel count:
+		if (buffer->outchannels != audiodevices[pahandle].outchannels) {
+			printf("PsychPortAudio-ERROR: Audio channel count %i of audiobuffer with handle %i doesn't match channel count %i of audio device!\n", buffer->outchannels, bufferhandle, audiodevices[pahandle].outchannels);
+			PsychErrorExitMsg(PsychError_user, "Target audio buffer 'bufferHandle' has an audio channel count that doesn't match channels of audio device!");
 		}
+	}
 
+	// Bufferhandle instead of input data matrix provided?
+	if (PsychCopyInIntegerArg(3, kPsychArgAnything, &inbufferhandle) && (inbufferhandle > 0)) {
+		// Seems so. Double check:
+		inbuffer = PsychPAGetAudioBuffer(inbufferhandle);
+		
+		// Assign properties:
+		inchannels = inbuffer->outchannels;
+		insamples = inbuffer->outputbuffersize / sizeof(float) / inchannels;
+		p = 1;
+		indatafloat = inbuffer->outputbuffer;
 	}
 	else {
-		// No channelmap provided: Assign one that identity-maps all master device channels:
-		if (mode & kPortAudioPlayBack) {
-			// Assign playback mappings:
-			audiodevices[audiodevicecount].outputmappings = malloc(sizeof(int) * mynrchannels[0]);
-			for (i = 0; i < mynrchannels[0]; i++) audiodevices[audiodevicecount].outputmappings[i] = i;
-
-			if (verbosity > 4) {
-				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound output to audio stream %i:\n", audiodevicecount); 
-				for (i=0; i < mynrchannels[0]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].outputmappings[i]+1);
-				printf("\n\n");
-			}
+		// Regular double matrix with sound data from runtime:
+		if (!PsychAllocInDoubleMatArg64(3, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
+			// Or regular float matrix instead:
+			PsychAllocInFloatMatArg64(3, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+			userfloat = TRUE;
 		}
-		
-		if (mode & kPortAudioCapture) {
-			// Assign Capture mappings:
-			audiodevices[audiodevicecount].inputmappings = malloc(sizeof(int) * mynrchannels[1]);
-			// Index into first row of one-row matrix or 2nd row of two-row matrix:
-			for (i = 0; i < mynrchannels[1]; i++) audiodevices[audiodevicecount].inputmappings[i] = i;
-
-			if (verbosity > 4) {
-				printf("PTB-INFO: Will use the following logical slave-channel -> master-channel mappings for sound capture from audio stream %i:\n", audiodevicecount); 
-				for (i=0; i < mynrchannels[1]; i++) printf("%i --> %i : ", i+1, audiodevices[audiodevicecount].inputmappings[i]+1);
-				printf("\n\n");
-			}
-		}	
 	}
+	
+	if (inchannels != audiodevices[pahandle].outchannels) {
+		printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
+		PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
+	}
+	
+	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample for refill of your audio buffer!");
+	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
+	
+	// Get optional startIndex:
+	PsychCopyInIntegerArg64(4, kPsychArgOptional, &startIndex);
+	if (startIndex < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startIndex' provided. Must be greater or equal to zero.");
 
-	// Setup our final device structure. Mostly settings from the master device, with
-	// a few settings specific to the slave:
-	audiodevices[audiodevicecount].opmode = mode;
-	audiodevices[audiodevicecount].runMode = 1;
-	audiodevices[audiodevicecount].stream = audiodevices[pamaster].stream;
-	audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(audiodevices[pamaster].stream);
-	audiodevices[audiodevicecount].hostAPI = audiodevices[pamaster].hostAPI;
-	audiodevices[audiodevicecount].startTime = 0.0;
-	audiodevices[audiodevicecount].reqStartTime = 0.0;
-	audiodevices[audiodevicecount].reqStopTime = DBL_MAX;
-	audiodevices[audiodevicecount].estStopTime = 0;
-	audiodevices[audiodevicecount].currentTime = 0;		
-	audiodevices[audiodevicecount].state = 0;
-	audiodevices[audiodevicecount].reqstate = 255;
-	audiodevices[audiodevicecount].repeatCount = 1;
-	audiodevices[audiodevicecount].outputbuffer = NULL;
-	audiodevices[audiodevicecount].outputbuffersize = 0;
-	audiodevices[audiodevicecount].inputbuffer = NULL;
-	audiodevices[audiodevicecount].inputbuffersize = 0;
-	audiodevices[audiodevicecount].outchannels = mynrchannels[0];
-	audiodevices[audiodevicecount].inchannels = mynrchannels[1];
-	audiodevices[audiodevicecount].latencyBias = 0.0;
-	audiodevices[audiodevicecount].schedule = NULL;
-	audiodevices[audiodevicecount].schedule_size = 0;
-	audiodevices[audiodevicecount].schedule_pos = 0;
-	audiodevices[audiodevicecount].schedule_writepos = 0;
-	audiodevices[audiodevicecount].outdeviceidx = audiodevices[pamaster].outdeviceidx;
-	audiodevices[audiodevicecount].indeviceidx  = audiodevices[pamaster].indeviceidx;
-	audiodevices[audiodevicecount].slaveCount = 0;
-	audiodevices[audiodevicecount].slaves = NULL;
-	audiodevices[audiodevicecount].pamaster = -1;
-	audiodevices[audiodevicecount].modulatorSlave = -1;	
-	audiodevices[audiodevicecount].slaveOutBuffer = NULL;
-	audiodevices[audiodevicecount].slaveGainBuffer = NULL;
-	audiodevices[audiodevicecount].slaveInBuffer = NULL;
-	audiodevices[audiodevicecount].masterVolume = 1.0;
-	audiodevices[audiodevicecount].playposition = 0;
-	audiodevices[audiodevicecount].totalplaycount = 0;
+	// Assign bufferpointer based on bufferhandle:
+	if (bufferhandle > 0) {
+		// Generic buffer:
+		outdata = buffer->outputbuffer;
+		outbuffersize = buffer->outputbuffersize;
+	}
+	else {
+		// Standard playout buffer:
+		outdata = audiodevices[pahandle].outputbuffer;
+		outbuffersize = audiodevices[pahandle].outputbuffersize;
+	}
 
-	// Setup per-channel output volumes for slave: Each channel starts with a 1.0 setting, ie., max volume:
-	if (audiodevices[audiodevicecount].outchannels > 0) {
-		audiodevices[audiodevicecount].outChannelVolumes = (float*) malloc(sizeof(float) * audiodevices[audiodevicecount].outchannels);
-		if (audiodevices[audiodevicecount].outChannelVolumes == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Memory exhausted during audio volume vector allocation.");
-		for (i = 0; i < audiodevices[audiodevicecount].outchannels; i++) audiodevices[audiodevicecount].outChannelVolumes[i] = 1.0;
+	// Buffer exists?
+	if (outdata == NULL) PsychErrorExitMsg(PsychError_user, "No such buffer with given 'bufferhandle', or buffer not yet created!");
+	
+	// Compute required buffersize for copying all data from given startIndex:
+	buffersize = sizeof(float) * (size_t) inchannels * ((size_t) insamples + (size_t) startIndex);
+	
+	// Buffer of sufficient size?
+	if (buffersize > outbuffersize) {
+		// Nope, too small: Adapt 'buffersize' to allowable maximum amount:
+		if (verbosity > 1) printf("PsychPortAudio: WARNING: In 'RefillBuffer' for bufferhandle %i at startindex %i: Insufficient\nbuffersize %i for %i new audioframes starting at given startindex.\nWill truncate to maximum possible.\n", bufferhandle, (int) startIndex, (int) (outbuffersize / (sizeof(float) * inchannels)), (int) insamples);
+		buffersize = outbuffersize;
+		buffersize -= sizeof(float) * (size_t) inchannels * (size_t) startIndex;
 	}
 	else {
-		audiodevices[audiodevicecount].outChannelVolumes = NULL;
-	}
-
-	// If we use locking, we need to initialize the per-device mutex:
-	if (uselocking && PsychInitMutex(&(audiodevices[audiodevicecount].mutex))) {
-		printf("PsychPortAudio: CRITICAL! Failed to initialize Mutex object for pahandle %i! Prepare for trouble!\n", audiodevicecount);
-		PsychErrorExitMsg(PsychError_system, "Audio device mutex creation failed!");
+		// Big enough:
+		buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
 	}
 	
-	// If we use locking, this will create & init the associated event variable:
-	PsychPACreateSignal(&(audiodevices[audiodevicecount]));
-	
-	// Assign parent:
-	paparent = pamaster;
-	
-	// Remap the meaning of master if we are a modulator for another slave. Our pamaster is actually our parents pamaster:
-	if (mode & kPortAudioIsAMModulatorForSlave) pamaster = audiodevices[paparent].pamaster;
+	// Map startIndex to offset in buffer:
+	outdata += (size_t) inchannels * (size_t) startIndex;
 	
-	// Attach us to master device: This needs to be done under master mutex protection.
-	PsychPALockDeviceMutex(&audiodevices[pamaster]);
+	// Ok, everything sane, fill the buffer: 'buffersize' iterations into 'outdata':
+	//fprintf(stderr, "buffersize = %i\n", buffersize);
 
-	// Maximum number of allowable slaves exceeded?
-	if (audiodevices[pamaster].slaveCount >= MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) {
-		// Ouch. Have to abort here:
-		PsychPAUnlockDeviceMutex(&audiodevices[pamaster]);
-		PsychErrorExitMsg(PsychError_user, "Can't attach slave audio device to specified master. Maximum number of allowable slaves for master exceeded!");		
+	if (indata || userfloat) {
+		// Copy the data, convert it from double or single to float:
+		PsychPACopyInSamples(outdata, indata, indatafloat, (psych_int64) (buffersize / sizeof(float)));
+	}
+	else {
+		// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
+		memcpy(outdata, indatafloat, buffersize);
 	}
 
-	// Sufficient space for slaves: Find us the first free slot and attach us:
-	for (i=0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (audiodevices[pamaster].slaves[i] > -1); i++);
-
-	// Attach us to master:
-	audiodevices[pamaster].slaves[i] = audiodevicecount;
-	audiodevices[pamaster].slaveCount++;
+	// Done.
+	return(PsychError_none);
+}
 
-	// Attach master to us:
-	audiodevices[audiodevicecount].pamaster = pamaster;
+/* PsychPortAudio('DeleteBuffer') - Delete a dynamic audio outputbuffer.
+ */
+PsychError PSYCHPORTAUDIODeleteBuffer(void) 
+{
+ 	static char useString[] = "result = PsychPortAudio('DeleteBuffer'[, bufferhandle] [, waitmode]);";
+	static char synopsisString[] = 
+		"Delete an existing dynamic audio data playback buffer.\n"
+		"'bufferhandle' is the handle for the buffer to delete. If it is omitted, all "
+		"buffers will be deleted. 'waitmode' defines what happens if a buffer shall be "
+		"deleted that is currently in use, i.e., part of the audio playback schedule "
+		"of an active audio device. The default of zero will simply return without deleting "
+		"the buffer. A setting of 1 will wait until the buffer can be safely deleted.\n"
+		"The memory of deleted buffers is kept for reuse by new buffers of similar size, up to a total "
+		"of 256 MB, so creating and deleting many buffers, e.g., one per trial, is cheap. Deleting all "
+		"buffers by omitting 'bufferhandle' releases all memory.\n";
 
-	// If we are a modulator for another slave then attach us as modulator to that slave.
-	// No need to mutex-lock the slave, as that protection is already implied by the masters mutex:
-	if (mode & kPortAudioIsAMModulatorForSlave) audiodevices[paparent].modulatorSlave = audiodevicecount;
+	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
+  	
+	int bufferhandle = 0;
+	int waitmode = 0;
+	int rc = 0;
+	
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
-	// Attached :-)
-	PsychPAUnlockDeviceMutex(&audiodevices[pamaster]);
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
 
-	if (verbosity > 4) {
-		printf("PTB-INFO: New virtual audio slave device with handle %i opened and attached to parent device handle %i [master %i].\n", audiodevicecount, paparent, pamaster);
+	// Get optional waitmode with default zero:
+	PsychCopyInIntegerArg(2, FALSE, &waitmode);
 
-		if (audiodevices[audiodevicecount].opmode & kPortAudioIsAMModulator) {
-			printf("PTB-INFO: For %i channels amplitude modulation.\n", audiodevices[audiodevicecount].outchannels);
-		}
-		else if (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) {
-			printf("PTB-INFO: For %i channels playback.\n", audiodevices[audiodevicecount].outchannels);
+	if (PsychCopyInIntegerArg(1, FALSE, &bufferhandle)) {
+		// Specific bufferhandle provided for deletion:
+		
+		// Check if handle valid and error out if so:
+		(void) PsychPAGetAudioBuffer(bufferhandle);
+		
+		// Valid: Try to delete buffer:
+		rc = PsychPADeleteAudioBuffer(bufferhandle, waitmode);
+	}
+	else {
+		// No specific handle: Try to delete all buffers:
+		if (PsychPAUpdateBufferReferences()) {
+			// At least one buffer locked. What do do?
+			if (waitmode == 0) {
+				// Just fail -> No op.
+				rc = 0;
+			}
+			else {
+				// Retry until it works:
+				while (PsychPAUpdateBufferReferences()) PsychYieldIntervalSeconds(yieldInterval);
+				rc = 1;
+			}
 		}
-
-		if (audiodevices[audiodevicecount].opmode & kPortAudioIsOutputCapture) {
-			printf("PTB-INFO: For %i channels capture of master output mix.\n", audiodevices[audiodevicecount].inchannels);		
-		} else if (audiodevices[audiodevicecount].opmode & kPortAudioCapture) {
-			printf("PTB-INFO: For %i channels capture.\n", audiodevices[audiodevicecount].inchannels);
+		else {
+			rc = 1;
 		}
 		
-		printf("PTB-INFO: Real samplerate %f Hz. Input latency %f msecs, Output latency %f msecs.\n",
-				audiodevices[audiodevicecount].streaminfo->sampleRate, audiodevices[audiodevicecount].streaminfo->inputLatency * 1000.0,
-				audiodevices[audiodevicecount].streaminfo->outputLatency * 1000.0);
+		// Really delete all buffers if rc == 1:
+		if (rc == 1) PsychPADeleteAllAudioBuffers();
 	}
-
-	// Return device handle:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevicecount);
 	
-	// One more audio device...
-	audiodevicecount++;
+	// Return status:
+	PsychCopyOutDoubleArg(1, FALSE, (double) rc);
 
-    return(PsychError_none);	
+	// Done.
+	return(PsychError_none);
 }
 
-/* PsychPortAudio('Close') - Close an audio device via PortAudio.
+/* PsychPortAudio('CreateBuffer') - Create and fill dynamic audio outputbuffer of a device with data.
  */
-PsychError PSYCHPORTAUDIOClose(void) 
+PsychError PSYCHPORTAUDIOCreateBuffer(void) 
 {
- 	static char useString[] = "PsychPortAudio('Close' [, pahandle]);";
+ 	static char useString[] = "bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata [, sampleRate]);";
 	static char synopsisString[] = 
-		"Close a PortAudio audio device. The optional 'pahandle' is the handle of the device to close. If pahandle "
-		"is omitted, all audio devices will be closed and the driver will shut down.\n";
-	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
+		"Create a new dynamic audio data playback buffer for a PortAudio audio device and fill it with initial data.\n"
+		"Return a 'bufferhandle' to the new buffer. 'pahandle' is the optional handle of the device "
+		"whose buffer is to be filled. 'bufferdata' is a matrix with audio data in double() or single() "
+		"format. Each row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
+		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
+		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
+		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n\n"
+		"You can refill the buffer anytime via the PsychPortAudio('RefillBuffer') call.\n"
+		"You can delete the buffer via the PsychPortAudio('DeleteBuffer') call, once it is not used anymore. \n"
+		"You can attach the buffer to an audio playback schedule for actual audio playback via the "
+		"PsychPortAudio('AddToSchedule') call.\n"
+		"The same buffer can be attached to and used by multiple audio devices simultaneously, or multiple "
+		"times within one or more playback schedules.\n"
+		"'sampleRate' optional: Sample rate of the sound in Hz. If provided, devices with an enabled resampler "
+		"convert the sound to their own sample rate during playback, see PsychPortAudio('UseResampler'). The "
+		"default of zero plays the sound at the sample rate of the device. ";
+
+	static char seeAlsoString[] = "Open FillBuffer GetStatus UseResampler ";	 
   	
-	int pahandle= -1;
+	PsychPABuffer* buffer;
+	double sampleRate = 0;
+	psych_int64 inchannels, insamples, p;
+	size_t buffersize, outbuffersize;
+	double*	indata = NULL;
+	float* indatafloat = NULL;
+	float*  outdata = NULL;
+	int pahandle   = -1;
+	int bufferhandle = 0;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(1));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	PsychCopyInIntegerArg(1, kPsychArgOptional, &pahandle);
-	if (pahandle == -1) {
-		// Full shutdown requested:
-		PsychPortAudioExit();
+	// Get data matrix with initial buffer content:
+	if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
+		// Or regular float matrix instead:
+		PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
 	}
-	else {
-		// Close one device:
+	
+	// If the optional pahandle is provided...
+	if (PsychCopyInIntegerArg(1, kPsychArgOptional, &pahandle)) {
+		// ...then we use it to validate the configuration of the datamatrix for the new
+		// buffer against the requirements of that audiodevice pahandle:
 		if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-		PsychPACloseStream(pahandle);
+		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
 		
-		// All devices down? Shutdown PortAudio if so:
-		if (audiodevicecount == 0) PsychPortAudioExit();
+		if (inchannels != audiodevices[pahandle].outchannels) {
+			printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
+			PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
+		}
 	}
+
+	if (inchannels < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 row for creation of at least one audio channel in your audio buffer!");
+	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample for creation of your audio buffer!");
+	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
+
+	// Get optional sample rate of the sound:
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &sampleRate);
+	if (sampleRate < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'sampleRate' provided. Must be zero or positive!");
+
+	// Create buffer and assign bufferhandle:
+	bufferhandle = PsychPACreateAudioBuffer(inchannels, insamples);
+	
+	// Deref bufferHandle:
+	buffer = PsychPAGetAudioBuffer(bufferhandle);
+	outdata = buffer->outputbuffer;
+	outbuffersize = buffer->outputbuffersize;
+	buffer->sampleRate = sampleRate;
+	buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
+
+	// Copy the data, convert it from double or single to float:
+	PsychPACopyInSamples(outdata, indata, indatafloat, (psych_int64) (buffersize / sizeof(float)));
 	
+	// Return bufferhandle:
+	PsychCopyOutDoubleArg(1, FALSE, (double) bufferhandle);
+
+	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('FillBuffer') - Fill audio outputbuffer of a device with data.
+/* PsychPortAudio('GetAudioData') - Retrieve captured audio data.
  */
-PsychError PSYCHPORTAUDIOFillAudioBuffer(void) 
+PsychError PSYCHPORTAUDIOGetAudioData(void) 
 {
- 	static char useString[] = "[underflow, nextSampleStartIndex, nextSampleETASecs] = PsychPortAudio('FillBuffer', pahandle, bufferdata [, streamingrefill=0][, startIndex=Append]);";
-	//							1		   2					 3												   1		 2			   3					4
+ 	static char useString[] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, singleType=0][, targetBuffer=0]);";
 	static char synopsisString[] = 
-		"Fill audio data playback buffer of a PortAudio audio device. 'pahandle' is the handle of the device "
-		"whose buffer is to be filled. 'bufferdata' is usually a matrix with audio data in double() or single() format. Each "
-		"row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
-		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
-		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
+		"Retrieve captured audio data from a audio device. 'pahandle' is the handle of the device "
+		"whose data is to be retrieved. 'audiodata' is a matrix with audio data in floating point format. Each "
+		"row of the matrix returns one sound channel, each column one sample for each channel. "
+		"Returned samples are in range -1.0 to +1.0, with 0.0 for silence. This is "
+		"intentionally a very restricted interface. For lowest latency and best timing we want you to accept audio "
 		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
 		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
-		"Instead of a matrix, you can also pass in the bufferhandle of an audio buffer as 'bufferdata'. This buffer "
-		"must have been created beforehand via PsychPortAudio('CreateBuffer', ...). Its content must satisfy the "
-		"same constraints as in case of passing a Matlab matrix. The content will be copied from the given buffer "
-		"to the standard audio buffer, so it is safe to delete that source buffer if you want.\n"
-		"'streamingrefill' optional: If set to 1, ask the driver to refill the buffer immediately while playback "
-		"is active. You can think of this as appending the audio data to the audio data already present in the buffer. "
-		"This is useful for streaming playback or for creating live audio feedback loops. However, the current implementation "
-		"doesn't really append the audio data. Instead it replaces already played audio data with your new data. This means "
-		"that if you try to refill more than what has been actually played, this function will wait until enough storage space "
-		"is available. A 'streamingrefill' flag of 2 will always refill immediately, ie., without waiting for sufficient buffer "
-		"space to become available, even if this causes audible artifacts or some sound data to be overwritten. This is useful "
-		"for a few very special audio feedback tricks, only use if you really know what you're doing!\n"
-		"It will also fail if you try to refill more than the total buffer capacity. Default is to not do "
-		"streaming refills, i.e., the buffer is filled in one batch while playback is stopped. Such a refill will also "
-		"reset any playloop setting done via the 'SetLoop' subfunction to the full size of the refilled buffer.\n"
-		"If the 'streamingrefill' flag is non-zero and the optional 'startIndex' argument is provided, then the refilling "
-		"of the buffer will happen at the provided linear sample index 'startIndex'. If the argument is omitted, new data "
-		"will be appended at the end of the current soundbuffers content. The 'startIndex' argument is ignored if no streaming "
-		"refill is requested.\n"
-		"\nOptionally the function returns the following values:\n"
-		"'underflow' A flag: If 1 then the audio buffer underflowed because you didn't refill it in time, ie., some audible "
-		"glitches were present in playback and your further playback timing is screwed.\n"
-		"'nextSampleStartIndex' This is the absolute index in samples since start of playback of the sample that would "
-		"follow after the last sample you added during this 'FillBuffer' call, ie., the first sample during a successive "
-		"'FillBuffer' call.\n"
-		"'nextSampleETASecs' This value is undefined (NaN) if playback isn't running. During a streaming refill, it contains "
-		"the predicted audio onset time in seconds of the sample with index 'nextSampleStartIndex'. Please note that this "
-		"prediction can accumulate a prediction error if your buffer is so large that it contains samples that will only "
-		"playback far in the future.\n";
+		"You must call this function once before start of capture operations to allocate an internal buffer "
+		"that stores captured audio data inbetween your periodic calls. Provide 'amountToAllocateSecs' as "
+		"requested buffersize in seconds. After start of capture you must call this function periodically "
+		"at least every 'amountToAllocateSecs' seconds to drain the internal buffer into your Matlab/Octave "
+		"matrix 'audiodata'. If you fail to call the function frequently enough, sound data will get lost!\n"
+		"'minimumAmountToReturnSecs' optional minimum amount of recorded data to return at each call. The "
+		"driver will only return control to your script when it was able to collect at least that amount "
+		"of seconds of sound data - or if the capture engine was stopped. If you don't set this parameter, "
+		"the driver will return immediately, giving you whatever amount of sound data was available - including "
+		"an empty matrix if nothing was available.\n"
+		"'maximumAmountToReturnSecs' allows you to optionally restrict the amount of returned sound data to "
+		"a specific duration in seconds. By default, you'll get whatever is available.\n"
+		"If you provide both, 'minimumAmountToReturnSecs' and 'maximumAmountToReturnSecs' and set them to equal "
+		"values (but significantly lower than the 'amountToAllocateSecs' buffersize!!) then you'll always "
+		"get an 'audiodata' matrix back that is of a fixed size. This may be convenient for postprocessing "
+		"in Matlab. It may also reduce or avoid Matlab memory fragmentation...\n"
+		"'singleType' if set to 1 will return a sound data matrix of single() type instead of double() type. "
+		"By default, double() type is returned. single() type matrices only consume half as much memory as "
+		"double() type matrices, without any loss of audio precision. They are also faster to return, as the "
+		"captured data is copied without any format conversion.\n"
+		"'targetBuffer' if set to the bufferhandle of an audio buffer created via PsychPortAudio('CreateBuffer'), "
+		"will copy the captured sound data into that preallocated buffer, starting at its first sample frame, instead "
+		"of returning it in a newly allocated matrix. The buffer must have as many channels as the capture device. "
+		"At most as much data as fits into the buffer is fetched. In this case 'audiodata' returns the number of "
+		"sample frames written into the buffer. This avoids any memory allocation and format conversion, e.g., when "
+		"fetching captured sound repeatedly in a loop. The buffer must not be referenced by any pending slot of a "
+		"schedule, as it could be played back while it gets overwritten, so 'GetAudioData' fails for such buffers. "
+		"If you want to play back the captured sound via a schedule, only add the buffer to the schedule after it "
+		"got filled, and don't use it as 'targetBuffer' again until its slots are played back.\n"
+		"\n"
+		"\nOptional return arguments other than 'audiodata':\n\n"
+		"'absrecposition' is the absolute position (in samples) of the first column in the returned data matrix, "
+		"assuming that sample zero was the very first recorded sample in this session. The count is reset each time "
+		"you start a new capture session via call to PsychPortAudio('Start').\n"
+		"Each call to this function will return a new chunk of recorded sound data. The 'absrecposition' provides "
+		"you with absolute matrix column indices to stitch together the results of all calls into one seamless "
+		"recording if you want. 'overflow' if this flag is zero then everything went fine. If it is one then you "
+		"didn't manage to call this function frequent enough, the capacity of the internal recording buffer was "
+		"exceeded and therefore you lost captured sound data, i.e., there is a gap in your recording. When "
+		"initially allocating the internal buffer, make sure to allocate it big enough so it is able to easily "
+		"store all recorded data inbetween your calls to 'GetAudioData'. Example: You expect to call this routine "
+		"once every second in your trial loop, then allocate a sound buffer of at least 2 seconds for some security "
+		"headroom. If you know that the recording time of each recording has an upper bound then you can allocate "
+		"an internal buffer of sufficient size and fetch the buffer all at once at the end of a recording.\n"
+		"'ctsstarttime' this is an estimate of the system time (in seconds) when the very first sample of this "
+		"recording was captured by the sound input of your hardware. This is only a rough estimate, not to be "
+		"trusted down to the millisecond level, at least not without former careful calibration of your setup!\n";
 
 	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
   	
-	PsychPABuffer* inbuffer;
-	int inbufferhandle = 0;
-	float*  indatafloat = NULL;
-	psych_bool userfloat = FALSE;
-	psych_int64 inchannels, insamples, p;
+	//int inchannels, insamples, p, maxSamples;
+	psych_int64 insamples, maxSamples;
 	size_t buffersize;
-	psych_int64 totalplaycount;
 	double*	indata = NULL;
-	float*  outdata = NULL;
+	float*  indatafloat = NULL;
 	int pahandle   = -1;
-	int streamingrefill = 0;
-	int underrun = 0;
-	double currentTime, etaSecs;
-	psych_int64 startIndex = 0;
-	double tBehind = 0.0;
+	int singleType = 0;
+	int targetbufferhandle = 0;
+	PsychPABuffer* targetbuffer = NULL;
+	psych_int64 inbuffersamples, offset, chunk;
+	double allocsize;
+	double minSecs, maxSecs, minSamples;
+	int overrun = 0;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(4));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
-
-	// Bufferhandle instead of input data matrix provided?
-	if (PsychCopyInIntegerArg(2, kPsychArgAnything, &inbufferhandle) && (inbufferhandle > 0)) {
-		// Seems so. Double check:
-		inbuffer = PsychPAGetAudioBuffer(inbufferhandle);
-		
-		// Assign properties:
-		inchannels = inbuffer->outchannels;
-		insamples  = inbuffer->outputbuffersize / sizeof(float) / inchannels;
-		p = 1;
-		indatafloat = inbuffer->outputbuffer;
-	}
-	else {
-		// Regular double matrix with sound data from runtime:
-		if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-			// Or regular float matrix instead:
-			PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-			userfloat = TRUE;
-		}
-	}
+	if ((audiodevices[pahandle].opmode & kPortAudioCapture) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio capture, so this call doesn't make sense.");
+	if (audiodevices[pahandle].captureWriter) PsychErrorExitMsg(PsychError_user, "Captured sound data of this device is streamed to a file via 'CaptureToFile'. Stop that first.");
 
-	if (inchannels != audiodevices[pahandle].outchannels) {
-		printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
-		PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
-	}
-	
-	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample in your audio buffer!");
-	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
-	
-	// Get optional streaming refill flag:
-	PsychCopyInIntegerArg(3, kPsychArgOptional, &streamingrefill);
+	buffersize = audiodevices[pahandle].inputbuffersize;
 	
-	// Full refill or streaming refill?
-	if (streamingrefill <= 0) {
-		// Standard refill with possible buffer reallocation. Engine needs to be
-		// stopped, full reset of engine at refill:
+	// Copy in optional amount of buffer memory to allocate for internal recording ringbuffer:
+	allocsize = 0;
+	PsychCopyInDoubleArg(2, kPsychArgOptional, &allocsize);
 
-		// Wait for playback on this stream to finish, before refilling it:
-		PsychPALockDeviceMutex(&audiodevices[pahandle]);
-		while (audiodevices[pahandle].state > 0) {
-			// Wait for a state-change before reevaluating the .state:
-			PsychPAWaitForChange(&audiodevices[pahandle]);
-		}
-		
-		// Device is idle, we hold the lock. We can safely drop the lock here and still modify
-		// device data, as none of this will get touched by the engine in idle state:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-		
-		// Ok, everything sane, fill the buffer:
-		buffersize = sizeof(float) * inchannels * insamples;
-		if (audiodevices[pahandle].outputbuffer && (audiodevices[pahandle].outputbuffersize != buffersize)) {
-			free(audiodevices[pahandle].outputbuffer);
-			audiodevices[pahandle].outputbuffer = NULL;
-			audiodevices[pahandle].outputbuffersize = 0;
-		}
-		
-		if (audiodevices[pahandle].outputbuffer == NULL) {
-			audiodevices[pahandle].outputbuffersize = buffersize;
-			audiodevices[pahandle].outputbuffer = (float*) malloc(buffersize);
-			if (audiodevices[pahandle].outputbuffer==NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate audio buffer.");
-		}
-		
-		// Reset play position:
-		audiodevices[pahandle].playposition = 0;
-		
-		outdata = audiodevices[pahandle].outputbuffer;
-		if (indata || userfloat) {
-			if (indata) {
-				// Copy the data, convert it from double to float:
-				while(buffersize) {
-					*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-					buffersize-=sizeof(float);
-				}
-			} else {
-				// Copy the data:
-				while(buffersize) {
-					*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-					buffersize-=sizeof(float);
-				}			
-			}
-		}
-		else {
-			// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
-			memcpy(outdata, indatafloat, buffersize);
-		}
-		
-		// Reset write position to end of buffer:
-		audiodevices[pahandle].writeposition = (psych_int64) inchannels * insamples;
-		
-		// Elapsed count of played out samples must be zero as engine is stopped and will restart sometime after this call:
-		totalplaycount = 0;
-		
-		// Current playout time undefined when playback is stopped:
-		currentTime = PsychGetNanValue();
+	// Internal capture ringbuffer already allocated?
+	if (buffersize == 0) {
+		// Nope. This call needs to allocate it. We know the engine is idle in this case, because it
+		// can't be started or brought out of idle if buffersize == 0 due to checks in 'Start' and 'RescheduleStart'.
+		if (allocsize <= 0) PsychErrorExitMsg(PsychError_user, "You must first call this function with a positive 'amountToAllocateSecs' argument to allocate internal bufferspace first!");
 		
-		// Reset playback loop to full buffer:
-		audiodevices[pahandle].loopStartFrame = 0;
-		audiodevices[pahandle].loopEndFrame = (audiodevices[pahandle].outputbuffersize / sizeof(float) / audiodevices[pahandle].outchannels) - 1;
+		// Ready to allocate ringbuffer memory outside this if-clause...
 	}
 	else {
-		// Streaming refill while playback is running:
+		// Buffer already allocated. Need to realloc?
+		if (allocsize > 0) {
+			// Calling script wants to reallocate the buffer. Check if this is possible here:
+			
+			// Test 1: Engine running? [No need to mutex lock: If running, we fail safely. If state = 0 it can't transition to > 0 behind our back]
+			if (audiodevices[pahandle].state > 0) PsychErrorExitMsg(PsychError_user, "Tried to resize internal buffer while recording engine is running! You must stop recording before resizing the buffer!");
 
-		// Get optional startIndex for new writePosition, if any:
-		if (PsychCopyInIntegerArg64(4, kPsychArgOptional, &startIndex)) {
-			// New writePosition provided:
-			if (startIndex < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startIndex' provided. Must be greater or equal to zero.");
+			// Test 2: Pending samples to read from current ringbuffer? Engine is idle, so we can safely access device data lock-free...
+			if (audiodevices[pahandle].readposition < audiodevices[pahandle].recposition) PsychErrorExitMsg(PsychError_user, "Tried to resize internal buffer without emptying it beforehand. You must drain the buffer before resizing it!");
+
+			// Ok, reallocation allowed, as engine is idle. Delete old buffer:
+			audiodevices[pahandle].inputbuffersize = 0;
+			free(audiodevices[pahandle].inputbuffer);
+			audiodevices[pahandle].inputbuffer = NULL;
 			
-			// Set writePosition to given startIndex: We can do this without lock held, because writeposition is only
-			// touched by us, ie., the main thread, but never by one of the PortAudio threads:
-			audiodevices[pahandle].writeposition = (psych_int64) inchannels * (psych_int64) startIndex;
+			// At this point we are ready to re-allocate ringbuffer outside this if-clause...
 		}
+	}
+	
+	// Still (re-)allocation wanted?
+	if (allocsize > 0) {
+		// We know the engine is idle if we reach this point, so no need to acquire locks or check state...
 		
-		// Engine stopped? [No need to mutex-lock, as engine can't change from state 0 to other state without our intervention]
-		if (audiodevices[pahandle].state == 0) PsychErrorExitMsg(PsychError_user, "Audiodevice not in playback mode! Can't do a streaming buffer refill while stopped.");
+		// Calculate needed buffersize in samples: Convert allocsize in seconds to size in bytes:
+		audiodevices[pahandle].inputbuffersize = sizeof(float) * ((psych_int64) (allocsize * audiodevices[pahandle].streaminfo->sampleRate)) * audiodevices[pahandle].inchannels;
+		audiodevices[pahandle].inputbuffer = (float*) calloc(1, audiodevices[pahandle].inputbuffersize);
+		if (audiodevices[pahandle].inputbuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Free system memory exhausted when trying to allocate audio recording buffer!");
 
-		// No buffer allocated? [No need to mutex-lock, see above]
-		if (audiodevices[pahandle].outputbuffer == NULL) PsychErrorExitMsg(PsychError_user, "No audio buffer allocated! You must call this method once before start of playback to initially allocate a buffer of sufficient size.");
+		// This was an (re-)allocation call, so no data is pending in the buffer.
+		// Therefore we don't return any data, just reset the counters:
+		audiodevices[pahandle].recposition = 0;
+		audiodevices[pahandle].readposition = 0;
+		return(PsychError_none);
+	}
+	
+	// This is not an allocation call, but a real data fetch call:
 
-		// Buffer of sufficient size for a streaming refill of this amount?
-		buffersize = sizeof(float) * (psych_int64) inchannels * (psych_int64) insamples;
-		if (audiodevices[pahandle].outputbuffersize < buffersize) PsychErrorExitMsg(PsychError_user, "Total capacity of audio buffer is too small for a refill of this size! Allocate an initial buffer of at least the size of the biggest refill.");
+	// Get optional "minimum amount to return" argument:
+	// We default to "whatever we can get" ie. zero seconds.
+	minSecs = 0;
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &minSecs);
 
-		// Need to lock b'cause of 'playposition':
-		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+	// Get optional "maximum amount to return" argument:
+	// We default to "whatever we can get" ie. infinite seconds.
+	maxSecs = 0;
+	PsychCopyInDoubleArg(4, kPsychArgOptional, &maxSecs);
 
-		// Check for buffer underrun:
-		if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
-			underrun = 1;
-			tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
+	// Get optional singleType flag:
+	PsychCopyInIntegerArg(5, kPsychArgOptional, &singleType);
+	if (singleType < 0 || singleType > 1) PsychErrorExitMsg(PsychError_user, "'singleType' flag must be zero or one!");
+
+	// Get optional targetBuffer handle of preallocated buffer to fill:
+	if (PsychCopyInIntegerArg(6, kPsychArgOptional, &targetbufferhandle) && (targetbufferhandle > 0)) {
+		targetbuffer = PsychPAGetAudioBuffer(targetbufferhandle);
+		if (targetbuffer->outchannels != audiodevices[pahandle].inchannels) {
+			printf("PTB-ERROR: Audio device %i has %i input channels, but provided 'targetBuffer' has non-matching number of %i channels.\n", pahandle, (int) audiodevices[pahandle].inchannels, (int) targetbuffer->outchannels);
+			PsychErrorExitMsg(PsychError_user, "Number of channels of 'targetBuffer' doesn't match number of input channels of selected audio device.\n");
 		}
+	}
 
-		// Boundary conditions met. Can we refill immediately or do we need to wait for playback
-		// position to progress far enough? We skip this test if the streamingrefill flag is > 1:
-		while ((streamingrefill < 2) && (audiodevices[pahandle].state > 0) && (!underrun) && (((audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float)) - (audiodevices[pahandle].writeposition - audiodevices[pahandle].playposition) - (psych_int64) inchannels) <= (inchannels * insamples))) {
-			// Sleep a bit, drop the lock throughout sleep:
+	// The engine is potentially running, so we need to mutex-lock our accesses...
+	PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+	// How much samples are available in ringbuffer to fetch?
+	insamples = (psych_int64) (audiodevices[pahandle].recposition - audiodevices[pahandle].readposition);
+	
+	// Convert amount of available data into seconds and check if our minimum
+	// requirements are fulfilled:
+	if (minSecs > 0) {
+		// Convert seconds to samples:
+		minSamples = minSecs * ((double) audiodevices[pahandle].streaminfo->sampleRate) * ((double) audiodevices[pahandle].inchannels) + ((double) audiodevices[pahandle].inchannels);
+
+		// Bigger than buffersize? That would be a no no...
+		if (((psych_int64) minSamples * sizeof(float)) > audiodevices[pahandle].inputbuffersize) {
 			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-			// TODO: We could do better here by predicting how long it will take at least until we're ready to refill,
-			// but a perfect solution would require quite a bit of effort... ...Something for a really boring afternoon.
-			PsychYieldIntervalSeconds(yieldInterval);
+			PsychErrorExitMsg(PsychError_user, "Invalid 'minimumAmountToReturnSecs' parameter: The requested minimum is bigger than the whole capture buffer size!'");			
+		}
+		
+		// Loop until either request is fullfillable or the device gets stopped - in which
+		// case we'll never be able to fullfill the request...
+		while (((double) insamples < minSamples) && (audiodevices[pahandle].state > 0)) {
+			// Compute amount of time to elapse before request could be fullfilled:
+			minSecs = (minSamples - (double) insamples) / ((double) audiodevices[pahandle].inchannels) / ((double) audiodevices[pahandle].streaminfo->sampleRate);
+			// Ok, required data will be available earliest in 'minSecs' seconds. Sleep until then with lock dropped:
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+			PsychWaitIntervalSeconds(minSecs);
 			PsychPALockDeviceMutex(&audiodevices[pahandle]);
-
-			// Recheck for buffer underrun:
-			if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
-				underrun = 1;
-				tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
-			}
+			
+			// We've slept at least the estimated amount of required time. Recalculate amount
+			// of available sound data and check again...
+			insamples = (psych_int64) (audiodevices[pahandle].recposition - audiodevices[pahandle].readposition);
 		}
+	}
+	
+	// Lock held here...
+	
+	// Never ever fetch the samples for the last sampleframe. We do not want to fetch
+	// a possibly not yet updated or incomplete sample frame. Leave this to next call
+	// of this function. Well, unless state is zero == engine stopped. In that case we
+	// know that the playhead won't move anymore and we can safely fetch all remaining
+	// data.
+	if (audiodevices[pahandle].state > 0) {
+		insamples = insamples - (insamples % audiodevices[pahandle].inchannels);
+		insamples-= audiodevices[pahandle].inchannels;
+	}
 
-		// Exit with lock held...
-		
-		// Have we left the while-loop because the engine stopped? In that case we won't
-		// be able to ever get the needed headroom and need to error-out:
-		if (audiodevices[pahandle].state == 0) {
-			// Ohoh...
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
-			PsychErrorExitMsg(PsychError_user, "Audiodevice no longer in playback mode (Auto stopped?!?)! Can't continue a streaming buffer refill while stopped. Check your code!");
-		}
+	// Can unlock here: The remainder of the routine doesn't touch any critical device variables anymore,
+	// only variables that aren't modified by the engine, or not used/touched by engine.
+	// Well, theoretically the engine could overwrite the portion of the buffer we're going to
+	// read out if we stall massively and the capturebuffer is way too "undersized", but in that
+	// case the user code is screwed anyway and it (or the system) needs to be fixed...
+	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+	
+	insamples = (insamples < 0) ? 0 : insamples;
+	buffersize = insamples * sizeof(float);
+
+	// Buffer "overflow" detected?
+	if (buffersize > audiodevices[pahandle].inputbuffersize) {
+		// Ok, the buffer did overrun and captured data was lost. Limit returned data
+		// to buffersize and set the overrun flag, optionally output a warning:
+		buffersize = audiodevices[pahandle].inputbuffersize;
+		insamples = buffersize / sizeof(float);
 		
-		// Ok, device locked and enough headroom for batch streaming refill:
+		// Set overrun flag:
+		overrun = 1;
 		
-		// Copy the data, convert it from double to float, take ringbuffer wraparound into account:
-		if (indata || userfloat) {
-			if (indata) {
-				while(buffersize > 0) {
-					// Fetch next sample and copy it to matrix:
-					audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-					
-					// Update sample write counter:
-					audiodevices[pahandle].writeposition++;
-					
-					// Decrement copy counter:
-					buffersize-=sizeof(float);
-				}
-			}
-			else {
-				while(buffersize > 0) {
-					// Fetch next sample and copy it to matrix:
-					audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-					
-					// Update sample write counter:
-					audiodevices[pahandle].writeposition++;
-					
-					// Decrement copy counter:
-					buffersize-=sizeof(float);
-				}
-			}
+		if (verbosity > 1) printf("PsychPortAudio-WARNING: Overflow of audio capture buffer detected. Some sound data will be lost!\n");
+	}
+	
+	// Limitation of returned amount of data wanted?
+	if (maxSecs > 0) {
+		// Yes. Convert maximum amount in seconds to maximum amount in samples:
+		maxSamples = (psych_int64) (ceil(maxSecs * ((double) audiodevices[pahandle].streaminfo->sampleRate)) * ((double) audiodevices[pahandle].inchannels));
+		// Clamp insamples to that value, if neccessary:
+		if (insamples > maxSamples) {
+			insamples = maxSamples;
+			buffersize = insamples * sizeof(float);
 		}
-		else {
-			// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
-			while(buffersize > 0) {
-				// Fetch next sample and copy it to matrix:
-				audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = *(indatafloat++);
-				
-				// Update sample write counter:
-				audiodevices[pahandle].writeposition++;
-				
-				// Decrement copy counter:
-				buffersize-=sizeof(float);
-			}		
+	}
+	
+	if (targetbuffer) {
+		// Clamp insamples to capacity of target buffer, if neccessary:
+		if (insamples > (psych_int64) (targetbuffer->outputbuffersize / sizeof(float))) {
+			insamples = (psych_int64) (targetbuffer->outputbuffersize / sizeof(float));
+			buffersize = insamples * sizeof(float);
 		}
-		
-		// Retrieve total count of played out samples from engine:
-		totalplaycount = audiodevices[pahandle].totalplaycount;
 
-		// Retrieve corresponding timestamp of last playout:
-		currentTime = audiodevices[pahandle].currentTime;
-		
-		// Check for buffer underrun:
-		if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
-			underrun = 1;
-			tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
-		}
-		
-		// Drop lock here, no longer needed:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
+		// Copy directly into target buffer, return number of fetched sample frames instead of a matrix:
+		indatafloat = targetbuffer->outputbuffer;
+		PsychCopyOutDoubleArg(1, FALSE, (double) (insamples / audiodevices[pahandle].inchannels));
+	}
+	else if (singleType & 1) {
+		// Allocate output float matrix with matching number of channels and samples:
+		PsychAllocOutFloatMatArg(1, FALSE, audiodevices[pahandle].inchannels, insamples / audiodevices[pahandle].inchannels, 1, &indatafloat);
+	}
+	else { 
+		// Allocate output double matrix with matching number of channels and samples:
+		PsychAllocOutDoubleMatArg(1, FALSE, audiodevices[pahandle].inchannels, insamples / audiodevices[pahandle].inchannels, 1, &indata);
+	}
+	
+	// Copy out absolute sample read position of first sample in buffer:
+	PsychCopyOutDoubleArg(2, FALSE, (double) (audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels));
 
-		if ((underrun > 0) && (verbosity > 1)) {
-			printf("PsychPortAudio-WARNING: Underrun of audio playback buffer detected during streaming refill at approximate play position %f secs [%f msecs behind]. Sound will be skipped, timing may be wrong and audible glitches may occur!\n",
-					((double) audiodevices[pahandle].playposition / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate)) , tBehind / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate) * 1000.0);
+	// The targetBuffer must not be referenced by any schedule, as paCallback may be reading it for playback while we
+	// write into it. Hold the bufferListmutex during the whole copy, so it can't get added to a schedule meanwhile:
+	if (targetbuffer) {
+		PsychLockMutex(&bufferListmutex);
+		if (targetbuffer->refcount > 0) {
+			PsychUnlockMutex(&bufferListmutex);
+			printf("PTB-ERROR: Provided 'targetBuffer' %i is still referenced by %i pending slots of some audio schedule.\n", targetbufferhandle, targetbuffer->refcount);
+			PsychErrorExitMsg(PsychError_user, "'targetBuffer' is in use by a schedule. Use a buffer which isn't part of any pending schedule.\n");
 		}
 	}
 
-	// Copy out underrun flag:
-	PsychCopyOutDoubleArg(1, FALSE, (double) underrun);
-	
-	// Copy out number of submitted sample frames, aka the absolute sample frame startindex for next 'Fillbuffer' call.
-	PsychCopyOutDoubleArg(2, FALSE, (double) audiodevices[pahandle].writeposition / (double) audiodevices[pahandle].outchannels);
-	
-	// Compute and return predicted estimated time of arrival for playout of first sample for next 'FillBuffer' call, aka almost of the last sample in this 'FillBuffer' call:
-	etaSecs = currentTime + ((((double) audiodevices[pahandle].writeposition - (double) totalplaycount) / (double) audiodevices[pahandle].outchannels) / (double) audiodevices[pahandle].streaminfo->sampleRate);
-	PsychCopyOutDoubleArg(3, FALSE, etaSecs);
+	// Copy the data, convert it from float to double if needed: Take ringbuffer wraparound into account by
+	// copying in at most two contiguous chunks, one up to the end of the ringbuffer, one from its start:
+	inbuffersamples = audiodevices[pahandle].inputbuffersize / sizeof(float);
+	insamples = (psych_int64) (buffersize / sizeof(float));
+	while (insamples > 0) {
+		// Offset of read position in ringbuffer and size of contiguous chunk until wraparound:
+		offset = audiodevices[pahandle].readposition % inbuffersamples;
+		chunk = (insamples < inbuffersamples - offset) ? insamples : inbuffersamples - offset;
+
+		// Copy to float/single or double matrix:
+		PsychPACopyOutSamples(indata, indatafloat, &(audiodevices[pahandle].inputbuffer[offset]), chunk);
+		if (indatafloat) indatafloat += chunk; else indata += chunk;
+
+		// Update sample read counter:
+		audiodevices[pahandle].readposition += chunk;
+
+		// Decrement copy counter:
+		insamples -= chunk;
+	}
+
+	if (targetbuffer) PsychUnlockMutex(&bufferListmutex);
+
+	// Copy out overrun flag:
+	PsychCopyOutDoubleArg(3, FALSE, (double) overrun);
+
+	// Return capture timestamp in system time of first captured sample in this session. This is a bit problematic:
+	// In full-duplex mode, at least OS/X doesn't return separate timestamps, so we'll provide the playback onset time
+	// instead - the best we can do. In pure capture mode we get a capture timestamp...
+	PsychCopyOutDoubleArg(4, FALSE, (audiodevices[pahandle].captureStartTime > 0) ? audiodevices[pahandle].captureStartTime : audiodevices[pahandle].startTime);
 	
 	// Buffer ready.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('RefillBuffer') - Refill existing audio outputbuffer of a device with data.
+/* PsychPortAudio('RescheduleStart') - Set new start time for an already running audio device via PortAudio.
  */
-PsychError PSYCHPORTAUDIORefillBuffer(void) 
+PsychError PSYCHPORTAUDIORescheduleStart(void) 
 {
- 	static char useString[] = "PsychPortAudio('RefillBuffer', pahandle [, bufferhandle=0], bufferdata [, startIndex=0]);";
+ 	static char useString[] = "startTime = PsychPortAudio('RescheduleStart', pahandle, when [, waitForStart=0] [, repetitions] [, stopTime]);";
 	static char synopsisString[] = 
-		"Refill part of an audio data playback buffer of a PortAudio audio device. 'pahandle' is the handle of the device "
-		"whose buffer is to be filled. 'bufferhandle' is the handle of the buffer: Use a handle of zero for the standard "
-		"buffer created and accessed via 'FillBuffer'. 'bufferdata' is a matrix with audio data in double() or single() "
-		"format. Each row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
-		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
-		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
-		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
-		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
-		"Instead of a matrix, you can also pass in the bufferhandle of an audio buffer as 'bufferdata'. This buffer "
-		"must have been created beforehand via PsychPortAudio('CreateBuffer', ...). Its content must satisfy the "
-		"same constraints as in case of passing a Matlab matrix. The content will be copied from the given buffer "
-		"to the standard audio buffer, so it is safe to delete that source buffer if you want.\n"		
-		"'startIndex' optional: Defines the first sample frame within the buffer where refill should start. "
-		"By default, refilling starts at the beginning of the buffer - at sample frame 0. 'startIndex' allows to "
-		"start refilling at some offset.\n"
-		"Please note that 'RefillBuffer' can't resize an existing buffer - you can't fill in more data than the "
-		"current buffer capacity permits. If you want to add more sound, you'll need to use 'FillBuffer' or "
-		"create a new buffer of proper capacity.\n"
-		"'RefillBuffer' can be used any time on a buffer, even if the buffer is currently playing, allowing for "
-		"on-the-fly replacement of content. However be careful to avoid the currently played section, or you'll "
-		"hear audio artifacts. For streaming out audio content in a glitch-free way, you may want to use the "
-		"'streamingrefill' option of the 'FillBuffer' subfunction instead.\n";
+		"Modify requested start time 'when' of an already started PortAudio audio device.\n"
+		"After you've started an audio device via the 'Start' subfunction, but *before* the "
+		"device has really started playback (because the 'when' time provided to the 'Start' "
+		"method is still far in the future), you can use this function to reschedule the start for "
+		"a different 'when' time - including a value of zero for immediate start.\n"
+		"\n"
+		"The 'pahandle' is the handle of the device to start. Starting a "
+		"device means: Start playback of output devices, start recording on capture device, do both on "
+		"full duplex devices. 'waitForStart' if set to 1 will wait until device has really started, default "
+		"is to continue immediately, ie. only schedule start of device. 'when' Requested time, when device "
+		"should start. Defaults to zero, i.e. start immediately. If set to a non-zero system time, PTB will "
+		"do its best to start the device at the requested time, but the accuracy of start depends on the "
+		"operating system, audio hardware and system load. If 'waitForStart' is set to non-zero value, ie "
+		"if PTB should wait for sound onset, then the optional return argument 'startTime' will contain an "
+		"estimate of when the first audio sample hit the speakers, i.e., the real start time.\n"
+		"Please note that the 'when' value always refers to playback, so it defines the starttime of "
+		"playback. The start time of capture is related to the start time of playback in duplex mode, "
+		"but it isn't the same. In pure capture mode (without playback), 'when' will be ignored and "
+		"capture always starts immediately. See the help for subfunction 'GetStatus' for more info on "
+		"the meaning of the different timestamps.\n"
+		"The 'repetitions' parameter will change the number of playback repetitions if provided. The "
+		"value for 'repetitions' from the PsychPortAudio('Start') function will be used if the parameter "
+		"is omitted. See explanation in the 'Start' function for its meaning.\n"
+		"'stopTime' is an optional override for the 'stopTime' parameter from the 'Start' function, see "
+		"explanations there.\n";
 
-	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
+	static char seeAlsoString[] = "Open";	 
   	
-	PsychPABuffer* buffer;
-	PsychPABuffer* inbuffer;
-	
-	psych_int64 inchannels, insamples, p;
-	size_t buffersize, outbuffersize;
-	double*	indata = NULL;
-	int inbufferhandle = 0;
-	float*  indatafloat = NULL;
-	psych_bool userfloat = FALSE;
-	float*  outdata = NULL;
-	int pahandle   = -1;
-	int bufferhandle = 0;
-	psych_int64 startIndex = 0;
-	
+	PaError err;
+	int pahandle= -1;
+	int waitForStart = 0;
+	double when = 0.0;
+	double repetitions = -1;
+	double stopTime = -1;
+	 
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(3)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
-
-	PsychCopyInIntegerArg(2, kPsychArgOptional, &bufferhandle);
-	// Check for valid bufferhandle:
-	if (bufferhandle < 0) PsychErrorExitMsg(PsychError_user, "Invalid audio 'bufferhandle' provided.");
-
-	// If it is a non-zero handle, try to dereference from dynamic buffer:
-	if (bufferhandle > 0) {
-		// Deref bufferHandle: Issue error if no buffer with such a handle exists:
-		buffer = PsychPAGetAudioBuffer(bufferhandle);
-		
-		// Validate matching output channel count:
-		if (buffer->outchannels != audiodevices[pahandle].outchannels) {
-			printf("PsychPortAudio-ERROR: Audio channel count %i of audiobuffer with handle %i doesn't match channel count %i of audio device!\n", buffer->outchannels, bufferhandle, audiodevices[pahandle].outchannels);
-			PsychErrorExitMsg(PsychError_user, "Target audio buffer 'bufferHandle' has an audio channel count that doesn't match channels of audio device!");
-		}
+	if ((audiodevices[pahandle].opmode & kPortAudioMonitoring) == 0) {
+		// Not in monitoring mode: We must have in/outbuffers allocated:
+		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) && (audiodevices[pahandle].outputbuffer == NULL) && (audiodevices[pahandle].schedule == NULL) && (audiodevices[pahandle].ringBuffer == NULL)) PsychErrorExitMsg(PsychError_user, "Sound outputbuffer doesn't contain any sound to play?!?");
+		if ((audiodevices[pahandle].opmode & kPortAudioCapture) && (audiodevices[pahandle].inputbuffer == NULL)) PsychErrorExitMsg(PsychError_user, "Sound inputbuffer not prepared/allocated for capture?!?");
 	}
 
-	// Bufferhandle instead of input data matrix provided?
-	if (PsychCopyInIntegerArg(3, kPsychArgAnything, &inbufferhandle) && (inbufferhandle > 0)) {
-		// Seems so. Double check:
-		inbuffer = PsychPAGetAudioBuffer(inbufferhandle);
-		
-		// Assign properties:
-		inchannels = inbuffer->outchannels;
-		insamples = inbuffer->outputbuffersize / sizeof(float) / inchannels;
-		p = 1;
-		indatafloat = inbuffer->outputbuffer;
-	}
-	else {
-		// Regular double matrix with sound data from runtime:
-		if (!PsychAllocInDoubleMatArg64(3, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-			// Or regular float matrix instead:
-			PsychAllocInFloatMatArg64(3, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-			userfloat = TRUE;
-		}
-	}
-	
-	if (inchannels != audiodevices[pahandle].outchannels) {
-		printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
-		PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
-	}
-	
-	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample for refill of your audio buffer!");
-	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
-	
-	// Get optional startIndex:
-	PsychCopyInIntegerArg64(4, kPsychArgOptional, &startIndex);
-	if (startIndex < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startIndex' provided. Must be greater or equal to zero.");
+	// Get new required 'when' start time:
+	PsychCopyInDoubleArg(2, kPsychArgRequired, &when);
+	if (when < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'when'. Valid values are zero or greater.");
 
-	// Assign bufferpointer based on bufferhandle:
-	if (bufferhandle > 0) {
-		// Generic buffer:
-		outdata = buffer->outputbuffer;
-		outbuffersize = buffer->outputbuffersize;
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &waitForStart);
+	if (waitForStart < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'waitForStart'. Valid values are zero or greater.");
+
+	// Get new optional 'repetitions' count:
+	if (PsychCopyInDoubleArg(4, kPsychArgOptional, &repetitions)) {
+		// Argument provided: Range-Check and assign it:
+		if (repetitions < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'repetitions'. Valid values are zero or greater.");
 	}
 	else {
-		// Standard playout buffer:
-		outdata = audiodevices[pahandle].outputbuffer;
-		outbuffersize = audiodevices[pahandle].outputbuffersize;
+		repetitions = -1;
 	}
 
-	// Buffer exists?
-	if (outdata == NULL) PsychErrorExitMsg(PsychError_user, "No such buffer with given 'bufferhandle', or buffer not yet created!");
-	
-	// Compute required buffersize for copying all data from given startIndex:
-	buffersize = sizeof(float) * (size_t) inchannels * ((size_t) insamples + (size_t) startIndex);
-	
-	// Buffer of sufficient size?
-	if (buffersize > outbuffersize) {
-		// Nope, too small: Adapt 'buffersize' to allowable maximum amount:
-		if (verbosity > 1) printf("PsychPortAudio: WARNING: In 'RefillBuffer' for bufferhandle %i at startindex %i: Insufficient\nbuffersize %i for %i new audioframes starting at given startindex.\nWill truncate to maximum possible.\n", bufferhandle, (int) startIndex, (int) (outbuffersize / (sizeof(float) * inchannels)), (int) insamples);
-		buffersize = outbuffersize;
-		buffersize -= sizeof(float) * (size_t) inchannels * (size_t) startIndex;
+	// Get new optional 'stopTime':
+	if (PsychCopyInDoubleArg(5, kPsychArgOptional, &stopTime)) {
+		// Argument provided: Range-Check and assign it:
+		if (stopTime <= when && (stopTime < DBL_MAX)) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'stopTime'. Valid values are greater than 'when' starttime.");
 	}
 	else {
-		// Big enough:
-		buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
+		stopTime = -1;
 	}
+
+	// Audio engine running? That is the minimum requirement for this function to work:
+	if (!Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Audio device not started. You need to call the 'Start' function first!");
+
+	// Lock the device:
+	PsychPALockDeviceMutex(&audiodevices[pahandle]);
 	
-	// Map startIndex to offset in buffer:
-	outdata += (size_t) inchannels * (size_t) startIndex;
+	// Whatever the current scheduled starttime is, override it to be infinity:
+	audiodevices[pahandle].reqStartTime = DBL_MAX;
 	
-	// Ok, everything sane, fill the buffer: 'buffersize' iterations into 'outdata':
-	//fprintf(stderr, "buffersize = %i\n", buffersize);
+	// Reset any pending requests:
+	audiodevices[pahandle].reqstate = 255;
 
-	if (indata || userfloat) {
-		if (indata) {
-			// Copy the data, convert it from double to float:
-			while(buffersize > 0) {
-				*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-				buffersize-=sizeof(float);
-			}
-		}
-		else {
-			// Copy the data:
-			while(buffersize > 0) {
-				*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-				buffersize-=sizeof(float);
-			}
-		}
+	// Engine is running. Is it in a state ready for rescheduling a start?
+	
+	// In runMode zero it must be in hot-standby as immediately after a 'Start' in order to be reschedulable:
+	if ((audiodevices[pahandle].runMode == 0) && (audiodevices[pahandle].state != 1)) {
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		PsychErrorExitMsg(PsychError_user, "Audio device not started and waiting. You need to call the 'Start' function first with an infinite 'when' time or a 'when' time in the far future!");
 	}
-	else {
-		// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
-		memcpy(outdata, indatafloat, buffersize);
+	
+	// In runMode 1 the device itself is always running and has to be in a logically stopped/idle (=0) state or hotstandby for rescheduling.
+	if ((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 1)) {
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		PsychErrorExitMsg(PsychError_user, "Audio device not idle. Make sure it is idle first, e.g., by proper use of the 'Stop' function or by checking its 'Active' state via the 'GetStatus' function!");
 	}
 
-	// Done.
-	return(PsychError_none);
-}
+	// Audio engine is in a proper state for rescheduling now: 
 
-/* PsychPortAudio('DeleteBuffer') - Delete a dynamic audio outputbuffer.
- */
-PsychError PSYCHPORTAUDIODeleteBuffer(void) 
-{
- 	static char useString[] = "result = PsychPortAudio('DeleteBuffer'[, bufferhandle] [, waitmode]);";
-	static char synopsisString[] = 
-		"Delete an existing dynamic audio data playback buffer.\n"
-		"'bufferhandle' is the handle for the buffer to delete. If it is omitted, all "
-		"buffers will be deleted. 'waitmode' defines what happens if a buffer shall be "
-		"deleted that is currently in use, i.e., part of the audio playback schedule "
-		"of an active audio device. The default of zero will simply return without deleting "
-		"the buffer. A setting of 1 will wait until the buffer can be safely deleted.\n";
+	// New repetitions provided?
+	if (repetitions >=0) {
+		// Set number of requested repetitions: 0 means loop forever, default is 1 time.
+		audiodevices[pahandle].repeatCount = (repetitions == 0) ? -1 : repetitions;
+	}
 
-	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
-  	
-	int bufferhandle = 0;
-	int waitmode = 0;
-	int rc = 0;
+	// New stopTime provided?
+	if (stopTime >= 0) audiodevices[pahandle].reqStopTime = stopTime;
+
+	// Reset statistics:
+	audiodevices[pahandle].xruns = 0;	
+	audiodevices[pahandle].noTime = 0;
+	audiodevices[pahandle].captureStartTime = 0;
+	audiodevices[pahandle].startTime = 0.0;
+	audiodevices[pahandle].estStopTime = 0;
+	audiodevices[pahandle].currentTime = 0;		
+	audiodevices[pahandle].schedule_pos = 0;
+
+	// Buffers of the schedule may have changed while we were idle:
+	PsychPACompileSchedule(&audiodevices[pahandle]);
 	
-	// Setup online help: 
-	PsychPushHelp(useString, synopsisString, seeAlsoString);
-	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	// Reset recorded samples counter:
+	audiodevices[pahandle].recposition = 0;
+
+	// Reset read samples counter: This will discard possibly not yet fetched data.
+	audiodevices[pahandle].readposition = 0;
+
+	// Reset play position:
+	audiodevices[pahandle].playposition = 0;
+	audiodevices[pahandle].resamplePhase = 0;
 	
-	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	// Reset total count of played out samples:
+	audiodevices[pahandle].totalplaycount = 0;
+	
+	// Setup new rescheduled target start time:
+	audiodevices[pahandle].reqStartTime = when;
 
-	// Make sure PortAudio is online:
-	PsychPortAudioInitialize();
+	if (audiodevices[pahandle].runMode == 1) {
+		// Set the state to hot-standby to actually make this scheduling request active:
+		audiodevices[pahandle].state = 1;
+	}
 
-	// Get optional waitmode with default zero:
-	PsychCopyInIntegerArg(2, FALSE, &waitmode);
+	// Safety check for deadlock avoidance with waiting slaves:
+	if ((waitForStart > 0) && (audiodevices[pahandle].opmode & kPortAudioIsSlave) &&
+		(!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream) ||
+		 audiodevices[audiodevices[pahandle].pamaster].state < 1)) {
+		// We are a slave that shall wait for start, but the master audio device hasn't even
+		// started its engine. This looks like a deadlock to avoid:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		printf("PTB-ERROR: Failed to reschedule start of audio device %i. You asked me to wait for start to happen, but the\n", pahandle);
+		printf("PTB-ERROR: master audio device %i isn't active yet, so i would hang forever! Aborting!!\n", audiodevices[pahandle].pamaster);
+		PsychErrorExitMsg(PsychError_user, "Asked to 'waitForStart' of a slave device, but associated master device not even started! Deadlock avoided!");
+	}
 
-	if (PsychCopyInIntegerArg(1, FALSE, &bufferhandle)) {
-		// Specific bufferhandle provided for deletion:
+	if (waitForStart>0) {
+		// Wait for real start of device: We enter the first while() loop iteration with
+		// the device lock still held from above, so the while() loop will iterate at
+		// least once...
+		while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+			// Wait for a state-change before reevaluating the .state:
+			PsychPAWaitForChange(&audiodevices[pahandle]);
+		}
 		
-		// Check if handle valid and error out if so:
-		(void) PsychPAGetAudioBuffer(bufferhandle);
+		// Device has started (potentially even already finished for very short sounds!)
+		// In any case we have a valid .startTime to wait for in the device struct,
+		// which won't change by itself anymore, so it is safe to access unlocked.
+		// Unlock device:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+
+		// Ok, relevant audio buffer with real sound onset submitted to engine.
+		// We now have an estimate of real sound onset in startTime, wait until
+		// then:
+		PsychWaitUntilSeconds(audiodevices[pahandle].startTime);
 		
-		// Valid: Try to delete buffer:
-		rc = PsychPADeleteAudioBuffer(bufferhandle, waitmode);
+		// Engine should run now. Return real onset time:
+		PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
 	}
 	else {
-		// No specific handle: Try to delete all buffers:
-		if (PsychPAUpdateBufferReferences()) {
-			// At least one buffer locked. What do do?
-			if (waitmode == 0) {
-				// Just fail -> No op.
-				rc = 0;
-			}
-			else {
-				// Retry until it works:
-				while (PsychPAUpdateBufferReferences()) PsychYieldIntervalSeconds(yieldInterval);
-				rc = 1;
-			}
-		}
-		else {
-			rc = 1;
-		}
-		
-		// Really delete all buffers if rc == 1:
-		if (rc == 1) PsychPADeleteAllAudioBuffers();
+		// Unlock device: This will trigger actual start at next paCallback() invocation by engine:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+
+		// Return empty zero timestamp to signal that this info is not available:
+		PsychCopyOutDoubleArg(1, kPsychArgOptional, 0.0);
 	}
 	
-	// Return status:
-	PsychCopyOutDoubleArg(1, FALSE, (double) rc);
-
-	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('CreateBuffer') - Create and fill dynamic audio outputbuffer of a device with data.
+
+/* PsychPortAudio('Start') - Start an audio device via PortAudio.
  */
-PsychError PSYCHPORTAUDIOCreateBuffer(void) 
+PsychError PSYCHPORTAUDIOStartAudioDevice(void) 
 {
- 	static char useString[] = "bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata);";
+ 	static char useString[] = "startTime = PsychPortAudio('Start', pahandle [, repetitions=1] [, when=0] [, waitForStart=0] [, stopTime=inf] [, resume=0]);";
 	static char synopsisString[] = 
-		"Create a new dynamic audio data playback buffer for a PortAudio audio device and fill it with initial data.\n"
-		"Return a 'bufferhandle' to the new buffer. 'pahandle' is the optional handle of the device "
-		"whose buffer is to be filled. 'bufferdata' is a matrix with audio data in double() or single() "
-		"format. Each row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
-		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
-		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
-		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
-		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n\n"
-		"You can refill the buffer anytime via the PsychPortAudio('RefillBuffer') call.\n"
-		"You can delete the buffer via the PsychPortAudio('DeleteBuffer') call, once it is not used anymore. \n"
-		"You can attach the buffer to an audio playback schedule for actual audio playback via the "
-		"PsychPortAudio('AddToSchedule') call.\n"
-		"The same buffer can be attached to and used by multiple audio devices simultaneously, or multiple "
-		"times within one or more playback schedules. ";
-
-	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
-  	
-	PsychPABuffer* buffer;
-	psych_int64 inchannels, insamples, p;
-	size_t buffersize, outbuffersize;
-	double*	indata = NULL;
-	float* indatafloat = NULL;
-	float*  outdata = NULL;
-	int pahandle   = -1;
-	int bufferhandle = 0;
+		"Start a PortAudio audio device. The 'pahandle' is the handle of the device to start. Starting a "
+		"device means: Start playback of output devices, start recording on capture device, do both on "
+		"full duplex devices. 'waitForStart' if set to 1 will wait until device has really started, default "
+		"is to continue immediately, ie. only schedule start of device. 'when' Requested time, when device "
+		"should start. Defaults to zero, i.e. start immediately. If set to a non-zero system time, PTB will "
+		"do its best to start the device at the requested time, but the accuracy of start depends on the "
+		"operating system, audio hardware and system load. If 'waitForStart' is set to non-zero value, ie "
+		"if PTB should wait for sound onset, then the optional return argument 'startTime' will contain an "
+		"estimate of when the first audio sample hit the speakers, i.e., the real start time.\n"
+		"Please note that the 'when' value always refers to playback, so it defines the starttime of "
+		"playback. The start time of capture is related to the start time of playback in duplex mode, "
+		"but it isn't the same. In pure capture mode (without playback), 'when' will be ignored and "
+		"capture always starts immediately. See the help for subfunction 'GetStatus' for more info on "
+		"the meaning of the different timestamps.\n"
+		"The 'repetitions' parameter defines how often the playback of the sound data should be repeated. "
+		"A setting of zero will cause infinite repetitions, ie., until manually stopped via the 'Stop' "
+		"subfunction. A positive setting will cause the provided number of repetitions to happen. The "
+		"default setting is 1, ie., play exactly once, then stop. Fractional values are allowed, e.g, "
+		"1.5 for one and a half repetition.\n"
+		"The optional parameter 'stopTime' allows to set a specific system time when sound playback "
+		"should stop by itself at latest, regardless if the requested number of 'repetitions' has "
+		"completed. PTB will do its best to stop sound at exactly that time, see comments about the "
+		"'when' parameter - The same mechanism is used, with the same restrictions.\n"
+		"The optional parameter 'resume' if set to 1, allows to resume playback at the position it "
+		"was last stopped, instead of starting at the beginning again. By default, playback starts "
+		"at the beginning.\n";
+
+	static char seeAlsoString[] = "Open";	 
+  	
+	PaError err;
+	int pahandle= -1;
+	int waitForStart = 0;
+	int resume = 0;
+	double repetitions = 1;
+	double when = 0.0;
+	double stopTime = DBL_MAX;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	// Get data matrix with initial buffer content:
-	if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-		// Or regular float matrix instead:
-		PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+
+	// If this is a master device, we refault repetitions to zero, ie., infinite playback/capture.
+	// Makes much more sense for a master device:
+	if (audiodevices[pahandle].opmode & kPortAudioIsMaster) repetitions = 0;
+
+	PsychCopyInDoubleArg(2, kPsychArgOptional, &repetitions);
+	if (repetitions < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'repetitions'. Valid values are zero or greater.");
+
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &when);
+	if (when < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'when'. Valid values are zero or greater.");
+
+	PsychCopyInIntegerArg(4, kPsychArgOptional, &waitForStart);
+	if (waitForStart < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'waitForStart'. Valid values are zero or greater.");
+
+	PsychCopyInDoubleArg(5, kPsychArgOptional, &stopTime);
+	if (stopTime <= when && (stopTime < DBL_MAX)) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'stopTime'. Valid values are greater than 'when' starttime.");
+
+	PsychCopyInIntegerArg(6, kPsychArgOptional, &resume);
+	if (resume < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'resume'. Valid values are zero or greater.");
+
+	if ((audiodevices[pahandle].opmode & kPortAudioMonitoring) == 0) {
+		// Not in monitoring mode: We must have in/outbuffers allocated:
+		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) && (audiodevices[pahandle].outputbuffer == NULL) && (audiodevices[pahandle].schedule == NULL) && (audiodevices[pahandle].ringBuffer == NULL)) PsychErrorExitMsg(PsychError_user, "Sound outputbuffer doesn't contain any sound to play?!?");
+		if ((audiodevices[pahandle].opmode & kPortAudioCapture) && (audiodevices[pahandle].inputbuffer == NULL)) PsychErrorExitMsg(PsychError_user, "Sound inputbuffer not prepared/allocated for capture?!?");
 	}
-	
-	// If the optional pahandle is provided...
-	if (PsychCopyInIntegerArg(1, kPsychArgOptional, &pahandle)) {
-		// ...then we use it to validate the configuration of the datamatrix for the new
-		// buffer against the requirements of that audiodevice pahandle:
-		if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
-		
-		if (inchannels != audiodevices[pahandle].outchannels) {
-			printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
-			PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
+
+	// Make sure current state is zero, aka fully stopped and engine is really stopped: Output a warning if this looks like an
+	// unintended "too early" restart: [No need to mutex-lock here, as iff these .state setting is not met,
+	// then we are good and they can't change by themselves behind our back -- paCallback() can't change .state to > 0]
+	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+		if (verbosity > 1) {
+			printf("PsychPortAudio-WARNING: 'Start' method on audiodevice %i called, although playback on device not yet completely stopped.\nWill forcefully restart with possible audible artifacts or timing glitches.\nCheck your playback timing or use the 'Stop' function properly!\n", pahandle);
 		}
 	}
 
-	if (inchannels < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 row for creation of at least one audio channel in your audio buffer!");
-	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample for creation of your audio buffer!");
-	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
+	// Safeguard: If the stream is not stopped in runMode 0, do it now:
+	if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) {
+		if (audiodevices[pahandle].runMode == 0) Pa_StopStream(audiodevices[pahandle].stream);
+	}
+	
+	// Mutex-lock here: Needed if engine already/still running in runMode1, doesn't hurt if engine is stopped
+	PsychPALockDeviceMutex(&audiodevices[pahandle]);
 
-	// Create buffer and assign bufferhandle:
-	bufferhandle = PsychPACreateAudioBuffer(inchannels, insamples);
+	// Reset statistics values:
+	audiodevices[pahandle].batchsize = 0;	
+	audiodevices[pahandle].xruns = 0;	
+	audiodevices[pahandle].paCalls = 0;
+	audiodevices[pahandle].noTime = 0;
+	audiodevices[pahandle].captureStartTime = 0;
+	audiodevices[pahandle].startTime = 0.0;
+	audiodevices[pahandle].workerFallback = 0;
+	audiodevices[pahandle].reqStopTime = stopTime;
+	audiodevices[pahandle].estStopTime = 0;
+	audiodevices[pahandle].currentTime = 0;		
+	if (!resume) audiodevices[pahandle].schedule_pos = 0;
+
+	// Buffers of the schedule may have changed while we were idle:
+	PsychPACompileSchedule(&audiodevices[pahandle]);
 	
-	// Deref bufferHandle:
-	buffer = PsychPAGetAudioBuffer(bufferhandle);
-	outdata = buffer->outputbuffer;
-	outbuffersize = buffer->outputbuffersize;
-	buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
+	// Reset recorded samples counter:
+	audiodevices[pahandle].recposition = 0;
 
-	if (indata) {
-		// Copy the data, convert it from double to float:
-		while(buffersize > 0) {
-			*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-			buffersize-=sizeof(float);
-		}
-	} else {
-		// Copy the float data:
-		while(buffersize > 0) {
-			*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-			buffersize-=sizeof(float);
+	// Reset read samples counter: This will discard possibly not yet fetched data.
+	audiodevices[pahandle].readposition = 0;
+
+	// Reset play position:
+	if (!resume) audiodevices[pahandle].playposition = 0;
+	if (!resume) audiodevices[pahandle].resamplePhase = 0;
+	
+	// Reset total count of played out samples:
+	if (!resume) audiodevices[pahandle].totalplaycount = 0;
+
+	// Reset ring buffer underrun counters:
+	if (!resume) audiodevices[pahandle].ringUnderruns = 0;
+	if (!resume) audiodevices[pahandle].ringUnderrunFrames = 0;
+
+	// Set number of requested repetitions: 0 means loop forever, default is 1 time.
+	audiodevices[pahandle].repeatCount = (repetitions == 0) ? -1 : repetitions;
+
+	// Reset any pending requests:
+	audiodevices[pahandle].reqstate = 255;
+
+	// Setup target start time:
+	audiodevices[pahandle].reqStartTime = when;
+
+	// Mark state as "hot-started":
+	audiodevices[pahandle].state = 1;
+
+	if (!(audiodevices[pahandle].opmode & kPortAudioIsSlave)) {
+		// Engine running?
+		if (!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream)) {
+			// Try to start stream if the engine isn't running, either because it is the very
+			// first call to 'Start' in any runMode, or because the engine got stopped in
+			// preparation for a restart in runMode zero. Need to drop the lock during
+			// call to Pa_StartStream to avoid deadlock:
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+			
+			// Safeguard: If the stream is not stopped, do it now:
+			if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
+			
+			// Start engine:
+			if ((err=Pa_StartStream(audiodevices[pahandle].stream))!=paNoError) {
+				printf("PTB-ERROR: Failed to start audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
+				PsychErrorExitMsg(PsychError_system, "Failed to start PortAudio audio device.");
+			}
+			
+			// Reacquire lock:
+			PsychPALockDeviceMutex(&audiodevices[pahandle]);
 		}
 	}
+	// From here on, the engine is running, and we have the mutex-lock. Unless we're a slave,
+	// then we have the lock but the engine may not be running yet.
 	
-	// Return bufferhandle:
-	PsychCopyOutDoubleArg(1, FALSE, (double) bufferhandle);
+	// Safety check for deadlock avoidance with waiting slaves:
+	if ((waitForStart > 0) && (audiodevices[pahandle].opmode & kPortAudioIsSlave) &&
+		(!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream) ||
+		 audiodevices[audiodevices[pahandle].pamaster].state < 1)) {
+		// We are a slave that shall wait for start, but the master audio device hasn't even
+		// started its engine. This looks like a deadlock to avoid:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		printf("PTB-ERROR: Failed to start audio device %i. You asked me to wait for start to happen, but the\n", pahandle);
+		printf("PTB-ERROR: master audio device %i isn't active yet, so i would hang forever! Aborting!!\n", audiodevices[pahandle].pamaster);
+		PsychErrorExitMsg(PsychError_user, "Asked to 'waitForStart' of a slave device, but associated master device not even started! Deadlock avoided!");
+	}
+	
+	// Wait for real start of playback/capture?
+	if (waitForStart > 0) {
+		// Device will be in state == 1 until playback really starts:
+		// We need to enter the first while() loop iteration with
+		// the device lock held from above, so the while() loop will iterate at
+		// least once...
+		while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+			// Wait for a state-change before reevaluating the .state:
+			PsychPAWaitForChange(&audiodevices[pahandle]);
+		}
+		
+		// Device has started (potentially even already finished for very short sounds!)
+		// In any case we have a valid .startTime to wait for in the device struct,
+		// which won't change by itself anymore, so it is safe to access unlocked.
+		// Unlock device:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		
+		// Ok, relevant audio buffer with real sound onset submit to engine.
+		// We now have an estimate of real sound onset in startTime, wait until
+		// then:
+		PsychWaitUntilSeconds(audiodevices[pahandle].startTime);
+		
+		// Engine should run now. Return real onset time:
+		PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
+	}
+	else {
+		// Unlock device:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+
+		// Return empty zero timestamp to signal that this info is not available:
+		PsychCopyOutDoubleArg(1, kPsychArgOptional, 0.0);
+	}
 
-	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('GetAudioData') - Retrieve captured audio data.
+/* PsychPortAudio('Stop') - Stop an audio device via PortAudio.
  */
-PsychError PSYCHPORTAUDIOGetAudioData(void) 
+PsychError PSYCHPORTAUDIOStopAudioDevice(void) 
 {
- 	static char useString[] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, singleType=0]);";
+ 	static char useString[] = "[startTime endPositionSecs xruns estStopTime] = PsychPortAudio('Stop', pahandle [, waitForEndOfPlayback=0] [, blockUntilStopped=1] [, repetitions] [, stopTime]);";
 	static char synopsisString[] = 
-		"Retrieve captured audio data from a audio device. 'pahandle' is the handle of the device "
-		"whose data is to be retrieved. 'audiodata' is a matrix with audio data in floating point format. Each "
-		"row of the matrix returns one sound channel, each column one sample for each channel. "
-		"Returned samples are in range -1.0 to +1.0, with 0.0 for silence. This is "
-		"intentionally a very restricted interface. For lowest latency and best timing we want you to accept audio "
-		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
-		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
-		"You must call this function once before start of capture operations to allocate an internal buffer "
-		"that stores captured audio data inbetween your periodic calls. Provide 'amountToAllocateSecs' as "
-		"requested buffersize in seconds. After start of capture you must call this function periodically "
-		"at least every 'amountToAllocateSecs' seconds to drain the internal buffer into your Matlab/Octave "
-		"matrix 'audiodata'. If you fail to call the function frequently enough, sound data will get lost!\n"
-		"'minimumAmountToReturnSecs' optional minimum amount of recorded data to return at each call. The "
-		"driver will only return control to your script when it was able to collect at least that amount "
-		"of seconds of sound data - or if the capture engine was stopped. If you don't set this parameter, "
-		"the driver will return immediately, giving you whatever amount of sound data was available - including "
-		"an empty matrix if nothing was available.\n"
-		"'maximumAmountToReturnSecs' allows you to optionally restrict the amount of returned sound data to "
-		"a specific duration in seconds. By default, you'll get whatever is available.\n"
-		"If you provide both, 'minimumAmountToReturnSecs' and 'maximumAmountToReturnSecs' and set them to equal "
-		"values (but significantly lower than the 'amountToAllocateSecs' buffersize!!) then you'll always "
-		"get an 'audiodata' matrix back that is of a fixed size. This may be convenient for postprocessing "
-		"in Matlab. It may also reduce or avoid Matlab memory fragmentation...\n"
-		"'singleType' if set to 1 will return a sound data matrix of single() type instead of double() type. "
-		"By default, double() type is returned. single() type matrices only consume half as much memory as "
-		"double() type matrices, without any loss of audio precision.\n"
-		"\n"
-		"\nOptional return arguments other than 'audiodata':\n\n"
-		"'absrecposition' is the absolute position (in samples) of the first column in the returned data matrix, "
-		"assuming that sample zero was the very first recorded sample in this session. The count is reset each time "
-		"you start a new capture session via call to PsychPortAudio('Start').\n"
-		"Each call to this function will return a new chunk of recorded sound data. The 'absrecposition' provides "
-		"you with absolute matrix column indices to stitch together the results of all calls into one seamless "
-		"recording if you want. 'overflow' if this flag is zero then everything went fine. If it is one then you "
-		"didn't manage to call this function frequent enough, the capacity of the internal recording buffer was "
-		"exceeded and therefore you lost captured sound data, i.e., there is a gap in your recording. When "
-		"initially allocating the internal buffer, make sure to allocate it big enough so it is able to easily "
-		"store all recorded data inbetween your calls to 'GetAudioData'. Example: You expect to call this routine "
-		"once every second in your trial loop, then allocate a sound buffer of at least 2 seconds for some security "
-		"headroom. If you know that the recording time of each recording has an upper bound then you can allocate "
-		"an internal buffer of sufficient size and fetch the buffer all at once at the end of a recording.\n"
-		"'ctsstarttime' this is an estimate of the system time (in seconds) when the very first sample of this "
-		"recording was captured by the sound input of your hardware. This is only a rough estimate, not to be "
-		"trusted down to the millisecond level, at least not without former careful calibration of your setup!\n";
-
+		"Stop a PortAudio audio device. The 'pahandle' is the handle of the device to stop.\n"
+		"'waitForEndOfPlayback' - If set to 1, this method will wait until playback of the "
+		"audio stream finishes by itself. This only makes sense if you perform playback with "
+		"a defined playback duration. The flag will be ignored when infinite repetition is "
+		"requested (as playback would never stop by itself, resulting in a hang) and if no "
+		"scheduled 'stopTime' has been set, either in this call or in the 'Start' function. "
+		"The setting will be also ignored if this is a pure recording session.\n"
+		"A setting of 0 (which is the default) requests stop of playback without waiting for all "
+		"the sound to be finished playing. Sound may continue to be played back for multiple "
+		"milliseconds after this call, as this is a polite request to the hardware to finish up.\n"
+		"A setting of 2 requests abortion of playback and/or capture as soon as possible with your "
+		"sound hardware, even if this creates audible artifacts etc. Abortion may or may not be faster "
+		"than a normal stop, this depends on your specific hardware, but our driver tries as hard as "
+		"possible to get the hardware to shut up. In a worst-case setting, the hardware would continue "
+		"to playback the sound data that is stored in its internal buffers, so the latency for stopping "
+		"sound would be the the same as the latency for starting sound as quickly as possible. E.g., "
+		"a 2nd generation Intel MacBook Pro seems to have a stop-delay of roughly 5-6 msecs under "
+		"optimal conditions (e.g., buffersize = 64, frequency=96000, OS/X 10.4.10, no other sound apps running).\n"
+		"A setting of 3 will not try to stop the playback now: You can use this setting if you just "
+		"want to use this function to wait until playback stops by itself, e.g. because the set "
+		"number of 'repetitions' or the set 'stopTime' has been reached. You can also use this to "
+		"just change the 'repetitions' or 'stopTime' settings without waiting for anything.\n"
+		"The optional parameter 'blockUntilStopped' defines if the subfunction should wait until "
+		"sound processing has really stopped (at a setting of 1, which is the default), or if the "
+		"function should return with minimal delay after only scheduling a stop at a zero setting. "
+		"If 'waitForEndOfPlayback' is set to 1, then 'blockUntilStopped' is meaningless and the function "
+		"will always block until the stop is completed.\n"
+		"The optional parameter 'stopTime' allows to set a defined system time when playback should "
+		"stop by itself. Similar, the optional 'repetitions' setting allows to change the number of "
+		"repetitions after which playback should stop by itself. These settings allow you to override "
+		"the same settings made during a call to the 'Start' or 'RescheduleStart' function.\n"
+		"The optional return argument 'startTime' returns an estimate of when the stopped "
+		"stream actually started its playback and/or recording. Its the same timestamp as the one "
+		"returned by the start command when executed in waiting mode. 'endPositionSecs' is the final "
+		"playback/recording position in seconds. 'xruns' is the number of buffer over- or underruns. "
+		"This should be zero if the playback operation was glitch-free, however a zero value doesn't "
+		"imply glitch free operation, as the glitch detection algorithm can miss some types of glitches. "
+		"The optional return argument 'estStopTime' returns an estimate of when playback likely stopped.\n"
+		"The return arguments are undefined if you set the 'blockUntilStopped' flag to zero.\n";
+	
 	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
-  	
-	//int inchannels, insamples, p, maxSamples;
-	psych_int64 insamples, maxSamples;
-	size_t buffersize;
-	double*	indata = NULL;
-	float*  indatafloat = NULL;
-	int pahandle   = -1;
-	int singleType = 0;
-	double allocsize;
-	double minSecs, maxSecs, minSamples;
-	int overrun = 0;
+	
+	PaError err;
+	int pahandle= -1;
+	int waitforend = 0;
+	int blockUntilStopped = 1;
+	double stopTime = -1;
+	double repetitions = -1;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -3630,454 +6338,480 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-	if ((audiodevices[pahandle].opmode & kPortAudioCapture) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio capture, so this call doesn't make sense.");
 
-	buffersize = audiodevices[pahandle].inputbuffersize;
+	// Get optional wait-flag:
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &waitforend);
+
+	// Get optional blockUntilStopped-flag:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &blockUntilStopped);
+
+	// Get new optional 'repetitions' count:
+	if (PsychCopyInDoubleArg(4, kPsychArgOptional, &repetitions)) {
+		// Argument provided: Range-Check and assign it:
+		if (repetitions < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'repetitions'. Valid values are zero or greater.");
+	}
+	else {
+		repetitions = -1;
+	}
+
+	// Get optional stopTime:
+	if (PsychCopyInDoubleArg(5, kPsychArgOptional, &stopTime)) {
+		if ((stopTime <= audiodevices[pahandle].reqStartTime) && (stopTime < DBL_MAX)) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'stopTime'. Valid values are greater than previously set 'when' starttime.");
+	}
+	else {
+		stopTime = -1;
+	}
+
+	// Lock device:
+	PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+	// New repetitions provided?
+	if (repetitions >=0) {
+		// Set number of requested repetitions: 0 means loop forever, default is 1 time.
+		audiodevices[pahandle].repeatCount = (repetitions == 0) ? -1 : repetitions;
+	}
 	
-	// Copy in optional amount of buffer memory to allocate for internal recording ringbuffer:
-	allocsize = 0;
-	PsychCopyInDoubleArg(2, kPsychArgOptional, &allocsize);
+	// New stopTime provided?
+	if (stopTime > 0) {
+		// Yes. Quickly assign it:
+		audiodevices[pahandle].reqStopTime = stopTime;
+	}
+	
+	// Wait for automatic stop of playback if requested: This only makes sense if we
+	// are in playback mode and not in infinite playback mode! Would not make sense in
+	// looping mode (infinite repetitions of playback) or pure recording mode. It is also
+	// allowed if we have infinite repetitions set, but a finite stopTime is defined, so
+	// the engine will eventually stop by itself. Same goes for an operative schedule which
+	// will run empty if not regularly updated:
+	if ((waitforend == 1) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0) &&
+		(audiodevices[pahandle].opmode & kPortAudioPlayBack) && ((audiodevices[pahandle].repeatCount != -1) || (audiodevices[pahandle].schedule) || (audiodevices[pahandle].reqStopTime < DBL_MAX))) {
+		while ( ((audiodevices[pahandle].runMode == 0) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) ||
+				((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
 
-	// Internal capture ringbuffer already allocated?
-	if (buffersize == 0) {
-		// Nope. This call needs to allocate it. We know the engine is idle in this case, because it
-		// can't be started or brought out of idle if buffersize == 0 due to checks in 'Start' and 'RescheduleStart'.
-		if (allocsize <= 0) PsychErrorExitMsg(PsychError_user, "You must first call this function with a positive 'amountToAllocateSecs' argument to allocate internal bufferspace first!");
-		
-		// Ready to allocate ringbuffer memory outside this if-clause...
+			// Wait for a state-change before reevaluating:
+			PsychPAWaitForChange(&audiodevices[pahandle]);
+		}
+	}
+	
+	// Lock held here in any case...
+	
+	if (waitforend == 3) {
+		// No immediate stop request: This was only either a query for end of playback,
+		// or a call to simply set new 'stopTime' or 'repetitions' parameters on the fly.
+		// Unlock the device and skip stop requests...
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 	}
 	else {
-		// Buffer already allocated. Need to realloc?
-		if (allocsize > 0) {
-			// Calling script wants to reallocate the buffer. Check if this is possible here:
+		// Some real immediate stop request wanted:
+		// Soft stop requested (as opposed to fast stop)?
+		if (waitforend!=2) {
+			// Softstop: Try to stop stream:
+			if (audiodevices[pahandle].state > 0) {
+				// Stream running. Request a stop of stream, to be honored by playback thread:
+				audiodevices[pahandle].reqstate = 0;
+			}
+				
+			// Drop lock, so request can get through...
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+				
+			// If blockUntilStopped is non-zero, then explicitely stop as well:
+			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) && (err=Pa_StopStream(audiodevices[pahandle].stream))!=paNoError) {
+				printf("PTB-ERROR: Failed to stop audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
+				PsychErrorExitMsg(PsychError_system, "Failed to stop PortAudio audio device.");
+			}
+		}
+		else {
+			// Faststop: Try to abort stream. Skip if already stopped/not yet started:
 			
-			// Test 1: Engine running? [No need to mutex lock: If running, we fail safely. If state = 0 it can't transition to > 0 behind our back]
-			if (audiodevices[pahandle].state > 0) PsychErrorExitMsg(PsychError_user, "Tried to resize internal buffer while recording engine is running! You must stop recording before resizing the buffer!");
+			// Stream active?
+			if (audiodevices[pahandle].state > 0) {
+				// Yes. Set the 'state' flag to signal our IO-Thread not to push any audio
+				// data anymore, but only zeros for silence and to paAbort asap:
+				audiodevices[pahandle].reqstate = 3;
+			}
+			
+			// Drop lock, so request can get through...
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+			
+			// If blockUntilStopped is non-zero, then send abort request to hardware:
+			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) && ((err=Pa_AbortStream(audiodevices[pahandle].stream))!=paNoError)) {
+				printf("PTB-ERROR: Failed to abort audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
+				PsychErrorExitMsg(PsychError_system, "Failed to fast stop (abort) PortAudio audio device.");
+			}
+		}
+	}
+	
+	// No lock held here...
+
+	// Wait for real stop:
+	if (blockUntilStopped > 0) {
+		// Lock device:
+		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+		// Wait for stop / idle:
+		if (Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+			while ( ((audiodevices[pahandle].runMode == 0) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) ||
+					((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
+				
+				// Wait for a state-change before reevaluating:
+				PsychPAWaitForChange(&audiodevices[pahandle]);
+			}
+		}
+		
+		// We are stopped/idle, with lock held:
+		
+		// Need to update stream state and reqstate manually here, as the Pa_Stop/AbortStream()
+		// requests may have stopped the paCallback() thread before it could update/honor state/reqstate by himself.
+
+		// Mark state as stopped:
+		audiodevices[pahandle].state = 0;
+		
+		// Reset request to none:
+		audiodevices[pahandle].reqstate = 255;
+
+		// Can unlock here, as the fields we're interested in will remain static with an idle/stopped engine:
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+
+		// Copy out our estimate of when playback really started for the just stopped stream:
+		PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
+		
+		// Copy out final playback position (secs) since start:
+		PsychCopyOutDoubleArg(2, kPsychArgOptional, ((double)(audiodevices[pahandle].playposition / audiodevices[pahandle].outchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate);
+		
+		// Copy out number of buffer over-/underflows since start:
+		PsychCopyOutDoubleArg(3, kPsychArgOptional, audiodevices[pahandle].xruns);
+
+		// Copy out estimated stopTime:
+		PsychCopyOutDoubleArg(4, kPsychArgOptional, audiodevices[pahandle].estStopTime);
+	}
+	else {
+		// No block until stopped. That means we won't have meaningful return arguments available.
+		// Just return dummy args to signal this:
+		PsychCopyOutDoubleArg(1, kPsychArgOptional, -1);
+		
+		// Copy out final playback position (secs) since start:
+		PsychCopyOutDoubleArg(2, kPsychArgOptional, -1);
+		
+		// Copy out number of buffer over-/underflows since start:
+		PsychCopyOutDoubleArg(3, kPsychArgOptional, -1);
+
+		// Copy out estimated stopTime:
+		PsychCopyOutDoubleArg(4, kPsychArgOptional, -1);
+	}
+
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('GetStatus') - Return current status of stream.
+ */
+PsychError PSYCHPORTAUDIOGetStatus(void) 
+{
+ 	static char useString[] = "status = PsychPortAudio('GetStatus', pahandle);";
+	static char synopsisString[] = 
+		"Returns 'status', a struct with status information about the current state of device 'pahandle'.\n"
+		"The struct contains the following fields:\n"
+		"Active: Can be 1 if playback or recording is active, or 0 if playback/recording is stopped or not yet started.\n"
+		"RequestedStartTime: Is the requested start time of the audio stream after start of playback/recording. "
+		"StartTime: Is the real start time of the audio stream after start of playback/recording. If both, playback and "
+		"recording are active (full-duplex mode), it is the start time of sound playback, ie an estimate of when the first "
+		"sample hit the speakers. Same goes for pure playback. \n"
+		"CaptureStartTime: Start time of audio capture (if any is active) - an estimate of when the first sound sample was "
+		"captured. In pure capture mode, this is nearly identical to StartTime, but whenever playback is active, StartTime and "
+		"CaptureStartTime will differ. CaptureStartTime doesn't take the user provided 'LatencyBias' into account.\n"
+		"RequestedStopTime: The requested stop / sound offset time for playback of sounds, as selected via the 'stopTime' "
+		"paramter in the 'Start', 'RescheduleStart' or 'Stop' function. This will show a very large (~ infinite) value "
+		"if no stop time has been sprecified.\n"
+		"EstimatedStopTime: Estimated time when sound playback has stopped. This is an estimate of when exactly the last "
+		"audio sample will leave the speaker. The value is zero as long as the estimate isn't available. Due to the latency "
+		"involved in sound playback, the value may become available a few msecs before or after actual sound offset.\n"
+		"CurrentStreamTime: Estimate of when the most recently submitted sample will hit the speaker. This corresponds "
+		"roughly to 'PositionSecs' below, but in absolute realtime.\n"
+		"ElapsedOutSamples: Total number of samples played out since start of playback. This count increments monotonically "
+		"from start of playback to stop of playback. This denotes the absolute sample position that will hit the speaker "
+		"at time 'CurrentStreamTime'. \n"
+		"PositionSecs is an estimate of the current stream playback position in seconds within the current playback loop "
+		"of the current buffer. it's not totally accurate, because "
+		"it measures how much sound has been submitted to the sound system, not how much sound has left the "
+		"speakers, i.e., it doesn't take driver and hardware latency into account.\n"
+		"SchedulePosition: Current position in a running schedule, if any.\n"
+		"XRuns: Number of dropouts due to buffer overrun or underrun conditions.\n"
+		"TotalCalls, TimeFailed and BufferSize are only for debugging of PsychPortAudio itself.\n"
+		"CPULoad: How much load does the playback engine impose on the CPU? Values can range from 0.0 = 0% "
+		"to 1.0 for 100%. Values close to 1.0 indicate that your system can't handle the load and timing glitches "
+		"or sound glitches are likely. In such a case, try to reduce the load on your system.\n"
+		"PredictedLatency: Is the latency in seconds of your driver+hardware combo. It tells you, "
+		"how far ahead of time a sound device must be started ahead of the requested onset time via "
+		"PsychPortAudio('Start'...) to make sure it actually starts playing in time. High quality systems like "
+		"Linux or MacOS/X may allow values as low as 5 msecs or less on standard hardware. Other operating "
+		"systems may require dozens or hundreds of milliseconds of headstart. Caution: In full-duplex mode, "
+		"this value only refers to the latency on the sound output, not in the sound input! Also, this is just "
+		"an estimate, not 100% reliable.\n"
+		"LatencyBias: Is an additional bias setting you can impose via PsychPortAudio('LatencyBias', pahandle, bias); "
+		"in case our drivers estimate is a bit off. Allows fine-tuning.\n"
+		"SampleRate: Is the sampling rate for playback/recording in samples per second (Hz).\n"
+		"OutDeviceIndex: Is the deviceindex of the playback device, or -1 if not opened for playback. "
+		"You can pass OutDeviceIndex to PsychPortAudio('GetDevices', [], OutDeviceIndex); to query information "
+		"about the device.\n"
+		"InDeviceIndex: Is the deviceindex of the capture device, or -1 if not opened for capture.\n"
+		"RecordedSecs: Is the total amount of recorded sound data (in seconds) since start of capture.\n"
+		"ReadSecs: Is the total amount of sound data (in seconds) that has been fetched from the internal buffer. "
+		"The difference between RecordedSecs and ReadSecs is the amount of recorded sound data pending for retrieval.\n"
+		"RingUnderruns: In ring buffer mode (see 'UseRingBuffer'), the number of times playback ran out of pushed sound data "
+		"since start of playback, so silence had to be inserted.\n"
+		"RingUnderrunSecs: Total duration of silence (in seconds) inserted due to ring buffer underruns.\n"
+		"RingQueuedSecs: Amount of sound data (in seconds) pushed into the ring buffer, but not yet played out.\n"
+		"CaptureFileActive: 1 if captured sound data is streamed to a file via 'CaptureToFile', 0 otherwise.\n"
+		"CaptureFileFrames: Number of sample frames written to the file by the current or last 'CaptureToFile' writer.\n"
+		"CaptureFileOverflows: Number of times the capture buffer overflowed, because the file writer couldn't keep up.\n"
+		"CaptureFileLostFrames: Number of captured sample frames lost due to such overflows. ";
 
-			// Test 2: Pending samples to read from current ringbuffer? Engine is idle, so we can safely access device data lock-free...
-			if (audiodevices[pahandle].readposition < audiodevices[pahandle].recposition) PsychErrorExitMsg(PsychError_user, "Tried to resize internal buffer without emptying it beforehand. You must drain the buffer before resizing it!");
+	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
+	PsychGenericScriptType 	*status;
+	double currentTime;
+	psych_int64 playposition, totalplaycount;
 
-			// Ok, reallocation allowed, as engine is idle. Delete old buffer:
-			audiodevices[pahandle].inputbuffersize = 0;
-			free(audiodevices[pahandle].inputbuffer);
-			audiodevices[pahandle].inputbuffer = NULL;
-			
-			// At this point we are ready to re-allocate ringbuffer outside this if-clause...
-		}
-	}
+	const char *FieldNames[]={	"Active", "State", "RequestedStartTime", "StartTime", "CaptureStartTime", "RequestedStopTime", "EstimatedStopTime", "CurrentStreamTime", "ElapsedOutSamples", "PositionSecs", "RecordedSecs", "ReadSecs", "SchedulePosition",
+								"XRuns", "TotalCalls", "TimeFailed", "BufferSize", "CPULoad", "PredictedLatency", "LatencyBias", "SampleRate",
+								"OutDeviceIndex", "InDeviceIndex", "RingUnderruns", "RingUnderrunSecs", "RingQueuedSecs",
+								"CaptureFileActive", "CaptureFileFrames", "CaptureFileOverflows", "CaptureFileLostFrames" };
+	int pahandle = -1;
 	
-	// Still (re-)allocation wanted?
-	if (allocsize > 0) {
-		// We know the engine is idle if we reach this point, so no need to acquire locks or check state...
-		
-		// Calculate needed buffersize in samples: Convert allocsize in seconds to size in bytes:
-		audiodevices[pahandle].inputbuffersize = sizeof(float) * ((psych_int64) (allocsize * audiodevices[pahandle].streaminfo->sampleRate)) * audiodevices[pahandle].inchannels;
-		audiodevices[pahandle].inputbuffer = (float*) calloc(1, audiodevices[pahandle].inputbuffersize);
-		if (audiodevices[pahandle].inputbuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Free system memory exhausted when trying to allocate audio recording buffer!");
-
-		// This was an (re-)allocation call, so no data is pending in the buffer.
-		// Therefore we don't return any data, just reset the counters:
-		audiodevices[pahandle].recposition = 0;
-		audiodevices[pahandle].readposition = 0;
-		return(PsychError_none);
-	}
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	// This is not an allocation call, but a real data fetch call:
+	PsychErrorExit(PsychCapNumInputArgs(1));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
-	// Get optional "minimum amount to return" argument:
-	// We default to "whatever we can get" ie. zero seconds.
-	minSecs = 0;
-	PsychCopyInDoubleArg(3, kPsychArgOptional, &minSecs);
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
 
-	// Get optional "maximum amount to return" argument:
-	// We default to "whatever we can get" ie. infinite seconds.
-	maxSecs = 0;
-	PsychCopyInDoubleArg(4, kPsychArgOptional, &maxSecs);
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	// Get optional singleType flag:
-	PsychCopyInIntegerArg(5, kPsychArgOptional, &singleType);
-	if (singleType < 0 || singleType > 1) PsychErrorExitMsg(PsychError_user, "'singleType' flag must be zero or one!");
+	PsychAllocOutStructArray(1, kPsychArgOptional, 1, 30, FieldNames, &status);
 
-	// The engine is potentially running, so we need to mutex-lock our accesses...
+	// Ok, in a perfect world we should hold the device mutex while querying all the device state.
+	// However, we don't: This reduces lock contention at the price of a small chance that the
+	// fetched information is not 100% up to date / that this is not an atomic snapshot of state.
+	//
+	// Instead we only hold the lock to get the most crucial values atomically, then release and get the rest
+	// while not holding the lock:
 	PsychPALockDeviceMutex(&audiodevices[pahandle]);
-
-	// How much samples are available in ringbuffer to fetch?
-	insamples = (psych_int64) (audiodevices[pahandle].recposition - audiodevices[pahandle].readposition);
-	
-	// Convert amount of available data into seconds and check if our minimum
-	// requirements are fulfilled:
-	if (minSecs > 0) {
-		// Convert seconds to samples:
-		minSamples = minSecs * ((double) audiodevices[pahandle].streaminfo->sampleRate) * ((double) audiodevices[pahandle].inchannels) + ((double) audiodevices[pahandle].inchannels);
-
-		// Bigger than buffersize? That would be a no no...
-		if (((psych_int64) minSamples * sizeof(float)) > audiodevices[pahandle].inputbuffersize) {
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-			PsychErrorExitMsg(PsychError_user, "Invalid 'minimumAmountToReturnSecs' parameter: The requested minimum is bigger than the whole capture buffer size!'");			
-		}
-		
-		// Loop until either request is fullfillable or the device gets stopped - in which
-		// case we'll never be able to fullfill the request...
-		while (((double) insamples < minSamples) && (audiodevices[pahandle].state > 0)) {
-			// Compute amount of time to elapse before request could be fullfilled:
-			minSecs = (minSamples - (double) insamples) / ((double) audiodevices[pahandle].inchannels) / ((double) audiodevices[pahandle].streaminfo->sampleRate);
-			// Ok, required data will be available earliest in 'minSecs' seconds. Sleep until then with lock dropped:
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-			PsychWaitIntervalSeconds(minSecs);
-			PsychPALockDeviceMutex(&audiodevices[pahandle]);
-			
-			// We've slept at least the estimated amount of required time. Recalculate amount
-			// of available sound data and check again...
-			insamples = (psych_int64) (audiodevices[pahandle].recposition - audiodevices[pahandle].readposition);
-		}
-	}
-	
-	// Lock held here...
-	
-	// Never ever fetch the samples for the last sampleframe. We do not want to fetch
-	// a possibly not yet updated or incomplete sample frame. Leave this to next call
-	// of this function. Well, unless state is zero == engine stopped. In that case we
-	// know that the playhead won't move anymore and we can safely fetch all remaining
-	// data.
-	if (audiodevices[pahandle].state > 0) {
-		insamples = insamples - (insamples % audiodevices[pahandle].inchannels);
-		insamples-= audiodevices[pahandle].inchannels;
-	}
-
-	// Can unlock here: The remainder of the routine doesn't touch any critical device variables anymore,
-	// only variables that aren't modified by the engine, or not used/touched by engine.
-	// Well, theoretically the engine could overwrite the portion of the buffer we're going to
-	// read out if we stall massively and the capturebuffer is way too "undersized", but in that
-	// case the user code is screwed anyway and it (or the system) needs to be fixed...
+	currentTime = audiodevices[pahandle].currentTime;
+	totalplaycount = audiodevices[pahandle].totalplaycount;
+	playposition = audiodevices[pahandle].playposition;
 	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 	
-	insamples = (insamples < 0) ? 0 : insamples;
-	buffersize = insamples * sizeof(float);
+	// Atomic snapshot for remaining fields would only be needed for low-level debugging, so who cares?
+	PsychSetStructArrayDoubleElement("Active", 0, (audiodevices[pahandle].state >= 2) ? 1 : 0, status);
+	PsychSetStructArrayDoubleElement("State", 0, audiodevices[pahandle].state, status);
+	PsychSetStructArrayDoubleElement("RequestedStartTime", 0, audiodevices[pahandle].reqStartTime, status);
+	PsychSetStructArrayDoubleElement("StartTime", 0, audiodevices[pahandle].startTime, status);
+	PsychSetStructArrayDoubleElement("CaptureStartTime", 0, audiodevices[pahandle].captureStartTime, status);
+	PsychSetStructArrayDoubleElement("RequestedStopTime", 0, audiodevices[pahandle].reqStopTime, status);
+	PsychSetStructArrayDoubleElement("EstimatedStopTime", 0, audiodevices[pahandle].estStopTime, status);
+	PsychSetStructArrayDoubleElement("CurrentStreamTime", 0, currentTime, status);	
+	PsychSetStructArrayDoubleElement("ElapsedOutSamples", 0, ((double)(totalplaycount / audiodevices[pahandle].outchannels)), status);
+	PsychSetStructArrayDoubleElement("PositionSecs", 0, ((double)(playposition / audiodevices[pahandle].outchannels)) / ((audiodevices[pahandle].resampler && (audiodevices[pahandle].playoutSampleRate > 0)) ? audiodevices[pahandle].playoutSampleRate : (double) audiodevices[pahandle].streaminfo->sampleRate), status);
+	PsychSetStructArrayDoubleElement("RecordedSecs", 0, ((double)(audiodevices[pahandle].recposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
+	PsychSetStructArrayDoubleElement("ReadSecs", 0, ((double)(audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
+	PsychSetStructArrayDoubleElement("SchedulePosition", 0, audiodevices[pahandle].schedule_pos, status);
+	PsychSetStructArrayDoubleElement("XRuns", 0, audiodevices[pahandle].xruns, status);
+	PsychSetStructArrayDoubleElement("TotalCalls", 0, audiodevices[pahandle].paCalls, status);
+	PsychSetStructArrayDoubleElement("TimeFailed", 0, audiodevices[pahandle].noTime, status);
+	PsychSetStructArrayDoubleElement("BufferSize", 0, audiodevices[pahandle].batchsize, status);
+	PsychSetStructArrayDoubleElement("CPULoad", 0, (Pa_IsStreamActive(audiodevices[pahandle].stream)) ? Pa_GetStreamCpuLoad(audiodevices[pahandle].stream) : 0.0, status);
+	PsychSetStructArrayDoubleElement("PredictedLatency", 0, audiodevices[pahandle].predictedLatency, status);
+	PsychSetStructArrayDoubleElement("LatencyBias", 0, audiodevices[pahandle].latencyBias, status);
+	PsychSetStructArrayDoubleElement("SampleRate", 0, audiodevices[pahandle].streaminfo->sampleRate, status);
+	PsychSetStructArrayDoubleElement("OutDeviceIndex", 0, audiodevices[pahandle].outdeviceidx, status);
+	PsychSetStructArrayDoubleElement("InDeviceIndex", 0, audiodevices[pahandle].indeviceidx, status);
+	PsychSetStructArrayDoubleElement("RingUnderruns", 0, (double) audiodevices[pahandle].ringUnderruns, status);
+	PsychSetStructArrayDoubleElement("RingUnderrunSecs", 0, (double) audiodevices[pahandle].ringUnderrunFrames / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
+	PsychSetStructArrayDoubleElement("RingQueuedSecs", 0, (audiodevices[pahandle].ringBuffer) ? ((double) (unsigned int) (audiodevices[pahandle].ringWritePos - audiodevices[pahandle].ringReadPos) / (double) audiodevices[pahandle].outchannels / (double) audiodevices[pahandle].streaminfo->sampleRate) : 0.0, status);
+	PsychSetStructArrayDoubleElement("CaptureFileActive", 0, (audiodevices[pahandle].captureWriter) ? 1 : 0, status);
+	PsychSetStructArrayDoubleElement("CaptureFileFrames", 0, (double) audiodevices[pahandle].captureFileFrames, status);
+	PsychSetStructArrayDoubleElement("CaptureFileOverflows", 0, (double) audiodevices[pahandle].captureFileOverflows, status);
+	PsychSetStructArrayDoubleElement("CaptureFileLostFrames", 0, (double) audiodevices[pahandle].captureFileLostFrames, status);
+	return(PsychError_none);
+}
 
-	// Buffer "overflow" detected?
-	if (buffersize > audiodevices[pahandle].inputbuffersize) {
-		// Ok, the buffer did overrun and captured data was lost. Limit returned data
-		// to buffersize and set the overrun flag, optionally output a warning:
-		buffersize = audiodevices[pahandle].inputbuffersize;
-		insamples = buffersize / sizeof(float);
-		
-		// Set overrun flag:
-		overrun = 1;
-		
-		if (verbosity > 1) printf("PsychPortAudio-WARNING: Overflow of audio capture buffer detected. Some sound data will be lost!\n");
-	}
-	
-	// Limitation of returned amount of data wanted?
-	if (maxSecs > 0) {
-		// Yes. Convert maximum amount in seconds to maximum amount in samples:
-		maxSamples = (psych_int64) (ceil(maxSecs * ((double) audiodevices[pahandle].streaminfo->sampleRate)) * ((double) audiodevices[pahandle].inchannels));
-		// Clamp insamples to that value, if neccessary:
-		if (insamples > maxSamples) {
-			insamples = maxSamples;
-			buffersize = insamples * sizeof(float);
-		}
-	}
-	
-	if (singleType & 1) {
-		// Allocate output float matrix with matching number of channels and samples:
-		PsychAllocOutFloatMatArg(1, FALSE, audiodevices[pahandle].inchannels, insamples / audiodevices[pahandle].inchannels, 1, &indatafloat);
-	}
-	else { 
-		// Allocate output double matrix with matching number of channels and samples:
-		PsychAllocOutDoubleMatArg(1, FALSE, audiodevices[pahandle].inchannels, insamples / audiodevices[pahandle].inchannels, 1, &indata);
-	}
+/* PsychPortAudio('Verbosity') - Set level of verbosity.
+ */
+PsychError PSYCHPORTAUDIOVerbosity(void) 
+{
+ 	static char useString[] = "oldlevel = PsychPortAudio('Verbosity' [,level]);";
+	static char synopsisString[] = 
+		"Set level of verbosity for error/warning/status messages. 'level' optional, new level "
+		"of verbosity. 'oldlevel' is the old level of verbosity. The following levels are "
+		"supported: 0 = Shut up. 1 = Print errors, 2 = Print also warnings, 3 = Print also some info, "
+		"4 = Print more useful info (default), >5 = Be very verbose (mostly for debugging the driver itself). ";		
+	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
 	
-	// Copy out absolute sample read position of first sample in buffer:
-	PsychCopyOutDoubleArg(2, FALSE, (double) (audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels));
+	int level= -1;
 
-	// Copy the data, convert it from float to double: Take ringbuffer wraparound into account:
-	if (indatafloat) {
-		// Copy to float/single matrix:
-		while(buffersize > 0) {
-			// Fetch next sample and copy it to matrix:
-			*(indatafloat++) = (float) audiodevices[pahandle].inputbuffer[(audiodevices[pahandle].readposition % (audiodevices[pahandle].inputbuffersize / sizeof(float)))];
-			
-			// Update sample read counter:
-			audiodevices[pahandle].readposition++;
-			
-			// Decrement copy counter:
-			buffersize-=sizeof(float);
-		}
-	}
-	else {
-		// Copy to double matrix:
-		while(buffersize > 0) {
-			// Fetch next sample and copy it to matrix:
-			*(indata++) = (double) audiodevices[pahandle].inputbuffer[(audiodevices[pahandle].readposition % (audiodevices[pahandle].inputbuffersize / sizeof(float)))];
-			
-			// Update sample read counter:
-			audiodevices[pahandle].readposition++;
-			
-			// Decrement copy counter:
-			buffersize-=sizeof(float);
-		}
-	}
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	// Copy out overrun flag:
-	PsychCopyOutDoubleArg(3, FALSE, (double) overrun);
+	PsychErrorExit(PsychCapNumInputArgs(1));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
-	// Return capture timestamp in system time of first captured sample in this session. This is a bit problematic:
-	// In full-duplex mode, at least OS/X doesn't return separate timestamps, so we'll provide the playback onset time
-	// instead - the best we can do. In pure capture mode we get a capture timestamp...
-	PsychCopyOutDoubleArg(4, FALSE, (audiodevices[pahandle].captureStartTime > 0) ? audiodevices[pahandle].captureStartTime : audiodevices[pahandle].startTime);
+	PsychCopyInIntegerArg(1, kPsychArgOptional, &level);
+	if (level < -1) PsychErrorExitMsg(PsychError_user, "Invalid level of verbosity provided. Valid are levels of zero and greater.");
 	
-	// Buffer ready.
-	return(PsychError_none);
-}
+	// Return current/old level:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) verbosity);
 
-/* PsychPortAudio('RescheduleStart') - Set new start time for an already running audio device via PortAudio.
- */
-PsychError PSYCHPORTAUDIORescheduleStart(void) 
-{
- 	static char useString[] = "startTime = PsychPortAudio('RescheduleStart', pahandle, when [, waitForStart=0] [, repetitions] [, stopTime]);";
-	static char synopsisString[] = 
-		"Modify requested start time 'when' of an already started PortAudio audio device.\n"
-		"After you've started an audio device via the 'Start' subfunction, but *before* the "
-		"device has really started playback (because the 'when' time provided to the 'Start' "
-		"method is still far in the future), you can use this function to reschedule the start for "
-		"a different 'when' time - including a value of zero for immediate start.\n"
-		"\n"
-		"The 'pahandle' is the handle of the device to start. Starting a "
-		"device means: Start playback of output devices, start recording on capture device, do both on "
-		"full duplex devices. 'waitForStart' if set to 1 will wait until device has really started, default "
-		"is to continue immediately, ie. only schedule start of device. 'when' Requested time, when device "
-		"should start. Defaults to zero, i.e. start immediately. If set to a non-zero system time, PTB will "
-		"do its best to start the device at the requested time, but the accuracy of start depends on the "
-		"operating system, audio hardware and system load. If 'waitForStart' is set to non-zero value, ie "
-		"if PTB should wait for sound onset, then the optional return argument 'startTime' will contain an "
-		"estimate of when the first audio sample hit the speakers, i.e., the real start time.\n"
-		"Please note that the 'when' value always refers to playback, so it defines the starttime of "
-		"playback. The start time of capture is related to the start time of playback in duplex mode, "
-		"but it isn't the same. In pure capture mode (without playback), 'when' will be ignored and "
-		"capture always starts immediately. See the help for subfunction 'GetStatus' for more info on "
-		"the meaning of the different timestamps.\n"
-		"The 'repetitions' parameter will change the number of playback repetitions if provided. The "
-		"value for 'repetitions' from the PsychPortAudio('Start') function will be used if the parameter "
-		"is omitted. See explanation in the 'Start' function for its meaning.\n"
-		"'stopTime' is an optional override for the 'stopTime' parameter from the 'Start' function, see "
-		"explanations there.\n";
+	// Set new level, if one was provided:
+	if (level > -1) verbosity = level;
+
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('GetOpenDeviceCount') - Get number of open audio devices.
+ */
+PsychError PSYCHPORTAUDIOGetOpenDeviceCount(void) 
+{
+ 	static char useString[] = "count = PsychPortAudio('GetOpenDeviceCount');";
+	static char synopsisString[] = "Return the number of currently open audio devices.\n";
+	static char seeAlsoString[] = "Open ";	 
 
-	static char seeAlsoString[] = "Open";	 
-  	
-	PaError err;
-	int pahandle= -1;
-	int waitForStart = 0;
-	double when = 0.0;
-	double repetitions = -1;
-	double stopTime = -1;
-	 
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumInputArgs(0));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
-	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-	if ((audiodevices[pahandle].opmode & kPortAudioMonitoring) == 0) {
-		// Not in monitoring mode: We must have in/outbuffers allocated:
-		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) && (audiodevices[pahandle].outputbuffer == NULL) && (audiodevices[pahandle].schedule == NULL)) PsychErrorExitMsg(PsychError_user, "Sound outputbuffer doesn't contain any sound to play?!?");
-		if ((audiodevices[pahandle].opmode & kPortAudioCapture) && (audiodevices[pahandle].inputbuffer == NULL)) PsychErrorExitMsg(PsychError_user, "Sound inputbuffer not prepared/allocated for capture?!?");
-	}
-
-	// Get new required 'when' start time:
-	PsychCopyInDoubleArg(2, kPsychArgRequired, &when);
-	if (when < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'when'. Valid values are zero or greater.");
-
-	PsychCopyInIntegerArg(3, kPsychArgOptional, &waitForStart);
-	if (waitForStart < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'waitForStart'. Valid values are zero or greater.");
-
-	// Get new optional 'repetitions' count:
-	if (PsychCopyInDoubleArg(4, kPsychArgOptional, &repetitions)) {
-		// Argument provided: Range-Check and assign it:
-		if (repetitions < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'repetitions'. Valid values are zero or greater.");
-	}
-	else {
-		repetitions = -1;
-	}
+	// Return count:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevicecount);
 
-	// Get new optional 'stopTime':
-	if (PsychCopyInDoubleArg(5, kPsychArgOptional, &stopTime)) {
-		// Argument provided: Range-Check and assign it:
-		if (stopTime <= when && (stopTime < DBL_MAX)) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'stopTime'. Valid values are greater than 'when' starttime.");
-	}
-	else {
-		stopTime = -1;
-	}
+	return(PsychError_none);
+}
 
-	// Audio engine running? That is the minimum requirement for this function to work:
-	if (!Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Audio device not started. You need to call the 'Start' function first!");
+/* PsychPortAudio('LatencyBias') - Set a manual bias for the latencies we operate on.
+ */
+PsychError PSYCHPORTAUDIOLatencyBias(void) 
+{
+ 	static char useString[] = "oldbias = PsychPortAudio('LatencyBias', pahandle [,biasSecs]);";
+	static char synopsisString[] = 
+		"Set audio output latency bias in seconds to 'biasSecs' and/or return old bias for a device "
+		"'pahandle'. The device must be open for this setting to take effect. It is reset to zero at "
+		"each reopening of the device. PsychPortAudio computes a latency value for the expected latency "
+		"of an audio output device to get its timing right. If this latency value is slightly off for "
+		"some reason, you can provide a bias value with this function to correct the computed value.\n\n"
+		"Please note that this 'biasSecs' setting is applied to either audio playback or audio capture "
+		"if your device is configured in simplex mode, either for playback *or* capture. If your device "
+		"is opened in full-duplex mode for simultaneous capture and playback, then the bias value is only "
+		"applied to the playback timing and timestamps, but not to the capture timing and timestamps!\n\n"
+		"See the online help for PsychPortAudio for more in depth explanation of latencies. ";
 
-	// Lock the device:
-	PsychPALockDeviceMutex(&audiodevices[pahandle]);
-	
-	// Whatever the current scheduled starttime is, override it to be infinity:
-	audiodevices[pahandle].reqStartTime = DBL_MAX;
+	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
 	
-	// Reset any pending requests:
-	audiodevices[pahandle].reqstate = 255;
+	double bias= DBL_MAX;
+	int pahandle = -1;
 
-	// Engine is running. Is it in a state ready for rescheduling a start?
-	
-	// In runMode zero it must be in hot-standby as immediately after a 'Start' in order to be reschedulable:
-	if ((audiodevices[pahandle].runMode == 0) && (audiodevices[pahandle].state != 1)) {
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-		PsychErrorExitMsg(PsychError_user, "Audio device not started and waiting. You need to call the 'Start' function first with an infinite 'when' time or a 'when' time in the far future!");
-	}
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	// In runMode 1 the device itself is always running and has to be in a logically stopped/idle (=0) state or hotstandby for rescheduling.
-	if ((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 1)) {
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-		PsychErrorExitMsg(PsychError_user, "Audio device not idle. Make sure it is idle first, e.g., by proper use of the 'Stop' function or by checking its 'Active' state via the 'GetStatus' function!");
-	}
-
-	// Audio engine is in a proper state for rescheduling now: 
-
-	// New repetitions provided?
-	if (repetitions >=0) {
-		// Set number of requested repetitions: 0 means loop forever, default is 1 time.
-		audiodevices[pahandle].repeatCount = (repetitions == 0) ? -1 : repetitions;
-	}
-
-	// New stopTime provided?
-	if (stopTime >= 0) audiodevices[pahandle].reqStopTime = stopTime;
+	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
-	// Reset statistics:
-	audiodevices[pahandle].xruns = 0;	
-	audiodevices[pahandle].noTime = 0;
-	audiodevices[pahandle].captureStartTime = 0;
-	audiodevices[pahandle].startTime = 0.0;
-	audiodevices[pahandle].estStopTime = 0;
-	audiodevices[pahandle].currentTime = 0;		
-	audiodevices[pahandle].schedule_pos = 0;
-	
-	// Reset recorded samples counter:
-	audiodevices[pahandle].recposition = 0;
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
 
-	// Reset read samples counter: This will discard possibly not yet fetched data.
-	audiodevices[pahandle].readposition = 0;
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	// Reset play position:
-	audiodevices[pahandle].playposition = 0;
-	
-	// Reset total count of played out samples:
-	audiodevices[pahandle].totalplaycount = 0;
+	// Copy in optional new bias value:
+	PsychCopyInDoubleArg(2, kPsychArgOptional, &bias);
 	
-	// Setup new rescheduled target start time:
-	audiodevices[pahandle].reqStartTime = when;
-
-	if (audiodevices[pahandle].runMode == 1) {
-		// Set the state to hot-standby to actually make this scheduling request active:
-		audiodevices[pahandle].state = 1;
-	}
-
-	// Safety check for deadlock avoidance with waiting slaves:
-	if ((waitForStart > 0) && (audiodevices[pahandle].opmode & kPortAudioIsSlave) &&
-		(!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream) ||
-		 audiodevices[audiodevices[pahandle].pamaster].state < 1)) {
-		// We are a slave that shall wait for start, but the master audio device hasn't even
-		// started its engine. This looks like a deadlock to avoid:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-		printf("PTB-ERROR: Failed to reschedule start of audio device %i. You asked me to wait for start to happen, but the\n", pahandle);
-		printf("PTB-ERROR: master audio device %i isn't active yet, so i would hang forever! Aborting!!\n", audiodevices[pahandle].pamaster);
-		PsychErrorExitMsg(PsychError_user, "Asked to 'waitForStart' of a slave device, but associated master device not even started! Deadlock avoided!");
-	}
-
-	if (waitForStart>0) {
-		// Wait for real start of device: We enter the first while() loop iteration with
-		// the device lock still held from above, so the while() loop will iterate at
-		// least once...
-		while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
-			// Wait for a state-change before reevaluating the .state:
-			PsychPAWaitForChange(&audiodevices[pahandle]);
-		}
-		
-		// Device has started (potentially even already finished for very short sounds!)
-		// In any case we have a valid .startTime to wait for in the device struct,
-		// which won't change by itself anymore, so it is safe to access unlocked.
-		// Unlock device:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-
-		// Ok, relevant audio buffer with real sound onset submitted to engine.
-		// We now have an estimate of real sound onset in startTime, wait until
-		// then:
-		PsychWaitUntilSeconds(audiodevices[pahandle].startTime);
-		
-		// Engine should run now. Return real onset time:
-		PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
-	}
-	else {
-		// Unlock device: This will trigger actual start at next paCallback() invocation by engine:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+	// Return current/old bias:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].latencyBias);
 
-		// Return empty zero timestamp to signal that this info is not available:
-		PsychCopyOutDoubleArg(1, kPsychArgOptional, 0.0);
+	// Set new bias, if one was provided:
+	if (bias!=DBL_MAX) {
+		if (audiodevices[pahandle].opmode & kPortAudioIsSlave) PsychErrorExitMsg(PsychError_user, "Change of latency bias is not allowed on slave devices! Set it on associated master device.");
+		if (Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change 'biasSecs' while device is active! Forbidden!");
+		audiodevices[pahandle].latencyBias = bias;
 	}
 	
 	return(PsychError_none);
 }
 
-
-/* PsychPortAudio('Start') - Start an audio device via PortAudio.
+/* PsychPortAudio('Volume') - Set volume per device.
  */
-PsychError PSYCHPORTAUDIOStartAudioDevice(void) 
+PsychError PSYCHPORTAUDIOVolume(void) 
 {
- 	static char useString[] = "startTime = PsychPortAudio('Start', pahandle [, repetitions=1] [, when=0] [, waitForStart=0] [, stopTime=inf] [, resume=0]);";
+ 	static char useString[] = "[oldMasterVolume, oldChannelVolumes] = PsychPortAudio('Volume', pahandle [, masterVolume][, channelVolumes]);";
 	static char synopsisString[] = 
-		"Start a PortAudio audio device. The 'pahandle' is the handle of the device to start. Starting a "
-		"device means: Start playback of output devices, start recording on capture device, do both on "
-		"full duplex devices. 'waitForStart' if set to 1 will wait until device has really started, default "
-		"is to continue immediately, ie. only schedule start of device. 'when' Requested time, when device "
-		"should start. Defaults to zero, i.e. start immediately. If set to a non-zero system time, PTB will "
-		"do its best to start the device at the requested time, but the accuracy of start depends on the "
-		"operating system, audio hardware and system load. If 'waitForStart' is set to non-zero value, ie "
-		"if PTB should wait for sound onset, then the optional return argument 'startTime' will contain an "
-		"estimate of when the first audio sample hit the speakers, i.e., the real start time.\n"
-		"Please note that the 'when' value always refers to playback, so it defines the starttime of "
-		"playback. The start time of capture is related to the start time of playback in duplex mode, "
-		"but it isn't the same. In pure capture mode (without playback), 'when' will be ignored and "
-		"capture always starts immediately. See the help for subfunction 'GetStatus' for more info on "
-		"the meaning of the different timestamps.\n"
-		"The 'repetitions' parameter defines how often the playback of the sound data should be repeated. "
-		"A setting of zero will cause infinite repetitions, ie., until manually stopped via the 'Stop' "
-		"subfunction. A positive setting will cause the provided number of repetitions to happen. The "
-		"default setting is 1, ie., play exactly once, then stop. Fractional values are allowed, e.g, "
-		"1.5 for one and a half repetition.\n"
-		"The optional parameter 'stopTime' allows to set a specific system time when sound playback "
-		"should stop by itself at latest, regardless if the requested number of 'repetitions' has "
-		"completed. PTB will do its best to stop sound at exactly that time, see comments about the "
-		"'when' parameter - The same mechanism is used, with the same restrictions.\n"
-		"The optional parameter 'resume' if set to 1, allows to resume playback at the position it "
-		"was last stopped, instead of starting at the beginning again. By default, playback starts "
-		"at the beginning.\n";
+		"Set audio output volume(s) and/or return old volumes for a device 'pahandle'.\n"
+		"The device must be open for this setting to take effect. It is initially set to 1.0. "
+		"On a regular audio device or master device, you can only set the global 'masterVolume' for the "
+		"whole device. On a slave device, you can optionally define a per-channel volume vector 'channelVolumes'. "
+		"E.g., if your slave device has two output channels, a 'channelVolumes' "
+		"vector of [0.9 ; 0.25] would set the first channel to 90% intensity, the 2nd channel to "
+		"25% intensity. The elements of 'channelVolumes' and the 'masterVolume' can be any value. The value for a device or a "
+		"channel is simply multiplied with each output sample before output to the hardware, so "
+		"that a value of 1.0 (the default setting for each device and channel) will pass samples "
+		"unmodified, a value of 0.5 would reduce intensity to 50%, a value of 1.25 would amplify "
+		"to 125% of the original value, or a value of -1 would invert the signal.\n"
+		"Be careful with amplification (values > 1). If the final sample leaves the valid output "
+		"range of -1.0 to 1.0, you may hear ugly auditory clipping artifacts and possibly damage "
+		"your ears or speakers! In 'normal' mode, PsychPortAudio clamps output samples to the valid "
+		"range of -1 to 1, but in high timing precision/low latency mode, clamping is not performed "
+		"in order to save computation time.\n\n"
+		"Caution: All volume settings are silently ignored on regular audio devices or master devices "
+		"if audio monitoring mode is active. On a slave device, per-channel volumes would be still applied "
+		"in monitoring mode, but not the masterVolume. This is for efficiency reasons. If you need volume "
+		"settings in monitoring mode, then open a master device, attach a slave device to it in monitoring "
+		"mode, then set the 'channelVolumes' of that slave device to control volume of monitoring.\n\n"
+		"Caution: The volume settings only affect what is sent to your computers sound system. The "
+		"operating system or audio hardware itself may apply additional volume settings, gains, filters "
+		"etc., depending on your specific setup. These are only controllable via external system specific tools, "
+		"PsychPortAudio doesn't know about such additional settings and can't control them in any way!\n\n"
+		"If you need to modulate output volume over time, you can also attach an additional slave "
+		"device whose opMode is set to act as an AMmodulator to a master or slave device, see help for 'OpenSlave'. "
+		"Such a slave device will not output sound itself, but use the data stored in its playback "
+		"buffers to modulate the amplitude of its parent slave, or of the summed signal of all previously "
+		"attached slaves for a master over time. Example: You create a master device, then 'OpenSlave' three regular slave "
+		"devices, then 'OpenSlave' a AMmodulator slave device. During playback, the sound signals "
+		"of the three regular slaves will be mixed together. The combined signal will be multiplied "
+		"by the per-sample volume values provided by the AMmodulator slave device, thereby modulating "
+		"the amplitude or ''acoustic envelope'' of the mixed signals. The resulting signal will be "
+		"played by the master device. If you'd attach more regular slave devices after the AMmodulator, "
+		"their signal would not get modulated, but simply added to the modulated signal of the first "
+		"three devices.\n\n"
+		"You can also modulate only the signals of a specific slave device, by attaching the modulator "
+		"to that slave device in the 'OpenSlave' call. You'd simply pass the handle of the slave that "
+		"should be modulated to 'OpenSlave', instead of the handle of a master device.\n\n"
+		"For sample-accurate fades, ramps or envelopes of the volume settings, see the help of 'UseAutomation'. While "
+		"automation is active for a setting, it overrides values set via this function.\n\n";
 
-	static char seeAlsoString[] = "Open";	 
-  	
-	PaError err;
-	int pahandle= -1;
-	int waitForStart = 0;
-	int resume = 0;
-	double repetitions = 1;
-	double when = 0.0;
-	double stopTime = DBL_MAX;
+	static char seeAlsoString[] = "Open UseAutomation AddToAutomation";	 
 	
+	double masterVolume;
+	double *channelVolumes;
+	int m, n, p, i;
+	int pahandle = -1;
+
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumOutputArgs(2));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
@@ -4085,461 +6819,254 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	// If this is a master device, we refault repetitions to zero, ie., infinite playback/capture.
-	// Makes much more sense for a master device:
-	if (audiodevices[pahandle].opmode & kPortAudioIsMaster) repetitions = 0;
-
-	PsychCopyInDoubleArg(2, kPsychArgOptional, &repetitions);
-	if (repetitions < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'repetitions'. Valid values are zero or greater.");
-
-	PsychCopyInDoubleArg(3, kPsychArgOptional, &when);
-	if (when < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'when'. Valid values are zero or greater.");
-
-	PsychCopyInIntegerArg(4, kPsychArgOptional, &waitForStart);
-	if (waitForStart < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'waitForStart'. Valid values are zero or greater.");
-
-	PsychCopyInDoubleArg(5, kPsychArgOptional, &stopTime);
-	if (stopTime <= when && (stopTime < DBL_MAX)) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'stopTime'. Valid values are greater than 'when' starttime.");
-
-	PsychCopyInIntegerArg(6, kPsychArgOptional, &resume);
-	if (resume < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'resume'. Valid values are zero or greater.");
-
-	if ((audiodevices[pahandle].opmode & kPortAudioMonitoring) == 0) {
-		// Not in monitoring mode: We must have in/outbuffers allocated:
-		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) && (audiodevices[pahandle].outputbuffer == NULL) && (audiodevices[pahandle].schedule == NULL)) PsychErrorExitMsg(PsychError_user, "Sound outputbuffer doesn't contain any sound to play?!?");
-		if ((audiodevices[pahandle].opmode & kPortAudioCapture) && (audiodevices[pahandle].inputbuffer == NULL)) PsychErrorExitMsg(PsychError_user, "Sound inputbuffer not prepared/allocated for capture?!?");
-	}
-
-	// Make sure current state is zero, aka fully stopped and engine is really stopped: Output a warning if this looks like an
-	// unintended "too early" restart: [No need to mutex-lock here, as iff these .state setting is not met,
-	// then we are good and they can't change by themselves behind our back -- paCallback() can't change .state to > 0]
-	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
-		if (verbosity > 1) {
-			printf("PsychPortAudio-WARNING: 'Start' method on audiodevice %i called, although playback on device not yet completely stopped.\nWill forcefully restart with possible audible artifacts or timing glitches.\nCheck your playback timing or use the 'Stop' function properly!\n", pahandle);
-		}
-	}
-
-	// Safeguard: If the stream is not stopped in runMode 0, do it now:
-	if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) {
-		if (audiodevices[pahandle].runMode == 0) Pa_StopStream(audiodevices[pahandle].stream);
-	}
-	
-	// Mutex-lock here: Needed if engine already/still running in runMode1, doesn't hurt if engine is stopped
-	PsychPALockDeviceMutex(&audiodevices[pahandle]);
-
-	// Reset statistics values:
-	audiodevices[pahandle].batchsize = 0;	
-	audiodevices[pahandle].xruns = 0;	
-	audiodevices[pahandle].paCalls = 0;
-	audiodevices[pahandle].noTime = 0;
-	audiodevices[pahandle].captureStartTime = 0;
-	audiodevices[pahandle].startTime = 0.0;
-	audiodevices[pahandle].reqStopTime = stopTime;
-	audiodevices[pahandle].estStopTime = 0;
-	audiodevices[pahandle].currentTime = 0;		
-	if (!resume) audiodevices[pahandle].schedule_pos = 0;
-	
-	// Reset recorded samples counter:
-	audiodevices[pahandle].recposition = 0;
-
-	// Reset read samples counter: This will discard possibly not yet fetched data.
-	audiodevices[pahandle].readposition = 0;
-
-	// Reset play position:
-	if (!resume) audiodevices[pahandle].playposition = 0;
-	
-	// Reset total count of played out samples:
-	if (!resume) audiodevices[pahandle].totalplaycount = 0;
-
-	// Set number of requested repetitions: 0 means loop forever, default is 1 time.
-	audiodevices[pahandle].repeatCount = (repetitions == 0) ? -1 : repetitions;
-
-	// Reset any pending requests:
-	audiodevices[pahandle].reqstate = 255;
-
-	// Setup target start time:
-	audiodevices[pahandle].reqStartTime = when;
+	// Return old masterVolume:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevices[pahandle].masterVolume);
 
-	// Mark state as "hot-started":
-	audiodevices[pahandle].state = 1;
+	// Copy in optional new masterVolume: We can assign this without locking, as a single scalar
+	// 32-bit float assignment is basically atomic:
+	if (PsychCopyInDoubleArg(2, kPsychArgOptional, &masterVolume)) audiodevices[pahandle].masterVolume = (float) masterVolume;
 
-	if (!(audiodevices[pahandle].opmode & kPortAudioIsSlave)) {
-		// Engine running?
-		if (!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream)) {
-			// Try to start stream if the engine isn't running, either because it is the very
-			// first call to 'Start' in any runMode, or because the engine got stopped in
-			// preparation for a restart in runMode zero. Need to drop the lock during
-			// call to Pa_StartStream to avoid deadlock:
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-			
-			// Safeguard: If the stream is not stopped, do it now:
-			if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
-			
-			// Start engine:
-			if ((err=Pa_StartStream(audiodevices[pahandle].stream))!=paNoError) {
-				printf("PTB-ERROR: Failed to start audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
-				PsychErrorExitMsg(PsychError_system, "Failed to start PortAudio audio device.");
-			}
-			
-			// Reacquire lock:
-			PsychPALockDeviceMutex(&audiodevices[pahandle]);
-		}
-	}
-	// From here on, the engine is running, and we have the mutex-lock. Unless we're a slave,
-	// then we have the lock but the engine may not be running yet.
-	
-	// Safety check for deadlock avoidance with waiting slaves:
-	if ((waitForStart > 0) && (audiodevices[pahandle].opmode & kPortAudioIsSlave) &&
-		(!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream) ||
-		 audiodevices[audiodevices[pahandle].pamaster].state < 1)) {
-		// We are a slave that shall wait for start, but the master audio device hasn't even
-		// started its engine. This looks like a deadlock to avoid:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-		printf("PTB-ERROR: Failed to start audio device %i. You asked me to wait for start to happen, but the\n", pahandle);
-		printf("PTB-ERROR: master audio device %i isn't active yet, so i would hang forever! Aborting!!\n", audiodevices[pahandle].pamaster);
-		PsychErrorExitMsg(PsychError_user, "Asked to 'waitForStart' of a slave device, but associated master device not even started! Deadlock avoided!");
-	}
-	
-	// Wait for real start of playback/capture?
-	if (waitForStart > 0) {
-		// Device will be in state == 1 until playback really starts:
-		// We need to enter the first while() loop iteration with
-		// the device lock held from above, so the while() loop will iterate at
-		// least once...
-		while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
-			// Wait for a state-change before reevaluating the .state:
-			PsychPAWaitForChange(&audiodevices[pahandle]);
-		}
-		
-		// Device has started (potentially even already finished for very short sounds!)
-		// In any case we have a valid .startTime to wait for in the device struct,
-		// which won't change by itself anymore, so it is safe to access unlocked.
-		// Unlock device:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+	// Slaves can have per-channel volumes:
+	if (audiodevices[pahandle].opmode & kPortAudioIsSlave) {
+		// Slave device: Need whole vector:
 		
-		// Ok, relevant audio buffer with real sound onset submit to engine.
-		// We now have an estimate of real sound onset in startTime, wait until
-		// then:
-		PsychWaitUntilSeconds(audiodevices[pahandle].startTime);
+		// Copy out old settings:
+		PsychAllocOutDoubleMatArg(2, kPsychArgOptional, 1, audiodevices[pahandle].outchannels, 1, &channelVolumes);
+		for (i = 0; i < audiodevices[pahandle].outchannels; i++) channelVolumes[i] = (double) audiodevices[pahandle].outChannelVolumes[i];
 		
-		// Engine should run now. Return real onset time:
-		PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
+		// Get optional new settings:
+		if (PsychAllocInDoubleMatArg(3, kPsychArgOptional, &m, &n, &p, &channelVolumes)) {
+			// Valid?
+			if (m * n != audiodevices[pahandle].outchannels || p != 1) PsychErrorExitMsg(PsychError_user, "Invalid channelVolumes vector for audio slave device provided. Number of elements doesn't match number of audio output channels!");
+
+			// Assign, but with device mutex of master device held, so we don't update in
+			// the middle of a mix cycle for our slave device:
+			PsychPALockDeviceMutex(&audiodevices[audiodevices[pahandle].pamaster]);
+			for (i = 0; i < audiodevices[pahandle].outchannels; i++) audiodevices[pahandle].outChannelVolumes[i]  = (float) channelVolumes[i];
+			PsychPAUnlockDeviceMutex(&audiodevices[audiodevices[pahandle].pamaster]);
+		}
 	}
 	else {
-		// Unlock device:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-
-		// Return empty zero timestamp to signal that this info is not available:
-		PsychCopyOutDoubleArg(1, kPsychArgOptional, 0.0);
+		// Superfluous channelVolumes for a non-slave provided?
+		if (PsychAllocInDoubleMatArg(3, kPsychArgOptional, &m, &n, &p, &channelVolumes)) {
+			PsychErrorExitMsg(PsychError_user, "Invalid channelVolumes vector for a non-slave device provided. Only slave devices accept this vector!");			
+		}
 	}
 
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('Stop') - Stop an audio device via PortAudio.
+/* PsychPortAudio('GetDevices') - Enumerate all available sound devices.
  */
-PsychError PSYCHPORTAUDIOStopAudioDevice(void) 
+PsychError PSYCHPORTAUDIOGetDevices(void) 
 {
- 	static char useString[] = "[startTime endPositionSecs xruns estStopTime] = PsychPortAudio('Stop', pahandle [, waitForEndOfPlayback=0] [, blockUntilStopped=1] [, repetitions] [, stopTime]);";
+ 	static char useString[] = "devices = PsychPortAudio('GetDevices' [, devicetype] [, deviceIndex]);";
 	static char synopsisString[] = 
-		"Stop a PortAudio audio device. The 'pahandle' is the handle of the device to stop.\n"
-		"'waitForEndOfPlayback' - If set to 1, this method will wait until playback of the "
-		"audio stream finishes by itself. This only makes sense if you perform playback with "
-		"a defined playback duration. The flag will be ignored when infinite repetition is "
-		"requested (as playback would never stop by itself, resulting in a hang) and if no "
-		"scheduled 'stopTime' has been set, either in this call or in the 'Start' function. "
-		"The setting will be also ignored if this is a pure recording session.\n"
-		"A setting of 0 (which is the default) requests stop of playback without waiting for all "
-		"the sound to be finished playing. Sound may continue to be played back for multiple "
-		"milliseconds after this call, as this is a polite request to the hardware to finish up.\n"
-		"A setting of 2 requests abortion of playback and/or capture as soon as possible with your "
-		"sound hardware, even if this creates audible artifacts etc. Abortion may or may not be faster "
-		"than a normal stop, this depends on your specific hardware, but our driver tries as hard as "
-		"possible to get the hardware to shut up. In a worst-case setting, the hardware would continue "
-		"to playback the sound data that is stored in its internal buffers, so the latency for stopping "
-		"sound would be the the same as the latency for starting sound as quickly as possible. E.g., "
-		"a 2nd generation Intel MacBook Pro seems to have a stop-delay of roughly 5-6 msecs under "
-		"optimal conditions (e.g., buffersize = 64, frequency=96000, OS/X 10.4.10, no other sound apps running).\n"
-		"A setting of 3 will not try to stop the playback now: You can use this setting if you just "
-		"want to use this function to wait until playback stops by itself, e.g. because the set "
-		"number of 'repetitions' or the set 'stopTime' has been reached. You can also use this to "
-		"just change the 'repetitions' or 'stopTime' settings without waiting for anything.\n"
-		"The optional parameter 'blockUntilStopped' defines if the subfunction should wait until "
-		"sound processing has really stopped (at a setting of 1, which is the default), or if the "
-		"function should return with minimal delay after only scheduling a stop at a zero setting. "
-		"If 'waitForEndOfPlayback' is set to 1, then 'blockUntilStopped' is meaningless and the function "
-		"will always block until the stop is completed.\n"
-		"The optional parameter 'stopTime' allows to set a defined system time when playback should "
-		"stop by itself. Similar, the optional 'repetitions' setting allows to change the number of "
-		"repetitions after which playback should stop by itself. These settings allow you to override "
-		"the same settings made during a call to the 'Start' or 'RescheduleStart' function.\n"
-		"The optional return argument 'startTime' returns an estimate of when the stopped "
-		"stream actually started its playback and/or recording. Its the same timestamp as the one "
-		"returned by the start command when executed in waiting mode. 'endPositionSecs' is the final "
-		"playback/recording position in seconds. 'xruns' is the number of buffer over- or underruns. "
-		"This should be zero if the playback operation was glitch-free, however a zero value doesn't "
-		"imply glitch free operation, as the glitch detection algorithm can miss some types of glitches. "
-		"The optional return argument 'estStopTime' returns an estimate of when playback likely stopped.\n"
-		"The return arguments are undefined if you set the 'blockUntilStopped' flag to zero.\n";
-	
+		"Returns 'devices', an array of structs, one struct for each available PortAudio device.\n\n"
+		"If the optional parameter 'deviceIndex' is provided and the optional parameter 'devicetype' "
+		"is set to [], then only returns a single struct with information about the device with index "
+		"'deviceIndex'.\n\n"
+		"Each struct contains information about its associated PortAudio device. The optional "
+		"parameter 'devicetype' can be used to enumerate only devices of a specific class: \n"
+		"1=Windows/DirectSound, 2=Windows/MME, 3=Windows/ASIO, 11=Windows/WDMKS, 13=Windows/WASAPI, "
+		"8=Linux/ALSA, 7=Linux/OSS, 12=Linux/JACK, 5=MacOSX/CoreAudio.\n\n"
+		"On OS/X you'll usually only see devices for the CoreAudio API, a first-class audio subsystem. "
+		"On Linux you may have the choice between ALSA, JACK and OSS. ALSA or JACK provide very low "
+		"latencies and very good timing, OSS is an older system which is less capable but not very "
+		"widespread in use anymore. On MS-Windows you'll have the ''choice'' between up to 5 different "
+		"audio subsystems: If you buy an expensive sound card with ASIO drivers, pick that API for low "
+		"latency, it should give you comparable performance to OS/X or Linux. 2nd best choice "
+		"would be WASAPI (on Windows-Vista) or WDMKS (on Windows-2000/XP) for ok latency on good days. DirectSound is the next "
+		"worst choice if you have hardware with DirectSound support. If everything else fails, you'll be left "
+		"with MME, a premium example of system misdesign successfully sold to paying customers.";
+		
 	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
-	
-	PaError err;
-	int pahandle= -1;
-	int waitforend = 0;
-	int blockUntilStopped = 1;
-	double stopTime = -1;
-	double repetitions = -1;
+	PsychGenericScriptType 	*devices;
+	const char *FieldNames[]={	"DeviceIndex", "HostAudioAPIId", "HostAudioAPIName", "DeviceName", "NrInputChannels", "NrOutputChannels", 
+								 		"LowInputLatency", "HighInputLatency", "LowOutputLatency", "HighOutputLatency",  "DefaultSampleRate", "xxx" };
+	int devicetype = -1;
+	int deviceindex = -1;
+	int count = 0;
+	int i, ic, filteredcount;
+	const PaDeviceInfo* padev = NULL;
+	const PaHostApiInfo* hainfo = NULL;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(4));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
-	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-
-	// Get optional wait-flag:
-	PsychCopyInIntegerArg(2, kPsychArgOptional, &waitforend);
-
-	// Get optional blockUntilStopped-flag:
-	PsychCopyInIntegerArg(3, kPsychArgOptional, &blockUntilStopped);
-
-	// Get new optional 'repetitions' count:
-	if (PsychCopyInDoubleArg(4, kPsychArgOptional, &repetitions)) {
-		// Argument provided: Range-Check and assign it:
-		if (repetitions < 0) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'repetitions'. Valid values are zero or greater.");
-	}
-	else {
-		repetitions = -1;
-	}
-
-	// Get optional stopTime:
-	if (PsychCopyInDoubleArg(5, kPsychArgOptional, &stopTime)) {
-		if ((stopTime <= audiodevices[pahandle].reqStartTime) && (stopTime < DBL_MAX)) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'stopTime'. Valid values are greater than previously set 'when' starttime.");
-	}
-	else {
-		stopTime = -1;
-	}
-
-	// Lock device:
-	PsychPALockDeviceMutex(&audiodevices[pahandle]);
+	PsychCopyInIntegerArg(1, kPsychArgOptional, &devicetype);
+	if (devicetype < -1) PsychErrorExitMsg(PsychError_user, "Invalid 'devicetype' provided. Valid are values of zero and greater.");
 
-	// New repetitions provided?
-	if (repetitions >=0) {
-		// Set number of requested repetitions: 0 means loop forever, default is 1 time.
-		audiodevices[pahandle].repeatCount = (repetitions == 0) ? -1 : repetitions;
-	}
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &deviceindex);
+	if (deviceindex < -1) PsychErrorExitMsg(PsychError_user, "Invalid 'deviceindex' provided. Valid are values of zero and greater.");
 	
-	// New stopTime provided?
-	if (stopTime > 0) {
-		// Yes. Quickly assign it:
-		audiodevices[pahandle].reqStopTime = stopTime;
-	}
+	// Provided deviceIndex overrides potentially provided deviceType, if any:
+	if (deviceindex >= 0 && devicetype >=0) PsychErrorExitMsg(PsychError_user, "Provided 'deviceindex' and 'devicetype'! This is forbidden. Provide one or the other.");
 	
-	// Wait for automatic stop of playback if requested: This only makes sense if we
-	// are in playback mode and not in infinite playback mode! Would not make sense in
-	// looping mode (infinite repetitions of playback) or pure recording mode. It is also
-	// allowed if we have infinite repetitions set, but a finite stopTime is defined, so
-	// the engine will eventually stop by itself. Same goes for an operative schedule which
-	// will run empty if not regularly updated:
-	if ((waitforend == 1) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0) &&
-		(audiodevices[pahandle].opmode & kPortAudioPlayBack) && ((audiodevices[pahandle].repeatCount != -1) || (audiodevices[pahandle].schedule) || (audiodevices[pahandle].reqStopTime < DBL_MAX))) {
-		while ( ((audiodevices[pahandle].runMode == 0) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) ||
-				((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
-
-			// Wait for a state-change before reevaluating:
-			PsychPAWaitForChange(&audiodevices[pahandle]);
+	// Query number of devices and allocate out struct array:
+	count = (int) Pa_GetDeviceCount();
+	if (count > 0) {
+		filteredcount = count;
+		if (devicetype!=-1) {
+			filteredcount = 0;
+			// Filtering by host API requested: Do it.
+			for (i=0; i<count; i++) {
+				padev = Pa_GetDeviceInfo((PaDeviceIndex) i);
+				hainfo = Pa_GetHostApiInfo(padev->hostApi);
+				if (hainfo->type == devicetype) filteredcount++;
+			}
 		}
-	}
-	
-	// Lock held here in any case...
-	
-	if (waitforend == 3) {
-		// No immediate stop request: This was only either a query for end of playback,
-		// or a call to simply set new 'stopTime' or 'repetitions' parameters on the fly.
-		// Unlock the device and skip stop requests...
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+
+		// Only return one single struct if specific deviceindex given:
+		if (deviceindex >= 0) filteredcount = 1;
+		
+		// Alloc output struct array:
+		PsychAllocOutStructArray(1, kPsychArgOptional, filteredcount, 11, FieldNames, &devices);
 	}
 	else {
-		// Some real immediate stop request wanted:
-		// Soft stop requested (as opposed to fast stop)?
-		if (waitforend!=2) {
-			// Softstop: Try to stop stream:
-			if (audiodevices[pahandle].state > 0) {
-				// Stream running. Request a stop of stream, to be honored by playback thread:
-				audiodevices[pahandle].reqstate = 0;
-			}
-				
-			// Drop lock, so request can get through...
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-				
-			// If blockUntilStopped is non-zero, then explicitely stop as well:
-			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) && (err=Pa_StopStream(audiodevices[pahandle].stream))!=paNoError) {
-				printf("PTB-ERROR: Failed to stop audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
-				PsychErrorExitMsg(PsychError_system, "Failed to stop PortAudio audio device.");
-			}
-		}
-		else {
-			// Faststop: Try to abort stream. Skip if already stopped/not yet started:
-			
-			// Stream active?
-			if (audiodevices[pahandle].state > 0) {
-				// Yes. Set the 'state' flag to signal our IO-Thread not to push any audio
-				// data anymore, but only zeros for silence and to paAbort asap:
-				audiodevices[pahandle].reqstate = 3;
-			}
-			
-			// Drop lock, so request can get through...
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		PsychErrorExitMsg(PsychError_user, "PTB-ERROR: PortAudio can't detect any supported sound device on this system.");
+	}
+	
+	// Iterate through device list:
+	ic = 0;
+	for (i=0; i<count; i++) {
+		// Return info about deviceindex i if it matches the selected deviceindex or if
+		// all devices should be returned:
+		if ((deviceindex == -1) || (deviceindex == i)) {
+			// Get info about deviceindex i:
+			padev = Pa_GetDeviceInfo((PaDeviceIndex) i);
+			hainfo = Pa_GetHostApiInfo(padev->hostApi);
 			
-			// If blockUntilStopped is non-zero, then send abort request to hardware:
-			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) && ((err=Pa_AbortStream(audiodevices[pahandle].stream))!=paNoError)) {
-				printf("PTB-ERROR: Failed to abort audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
-				PsychErrorExitMsg(PsychError_system, "Failed to fast stop (abort) PortAudio audio device.");
+			// Return info if devicetype doesn't matter or if it matches the required one:
+			if ((devicetype==-1) || (hainfo->type == devicetype)) {
+				// Fill slot ic of struct array with info of deviceindex i:
+				PsychSetStructArrayDoubleElement("DeviceIndex", ic, i, devices);
+				PsychSetStructArrayDoubleElement("HostAudioAPIId", ic, hainfo->type, devices);
+				PsychSetStructArrayStringElement("HostAudioAPIName", ic, (char*) (hainfo->name), devices);
+				PsychSetStructArrayStringElement("DeviceName", ic, (char*) (padev->name), devices);
+				PsychSetStructArrayDoubleElement("NrInputChannels", ic, padev->maxInputChannels, devices);
+				PsychSetStructArrayDoubleElement("NrOutputChannels", ic, padev->maxOutputChannels, devices);
+				PsychSetStructArrayDoubleElement("LowInputLatency", ic, padev->defaultLowInputLatency, devices);
+				PsychSetStructArrayDoubleElement("HighInputLatency", ic, padev->defaultHighInputLatency, devices);
+				PsychSetStructArrayDoubleElement("LowOutputLatency", ic, padev->defaultLowOutputLatency, devices);
+				PsychSetStructArrayDoubleElement("HighOutputLatency", ic, padev->defaultHighOutputLatency, devices);
+				PsychSetStructArrayDoubleElement("DefaultSampleRate", ic, padev->defaultSampleRate, devices);
+				// PsychSetStructArrayDoubleElement("xxx", ic, 0, devices);
+				ic++;
 			}
 		}
 	}
 	
-	// No lock held here...
-
-	// Wait for real stop:
-	if (blockUntilStopped > 0) {
-		// Lock device:
-		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+	return(PsychError_none);
+}
 
-		// Wait for stop / idle:
-		if (Pa_IsStreamActive(audiodevices[pahandle].stream)) {
-			while ( ((audiodevices[pahandle].runMode == 0) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) ||
-					((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
-				
-				// Wait for a state-change before reevaluating:
-				PsychPAWaitForChange(&audiodevices[pahandle]);
-			}
-		}
-		
-		// We are stopped/idle, with lock held:
+/* PsychPortAudio('RunMode') - Select a different mode of operation.
+ */
+PsychError PSYCHPORTAUDIORunMode(void) 
+{
+ 	static char useString[] = "oldRunMode = PsychPortAudio('RunMode', pahandle [,runMode]);";
+	static char synopsisString[] = 
+		"Set general run mode to 'runMode' and/or return old runMode for a device 'pahandle'.\n"
+		"The device must be open for this setting to take effect and playback must be stopped if "
+		"one wants to change the setting. If playback isn't stopped, it will be forcefully stopped. "
+		"Change of runMode is not supported on slave devices. "
+		"The current/old runMode is returned in the optional return value 'oldRunMode'. "
+		"'runMode' is the optional new runmode: At device open time, the runMode defaults to one. "
+		"In mode zero, the audio hardware and all internal processing are completely stopped at end "
+		"of audio playback. This reduces system ressource usage (both hardware and computation time), "
+		"but may cause slightly longer latencies when re'Start'ing the device for playback of a different "
+		"sound, e.g., a sequence of sounds. In 'runMode' 1, the audio hardware and processing don't shut "
+		"down at the end of audio playback. Instead, everything remains active in a ''hot standby'' state. "
+		"This allows to very quickly (with low latency) restart sound playback via the 'RescheduleStart' "
+		"function. The downside is a permanent use of system ressources even if no sound is playing. "
+		"Future runMode settings may provide more interesting options, stay tuned...\n";
 		
-		// Need to update stream state and reqstate manually here, as the Pa_Stop/AbortStream()
-		// requests may have stopped the paCallback() thread before it could update/honor state/reqstate by himself.
+	static char seeAlsoString[] = "Start Stop RescheduleStart ";
+	
+	int runMode = -1;
+	int pahandle = -1;
 
-		// Mark state as stopped:
-		audiodevices[pahandle].state = 0;
-		
-		// Reset request to none:
-		audiodevices[pahandle].reqstate = 255;
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
-		// Can unlock here, as the fields we're interested in will remain static with an idle/stopped engine:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
 
-		// Copy out our estimate of when playback really started for the just stopped stream:
-		PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
-		
-		// Copy out final playback position (secs) since start:
-		PsychCopyOutDoubleArg(2, kPsychArgOptional, ((double)(audiodevices[pahandle].playposition / audiodevices[pahandle].outchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate);
-		
-		// Copy out number of buffer over-/underflows since start:
-		PsychCopyOutDoubleArg(3, kPsychArgOptional, audiodevices[pahandle].xruns);
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+
+	// Copy in optional runMode value:
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &runMode);
+	
+	// Return current/old runMode:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].runMode);
+
+	// Set new runMode, if one was provided:
+	if (runMode != -1) {
+		// Doing this is a no-no on slaves:
+		if (audiodevices[pahandle].opmode & kPortAudioIsSlave) PsychErrorExitMsg(PsychError_user, "Change of runmode is not allowed on slave devices!");
+
+		// Stop engine if it is running:
+		if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
+
+		// Reset state:
+		audiodevices[pahandle].state = 0;
+		audiodevices[pahandle].reqstate = 255;
 
-		// Copy out estimated stopTime:
-		PsychCopyOutDoubleArg(4, kPsychArgOptional, audiodevices[pahandle].estStopTime);
-	}
-	else {
-		// No block until stopped. That means we won't have meaningful return arguments available.
-		// Just return dummy args to signal this:
-		PsychCopyOutDoubleArg(1, kPsychArgOptional, -1);
-		
-		// Copy out final playback position (secs) since start:
-		PsychCopyOutDoubleArg(2, kPsychArgOptional, -1);
-		
-		// Copy out number of buffer over-/underflows since start:
-		PsychCopyOutDoubleArg(3, kPsychArgOptional, -1);
+		if (runMode < 0 || runMode > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'runMode' provided. Must be 0 or 1!");
 
-		// Copy out estimated stopTime:
-		PsychCopyOutDoubleArg(4, kPsychArgOptional, -1);
+		// Assign new runMode:
+		audiodevices[pahandle].runMode = runMode;
 	}
 
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('GetStatus') - Return current status of stream.
+/* PsychPortAudio('SetLoop') - Define a subrange of samples in the audio playback buffer to play.
  */
-PsychError PSYCHPORTAUDIOGetStatus(void) 
+PsychError PSYCHPORTAUDIOSetLoop(void) 
 {
- 	static char useString[] = "status = PsychPortAudio('GetStatus', pahandle);";
+ 	static char useString[] = "PsychPortAudio('SetLoop', pahandle[, startSample=0][, endSample=max][, UnitIsSeconds=0]);";
 	static char synopsisString[] = 
-		"Returns 'status', a struct with status information about the current state of device 'pahandle'.\n"
-		"The struct contains the following fields:\n"
-		"Active: Can be 1 if playback or recording is active, or 0 if playback/recording is stopped or not yet started.\n"
-		"RequestedStartTime: Is the requested start time of the audio stream after start of playback/recording. "
-		"StartTime: Is the real start time of the audio stream after start of playback/recording. If both, playback and "
-		"recording are active (full-duplex mode), it is the start time of sound playback, ie an estimate of when the first "
-		"sample hit the speakers. Same goes for pure playback. \n"
-		"CaptureStartTime: Start time of audio capture (if any is active) - an estimate of when the first sound sample was "
-		"captured. In pure capture mode, this is nearly identical to StartTime, but whenever playback is active, StartTime and "
-		"CaptureStartTime will differ. CaptureStartTime doesn't take the user provided 'LatencyBias' into account.\n"
-		"RequestedStopTime: The requested stop / sound offset time for playback of sounds, as selected via the 'stopTime' "
-		"paramter in the 'Start', 'RescheduleStart' or 'Stop' function. This will show a very large (~ infinite) value "
-		"if no stop time has been sprecified.\n"
-		"EstimatedStopTime: Estimated time when sound playback has stopped. This is an estimate of when exactly the last "
-		"audio sample will leave the speaker. The value is zero as long as the estimate isn't available. Due to the latency "
-		"involved in sound playback, the value may become available a few msecs before or after actual sound offset.\n"
-		"CurrentStreamTime: Estimate of when the most recently submitted sample will hit the speaker. This corresponds "
-		"roughly to 'PositionSecs' below, but in absolute realtime.\n"
-		"ElapsedOutSamples: Total number of samples played out since start of playback. This count increments monotonically "
-		"from start of playback to stop of playback. This denotes the absolute sample position that will hit the speaker "
-		"at time 'CurrentStreamTime'. \n"
-		"PositionSecs is an estimate of the current stream playback position in seconds within the current playback loop "
-		"of the current buffer. it's not totally accurate, because "
-		"it measures how much sound has been submitted to the sound system, not how much sound has left the "
-		"speakers, i.e., it doesn't take driver and hardware latency into account.\n"
-		"SchedulePosition: Current position in a running schedule, if any.\n"
-		"XRuns: Number of dropouts due to buffer overrun or underrun conditions.\n"
-		"TotalCalls, TimeFailed and BufferSize are only for debugging of PsychPortAudio itself.\n"
-		"CPULoad: How much load does the playback engine impose on the CPU? Values can range from 0.0 = 0% "
-		"to 1.0 for 100%. Values close to 1.0 indicate that your system can't handle the load and timing glitches "
-		"or sound glitches are likely. In such a case, try to reduce the load on your system.\n"
-		"PredictedLatency: Is the latency in seconds of your driver+hardware combo. It tells you, "
-		"how far ahead of time a sound device must be started ahead of the requested onset time via "
-		"PsychPortAudio('Start'...) to make sure it actually starts playing in time. High quality systems like "
-		"Linux or MacOS/X may allow values as low as 5 msecs or less on standard hardware. Other operating "
-		"systems may require dozens or hundreds of milliseconds of headstart. Caution: In full-duplex mode, "
-		"this value only refers to the latency on the sound output, not in the sound input! Also, this is just "
-		"an estimate, not 100% reliable.\n"
-		"LatencyBias: Is an additional bias setting you can impose via PsychPortAudio('LatencyBias', pahandle, bias); "
-		"in case our drivers estimate is a bit off. Allows fine-tuning.\n"
-		"SampleRate: Is the sampling rate for playback/recording in samples per second (Hz).\n"
-		"OutDeviceIndex: Is the deviceindex of the playback device, or -1 if not opened for playback. "
-		"You can pass OutDeviceIndex to PsychPortAudio('GetDevices', [], OutDeviceIndex); to query information "
-		"about the device.\n"
-		"InDeviceIndex: Is the deviceindex of the capture device, or -1 if not opened for capture.\n"
-		"RecordedSecs: Is the total amount of recorded sound data (in seconds) since start of capture.\n"
-		"ReadSecs: Is the total amount of sound data (in seconds) that has been fetched from the internal buffer. "
-		"The difference between RecordedSecs and ReadSecs is the amount of recorded sound data pending for retrieval. ";
-
-	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
-	PsychGenericScriptType 	*status;
-	double currentTime;
-	psych_int64 playposition, totalplaycount;
-
-	const char *FieldNames[]={	"Active", "State", "RequestedStartTime", "StartTime", "CaptureStartTime", "RequestedStopTime", "EstimatedStopTime", "CurrentStreamTime", "ElapsedOutSamples", "PositionSecs", "RecordedSecs", "ReadSecs", "SchedulePosition",
-								"XRuns", "TotalCalls", "TimeFailed", "BufferSize", "CPULoad", "PredictedLatency", "LatencyBias", "SampleRate",
-								"OutDeviceIndex", "InDeviceIndex" };
-	int pahandle = -1;
+		"Restrict audio playback to a subrange of sound samples in the current audio playback buffer for "
+		"audio device 'pahandle'. The device must be open and a soundbuffer created via 'FillBuffer' "
+		"for this setting to take effect. The setting is reset at each non-streaming 'FillBuffer' call.\n"
+		"'startSample' defines the first sample to be played, it defaults to zero, ie. the very first in "
+		"the buffer. 'endSample' the last sample to be played, it defaults to the end of the buffer.\n"
+		"Calling this function without any parameter except 'pahandle' will therefore reset the playloop "
+		"to the full buffer size. It is possible but not advisable to change the loop range while "
+		"sound playback is active, as this may cause audible glitches or artifacts in the playback.\n"
+		"By default, 'startSample' and 'endSample' are specified in units of samples, but if the "
+		"optional flag 'UnitIsSeconds' is set to a non-zero value, then the given range is "
+		"interpreted in units of seconds. ";
+		
+	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart ";
 	
+	double startSample, endSample, sMultiplier;
+	psych_int64 maxSample;
+	int unitIsSecs;
+	int pahandle = -1;
+
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(1));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
@@ -4547,135 +7074,210 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	PsychAllocOutStructArray(1, kPsychArgOptional, 1, 23, FieldNames, &status);
+	unitIsSecs = 0;
+	PsychCopyInIntegerArg(4, kPsychArgOptional, &unitIsSecs);
+	sMultiplier = (unitIsSecs > 0) ? PsychPABufferSampleRate(&audiodevices[pahandle], NULL) : 1.0;
 
-	// Ok, in a perfect world we should hold the device mutex while querying all the device state.
-	// However, we don't: This reduces lock contention at the price of a small chance that the
-	// fetched information is not 100% up to date / that this is not an atomic snapshot of state.
-	//
-	// Instead we only hold the lock to get the most crucial values atomically, then release and get the rest
-	// while not holding the lock:
+	// Compute maxSample the maximum possible sampleframe index for given soundbuffer:
+	maxSample = (audiodevices[pahandle].outputbuffersize / sizeof(float) / audiodevices[pahandle].outchannels) - 1;
+
+	// Copy in optional startSample:
+	startSample = 0;
+	PsychCopyInDoubleArg(2, kPsychArgOptional, &startSample);
+	if (startSample < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startSample' provided. Must be greater or equal to zero!");
+	startSample *= sMultiplier;
+	
+	// Copy in optional endSample:
+	if (PsychCopyInDoubleArg(3, kPsychArgOptional, &endSample)) {
+		endSample *= sMultiplier;
+		if (endSample > maxSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be no greater than total buffersize!");
+	}
+	else {
+		endSample = maxSample;
+	}
+
+	if (endSample < startSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be greater or equal than 'startSample'!");
+	
+	// Ok, range is valid. Assign it:
 	PsychPALockDeviceMutex(&audiodevices[pahandle]);
-	currentTime = audiodevices[pahandle].currentTime;
-	totalplaycount = audiodevices[pahandle].totalplaycount;
-	playposition = audiodevices[pahandle].playposition;
+	audiodevices[pahandle].loopStartFrame = (psych_int64) startSample;
+	audiodevices[pahandle].loopEndFrame = (psych_int64) endSample;
 	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-	
-	// Atomic snapshot for remaining fields would only be needed for low-level debugging, so who cares?
-	PsychSetStructArrayDoubleElement("Active", 0, (audiodevices[pahandle].state >= 2) ? 1 : 0, status);
-	PsychSetStructArrayDoubleElement("State", 0, audiodevices[pahandle].state, status);
-	PsychSetStructArrayDoubleElement("RequestedStartTime", 0, audiodevices[pahandle].reqStartTime, status);
-	PsychSetStructArrayDoubleElement("StartTime", 0, audiodevices[pahandle].startTime, status);
-	PsychSetStructArrayDoubleElement("CaptureStartTime", 0, audiodevices[pahandle].captureStartTime, status);
-	PsychSetStructArrayDoubleElement("RequestedStopTime", 0, audiodevices[pahandle].reqStopTime, status);
-	PsychSetStructArrayDoubleElement("EstimatedStopTime", 0, audiodevices[pahandle].estStopTime, status);
-	PsychSetStructArrayDoubleElement("CurrentStreamTime", 0, currentTime, status);	
-	PsychSetStructArrayDoubleElement("ElapsedOutSamples", 0, ((double)(totalplaycount / audiodevices[pahandle].outchannels)), status);
-	PsychSetStructArrayDoubleElement("PositionSecs", 0, ((double)(playposition / audiodevices[pahandle].outchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
-	PsychSetStructArrayDoubleElement("RecordedSecs", 0, ((double)(audiodevices[pahandle].recposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
-	PsychSetStructArrayDoubleElement("ReadSecs", 0, ((double)(audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
-	PsychSetStructArrayDoubleElement("SchedulePosition", 0, audiodevices[pahandle].schedule_pos, status);
-	PsychSetStructArrayDoubleElement("XRuns", 0, audiodevices[pahandle].xruns, status);
-	PsychSetStructArrayDoubleElement("TotalCalls", 0, audiodevices[pahandle].paCalls, status);
-	PsychSetStructArrayDoubleElement("TimeFailed", 0, audiodevices[pahandle].noTime, status);
-	PsychSetStructArrayDoubleElement("BufferSize", 0, audiodevices[pahandle].batchsize, status);
-	PsychSetStructArrayDoubleElement("CPULoad", 0, (Pa_IsStreamActive(audiodevices[pahandle].stream)) ? Pa_GetStreamCpuLoad(audiodevices[pahandle].stream) : 0.0, status);
-	PsychSetStructArrayDoubleElement("PredictedLatency", 0, audiodevices[pahandle].predictedLatency, status);
-	PsychSetStructArrayDoubleElement("LatencyBias", 0, audiodevices[pahandle].latencyBias, status);
-	PsychSetStructArrayDoubleElement("SampleRate", 0, audiodevices[pahandle].streaminfo->sampleRate, status);
-	PsychSetStructArrayDoubleElement("OutDeviceIndex", 0, audiodevices[pahandle].outdeviceidx, status);
-	PsychSetStructArrayDoubleElement("InDeviceIndex", 0, audiodevices[pahandle].indeviceidx, status);
+
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('Verbosity') - Set level of verbosity.
+/* PsychPortAudio('EngineTunables') - Set tunable low-level engine parameters
  */
-PsychError PSYCHPORTAUDIOVerbosity(void) 
+PsychError PSYCHPORTAUDIOEngineTunables(void) 
 {
- 	static char useString[] = "oldlevel = PsychPortAudio('Verbosity' [,level]);";
+ 	static char useString[] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend, mixerSIMD, slaveWorkerThreads] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend] [, mixerSIMD] [, slaveWorkerThreads]);";
 	static char synopsisString[] = 
-		"Set level of verbosity for error/warning/status messages. 'level' optional, new level "
-		"of verbosity. 'oldlevel' is the old level of verbosity. The following levels are "
-		"supported: 0 = Shut up. 1 = Print errors, 2 = Print also warnings, 3 = Print also some info, "
-		"4 = Print more useful info (default), >5 = Be very verbose (mostly for debugging the driver itself). ";		
-	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
+		"Return, and optionally set low-level tuneable driver parameters.\n"
+		"The driver must be idle, ie., no audio device must be open, if you want to change tuneables! "
+		"These tuneable parameters usually have reasonably chosen defaults and you should only "
+		"need to change them to work around bugs or flaws in your operating system, sound hardware or drivers, "
+		"or if you have very unusual needs or setups. Only touch these if you know what you're doing, probably "
+		"after consultation with the Psychtoolbox forum or Wiki. Some of these have potential to cause serious "
+		"system malfunctions if not selected properly!\n\n"
+		"'yieldInterval' - If the driver has to perform polling operations, it will release the cpu for "
+		"yieldInterval seconds inbetween unsuccessful polling iterations. Valid range is 0.0 to 0.1 secs, with "
+		"a reasonable default of 0.001 secs ie. 1 msec.\n"
+		"'MutexEnable' - Enable (1) or Disable (0) internal mutex locking of driver data structures to prevent "
+		"potential race-conditions between internal processing threads. Locking is enabled by default. Only "
+		"disable locking to work around seriously broken audio device drivers or system setups and be aware "
+		"that this may have unpleasant side effects and can cause all kinds of malfunctions by itself!\n"
+		"'lockToCore1' - Enable (1) or Disable (0) locking of all audio engine processing threads to cpu core 1 "
+		"on Microsoft Windows systems. By default threads are locked to cpu core 1 to avoid problems with "
+		"timestamping due to bugs in some microprocessors clocks and in Microsoft Windows itself. If you're "
+		"confident/certain that your system is bugfree wrt. to its clocks and want to get a bit more "
+		"performance out of multi-core machines, you can disable this. You must perform this setting before "
+		"you open the first audio device the first time, otherwise the setting might be ignored.\n"
+		"'audioserver_autosuspend' - Enable (1) or Disable (0) automatic suspending of running desktop "
+		"audio servers, e.g., PulseAudio, while PsychPortAudio is active. Default is (1) - suspend while "
+		"PsychPortAudio does its thing. Desktop sound servers like the commonly used PulseAudio server "
+		"can interfere with low level audio device access and low-latency / high-precision audio timing. "
+		"For this reason it is a good idea to switch them to standby (suspend) while a PsychPortAudio "
+		"session is active. Sometimes this isn't needed or not even desireable. Therefore this option "
+		"allows to inhibit this automatic suspending of audio servers.\n"
+		"'mixerSIMD' - Select the type of mixing kernels used by master devices to mix slave devices output into "
+		"the master output: 0 = Plain C code, 1 = SSE2 vector code, 2 = AVX vector code. By default the fastest "
+		"type supported by your machine is used. Requests for unsupported types are reduced to the best supported "
+		"type. All types produce the same results, so this is only useful for benchmarking or to work around bugs.\n"
+		"'slaveWorkerThreads' - Number of additional realtime worker threads to use for parallel rendering of the slave "
+		"devices attached to a master device. By default (0) all slaves are rendered one after another on the single "
+		"audio processing thread of the master, so processing time grows linearly with the number of active slaves. "
+		"On multi-core machines with many active slaves, you can set this to a value of up to the number of cpu cores "
+		"minus one, to distribute slave processing across cores. The setting applies to master devices opened afterwards. "
+		"If the worker threads fall behind the audio processing thread, e.g., due to system overload, the master "
+		"switches back to serial rendering of its slaves until its next 'Start'. "
+		"It has no effect on MS-Windows while 'lockToCore1' is enabled.\n";
+
+	static char seeAlsoString[] = "Open ";	 
 	
-	int level= -1;
+	int mutexenable, mylockToCore1, mysuspend, mymixerSIMD, myworkers;
+	char msgerr[256];
+	double myyieldInterval;
 
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(1));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumOutputArgs(6));    // The maximum number of outputs
 
-	PsychCopyInIntegerArg(1, kPsychArgOptional, &level);
-	if (level < -1) PsychErrorExitMsg(PsychError_user, "Invalid level of verbosity provided. Valid are levels of zero and greater.");
-	
-	// Return current/old level:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) verbosity);
+	// Make sure no settings are changed while an audio device is open:
+	if ((PsychGetNumInputArgs() > 0) && (audiodevicecount > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change low-level engine parameter while at least one audio device is open! Forbidden!");
 
-	// Set new level, if one was provided:
-	if (level > -1) verbosity = level;
+	// Return current/old audioserver_suspend:
+	PsychCopyOutDoubleArg(4, kPsychArgOptional, (double) ((pulseaudio_autosuspend) ? 1 : 0));
 
-	return(PsychError_none);
-}
+	// Get optional new audioserver_suspend:
+	if (PsychCopyInIntegerArg(4, kPsychArgOptional, &mysuspend)) {
+		if (mysuspend < 0 || mysuspend > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'audioserver_autosuspend' provided. Valid are 0 and 1.");
+		pulseaudio_autosuspend = (mysuspend > 0) ? TRUE : FALSE;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Automatic suspending of desktop audio servers %s.\n", (pulseaudio_autosuspend) ? "enabled" : "disabled");
+	}
+
+	// Make sure PortAudio is online: Must be done after setup of audioserver_suspend!
+	PsychPortAudioInitialize();
+
+	// Return old yieldInterval:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, yieldInterval);
+
+	// Get optional new yieldInterval:
+	if (PsychCopyInDoubleArg(1, kPsychArgOptional, &myyieldInterval)) {
+		if (myyieldInterval < 0 || myyieldInterval > 0.1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'yieldInterval' provided. Valid are between 0.0 and 0.1 seconds.");
+		yieldInterval = myyieldInterval;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Engine yieldInterval changed to %lf seconds.\n", yieldInterval);
+	}
+
+	// Return current/old mutexenable:
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) ((uselocking) ? 1 : 0));
+
+	// Get optional new mutexenable:
+	if (PsychCopyInIntegerArg(2, kPsychArgOptional, &mutexenable)) {
+		if (mutexenable < 0 || mutexenable > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'MutexEnable' provided. Valid are 0 and 1.");
+		uselocking = (mutexenable > 0) ? TRUE : FALSE;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Engine Mutex locking %s.\n", (uselocking) ? "enabled" : "disabled");
+	}
+
+	// Return current/old lockToCore1:
+	PsychCopyOutDoubleArg(3, kPsychArgOptional, (double) ((lockToCore1) ? 1 : 0));
+
+	// Get optional new lockToCore1:
+	if (PsychCopyInIntegerArg(3, kPsychArgOptional, &mylockToCore1)) {
+		if (mylockToCore1 < 0 || mylockToCore1 > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'lockToCore1' provided. Valid are 0 and 1.");
+		lockToCore1 = (mylockToCore1 > 0) ? TRUE : FALSE;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Locking of all engine threads to cpu core 1 %s.\n", (lockToCore1) ? "enabled" : "disabled");
+	}
 
-/* PsychPortAudio('GetOpenDeviceCount') - Get number of open audio devices.
- */
-PsychError PSYCHPORTAUDIOGetOpenDeviceCount(void) 
-{
- 	static char useString[] = "count = PsychPortAudio('GetOpenDeviceCount');";
-	static char synopsisString[] = "Return the number of currently open audio devices.\n";
-	static char seeAlsoString[] = "Open ";	 
+	// Return current/old mixerSIMD:
+	PsychCopyOutDoubleArg(5, kPsychArgOptional, (double) mixSIMDLevel);
 
-	// Setup online help: 
-	PsychPushHelp(useString, synopsisString, seeAlsoString);
-	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
-	
-	PsychErrorExit(PsychCapNumInputArgs(0));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	// Get optional new mixerSIMD:
+	if (PsychCopyInIntegerArg(5, kPsychArgOptional, &mymixerSIMD)) {
+		if (mymixerSIMD < kPsychPAMixScalar || mymixerSIMD > kPsychPAMixAVX) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'mixerSIMD' provided. Valid are 0, 1 and 2.");
+		mixSIMDLevel = (mymixerSIMD > mixSIMDMaxLevel) ? mixSIMDMaxLevel : mymixerSIMD;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Using %s mixing kernels for master devices.\n", (mixSIMDLevel == kPsychPAMixAVX) ? "AVX" : ((mixSIMDLevel == kPsychPAMixSSE2) ? "SSE2" : "plain C"));
+	}
 
-	// Make sure PortAudio is online:
-	PsychPortAudioInitialize();
+	// Return current/old slaveWorkerThreads:
+	PsychCopyOutDoubleArg(6, kPsychArgOptional, (double) slaveWorkerThreads);
 
-	// Return count:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevicecount);
+	// Get optional new slaveWorkerThreads:
+	if (PsychCopyInIntegerArg(6, kPsychArgOptional, &myworkers)) {
+		if (myworkers < 0 || myworkers > MAX_PSYCH_AUDIO_WORKER_THREADS) {
+			sprintf(msgerr, "Invalid setting for 'slaveWorkerThreads' provided. Valid are 0 to %i.", MAX_PSYCH_AUDIO_WORKER_THREADS);
+			PsychErrorExitMsg(PsychError_user, msgerr);
+		}
+		slaveWorkerThreads = myworkers;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Parallel rendering of slaves on %i worker threads %s.\n", slaveWorkerThreads, (slaveWorkerThreads > 0) ? "enabled" : "disabled");
+	}
 
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('LatencyBias') - Set a manual bias for the latencies we operate on.
+/* PsychPortAudio('UseSchedule') - Enable & Create, or disable and destroy a playback schedule.
  */
-PsychError PSYCHPORTAUDIOLatencyBias(void) 
+PsychError PSYCHPORTAUDIOUseSchedule(void) 
 {
- 	static char useString[] = "oldbias = PsychPortAudio('LatencyBias', pahandle [,biasSecs]);";
+ 	static char useString[] = "PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
 	static char synopsisString[] = 
-		"Set audio output latency bias in seconds to 'biasSecs' and/or return old bias for a device "
-		"'pahandle'. The device must be open for this setting to take effect. It is reset to zero at "
-		"each reopening of the device. PsychPortAudio computes a latency value for the expected latency "
-		"of an audio output device to get its timing right. If this latency value is slightly off for "
-		"some reason, you can provide a bias value with this function to correct the computed value.\n\n"
-		"Please note that this 'biasSecs' setting is applied to either audio playback or audio capture "
-		"if your device is configured in simplex mode, either for playback *or* capture. If your device "
-		"is opened in full-duplex mode for simultaneous capture and playback, then the bias value is only "
-		"applied to the playback timing and timestamps, but not to the capture timing and timestamps!\n\n"
-		"See the online help for PsychPortAudio for more in depth explanation of latencies. ";
-
-	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
+		"Enable or disable use of a preprogrammed schedule for audio playback on audio device 'pahandle'.\n"
+		"Schedules are similar to playlists on your favorite audio player. A schedule allows to define a sequence "
+		"of distinct sounds to play in succession. When PsychPortAudio('Start') is called, processing of "
+		"the schedule begins and the first programmed sound snippet is played, followed by the 2nd, 3rd, ... "
+		"until the whole schedule has been played once and playback stops. You can add new sound snippets to the "
+		"schedule while playback is running for uninterrupted playback of long sequences of sound.\n"
+		"Each sound snippet or slot in the schedule defines a soundbuffer to play back via a 'bufferhandle', "
+		"within the buffer a subsegment (a so called playloop) defined by start- and endpoint, and a number "
+		"of repetitions for that playloop.\n"
+		"This subfunction allows to either enable use of schedules by setting the 'enableSchedule' flag to 1, "
+		"in which case a schedule with a maximum of 'maxSize' distinct slots is created ('maxSize' defaults to 128 slots), "
+		"or to disable use of schedules by setting 'enableSchedule' to 0, in which case PsychPortAudio reverts "
+		"back to its normal playback behaviour and an existing schedule is deleted.\n"
+		"A 'enableSchedule' setting of 2 will reset an existing schedule, ie. clear it of all its entries, "
+		"so it is ready to be rewritten with new entries. You should reset and rewrite a schedule each "
+		"time after playback/processing of a schedule has finished or has been stopped.\n"
+		"A 'enableSchedule' setting of 3 will reactivate an existing schedule, ie. prepare it for a replay.\n"
+		"See the subfunction 'AddToSchedule' on how to populate the schedule with actual entries.\n";
+		
+	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart AddToSchedule";
 	
-	double bias= DBL_MAX;
 	int pahandle = -1;
-
+	int enableSchedule;
+	int maxSize = 128;
+	int j;
+	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
@@ -4683,81 +7285,182 @@ PsychError PSYCHPORTAUDIOLatencyBias(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	// Copy in optional new bias value:
-	PsychCopyInDoubleArg(2, kPsychArgOptional, &bias);
-	
-	// Return current/old bias:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].latencyBias);
+	// Make sure the device is fully idle: We can check without mutex held, as a device which is
+	// already idle (state == 0) can't switch by itself out of idle state (state > 0), neither
+	// can an inactive stream start itself.
+	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Tried to enable/disable audio schedule while audio device is active. Forbidden! Call 'Stop' first.");
 
-	// Set new bias, if one was provided:
-	if (bias!=DBL_MAX) {
-		if (audiodevices[pahandle].opmode & kPortAudioIsSlave) PsychErrorExitMsg(PsychError_user, "Change of latency bias is not allowed on slave devices! Set it on associated master device.");
-		if (Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change 'biasSecs' while device is active! Forbidden!");
-		audiodevices[pahandle].latencyBias = bias;
+	// At this point the deivce is idle and will remain so during this routines execution,
+	// so it won't touch any of the schedule related variables and we can manipulate them
+	// without a need to lock the device:
+
+	// Get required enable flag:
+	PsychCopyInIntegerArg(2, kPsychArgRequired, &enableSchedule);
+	if (enableSchedule < 0 || enableSchedule > 3)  PsychErrorExitMsg(PsychError_user, "Invalid 'enableSchedule' provided. Must be 0, 1, 2 or 3!");
+	if (enableSchedule && audiodevices[pahandle].ringBuffer) PsychErrorExitMsg(PsychError_user, "Tried to enable schedule on a device which uses a ring buffer. Forbidden! Disable the ring buffer first.");
+
+	// Get the optional maxSize parameter:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &maxSize);
+	if (maxSize < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'maxSize' provided. Must be greater than zero!");
+
+	// Revival of existing schedule requested?
+	if (enableSchedule == 3) {
+		if (NULL == audiodevices[pahandle].schedule) {
+			PsychErrorExitMsg(PsychError_user, "'enableSchedule' == 3 requested to revive current schedule, but no such schedule exists! You must create it first.");
+		}
+
+		// Reset current position in schedule to start:
+		audiodevices[pahandle].schedule_pos = 0;
+		
+		PsychLockMutex(&bufferListmutex);
+		for (j = 0; j < audiodevices[pahandle].schedule_size; j++) {
+			// Slot occupied, but no longer pending?
+			if ((audiodevices[pahandle].schedule[j].mode & 3) == 1) {
+				// Reactivate this slot to pending. It references its buffer again, unless that buffer got deleted meanwhile:
+				audiodevices[pahandle].schedule[j].mode |= 2;
+				PsychPAReferenceSlotBuffer(&(audiodevices[pahandle].schedule[j]));
+			}
+		}
+		PsychUnlockMutex(&bufferListmutex);
+		
+		// Done.
+		return(PsychError_none);
+	}
+
+
+	// Reset of existing schedule requested?
+	if ((enableSchedule == 2) && (audiodevices[pahandle].schedule)) {
+		// Yes: Simply set requested size to current size, this will trigger
+		// a memset() to zero below, instead of a realloc or alloc, which is
+		// exactly what we want:
+		maxSize = audiodevices[pahandle].schedule_size;
+	}
+
+	// Release an already existing schedule: This will take care of both,
+	// disabling use of schedules if this is a disable call, and resetting
+	// of an existing schedule if this is an enable call following another
+	// enable call:
+	if (audiodevices[pahandle].schedule) {
+		// Pending slots of the old schedule no longer reference their buffers:
+		PsychPAUnreferenceScheduleBuffers(&audiodevices[pahandle]);
+
+		// Schedule already exists: Is this by any chance an enable call and
+		// the requested size of the new schedule matches the size of the current
+		// one?
+		if (enableSchedule && (audiodevices[pahandle].schedule_size == maxSize)) {
+			// Yes! Have a schedule of exactly wanted size, no need to free and
+			// realloc - We simply clear it out by zero filling:
+			memset((void*) audiodevices[pahandle].schedule, 0, (size_t) (maxSize * sizeof(PsychPASchedule)));
+		}
+		else {
+			// No. Release old schedule...
+			free(audiodevices[pahandle].schedule);
+			audiodevices[pahandle].schedule = NULL;
+			audiodevices[pahandle].schedule_size = 0;
+		}
 	}
+
+	// Reset current position in schedule to start and size to zero in any case:
+	audiodevices[pahandle].schedule_pos = 0;
+	audiodevices[pahandle].schedule_writepos = 0;
 	
+	// Enable/Reset request?
+	if (enableSchedule && (NULL == audiodevices[pahandle].schedule)) {
+		// Enable request - Allocate proper schedule:
+		audiodevices[pahandle].schedule_size = 0;
+		audiodevices[pahandle].schedule = (PsychPASchedule*) calloc(maxSize, sizeof(PsychPASchedule));
+		if (audiodevices[pahandle].schedule == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create a schedule!");
+
+		// Assign new size:
+		audiodevices[pahandle].schedule_size = maxSize;
+	}
+
+	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('Volume') - Set volume per device.
+/* PsychPortAudio('AddToSchedule') - Add command slots to a playback schedule.
  */
-PsychError PSYCHPORTAUDIOVolume(void) 
+PsychError PSYCHPORTAUDIOAddToSchedule(void) 
 {
- 	static char useString[] = "[oldMasterVolume, oldChannelVolumes] = PsychPortAudio('Volume', pahandle [, masterVolume][, channelVolumes]);";
+ 	static char useString[] = "[success, freeslots] = PsychPortAudio('AddToSchedule', pahandle [, bufferHandle=0][, repetitions=1][, startSample=0][, endSample=max][, UnitIsSeconds=0][, specialFlags=0]);";
+	//																				  1           2                 3                4                5                6				  7
 	static char synopsisString[] = 
-		"Set audio output volume(s) and/or return old volumes for a device 'pahandle'.\n"
-		"The device must be open for this setting to take effect. It is initially set to 1.0. "
-		"On a regular audio device or master device, you can only set the global 'masterVolume' for the "
-		"whole device. On a slave device, you can optionally define a per-channel volume vector 'channelVolumes'. "
-		"E.g., if your slave device has two output channels, a 'channelVolumes' "
-		"vector of [0.9 ; 0.25] would set the first channel to 90% intensity, the 2nd channel to "
-		"25% intensity. The elements of 'channelVolumes' and the 'masterVolume' can be any value. The value for a device or a "
-		"channel is simply multiplied with each output sample before output to the hardware, so "
-		"that a value of 1.0 (the default setting for each device and channel) will pass samples "
-		"unmodified, a value of 0.5 would reduce intensity to 50%, a value of 1.25 would amplify "
-		"to 125% of the original value, or a value of -1 would invert the signal.\n"
-		"Be careful with amplification (values > 1). If the final sample leaves the valid output "
-		"range of -1.0 to 1.0, you may hear ugly auditory clipping artifacts and possibly damage "
-		"your ears or speakers! In 'normal' mode, PsychPortAudio clamps output samples to the valid "
-		"range of -1 to 1, but in high timing precision/low latency mode, clamping is not performed "
-		"in order to save computation time.\n\n"
-		"Caution: All volume settings are silently ignored on regular audio devices or master devices "
-		"if audio monitoring mode is active. On a slave device, per-channel volumes would be still applied "
-		"in monitoring mode, but not the masterVolume. This is for efficiency reasons. If you need volume "
-		"settings in monitoring mode, then open a master device, attach a slave device to it in monitoring "
-		"mode, then set the 'channelVolumes' of that slave device to control volume of monitoring.\n\n"
-		"Caution: The volume settings only affect what is sent to your computers sound system. The "
-		"operating system or audio hardware itself may apply additional volume settings, gains, filters "
-		"etc., depending on your specific setup. These are only controllable via external system specific tools, "
-		"PsychPortAudio doesn't know about such additional settings and can't control them in any way!\n\n"
-		"If you need to modulate output volume over time, you can also attach an additional slave "
-		"device whose opMode is set to act as an AMmodulator to a master or slave device, see help for 'OpenSlave'. "
-		"Such a slave device will not output sound itself, but use the data stored in its playback "
-		"buffers to modulate the amplitude of its parent slave, or of the summed signal of all previously "
-		"attached slaves for a master over time. Example: You create a master device, then 'OpenSlave' three regular slave "
-		"devices, then 'OpenSlave' a AMmodulator slave device. During playback, the sound signals "
-		"of the three regular slaves will be mixed together. The combined signal will be multiplied "
-		"by the per-sample volume values provided by the AMmodulator slave device, thereby modulating "
-		"the amplitude or ''acoustic envelope'' of the mixed signals. The resulting signal will be "
-		"played by the master device. If you'd attach more regular slave devices after the AMmodulator, "
-		"their signal would not get modulated, but simply added to the modulated signal of the first "
-		"three devices.\n\n"
-		"You can also modulate only the signals of a specific slave device, by attaching the modulator "
-		"to that slave device in the 'OpenSlave' call. You'd simply pass the handle of the slave that "
-		"should be modulated to 'OpenSlave', instead of the handle of a master device.\n\n";
+		"Add a new item to an existing schedule for audio playback on audio device 'pahandle'.\n"
+		"The schedule must have been created and enabled already via a previous call to 'UseSchedule'. "
+		"The function returns if the addition of a new item was successfull via the return argument "
+		"'success' (1=Success, 0=Failed), and the number of remaining free slots in 'freeslots'. "
+		"Failure to add an item can happen if the schedule is full. If playback is running, you can "
+		"simply retry after some time, because eventually the playback will consume and thereby free "
+		"at least one slot in the schedule. If playback is stopped and you get this failure, you should "
+		"reallocate the schedule with a bigger size via a proper call to 'UseSchedule'.\n"
+		"Please note that after playback/processing of a schedule has finished by itself, or due to "
+		"'Stop'ping the playback via the stop function, you should clear or reactivate the schedule and rewrite "
+		"it, otherwise results at next call to 'Start' may be undefined. You can clear/reactivate a schedule "
+		"efficiently without resizing it by calling 'UseSchedule' with an enableFlag of 2 or 3.\n\n"
+		"The following optional paramters can be used to define the new slot in the schedule:\n"
+		"'bufferHandle' Handle of the audio buffer which should be used for playback of this slot. "
+		"The default value zero will play back the standard audio buffer created by a call to 'FillBuffer'. "
+		"'bufferHandle' can also be a vector of buffer handles, to append one slot per buffer, all with the "
+		"same remaining parameters, in a single call. Either all slots are added, or none if the schedule "
+		"doesn't have enough free slots, in which case 'success' is 0 and 'freeslots' tells how many slots "
+		"are free. Command codes can't be part of such a vector.\n"
+		"'repetitions' How often should playback of this slot be repeated. Fractional positive values are "
+		"allowed, the value zero (ie. infinite repetition) is not allowed in this driver release.\n"
+		"'startSample' and 'endSample' define a playback loop - a subsegment of the audio buffer to which "
+		"playback should be restricted, and 'UnitIsSeconds' tells if the given loop boundaries are expressed "
+		"in audio sample frames, or in seconds realtime. See the help for the 'SetLoop' function for more "
+		"explanation.\n\n"
+		"'specialFlags' is an optional parameter to pass in some special mode flags to alter processing "
+		"of a slot: Defaults to zero. If the value '1' is used (or added), then a slot is not automatically "
+		"disabled after it has been used up, but it will be reused on repeated execution of the schedule. "
+		"You'll need to set this flag on all slots in a schedule if you want the schedule to auto-repeat "
+		"without the need for manual reset commands."
+		"\n\n"
+		"This function can also be used to sneak special command slots into the schedule:\n"
+		"If you specify a negative number for the 'bufferHandle' argument, then this actually "
+		"defines a command slot instead of a regular playback slot, and the number is a command code "
+		"that defines the action to take. For timing related actions, the 'repetitions' parameter is "
+		"abused as a 'tWhen' time specification in seconds.\n"
+		"Following command codes are currently defined: (Add numbers to combine options)\n"
+		"1   = Pause audio playback (and capture) immediately, resume it at a given 'tWhen' target time.\n"
+		"2   = (Re-)schedule the end of playback for given 'tWhen' target time.\n"
+		"You must specify the type of 'tWhen' if you specify 1 or 2 as commandCode:"
+		"+4  = 'tWhen' is an absolute GetSecs() style system time.\n"
+		"+8  = 'tWhen' is a time delta to the last requested start time of playback.\n"
+		"+16 = 'tWhen' is a time delta to the last actual start time of playback.\n"
+		"+32 = 'tWhen' is a time delta to the last requested end time of playback. Broken & Defective!!\n"
+		"+64 = 'tWhen' is a time delta to the last actual end time of playback. Broken & Defective!!\n"
+		"\n"
+		"E.g., you want to (re)start playback at a certain time, then you'd set 'bufferHandle' to -5, because "
+		"command code would be 1 + 4 == 5, so negated it is -5. Then you'd specify the requested time in the "
+		"'repetitions' parameter as an absolute time in seconds.\n\n";
 
-	static char seeAlsoString[] = "Open ";	 
+	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart UseSchedule";
 	
-	double masterVolume;
-	double *channelVolumes;
-	int m, n, p, i;
+	PsychPASchedule* slot;
+	PsychPABuffer** buffers;
+	double* handles = NULL;
+	double* startSamples;
+	double* endSamples;
+	int	slotid;
+	double startSample, endSample, sMultiplier;
+	psych_int64 maxSample, count, k, m, n, p;
+	int unitIsSecs;
 	int pahandle = -1;
-
+	int bufferHandle = 0;
+	unsigned int commandCode = 0;
+	int specialFlags = 0;
+	double repetitions = 1;
+	psych_bool endGiven;
+	int success = 0;
+	int freeslots = 0;
+	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(7));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(2));	 // The maximum number of outputs
 
@@ -4767,253 +7470,414 @@ PsychError PSYCHPORTAUDIOVolume(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	// Return old masterVolume:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevices[pahandle].masterVolume);
+	// Make sure there is a schedule available:
+	if (audiodevices[pahandle].schedule == NULL) PsychErrorExitMsg(PsychError_user, "You tried to AddToSchedule, but use of schedules is disabled! Call 'UseSchedule' first to enable them.");
 
-	// Copy in optional new masterVolume: We can assign this without locking, as a single scalar
-	// 32-bit float assignment is basically atomic:
-	if (PsychCopyInDoubleArg(2, kPsychArgOptional, &masterVolume)) audiodevices[pahandle].masterVolume = (float) masterVolume;
+	// Get optional bufferhandle, or a vector of bufferhandles to append one slot per buffer:
+	if (PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &m, &n, &p, &handles) && (m * n * p > 1)) {
+		count = m * n * p;
+		if (count > (psych_int64) audiodevices[pahandle].schedule_size) PsychErrorExitMsg(PsychError_user, "Invalid 'bufferHandle' vector provided. Has more elements than the schedule has slots!");
+	}
+	else {
+		count = 1;
+		handles = NULL;
+		PsychCopyInIntegerArg(2, kPsychArgOptional, &bufferHandle);
+	}
 
-	// Slaves can have per-channel volumes:
-	if (audiodevices[pahandle].opmode & kPortAudioIsSlave) {
-		// Slave device: Need whole vector:
-		
-		// Copy out old settings:
-		PsychAllocOutDoubleMatArg(2, kPsychArgOptional, 1, audiodevices[pahandle].outchannels, 1, &channelVolumes);
-		for (i = 0; i < audiodevices[pahandle].outchannels; i++) channelVolumes[i] = (double) audiodevices[pahandle].outChannelVolumes[i];
-		
-		// Get optional new settings:
-		if (PsychAllocInDoubleMatArg(3, kPsychArgOptional, &m, &n, &p, &channelVolumes)) {
-			// Valid?
-			if (m * n != audiodevices[pahandle].outchannels || p != 1) PsychErrorExitMsg(PsychError_user, "Invalid channelVolumes vector for audio slave device provided. Number of elements doesn't match number of audio output channels!");
+	// if (bufferHandle < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'bufferHandle' provided. Must be greater or equal to zero, and a handle to an existing buffer!");
+	if (bufferHandle < 0) {
+		// This isn't a bufferHandle but a command code, ergo this ain't a
+		// audio playout buffer, but a command buffer:
+		commandCode = -bufferHandle;
+		bufferHandle = 0;
 
-			// Assign, but with device mutex of master device held, so we don't update in
-			// the middle of a mix cycle for our slave device:
-			PsychPALockDeviceMutex(&audiodevices[audiodevices[pahandle].pamaster]);
-			for (i = 0; i < audiodevices[pahandle].outchannels; i++) audiodevices[pahandle].outChannelVolumes[i]  = (float) channelVolumes[i];
-			PsychPAUnlockDeviceMutex(&audiodevices[audiodevices[pahandle].pamaster]);
+		// Child protection: Must give a timespec type specifier if some time related action is requested:
+		if ((commandCode & (1 | 2)) && !(commandCode & (4 | 8 | 16 | 32 | 64))) PsychErrorExitMsg(PsychError_user, "Invalid commandCode provided: You requested scheduled (re)start or end of operation, but didn't provide any of the required timespec-type specifiers!");
+	}
+
+	// Validate all handles, and if they are non-zero, try to dereference them from dynamic buffers:
+	buffers = (PsychPABuffer**) PsychMallocTemp((size_t) count * sizeof(PsychPABuffer*));
+	for (k = 0; k < count; k++) {
+		if (handles) {
+			bufferHandle = (int) handles[k];
+			if ((bufferHandle < 0) || ((double) bufferHandle != handles[k])) PsychErrorExitMsg(PsychError_user, "Invalid 'bufferHandle' vector provided. All elements must be integral handles greater or equal to zero, command codes are not allowed!");
+		}
+
+		buffers[k] = NULL;
+		if (bufferHandle > 0) {
+			// Deref bufferHandle: Issue error if no buffer with such a handle exists:
+			buffers[k] = PsychPAGetAudioBuffer(bufferHandle);
+
+			// Validate matching output channel count:
+			if (buffers[k]->outchannels != audiodevices[pahandle].outchannels) {
+				printf("PsychPortAudio-ERROR: Audio channel count %i of audiobuffer with handle %i doesn't match channel count %i of audio device!\n", buffers[k]->outchannels, bufferHandle, audiodevices[pahandle].outchannels);
+				PsychErrorExitMsg(PsychError_user, "Referenced audio buffer 'bufferHandle' has an audio channel count that doesn't match channels of audio device!");
+			}
+		}
+	}
+
+	// Get optional repetitions. We abuse it also for the tWhen parameter if this
+	// is a commandbuffer instead of an audio buffer:
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &repetitions);
+	if ((repetitions < 0) && (commandCode == 0)) PsychErrorExitMsg(PsychError_user, "Invalid 'repetitions' provided. Must be a positive or zero number!");
+
+	// Get loop parameters, if any:
+	unitIsSecs = 0;
+	PsychCopyInIntegerArg(6, kPsychArgOptional, &unitIsSecs);
+
+	// Set maxSample to maximum integer: The scheduler (aka PsychPACompileScheduleSlot()) will test if the playloop extends
+	// beyond valid playbuffer boundaries and clamp to end-of-buffer if needed, so this is safe:
+	// Ok, not quite the maximum 64 bit signed integer, but 2^32 counts less. Why? Because we assign
+	// maxSample to a double variable below, then that back to a int64. Due to limited precision of
+	// the double data type, roundoff errors would cause a INT64_MAX to overflow the representable
+	// max value of 2^63 for psych_int64, thereby causing storage of wrapped around negative value,
+	// and the whole logic would blow up! Keep some (overly large) security margin to prevent this.
+	// Oh, and we need to divide by max number of device channels, as otherwise some multiplication
+	// in the audio schedule processing may overflow and wreak havoc:
+	maxSample = ((INT64_MAX - (psych_int64) INT32_MAX)) / ((psych_int64) MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE);
+
+	// Copy in optional startSample:
+	startSample = 0;
+	PsychCopyInDoubleArg(4, kPsychArgOptional, &startSample);
+	if (startSample < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startSample' provided. Must be greater or equal to zero!");
+
+	// Copy in optional endSample:
+	endSample = 0;
+	endGiven = PsychCopyInDoubleArg(5, kPsychArgOptional, &endSample);
+
+	// Map loop boundaries to sample frames of each buffer, as buffers can have different sample rates:
+	startSamples = (double*) PsychMallocTemp((size_t) count * sizeof(double));
+	endSamples = (double*) PsychMallocTemp((size_t) count * sizeof(double));
+	for (k = 0; k < count; k++) {
+		sMultiplier = (unitIsSecs > 0) ? PsychPABufferSampleRate(&audiodevices[pahandle], buffers[k]) : 1.0;
+		startSamples[k] = startSample * sMultiplier;
+		if (endGiven) {
+			endSamples[k] = endSample * sMultiplier;
+			if (endSamples[k] > maxSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be no greater than total buffersize!");
+		}
+		else {
+			endSamples[k] = maxSample;
 		}
+
+		if (endSamples[k] < startSamples[k]) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be greater or equal than 'startSample'!");
+	}
+
+	// Copy in optional specialFlags:
+	PsychCopyInIntegerArg(7, kPsychArgOptional, &specialFlags);
+
+	// Tabulate resampler filters for the sample rates of the buffers now, instead of while the engine is locked out:
+	if (commandCode == 0) {
+		for (k = 0; k < count; k++) PsychPAGetResamplerBankForRate(&audiodevices[pahandle], PsychPABufferSampleRate(&audiodevices[pahandle], buffers[k]));
+	}
+	
+	// All settings validated and ready to initialize slots in the schedule:
+
+	// Lock device:
+	PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+	// Enough unoccupied space in schedule? Ie., are all needed slots free (either never used, or already consumed and ready for recycling)?
+	for (k = 0; k < count; k++) {
+		if (audiodevices[pahandle].schedule[(audiodevices[pahandle].schedule_writepos + k) % audiodevices[pahandle].schedule_size].mode & 2) break;
+	}
+
+	// Recompute number of free slots:
+	if (audiodevices[pahandle].schedule_size >= (audiodevices[pahandle].schedule_writepos - audiodevices[pahandle].schedule_pos)) {
+		freeslots = audiodevices[pahandle].schedule_size - (audiodevices[pahandle].schedule_writepos - audiodevices[pahandle].schedule_pos);
 	}
 	else {
-		// Superfluous channelVolumes for a non-slave provided?
-		if (PsychAllocInDoubleMatArg(3, kPsychArgOptional, &m, &n, &p, &channelVolumes)) {
-			PsychErrorExitMsg(PsychError_user, "Invalid channelVolumes vector for a non-slave device provided. Only slave devices accept this vector!");			
+		freeslots = 0;
+	}
+
+	if (k == count) {
+		// Pending slots reference their buffers until they are consumed. Their playback parameters get precompiled
+		// right away, so paCallback doesn't need to resolve buffers and loops when it advances to them:
+		PsychLockMutex(&bufferListmutex);
+
+		for (k = 0; k < count; k++) {
+			// Map writepos to slotindex:
+			slotid = audiodevices[pahandle].schedule_writepos % audiodevices[pahandle].schedule_size;
+
+			// Fill slot. If paCallback couldn't release the buffer reference of the slot when it got consumed, do it now:
+			slot = (PsychPASchedule*) &(audiodevices[pahandle].schedule[slotid]);
+			if (slot->mode & 8) PsychPAUnreferenceSlotBuffer(slot);
+			slot->mode = 1 | 2 | ((specialFlags & 1) ? 4 : 0);
+			slot->bufferhandle   = (handles) ? (int) handles[k] : bufferHandle;
+			slot->buffergeneration = (buffers[k]) ? buffers[k]->generation : 0;
+			slot->repetitions    = (commandCode == 0) ? ((repetitions == 0) ? -1 : repetitions) : 0.0;;
+			slot->loopStartFrame = startSamples[k];
+			slot->loopEndFrame   = endSamples[k];
+			slot->command		 = commandCode;
+			slot->tWhen			 = (commandCode > 0) ? repetitions : 0.0;
+
+			PsychPAReferenceSlotBuffer(slot);
+			PsychPACompileScheduleSlot(&audiodevices[pahandle], slot);
+
+			// Advance write position for next update iteration:
+			audiodevices[pahandle].schedule_writepos++;
 		}
+
+		PsychUnlockMutex(&bufferListmutex);
+
+		freeslots = (freeslots > count) ? freeslots - (int) count : 0;
+		success = 1;
+	}
+	else {
+		// Nope. Not enough free slots. A single slot request reports zero free slots, as before:
+		success = 0;
+		if (count == 1) freeslots = 0;
 	}
 
+	// Unlock device:
+	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+
+	// Return optional result code:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) success);
+
+	// Return optional remaining number of free slots:
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) freeslots);
+	
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('GetDevices') - Enumerate all available sound devices.
+/* PsychPortAudio('UseRingBuffer') - Enable & Create, or disable and destroy a lock-free playback ring buffer.
  */
-PsychError PSYCHPORTAUDIOGetDevices(void) 
+PsychError PSYCHPORTAUDIOUseRingBuffer(void) 
 {
- 	static char useString[] = "devices = PsychPortAudio('GetDevices' [, devicetype] [, deviceIndex]);";
+ 	static char useString[] = "PsychPortAudio('UseRingBuffer', pahandle, enableRing [, capacityFrames]);";
 	static char synopsisString[] = 
-		"Returns 'devices', an array of structs, one struct for each available PortAudio device.\n\n"
-		"If the optional parameter 'deviceIndex' is provided and the optional parameter 'devicetype' "
-		"is set to [], then only returns a single struct with information about the device with index "
-		"'deviceIndex'.\n\n"
-		"Each struct contains information about its associated PortAudio device. The optional "
-		"parameter 'devicetype' can be used to enumerate only devices of a specific class: \n"
-		"1=Windows/DirectSound, 2=Windows/MME, 3=Windows/ASIO, 11=Windows/WDMKS, 13=Windows/WASAPI, "
-		"8=Linux/ALSA, 7=Linux/OSS, 12=Linux/JACK, 5=MacOSX/CoreAudio.\n\n"
-		"On OS/X you'll usually only see devices for the CoreAudio API, a first-class audio subsystem. "
-		"On Linux you may have the choice between ALSA, JACK and OSS. ALSA or JACK provide very low "
-		"latencies and very good timing, OSS is an older system which is less capable but not very "
-		"widespread in use anymore. On MS-Windows you'll have the ''choice'' between up to 5 different "
-		"audio subsystems: If you buy an expensive sound card with ASIO drivers, pick that API for low "
-		"latency, it should give you comparable performance to OS/X or Linux. 2nd best choice "
-		"would be WASAPI (on Windows-Vista) or WDMKS (on Windows-2000/XP) for ok latency on good days. DirectSound is the next "
-		"worst choice if you have hardware with DirectSound support. If everything else fails, you'll be left "
-		"with MME, a premium example of system misdesign successfully sold to paying customers.";
+		"Enable or disable use of a lock-free ring buffer for streaming audio playback on audio device 'pahandle'.\n"
+		"In ring buffer mode, the device doesn't play back its regular sound buffer or a schedule. Instead, "
+		"you continuously push new sound data into a ring buffer of fixed capacity via PsychPortAudio('PushAudio', ...), "
+		"and the audio engine plays it back in the order it was pushed. Pushing data never locks out the realtime "
+		"audio processing thread, which makes this mode well suited for long streaming playback of generated or "
+		"decoded sound, where 'FillBuffer' streaming refills would cause too much overhead.\n"
+		"If the ring buffer runs empty while playback is active, silence is played until new data arrives. Such "
+		"underruns are counted and can be queried via the fields 'RingUnderruns' and 'RingUnderrunSecs' of "
+		"PsychPortAudio('GetStatus').\n"
+		"'enableRing' 1 creates a new, empty ring buffer, discarding any previous one, 0 disables ring buffer mode and "
+		"deletes the ring buffer.\n"
+		"'capacityFrames' optional: Capacity of the ring buffer in sample frames. Will be rounded up to the next "
+		"power of two. Defaults to one second of sound at the devices sampling rate.\n"
+		"Ring buffer mode can only be changed while the device is stopped. It is not supported on master devices, or "
+		"together with a schedule.\n";
 		
-	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
-	PsychGenericScriptType 	*devices;
-	const char *FieldNames[]={	"DeviceIndex", "HostAudioAPIId", "HostAudioAPIName", "DeviceName", "NrInputChannels", "NrOutputChannels", 
-								 		"LowInputLatency", "HighInputLatency", "LowOutputLatency", "HighOutputLatency",  "DefaultSampleRate", "xxx" };
-	int devicetype = -1;
-	int deviceindex = -1;
-	int count = 0;
-	int i, ic, filteredcount;
-	const PaDeviceInfo* padev = NULL;
-	const PaHostApiInfo* hainfo = NULL;
+	static char seeAlsoString[] = "PushAudio Start Stop GetStatus";
+	
+	int pahandle = -1;
+	int enableRing;
+	double capacityFrames;
+	psych_int64 capacity;
+	unsigned int ringCapacity;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	PsychCopyInIntegerArg(1, kPsychArgOptional, &devicetype);
-	if (devicetype < -1) PsychErrorExitMsg(PsychError_user, "Invalid 'devicetype' provided. Valid are values of zero and greater.");
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
+	if (audiodevices[pahandle].opmode & kPortAudioIsMaster) PsychErrorExitMsg(PsychError_user, "Ring buffer playback is not supported on master devices.");
 
-	PsychCopyInIntegerArg(2, kPsychArgOptional, &deviceindex);
-	if (deviceindex < -1) PsychErrorExitMsg(PsychError_user, "Invalid 'deviceindex' provided. Valid are values of zero and greater.");
-	
-	// Provided deviceIndex overrides potentially provided deviceType, if any:
-	if (deviceindex >= 0 && devicetype >=0) PsychErrorExitMsg(PsychError_user, "Provided 'deviceindex' and 'devicetype'! This is forbidden. Provide one or the other.");
-	
-	// Query number of devices and allocate out struct array:
-	count = (int) Pa_GetDeviceCount();
-	if (count > 0) {
-		filteredcount = count;
-		if (devicetype!=-1) {
-			filteredcount = 0;
-			// Filtering by host API requested: Do it.
-			for (i=0; i<count; i++) {
-				padev = Pa_GetDeviceInfo((PaDeviceIndex) i);
-				hainfo = Pa_GetHostApiInfo(padev->hostApi);
-				if (hainfo->type == devicetype) filteredcount++;
-			}
-		}
+	// Make sure the device is fully idle, see 'UseSchedule' for why this is safe without mutex held:
+	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Tried to enable/disable ring buffer while audio device is active. Forbidden! Call 'Stop' first.");
 
-		// Only return one single struct if specific deviceindex given:
-		if (deviceindex >= 0) filteredcount = 1;
-		
-		// Alloc output struct array:
-		PsychAllocOutStructArray(1, kPsychArgOptional, filteredcount, 11, FieldNames, &devices);
-	}
-	else {
-		PsychErrorExitMsg(PsychError_user, "PTB-ERROR: PortAudio can't detect any supported sound device on this system.");
-	}
-	
-	// Iterate through device list:
-	ic = 0;
-	for (i=0; i<count; i++) {
-		// Return info about deviceindex i if it matches the selected deviceindex or if
-		// all devices should be returned:
-		if ((deviceindex == -1) || (deviceindex == i)) {
-			// Get info about deviceindex i:
-			padev = Pa_GetDeviceInfo((PaDeviceIndex) i);
-			hainfo = Pa_GetHostApiInfo(padev->hostApi);
-			
-			// Return info if devicetype doesn't matter or if it matches the required one:
-			if ((devicetype==-1) || (hainfo->type == devicetype)) {
-				// Fill slot ic of struct array with info of deviceindex i:
-				PsychSetStructArrayDoubleElement("DeviceIndex", ic, i, devices);
-				PsychSetStructArrayDoubleElement("HostAudioAPIId", ic, hainfo->type, devices);
-				PsychSetStructArrayStringElement("HostAudioAPIName", ic, (char*) (hainfo->name), devices);
-				PsychSetStructArrayStringElement("DeviceName", ic, (char*) (padev->name), devices);
-				PsychSetStructArrayDoubleElement("NrInputChannels", ic, padev->maxInputChannels, devices);
-				PsychSetStructArrayDoubleElement("NrOutputChannels", ic, padev->maxOutputChannels, devices);
-				PsychSetStructArrayDoubleElement("LowInputLatency", ic, padev->defaultLowInputLatency, devices);
-				PsychSetStructArrayDoubleElement("HighInputLatency", ic, padev->defaultHighInputLatency, devices);
-				PsychSetStructArrayDoubleElement("LowOutputLatency", ic, padev->defaultLowOutputLatency, devices);
-				PsychSetStructArrayDoubleElement("HighOutputLatency", ic, padev->defaultHighOutputLatency, devices);
-				PsychSetStructArrayDoubleElement("DefaultSampleRate", ic, padev->defaultSampleRate, devices);
-				// PsychSetStructArrayDoubleElement("xxx", ic, 0, devices);
-				ic++;
-			}
-		}
+	// Get required enable flag:
+	PsychCopyInIntegerArg(2, kPsychArgRequired, &enableRing);
+	if (enableRing < 0 || enableRing > 1)  PsychErrorExitMsg(PsychError_user, "Invalid 'enableRing' provided. Must be 0 or 1!");
+	if (enableRing && audiodevices[pahandle].schedule) PsychErrorExitMsg(PsychError_user, "Tried to enable ring buffer on a device which uses a schedule. Forbidden! Disable the schedule first.");
+
+	// Get the optional capacity, default to 1 second of sound:
+	capacityFrames = audiodevices[pahandle].streaminfo->sampleRate;
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &capacityFrames);
+	if (capacityFrames < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'capacityFrames' provided. Must be greater than zero!");
+
+	// Convert to samples and round up to power of two. We keep the capacity at most 2^30 samples, so
+	// the difference between the free running 32 bit read and write positions never becomes ambiguous:
+	capacity = (psych_int64) ceil(capacityFrames) * audiodevices[pahandle].outchannels;
+	if (capacity > (1 << 30)) PsychErrorExitMsg(PsychError_user, "Invalid 'capacityFrames' provided. Ring buffer would be too large!");
+	for (ringCapacity = 1; (psych_int64) ringCapacity < capacity; ringCapacity <<= 1);
+
+	// Release any existing ring buffer:
+	if (audiodevices[pahandle].ringBuffer) {
+		free(audiodevices[pahandle].ringBuffer);
+		audiodevices[pahandle].ringBuffer = NULL;
+		audiodevices[pahandle].ringCapacity = 0;
+	}
+
+	// Reset ring positions and underrun counters in any case:
+	audiodevices[pahandle].ringReadPos = 0;
+	audiodevices[pahandle].ringWritePos = 0;
+	audiodevices[pahandle].ringUnderruns = 0;
+	audiodevices[pahandle].ringUnderrunFrames = 0;
+
+	// Enable request?
+	if (enableRing) {
+		audiodevices[pahandle].ringBuffer = (float*) calloc(ringCapacity, sizeof(float));
+		if (audiodevices[pahandle].ringBuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create a ring buffer!");
+		audiodevices[pahandle].ringCapacity = ringCapacity;
+		if (verbosity > 4) printf("PsychPortAudio: INFO: Ring buffer of %i frames capacity enabled on device %i.\n", (int) (ringCapacity / audiodevices[pahandle].outchannels), pahandle);
 	}
-	
+
+	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('RunMode') - Select a different mode of operation.
- */
-PsychError PSYCHPORTAUDIORunMode(void) 
-{
- 	static char useString[] = "oldRunMode = PsychPortAudio('RunMode', pahandle [,runMode]);";
-	static char synopsisString[] = 
-		"Set general run mode to 'runMode' and/or return old runMode for a device 'pahandle'.\n"
-		"The device must be open for this setting to take effect and playback must be stopped if "
-		"one wants to change the setting. If playback isn't stopped, it will be forcefully stopped. "
-		"Change of runMode is not supported on slave devices. "
-		"The current/old runMode is returned in the optional return value 'oldRunMode'. "
-		"'runMode' is the optional new runmode: At device open time, the runMode defaults to one. "
-		"In mode zero, the audio hardware and all internal processing are completely stopped at end "
-		"of audio playback. This reduces system ressource usage (both hardware and computation time), "
-		"but may cause slightly longer latencies when re'Start'ing the device for playback of a different "
-		"sound, e.g., a sequence of sounds. In 'runMode' 1, the audio hardware and processing don't shut "
-		"down at the end of audio playback. Instead, everything remains active in a ''hot standby'' state. "
-		"This allows to very quickly (with low latency) restart sound playback via the 'RescheduleStart' "
-		"function. The downside is a permanent use of system ressources even if no sound is playing. "
-		"Future runMode settings may provide more interesting options, stay tuned...\n";
-		
-	static char seeAlsoString[] = "Start Stop RescheduleStart ";
-	
-	int runMode = -1;
-	int pahandle = -1;
-
+/* PsychPortAudio('PushAudio') - Push sound data into a playback ring buffer.
+ */
+PsychError PSYCHPORTAUDIOPushAudio(void) 
+{
+ 	static char useString[] = "[framesPushed, framesQueued, underruns] = PsychPortAudio('PushAudio', pahandle, bufferdata [, waitForSpace=1]);";
+	//							1			  2				3														  1			2			  3
+	static char synopsisString[] = 
+		"Push new sound data into the playback ring buffer of audio device 'pahandle'.\n"
+		"The device must have been switched to ring buffer mode via PsychPortAudio('UseRingBuffer', ...) beforehand. "
+		"'bufferdata' is a matrix with audio data in single() or double() format, with one row per output channel of "
+		"the device and one column per sample frame, as in 'FillBuffer'. Passing single() data is most efficient, "
+		"as it is copied directly into the ring buffer without any format conversion. Pushing never blocks the realtime "
+		"audio processing thread, so it is safe to call this at a high rate while playback is active.\n"
+		"'waitForSpace' optional: If set to 1 (the default), wait until enough free space is available in the ring buffer "
+		"to push all of 'bufferdata', as long as the device is playing. If set to 0, push only as many sample frames as "
+		"fit into the ring buffer immediately, and drop the remainder.\n"
+		"Returns the number of sample frames 'framesPushed' that actually got pushed, the number of sample frames "
+		"'framesQueued' waiting for playback in the ring buffer after the push, and the total number of ring buffer "
+		"'underruns' since start of playback.\n";
+
+	static char seeAlsoString[] = "UseRingBuffer FillBuffer GetStatus";	 
+  	
+	PsychPADevice* dev;
+	psych_int64 inchannels, insamples, p, count, chunk, space, total, j;
+	double*	indata = NULL;
+	float*  indatafloat = NULL;
+	float*  ringBuffer;
+	unsigned int writePos, ringMask, ringCapacity;
+	int pahandle = -1;
+	int waitForSpace = 1;
+	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+	if (dev->ringBuffer == NULL) PsychErrorExitMsg(PsychError_user, "Audio device is not in ring buffer mode. Call PsychPortAudio('UseRingBuffer', ...) first.");
 
-	// Copy in optional runMode value:
-	PsychCopyInIntegerArg(2, kPsychArgOptional, &runMode);
-	
-	// Return current/old runMode:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].runMode);
+	// Get sound data as float matrix if possible, as double matrix otherwise:
+	if (!PsychAllocInFloatMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indatafloat)) {
+		PsychAllocInDoubleMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indata);
+	}
 
-	// Set new runMode, if one was provided:
-	if (runMode != -1) {
-		// Doing this is a no-no on slaves:
-		if (audiodevices[pahandle].opmode & kPortAudioIsSlave) PsychErrorExitMsg(PsychError_user, "Change of runmode is not allowed on slave devices!");
+	if (inchannels != dev->outchannels) {
+		printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) dev->outchannels, (int) inchannels);
+		PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
+	}
 
-		// Stop engine if it is running:
-		if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
+	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
 
-		// Reset state:
-		audiodevices[pahandle].state = 0;
-		audiodevices[pahandle].reqstate = 255;
+	// Get optional wait flag:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &waitForSpace);
+
+	// We are the only writer of ringWritePos, and ringBuffer can't change while we are executing,
+	// as 'UseRingBuffer' runs on this thread as well. The audio thread only ever advances ringReadPos:
+	ringBuffer = dev->ringBuffer;
+	ringCapacity = dev->ringCapacity;
+	ringMask = ringCapacity - 1;
+	writePos = dev->ringWritePos;
+	total = inchannels * insamples;
+	j = 0;
+
+	while (j < total) {
+		// Free space in ring, in samples, rounded down to full sample frames:
+		space = (psych_int64) ringCapacity - (psych_int64) (unsigned int) (writePos - dev->ringReadPos);
+		space -= space % inchannels;
+		PsychPAMemoryBarrier();
+
+		if (space <= 0) {
+			// Ring full. Wait for the engine to consume data, unless we shouldn't wait or the
+			// engine is not playing, in which case no space would ever become available:
+			if (!waitForSpace || (dev->state == 0)) break;
+			PsychYieldIntervalSeconds(yieldInterval);
+			continue;
+		}
 
-		if (runMode < 0 || runMode > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'runMode' provided. Must be 0 or 1!");
+		count = (total - j < space) ? total - j : space;
 
-		// Assign new runMode:
-		audiodevices[pahandle].runMode = runMode;
+		// Copy in at most two contiguous chunks, one up to the end of the ring, one from its start:
+		while (count > 0) {
+			chunk = (count < (psych_int64) (ringCapacity - (writePos & ringMask))) ? count : (psych_int64) (ringCapacity - (writePos & ringMask));
+			PsychPACopyInSamples(&ringBuffer[writePos & ringMask], (indata) ? &indata[j] : NULL, (indatafloat) ? &indatafloat[j] : NULL, chunk);
+			writePos += (unsigned int) chunk;
+			j += chunk;
+			count -= chunk;
+		}
+
+		// Publish the new data to the engine only after it has been written:
+		PsychPAMemoryBarrier();
+		dev->ringWritePos = writePos;
 	}
 
+	// Return number of pushed frames, number of queued frames and count of underruns:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) (j / inchannels));
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) ((unsigned int) (dev->ringWritePos - dev->ringReadPos) / inchannels));
+	PsychCopyOutDoubleArg(3, kPsychArgOptional, (double) dev->ringUnderruns);
+
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('SetLoop') - Define a subrange of samples in the audio playback buffer to play.
+/* PsychPortAudio('UseAutomation') - Enable & Create, or disable and destroy parameter automation tracks.
  */
-PsychError PSYCHPORTAUDIOSetLoop(void) 
+PsychError PSYCHPORTAUDIOUseAutomation(void) 
 {
- 	static char useString[] = "PsychPortAudio('SetLoop', pahandle[, startSample=0][, endSample=max][, UnitIsSeconds=0]);";
+ 	static char useString[] = "PsychPortAudio('UseAutomation', pahandle, enableAutomation [, maxSize = 128]);";
 	static char synopsisString[] = 
-		"Restrict audio playback to a subrange of sound samples in the current audio playback buffer for "
-		"audio device 'pahandle'. The device must be open and a soundbuffer created via 'FillBuffer' "
-		"for this setting to take effect. The setting is reset at each non-streaming 'FillBuffer' call.\n"
-		"'startSample' defines the first sample to be played, it defaults to zero, ie. the very first in "
-		"the buffer. 'endSample' the last sample to be played, it defaults to the end of the buffer.\n"
-		"Calling this function without any parameter except 'pahandle' will therefore reset the playloop "
-		"to the full buffer size. It is possible but not advisable to change the loop range while "
-		"sound playback is active, as this may cause audible glitches or artifacts in the playback.\n"
-		"By default, 'startSample' and 'endSample' are specified in units of samples, but if the "
-		"optional flag 'UnitIsSeconds' is set to a non-zero value, then the given range is "
-		"interpreted in units of seconds. ";
-		
-	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart ";
-	
-	double startSample, endSample, sMultiplier;
-	psych_int64 maxSample;
-	int unitIsSecs;
+		"Enable or disable sample-accurate automation of volume settings on audio device 'pahandle'.\n"
+		"Parameter automation allows to define timelines of volume changes, e.g., fades, ramps or envelopes, which "
+		"are then applied by the audio engine itself while playback is running, precisely at the sample frames "
+		"corresponding to the requested times. This is both more accurate and much cheaper than repeatedly calling "
+		"PsychPortAudio('Volume') in a script loop.\n"
+		"Each device has one automation track for its 'masterVolume'. Slave devices additionally have one track per "
+		"output channel for the per-channel 'channelVolumes', see help for 'Volume'. Each track is a sequence of "
+		"breakpoints, defined via PsychPortAudio('AddToAutomation', ...). While a track has pending breakpoints, the "
+		"value of its parameter is computed for each output sample frame and the 'Volume' settings are updated accordingly. "
+		"After the last breakpoint, the parameter keeps the value of that breakpoint.\n"
+		"'enableAutomation' 1 creates new, empty automation tracks, each with room for 'maxSize' pending breakpoints, "
+		"discarding any previous tracks. 'maxSize' defaults to 128 breakpoints. An 'enableAutomation' setting of 2 clears "
+		"all pending breakpoints of the existing tracks, leaving the current volume settings as they are. A setting of 0 "
+		"disables automation and deletes all tracks.\n"
+		"This function can be called at any time, also while playback is active.\n";
+
+	static char seeAlsoString[] = "AddToAutomation Volume Start";
+	
+	PsychPADevice* dev;
+	PsychPAAutomationTrack* tracks = NULL;
+	PsychPAAutomationTrack* oldtracks;
+	float* mixgains = NULL;
+	float* oldmixgains;
 	int pahandle = -1;
-
+	int enableAutomation;
+	int maxSize = 128;
+	int t, ntracks, oldntracks;
+	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
@@ -5021,175 +7885,352 @@ PsychError PSYCHPORTAUDIOSetLoop(void)
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+	if ((dev->opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
 
-	unitIsSecs = 0;
-	PsychCopyInIntegerArg(4, kPsychArgOptional, &unitIsSecs);
-	sMultiplier = (unitIsSecs > 0) ? (double) audiodevices[pahandle].streaminfo->sampleRate : 1.0;
+	// Get required enable flag:
+	PsychCopyInIntegerArg(2, kPsychArgRequired, &enableAutomation);
+	if (enableAutomation < 0 || enableAutomation > 2)  PsychErrorExitMsg(PsychError_user, "Invalid 'enableAutomation' provided. Must be 0, 1 or 2!");
 
-	// Compute maxSample the maximum possible sampleframe index for given soundbuffer:
-	maxSample = (audiodevices[pahandle].outputbuffersize / sizeof(float) / audiodevices[pahandle].outchannels) - 1;
+	// Get the optional maxSize parameter:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &maxSize);
+	if (maxSize < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'maxSize' provided. Must be greater than zero!");
 
-	// Copy in optional startSample:
-	startSample = 0;
-	PsychCopyInDoubleArg(2, kPsychArgOptional, &startSample);
-	if (startSample < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startSample' provided. Must be greater or equal to zero!");
-	startSample *= sMultiplier;
-	
-	// Copy in optional endSample:
-	if (PsychCopyInDoubleArg(3, kPsychArgOptional, &endSample)) {
-		endSample *= sMultiplier;
-		if (endSample > maxSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be no greater than total buffersize!");
+	// Reset of existing tracks requested?
+	if (enableAutomation == 2) {
+		if (NULL == dev->automation) PsychErrorExitMsg(PsychError_user, "'enableAutomation' == 2 requested to clear automation tracks, but no such tracks exist! You must create them first.");
+
+		// Drop all pending breakpoints: Need to lock, as the engine may be running:
+		PsychPALockDeviceMutex(dev);
+		for (t = 0; t < dev->automationTracks; t++) {
+			dev->automation[t].readpos = dev->automation[t].writepos;
+			dev->automation[t].segStart = -1;
+		}
+		PsychPAUnlockDeviceMutex(dev);
+
+		return(PsychError_none);
+	}
+
+	// Enable request? Allocate new tracks outside of the lock, so the engine doesn't stall on us:
+	if (enableAutomation) {
+		// One track for masterVolume, plus one per output channel on slaves:
+		ntracks = 1 + ((dev->opmode & kPortAudioIsSlave) ? dev->outchannels : 0);
+
+		tracks = (PsychPAAutomationTrack*) calloc(ntracks, sizeof(PsychPAAutomationTrack));
+		if (tracks == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create automation tracks!");
+
+		for (t = 0; t < ntracks; t++) {
+			tracks[t].points = (PsychPAAutomationPoint*) calloc(maxSize, sizeof(PsychPAAutomationPoint));
+			tracks[t].size = maxSize;
+			tracks[t].segStart = -1;
+			if (tracks[t].points == NULL) {
+				while (t >= 0) free(tracks[t--].points);
+				free(tracks);
+				PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create automation tracks!");
+			}
+		}
+
+		if (ntracks > 1) {
+			mixgains = (float*) calloc(dev->outchannels, sizeof(float));
+			if (mixgains == NULL) {
+				for (t = 0; t < ntracks; t++) free(tracks[t].points);
+				free(tracks);
+				PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create automation tracks!");
+			}
+		}
 	}
 	else {
-		endSample = maxSample;
+		ntracks = 0;
 	}
 
-	if (endSample < startSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be greater or equal than 'startSample'!");
-	
-	// Ok, range is valid. Assign it:
-	PsychPALockDeviceMutex(&audiodevices[pahandle]);
-	audiodevices[pahandle].loopStartFrame = (psych_int64) startSample;
-	audiodevices[pahandle].loopEndFrame = (psych_int64) endSample;
-	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+	// Swap old tracks for new ones with device locked:
+	PsychPALockDeviceMutex(dev);
+	oldtracks = dev->automation;
+	oldntracks = dev->automationTracks;
+	oldmixgains = dev->automationMixGains;
+	dev->automation = tracks;
+	dev->automationTracks = ntracks;
+	dev->automationMixGains = mixgains;
+	PsychPAUnlockDeviceMutex(dev);
+
+	// On a slave, the master may still be mixing with the old gains: Lock it while releasing them:
+	if (dev->opmode & kPortAudioIsSlave) PsychPALockDeviceMutex(&audiodevices[dev->pamaster]);
+
+	if (oldtracks) {
+		for (t = 0; t < oldntracks; t++) free(oldtracks[t].points);
+		free(oldtracks);
+	}
 
+	if (oldmixgains) {
+		if (dev->mixGains == oldmixgains) dev->mixGains = dev->outChannelVolumes;
+		free(oldmixgains);
+	}
+
+	if (dev->opmode & kPortAudioIsSlave) PsychPAUnlockDeviceMutex(&audiodevices[dev->pamaster]);
+
+	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('EngineTunables') - Set tunable low-level engine parameters
+/* PsychPortAudio('AddToAutomation') - Add a breakpoint to a parameter automation track.
  */
-PsychError PSYCHPORTAUDIOEngineTunables(void) 
+PsychError PSYCHPORTAUDIOAddToAutomation(void) 
 {
- 	static char useString[] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend]);";
+ 	static char useString[] = "[success, freeslots] = PsychPortAudio('AddToAutomation', pahandle, target, when, value [, shape=0][, timeUnit=0]);";
+	//																						 1		   2		3	  4		   5		  6
 	static char synopsisString[] = 
-		"Return, and optionally set low-level tuneable driver parameters.\n"
-		"The driver must be idle, ie., no audio device must be open, if you want to change tuneables! "
-		"These tuneable parameters usually have reasonably chosen defaults and you should only "
-		"need to change them to work around bugs or flaws in your operating system, sound hardware or drivers, "
-		"or if you have very unusual needs or setups. Only touch these if you know what you're doing, probably "
-		"after consultation with the Psychtoolbox forum or Wiki. Some of these have potential to cause serious "
-		"system malfunctions if not selected properly!\n\n"
-		"'yieldInterval' - If the driver has to perform polling operations, it will release the cpu for "
-		"yieldInterval seconds inbetween unsuccessful polling iterations. Valid range is 0.0 to 0.1 secs, with "
-		"a reasonable default of 0.001 secs ie. 1 msec.\n"
-		"'MutexEnable' - Enable (1) or Disable (0) internal mutex locking of driver data structures to prevent "
-		"potential race-conditions between internal processing threads. Locking is enabled by default. Only "
-		"disable locking to work around seriously broken audio device drivers or system setups and be aware "
-		"that this may have unpleasant side effects and can cause all kinds of malfunctions by itself!\n"
-		"'lockToCore1' - Enable (1) or Disable (0) locking of all audio engine processing threads to cpu core 1 "
-		"on Microsoft Windows systems. By default threads are locked to cpu core 1 to avoid problems with "
-		"timestamping due to bugs in some microprocessors clocks and in Microsoft Windows itself. If you're "
-		"confident/certain that your system is bugfree wrt. to its clocks and want to get a bit more "
-		"performance out of multi-core machines, you can disable this. You must perform this setting before "
-		"you open the first audio device the first time, otherwise the setting might be ignored.\n"
-		"'audioserver_autosuspend' - Enable (1) or Disable (0) automatic suspending of running desktop "
-		"audio servers, e.g., PulseAudio, while PsychPortAudio is active. Default is (1) - suspend while "
-		"PsychPortAudio does its thing. Desktop sound servers like the commonly used PulseAudio server "
-		"can interfere with low level audio device access and low-latency / high-precision audio timing. "
-		"For this reason it is a good idea to switch them to standby (suspend) while a PsychPortAudio "
-		"session is active. Sometimes this isn't needed or not even desireable. Therefore this option "
-		"allows to inhibit this automatic suspending of audio servers.\n";
-
-	static char seeAlsoString[] = "Open ";	 
+		"Add a new breakpoint to a parameter automation track of audio device 'pahandle'.\n"
+		"Automation must have been enabled via PsychPortAudio('UseAutomation', ...) beforehand.\n"
+		"'target' selects the parameter to automate: 0 = The 'masterVolume' of the device. On slave devices, a 'target' "
+		"of k = 1 to number of output channels selects the 'channelVolumes' setting of output channel k.\n"
+		"'when' is the time at which the parameter shall reach the given 'value'. It is interpreted according to 'timeUnit':\n"
+		"0 = System time in seconds, as returned by GetSecs(), like 'when' in PsychPortAudio('Start').\n"
+		"1 = Seconds since start of playback, ie., since onset of the first sample after PsychPortAudio('Start').\n"
+		"2 = Sample frames since start of playback. This allows to key ramps to positions in your sound data.\n"
+		"'shape' defines how the parameter changes from the previous breakpoint, or from its current value, to 'value':\n"
+		"0 = Linear ramp, e.g., for linear fades.\n"
+		"1 = Exponential ramp, e.g., for fades with a constant change in decibels per second. Exponential ramps "
+		"between values which are zero or of different sign are not possible, so they are performed as linear ramps instead.\n"
+		"2 = Step: The parameter keeps its current value until 'when', then jumps to 'value'.\n"
+		"The first breakpoint on an idle track ramps from the current value of the parameter, starting at the first "
+		"sample played after the breakpoint was added. Breakpoints whose time has already passed take effect immediately. "
+		"Breakpoints on a track must be added in chronological order.\n"
+		"Returns a 'success' flag of 1 if the breakpoint could be added, 0 if the track is full, and the number of "
+		"remaining 'freeslots' in the track. Slots of breakpoints which have been reached during playback are recycled.\n";
+
+	static char seeAlsoString[] = "UseAutomation Volume Start";	 
+  	
+	PsychPADevice* dev;
+	PsychPAAutomationTrack* track;
+	PsychPAAutomationPoint* last;
+	int pahandle = -1;
+	int target, shape = 0, timeUnit = 0;
+	int success = 0;
+	double when, value;
+	unsigned int freeslots;
 	
-	int mutexenable, mylockToCore1, mysuspend;
-	double myyieldInterval;
-
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(4));    // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(4)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(2));	 // The maximum number of outputs
 
-	// Make sure no settings are changed while an audio device is open:
-	if ((PsychGetNumInputArgs() > 0) && (audiodevicecount > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change low-level engine parameter while at least one audio device is open! Forbidden!");
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
 
-	// Return current/old audioserver_suspend:
-	PsychCopyOutDoubleArg(4, kPsychArgOptional, (double) ((pulseaudio_autosuspend) ? 1 : 0));
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+	if (dev->automation == NULL) PsychErrorExitMsg(PsychError_user, "Parameter automation not enabled on this device. Call PsychPortAudio('UseAutomation', ...) first.");
 
-	// Get optional new audioserver_suspend:
-	if (PsychCopyInIntegerArg(4, kPsychArgOptional, &mysuspend)) {
-		if (mysuspend < 0 || mysuspend > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'audioserver_autosuspend' provided. Valid are 0 and 1.");
-		pulseaudio_autosuspend = (mysuspend > 0) ? TRUE : FALSE;
-		if (verbosity > 3) printf("PsychPortAudio: INFO: Automatic suspending of desktop audio servers %s.\n", (pulseaudio_autosuspend) ? "enabled" : "disabled");
-	}
+	PsychCopyInIntegerArg(2, kPsychArgRequired, &target);
+	if (target < 0 || target >= dev->automationTracks) PsychErrorExitMsg(PsychError_user, "Invalid 'target' provided. Must be 0 for masterVolume, or an output channel number on a slave device.");
 
-	// Make sure PortAudio is online: Must be done after setup of audioserver_suspend!
-	PsychPortAudioInitialize();
+	PsychCopyInDoubleArg(3, kPsychArgRequired, &when);
+	PsychCopyInDoubleArg(4, kPsychArgRequired, &value);
 
-	// Return old yieldInterval:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, yieldInterval);
+	PsychCopyInIntegerArg(5, kPsychArgOptional, &shape);
+	if (shape < 0 || shape > 2) PsychErrorExitMsg(PsychError_user, "Invalid 'shape' provided. Must be 0, 1 or 2!");
 
-	// Get optional new yieldInterval:
-	if (PsychCopyInDoubleArg(1, kPsychArgOptional, &myyieldInterval)) {
-		if (myyieldInterval < 0 || myyieldInterval > 0.1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'yieldInterval' provided. Valid are between 0.0 and 0.1 seconds.");
-		yieldInterval = myyieldInterval;
-		if (verbosity > 3) printf("PsychPortAudio: INFO: Engine yieldInterval changed to %lf seconds.\n", yieldInterval);
-	}
+	PsychCopyInIntegerArg(6, kPsychArgOptional, &timeUnit);
+	if (timeUnit < 0 || timeUnit > 2) PsychErrorExitMsg(PsychError_user, "Invalid 'timeUnit' provided. Must be 0, 1 or 2!");
 
-	// Return current/old mutexenable:
-	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) ((uselocking) ? 1 : 0));
+	// Need to lock, as the engine may be running and consuming breakpoints:
+	PsychPALockDeviceMutex(dev);
+	track = &(dev->automation[target]);
 
-	// Get optional new mutexenable:
-	if (PsychCopyInIntegerArg(2, kPsychArgOptional, &mutexenable)) {
-		if (mutexenable < 0 || mutexenable > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'MutexEnable' provided. Valid are 0 and 1.");
-		uselocking = (mutexenable > 0) ? TRUE : FALSE;
-		if (verbosity > 3) printf("PsychPortAudio: INFO: Engine Mutex locking %s.\n", (uselocking) ? "enabled" : "disabled");
+	// Check for chronological order against the last pending breakpoint of the same time unit:
+	if (track->writepos != track->readpos) {
+		last = &(track->points[(track->writepos - 1) % track->size]);
+		if ((last->unit == (unsigned int) timeUnit) && (when < last->when)) {
+			PsychPAUnlockDeviceMutex(dev);
+			PsychErrorExitMsg(PsychError_user, "Invalid 'when' provided. Breakpoints must be added in chronological order!");
+		}
 	}
 
-	// Return current/old lockToCore1:
-	PsychCopyOutDoubleArg(3, kPsychArgOptional, (double) ((lockToCore1) ? 1 : 0));
-
-	// Get optional new lockToCore1:
-	if (PsychCopyInIntegerArg(3, kPsychArgOptional, &mylockToCore1)) {
-		if (mylockToCore1 < 0 || mylockToCore1 > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'lockToCore1' provided. Valid are 0 and 1.");
-		lockToCore1 = (mylockToCore1 > 0) ? TRUE : FALSE;
-		if (verbosity > 3) printf("PsychPortAudio: INFO: Locking of all engine threads to cpu core 1 %s.\n", (lockToCore1) ? "enabled" : "disabled");
+	// Free slot available?
+	if (track->writepos - track->readpos < track->size) {
+		track->points[track->writepos % track->size].when = when;
+		track->points[track->writepos % track->size].value = (float) value;
+		track->points[track->writepos % track->size].shape = (unsigned int) shape;
+		track->points[track->writepos % track->size].unit = (unsigned int) timeUnit;
+		track->writepos++;
+		success = 1;
 	}
 
+	freeslots = track->size - (track->writepos - track->readpos);
+	PsychPAUnlockDeviceMutex(dev);
+
+	// Return optional result code:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) success);
+
+	// Return optional remaining number of free slots:
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) freeslots);
+
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('UseSchedule') - Enable & Create, or disable and destroy a playback schedule.
+/* PsychPortAudio('UseResampler') - Enable or disable realtime sample rate conversion of a device.
  */
-PsychError PSYCHPORTAUDIOUseSchedule(void) 
+PsychError PSYCHPORTAUDIOUseResampler(void)
 {
- 	static char useString[] = "PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
-	static char synopsisString[] = 
-		"Enable or disable use of a preprogrammed schedule for audio playback on audio device 'pahandle'.\n"
-		"Schedules are similar to playlists on your favorite audio player. A schedule allows to define a sequence "
-		"of distinct sounds to play in succession. When PsychPortAudio('Start') is called, processing of "
-		"the schedule begins and the first programmed sound snippet is played, followed by the 2nd, 3rd, ... "
-		"until the whole schedule has been played once and playback stops. You can add new sound snippets to the "
-		"schedule while playback is running for uninterrupted playback of long sequences of sound.\n"
-		"Each sound snippet or slot in the schedule defines a soundbuffer to play back via a 'bufferhandle', "
-		"within the buffer a subsegment (a so called playloop) defined by start- and endpoint, and a number "
-		"of repetitions for that playloop.\n"
-		"This subfunction allows to either enable use of schedules by setting the 'enableSchedule' flag to 1, "
-		"in which case a schedule with a maximum of 'maxSize' distinct slots is created ('maxSize' defaults to 128 slots), "
-		"or to disable use of schedules by setting 'enableSchedule' to 0, in which case PsychPortAudio reverts "
-		"back to its normal playback behaviour and an existing schedule is deleted.\n"
-		"A 'enableSchedule' setting of 2 will reset an existing schedule, ie. clear it of all its entries, "
-		"so it is ready to be rewritten with new entries. You should reset and rewrite a schedule each "
-		"time after playback/processing of a schedule has finished or has been stopped.\n"
-		"A 'enableSchedule' setting of 3 will reactivate an existing schedule, ie. prepare it for a replay.\n"
-		"See the subfunction 'AddToSchedule' on how to populate the schedule with actual entries.\n";
-		
-	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart AddToSchedule";
-	
+ 	static char useString[] = "PsychPortAudio('UseResampler', pahandle, quality [, sampleRate]);";
+	//                                                         1         2          3
+	static char synopsisString[] =
+		"Enable or disable realtime sample rate conversion of audio buffers on audio device 'pahandle'.\n"
+		"Normally all audio buffers are played back at the sample rate of the device, so sound data must be provided "
+		"at that rate. With the resampler enabled, buffers which have a sample rate assigned are converted on the fly "
+		"to the sample rate of the device during playback, also during playback of schedules. This way, e.g., sounds "
+		"with a sample rate of 44100 Hz can be played on a device opened at 48000 Hz or 96000 Hz without the need for an "
+		"offline conversion.\n"
+		"The sample rate of a dynamic buffer is assigned via the optional 'sampleRate' argument of PsychPortAudio('CreateBuffer'). "
+		"The sample rate of the standard playback buffer, as filled by PsychPortAudio('FillBuffer'), is assigned via the optional "
+		"'sampleRate' argument of this function. It is also set to the sample rate of a dynamic buffer if that buffer is passed "
+		"to 'FillBuffer'. Buffers without an assigned sample rate are played without conversion.\n"
+		"The device must be idle, i.e., stopped, and must not be a master device. It can be a playback slave device.\n"
+		"'quality' 0 disables the resampler. A 'quality' of 1, 2 or 3 selects a windowed-sinc interpolation filter of "
+		"16, 32 or 64 taps. Higher quality suppresses aliasing better, at a higher computational cost. A 'quality' of 2 "
+		"is a good choice for most purposes. Downsampling, i.e., playback of buffers with a higher sample rate than the "
+		"sample rate of the device, is supported up to a ratio of 8, but its cost increases with the ratio.\n"
+		"'sampleRate' Sample rate in Hz of the standard playback buffer. Zero means the sample rate of the device.\n"
+		"Playback positions, loop boundaries set via 'SetLoop' and 'AddToSchedule', and streaming refills refer to sample "
+		"frames of the buffers, not of the device. Playback in ring buffer mode via 'PushAudio' is not resampled.\n";
+
+	static char seeAlsoString[] = "CreateBuffer FillBuffer AddToSchedule SetLoop";
+
+	PsychPAResamplerBank* bank = NULL;
+	float* scratch = NULL;
+	double sampleRate = 0;
+	psych_bool rateGiven;
+	int quality;
+	int pahandle = -1;
+
+	// Setup online help:
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs
+	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
+	if (audiodevices[pahandle].opmode & kPortAudioIsMaster) PsychErrorExitMsg(PsychError_user, "Tried to enable the resampler on a master device. Forbidden! Use it on its slave devices instead.");
+
+	// Make sure the device is fully idle. See 'UseSchedule' for why we can check without mutex held:
+	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Tried to enable/disable resampler while audio device is active. Forbidden! Call 'Stop' first.");
+
+	PsychCopyInIntegerArg(2, kPsychArgRequired, &quality);
+	if (quality < 0 || quality > 3) PsychErrorExitMsg(PsychError_user, "Invalid 'quality' provided. Must be 0, 1, 2 or 3!");
+
+	rateGiven = PsychCopyInDoubleArg(3, kPsychArgOptional, &sampleRate);
+	if (rateGiven) {
+		if ((sampleRate < 0) || (sampleRate > PSYCH_PA_RESAMPLER_MAXRATIO * audiodevices[pahandle].streaminfo->sampleRate)) {
+			PsychErrorExitMsg(PsychError_user, "Invalid 'sampleRate' provided. Must be zero, or positive and at most 8 times the sample rate of the device!");
+		}
+	}
+
+	if (quality > 0) {
+		// Get cached filter bank and scratch memory for the sample window, filter weights and per-channel sums:
+		bank = PsychPAGetResamplerBank(quality);
+		if (NULL == bank) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create resampler filters!");
+
+		scratch = (float*) calloc((size_t) ((bank->taps * PSYCH_PA_RESAMPLER_MAXRATIO + 4) * (audiodevices[pahandle].outchannels + 1) + audiodevices[pahandle].outchannels), sizeof(float));
+		if (NULL == scratch) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to enable resampler!");
+	}
+
+	// Device is idle, so we can switch without locking:
+	free(audiodevices[pahandle].resampleScratch);
+	audiodevices[pahandle].resampleScratch = scratch;
+	audiodevices[pahandle].resampler = bank;
+	audiodevices[pahandle].resamplePhase = 0;
+	audiodevices[pahandle].playoutSampleRate = 0;
+	audiodevices[pahandle].playoutResampler = NULL;
+	if (rateGiven) audiodevices[pahandle].outputbufferSampleRate = sampleRate;
+
+	// Tabulate the filters for the standard playback buffer now. Schedules get recompiled for the new filters at 'Start':
+	audiodevices[pahandle].outputbufferResampler = PsychPAGetResamplerBankForRate(&audiodevices[pahandle], audiodevices[pahandle].outputbufferSampleRate);
+
+	if (verbosity > 4) printf("PsychPortAudio: Resampler of device %i %s.\n", pahandle, (quality > 0) ? "enabled" : "disabled");
+
+	return(PsychError_none);
+}
+
+static int PsychPACompareDoubles(const void* a, const void* b)
+{
+	return((*(const double*) a < *(const double*) b) ? -1 : ((*(const double*) a > *(const double*) b) ? 1 : 0));
+}
+
+/* PsychPortAudio('GetTimingStats') - Enable, disable or query callback timing telemetry of a device.
+ */
+PsychError PSYCHPORTAUDIOGetTimingStats(void)
+{
+ 	static char useString[] = "[stats, records] = PsychPortAudio('GetTimingStats', pahandle [, enable][, reset=0]);";
+	//                          1      2                                            1           2         3
+	static char synopsisString[] =
+		"Enable, disable or query callback timing telemetry of audio device 'pahandle'.\n"
+		"If telemetry is enabled, each invocation of the realtime audio processing callback of the device records its start "
+		"time, duration, number of requested sample frames, number of attached slaves, predicted output latency and PortAudio "
+		"status flags in a ring buffer of the most recent 4096 callbacks, and updates a histogram of callback durations. "
+		"The context of the most recent 32 buffer over- or underruns (xruns) is kept separately. The overhead is small enough "
+		"to keep telemetry enabled during production runs, to diagnose sporadic audio dropouts. On master devices the "
+		"duration includes the processing of all attached slaves.\n"
+		"'enable' 1 = Enable telemetry, 0 = Disable it. If omitted, the setting is left unchanged. Telemetry is disabled by "
+		"default. It can be enabled and disabled at any time, even during playback. Enabling it resets the statistics.\n"
+		"'reset' If 1, the statistics are reset after they have been returned, so the next query only returns data of "
+		"callbacks after this call.\n\n"
+		"'stats' is a struct with the following fields:\n"
+		"'Enabled' 1 if telemetry is enabled, 0 otherwise.\n"
+		"'Count' Number of callbacks recorded since the last reset.\n"
+		"'MeanDuration' and 'MaxDuration' Mean and maximum callback duration in seconds since the last reset.\n"
+		"'Histogram' Histogram of callback durations since the last reset: Element 1 counts durations below 2 microseconds, "
+		"element k counts durations of 2^(k-1) to 2^k microseconds, the last element all longer durations.\n"
+		"'HistogramEdges' Lower edges of the histogram bins in seconds.\n"
+		"The following fields are computed from the records in the ring buffer, i.e., of at most the last 4096 callbacks:\n"
+		"'Percentiles' The percentiles [50, 90, 99, 99.9] reported in the following two fields.\n"
+		"'PercentileDurations' Callback durations in seconds at these percentiles.\n"
+		"'PercentileLoads' Callback durations at these percentiles, relative to the duration of the sound processed by "
+		"each callback. Values close to 1 mean a risk of dropouts.\n"
+		"'MinInterval' and 'MaxInterval' Minimum and maximum time in seconds between the start of two successive callbacks.\n"
+		"'XRuns' Struct array with the context of the most recent xruns, oldest first. The fields 'Time', 'Duration', "
+		"'Frames', 'Slaves', 'PredictedLatency' and 'Flags' describe the callback which reported the xrun. 'Slaves' is the "
+		"number of active slave devices a master device executed in that callback, not counting inactive ones. 'Flags' are the "
+		"PortAudio status flags: 1 = Input underflow, 2 = Input overflow, 4 = Output underflow, 8 = Output overflow. "
+		"'PreviousTime' and 'PreviousDuration' describe the preceding callback, or are zero if it is unknown.\n\n"
+		"'records' optional: A 6-by-n matrix with the n records in the ring buffer, oldest first. Each column describes one "
+		"callback, with rows: Start time, duration, frames, executed slaves, predicted latency, status flags.\n";
+
+	static char seeAlsoString[] = "GetStatus Open";
+
+	const char *FieldNames[] = { "Enabled", "Count", "MeanDuration", "MaxDuration", "Histogram", "HistogramEdges", "Percentiles",
+								 "PercentileDurations", "PercentileLoads", "MinInterval", "MaxInterval", "XRuns" };
+	const char *XRunFieldNames[] = { "Time", "Duration", "Frames", "Slaves", "PredictedLatency", "Flags", "PreviousTime", "PreviousDuration" };
+	const double percentiles[4] = { 50.0, 90.0, 99.0, 99.9 };
+	PsychGenericScriptType *stats, *xrunstats, *vec;
+	PsychPATimingStats* timing;
+	PsychPATimingRecord* records = NULL;
+	PsychPAXRunRecord xruns[PSYCH_PA_TIMING_XRUNS];
+	double *durations = NULL, *loads = NULL, *v, *out;
+	double minInterval = 0, maxInterval = 0, interval;
+	unsigned int start, end, skip, n, xstart, xend, nx, count = 0;
+	unsigned int i;
 	int pahandle = -1;
-	int enableSchedule;
-	int maxSize = 128;
-	int j;
-	
-	// Setup online help: 
+	int enable = -1;
+	int reset = 0;
+
+	// Setup online help:
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
-	
+
 	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs
+	PsychErrorExit(PsychCapNumOutputArgs(2));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
@@ -5197,294 +8238,299 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	// Make sure the device is fully idle: We can check without mutex held, as a device which is
-	// already idle (state == 0) can't switch by itself out of idle state (state > 0), neither
-	// can an inactive stream start itself.
-	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Tried to enable/disable audio schedule while audio device is active. Forbidden! Call 'Stop' first.");
-
-	// At this point the deivce is idle and will remain so during this routines execution,
-	// so it won't touch any of the schedule related variables and we can manipulate them
-	// without a need to lock the device:
-
-	// Get required enable flag:
-	PsychCopyInIntegerArg(2, kPsychArgRequired, &enableSchedule);
-	if (enableSchedule < 0 || enableSchedule > 3)  PsychErrorExitMsg(PsychError_user, "Invalid 'enableSchedule' provided. Must be 0, 1, 2 or 3!");
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &enable);
+	if (enable < -1 || enable > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'enable' flag provided. Must be 0 or 1!");
 
-	// Get the optional maxSize parameter:
-	PsychCopyInIntegerArg(3, kPsychArgOptional, &maxSize);
-	if (maxSize < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'maxSize' provided. Must be greater than zero!");
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &reset);
+	if (reset < 0 || reset > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'reset' flag provided. Must be 0 or 1!");
 
-	// Revival of existing schedule requested?
-	if (enableSchedule == 3) {
-		if (NULL == audiodevices[pahandle].schedule) {
-			PsychErrorExitMsg(PsychError_user, "'enableSchedule' == 3 requested to revive current schedule, but no such schedule exists! You must create it first.");
+	if ((enable == 1) && !audiodevices[pahandle].timingEnabled) {
+		// Telemetry memory is allocated on first enable and only released when the device is closed,
+		// so paCallback can't access it after release:
+		if (NULL == audiodevices[pahandle].timing) {
+			timing = (PsychPATimingStats*) calloc(1, sizeof(PsychPATimingStats));
+			if (NULL == timing) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to enable timing telemetry!");
+			PsychPAMemoryBarrier();
+			audiodevices[pahandle].timing = timing;
 		}
-
-		// Reset current position in schedule to start:
-		audiodevices[pahandle].schedule_pos = 0;
-		
-		for (j = 0; j < audiodevices[pahandle].schedule_size; j++) {
-			// Slot occupied?
-			if (audiodevices[pahandle].schedule[j].mode & 1) {
-				// Reactivate this slot to pending:
-				audiodevices[pahandle].schedule[j].mode |= 2;
-			}
+		else {
+			// Callbacks don't touch the statistics while disabled, so we can reset them here:
+			PsychPAResetTimingStats(audiodevices[pahandle].timing);
 		}
-		
-		// Done.
-		return(PsychError_none);
+
+		PsychPAMemoryBarrier();
+		audiodevices[pahandle].timingEnabled = 1;
 	}
 
+	if (enable == 0) audiodevices[pahandle].timingEnabled = 0;
 
-	// Reset of existing schedule requested?
-	if ((enableSchedule == 2) && (audiodevices[pahandle].schedule)) {
-		// Yes: Simply set requested size to current size, this will trigger
-		// a memset() to zero below, instead of a realloc or alloc, which is
-		// exactly what we want:
-		maxSize = audiodevices[pahandle].schedule_size;
-	}
+	timing = audiodevices[pahandle].timing;
+	if (timing) {
+		// Copy records from ring. This races with paCallback, so drop all records which
+		// may have been overwritten while we copied them:
+		end = timing->writepos;
+		PsychPAMemoryBarrier();
+		start = (end - timing->firstpos > PSYCH_PA_TIMING_RECORDS) ? end - PSYCH_PA_TIMING_RECORDS : timing->firstpos;
+		n = end - start;
+		records = (PsychPATimingRecord*) PsychMallocTemp(((size_t) n + 1) * sizeof(PsychPATimingRecord));
+		for (i = 0; i < n; i++) records[i] = timing->records[(start + i) & (PSYCH_PA_TIMING_RECORDS - 1)];
 
-	// Release an already existing schedule: This will take care of both,
-	// disabling use of schedules if this is a disable call, and resetting
-	// of an existing schedule if this is an enable call following another
-	// enable call:
-	if (audiodevices[pahandle].schedule) {
-		// Schedule already exists: Is this by any chance an enable call and
-		// the requested size of the new schedule matches the size of the current
-		// one?
-		if (enableSchedule && (audiodevices[pahandle].schedule_size == maxSize)) {
-			// Yes! Have a schedule of exactly wanted size, no need to free and
-			// realloc - We simply clear it out by zero filling:
-			memset((void*) audiodevices[pahandle].schedule, 0, (size_t) (maxSize * sizeof(PsychPASchedule)));
+		xend = timing->xrunpos;
+		PsychPAMemoryBarrier();
+		xstart = (xend - timing->firstxrun > PSYCH_PA_TIMING_XRUNS) ? xend - PSYCH_PA_TIMING_XRUNS : timing->firstxrun;
+		nx = xend - xstart;
+		for (i = 0; i < nx; i++) xruns[i] = timing->xruns[(xstart + i) % PSYCH_PA_TIMING_XRUNS];
+
+		PsychPAMemoryBarrier();
+		skip = timing->writepos - start;
+		skip = (skip > PSYCH_PA_TIMING_RECORDS) ? skip - PSYCH_PA_TIMING_RECORDS : 0;
+		if (skip > n) skip = n;
+		records += skip;
+		n -= skip;
+
+		skip = timing->xrunpos - xstart;
+		skip = (skip > PSYCH_PA_TIMING_XRUNS) ? skip - PSYCH_PA_TIMING_XRUNS : 0;
+		if (skip > nx) skip = nx;
+		memmove(&xruns[0], &xruns[skip], (nx - skip) * sizeof(PsychPAXRunRecord));
+		nx -= skip;
+
+		count = timing->writepos - timing->firstpos;
+	}
+	else {
+		n = nx = 0;
+	}
+
+	PsychAllocOutStructArray(1, kPsychArgOptional, 1, 12, FieldNames, &stats);
+	PsychSetStructArrayDoubleElement("Enabled", 0, (double) audiodevices[pahandle].timingEnabled, stats);
+	PsychSetStructArrayDoubleElement("Count", 0, (double) count, stats);
+	PsychSetStructArrayDoubleElement("MeanDuration", 0, (timing && count) ? timing->totalDuration / count : 0.0, stats);
+	PsychSetStructArrayDoubleElement("MaxDuration", 0, (timing) ? (double) timing->maxDuration : 0.0, stats);
+
+	PsychAllocateNativeDoubleMat(1, PSYCH_PA_TIMING_BINS, 1, &v, &vec);
+	for (i = 0; i < PSYCH_PA_TIMING_BINS; i++) v[i] = (timing) ? (double) timing->histogram[i] : 0.0;
+	PsychSetStructArrayNativeElement("Histogram", 0, vec, stats);
+
+	PsychAllocateNativeDoubleMat(1, PSYCH_PA_TIMING_BINS, 1, &v, &vec);
+	for (i = 0; i < PSYCH_PA_TIMING_BINS; i++) v[i] = (i > 0) ? (double) (1 << i) * 1e-6 : 0.0;
+	PsychSetStructArrayNativeElement("HistogramEdges", 0, vec, stats);
+
+	PsychAllocateNativeDoubleMat(1, 4, 1, &v, &vec);
+	for (i = 0; i < 4; i++) v[i] = percentiles[i];
+	PsychSetStructArrayNativeElement("Percentiles", 0, vec, stats);
+
+	// Percentiles of durations and relative load, and callback intervals from the records:
+	if (n > 0) {
+		durations = (double*) PsychMallocTemp((size_t) n * sizeof(double));
+		loads = (double*) PsychMallocTemp((size_t) n * sizeof(double));
+		for (i = 0; i < n; i++) {
+			durations[i] = records[i].duration;
+			loads[i] = (records[i].frames > 0) ? records[i].duration * audiodevices[pahandle].streaminfo->sampleRate / records[i].frames : 0.0;
+			if (i > 0) {
+				interval = records[i].tStart - records[i - 1].tStart;
+				if ((i == 1) || (interval < minInterval)) minInterval = interval;
+				if ((i == 1) || (interval > maxInterval)) maxInterval = interval;
+			}
 		}
-		else {
-			// No. Release old schedule...
-			free(audiodevices[pahandle].schedule);
-			audiodevices[pahandle].schedule = NULL;
-			audiodevices[pahandle].schedule_size = 0;
+
+		qsort(durations, n, sizeof(double), PsychPACompareDoubles);
+		qsort(loads, n, sizeof(double), PsychPACompareDoubles);
+	}
+
+	PsychAllocateNativeDoubleMat(1, 4, 1, &v, &vec);
+	for (i = 0; i < 4; i++) v[i] = (n > 0) ? durations[(unsigned int) (percentiles[i] / 100.0 * (n - 1) + 0.5)] : 0.0;
+	PsychSetStructArrayNativeElement("PercentileDurations", 0, vec, stats);
+
+	PsychAllocateNativeDoubleMat(1, 4, 1, &v, &vec);
+	for (i = 0; i < 4; i++) v[i] = (n > 0) ? loads[(unsigned int) (percentiles[i] / 100.0 * (n - 1) + 0.5)] : 0.0;
+	PsychSetStructArrayNativeElement("PercentileLoads", 0, vec, stats);
+
+	PsychSetStructArrayDoubleElement("MinInterval", 0, minInterval, stats);
+	PsychSetStructArrayDoubleElement("MaxInterval", 0, maxInterval, stats);
+
+	PsychAllocOutStructArray(-1, FALSE, nx, 8, XRunFieldNames, &xrunstats);
+	for (i = 0; i < nx; i++) {
+		PsychSetStructArrayDoubleElement("Time", i, xruns[i].xrun.tStart, xrunstats);
+		PsychSetStructArrayDoubleElement("Duration", i, xruns[i].xrun.duration, xrunstats);
+		PsychSetStructArrayDoubleElement("Frames", i, xruns[i].xrun.frames, xrunstats);
+		PsychSetStructArrayDoubleElement("Slaves", i, xruns[i].xrun.slaves, xrunstats);
+		PsychSetStructArrayDoubleElement("PredictedLatency", i, xruns[i].xrun.predictedLatency, xrunstats);
+		PsychSetStructArrayDoubleElement("Flags", i, xruns[i].xrun.flags, xrunstats);
+		PsychSetStructArrayDoubleElement("PreviousTime", i, xruns[i].previous.tStart, xrunstats);
+		PsychSetStructArrayDoubleElement("PreviousDuration", i, xruns[i].previous.duration, xrunstats);
+	}
+	PsychSetStructArrayStructElement("XRuns", 0, xrunstats, stats);
+
+	// Return raw records, if requested:
+	if (PsychAllocOutDoubleMatArg(2, kPsychArgOptional, 6, (int) n, 1, &out)) {
+		for (i = 0; i < n; i++) {
+			*(out++) = records[i].tStart;
+			*(out++) = records[i].duration;
+			*(out++) = records[i].frames;
+			*(out++) = records[i].slaves;
+			*(out++) = records[i].predictedLatency;
+			*(out++) = records[i].flags;
 		}
 	}
 
-	// Reset current position in schedule to start and size to zero in any case:
-	audiodevices[pahandle].schedule_pos = 0;
-	audiodevices[pahandle].schedule_writepos = 0;
-	
-	// Enable/Reset request?
-	if (enableSchedule && (NULL == audiodevices[pahandle].schedule)) {
-		// Enable request - Allocate proper schedule:
-		audiodevices[pahandle].schedule_size = 0;
-		audiodevices[pahandle].schedule = (PsychPASchedule*) calloc(maxSize, sizeof(PsychPASchedule));
-		if (audiodevices[pahandle].schedule == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create a schedule!");
-
-		// Assign new size:
-		audiodevices[pahandle].schedule_size = maxSize;
+	// Reset statistics after query? If no callbacks are running we do it ourselves, otherwise paCallback does it:
+	if (reset && timing) {
+		if (audiodevices[pahandle].timingEnabled && Pa_IsStreamActive(audiodevices[pahandle].stream)) timing->resetRequest = 1;
+		else PsychPAResetTimingStats(timing);
 	}
 
-	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('AddToSchedule') - Add command slots to a playback schedule.
+/* PsychPortAudio('CaptureToFile') - Stream captured sound data to a sound file in the background.
  */
-PsychError PSYCHPORTAUDIOAddToSchedule(void) 
+PsychError PSYCHPORTAUDIOCaptureToFile(void)
 {
- 	static char useString[] = "[success, freeslots] = PsychPortAudio('AddToSchedule', pahandle [, bufferHandle=0][, repetitions=1][, startSample=0][, endSample=max][, UnitIsSeconds=0][, specialFlags=0]);";
-	//																				  1           2                 3                4                5                6				  7
-	static char synopsisString[] = 
-		"Add a new item to an existing schedule for audio playback on audio device 'pahandle'.\n"
-		"The schedule must have been created and enabled already via a previous call to 'UseSchedule'. "
-		"The function returns if the addition of a new item was successfull via the return argument "
-		"'success' (1=Success, 0=Failed), and the number of remaining free slots in 'freeslots'. "
-		"Failure to add an item can happen if the schedule is full. If playback is running, you can "
-		"simply retry after some time, because eventually the playback will consume and thereby free "
-		"at least one slot in the schedule. If playback is stopped and you get this failure, you should "
-		"reallocate the schedule with a bigger size via a proper call to 'UseSchedule'.\n"
-		"Please note that after playback/processing of a schedule has finished by itself, or due to "
-		"'Stop'ping the playback via the stop function, you should clear or reactivate the schedule and rewrite "
-		"it, otherwise results at next call to 'Start' may be undefined. You can clear/reactivate a schedule "
-		"efficiently without resizing it by calling 'UseSchedule' with an enableFlag of 2 or 3.\n\n"
-		"The following optional paramters can be used to define the new slot in the schedule:\n"
-		"'bufferHandle' Handle of the audio buffer which should be used for playback of this slot. "
-		"The default value zero will play back the standard audio buffer created by a call to 'FillBuffer'.\n"
-		"'repetitions' How often should playback of this slot be repeated. Fractional positive values are "
-		"allowed, the value zero (ie. infinite repetition) is not allowed in this driver release.\n"
-		"'startSample' and 'endSample' define a playback loop - a subsegment of the audio buffer to which "
-		"playback should be restricted, and 'UnitIsSeconds' tells if the given loop boundaries are expressed "
-		"in audio sample frames, or in seconds realtime. See the help for the 'SetLoop' function for more "
-		"explanation.\n\n"
-		"'specialFlags' is an optional parameter to pass in some special mode flags to alter processing "
-		"of a slot: Defaults to zero. If the value '1' is used (or added), then a slot is not automatically "
-		"disabled after it has been used up, but it will be reused on repeated execution of the schedule. "
-		"You'll need to set this flag on all slots in a schedule if you want the schedule to auto-repeat "
-		"without the need for manual reset commands."
-		"\n\n"
-		"This function can also be used to sneak special command slots into the schedule:\n"
-		"If you specify a negative number for the 'bufferHandle' argument, then this actually "
-		"defines a command slot instead of a regular playback slot, and the number is a command code "
-		"that defines the action to take. For timing related actions, the 'repetitions' parameter is "
-		"abused as a 'tWhen' time specification in seconds.\n"
-		"Following command codes are currently defined: (Add numbers to combine options)\n"
-		"1   = Pause audio playback (and capture) immediately, resume it at a given 'tWhen' target time.\n"
-		"2   = (Re-)schedule the end of playback for given 'tWhen' target time.\n"
-		"You must specify the type of 'tWhen' if you specify 1 or 2 as commandCode:"
-		"+4  = 'tWhen' is an absolute GetSecs() style system time.\n"
-		"+8  = 'tWhen' is a time delta to the last requested start time of playback.\n"
-		"+16 = 'tWhen' is a time delta to the last actual start time of playback.\n"
-		"+32 = 'tWhen' is a time delta to the last requested end time of playback. Broken & Defective!!\n"
-		"+64 = 'tWhen' is a time delta to the last actual end time of playback. Broken & Defective!!\n"
-		"\n"
-		"E.g., you want to (re)start playback at a certain time, then you'd set 'bufferHandle' to -5, because "
-		"command code would be 1 + 4 == 5, so negated it is -5. Then you'd specify the requested time in the "
-		"'repetitions' parameter as an absolute time in seconds.\n\n";
-
-	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart UseSchedule";
-	
-	PsychPASchedule* slot;
-	PsychPABuffer* buffer;
-	int	slotid;
-	double startSample, endSample, sMultiplier;
-	psych_int64 maxSample;
-	int unitIsSecs;
+	static char useString[] = "[framesWritten, overflows, lostFrames] = PsychPortAudio('CaptureToFile', pahandle [, filename][, format=0][, chunkSecs=0.5]);";
+	//																											 1           2           3			  4
+	static char synopsisString[] =
+		"Stream captured sound data of audio device 'pahandle' to a sound file in the background.\n"
+		"If a 'filename' is given, a background writer thread is started, which continuously drains the internal capture "
+		"buffer of the device into the file 'filename' with large writes. This allows recordings of arbitrary length "
+		"with bounded memory consumption, and without any need to fetch the captured data via 'GetAudioData'. "
+		"The device must be opened for audio capture. If no sufficiently big capture buffer has been allocated "
+		"via 'GetAudioData', a buffer of 10 seconds is allocated. The writer keeps running across 'Stop' and 'Start' "
+		"of the device, appending newly captured sound to the file, until it gets stopped. While the writer is active, "
+		"'GetAudioData' can not be used on the device.\n"
+		"'format' selects the file format: 0 = WAV file with 32 bit floating point samples. Files exceeding 4 GB are "
+		"automatically written as RF64 files. 1 = Raw file without header, with interleaved 32 bit floating point "
+		"samples in native byte order.\n"
+		"'chunkSecs' is the amount of sound data in seconds to accumulate before each write to the file. Defaults to "
+		"0.5 seconds. The capture buffer should be a multiple of 'chunkSecs', so it can absorb stalls of file i/o.\n"
+		"If 'filename' is omitted or empty, the writer is stopped after it wrote out all pending sound data, and the "
+		"file is finalized and closed.\n"
+		"Returns the number of sample frames written to the file in 'framesWritten', the number of times the capture "
+		"buffer overflowed, because the writer couldn't keep up, in 'overflows', and the total number of sample frames "
+		"lost due to such overflows in 'lostFrames'. These statistics are also reported by 'GetStatus'.\n";
+	static char seeAlsoString[] = "GetAudioData GetStatus Open";
+
+	PsychPACaptureWriter* writer;
+	unsigned char header[PSYCH_PA_CAPTUREFILE_HEADERSIZE];
+	char* filename = NULL;
 	int pahandle = -1;
-	int bufferHandle = 0;
-	unsigned int commandCode = 0;
-	int specialFlags = 0;
-	double repetitions = 1;
-	int success = 0;
-	int freeslots = 0;
-	
-	// Setup online help: 
+	int format = 0;
+	int rc;
+	double chunkSecs = 0.5;
+	psych_int64 chunkFrames, insbsize;
+
+	// Setup online help:
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
-	
-	PsychErrorExit(PsychCapNumInputArgs(7));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(2));	 // The maximum number of outputs
+
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs
+	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	if ((audiodevices[pahandle].opmode & kPortAudioCapture) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio capture, so this call doesn't make sense.");
 
-	// Make sure there is a schedule available:
-	if (audiodevices[pahandle].schedule == NULL) PsychErrorExitMsg(PsychError_user, "You tried to AddToSchedule, but use of schedules is disabled! Call 'UseSchedule' first to enable them.");
-
-	// Get optional bufferhandle:
-	PsychCopyInIntegerArg(2, kPsychArgOptional, &bufferHandle);
-
-	// if (bufferHandle < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'bufferHandle' provided. Must be greater or equal to zero, and a handle to an existing buffer!");
-	if (bufferHandle < 0) {
-		// This isn't a bufferHandle but a command code, ergo this ain't a
-		// audio playout buffer, but a command buffer:
-		commandCode = -bufferHandle;
-		bufferHandle = 0;
-
-		// Child protection: Must give a timespec type specifier if some time related action is requested:
-		if ((commandCode & (1 | 2)) && !(commandCode & (4 | 8 | 16 | 32 | 64))) PsychErrorExitMsg(PsychError_user, "Invalid commandCode provided: You requested scheduled (re)start or end of operation, but didn't provide any of the required timespec-type specifiers!");
-	}
+	PsychAllocInCharArg(2, kPsychArgOptional, &filename);
 
-	// If it is a non-zero handle, try to dereference from dynamic buffer:
-	if (bufferHandle > 0) {
-		// Deref bufferHandle: Issue error if no buffer with such a handle exists:
-		buffer = PsychPAGetAudioBuffer(bufferHandle);
-		
-		// Validate matching output channel count:
-		if (buffer->outchannels != audiodevices[pahandle].outchannels) {
-			printf("PsychPortAudio-ERROR: Audio channel count %i of audiobuffer with handle %i doesn't match channel count %i of audio device!\n", buffer->outchannels, bufferHandle, audiodevices[pahandle].outchannels);
-			PsychErrorExitMsg(PsychError_user, "Referenced audio buffer 'bufferHandle' has an audio channel count that doesn't match channels of audio device!");
+	if ((NULL == filename) || (strlen(filename) == 0)) {
+		// Stop request: Finalize file, if any:
+		if ((rc = PsychPAStopCaptureWriter(&audiodevices[pahandle])) != 0) {
+			printf("PsychPortAudio-ERROR: Writing captured sound data to file failed [%s]. The file is incomplete.\n", strerror(rc));
+			PsychErrorExitMsg(PsychError_system, "Writing captured sound data to file failed.");
 		}
 	}
+	else {
+		if (audiodevices[pahandle].captureWriter) PsychErrorExitMsg(PsychError_user, "Captured sound is already written to a file! Stop that first.");
 
-	// Get optional repetitions. We abuse it also for the tWhen parameter if this
-	// is a commandbuffer instead of an audio buffer:
-	PsychCopyInDoubleArg(3, kPsychArgOptional, &repetitions);
-	if ((repetitions < 0) && (commandCode == 0)) PsychErrorExitMsg(PsychError_user, "Invalid 'repetitions' provided. Must be a positive or zero number!");
+		PsychCopyInIntegerArg(3, kPsychArgOptional, &format);
+		if (format < 0 || format > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'format' provided. Must be 0 for WAV or 1 for raw float!");
 
-	// Get loop parameters, if any:
-	unitIsSecs = 0;
-	PsychCopyInIntegerArg(6, kPsychArgOptional, &unitIsSecs);
-	sMultiplier = (unitIsSecs > 0) ? (double) audiodevices[pahandle].streaminfo->sampleRate : 1.0;
+		PsychCopyInDoubleArg(4, kPsychArgOptional, &chunkSecs);
+		if (chunkSecs <= 0) PsychErrorExitMsg(PsychError_user, "Invalid 'chunkSecs' provided. Must be greater than zero!");
 
-	// Set maxSample to maximum integer: The scheduler (aka PsychPAProcessSchedule()) will test at runtime if the playloop extends
-	// beyond valid playbuffer boundaries and clamp to end-of-buffer if needed, so this is safe:
-	// Ok, not quite the maximum 64 bit signed integer, but 2^32 counts less. Why? Because we assign
-	// maxSample to a double variable below, then that back to a int64. Due to limited precision of
-	// the double data type, roundoff errors would cause a INT64_MAX to overflow the representable
-	// max value of 2^63 for psych_int64, thereby causing storage of wrapped around negative value,
-	// and the whole logic would blow up! Keep some (overly large) security margin to prevent this.
-	// Oh, and we need to divide by max number of device channels, as otherwise some multiplication
-	// in the audio schedule processing may overflow and wreak havoc:
-	maxSample = ((INT64_MAX - (psych_int64) INT32_MAX)) / ((psych_int64) MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE);
+		// Chunks are a multiple of 1024 sample frames, so each chunk is a multiple of 4096 bytes:
+		chunkFrames = (psych_int64) ceil(chunkSecs * audiodevices[pahandle].streaminfo->sampleRate / 1024.0) * 1024;
 
-	// Copy in optional startSample:
-	startSample = 0;
-	PsychCopyInDoubleArg(4, kPsychArgOptional, &startSample);
-	if (startSample < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startSample' provided. Must be greater or equal to zero!");
-	startSample *= sMultiplier;
-	
-	// Copy in optional endSample:
-	if (PsychCopyInDoubleArg(5, kPsychArgOptional, &endSample)) {
-		endSample *= sMultiplier;
-		if (endSample > maxSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be no greater than total buffersize!");
-	}
-	else {
-		endSample = maxSample;
-	}
+		// Need a capture buffer which can hold multiple chunks:
+		insbsize = audiodevices[pahandle].inputbuffersize / sizeof(float);
+		if (insbsize < 4 * chunkFrames * audiodevices[pahandle].inchannels) {
+			// Only safe to reallocate while the engine is idle and no captured data is pending:
+			if (audiodevices[pahandle].state > 0) PsychErrorExitMsg(PsychError_user, "Capture buffer too small for given 'chunkSecs', and can't be resized while the engine is running! Use 'GetAudioData' to allocate a bigger one.");
+			if (audiodevices[pahandle].readposition < audiodevices[pahandle].recposition) PsychErrorExitMsg(PsychError_user, "Capture buffer too small for given 'chunkSecs', and can't be resized, as it isn't empty! You must drain it first.");
 
-	if (endSample < startSample) PsychErrorExitMsg(PsychError_user, "Invalid 'endSample' provided. Must be greater or equal than 'startSample'!");
-	
-	// Copy in optional specialFlags:
-	PsychCopyInIntegerArg(7, kPsychArgOptional, &specialFlags);
-	
-	// All settings validated and ready to initialize a slot in the schedule:
+			insbsize = (psych_int64) (10.0 * audiodevices[pahandle].streaminfo->sampleRate);
+			if (insbsize < 4 * chunkFrames) insbsize = 4 * chunkFrames;
+			insbsize *= audiodevices[pahandle].inchannels;
 
-	// Lock device:
-	PsychPALockDeviceMutex(&audiodevices[pahandle]);
+			free(audiodevices[pahandle].inputbuffer);
+			audiodevices[pahandle].inputbuffersize = 0;
+			audiodevices[pahandle].inputbuffer = (float*) calloc(1, (size_t) insbsize * sizeof(float));
+			if (audiodevices[pahandle].inputbuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Free system memory exhausted when trying to allocate audio recording buffer!");
+			audiodevices[pahandle].inputbuffersize = insbsize * sizeof(float);
+			audiodevices[pahandle].recposition = 0;
+			audiodevices[pahandle].readposition = 0;
+		}
 
-	// Map writepos to slotindex:
-	slotid = audiodevices[pahandle].schedule_writepos % audiodevices[pahandle].schedule_size;
-	
-	// Enough unoccupied space in schedule? Ie., is this slot free (either never used, or already consumed and ready for recycling)?
-	if ((audiodevices[pahandle].schedule[slotid].mode & 2) == 0) {
-		// Fill slot:
-		slot = (PsychPASchedule*) &(audiodevices[pahandle].schedule[slotid]);
-		slot->mode = 1 | 2 | ((specialFlags & 1) ? 4 : 0);
-		slot->bufferhandle   = bufferHandle;
-		slot->repetitions    = (commandCode == 0) ? ((repetitions == 0) ? -1 : repetitions) : 0.0;;
-		slot->loopStartFrame = startSample;
-		slot->loopEndFrame   = endSample;
-		slot->command		 = commandCode;
-		slot->tWhen			 = (commandCode > 0) ? repetitions : 0.0;
-
-		// Advance write position for next update iteration:
-		audiodevices[pahandle].schedule_writepos++;
-		
-		// Recompute number of free slots:
-		if (audiodevices[pahandle].schedule_size >= (audiodevices[pahandle].schedule_writepos - audiodevices[pahandle].schedule_pos)) {
-			freeslots = audiodevices[pahandle].schedule_size - (audiodevices[pahandle].schedule_writepos - audiodevices[pahandle].schedule_pos);
+		writer = (PsychPACaptureWriter*) calloc(1, sizeof(PsychPACaptureWriter));
+		if (NULL == writer) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to start capture to file!");
+
+		writer->format = format;
+		writer->chunkSamples = chunkFrames * audiodevices[pahandle].inchannels;
+		writer->pollSecs = 0.5 * (double) chunkFrames / audiodevices[pahandle].streaminfo->sampleRate;
+		writer->stageBuffer = (float*) malloc((size_t) writer->chunkSamples * sizeof(float));
+		if (NULL == writer->stageBuffer) {
+			free(writer);
+			PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to start capture to file!");
 		}
-		else {
-			freeslots = 0;
+
+		// Unbuffered file, as all writes are big anyway:
+		if (NULL == (writer->file = fopen(filename, "wb"))) {
+			free(writer->stageBuffer);
+			free(writer);
+			printf("PsychPortAudio-ERROR: Could not create capture file '%s' [%s].\n", filename, strerror(errno));
+			PsychErrorExitMsg(PsychError_user, "Could not create file for captured sound data.");
+		}
+		setvbuf(writer->file, NULL, _IONBF, 0);
+
+		// WAV files get a preliminary header with zero sizes, finalized when the writer stops:
+		if (format == 0) {
+			PsychPABuildCaptureFileHeader(header, (int) audiodevices[pahandle].inchannels, audiodevices[pahandle].streaminfo->sampleRate, 0);
+			if (fwrite(header, 1, sizeof(header), writer->file) != sizeof(header)) {
+				fclose(writer->file);
+				free(writer->stageBuffer);
+				free(writer);
+				PsychErrorExitMsg(PsychError_system, "Could not write header of file for captured sound data.");
+			}
 		}
-		
-		success = 1;
-	}
-	else {
-		// Nope. No free slot:
-		success = 0;
-		freeslots = 0;
-	}
 
-	// Unlock device:
-	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		// Reset statistics and start writer thread:
+		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+		audiodevices[pahandle].captureFileFrames = 0;
+		audiodevices[pahandle].captureFileOverflows = 0;
+		audiodevices[pahandle].captureFileLostFrames = 0;
+		audiodevices[pahandle].captureWriter = writer;
+		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 
-	// Return optional result code:
-	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) success);
+		if (uselocking) PsychInitCondition(&(writer->signal), NULL);
+		if ((rc = PsychCreateThread(&(writer->thread), NULL, PsychPACaptureWriterMain, (void*) &audiodevices[pahandle])) != 0) {
+			if (uselocking) PsychDestroyCondition(&(writer->signal));
+			audiodevices[pahandle].captureWriter = NULL;
+			fclose(writer->file);
+			free(writer->stageBuffer);
+			free(writer);
+			printf("PsychPortAudio-ERROR: Failed to create capture file writer thread [%i].\n", rc);
+			PsychErrorExitMsg(PsychError_system, "Failed to create capture file writer thread.");
+		}
+
+		if (verbosity > 3) printf("PsychPortAudio: Writing captured sound of device %i to file '%s' in chunks of %i sample frames.\n", pahandle, filename, (int) chunkFrames);
+	}
+
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) audiodevices[pahandle].captureFileFrames);
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) audiodevices[pahandle].captureFileOverflows);
+	PsychCopyOutDoubleArg(3, kPsychArgOptional, (double) audiodevices[pahandle].captureFileLostFrames);
 
-	// Return optional remaining number of free slots:
-	PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) freeslots);
-	
 	return(PsychError_none);
 }
 
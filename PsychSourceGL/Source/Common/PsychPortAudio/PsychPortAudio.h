@@ -91,5 +91,19 @@ PsychError PSYCHPORTAUDIOSetOpMode(void);
 PsychError PSYCHPORTAUDIODirectInputMonitoring(void);
 // Set per-device volume:
 PsychError PSYCHPORTAUDIOVolume(void);
+// Alloc/Dealloc Enable/Disable lock-free playback ring buffer:
+PsychError PSYCHPORTAUDIOUseRingBuffer(void);
+// Push sound data into playback ring buffer:
+PsychError PSYCHPORTAUDIOPushAudio(void);
+// Alloc/Dealloc Enable/Disable parameter automation:
+PsychError PSYCHPORTAUDIOUseAutomation(void);
+// Add breakpoint to parameter automation track:
+PsychError PSYCHPORTAUDIOAddToAutomation(void);
+// Enable/Disable realtime sample rate conversion:
+PsychError PSYCHPORTAUDIOUseResampler(void);
+// Enable/Disable and query callback timing telemetry:
+PsychError PSYCHPORTAUDIOGetTimingStats(void);
+// Stream captured sound data to a file:
+PsychError PSYCHPORTAUDIOCaptureToFile(void);
 //end include once
 #endif
@@ -66,6 +66,13 @@ PsychError PsychModuleInit(void)
 	PsychErrorExit(PsychRegister("SetOpMode", &PSYCHPORTAUDIOSetOpMode));
 	PsychErrorExit(PsychRegister("DirectInputMonitoring", &PSYCHPORTAUDIODirectInputMonitoring));
 	PsychErrorExit(PsychRegister("Volume", &PSYCHPORTAUDIOVolume));
+	PsychErrorExit(PsychRegister("UseRingBuffer", &PSYCHPORTAUDIOUseRingBuffer));
+	PsychErrorExit(PsychRegister("PushAudio", &PSYCHPORTAUDIOPushAudio));
+	PsychErrorExit(PsychRegister("UseAutomation", &PSYCHPORTAUDIOUseAutomation));
+	PsychErrorExit(PsychRegister("AddToAutomation", &PSYCHPORTAUDIOAddToAutomation));
+	PsychErrorExit(PsychRegister("UseResampler", &PSYCHPORTAUDIOUseResampler));
+	PsychErrorExit(PsychRegister("GetTimingStats", &PSYCHPORTAUDIOGetTimingStats));
+	PsychErrorExit(PsychRegister("CaptureToFile", &PSYCHPORTAUDIOCaptureToFile));
 
 	// Setup synopsis help strings:
 	InitializeSynopsis();   //Scripting glue won't require this if the function takes no arguments.
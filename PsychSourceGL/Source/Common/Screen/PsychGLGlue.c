@@ -522,3 +522,222 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
 		
 	return;
 }
+
+/* PsychStreamVertexData()
+ *
+ * Helper routine for the batch drawing functions of Screen(): Uploads 'size' bytes of float vertex
+ * attributes in 'data' into the streaming vertex buffer object of the onscreen window, if VBO's are
+ * supported. Respecifying the whole buffer on each call allows the driver to orphan the old storage
+ * instead of waiting for pending draws from it.
+ *
+ * Returns the base pointer for setting up vertex array pointers: NULL, i.e., offsets into the bound
+ * VBO, or 'data' itself if VBO's are unsupported. Call PsychReleaseStreamVertexData() after setup of
+ * all array pointers into the data, before setting up pointers to other client memory.
+ */
+GLfloat* PsychStreamVertexData(PsychWindowRecordType *windowRecord, GLfloat *data, size_t size)
+{
+	PsychWindowRecordType	*parentRecord = PsychGetParentWindow(windowRecord);
+
+	if ((parentRecord->streamVBO == 0) && glewIsSupported("GL_ARB_vertex_buffer_object")) glGenBuffersARB(1, &(parentRecord->streamVBO));
+	if (parentRecord->streamVBO == 0) return(data);
+
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, parentRecord->streamVBO);
+	glBufferDataARB(GL_ARRAY_BUFFER_ARB, size, data, GL_STREAM_DRAW_ARB);
+
+	return(NULL);
+}
+
+/* PsychReleaseStreamVertexData()
+ *
+ * Unbinds the streaming vertex buffer bound by PsychStreamVertexData(), if any.
+ */
+void PsychReleaseStreamVertexData(PsychWindowRecordType *windowRecord)
+{
+	if (PsychGetParentWindow(windowRecord)->streamVBO) glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+}
+
+// Fragment shader for analytic drawing of ovals by PsychDrawOvals(): gl_TexCoord[0].xy is the position relative to
+// the center of the oval, normalized to its half-axes, gl_TexCoord[0].z the relative size of the inner hole of a
+// framed oval. The coverage of each fragment is computed from the distance to the border(s), in units of pixels:
+static char ovalFragmentShaderSrc[] =
+"\n"
+"uniform float antiAlias; \n"
+" \n"
+"void main() \n"
+"{ \n"
+"    float r = length(gl_TexCoord[0].xy); \n"
+"    float w = max(fwidth(r), 0.0001); \n"
+"    float coverage = clamp((1.0 - r) / w + 0.5, 0.0, 1.0); \n"
+"    if (gl_TexCoord[0].z > 0.0) coverage *= clamp((r - gl_TexCoord[0].z) / w + 0.5, 0.0, 1.0); \n"
+" \n"
+"    /* Hard edges unless anti-aliasing is requested: */ \n"
+"    if (antiAlias == 0.0) coverage = (coverage >= 0.5) ? 1.0 : 0.0; \n"
+"    if (coverage <= 0.0) discard; \n"
+" \n"
+"    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage); \n"
+"} \n";
+
+/* PsychDrawOvals()
+ *
+ * Batch renderer for Screen('FillOval') and Screen('FrameOval'): Draws the 'numRects' ovals inscribed into
+ * the rects stored as 4-tuples in 'rects' with a single draw call. 'penSizes' contains one common pen size or
+ * one per oval ('nrsize') for the width of the ring of framed ovals, or is NULL for filled ovals. Colors are
+ * as set up by PsychPrepareRenderBatch(), 'nc' > 1 means one color per oval. 'maxDiameter' is the maximum
+ * diameter for which tessellated ovals look perfect.
+ *
+ * If GLSL is supported and no default draw shader is active, each oval is drawn as a single quad and its shape
+ * is computed analytically per fragment. Edges are hard, as with tessellated ovals, unless 'smooth' requests
+ * anti-aliased edges and alpha blending is enabled. Otherwise all ovals get tessellated into one vertex array
+ * of triangles on the CPU, and 'smooth' is ignored.
+ */
+void PsychDrawOvals(PsychWindowRecordType *windowRecord, int numRects, double *rects, int nrsize, double *penSizes, int nc, int mc, double *colors, unsigned char *bytecolors, double maxDiameter, psych_bool smooth)
+{
+	PsychWindowRecordType	*parentRecord = PsychGetParentWindow(windowRecord);
+	psych_bool				analytic;
+	double					*rect, *vcolors;
+	GLfloat					*vertices, *v, *t, *base;
+	unsigned char			*vbytecolors;
+	double					cx, cy, hw, hh, outer, inner, diameter, ex, ey, c, s, c1, s1, cd, sd;
+	int						i, j, k, nverts, totalverts, slices;
+
+	// Analytic oval shader available? Create it on first use:
+	if ((parentRecord->ovalShader == 0) && !windowRecord->defaultDrawShader) {
+		if (glewIsSupported("GL_ARB_shader_objects") && glewIsSupported("GL_ARB_shading_language_100") && glewIsSupported("GL_ARB_fragment_shader")) {
+			parentRecord->ovalShader = (GLint) PsychCreateGLSLProgram(ovalFragmentShaderSrc, NULL, NULL);
+		}
+
+		if (parentRecord->ovalShader == 0) {
+			if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Failed to create shader for drawing of ovals. Using slower fallback path.\n");
+			parentRecord->ovalShader = -1;
+		}
+	}
+	analytic = ((parentRecord->ovalShader > 0) && !windowRecord->defaultDrawShader) ? TRUE : FALSE;
+
+	// Count vertices: Four per oval for analytic ovals, three per triangle for tessellated ovals:
+	totalverts = 0;
+	for (i = 0; i < numRects; i++) {
+		rect = &rects[i * 4];
+		if (IsPsychRectEmpty(rect)) continue;
+
+		if (analytic) {
+			totalverts += 4;
+		}
+		else {
+			// One subdivision (slice) for each distance unit on the circumference of the oval:
+			diameter = (PsychGetWidthFromRect(rect) > PsychGetHeightFromRect(rect)) ? PsychGetWidthFromRect(rect) : PsychGetHeightFromRect(rect);
+			slices = (int) (3.14159265358979323846 * ((diameter < maxDiameter) ? diameter : maxDiameter));
+			if (slices < 12) slices = 12;
+			totalverts += ((penSizes) ? 6 : 3) * slices;
+		}
+	}
+
+	if (totalverts == 0) return;
+
+	// One block for streaming: 2D vertex positions, followed by 3D texture coordinates for analytic ovals:
+	vertices = (GLfloat*) PsychMallocTemp(sizeof(GLfloat) * ((analytic) ? 5 : 2) * (size_t) totalverts);
+	// Per vertex colors. High precision color mode can't handle uint8 colors, so they get converted to double:
+	vcolors = (nc > 1 && (colors || windowRecord->defaultDrawShader)) ? (double*) PsychMallocTemp(sizeof(double) * (size_t) mc * (size_t) totalverts) : NULL;
+	vbytecolors = (nc > 1 && !vcolors) ? (unsigned char*) PsychMallocTemp((size_t) mc * (size_t) totalverts) : NULL;
+
+	v = vertices;
+	t = vertices + 2 * totalverts;
+	totalverts = 0;
+	for (i = 0; i < numRects; i++) {
+		rect = &rects[i * 4];
+		if (IsPsychRectEmpty(rect)) continue;
+
+		PsychGetCenterFromRectAbsolute(rect, &cx, &cy);
+		hw = PsychGetWidthFromRect(rect) / 2;
+		hh = PsychGetHeightFromRect(rect) / 2;
+		outer = (hw > hh) ? hw : hh;
+
+		// Relative size of inner hole: The pen width is applied to the larger half-axis and
+		// scaled down with the oval along the smaller one:
+		inner = 0;
+		if (penSizes) {
+			inner = outer - penSizes[(nrsize > 1) ? i : 0];
+			inner = (inner < 0) ? 0 : inner / outer;
+		}
+
+		if (analytic) {
+			// Quad covering the oval, plus a pixel of padding for anti-aliasing:
+			ex = (hw + 1) / hw;
+			ey = (hh + 1) / hh;
+			for (k = 0; k < 4; k++) {
+				*(t++) = (GLfloat) ((k == 0 || k == 3) ? -ex : ex);
+				*(t++) = (GLfloat) ((k < 2) ? -ey : ey);
+				*(t++) = (GLfloat) inner;
+				*(v++) = (GLfloat) (cx + hw * t[-3]);
+				*(v++) = (GLfloat) (cy + hh * t[-2]);
+			}
+			nverts = 4;
+		}
+		else {
+			diameter = 2 * outer;
+			slices = (int) (3.14159265358979323846 * ((diameter < maxDiameter) ? diameter : maxDiameter));
+			if (slices < 12) slices = 12;
+
+			// Walk around the circumference by incremental rotation of (c, s):
+			cd = cos(2 * 3.14159265358979323846 / slices);
+			sd = sin(2 * 3.14159265358979323846 / slices);
+			c = 1;
+			s = 0;
+			for (k = 0; k < slices; k++) {
+				c1 = (k < slices - 1) ? c * cd - s * sd : 1;
+				s1 = (k < slices - 1) ? s * cd + c * sd : 0;
+				if (penSizes) {
+					// Two triangles per segment of the ring:
+					*(v++) = (GLfloat) (cx + hw * c);			*(v++) = (GLfloat) (cy + hh * s);
+					*(v++) = (GLfloat) (cx + hw * c1);			*(v++) = (GLfloat) (cy + hh * s1);
+					*(v++) = (GLfloat) (cx + hw * inner * c);	*(v++) = (GLfloat) (cy + hh * inner * s);
+					*(v++) = (GLfloat) (cx + hw * inner * c);	*(v++) = (GLfloat) (cy + hh * inner * s);
+					*(v++) = (GLfloat) (cx + hw * c1);			*(v++) = (GLfloat) (cy + hh * s1);
+					*(v++) = (GLfloat) (cx + hw * inner * c1);	*(v++) = (GLfloat) (cy + hh * inner * s1);
+				}
+				else {
+					// One triangle per segment of the disk:
+					*(v++) = (GLfloat) cx;						*(v++) = (GLfloat) cy;
+					*(v++) = (GLfloat) (cx + hw * c);			*(v++) = (GLfloat) (cy + hh * s);
+					*(v++) = (GLfloat) (cx + hw * c1);			*(v++) = (GLfloat) (cy + hh * s1);
+				}
+				c = c1;
+				s = s1;
+			}
+			nverts = ((penSizes) ? 6 : 3) * slices;
+		}
+
+		// Replicate per oval color to all its vertices:
+		for (j = totalverts * mc; vcolors && j < (totalverts + nverts) * mc; j++) vcolors[j] = (colors) ? colors[i * mc + (j % mc)] : (double) bytecolors[i * mc + (j % mc)] / 255.0;
+		for (j = totalverts * mc; vbytecolors && j < (totalverts + nverts) * mc; j++) vbytecolors[j] = bytecolors[i * mc + (j % mc)];
+		totalverts += nverts;
+	}
+
+	base = PsychStreamVertexData(windowRecord, vertices, sizeof(GLfloat) * ((analytic) ? 5 : 2) * (size_t) totalverts);
+	glVertexPointer(2, GL_FLOAT, 0, base);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	if (analytic) {
+		glTexCoordPointer(3, GL_FLOAT, 0, base + 2 * totalverts);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	PsychReleaseStreamVertexData(windowRecord);
+
+	if (nc > 1) PsychSetupVertexColorArrays(windowRecord, TRUE, mc, vcolors, vbytecolors);
+
+	if (analytic) {
+		PsychSetShader(windowRecord, parentRecord->ovalShader);
+		glUniform1f(glGetUniformLocation(parentRecord->ovalShader, "antiAlias"), (smooth && windowRecord->actualEnableBlending) ? 1.0f : 0.0f);
+		glDrawArrays(GL_QUADS, 0, totalverts);
+		PsychSetShader(windowRecord, -1);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(4, GL_FLOAT, 0, NULL);
+	}
+	else {
+		glDrawArrays(GL_TRIANGLES, 0, totalverts);
+	}
+
+	if (nc > 1) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, NULL);
+
+	return;
+}
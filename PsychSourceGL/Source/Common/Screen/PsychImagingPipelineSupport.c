@@ -36,6 +36,30 @@
 
 #include "Screen.h"
 
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+// Include for dynamic loading of native C plugins for hook chains:
+#include <dlfcn.h>
+// Includes for mkdir(), enumeration and aging of files and getpid() for the GLSL program binary cache directory:
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#else
+#include <direct.h>
+#include <sys/utime.h>
+#endif
+
+// Internal helpers for native C plugins in hook chains, see PsychImagingPluginAPI.h:
+static psych_bool PsychPipelineCallCFunction(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc, int command, void* hookUserData, PsychFBO** srcfbo1, PsychFBO** srcfbo2, PsychFBO** dstfbo, PsychFBO** bouncefbo);
+static void PsychPipelineDetachCFunctionSlot(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc);
+static void PsychPipelineReleaseCFunctionSlot(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc);
+
+// Internal helpers for FBO management, see PsychCreatePooledFBO():
+static void PsychDeleteFBO(PsychFBO* fboptr);
+static void PsychReleasePooledFBO(PsychWindowRecordType *parentWindow, PsychFBO* fbo);
+static void PsychFreeFBOPool(PsychWindowRecordType *win);
+static void PsychUpdateFBOPeakBytes(PsychWindowRecordType *win);
+
 static char texturePlanar1FragmentShaderSrc[] =
 "\n"
 " \n"
@@ -325,6 +349,9 @@ void PsychInitImagingPipelineDefaultsForWindowRecord(PsychWindowRecordType *wind
 	for (i=0; i<MAX_SCREEN_HOOKS; i++) {
 		windowRecord->HookChainEnabled[i]=FALSE;
 		windowRecord->HookChain[i]=NULL;
+		windowRecord->HookChainCompiled[i]=NULL;
+		windowRecord->HookChainSlotCount[i]=0;
+		windowRecord->HookChainPingPongs[i]=0;
 	}
 	
 	// Disable all special framebuffer objects by default:
@@ -338,6 +365,7 @@ void PsychInitImagingPipelineDefaultsForWindowRecord(PsychWindowRecordType *wind
 	windowRecord->preConversionFBO[0]=-1;
 	windowRecord->preConversionFBO[1]=-1;
 	windowRecord->preConversionFBO[2]=-1;
+	windowRecord->preConversionFBO[3]=-1;
 	windowRecord->finalizedFBO[0]=-1;
 	windowRecord->finalizedFBO[1]=-1;
 	windowRecord->fboCount = 0;
@@ -351,6 +379,146 @@ void PsychInitImagingPipelineDefaultsForWindowRecord(PsychWindowRecordType *wind
 	return;
 }
 
+// Stages of the imaging pipeline during which one of its FBO's can be live, for the FBO lifetime planner of
+// PsychAllocatePipelineFBOs(). PsychPreFlipOperations() executes the stages in this order on each flip:
+#define kPsychFBOStageDraw		1	// Between flips: Drawing into drawBufferFBO's, multisample resolves by Screen('GetImage').
+#define kPsychFBOStageProcess	2	// Multisample resolve into inputBufferFBO's and per-view image processing.
+#define kPsychFBOStageMerge		4	// Stereo merge operation.
+#define kPsychFBOStageOutput	8	// Output formatting and final blit into the finalizedFBO's.
+#define kPsychFBOStageAll		15	// Live during the whole lifetime of the window.
+
+// Request for one FBO of the imaging pipeline, see PsychPlanPipelineFBO():
+typedef struct PsychFBOPlanEntry {
+	GLenum			format;			// Parameters for PsychCreateFBO().
+	psych_bool		needzbuffer;
+	int				width;
+	int				height;
+	int				multisample;
+	const char*		errorMsg;		// Error message if creation of the FBO fails.
+	unsigned int	stages;			// Mask of kPsychFBOStageXXX during which the FBO is live.
+	int				fboIndex;		// Index of the FBO in fboTable after creation.
+} PsychFBOPlanEntry;
+
+// Record request number 'index' for a FBO of the imaging pipeline. The FBO gets created later by PsychAllocatePipelineFBOs(),
+// once all FBO's are assigned to their roles:
+static void PsychPlanPipelineFBO(PsychFBOPlanEntry *plan, int index, GLenum fboInternalFormat, psych_bool needzbuffer, int width, int height, int multisample, const char* errorMsg)
+{
+	if (index >= MAX_FBOTABLE_SLOTS) PsychErrorExitMsg(PsychError_internal, "Imaging Pipeline setup: Too many FBO's requested. PTB implementation bug!");
+
+	plan[index].format = fboInternalFormat;
+	plan[index].needzbuffer = needzbuffer;
+	plan[index].width = width;
+	plan[index].height = height;
+	plan[index].multisample = multisample;
+	plan[index].errorMsg = errorMsg;
+	plan[index].stages = 0;
+	plan[index].fboIndex = -1;
+}
+
+// Mark the FBO of request 'index' as live during 'stages'. Negative indices denote unused FBO's and are ignored:
+static void PsychPlanFBOLifetime(PsychFBOPlanEntry *plan, int index, unsigned int stages)
+{
+	if (index >= 0) plan[index].stages |= stages;
+}
+
+// Remap request index '*index' to the index of its FBO in fboTable. Negative indices denote unused FBO's and are left alone:
+static void PsychRemapPipelineFBO(PsychFBOPlanEntry *plan, int *index)
+{
+	if (*index >= 0) *index = plan[*index].fboIndex;
+}
+
+/* PsychAllocatePipelineFBOs() -- FBO lifetime planner for the imaging pipeline.
+ *
+ * Create the FBO's for the 'count' requests made via PsychPlanPipelineFBO() during setup of the imaging pipeline
+ * of onscreen window 'windowRecord', and remap all FBO indices in 'windowRecord' from request indices to indices
+ * into fboTable. Intermediate buffers, e.g., bounce buffers, only hold content during some stages of the pipeline.
+ * Requests of identical size, format, multisampling level and depth buffer setup which are never live during the
+ * same stage therefore share one FBO. Returns the number of created FBO's.
+ */
+static int PsychAllocatePipelineFBOs(PsychWindowRecordType *windowRecord, PsychFBOPlanEntry *plan, int count)
+{
+	unsigned int	fboStages[MAX_FBOTABLE_SLOTS];
+	int				fboRequest[MAX_FBOTABLE_SLOTS];
+	int				i, j, first, last, fbocount;
+
+	// Derive lifetimes from the roles of the requests: The drawBufferFBO's must keep their content across flips, and so
+	// must the finalizedFBO's, e.g., for frame-sequential stereo or as source of the copy to the slave window in dual-window
+	// output mode. The inputBufferFBO's also serve as temporary multisample resolve buffers for Screen('GetImage'):
+	for (i=0; i<2; i++) {
+		PsychPlanFBOLifetime(plan, windowRecord->finalizedFBO[i], kPsychFBOStageAll);
+		PsychPlanFBOLifetime(plan, windowRecord->drawBufferFBO[i], kPsychFBOStageAll);
+		PsychPlanFBOLifetime(plan, windowRecord->inputBufferFBO[i], kPsychFBOStageDraw | kPsychFBOStageProcess);
+		PsychPlanFBOLifetime(plan, windowRecord->processedDrawBufferFBO[i], kPsychFBOStageProcess | kPsychFBOStageMerge);
+		PsychPlanFBOLifetime(plan, windowRecord->preConversionFBO[i], kPsychFBOStageMerge | kPsychFBOStageOutput);
+	}
+	PsychPlanFBOLifetime(plan, windowRecord->processedDrawBufferFBO[2], kPsychFBOStageProcess);
+	PsychPlanFBOLifetime(plan, windowRecord->preConversionFBO[2], kPsychFBOStageMerge | kPsychFBOStageOutput);
+	PsychPlanFBOLifetime(plan, windowRecord->preConversionFBO[3], kPsychFBOStageOutput);
+
+	for (i=0; i<count; i++) {
+		// Requests without any role are live all the time, to be on the safe side:
+		if (plan[i].stages == 0) plan[i].stages = kPsychFBOStageAll;
+
+		// A FBO is live from the first to the last stage which uses it:
+		first = last = -1;
+		for (j=0; j<4; j++) {
+			if (plan[i].stages & (1 << j)) {
+				if (first < 0) first = j;
+				last = j;
+			}
+		}
+		for (j=first; j<=last; j++) plan[i].stages |= (1 << j);
+	}
+
+	// Greedy allocation in request order: Share an already created FBO of identical properties which isn't live
+	// during any of our stages, create a new one otherwise:
+	fbocount = 0;
+	for (i=0; i<count; i++) {
+		for (j=0; j<fbocount; j++) {
+			if (!(fboStages[j] & plan[i].stages) && (plan[fboRequest[j]].format == plan[i].format) && (plan[fboRequest[j]].needzbuffer == plan[i].needzbuffer) &&
+				(plan[fboRequest[j]].width == plan[i].width) && (plan[fboRequest[j]].height == plan[i].height) && (plan[fboRequest[j]].multisample == plan[i].multisample)) break;
+		}
+
+		if (j < fbocount) {
+			// Shared:
+			windowRecord->fboAliasedBytes += PsychGetFBOSizeBytes(windowRecord->fboTable[j]);
+			if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Imaging pipeline buffer %i shares framebuffer object %i.\n", i, j);
+		}
+		else {
+			if (!PsychCreateFBO(&(windowRecord->fboTable[j]), plan[i].format, plan[i].needzbuffer, plan[i].width, plan[i].height, plan[i].multisample)) {
+				// Failed!
+				PsychErrorExitMsg(PsychError_system, plan[i].errorMsg);
+			}
+
+			windowRecord->fboBytes += PsychGetFBOSizeBytes(windowRecord->fboTable[j]);
+			fboStages[j] = 0;
+			fboRequest[j] = i;
+			fbocount++;
+		}
+
+		fboStages[j] |= plan[i].stages;
+		plan[i].fboIndex = j;
+	}
+
+	PsychUpdateFBOPeakBytes(windowRecord);
+
+	// Remap all roles to the created FBO's:
+	for (i=0; i<2; i++) {
+		PsychRemapPipelineFBO(plan, &(windowRecord->finalizedFBO[i]));
+		PsychRemapPipelineFBO(plan, &(windowRecord->drawBufferFBO[i]));
+		PsychRemapPipelineFBO(plan, &(windowRecord->inputBufferFBO[i]));
+	}
+	for (i=0; i<3; i++) PsychRemapPipelineFBO(plan, &(windowRecord->processedDrawBufferFBO[i]));
+	for (i=0; i<4; i++) PsychRemapPipelineFBO(plan, &(windowRecord->preConversionFBO[i]));
+
+	if (PsychPrefStateGet_Verbosity() > 4) {
+		printf("PTB-DEBUG: Imaging pipeline uses %i framebuffer objects for %i buffers, %f MB total, %f MB saved by sharing.\n",
+			   fbocount, count, (double) windowRecord->fboBytes / 1024 / 1024, (double) windowRecord->fboAliasedBytes / 1024 / 1024);
+	}
+
+	return(fbocount);
+}
+
 /*  PsychInitializeImagingPipeline()
  *
  *  Initialize imaging pipeline for windowRecord, applying the imagingmode flags. Called by Screen('OpenWindow').
@@ -374,6 +542,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 	GLint redbits;
 	float rg, gg, bg;	// Gains for color channels and color masking for anaglyph shader setup.
 	char blittercfg[1000];
+	PsychFBOPlanEntry fboplan[MAX_FBOTABLE_SLOTS];
 
 	// Processing ends here after minimal "all off" setup, if pipeline is disabled:
 	if (imagingmode<=0) {
@@ -534,7 +703,8 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		needfastbackingstore = TRUE;
 	}
 	
-	// Try to allocate and configure proper FBO's:
+	// Try to allocate and configure proper FBO's: We only collect the requests for FBO's here, they
+	// get created by PsychAllocatePipelineFBOs() at the end of setup:
 	fbocount = 0;
 	
 	// Define final default output buffers as system framebuffers: We create some pseudo-FBO's for these
@@ -544,10 +714,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 	winwidth=(int)PsychGetWidthFromRect(windowRecord->rect);
 	winheight=(int)PsychGetHeightFromRect(windowRecord->rect);
 
-	if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), 0, FALSE, winwidth, winheight, 0)) {
-		// Failed!
-		PsychErrorExitMsg(PsychError_internal, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline.");
-	}
+	PsychPlanPipelineFBO(fboplan, fbocount, 0, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline.");
 
 	// The pseudo-FBO initially contains a fboid of zero == system framebuffer, and empty (zero) attachments.
 	// The up to now only useful information is the viewport geometry ie winwidth and winheight.
@@ -583,10 +750,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		// In dual window output mode, we may only have one merged/composited stereo view or even only
 		// a single monoscopic view, but we still distribute that view to both finalizedFBO's aka different
 		// onscreen windows backbuffers, possibly with separate output formatting / postprocessing.
-		if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), finalizedFBOFormat, FALSE, winwidth, winheight, 0)) {
-			// Failed!
-			PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline for dual-window stereo.");
-		}
+		PsychPlanPipelineFBO(fboplan, fbocount, finalizedFBOFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline for dual-window stereo.");
 		
 		windowRecord->finalizedFBO[1]=fbocount;
 		fbocount++;
@@ -595,18 +759,12 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 	if (windowRecord->stereomode == kPsychFrameSequentialStereo) {
 		// Home-Grown frame-sequential stereo mode: Need one real finalizedFBO for each of the
 		// two stereo streams:
-		if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), finalizedFBOFormat, FALSE, winwidth, winheight, 0)) {
-			// Failed!
-			PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline for frame-sequential stereo (left eye).");
-		}
+		PsychPlanPipelineFBO(fboplan, fbocount, finalizedFBOFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline for frame-sequential stereo (left eye).");
 		
 		windowRecord->finalizedFBO[0]=fbocount;
 		fbocount++;
 
-		if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), finalizedFBOFormat, FALSE, winwidth, winheight, 0)) {
-			// Failed!
-			PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline for frame-sequential stereo (right eye).");
-		}
+		PsychPlanPipelineFBO(fboplan, fbocount, finalizedFBOFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 0 of imaging pipeline for frame-sequential stereo (right eye).");
 		
 		windowRecord->finalizedFBO[1]=fbocount;
 		fbocount++;
@@ -640,14 +798,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 
 		// These FBO's may need a z-buffer or stencil buffer as well if 3D rendering is
 		// enabled:
-		if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, needzbuffer, winwidth, winheight, multiSample)) {
-			// Failed!
-			PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 1 of imaging pipeline.");
-		}
-		
-		if ((PsychPrefStateGet_Verbosity() > 2) && (windowRecord->fboTable[fbocount]->multisample > 0)) {
-			printf("PTB-INFO: Created framebuffer for anti-aliasing with %i samples per pixel for use with imaging pipeline.\n", windowRecord->fboTable[fbocount]->multisample);
-		}
+		PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, needzbuffer, winwidth, winheight, multiSample, "Imaging Pipeline setup: Could not setup stage 1 of imaging pipeline.");
 		
 		// Assign this FBO as drawBuffer for left-eye or mono channel:
 		windowRecord->drawBufferFBO[0] = fbocount;
@@ -655,10 +806,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		
 		// If we are in stereo mode, we'll need a 2nd buffer for the right-eye channel:
 		if (windowRecord->stereomode > 0) {
-			if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, needzbuffer, winwidth, winheight, multiSample)) {
-				// Failed!
-				PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 1 of imaging pipeline.");
-			}
+			PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, needzbuffer, winwidth, winheight, multiSample, "Imaging Pipeline setup: Could not setup stage 1 of imaging pipeline.");
 			
 			// Assign this FBO as drawBuffer for right-eye channel:
 			windowRecord->drawBufferFBO[1] = fbocount;
@@ -713,10 +861,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 	
 		if (!targetisfinalFB) {
 			// Yes. Setup real inputBuffers as multisample-resolve targets:
-			if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-				// Failed!
-				PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 1 inputBufferFBO of imaging pipeline.");
-			}
+			PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 1 inputBufferFBO of imaging pipeline.");
 			
 			// Assign this FBO as inputBufferFBO for left-eye or mono channel:
 			windowRecord->inputBufferFBO[0] = fbocount;
@@ -730,10 +875,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		// If we are in stereo mode, we'll need a 2nd buffer for the right-eye channel:
 		if (windowRecord->stereomode > 0) {
 			if (!targetisfinalFB) {
-				if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-					// Failed!
-					PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 1 inputBufferFBO of imaging pipeline.");
-				}
+				PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 1 inputBufferFBO of imaging pipeline.");
 				
 				// Assign this FBO as drawBuffer for right-eye channel:
 				windowRecord->inputBufferFBO[1] = fbocount;
@@ -785,10 +927,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 
 		if (!targetisfinalFB) {
 			// These FBO's don't need z- or stencil buffers anymore:
-			if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-				// Failed!
-				PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 2 of imaging pipeline.");
-			}			
+			PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 2 of imaging pipeline.");
 
 			// Assign this FBO as processedDrawBuffer for left-eye or mono channel:
 			windowRecord->processedDrawBufferFBO[0] = fbocount;
@@ -803,10 +942,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		if (windowRecord->stereomode > 0) {
 			if (!targetisfinalFB) {
 				// These FBO's don't need z- or stencil buffers anymore:
-				if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-					// Failed!
-					PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 2 of imaging pipeline.");
-				}			
+				PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 2 of imaging pipeline.");
 				
 				// Assign this FBO as processedDrawBuffer for right-eye channel:
 				windowRecord->processedDrawBufferFBO[1] = fbocount;
@@ -824,10 +960,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		
 		// Allocate a bounce-buffer as well if multi-pass rendering is requested:
 		if (imagingmode & kPsychNeedDualPass || imagingmode & kPsychNeedMultiPass) {
-			if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-				// Failed!
-				PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 2 of imaging pipeline.");
-			}
+			PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 2 of imaging pipeline.");
 			
 			// Assign this FBO as processedDrawBuffer for bounce buffer ops in multi-pass rendering:
 			windowRecord->processedDrawBufferFBO[2] = fbocount;
@@ -864,10 +997,7 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		}
 
 		// These FBO's don't need z- or stencil buffers anymore:
-		if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-			// Failed!
-			PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 3 of imaging pipeline.");
-		}
+		PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 3 of imaging pipeline.");
 		
 		// Assign this FBO for left-eye and right-eye channel: The FBO is shared accross channels...
 		windowRecord->preConversionFBO[0] = fbocount;
@@ -915,30 +1045,15 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 
 	// Do we need a bounce buffer for merging and/or conversion?
 	if (windowRecord->preConversionFBO[2] == -1000) {
-		// Yes. We can reuse/share the bounce buffer of the image processing stage if
-		// one exists and is of suitable size i.e. we're not in dual-view stereo - in
-		// that case all buffers are of same size.
-		if ((windowRecord->processedDrawBufferFBO[2]!=-1) && 
-			!(windowRecord->stereomode==kPsychFreeFusionStereo || windowRecord->stereomode==kPsychFreeCrossFusionStereo)) {
-			// Stage 1 bounce buffer is suitable for sharing, assign it:
-			windowRecord->preConversionFBO[2] = windowRecord->processedDrawBufferFBO[2];
-		}
-		else {
-			// We need a new, private bounce-buffer:
-			if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-				// Failed!
-				PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 3 of imaging pipeline [1st bounce buffer].");
-			}
-			
-			windowRecord->preConversionFBO[2] = fbocount;
-			fbocount++;				
-		}
+		// Yes. Request a private bounce-buffer. PsychAllocatePipelineFBOs() will share the bounce buffer of the
+		// image processing stage for it if one exists and is of suitable size, i.e., we're not in dual-view
+		// stereo, as both are never needed at the same time:
+		PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 3 of imaging pipeline [1st bounce buffer].");
+		windowRecord->preConversionFBO[2] = fbocount;
+		fbocount++;
 		
 		// In any case, we need a new private 2nd bounce buffer for the special case of the final processing chain:
-		if (!PsychCreateFBO(&(windowRecord->fboTable[fbocount]), fboInternalFormat, FALSE, winwidth, winheight, 0)) {
-			// Failed!
-			PsychErrorExitMsg(PsychError_system, "Imaging Pipeline setup: Could not setup stage 3 of imaging pipeline [2nd bounce buffer].");
-		}
+		PsychPlanPipelineFBO(fboplan, fbocount, fboInternalFormat, FALSE, winwidth, winheight, 0, "Imaging Pipeline setup: Could not setup stage 3 of imaging pipeline [2nd bounce buffer].");
 		
 		windowRecord->preConversionFBO[3] = fbocount;
 		fbocount++;
@@ -952,6 +1067,13 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 		windowRecord->preConversionFBO[1] = windowRecord->preConversionFBO[0];
 	}
 
+	// All FBO's are requested and assigned to their roles. Create them, sharing FBO's between pipeline stages where possible:
+	fbocount = PsychAllocatePipelineFBOs(windowRecord, fboplan, fbocount);
+
+	if ((PsychPrefStateGet_Verbosity() > 2) && (windowRecord->drawBufferFBO[0] >= 0) && (windowRecord->fboTable[windowRecord->drawBufferFBO[0]]->multisample > 0)) {
+		printf("PTB-INFO: Created framebuffer for anti-aliasing with %i samples per pixel for use with imaging pipeline.\n", windowRecord->fboTable[windowRecord->drawBufferFBO[0]]->multisample);
+	}
+
 	// Setup imaging mode flags:
 	newimagingmode = (needseparatestreams) ? kPsychNeedSeparateStreams : 0;
 	if (!needseparatestreams && (windowRecord->stereomode > 0)) newimagingmode |= kPsychNeedStereoMergeOp;
@@ -1175,10 +1297,364 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
 	return;
 }
 
+// GL_ARB_get_program_binary for the GLSL program binary cache. Not known to our glew version, so we
+// define what we need ourselves:
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT	0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH			0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS		0x87FE
+#endif
+
+typedef void (GLAPIENTRY * PsychGetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (GLAPIENTRY * PsychProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (GLAPIENTRY * PsychProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+static PsychGetProgramBinaryProc	psych_glGetProgramBinary = NULL;
+static PsychProgramBinaryProc		psych_glProgramBinary = NULL;
+static PsychProgramParameteriProc	psych_glProgramParameteri = NULL;
+
+// Header of a GLSL program binary cache file, followed by 'length' bytes of program binary:
+typedef struct PsychGLSLCacheHeader {
+	char			magic[8];		// "PTBGLSL" + version.
+	psych_uint64	key;			// Hash of shader sources and renderer.
+	GLenum			binaryFormat;	// Format as returned by glGetProgramBinary().
+	GLsizei			length;			// Size of program binary in bytes.
+} PsychGLSLCacheHeader;
+
+static const char psychGLSLCacheMagic[8] = "PTBGLSL1";
+
+// Limits of the GLSL program binary cache. If it grows beyond them, the least recently used binaries get
+// deleted, until it is down to 3/4 of the limits:
+#define PSYCH_GLSLCACHE_MAXFILES	1024
+#define PSYCH_GLSLCACHE_MAXBYTES	(64 * 1024 * 1024)
+
+// Cache file name, size and time of last use, for eviction of least recently used cache files:
+typedef struct PsychGLSLCacheEntry {
+	char			name[32];
+	psych_int64		size;
+	psych_int64		lastUsed;
+} PsychGLSLCacheEntry;
+
+/* PsychGLSLCacheHash() - FNV-1a hash of a string into an existing hash value. NULL strings hash as a marker byte. */
+static psych_uint64 PsychGLSLCacheHash(psych_uint64 hash, const char* str)
+{
+	const unsigned char* p = (const unsigned char*) str;
+
+	if (p == NULL) {
+		hash ^= (psych_uint64) 0xff;
+		hash *= (psych_uint64) 1099511628211ULL;
+		return(hash);
+	}
+
+	// Include the terminating zero, so "ab"+"c" and "a"+"bc" hash differently:
+	do {
+		hash ^= (psych_uint64) *p;
+		hash *= (psych_uint64) 1099511628211ULL;
+	} while (*(p++));
+
+	return(hash);
+}
+
+/* PsychGLSLCacheCompareEntries() - qsort() comparison for sorting cache entries from least to most recently used. */
+static int PsychGLSLCacheCompareEntries(const void* a, const void* b)
+{
+	psych_int64 ta = ((const PsychGLSLCacheEntry*) a)->lastUsed;
+	psych_int64 tb = ((const PsychGLSLCacheEntry*) b)->lastUsed;
+
+	return((ta < tb) ? -1 : ((ta > tb) ? 1 : 0));
+}
+
+/* PsychGLSLCacheEvict()
+ * Bound the size of the cache in cache directory 'cacheDir': If it holds more than PSYCH_GLSLCACHE_MAXFILES
+ * files or PSYCH_GLSLCACHE_MAXBYTES bytes, delete the least recently used cache files until it is down to
+ * 3/4 of these limits. The modification time of a cache file is its time of last use, as it gets updated
+ * whenever the file is loaded. Binaries of all renderers share the cache, so machines with multiple gpu's
+ * or which alternate between drivers keep the binaries of each of them as long as they are in use.
+ */
+static void PsychGLSLCacheEvict(const char* cacheDir)
+{
+	PsychGLSLCacheEntry* entries = NULL;
+	PsychGLSLCacheEntry* newEntries;
+	char filePath[FILENAME_MAX];
+	const char* fileName;
+	psych_int64 totalBytes = 0;
+	size_t len;
+	int i, count = 0, capacity = 0, deleted = 0;
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+	WIN32_FIND_DATA entry;
+	HANDLE dir;
+	#else
+	struct dirent* entry;
+	struct stat fileStat;
+	DIR* dir;
+	#endif
+
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		if (strlen(cacheDir) + 8 >= FILENAME_MAX) return;
+		sprintf(filePath, "%s*.bin", cacheDir);
+		dir = FindFirstFile(filePath, &entry);
+		if (dir == INVALID_HANDLE_VALUE) return;
+		do {
+			fileName = entry.cFileName;
+	#else
+		dir = opendir(cacheDir);
+		if (NULL == dir) return;
+		while ((entry = readdir(dir))) {
+			fileName = entry->d_name;
+	#endif
+			// Only look at cache files, not at temporary files which may get written by another process right now:
+			len = strlen(fileName);
+			if ((len < 4) || (len >= sizeof(entries[0].name)) || strcmp(fileName + len - 4, ".bin") || (strlen(cacheDir) + len >= FILENAME_MAX)) continue;
+
+			if (count == capacity) {
+				capacity = (capacity > 0) ? 2 * capacity : 256;
+				newEntries = (PsychGLSLCacheEntry*) realloc(entries, capacity * sizeof(PsychGLSLCacheEntry));
+				if (NULL == newEntries) break;
+				entries = newEntries;
+			}
+
+			strcpy(entries[count].name, fileName);
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+			entries[count].size = ((psych_int64) entry.nFileSizeHigh << 32) | (psych_int64) entry.nFileSizeLow;
+			entries[count].lastUsed = ((psych_int64) entry.ftLastWriteTime.dwHighDateTime << 32) | (psych_int64) entry.ftLastWriteTime.dwLowDateTime;
+	#else
+			sprintf(filePath, "%s%s", cacheDir, fileName);
+			if (stat(filePath, &fileStat)) continue;
+			entries[count].size = (psych_int64) fileStat.st_size;
+			entries[count].lastUsed = (psych_int64) fileStat.st_mtime;
+	#endif
+			totalBytes += entries[count].size;
+			count++;
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		} while (FindNextFile(dir, &entry));
+		FindClose(dir);
+	#else
+		}
+		closedir(dir);
+	#endif
+
+	if ((count > PSYCH_GLSLCACHE_MAXFILES) || (totalBytes > PSYCH_GLSLCACHE_MAXBYTES)) {
+		// Delete least recently used files first:
+		qsort(entries, count, sizeof(PsychGLSLCacheEntry), PsychGLSLCacheCompareEntries);
+		for (i = 0; (i < count) && ((count - deleted > PSYCH_GLSLCACHE_MAXFILES / 4 * 3) || (totalBytes > PSYCH_GLSLCACHE_MAXBYTES / 4 * 3)); i++) {
+			sprintf(filePath, "%s%s", cacheDir, entries[i].name);
+			if (remove(filePath) == 0) {
+				totalBytes -= entries[i].size;
+				deleted++;
+			}
+		}
+
+		if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Deleted %i least recently used GLSL program binaries from cache %s.\n", deleted, cacheDir);
+	}
+
+	free(entries);
+
+	return;
+}
+
+/* PsychGLSLCacheGetFilename()
+ * Check if the GLSL program binary cache is usable for the current OpenGL context and assign the name
+ * of the cache file for the given shader sources to 'cachePath'. Returns FALSE if caching is impossible,
+ * e.g., due to missing GL_ARB_get_program_binary support, unknown config dir, or if it is disabled via
+ * environment variable PSYCHTOOLBOX_DISABLE_GLSLCACHE. The first time the cache is used in a session,
+ * least recently used cache files get evicted if the cache grew too big.
+ */
+static psych_bool PsychGLSLCacheGetFilename(const char* fragmentsrc, const char* vertexsrc, const char* primitivesrc, psych_uint64* key, char* cachePath)
+{
+	static psych_bool firstTime = TRUE;
+	static psych_bool evicted = FALSE;
+	const char* configDir;
+	psych_uint64 hash;
+	GLint numFormats = 0;
+
+	if (getenv("PSYCHTOOLBOX_DISABLE_GLSLCACHE")) return(FALSE);
+
+	// Resolve extension entry points once:
+	if (firstTime) {
+		firstTime = FALSE;
+		#if PSYCH_SYSTEM == PSYCH_WINDOWS
+			psych_glGetProgramBinary = (PsychGetProgramBinaryProc) wglGetProcAddress("glGetProgramBinary");
+			psych_glProgramBinary = (PsychProgramBinaryProc) wglGetProcAddress("glProgramBinary");
+			psych_glProgramParameteri = (PsychProgramParameteriProc) wglGetProcAddress("glProgramParameteri");
+		#elif PSYCH_SYSTEM == PSYCH_LINUX
+			psych_glGetProgramBinary = (PsychGetProgramBinaryProc) glXGetProcAddressARB((const GLubyte*) "glGetProgramBinary");
+			psych_glProgramBinary = (PsychProgramBinaryProc) glXGetProcAddressARB((const GLubyte*) "glProgramBinary");
+			psych_glProgramParameteri = (PsychProgramParameteriProc) glXGetProcAddressARB((const GLubyte*) "glProgramParameteri");
+		#else
+			psych_glGetProgramBinary = (PsychGetProgramBinaryProc) dlsym(RTLD_DEFAULT, "glGetProgramBinary");
+			psych_glProgramBinary = (PsychProgramBinaryProc) dlsym(RTLD_DEFAULT, "glProgramBinary");
+			psych_glProgramParameteri = (PsychProgramParameteriProc) dlsym(RTLD_DEFAULT, "glProgramParameteri");
+		#endif
+	}
+
+	if (!psych_glGetProgramBinary || !psych_glProgramBinary || !psych_glProgramParameteri) return(FALSE);
+
+	// Supported by the renderer of this context, with at least one binary format?
+	if (!strstr((char*) glGetString(GL_EXTENSIONS), "GL_ARB_get_program_binary")) return(FALSE);
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+	if (numFormats < 1) return(FALSE);
+
+	configDir = PsychRuntimeGetPsychtoolboxRoot(TRUE);
+	if ((strlen(configDir) == 0) || (strlen(configDir) + 40 >= FILENAME_MAX)) return(FALSE);
+
+	// Key is hash of renderer, driver version and all shader sources. Binaries are only valid
+	// for the exact same driver:
+	hash = (psych_uint64) 14695981039346656037ULL;
+	hash = PsychGLSLCacheHash(hash, (const char*) glGetString(GL_VENDOR));
+	hash = PsychGLSLCacheHash(hash, (const char*) glGetString(GL_RENDERER));
+	hash = PsychGLSLCacheHash(hash, (const char*) glGetString(GL_VERSION));
+	hash = PsychGLSLCacheHash(hash, fragmentsrc);
+	hash = PsychGLSLCacheHash(hash, vertexsrc);
+	hash = PsychGLSLCacheHash(hash, primitivesrc);
+	*key = hash;
+
+	sprintf(cachePath, "%sGLSLCache", configDir);
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		_mkdir(cachePath);
+	#else
+		mkdir(cachePath, 0755);
+	#endif
+
+	// Bound the size of the cache once per session:
+	if (!evicted) {
+		evicted = TRUE;
+		sprintf(cachePath, "%sGLSLCache/", configDir);
+		PsychGLSLCacheEvict(cachePath);
+	}
+
+	sprintf(cachePath, "%sGLSLCache/%08x%08x.bin", configDir, (unsigned int) (hash >> 32), (unsigned int) (hash & 0xffffffff));
+
+	return(TRUE);
+}
+
+/* PsychGLSLCacheLoad()
+ * Try to create GLSL program object from cache file 'cachePath'. Returns the program handle on success,
+ * 0 if there isn't a valid cached binary for the current driver.
+ */
+static GLuint PsychGLSLCacheLoad(const char* cachePath, psych_uint64 key)
+{
+	PsychGLSLCacheHeader header;
+	FILE* fd;
+	void* binary;
+	GLuint glsl;
+	GLint status;
+
+	fd = fopen(cachePath, "rb");
+	if (NULL == fd) return(0);
+
+	if ((fread(&header, sizeof(header), 1, fd) != 1) || memcmp(header.magic, psychGLSLCacheMagic, sizeof(header.magic)) ||
+		(header.key != key) || (header.length <= 0)) {
+		fclose(fd);
+		return(0);
+	}
+
+	binary = malloc((size_t) header.length);
+	if ((NULL == binary) || (fread(binary, (size_t) header.length, 1, fd) != 1)) {
+		free(binary);
+		fclose(fd);
+		return(0);
+	}
+	fclose(fd);
+
+	// Let the driver validate and load the binary. This fails if the driver changed in an
+	// incompatible way since the binary was stored:
+	glsl = glCreateProgram();
+	psych_glProgramBinary(glsl, header.binaryFormat, binary, header.length);
+	free(binary);
+
+	glGetProgramiv(glsl, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE) {
+		glDeleteProgram(glsl);
+		while (glGetError());
+		if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Cached GLSL program binary %s rejected by driver. Recompiling.\n", cachePath);
+		return(0);
+	}
+
+	// Mark cache file as recently used, so it doesn't get evicted:
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+	_utime(cachePath, NULL);
+	#else
+	utime(cachePath, NULL);
+	#endif
+
+	if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Created GLSL program %i from cached program binary %s.\n", glsl, cachePath);
+
+	return(glsl);
+}
+
+/* PsychGLSLCacheStore()
+ * Store program binary of successfully linked program 'glsl' in cache file 'cachePath'. The binary is written
+ * into a temporary file which then replaces the cache file, so other sessions never load a partially written file.
+ */
+static void PsychGLSLCacheStore(GLuint glsl, const char* cachePath, psych_uint64 key)
+{
+	PsychGLSLCacheHeader header;
+	char tmpPath[FILENAME_MAX];
+	FILE* fd;
+	void* binary;
+	psych_bool written;
+	GLint length = 0;
+
+	// Temporary file name is unique per process, in case multiple sessions store the same program concurrently:
+	if (strlen(cachePath) + 30 >= FILENAME_MAX) return;
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		sprintf(tmpPath, "%s.%u.tmp", cachePath, (unsigned int) GetCurrentProcessId());
+	#else
+		sprintf(tmpPath, "%s.%u.tmp", cachePath, (unsigned int) getpid());
+	#endif
+
+	glGetProgramiv(glsl, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		while (glGetError());
+		return;
+	}
+
+	binary = malloc((size_t) length);
+	if (NULL == binary) return;
+
+	memcpy(header.magic, psychGLSLCacheMagic, sizeof(header.magic));
+	header.key = key;
+	header.length = 0;
+	psych_glGetProgramBinary(glsl, (GLsizei) length, &header.length, &header.binaryFormat, binary);
+
+	if ((header.length > 0) && (fd = fopen(tmpPath, "wb"))) {
+		written = ((fwrite(&header, sizeof(header), 1, fd) == 1) && (fwrite(binary, (size_t) header.length, 1, fd) == 1)) ? TRUE : FALSE;
+		if (fclose(fd)) written = FALSE;
+
+		// Replace cache file by complete temporary file, or remove incomplete temporary file:
+		#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		if (written && !MoveFileEx(tmpPath, cachePath, MOVEFILE_REPLACE_EXISTING)) written = FALSE;
+		#else
+		if (written && rename(tmpPath, cachePath)) written = FALSE;
+		#endif
+
+		if (written) {
+			if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Stored GLSL program binary of %i bytes in cache file %s.\n", (int) header.length, cachePath);
+		}
+		else {
+			remove(tmpPath);
+		}
+	}
+
+	free(binary);
+	while (glGetError());
+
+	return;
+}
+
 /* PsychCreateGLSLProgram()
  *  Try to create GLSL shader from source strings and return handle to new shader.
  *  Returns the shader handle if it worked, 0 otherwise.
  *
+ *  If the driver supports GL_ARB_get_program_binary, linked programs are stored in an on-disk cache in the
+ *  GLSLCache subfolder of PsychtoolboxConfigDir(), keyed by shader sources and renderer, and later requests
+ *  for the same program are satisfied from the cache without compiling. Compilation is used whenever no
+ *  valid cached binary exists. The cache is bounded in size by eviction of the least recently used binaries.
+ *
  *  fragmentsrc - Source string for fragment shader. NULL if none needed.
  *  vertexsrc   - Source string for vertex shader. NULL if none needed.
  *  primitivesrc - Source string for primitive shader. NULL if none needed.
@@ -1190,6 +1666,9 @@ GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, co
 	GLuint shader;
 	GLint status;
 	char errtxt[10000];
+	char cachePath[FILENAME_MAX];
+	psych_uint64 cacheKey = 0;
+	psych_bool useCache;
 	
 	// Reset error state:
 	while (glGetError());
@@ -1200,8 +1679,13 @@ GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, co
 		return(0);
 	}
 	
+	// Try to get precompiled program from binary cache first:
+	useCache = PsychGLSLCacheGetFilename(fragmentsrc, vertexsrc, primitivesrc, &cacheKey, cachePath);
+	if (useCache && (glsl = PsychGLSLCacheLoad(cachePath, cacheKey))) return(glsl);
+
 	// Create GLSL program object:
 	glsl = glCreateProgram();
+	if (useCache) psych_glProgramParameteri(glsl, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	
 	// Fragment shader wanted?
 	if (fragmentsrc) {
@@ -1291,6 +1775,9 @@ GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, co
 	
 	while (glGetError());
 
+	// Store in binary cache for next time:
+	if (useCache) PsychGLSLCacheStore(glsl, cachePath, cacheKey);
+
 	// Return new GLSL program object handle:
 	return(glsl);
 }
@@ -1326,6 +1813,9 @@ psych_bool PsychCreateFBO(PsychFBO** fbo, GLenum fboInternalFormat, psych_bool n
 		(*fbo)->width = width;
 		(*fbo)->height = height;
 		(*fbo)->multisample = multisample;
+
+		// Zero for fboInternalFormat == 0, as our caller assigns a color buffer which belongs to someone else:
+		(*fbo)->format = fboInternalFormat;
 		
 		// fboInternalFormat == 0 --> Only allocate and assign, don't initialize FBO.
 		if (fboInternalFormat==0) return(TRUE);
@@ -1788,6 +2278,215 @@ psych_bool PsychCreateFBO(PsychFBO** fbo, GLenum fboInternalFormat, psych_bool n
 	return(TRUE);
 }
 
+/* PsychGetFBOSizeBytes()
+ * Return a rough estimate of the memory consumption of the buffers owned by FBO 'fbo'. The color buffer
+ * only counts if the FBO owns it, e.g., not for the pseudo FBO of a regular texture.
+ */
+size_t PsychGetFBOSizeBytes(PsychFBO* fbo)
+{
+	size_t pixels, samples, bytes;
+
+	if (fbo == NULL) return(0);
+
+	pixels = (size_t) fbo->width * (size_t) fbo->height;
+	samples = (fbo->multisample > 0) ? (size_t) fbo->multisample : 1;
+
+	// Color buffer:
+	switch (fbo->format) {
+		case 0:
+			bytes = 0;
+		break;
+
+		case GL_RGBA16:
+		case GL_RGBA16_SNORM:
+		case GL_RGBA_FLOAT16_APPLE:
+			bytes = pixels * samples * 8;
+		break;
+
+		case GL_RGBA_FLOAT32_APPLE:
+			bytes = pixels * samples * 16;
+		break;
+
+		case GL_RGB16_SNORM:
+		case GL_RGB_FLOAT16_APPLE:
+			bytes = pixels * samples * 6;
+		break;
+
+		case GL_RGB_FLOAT32_APPLE:
+			bytes = pixels * samples * 12;
+		break;
+
+		default:
+			bytes = pixels * samples * 4;
+	}
+
+	// 24 bit depth buffer, with or without packed 8 bit stencil, and separate 8 bit stencil buffer:
+	if (fbo->ztexid) bytes += pixels * samples * 4;
+	if (fbo->stexid) bytes += pixels * samples;
+
+	return(bytes);
+}
+
+// Update peak FBO memory consumption of onscreen window 'win':
+static void PsychUpdateFBOPeakBytes(PsychWindowRecordType *win)
+{
+	if (win->fboBytes + win->fboPoolBytes > win->fboPeakBytes) win->fboPeakBytes = win->fboBytes + win->fboPoolBytes;
+}
+
+/* PsychDeleteFBO()
+ * Delete the OpenGL framebuffer object 'fboptr' and all buffers owned by it, and free its PsychFBO struct.
+ */
+static void PsychDeleteFBO(PsychFBO* fboptr)
+{
+	// Detach and delete color buffer texture/renderbuffer. The color buffer of a FBO which doesn't own it, e.g.,
+	// the texture of a regular texture, gets deleted or recycled together with its texture:
+	if (fboptr->coltexid && (fboptr->format != 0)) {
+		if (glIsTexture(fboptr->coltexid)) {
+			// Color buffer is a texture:
+			glDeleteTextures(1, &(fboptr->coltexid));
+		}
+		else {
+			// Color buffer is a renderbuffer:
+			glDeleteRenderbuffersEXT(1, &(fboptr->coltexid));
+		}
+	}
+
+	// Detach and delete depth buffer (and probably stencil buffer) texture, if any:
+	if (fboptr->ztexid) {
+		if (glIsTexture(fboptr->ztexid)) {
+			// Depths buffer is a texture:
+			glDeleteTextures(1, &(fboptr->ztexid));
+		}
+		else {
+			// Depths buffer is a renderbuffer:
+			glDeleteRenderbuffersEXT(1, &(fboptr->ztexid));
+		}
+	}
+
+	// Detach and delete stencil renderbuffer, if a separate stencil buffer was needed:
+	if (fboptr->stexid) glDeleteRenderbuffersEXT(1, &(fboptr->stexid));
+
+	// Delete FBO itself:
+	if (fboptr->fboid) glDeleteFramebuffersEXT(1, &(fboptr->fboid));
+
+	// Delete PsychFBO struct associated with this FBO:
+	free(fboptr);
+}
+
+// Delete the least recently released FBO from the FBO pool of onscreen window 'win':
+static void PsychFBOPoolEvictOldest(PsychWindowRecordType *win)
+{
+	win->fboPoolBytes -= PsychGetFBOSizeBytes(win->fboPool[0]);
+	PsychDeleteFBO(win->fboPool[0]);
+	win->fboPoolCount--;
+	memmove(&(win->fboPool[0]), &(win->fboPool[1]), win->fboPoolCount * sizeof(PsychFBO*));
+	win->fboPoolEvictions++;
+}
+
+/* PsychCreatePooledFBO()
+ * Create a FBO like PsychCreateFBO() for an offscreen window or texture which belongs to the onscreen window of
+ * 'parentWindow', but recycle a FBO of identical size, color format, multisampling level and depth buffer setup from the
+ * FBO pool of the onscreen window if possible. The buffers of a recycled FBO are cleared. 'fboInternalFormat' must be a
+ * real format, not 0 or 1. PsychShutdownImagingPipeline() returns the FBO to the pool when the window gets closed.
+ */
+psych_bool PsychCreatePooledFBO(PsychWindowRecordType *parentWindow, PsychFBO** fbo, GLenum fboInternalFormat, psych_bool needzbuffer, int width, int height, int multisample)
+{
+	PsychFBO*	pooled;
+	int			i;
+
+	parentWindow = PsychGetParentWindow(parentWindow);
+
+	// Search most recently released FBO's first, they are the most likely ones to be still resident in VRAM:
+	for (i = parentWindow->fboPoolCount - 1; i >= 0; i--) {
+		pooled = parentWindow->fboPool[i];
+		if ((pooled->format == fboInternalFormat) && ((pooled->ztexid != 0) == (needzbuffer != FALSE)) &&
+			(pooled->width == width) && (pooled->height == height) && (pooled->multisample == multisample)) {
+			parentWindow->fboPoolBytes -= PsychGetFBOSizeBytes(pooled);
+			parentWindow->fboPoolCount--;
+			memmove(&(parentWindow->fboPool[i]), &(parentWindow->fboPool[i+1]), (parentWindow->fboPoolCount - i) * sizeof(PsychFBO*));
+			parentWindow->fboPoolHits++;
+			parentWindow->fboBytes += PsychGetFBOSizeBytes(pooled);
+
+			// Clear stale content of the previous user:
+			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, pooled->fboid);
+			glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_SCISSOR_BIT);
+			glDisable(GL_SCISSOR_TEST);
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			glDepthMask(GL_TRUE);
+			glStencilMask(~0);
+			glClearColor(0, 0, 0, 0);
+			glClearDepth(1);
+			glClearStencil(0);
+			glClear(GL_COLOR_BUFFER_BIT | ((pooled->ztexid) ? (GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT) : 0));
+			glPopAttrib();
+			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+
+			if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Recycled framebuffer object %i of size %i x %i from FBO pool.\n", pooled->fboid, width, height);
+
+			*fbo = pooled;
+			return(TRUE);
+		}
+	}
+
+	parentWindow->fboPoolMisses++;
+	if (!PsychCreateFBO(fbo, fboInternalFormat, needzbuffer, width, height, multisample)) return(FALSE);
+
+	parentWindow->fboBytes += PsychGetFBOSizeBytes(*fbo);
+	PsychUpdateFBOPeakBytes(parentWindow);
+
+	return(TRUE);
+}
+
+/* PsychReleasePooledFBO()
+ * Return FBO 'fbo' of a closing offscreen window or texture which belongs to the onscreen window of 'parentWindow'
+ * to the FBO pool of the onscreen window for recycling by PsychCreatePooledFBO(). Evicts the least recently released FBO's
+ * as needed to stay within the 'TexturePoolSizeMB' budget. Deletes 'fbo' if it doesn't fit into the budget.
+ */
+static void PsychReleasePooledFBO(PsychWindowRecordType *parentWindow, PsychFBO* fbo)
+{
+	size_t		budget = ((size_t) PsychPrefStateGet_TexturePoolSizeMB()) * 1024 * 1024;
+	size_t		size = PsychGetFBOSizeBytes(fbo);
+	PsychFBO**	newpool;
+
+	parentWindow = PsychGetParentWindow(parentWindow);
+	parentWindow->fboBytes -= (parentWindow->fboBytes > size) ? size : parentWindow->fboBytes;
+
+	// Trim pool to budget, e.g., after a reduction of the budget:
+	while ((parentWindow->fboPoolCount > 0) && (parentWindow->fboPoolBytes > budget)) PsychFBOPoolEvictOldest(parentWindow);
+
+	if (size <= budget) {
+		while (parentWindow->fboPoolBytes + size > budget) PsychFBOPoolEvictOldest(parentWindow);
+
+		if (parentWindow->fboPoolCount == parentWindow->fboPoolCapacity) {
+			newpool = (PsychFBO**) realloc(parentWindow->fboPool, (parentWindow->fboPoolCapacity + 16) * sizeof(PsychFBO*));
+			if (newpool) {
+				parentWindow->fboPool = newpool;
+				parentWindow->fboPoolCapacity += 16;
+			}
+		}
+
+		if (parentWindow->fboPoolCount < parentWindow->fboPoolCapacity) {
+			parentWindow->fboPool[parentWindow->fboPoolCount++] = fbo;
+			parentWindow->fboPoolBytes += size;
+			PsychUpdateFBOPeakBytes(parentWindow);
+			return;
+		}
+	}
+
+	// Doesn't fit into pool:
+	PsychDeleteFBO(fbo);
+}
+
+// Delete all FBO's in the FBO pool of onscreen window 'win' and release the pool:
+static void PsychFreeFBOPool(PsychWindowRecordType *win)
+{
+	while (win->fboPoolCount > 0) PsychFBOPoolEvictOldest(win);
+	free(win->fboPool);
+	win->fboPool = NULL;
+	win->fboPoolCapacity = 0;
+	win->fboPoolBytes = 0;
+}
+
 /* PsychCreateShadowFBOForTexture()
  * Check if provided PTB texture already has a PsychFBO attached. Do nothing if so.
  * If a FBO is missing, create one.
@@ -1832,7 +2531,7 @@ void PsychCreateShadowFBOForTexture(PsychWindowRecordType *textureRecord, psych_
 			// Need 32 bpc floating point precision?
 			if (forImagingmode & kPsychNeed32BPCFloat) { fboInternalFormat = GL_RGBA_FLOAT32_APPLE; textureRecord->bpc = 32; }
 			
-			PsychCreateFBO(&(textureRecord->fboTable[0]), fboInternalFormat, (PsychPrefStateGet_3DGfx() > 0) ? TRUE : FALSE, (int) PsychGetWidthFromRect(textureRecord->rect), (int) PsychGetHeightFromRect(textureRecord->rect), 0);
+			PsychCreatePooledFBO(textureRecord, &(textureRecord->fboTable[0]), fboInternalFormat, (PsychPrefStateGet_3DGfx() > 0) ? TRUE : FALSE, (int) PsychGetWidthFromRect(textureRecord->rect), (int) PsychGetHeightFromRect(textureRecord->rect), 0);
 			
 			// Manually set up the texture id from our color attachment texture id:
 			textureRecord->textureNumber = textureRecord->fboTable[0]->coltexid;
@@ -1991,7 +2690,7 @@ void PsychNormalizeTextureOrientation(PsychWindowRecordType *sourceRecord)
 		}
 		
 		// Now create proper FBO:
-		if (!PsychCreateFBO(&(sourceRecord->fboTable[0]), (GLenum) fboInternalFormat, needzbuffer, width, height, 0)) {
+		if (!PsychCreatePooledFBO(sourceRecord, &(sourceRecord->fboTable[0]), (GLenum) fboInternalFormat, needzbuffer, width, height, 0)) {
 			PsychErrorExitMsg(PsychError_internal, "Failed to normalize texture orientation - Creation of framebuffer object failed!");
 		}
 		
@@ -2067,59 +2766,77 @@ void PsychNormalizeTextureOrientation(PsychWindowRecordType *sourceRecord)
 	return;
 }
 
+/* PsychUnaccountPooledFBO()
+ * Remove FBO 'fbo' from PsychCreatePooledFBO() of offscreen window or texture 'windowRecord' from the memory accounting of
+ * its onscreen window, before it gets deleted without return to the FBO pool. The onscreen window may already be closed if
+ * the FBO lost its OpenGL context, so only onscreen windows which are still open get updated.
+ */
+static void PsychUnaccountPooledFBO(PsychWindowRecordType *windowRecord, PsychFBO* fbo)
+{
+	PsychWindowRecordType	**windowRecordArray;
+	PsychWindowRecordType	*parentWindow = windowRecord;
+	int						i, numWindows;
+	size_t					size = PsychGetFBOSizeBytes(fbo);
+
+	PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);
+	while (parentWindow && parentWindow->parentWindow) {
+		for (i = 0; (i < numWindows) && (windowRecordArray[i] != parentWindow->parentWindow); i++);
+		parentWindow = (i < numWindows) ? parentWindow->parentWindow : NULL;
+	}
+	PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
+
+	if (parentWindow && (parentWindow != windowRecord)) parentWindow->fboBytes -= (parentWindow->fboBytes > size) ? size : parentWindow->fboBytes;
+}
+
 /* PsychShutdownImagingPipeline()
  * Shutdown imaging pipeline for a windowRecord and free all ressources associated with it.
  */
 void PsychShutdownImagingPipeline(PsychWindowRecordType *windowRecord, psych_bool openglpart)
 {
-	int i;
+	int i, j;
 	PtrPsychHookFunction hookfunc, hookiter;
 	PsychFBO* fboptr;
 	
 	// Do OpenGL specific cleanup:
 	if (openglpart) {
-		// Yes. Mode specific cleanup:
+		// Detach native C plugins while their OpenGL context is still available, so they can release
+		// their OpenGL resources. Plugins in the post GL shutdown chain still need to execute, so they
+		// get detached later, when the hook chains are reset:
+		for (i=0; i<MAX_SCREEN_HOOKS; i++) {
+			if (i == kPsychCloseWindowPostGLShutdown) continue;
+			for (hookfunc = windowRecord->HookChain[i]; hookfunc; hookfunc = hookfunc->next) PsychPipelineDetachCFunctionSlot(windowRecord, i, hookfunc);
+		}
+
+		// Offscreen windows and textures return FBO's from PsychCreatePooledFBO() to the FBO pool
+		// of their onscreen window for recycling, as long as its OpenGL context is still alive.
+		// Otherwise they get deleted below, but still need to be removed from the memory accounting
+		// of their onscreen window, if that window still exists:
+		if ((windowRecord->windowType == kPsychTexture) && (windowRecord->fboCount == 1) && (windowRecord->fboTable[0]) && (windowRecord->fboTable[0]->format > 1)) {
+			if (windowRecord->targetSpecific.contextObject) {
+				PsychSetGLContext(windowRecord);
+				PsychReleasePooledFBO(windowRecord, windowRecord->fboTable[0]);
+				windowRecord->fboTable[0] = NULL;
+			}
+			else {
+				PsychUnaccountPooledFBO(windowRecord, windowRecord->fboTable[0]);
+			}
+		}
+
+		// Mode specific cleanup:
 		for (i=0; i<windowRecord->fboCount; i++) {
 			// Delete i'th FBO, if any:
 			fboptr = windowRecord->fboTable[i];
 			if (fboptr!=NULL) { 
 				// Delete all remaining references to this fbo:
-				for (i=0; i<windowRecord->fboCount; i++) if (fboptr == windowRecord->fboTable[i]) windowRecord->fboTable[i] = NULL;
-				
-				// Detach and delete color buffer texture/renderbuffer:
-				if (fboptr->coltexid) {
-					if (glIsTexture(fboptr->coltexid)) {
-						// Color buffer is a texture:
-						glDeleteTextures(1, &(fboptr->coltexid));
-					}
-					else {
-						// Color buffer is a renderbuffer:
-						glDeleteRenderbuffersEXT(1, &(fboptr->coltexid));
-					}
-				}
-
-				// Detach and delete depth buffer (and probably stencil buffer) texture, if any:
-				if (fboptr->ztexid) {
-					if (glIsTexture(fboptr->ztexid)) {
-						// Depths buffer is a texture:
-						glDeleteTextures(1, &(fboptr->ztexid));
-					}
-					else {
-						// Depths buffer is a renderbuffer:
-						glDeleteRenderbuffersEXT(1, &(fboptr->ztexid));
-					}
-				}
+				for (j=0; j<windowRecord->fboCount; j++) if (fboptr == windowRecord->fboTable[j]) windowRecord->fboTable[j] = NULL;
 
-				// Detach and delete stencil renderbuffer, if a separate stencil buffer was needed:
-				if (fboptr->stexid) glDeleteRenderbuffersEXT(1, &(fboptr->stexid));
-
-				// Delete FBO itself:
-				if (fboptr->fboid) glDeleteFramebuffersEXT(1, &(fboptr->fboid));
-				
-				// Delete PsychFBO struct associated with this FBO:
-				free(fboptr); fboptr = NULL;
+				// Delete it:
+				PsychDeleteFBO(fboptr);
 			}
 		}
+
+		// Delete FBO pool of an onscreen window:
+		if (PsychIsOnscreenWindow(windowRecord)) PsychFreeFBOPool(windowRecord);
 	} 
 
 	// The following cleanup must only happen after OpenGL rendering context is already detached and
@@ -2231,6 +2948,268 @@ PsychHookFunction* PsychAddNewHookFunction(PsychWindowRecordType *windowRecord,
 	return(hookfunc);
 }
 
+/* PsychPipelineCompileBlitterParams() - Pre-parse blitter config string of a hook slot.
+ * Resolves the override blitter, texture bindings and blitter parameters from the hookfunc->pString1
+ * of a shader slot or Builtin:IdentityBlit slot, so PsychPipelineExecuteBlitter() and the blitters
+ * don't need to parse it at each execution.
+ */
+static void PsychPipelineCompileBlitterParams(PsychHookFunction* hookfunc)
+{
+	char* strp;
+	int texunit, texid, i;
+	const char* texSpecs[4] = { "TEXTURE1D", "TEXTURE2D", "TEXTURERECT2D", "TEXTURE3D" };
+	GLenum texTargets[4] = { GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_RECTANGLE_EXT, GL_TEXTURE_3D };
+	char texFormat[32];
+	psych_bool displaylist;
+
+	// Any special override blitter defined in parameter string?
+	if (strstr(hookfunc->pString1, "Blitter:")) {
+		// Standard blitter? This one does a one-to-one copy without special geometric transformations.
+		if (strstr(hookfunc->pString1, "Blitter:IdentityBlit")) hookfunc->blitterfunc = (void*) &PsychBlitterIdentity;
+
+		// Displaylist blitter? This one calls an externally setup OpenGL display list to perform complex geometric transformations:
+		if (strstr(hookfunc->pString1, "Blitter:DisplayListBlit")) hookfunc->blitterfunc = (void*) &PsychBlitterDisplayList;
+
+		// Blitter assigned?
+		if (hookfunc->blitterfunc == NULL) {
+			hookfunc->parseError = "Invalid (unknown) blitter specified in blitter string. Blit aborted.";
+			hookfunc->parseErrorType = PsychError_none;
+			return;
+		}
+	}
+
+	// Blitter specific parameter parse errors are reported with the name of the blitter, which is the identity blitter by default:
+	displaylist = (hookfunc->blitterfunc == (void*) &PsychBlitterDisplayList) ? TRUE : FALSE;
+
+	// Texture bindings, in the same order as they were always applied: 1D, 2D, rectangle, 3D:
+	for (i = 0; i < 4; i++) {
+		sprintf(texFormat, "%s(%%i)=%%i", texSpecs[i]);
+		strp = hookfunc->pString1;
+		while ((strp = strstr(strp, texSpecs[i]))) {
+			if (2 == sscanf(strp, texFormat, &texunit, &texid)) {
+				if (hookfunc->numTextures >= kPsychMaxHookTextures) {
+					hookfunc->parseError = "In PsychPipelineExecuteBlitter(): Too many TEXTUREXXX(unit)=id texture bindings in blitter string! At most 8 are supported.\n";
+					hookfunc->parseErrorType = PsychError_user;
+					return;
+				}
+				hookfunc->texTarget[hookfunc->numTextures] = texTargets[i];
+				hookfunc->texUnit[hookfunc->numTextures] = GL_TEXTURE0_ARB + texunit;
+				hookfunc->texId[hookfunc->numTextures] = (GLuint) texid;
+				hookfunc->numTextures++;
+			}
+			strp++;
+		}
+	}
+
+	// Override width x height for blit:
+	if ((strp = strstr(hookfunc->pString1, "OvrSize:"))) {
+		if (sscanf(strp, "OvrSize:%i:%i", &(hookfunc->ovrWidth), &(hookfunc->ovrHeight)) != 2) {
+			hookfunc->parseError = "In PsychBlitterIdentity(): OvrSize: blit string parameter is invalid! Parse error...\n";
+			hookfunc->parseErrorType = PsychError_internal;
+			return;
+		}
+	}
+
+	// Bilinear filtering of srcfbo1 texture requested?
+	hookfunc->bilinear = (strstr(hookfunc->pString1, "Bilinear")) ? TRUE : FALSE;
+
+	// Integral (x,y) offset for the destination of the blit:
+	if ((strp = strstr(hookfunc->pString1, "Offset:"))) {
+		if (sscanf(strp, "Offset:%i:%i", &(hookfunc->offsetX), &(hookfunc->offsetY)) != 2) {
+			hookfunc->parseError = (displaylist) ? "In PsychBlitterDisplayList(): Offset: blit string parameter is invalid! Parse error...\n" :
+												   "In PsychBlitterIdentity(): Offset: blit string parameter is invalid! Parse error...\n";
+			hookfunc->parseErrorType = PsychError_internal;
+			return;
+		}
+	}
+
+	// Scaling:
+	if ((strp = strstr(hookfunc->pString1, "Scaling:"))) {
+		if (sscanf(strp, "Scaling:%f:%f", &(hookfunc->scaleX), &(hookfunc->scaleY)) != 2) {
+			hookfunc->parseError = (displaylist) ? "In PsychBlitterDisplayList(): Scaling: blit string parameter is invalid! Parse error...\n" :
+												   "In PsychBlitterIdentity(): Scaling: blit string parameter is invalid! Parse error...\n";
+			hookfunc->parseErrorType = PsychError_internal;
+			return;
+		}
+	}
+
+	// Display list handle for display list blitter:
+	if (displaylist) {
+		if (!(strp = strstr(hookfunc->pString1, "Handle:"))) {
+			hookfunc->parseError = "In PsychBlitterDisplayList(): No display list handle provided or parse-error fetching display list handle!\n";
+			hookfunc->parseErrorType = PsychError_internal;
+			return;
+		}
+		if (sscanf(strp, "Handle:%i", &texid) != 1) {
+			hookfunc->parseError = "In PsychBlitterDisplayList(): Handle: Parse error fetching display list handle!\n";
+			hookfunc->parseErrorType = PsychError_internal;
+			return;
+		}
+		hookfunc->gllist = (GLuint) texid;
+	}
+
+	return;
+}
+
+/* PsychPipelineCompileHookSlot() - Precompile a single hook slot.
+ * Resolves the operation of the slot from its type and idString and pre-parses all parameters from
+ * its parameter string pString1. Parse errors are stored in the slot and reported when the slot
+ * gets executed, just as if the string would be parsed at execution time.
+ */
+static void PsychPipelineCompileHookSlot(PsychHookFunction* hookfunc)
+{
+	char* strp;
+
+	// Reset to defaults:
+	hookfunc->opcode = kPsychHookOpUnknown;
+	hookfunc->parseError = NULL;
+	hookfunc->parseErrorType = PsychError_none;
+	hookfunc->blitterfunc = NULL;
+	hookfunc->numTextures = 0;
+	hookfunc->ovrWidth = hookfunc->ovrHeight = 0;
+	hookfunc->bilinear = FALSE;
+	hookfunc->offsetX = hookfunc->offsetY = 0;
+	hookfunc->scaleX = hookfunc->scaleY = 1.0;
+	hookfunc->gllist = 0;
+	hookfunc->hasYPosition = FALSE;
+
+	switch(hookfunc->hookfunctype) {
+		case kPsychShaderFunc:
+			hookfunc->opcode = kPsychHookOpShader;
+			PsychPipelineCompileBlitterParams(hookfunc);
+		break;
+
+		case kPsychCFunc:
+			hookfunc->opcode = kPsychHookOpCFunc;
+		break;
+
+		case kPsychMFunc:
+			hookfunc->opcode = kPsychHookOpMFunc;
+		break;
+
+		case kPsychBuiltinFunc:
+			if (strcmp(hookfunc->idString, "Builtin:FlipFBOs")==0) {
+				hookfunc->opcode = kPsychHookOpFlipFBOs;
+			}
+			else if (strstr(hookfunc->idString, "Builtin:RestrictToScissorROI")) {
+				hookfunc->opcode = kPsychHookOpScissorROI;
+				if (4!=sscanf(hookfunc->pString1, "%i:%i:%i:%i", &(hookfunc->iParams[0]), &(hookfunc->iParams[1]), &(hookfunc->iParams[2]), &(hookfunc->iParams[3]))) {
+					hookfunc->parseError = "In PsychPipelineExecuteHook: Builtin:RestrictToScissorROI - Parameter parse error in parameter string.";
+					hookfunc->parseErrorType = PsychError_none;
+				}
+			}
+			else if (strstr(hookfunc->idString, "Builtin:IdentityBlit")) {
+				hookfunc->opcode = kPsychHookOpIdentityBlit;
+				PsychPipelineCompileBlitterParams(hookfunc);
+			}
+			else if (strcmp(hookfunc->idString, "Builtin:RenderClutBits++")==0) {
+				hookfunc->opcode = kPsychHookOpClutBitsPlusPlus;
+
+				// Default T-Lock line position is first pixel of second scanline:
+				hookfunc->iParams[0] = 0;
+				hookfunc->iParams[1] = 1;
+
+				// Check for override vertical position for line:
+				if ((strp=strstr(hookfunc->pString1, "yPosition=")) && (sscanf(strp, "yPosition=%i", &(hookfunc->iParams[1]))!=1)) {
+					hookfunc->parseError = "builtin:RenderClutBitsPlusPlus: yPosition parameter for T-Lock line position is invalid! Parse error...\n";
+					hookfunc->parseErrorType = PsychError_user;
+				}
+
+				// Check for override horizontal position for line:
+				if ((strp=strstr(hookfunc->pString1, "xPosition=")) && (sscanf(strp, "xPosition=%i", &(hookfunc->iParams[0]))!=1)) {
+					hookfunc->parseError = "builtin:RenderClutBitsPlusPlus: xPosition parameter for T-Lock line position is invalid! Parse error...\n";
+					hookfunc->parseErrorType = PsychError_user;
+				}
+			}
+			else if (strcmp(hookfunc->idString, "Builtin:RenderClutViaRuntime")==0) {
+				hookfunc->opcode = kPsychHookOpClutViaRuntime;
+			}
+			else if (strcmp(hookfunc->idString, "Builtin:RenderStereoSyncLine")==0) {
+				hookfunc->opcode = kPsychHookOpStereoSyncLine;
+
+				// Defaults: Line at bottom of display, 25% of the width for left eye, 75% for right eye, white:
+				hookfunc->fParams[1] = 0.25;
+				hookfunc->fParams[2] = hookfunc->fParams[3] = hookfunc->fParams[4] = 1.0;
+
+				// Check for override vertical position for sync line:
+				if ((strp=strstr(hookfunc->pString1, "yPosition="))) {
+					hookfunc->hasYPosition = TRUE;
+					if (sscanf(strp, "yPosition=%f", &(hookfunc->fParams[0]))!=1) {
+						hookfunc->parseError = "builtin:RenderStereoSyncLine: yPosition parameter for horizontal stereo blue-sync line position is invalid! Parse error...\n";
+						hookfunc->parseErrorType = PsychError_user;
+					}
+				}
+
+				// Check for override horizontal fraction for sync line:
+				if ((strp=strstr(hookfunc->pString1, "hFraction=")) &&
+					((sscanf(strp, "hFraction=%f", &(hookfunc->fParams[1]))!=1) || (hookfunc->fParams[1] < 0.0) || (hookfunc->fParams[1] > 1.0))) {
+					hookfunc->parseError = "builtin:RenderStereoSyncLine: hFraction parameter for horizontal stereo blue-sync line length is invalid!\n";
+					hookfunc->parseErrorType = PsychError_user;
+				}
+
+				// Check for override color of sync-line:
+				if ((strp=strstr(hookfunc->pString1, "Color=")) && (sscanf(strp, "Color=%f %f %f", &(hookfunc->fParams[2]), &(hookfunc->fParams[3]), &(hookfunc->fParams[4]))!=3)) {
+					hookfunc->parseError = "builtin:RenderStereoSyncLine: Color spec for stereo sync-line is invalid!\n";
+					hookfunc->parseErrorType = PsychError_user;
+				}
+			}
+		break;
+
+		default:
+			PsychErrorExitMsg(PsychError_internal, "In PsychPipelineCompileHookSlot: Unknown (non-existent) hook function type!");
+	}
+
+	return;
+}
+
+/* PsychPipelineReportSlotParseError() - Report parse error of a precompiled hook slot at execution time.
+ * Aborts with the error type stored at compile time, or prints the error and returns FALSE to fail the slot.
+ */
+static psych_bool PsychPipelineReportSlotParseError(PsychHookFunction* hookfunc)
+{
+	if (hookfunc->parseErrorType != PsychError_none) PsychErrorExitMsg((PsychError) hookfunc->parseErrorType, (char*) hookfunc->parseError);
+	if (PsychPrefStateGet_Verbosity()>0) printf("PTB-ERROR: %s [Id='%s' : Params='%s']\n", hookfunc->parseError, hookfunc->idString, hookfunc->pString1);
+	return(FALSE);
+}
+
+/* PsychPipelineCompileHookChain() - Precompile a hook chain after modification.
+ * Translates the linked list of slots of hook chain 'hookidx' into a flat array in chain order,
+ * precompiles each slot and counts the Builtin:FlipFBOs ping-pong swaps of the chain. Must be
+ * called whenever a chain is modified, so PsychPipelineExecuteHook() can execute the chain with
+ * a simple loop over resolved operations, without any string processing.
+ */
+void PsychPipelineCompileHookChain(PsychWindowRecordType *windowRecord, int hookidx)
+{
+	PtrPsychHookFunction hookfunc;
+	int count;
+
+	// Release old compiled chain:
+	free(windowRecord->HookChainCompiled[hookidx]);
+	windowRecord->HookChainCompiled[hookidx] = NULL;
+	windowRecord->HookChainSlotCount[hookidx] = 0;
+	windowRecord->HookChainPingPongs[hookidx] = 0;
+
+	// Count slots:
+	count = 0;
+	for (hookfunc = windowRecord->HookChain[hookidx]; hookfunc; hookfunc = hookfunc->next) count++;
+	if (count == 0) return;
+
+	windowRecord->HookChainCompiled[hookidx] = (PtrPsychHookFunction*) calloc(count, sizeof(PtrPsychHookFunction));
+	if (windowRecord->HookChainCompiled[hookidx] == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Failed to allocate memory for compiled hook chain.");
+
+	// Compile all slots:
+	count = 0;
+	for (hookfunc = windowRecord->HookChain[hookidx]; hookfunc; hookfunc = hookfunc->next) {
+		PsychPipelineCompileHookSlot(hookfunc);
+		if (hookfunc->opcode == kPsychHookOpFlipFBOs) windowRecord->HookChainPingPongs[hookidx]++;
+		windowRecord->HookChainCompiled[hookidx][count++] = hookfunc;
+	}
+
+	windowRecord->HookChainSlotCount[hookidx] = count;
+
+	return;
+}
+
 /* PsychPipelibneDisableHook - Disable named hook chain. */
 void PsychPipelineDisableHook(PsychWindowRecordType *windowRecord, const char* hookString)
 {
@@ -2262,6 +3241,8 @@ void PsychPipelineResetHook(PsychWindowRecordType *windowRecord, const char* hoo
 	while(hookiter) {
 			hookfunc = hookiter;
 			hookiter = hookiter->next;
+			// Detach and unload native C plugin, if any:
+			PsychPipelineReleaseCFunctionSlot(windowRecord, hookidx, hookfunc);
 			// Delete all referenced memory:
 			free(hookfunc->idString);
 			free(hookfunc->pString1);
@@ -2271,6 +3252,7 @@ void PsychPipelineResetHook(PsychWindowRecordType *windowRecord, const char* hoo
 
 	// Null-out hook chain:
 	windowRecord->HookChain[hookidx]=NULL;
+	PsychPipelineCompileHookChain(windowRecord, hookidx);
 	return;
 }
 
@@ -2295,27 +3277,221 @@ void PsychPipelineAddShaderToHook(PsychWindowRecordType *windowRecord, const cha
 	hookfunc->shaderid =  shaderid;
 	hookfunc->pString1 =  (blitterString) ? strdup(blitterString) : strdup("");
 	hookfunc->luttexid1 = luttexid1;
+	PsychPipelineCompileHookChain(windowRecord, PsychGetHookByName(hookString));
 	return;
 }
 
 /* PsychPipelineAddCFunctionToHook()
  * Add a C callback function to a hook chain. The C callback function is executed when the corresponding
- * hook chain slot is executed, passing a set of parameters via a void* struct pointer. The set of parameters
- * is dependent on the exact hook chain, so users of this function must have knowledge of the PTB-3 source code
- * to know what to expect.
+ * hook chain slot is executed, passing a PsychImagingPluginParams struct with the source and destination
+ * FBOs and window info, as defined in PsychImagingPluginAPI.h.
  *
  * windowRecord - Execute for this window/texture.
  * hookString   - Attach to this named chain.
  * idString     - Arbitrary name string for identification (query) and debugging.
  * where        - Where to attach (0=Beginning, 1=End).
- * procPtr		- A void* function pointer which will be cast to a proper function pointer during execution.
+ * procPtr		- A void* function pointer to a PsychImagingPluginFunc.
  */
 void PsychPipelineAddCFunctionToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, void* procPtr)
 {
+	PtrPsychHookFunction hookfunc;
+
+	if (procPtr == NULL) PsychErrorExitMsg(PsychError_user, "AddHook: Invalid NULL function pointer provided for CFunction.");
+
 	// Create and attach proper preinitialized hook function and return pointer to it for further initialization:
-	PtrPsychHookFunction hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychCFunc);
+	hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychCFunc);
 	// Init remaining fields:
 	hookfunc->cprocfunc =  procPtr;
+	PsychPipelineCompileHookChain(windowRecord, PsychGetHookByName(hookString));
+	return;
+}
+
+/* PsychPipelineLoadCPlugin() - Load shared library of a native C plugin.
+ * Tries 'pluginName' as given first, ie., as absolute path or name of a library in the system
+ * library search path, then inside the Psychtoolbox/PsychBasic/PsychPlugins/ folder. Returns
+ * the library handle, or NULL on failure.
+ */
+static void* PsychPipelineLoadCPlugin(const char* pluginName)
+{
+	char pluginPath[FILENAME_MAX];
+	void* plugin;
+
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		plugin = (void*) LoadLibrary(pluginName);
+	#else
+		plugin = dlopen(pluginName, RTLD_NOW | RTLD_LOCAL);
+	#endif
+
+	if ((NULL == plugin) && (strlen(PsychRuntimeGetPsychtoolboxRoot(FALSE)) > 0) &&
+		(strlen(PsychRuntimeGetPsychtoolboxRoot(FALSE)) + strlen(pluginName) + 30 < FILENAME_MAX)) {
+		// Retry inside the PsychPlugins folder:
+		sprintf(pluginPath, "%sPsychBasic/PsychPlugins/%s", PsychRuntimeGetPsychtoolboxRoot(FALSE), pluginName);
+		if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: HookFunction: Trying to load native plugin from following file: [ %s ]\n", pluginPath);
+
+		#if PSYCH_SYSTEM == PSYCH_WINDOWS
+			plugin = (void*) LoadLibrary(pluginPath);
+		#else
+			plugin = dlopen(pluginPath, RTLD_NOW | RTLD_LOCAL);
+		#endif
+	}
+
+	if ((NULL == plugin) && (PsychPrefStateGet_Verbosity() > 0)) {
+		#if PSYCH_SYSTEM == PSYCH_WINDOWS
+			printf("PTB-ERROR: HookFunction: Failed to load native plugin [ %s ]: Error code %i.\n", pluginName, (int) GetLastError());
+		#else
+			printf("PTB-ERROR: HookFunction: Failed to load native plugin [ %s ]: %s\n", pluginName, (const char*) dlerror());
+		#endif
+	}
+
+	return(plugin);
+}
+
+/* PsychPipelineUnloadCPlugin() - Release a library handle returned by PsychPipelineLoadCPlugin(). */
+static void PsychPipelineUnloadCPlugin(void* plugin)
+{
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		FreeLibrary((HMODULE) plugin);
+	#else
+		dlclose(plugin);
+	#endif
+
+	return;
+}
+
+/* PsychPipelineAddCPluginToHook()
+ * Load a native C plugin from a shared library and add its entry point function to a hook chain, like
+ * PsychPipelineAddCFunctionToHook() does for a function given by memory pointer. The library stays loaded
+ * until the slot is removed from the chain.
+ *
+ * windowRecord   - Execute for this window/texture.
+ * hookString     - Attach to this named chain.
+ * idString       - Arbitrary name string for identification (query) and debugging.
+ * where          - Where to attach (0=Beginning, 1=End).
+ * pluginName     - Filename or path of the shared library.
+ * configString   - Configuration string passed to the plugin in each call. NULL for none.
+ * entryPointName - Name of the entry point function. NULL for PSYCH_IMAGING_PLUGIN_ENTRYPOINT.
+ */
+void PsychPipelineAddCPluginToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, const char* pluginName, const char* configString, const char* entryPointName)
+{
+	PtrPsychHookFunction hookfunc;
+	void* plugin;
+	void* procPtr;
+
+	// Validate hook name before loading anything:
+	if (PsychGetHookByName(hookString)==-1) PsychErrorExitMsg(PsychError_user, "AddHook: Unknown (non-existent) hook name provided.");
+	if ((entryPointName == NULL) || (strlen(entryPointName) == 0)) entryPointName = PSYCH_IMAGING_PLUGIN_ENTRYPOINT;
+
+	plugin = PsychPipelineLoadCPlugin(pluginName);
+	if (NULL == plugin) PsychErrorExitMsg(PsychError_user, "AddHook: Failed to load native plugin for CFunction. See error message above.");
+
+	// Resolve entry point:
+	#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		procPtr = (void*) GetProcAddress((HMODULE) plugin, entryPointName);
+	#else
+		procPtr = dlsym(plugin, entryPointName);
+	#endif
+
+	if (NULL == procPtr) {
+		PsychPipelineUnloadCPlugin(plugin);
+		if (PsychPrefStateGet_Verbosity() > 0) printf("PTB-ERROR: HookFunction: Native plugin [ %s ] does not export entry point function '%s'.\n", pluginName, entryPointName);
+		PsychErrorExitMsg(PsychError_user, "AddHook: Failed to find entry point of native plugin for CFunction. See error message above.");
+	}
+
+	// Create and attach proper preinitialized hook function and return pointer to it for further initialization:
+	hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychCFunc);
+	// Init remaining fields:
+	hookfunc->cprocfunc = procPtr;
+	hookfunc->pluginLibrary = plugin;
+	hookfunc->pString1 = (configString) ? strdup(configString) : strdup("");
+	PsychPipelineCompileHookChain(windowRecord, PsychGetHookByName(hookString));
+
+	if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: HookFunction: Native plugin [ %s ] attached as slot '%s' to hook chain '%s'.\n", pluginName, idString, hookString);
+
+	return;
+}
+
+/* PsychPipelineCopyPluginFBO() - Describe a PsychFBO to a native C plugin. NULL fbo's are all-zero. */
+static void PsychPipelineCopyPluginFBO(PsychImagingPluginFBO* pluginfbo, PsychFBO** fbo)
+{
+	memset(pluginfbo, 0, sizeof(PsychImagingPluginFBO));
+	if ((fbo == NULL) || (*fbo == NULL)) return;
+
+	pluginfbo->fboid = (unsigned int) (*fbo)->fboid;
+	pluginfbo->coltexid = (unsigned int) (*fbo)->coltexid;
+	pluginfbo->width = (*fbo)->width;
+	pluginfbo->height = (*fbo)->height;
+	pluginfbo->multisample = (*fbo)->multisample;
+
+	return;
+}
+
+/* PsychPipelineCallCFunction() - Call native C plugin function of a CFunction hook slot.
+ * Sets up the PsychImagingPluginParams for 'command' and calls the function. Returns TRUE on success,
+ * FALSE if the plugin reported failure.
+ */
+static psych_bool PsychPipelineCallCFunction(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc, int command, void* hookUserData, PsychFBO** srcfbo1, PsychFBO** srcfbo2, PsychFBO** dstfbo, PsychFBO** bouncefbo)
+{
+	PsychImagingPluginParams params;
+	int rc;
+
+	memset(&params, 0, sizeof(params));
+	params.apiVersion = PSYCH_IMAGING_PLUGIN_API_VERSION;
+	params.command = command;
+	params.hookId = hookId;
+	params.hookName = PsychHookPointNames[hookId];
+	params.idString = hookfunc->idString;
+	params.configString = (hookfunc->pString1) ? hookfunc->pString1 : "";
+	params.windowHandle = windowRecord->windowIndex;
+	params.windowWidth = (int) PsychGetWidthFromRect(windowRecord->rect);
+	params.windowHeight = (int) PsychGetHeightFromRect(windowRecord->rect);
+	params.stereoMode = windowRecord->stereomode;
+	params.flipCount = windowRecord->flipCount;
+	params.videoRefreshInterval = windowRecord->VideoRefreshInterval;
+	PsychPipelineCopyPluginFBO(&params.srcfbo1, srcfbo1);
+	PsychPipelineCopyPluginFBO(&params.srcfbo2, srcfbo2);
+	PsychPipelineCopyPluginFBO(&params.dstfbo, dstfbo);
+	PsychPipelineCopyPluginFBO(&params.bouncefbo, bouncefbo);
+	params.hookUserData = hookUserData;
+	params.pluginData = hookfunc->pluginData;
+
+	rc = ((PsychImagingPluginFunc) hookfunc->cprocfunc)(&params);
+
+	// Keep plugins private data for next invocation:
+	hookfunc->pluginData = params.pluginData;
+
+	if (rc != 0) {
+		if (PsychPrefStateGet_Verbosity() > 0) printf("PTB-ERROR: Native CFunction plugin in slot '%s' of hook chain '%s' failed with error code %i.\n", hookfunc->idString, PsychHookPointNames[hookId], rc);
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+/* PsychPipelineDetachCFunctionSlot() - Send kPsychImagingPluginDetach to a CFunction slot, unless already done. */
+static void PsychPipelineDetachCFunctionSlot(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc)
+{
+	if ((hookfunc->hookfunctype != kPsychCFunc) || (hookfunc->pluginDetached)) return;
+
+	hookfunc->pluginDetached = TRUE;
+	PsychPipelineCallCFunction(windowRecord, hookId, hookfunc, kPsychImagingPluginDetach, NULL, NULL, NULL, NULL, NULL);
+	hookfunc->pluginData = NULL;
+
+	return;
+}
+
+/* PsychPipelineReleaseCFunctionSlot() - Detach a CFunction slot and unload its plugin library, if any. */
+static void PsychPipelineReleaseCFunctionSlot(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc)
+{
+	if (hookfunc->hookfunctype != kPsychCFunc) return;
+
+	PsychPipelineDetachCFunctionSlot(windowRecord, hookId, hookfunc);
+
+	if (hookfunc->pluginLibrary) {
+		PsychPipelineUnloadCPlugin(hookfunc->pluginLibrary);
+		hookfunc->pluginLibrary = NULL;
+	}
+	hookfunc->cprocfunc = NULL;
+
 	return;
 }
 
@@ -2340,6 +3516,7 @@ void PsychPipelineAddRuntimeFunctionToHook(PsychWindowRecordType *windowRecord,
 	PtrPsychHookFunction hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychMFunc);
 	// Init remaining fields:
 	hookfunc->pString1 =  (evalString) ? strdup(evalString) : strdup("");
+	PsychPipelineCompileHookChain(windowRecord, PsychGetHookByName(hookString));
 	return;
 }
 
@@ -2360,6 +3537,7 @@ void PsychPipelineAddBuiltinFunctionToHook(PsychWindowRecordType *windowRecord,
 	PtrPsychHookFunction hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychBuiltinFunc);
 	// Init remaining fields:
 	hookfunc->pString1 =  (configString) ? strdup(configString) : strdup("");
+	PsychPipelineCompileHookChain(windowRecord, PsychGetHookByName(hookString));
 	return;
 }
 
@@ -2392,12 +3570,18 @@ void PsychPipelineDeleteHookSlot(PsychWindowRecordType *windowRecord, const char
 	// Detach it from hookchain, update predecessors next pointer so it points to successor:
 	*prehookfunc = hookfunc->next;
 	
-	// Detached. Delete hookfunc:
+	// Detached. Detach and unload native C plugin, if any:
+	PsychPipelineReleaseCFunctionSlot(windowRecord, hookidx, hookfunc);
+
+	// Delete hookfunc:
 	free(hookfunc->pString1);
 	free(hookfunc->idString);
 	free(hookfunc);
 	hookfunc = NULL;
 	
+	// Recompile remaining chain:
+	PsychPipelineCompileHookChain(windowRecord, hookidx);
+
 	// Done.
 	return;
 }
@@ -2513,7 +3697,7 @@ void PsychPipelineDumpHook(PsychWindowRecordType *windowRecord, const char* hook
 			break;
 			
 			case kPsychCFunc:
-				printf("C-Callback       : void*= %p\n", hookfunc->cprocfunc);
+				printf("C-Callback       : void*= %p , %s , config=%s\n", hookfunc->cprocfunc, (hookfunc->pluginLibrary) ? "plugin" : "pointer", (hookfunc->pString1) ? hookfunc->pString1 : "");
 			break;
 
 			case kPsychMFunc:
@@ -2566,13 +3750,14 @@ psych_bool PsychIsHookChainOperational(PsychWindowRecordType *windowRecord, int
 /* PsychPipelineExecuteHook()
  * Execute the full hook processing chain for a specific hook and a specific windowRecord.
  * This checks if the chain is enabled. If it isn't enabled, it skips processing.
- * If it is enabled, it iterates over the full chain, executes all assigned hook functions in order and uses the FBO's between minfbo and maxfbo
+ * If it is enabled, it iterates over the precompiled chain, executes all assigned hook functions in order and uses the FBO's between minfbo and maxfbo
  * as pingpong buffers if neccessary.
  */
 psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hookId, void* hookUserData, void* hookBlitterFunction, psych_bool srcIsReadonly, psych_bool allowFBOSwizzle, PsychFBO** srcfbo1, PsychFBO** srcfbo2, PsychFBO** dstfbo, PsychFBO** bouncefbo)
 {
 	PtrPsychHookFunction hookfunc;
-	int i=0;
+	PtrPsychHookFunction *hookslots;
+	int i, slotcount;
 	int pendingFBOpingpongs = 0;
 	PsychFBO *mysrcfbo1, *mysrcfbo2, *mydstfbo, *mynxtfbo;
 	PsychFBO **bouncefbo2;
@@ -2580,7 +3765,6 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 	GLint restorefboid = 0;
 	psych_bool scissor_ignore = FALSE;
 	psych_bool scissor_enabled = FALSE;
-	int sciss_x, sciss_y, sciss_w, sciss_h;
 
 	// Child protection:
 	if (hookId<0 || hookId>=MAX_SCREEN_HOOKS) PsychErrorExitMsg(PsychError_internal, "In PsychPipelineExecuteHook: Was asked to execute unknown (non-existent) hook chain with invalid id!");
@@ -2594,16 +3778,10 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 	// Is this an image processing hook?
 	gfxprocessing = (dstfbo!=NULL) ? TRUE : FALSE;
 
-	// Get start of enabled chain:
-	hookfunc = windowRecord->HookChain[hookId];
-
-	// Count number of needed ping-pong FBO switches inside this chain:
-	while(hookfunc) {
-		// Pingpong command?
-		if (hookfunc->hookfunctype == kPsychBuiltinFunc && strcmp(hookfunc->idString, "Builtin:FlipFBOs")==0) pendingFBOpingpongs++;
-		// Process next hookfunc slot in chain, if any:
-		hookfunc = hookfunc->next;
-	}
+	// Get precompiled slots of enabled chain and number of needed ping-pong FBO switches inside this chain:
+	hookslots = windowRecord->HookChainCompiled[hookId];
+	slotcount = windowRecord->HookChainSlotCount[hookId];
+	pendingFBOpingpongs = windowRecord->HookChainPingPongs[hookId];
 
 	if (gfxprocessing) {
 		// Prepare gfx-processing:
@@ -2669,12 +3847,10 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 		PsychPipelineSetupRenderFlow(mysrcfbo1, mysrcfbo2, mydstfbo, scissor_ignore);
 	}
 
-	
-	// Reget start of enabled chain:
-	hookfunc = windowRecord->HookChain[hookId];
-
 	// Iterate over all slots:
-	while(hookfunc) {
+	for (i = 0; i < slotcount; i++) {
+		hookfunc = hookslots[i];
+
 		// Debug output, if requested:
 		if (PsychPrefStateGet_Verbosity()>4) {
 			printf("Hookchain '%s' : Slot %i: Id='%s' : ", PsychHookPointNames[hookId], i, hookfunc->idString);
@@ -2684,7 +3860,7 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 					break;
 					
 				case kPsychCFunc:
-					printf("C-Callback       : void*= %p\n", hookfunc->cprocfunc);
+					printf("C-Callback       : void*= %p , %s , config=%s\n", hookfunc->cprocfunc, (hookfunc->pluginLibrary) ? "plugin" : "pointer", (hookfunc->pString1) ? hookfunc->pString1 : "");
 					break;
 					
 				case kPsychMFunc:
@@ -2698,7 +3874,7 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 		}
 		
 		// Is this a ping-pong command?
-		if (hookfunc->hookfunctype == kPsychBuiltinFunc && strcmp(hookfunc->idString, "Builtin:FlipFBOs")==0) {
+		if (hookfunc->opcode == kPsychHookOpFlipFBOs) {
 			// Ping pong buffer swap requested:
 			pendingFBOpingpongs--;
 			mysrcfbo1 = mydstfbo;
@@ -2723,16 +3899,13 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 		}
 		else {
 			// Restricted area processing?
-			if (hookfunc->hookfunctype == kPsychBuiltinFunc && strstr(hookfunc->idString, "Builtin:RestrictToScissorROI")) {
+			if (hookfunc->opcode == kPsychHookOpScissorROI) {
 				// Restrict pixel processing to specified region of interest ROI by setting
 				// up a proper scissor rectangle and enabling scissor tests. The special
 				// ROI (-1,-1,-1,-1) means: Disable scissor testing -> Unrestrict. 
-				if (4!=sscanf(hookfunc->pString1, "%i:%i:%i:%i", &sciss_x, &sciss_y, &sciss_w, &sciss_h)) {
-					if (PsychPrefStateGet_Verbosity()>0) printf("PTB-ERROR: In PsychPipelineExecuteHook: Builtin:RestrictToScissorROI - Parameter parse error in string %s\n", hookfunc->idString);
-					return(FALSE);
-				}
+				if (hookfunc->parseError) return(PsychPipelineReportSlotParseError(hookfunc));
 				
-				if (sciss_x==-1 && sciss_y==-1 && sciss_w==-1 && sciss_h==-1) {
+				if (hookfunc->iParams[0]==-1 && hookfunc->iParams[1]==-1 && hookfunc->iParams[2]==-1 && hookfunc->iParams[3]==-1) {
 					// Disable scissor tests:
 					glDisable(GL_SCISSOR_TEST);
 					scissor_ignore = FALSE;
@@ -2740,7 +3913,7 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 				else {
 					// Setup and enable scissor test:
 					glEnable(GL_SCISSOR_TEST);
-					glScissor(sciss_x, sciss_y, sciss_w, sciss_h);
+					glScissor(hookfunc->iParams[0], hookfunc->iParams[1], hookfunc->iParams[2], hookfunc->iParams[3]);
 					// Make sure PsychSetupRenderFlow() ignores scissor setup:
 					scissor_ignore = TRUE;
 				}
@@ -2756,10 +3929,6 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 				}
 			}
 		}
-		
-		// Process next hookfunc slot in chain, if any:
-		i++;
-		hookfunc = hookfunc->next;
 	}
 
 	if (gfxprocessing) {
@@ -2923,8 +4092,14 @@ psych_bool PsychPipelineExecuteHookSlot(PsychWindowRecordType *windowRecord, int
 		break;
 			
 		case kPsychCFunc:
-			// Call a C callback function via the given memory function pointer:
-			printf("TODO: EXECUTE -- C-Callback       : void*= %p\n", hookfunc->cprocfunc);
+			// Call a native C plugin function via the PsychImagingPluginAPI.h interface. It does its own
+			// rendering into dstfbo, with srcfbo1 and srcfbo2 bound as textures by the render flow setup:
+			if (!hookfunc->pluginDetached) {
+				if (!PsychPipelineCallCFunction(windowRecord, hookId, hookfunc, kPsychImagingPluginExecute, hookUserData, srcfbo1, srcfbo2, dstfbo, bouncefbo)) {
+					// Plugin failed!
+					return(FALSE);
+				}
+			}
 			dispatched=TRUE;
 		break;
 			
@@ -2945,52 +4120,55 @@ psych_bool PsychPipelineExecuteHookSlot(PsychWindowRecordType *windowRecord, int
 		break;
 			
 		case kPsychBuiltinFunc:
-			// Dispatch to a builtin function:
-
-			if (strcmp(hookfunc->idString, "Builtin:FlipFBOs")==0) { dispatched=TRUE; } // No op here. Done in upper layer...
-			if (strstr(hookfunc->idString, "Builtin:RestrictToScissorROI")) { dispatched=TRUE; } // No op here. Done in upper layer...
-
-			if (strstr(hookfunc->idString, "Builtin:IdentityBlit")) {
-				// Perform the most simple blit operation: A simple one-to-one copy of input FBO to output FBO:
-				if (!PsychPipelineExecuteBlitter(windowRecord, hookfunc, NULL, NULL, TRUE, FALSE, srcfbo1, NULL, dstfbo, NULL)) {
-					// Blitter failed!
-					return(FALSE);
-				}
-				dispatched=TRUE;
-			}
-
-			if (strcmp(hookfunc->idString, "Builtin:RenderClutBits++")==0) {
-				// Compute the T-Lock encoded CLUT for Cambridge Research Bits++ system in Bits++ mode. The CLUT
-				// is set via the standard Screen('LoadNormalizedGammaTable', ..., loadOnNextFlip) call by setting
-				// loadOnNextFlip to a value of 2.
-				if (!PsychPipelineBuiltinRenderClutBitsPlusPlus(windowRecord, hookfunc)) {
-					// Operation failed!
-					return(FALSE);
-				}
-				dispatched=TRUE;
-			}
-
-			if (strcmp(hookfunc->idString, "Builtin:RenderClutViaRuntime")==0) {
-				// Pass the last CLUT that was set via the standard Screen('LoadNormalizedGammaTable', ..., loadOnNextFlip) call by setting
-				// loadOnNextFlip to a value of 2 to the runtime environment.
-				if (!PsychPipelineBuiltinRenderClutViaRuntime(windowRecord, hookfunc)) {
-					// Operation failed!
-					return(FALSE);
-				}
-				dispatched=TRUE;
-			}
-			
-			if (strcmp(hookfunc->idString, "Builtin:RenderStereoSyncLine")==0) {
-				// Draw a blue-line-sync sync line at the bottom of the current framebuffer. This is needed
-				// to drive stereo shutter glasses with blueline-sync in quad-buffered frame-sequential stereo
-				// mode.
-				if (!PsychPipelineBuiltinRenderStereoSyncLine(windowRecord, hookId, hookfunc)) {
-					// Operation failed!
-					return(FALSE);
-				}
-				dispatched=TRUE;
+			// Dispatch to a builtin function, as resolved by PsychPipelineCompileHookChain():
+			switch(hookfunc->opcode) {
+				case kPsychHookOpFlipFBOs:
+				case kPsychHookOpScissorROI:
+					// No op here. Done in upper layer...
+					dispatched=TRUE;
+				break;
+
+				case kPsychHookOpIdentityBlit:
+					// Perform the most simple blit operation: A simple one-to-one copy of input FBO to output FBO:
+					if (!PsychPipelineExecuteBlitter(windowRecord, hookfunc, NULL, NULL, TRUE, FALSE, srcfbo1, NULL, dstfbo, NULL)) {
+						// Blitter failed!
+						return(FALSE);
+					}
+					dispatched=TRUE;
+				break;
+
+				case kPsychHookOpClutBitsPlusPlus:
+					// Compute the T-Lock encoded CLUT for Cambridge Research Bits++ system in Bits++ mode. The CLUT
+					// is set via the standard Screen('LoadNormalizedGammaTable', ..., loadOnNextFlip) call by setting
+					// loadOnNextFlip to a value of 2.
+					if (!PsychPipelineBuiltinRenderClutBitsPlusPlus(windowRecord, hookfunc)) {
+						// Operation failed!
+						return(FALSE);
+					}
+					dispatched=TRUE;
+				break;
+
+				case kPsychHookOpClutViaRuntime:
+					// Pass the last CLUT that was set via the standard Screen('LoadNormalizedGammaTable', ..., loadOnNextFlip) call by setting
+					// loadOnNextFlip to a value of 2 to the runtime environment.
+					if (!PsychPipelineBuiltinRenderClutViaRuntime(windowRecord, hookfunc)) {
+						// Operation failed!
+						return(FALSE);
+					}
+					dispatched=TRUE;
+				break;
+
+				case kPsychHookOpStereoSyncLine:
+					// Draw a blue-line-sync sync line at the bottom of the current framebuffer. This is needed
+					// to drive stereo shutter glasses with blueline-sync in quad-buffered frame-sequential stereo
+					// mode.
+					if (!PsychPipelineBuiltinRenderStereoSyncLine(windowRecord, hookId, hookfunc)) {
+						// Operation failed!
+						return(FALSE);
+					}
+					dispatched=TRUE;
+				break;
 			}
-
 		break;
 			
 		default:
@@ -3010,6 +4188,11 @@ void PsychPipelineSetupRenderFlow(PsychFBO* srcfbo1, PsychFBO* srcfbo2, PsychFBO
 	static int ow=0;
 	static int oh=0;
 	int w, h;
+	psych_bool cached;
+
+	// The cached viewport size is only valid for the OpenGL contexts of the master thread. The flipper thread
+	// of async flips executes hook chains in its own context, so it must always setup its viewport:
+	cached = PsychIsMasterThread();
 
 	// Select rendertarget:
 	if (glBindFramebufferEXT) glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, (dstfbo) ? dstfbo->fboid : 0);
@@ -3078,9 +4261,11 @@ void PsychPipelineSetupRenderFlow(PsychFBO* srcfbo1, PsychFBO* srcfbo2, PsychFBO
 		}
 
 		// Settings changed? We skip if not - state changes are expensive...
-		if (w!=ow || h!=oh) {
-			ow=w;
-			oh=h;
+		if (w!=ow || h!=oh || !cached) {
+			if (cached) {
+				ow=w;
+				oh=h;
+			}
 			
 			// Setup viewport and scissor for full FBO area:
 			glViewport(0, 0, w, h);
@@ -3095,7 +4280,7 @@ void PsychPipelineSetupRenderFlow(PsychFBO* srcfbo1, PsychFBO* srcfbo2, PsychFBO
 			glMatrixMode(GL_MODELVIEW);
 		}
 	}
-	else {
+	else if (cached) {
 		// Reset our cached settings:
 		ow=0;
 		oh=0;
@@ -3109,32 +4294,19 @@ psych_bool PsychPipelineExecuteBlitter(PsychWindowRecordType *windowRecord, Psyc
 	psych_bool rc = TRUE;
 	PsychBlitterFunc blitterfnc = NULL;
 	GLenum glerr;
-	char*  pstrpos = NULL;
-	int texunit, texid;
+	int i;
 	
+	// Blitter string failed to parse at compile time?
+	if (hookfunc->parseError) return(PsychPipelineReportSlotParseError(hookfunc));
+
 	// Select proper blitter function:
 	
 	// Initialize with master blitter function (if any). If none set,
 	// this will init to NULL:
 	blitterfnc = hookBlitterFunction;
 	
-	// Any special override blitter defined in parameter string?
-	if (strstr(hookfunc->pString1, "Blitter:")) {
-		// Yes. Which one?
-		blitterfnc = NULL;
-		
-		// Standard blitter? This one does a one-to-one copy without special geometric transformations.
-		if (strstr(hookfunc->pString1, "Blitter:IdentityBlit")) blitterfnc = &PsychBlitterIdentity; // Assign our standard one-to-one blitter.
-		
-		// Displaylist blitter? This one calls an externally setup OpenGL display list to perform complex geometric transformations:
-		if (strstr(hookfunc->pString1, "Blitter:DisplayListBlit")) blitterfnc = &PsychBlitterDisplayList;
-
-		// Blitter assigned?
-		if (blitterfnc == NULL) {
-			if (PsychPrefStateGet_Verbosity()>0) printf("PTB-ERROR: Invalid (unknown) blitter specified in blitter string. Blit aborted.\n");
-			return(FALSE);
-		}
-	}
+	// Any special override blitter defined in parameter string? Resolved by PsychPipelineCompileHookChain():
+	if (hookfunc->blitterfunc) blitterfnc = (PsychBlitterFunc) hookfunc->blitterfunc;
 	
 	if (blitterfnc == NULL) {
 		// No blitter set up to now. Assign the default blitter:
@@ -3143,52 +4315,12 @@ psych_bool PsychPipelineExecuteBlitter(PsychWindowRecordType *windowRecord, Psyc
 	
 	// TODO: Common setup code for texturing, filtering, alpha blending, z-test and such...
 	
-	// Setup code for 1D textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURE1D")) {
-		if (2==sscanf(pstrpos, "TEXTURE1D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glEnable(GL_TEXTURE_1D);
-			glBindTexture(GL_TEXTURE_1D, texid);
-			if (PsychPrefStateGet_Verbosity()>4) printf("PTB-DEBUG: Binding gltexid %i to GL_TEXTURE_1D target of texunit %i\n", texid, texunit);
-		}
-		pstrpos++;
-	}
-
-	// Setup code for 2D textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURE2D")) {
-		if (2==sscanf(pstrpos, "TEXTURE2D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glEnable(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, texid);
-			if (PsychPrefStateGet_Verbosity()>4) printf("PTB-DEBUG: Binding gltexid %i to GL_TEXTURE_2D target of texunit %i\n", texid, texunit);
-		}
-		pstrpos++;
-	}
-
-	// Setup code for 2D rectangle textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURERECT2D")) {
-		if (2==sscanf(pstrpos, "TEXTURERECT2D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glEnable(GL_TEXTURE_RECTANGLE_EXT);
-			glBindTexture(GL_TEXTURE_RECTANGLE_EXT, texid);
-			if (PsychPrefStateGet_Verbosity()>4) printf("PTB-DEBUG: Binding gltexid %i to GL_TEXTURE_RECTANGLE_EXT target of texunit %i\n", texid, texunit);
-		}
-		pstrpos++;
-	}
-
-	// Setup code for 3D textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURE3D")) {
-		if (2==sscanf(pstrpos, "TEXTURE3D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glEnable(GL_TEXTURE_3D);
-			glBindTexture(GL_TEXTURE_3D, texid);
-			if (PsychPrefStateGet_Verbosity()>4) printf("PTB-DEBUG: Binding gltexid %i to GL_TEXTURE_3D target of texunit %i\n", texid, texunit);
-		}
-		pstrpos++;
+	// Setup code for 1D, 2D, rectangle and 3D textures, as specified in blitter string:
+	for (i = 0; i < hookfunc->numTextures; i++) {
+		glActiveTextureARB(hookfunc->texUnit[i]);
+		glEnable(hookfunc->texTarget[i]);
+		glBindTexture(hookfunc->texTarget[i], hookfunc->texId[i]);
+		if (PsychPrefStateGet_Verbosity()>4) printf("PTB-DEBUG: Binding gltexid %i to texture target %x of texunit %i\n", hookfunc->texId[i], hookfunc->texTarget[i], hookfunc->texUnit[i] - GL_TEXTURE0_ARB);
 	}
 
 	glActiveTextureARB(GL_TEXTURE0_ARB);
@@ -3231,48 +4363,11 @@ psych_bool PsychPipelineExecuteBlitter(PsychWindowRecordType *windowRecord, Psyc
 	
 	// TODO: Common teardown code for texturing, filtering and such...
 
-	// Teardown code for 1D textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURE1D")) {
-		if (2==sscanf(pstrpos, "TEXTURE1D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glBindTexture(GL_TEXTURE_1D, 0);
-			glDisable(GL_TEXTURE_1D);
-		}
-		pstrpos++;
-	}
-
-	// Teardown code for 2D textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURE2D")) {
-		if (2==sscanf(pstrpos, "TEXTURE2D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glDisable(GL_TEXTURE_2D);
-		}
-		pstrpos++;
-	}
-
-	// Teardown code for 2D rectangle textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURERECT2D")) {
-		if (2==sscanf(pstrpos, "TEXTURERECT2D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glBindTexture(GL_TEXTURE_RECTANGLE_EXT, 0);
-			glDisable(GL_TEXTURE_RECTANGLE_EXT);
-		}
-		pstrpos++;
-	}
-
-	// Teardown code for 3D textures:
-	pstrpos = hookfunc->pString1;
-	while (pstrpos=strstr(pstrpos, "TEXTURE3D")) {
-		if (2==sscanf(pstrpos, "TEXTURE3D(%i)=%i", &texunit, &texid)) {
-			glActiveTextureARB(GL_TEXTURE0_ARB + texunit);
-			glBindTexture(GL_TEXTURE_3D, 0);
-			glDisable(GL_TEXTURE_3D);
-		}
-		pstrpos++;
+	// Teardown code for textures:
+	for (i = 0; i < hookfunc->numTextures; i++) {
+		glActiveTextureARB(hookfunc->texUnit[i]);
+		glBindTexture(hookfunc->texTarget[i], 0);
+		glDisable(hookfunc->texTarget[i]);
 	}
 
 	glActiveTextureARB(GL_TEXTURE0_ARB);
@@ -3294,7 +4389,6 @@ psych_bool PsychBlitterIdentity(PsychWindowRecordType *windowRecord, PsychHookFu
 {
 	int w, h, x, y;
 	float sx, sy;
-	char* strp;
 	psych_bool bilinearfiltering;
 
 	// Child protection:
@@ -3309,15 +4403,13 @@ psych_bool PsychBlitterIdentity(PsychWindowRecordType *windowRecord, PsychHookFu
 	// Check for override width x height parameter in the blitterString: An integral (w,h)
 	// size the blit. This allows to blit a target quad with a size different from srcfbo1, without
 	// scaling or filtering it. Mostly useful in conjunction with specific shaders.
-	if (strp=strstr(hookfunc->pString1, "OvrSize:")) {
-		// Parse and assign offset:
-		if (sscanf(strp, "OvrSize:%i:%i", &w, &h)!=2) {
-			PsychErrorExitMsg(PsychError_internal, "In PsychBlitterIdentity(): OvrSize: blit string parameter is invalid! Parse error...\n");
-		}
+	if (hookfunc->ovrWidth > 0 || hookfunc->ovrHeight > 0) {
+		w = hookfunc->ovrWidth;
+		h = hookfunc->ovrHeight;
 	}
 
 	// Bilinear filtering of srcfbo1 texture requested?
-	if (strstr(hookfunc->pString1, "Bilinear")) {
+	if (hookfunc->bilinear) {
 		// Yes. Enable it.
 		bilinearfiltering = TRUE;
 		glTexParameteri(GL_TEXTURE_RECTANGLE_EXT, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -3330,22 +4422,12 @@ psych_bool PsychBlitterIdentity(PsychWindowRecordType *windowRecord, PsychHookFu
 	// Check for offset parameter in the blitterString: An integral (x,y)
 	// offset for the destination of the blit. This allows to blit the srcfbo1, without
 	// scaling or filtering it, to a different start location than (0,0):
-	x=y=0;
-	if (strp=strstr(hookfunc->pString1, "Offset:")) {
-		// Parse and assign offset:
-		if (sscanf(strp, "Offset:%i:%i", &x, &y)!=2) {
-			PsychErrorExitMsg(PsychError_internal, "In PsychBlitterIdentity(): Offset: blit string parameter is invalid! Parse error...\n");
-		}
-	}
+	x = hookfunc->offsetX;
+	y = hookfunc->offsetY;
 
-	// Check for scaling parameter:
-	sx = sy = 1.0;
-	if (strp=strstr(hookfunc->pString1, "Scaling:")) {
-		// Parse and assign offset:
-		if (sscanf(strp, "Scaling:%f:%f", &sx, &sy)!=2) {
-			PsychErrorExitMsg(PsychError_internal, "In PsychBlitterIdentity(): Scaling: blit string parameter is invalid! Parse error...\n");
-		}
-	}
+	// Scaling parameter:
+	sx = hookfunc->scaleX;
+	sy = hookfunc->scaleY;
 
 	if (x!=0 || y!=0 || sx!=1.0 || sy!=1.0) {
 		glMatrixMode(GL_MODELVIEW);
@@ -3414,7 +4496,6 @@ psych_bool PsychBlitterDisplayList(PsychWindowRecordType *windowRecord, PsychHoo
 	int x, y;
 	GLuint gllist;
 	float sx, sy;
-	char* strp;
 	psych_bool bilinearfiltering;
 	
 	// Child protection:
@@ -3423,21 +4504,13 @@ psych_bool PsychBlitterDisplayList(PsychWindowRecordType *windowRecord, PsychHoo
 	}	
 
 	// Query display list handle:
-	if (strp=strstr(hookfunc->pString1, "Handle:")) {
-		// Parse and assign offset:
-		if (sscanf(strp, "Handle:%i", &gllist)!=1) {
-			PsychErrorExitMsg(PsychError_internal, "In PsychBlitterDisplayList(): Handle: Parse error fetching display list handle!\n");
-		}
-	}
-	else {
-		PsychErrorExitMsg(PsychError_internal, "In PsychBlitterDisplayList(): No display list handle provided or parse-error fetching display list handle!\n");
-	}
+	gllist = hookfunc->gllist;
 	
 	// Handle valid?
 	if (!glIsList(gllist)) PsychErrorExitMsg(PsychError_internal, "In PsychBlitterDisplayList(): Invalid display list handle provided!\n");
 	
 	// Bilinear filtering of srcfbo1 texture requested?
-	if (strstr(hookfunc->pString1, "Bilinear")) {
+	if (hookfunc->bilinear) {
 		// Yes. Enable it.
 		bilinearfiltering = TRUE;
 		glTexParameteri(GL_TEXTURE_RECTANGLE_EXT, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -3450,22 +4523,12 @@ psych_bool PsychBlitterDisplayList(PsychWindowRecordType *windowRecord, PsychHoo
 	// Check for offset parameter in the blitterString: An integral (x,y)
 	// offset for the destination of the blit. This allows to blit the srcfbo1, without
 	// scaling or filtering it, to a different start location than (0,0):
-	x=y=0;
-	if (strp=strstr(hookfunc->pString1, "Offset:")) {
-		// Parse and assign offset:
-		if (sscanf(strp, "Offset:%i:%i", &x, &y)!=2) {
-			PsychErrorExitMsg(PsychError_internal, "In PsychBlitterDisplayList(): Offset: blit string parameter is invalid! Parse error...\n");
-		}
-	}
+	x = hookfunc->offsetX;
+	y = hookfunc->offsetY;
 
-	// Check for scaling parameter:
-	sx = sy = 1.0;
-	if (strp=strstr(hookfunc->pString1, "Scaling:")) {
-		// Parse and assign offset:
-		if (sscanf(strp, "Scaling:%f:%f", &sx, &sy)!=2) {
-			PsychErrorExitMsg(PsychError_internal, "In PsychBlitterDisplayList(): Scaling: blit string parameter is invalid! Parse error...\n");
-		}
-	}
+	// Scaling parameter:
+	sx = hookfunc->scaleX;
+	sy = hookfunc->scaleY;
 
 	if (x!=0 || y!=0 || sx!=1.0 || sy!=1.0) {
 		glMatrixMode(GL_MODELVIEW);
@@ -3510,13 +4573,10 @@ psych_bool PsychBlitterDisplayList(PsychWindowRecordType *windowRecord, PsychHoo
  */
 psych_bool PsychPipelineBuiltinRenderClutBitsPlusPlus(PsychWindowRecordType *windowRecord, PsychHookFunction* hookfunc)
 {
-	char* strp;
 	const int bitshift = 16; // Bits++ expects 16 bit numbers, but ignores 2 least significant bits --> Effective 14 bit.
 	int i, x, y;
 	unsigned int r, g, b;
 	double t1, t2;
-	y=1;
-	x=0;
 	
 	if (windowRecord->loadGammaTableOnNextFlip != 0 || windowRecord->inRedTable == NULL) {
 		if (PsychPrefStateGet_Verbosity()>0) printf("PTB-ERROR: Bits++ CLUT encoding failed. No suitable CLUT set in Screen('LoadNormalizedGammaTable'). Skipped!\n");
@@ -3533,24 +4593,10 @@ psych_bool PsychPipelineBuiltinRenderClutBitsPlusPlus(PsychWindowRecordType *win
 		PsychGetAdjustedPrecisionTimerSeconds(&t1);
 	}
 
-	// Options provided?
-	if (strlen(hookfunc->pString1)>0) {
-		// Check for override vertical position for line. Default is first scanline of display.
-		if (strp=strstr(hookfunc->pString1, "yPosition=")) {
-			// Parse and assign offset:
-			if (sscanf(strp, "yPosition=%i", &y)!=1) {
-				PsychErrorExitMsg(PsychError_user, "builtin:RenderClutBitsPlusPlus: yPosition parameter for T-Lock line position is invalid! Parse error...\n");
-			}
-		}
-
-		// Check for override horizontal position for line. Default is first pixel of scanline.
-		if (strp=strstr(hookfunc->pString1, "xPosition=")) {
-			// Parse and assign offset:
-			if (sscanf(strp, "xPosition=%i", &x)!=1) {
-				PsychErrorExitMsg(PsychError_user, "builtin:RenderClutBitsPlusPlus: xPosition parameter for T-Lock line position is invalid! Parse error...\n");
-			}
-		}
-	}
+	// Position of line, as parsed from options by PsychPipelineCompileHookChain(). Default is first pixel of second scanline:
+	if (hookfunc->parseError) PsychPipelineReportSlotParseError(hookfunc);
+	x = hookfunc->iParams[0];
+	y = hookfunc->iParams[1];
 	
 	// Render CLUT as sequence of single points:	
 	glPointSize(1);
@@ -3679,44 +4725,24 @@ psych_bool PsychPipelineBuiltinRenderClutViaRuntime(PsychWindowRecordType *windo
 psych_bool PsychPipelineBuiltinRenderStereoSyncLine(PsychWindowRecordType *windowRecord, int hookId, PsychHookFunction* hookfunc)
 {
 	GLenum draw_buffer;
-	char* strp;
 	float blackpoint, r, g, b;
-	float fraction = 0.25;
+	float fraction;
 	float w = (float) PsychGetWidthFromRect(windowRecord->rect);
 	float h = (float) PsychGetHeightFromRect(windowRecord->rect);
-	r=g=b=1.0;
 	
 	// We default to display height minus 1 for position of sync-line, instead of the lower most row
 	// of the display: This is to account for a few display drivers that are off-by-one, so they would
 	// actually clip the line outside display area if provided with correct coordinates (e.g., NVidia Geforce8600M on OS/X 10.4.10 and 10.5)!
 	h = h - 1;
 	
-	// Options provided?
-	if (strlen(hookfunc->pString1)>0) {
-		// Check for override vertical position for sync line. Default is last scanline of display.
-		if (strp=strstr(hookfunc->pString1, "yPosition=")) {
-			// Parse and assign offset:
-			if (sscanf(strp, "yPosition=%f", &h)!=1) {
-				PsychErrorExitMsg(PsychError_user, "builtin:RenderStereoSyncLine: yPosition parameter for horizontal stereo blue-sync line position is invalid! Parse error...\n");
-			}
-		}
-
-		// Check for override horizontal fraction for sync line. Default is 25% for left eye, 75% for right eye.
-		if (strp=strstr(hookfunc->pString1, "hFraction=")) {
-			// Parse and assign offset:
-			if ((sscanf(strp, "hFraction=%f", &fraction)!=1) || (fraction < 0.0) || (fraction > 1.0)) {
-				PsychErrorExitMsg(PsychError_user, "builtin:RenderStereoSyncLine: hFraction parameter for horizontal stereo blue-sync line length is invalid!\n");
-			}
-		}
-		
-		// Check for override color of sync-line. Default is white.
-		if (strp=strstr(hookfunc->pString1, "Color=")) {
-			// Parse and assign offset:
-			if (sscanf(strp, "Color=%f %f %f", &r, &g, &b)!=3) {
-				PsychErrorExitMsg(PsychError_user, "builtin:RenderStereoSyncLine: Color spec for stereo sync-line is invalid!\n");
-			}
-		}
-	}
+	// Options, as parsed by PsychPipelineCompileHookChain(): Override vertical position of sync line, default is last scanline
+	// of display. Horizontal fraction for sync line, default is 25% for left eye, 75% for right eye. Color, default is white.
+	if (hookfunc->parseError) PsychPipelineReportSlotParseError(hookfunc);
+	if (hookfunc->hasYPosition) h = hookfunc->fParams[0];
+	fraction = hookfunc->fParams[1];
+	r = hookfunc->fParams[2];
+	g = hookfunc->fParams[3];
+	b = hookfunc->fParams[4];
 	
 	// Query current target buffer:
 	glGetIntegerv(GL_DRAW_BUFFER, (GLint*) &draw_buffer);
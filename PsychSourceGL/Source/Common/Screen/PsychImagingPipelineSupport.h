@@ -29,6 +29,7 @@
 #define PSYCH_IS_INCLUDED_PsychImagingPipelineSupport
 
 #include "Screen.h"
+#include "PsychImagingPluginAPI.h"
 
 // Definition of a pointer to a blitter function: See below for conforming blitter function prototypes:
 typedef psych_bool (*PsychBlitterFunc)(PsychWindowRecordType*, PsychHookFunction*, void*, psych_bool, psych_bool, PsychFBO**, PsychFBO**, PsychFBO**, PsychFBO**);
@@ -69,6 +70,7 @@ void	PsychPipelineDeleteHookSlot(PsychWindowRecordType *windowRecord, const char
 void	PsychPipelineAddBuiltinFunctionToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, const char* configString);
 void	PsychPipelineAddRuntimeFunctionToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, const char* evalString);
 void	PsychPipelineAddCFunctionToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, void* procPtr);
+void	PsychPipelineAddCPluginToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, const char* pluginName, const char* configString, const char* entryPointName);
 void	PsychPipelineAddShaderToHook(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, unsigned int shaderid, const char* blitterString, unsigned int luttexid1);
 
 psych_bool	PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hookId, void* hookUserData, void* hookBlitterFunction, psych_bool srcIsReadonly, psych_bool allowFBOSwizzle, PsychFBO** srcfbo1, PsychFBO** srcfbo2, PsychFBO** dstfbo, PsychFBO** bouncefbo);
@@ -79,6 +81,7 @@ int		PsychPipelineProcessMacros(PsychWindowRecordType *windowRecord, char* cmdSt
 
 PsychHookFunction* PsychAddNewHookFunction(PsychWindowRecordType *windowRecord, const char* hookString, const char* idString, int where, int hookfunctype);
 int		PsychGetHookByName(const char* hookName);
+void	PsychPipelineCompileHookChain(PsychWindowRecordType *windowRecord, int hookidx);
 
 // Setup source -> rendertarget binding for next rendering pass:
 void	PsychPipelineSetupRenderFlow(PsychFBO* srcfbo1, PsychFBO* srcfbo2, PsychFBO* dstfbo, psych_bool scissor_ignore);
@@ -86,6 +89,12 @@ void	PsychPipelineSetupRenderFlow(PsychFBO* srcfbo1, PsychFBO* srcfbo2, PsychFBO
 // Create OpenGL framebuffer object for internal rendering, setup PTB info struct for it:
 psych_bool PsychCreateFBO(PsychFBO** fbo, GLenum fboInternalFormat, psych_bool needzbuffer, int width, int height, int multisample);
 
+// Create FBO for an offscreen window or texture, recycling one from the FBO pool of its onscreen window if possible:
+psych_bool PsychCreatePooledFBO(PsychWindowRecordType *parentWindow, PsychFBO** fbo, GLenum fboInternalFormat, psych_bool needzbuffer, int width, int height, int multisample);
+
+// Estimated memory consumption of the buffers owned by a FBO:
+size_t PsychGetFBOSizeBytes(PsychFBO* fbo);
+
 // Check if provided PTB texture already has a PsychFBO attached. Do nothing if so. If a FBO is missing, create one:
 void PsychCreateShadowFBOForTexture(PsychWindowRecordType *textureRecord, psych_bool asRendertarget, int forImagingmode);
 
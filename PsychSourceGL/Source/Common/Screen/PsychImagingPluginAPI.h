@@ -0,0 +1,117 @@
+/*
+	PsychToolbox3/Source/Common/Screen/PsychImagingPluginAPI.h
+
+	PLATFORMS:
+
+		All.
+
+	AUTHORS:
+
+		Mario Kleiner           mk              mario.kleiner at tuebingen.mpg.de
+
+	HISTORY:
+
+		10/17/26	mk	Wrote it.
+
+	DESCRIPTION:
+
+		Binary interface between Screen's imaging pipeline and native C plugins for the
+		imaging pipeline hook chains, ie., hook slots of type 'CFunction'.
+
+		This header is self-contained and can be included by plugin code which is built
+		independently of Psychtoolbox. It must not include any other Psychtoolbox header.
+
+		A plugin is a shared library (.so, .dylib, .dll) which exports one function with
+		C linkage of type PsychImagingPluginFunc, by default under the name defined in
+		PSYCH_IMAGING_PLUGIN_ENTRYPOINT. It gets attached to a hook chain via:
+
+		Screen('HookFunction', windowPtr, 'AppendCFunction', hookname, idString, pluginLibraryName [, configString] [, entryPointName]);
+
+		Alternatively the double encoded memory address of a function of the same type can
+		be passed instead of 'pluginLibraryName', e.g., for functions inside some other mex file.
+
+		The function is called with command kPsychImagingPluginExecute each time its hook slot
+		gets executed, and once with command kPsychImagingPluginDetach when the slot is removed
+		from its chain or the window gets closed. The OpenGL context of the window is bound
+		during both calls, except for slots in the 'CloseOnscreenWindowPostGLShutdown' chain.
+
+		At execution time of an image processing hook chain, the 'dstfbo' framebuffer is bound
+		as drawbuffer, the color buffer textures of 'srcfbo1' and 'srcfbo2' (if any) are bound
+		to texture units 0 and 1 as GL_TEXTURE_RECTANGLE_EXT textures, and the viewport and
+		projection matrix are set up for a 1:1 mapping between pixel coordinates and the
+		pixels of 'dstfbo', with the origin in the top-left corner. The plugin can do arbitrary
+		OpenGL rendering into 'dstfbo', but must restore the framebuffer binding, texture bindings,
+		matrices and any other OpenGL state it changes before it returns.
+
+		A plugin can keep private per-slot state in the 'pluginData' field: It is NULL on
+		the first call and whatever the plugin assigned on the previous call afterwards. The
+		plugin must release it when processing kPsychImagingPluginDetach.
+
+		A minimal example plugin is in PsychSourceGL/Cohorts/ImagingPluginExample/.
+
+	NOTES:
+
+		Increment PSYCH_IMAGING_PLUGIN_API_VERSION whenever the layout of PsychImagingPluginParams
+		changes. Only ever append new fields to the end of the struct.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychImagingPluginAPI
+#define PSYCH_IS_INCLUDED_PsychImagingPluginAPI
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Version of the plugin interface, as passed in the 'apiVersion' field:
+#define PSYCH_IMAGING_PLUGIN_API_VERSION	1
+
+// Default name of the plugin entry point function in the shared library:
+#define PSYCH_IMAGING_PLUGIN_ENTRYPOINT		"PsychImagingPluginMain"
+
+// Commands passed in the 'command' field:
+#define kPsychImagingPluginExecute			0	// Execute the hook slot, ie., do the processing.
+#define kPsychImagingPluginDetach			1	// Slot gets removed: Release all resources and 'pluginData'.
+
+// Description of one OpenGL framebuffer object involved in the processing:
+typedef struct PsychImagingPluginFBO {
+	unsigned int		fboid;			// OpenGL framebuffer object handle. Zero if this FBO is unused or the system framebuffer.
+	unsigned int		coltexid;		// OpenGL GL_TEXTURE_RECTANGLE_EXT handle of the color buffer texture. Zero if none available.
+	int					width;			// Width of FBO in pixels.
+	int					height;			// Height of FBO in pixels.
+	int					multisample;	// Multisample level of FBO. If > 0, 'coltexid' is a renderbuffer, not a texture.
+} PsychImagingPluginFBO;
+
+// Parameter block passed to the plugin function:
+typedef struct PsychImagingPluginParams {
+	int						apiVersion;			// PSYCH_IMAGING_PLUGIN_API_VERSION of the calling Screen.
+	int						command;			// kPsychImagingPluginExecute or kPsychImagingPluginDetach.
+	int						hookId;				// Numeric id of the hook chain which executes this slot.
+	const char*				hookName;			// Name of the hook chain, e.g., "StereoLeftCompositingBlit".
+	const char*				idString;			// Name of the hook slot, as assigned when attaching the plugin.
+	const char*				configString;		// Configuration string, as assigned when attaching the plugin. Empty string if none.
+	int						windowHandle;		// Screen window handle of the window (or proxy window) executing this slot.
+	int						windowWidth;		// Width of the window in pixels.
+	int						windowHeight;		// Height of the window in pixels.
+	int						stereoMode;			// Stereo mode of the window.
+	int						flipCount;			// Number of completed flips of the window.
+	double					videoRefreshInterval;	// Measured video refresh interval of the display in seconds, if known.
+	PsychImagingPluginFBO	srcfbo1;			// First input image. All-zero if none available for the given hook chain.
+	PsychImagingPluginFBO	srcfbo2;			// Second input image, e.g., right eye view for stereo compositing.
+	PsychImagingPluginFBO	dstfbo;				// Output image, bound as drawbuffer at execution time.
+	PsychImagingPluginFBO	bouncefbo;			// Scratch buffer for multi-pass processing, if any.
+	void*					hookUserData;		// Hook chain specific data as passed by the caller of the chain. Usually NULL.
+	void*					pluginData;			// Private per-slot data of the plugin, see above.
+} PsychImagingPluginParams;
+
+// Type of plugin function: Returns zero on success, non-zero on failure. A failure aborts
+// processing of the hook chain.
+typedef int (*PsychImagingPluginFunc)(PsychImagingPluginParams* params);
+
+#ifdef __cplusplus
+}
+#endif
+
+//end include once
+#endif
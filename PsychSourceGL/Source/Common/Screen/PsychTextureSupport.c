@@ -28,6 +28,9 @@
 		10/11/05	mk		Support for special Quicktime movie textures added.
 		01/02/05	mk		Moved from OSX folder to Common folder. Contains nearly only shared code.
 		3/07/06		awi		Print warnings conditionally according to PsychPrefStateGet_SuppressAllWarnings(). 
+		10/17/26	mk		Split PsychBlitTextureToDisplay() into reusable setup helpers. New PsychBatchBlitTexturesToDisplay()
+								for state-sorted drawing of many textures via vertex arrays.
+		10/17/26	mk		Texture pool: Recycle texture objects of closed textures for new textures of same size and format.
 	
 	DESCRIPTION:
 	
@@ -144,6 +147,192 @@ void PsychInitWindowRecordTextureFields(PsychWindowRecordType *win)
 }
 
 
+/*
+	PsychMapTextureUploadBuffer()
+
+	Map a pixel buffer object of at least 'size' bytes from the ring of upload buffers of onscreen window 'win'
+	for asynchronous upload of texture 'tex'. Returns a pointer to the mapped buffer, to be filled with the texture
+	image and assigned to tex->textureMemory. PsychCreateTexture() then unmaps the buffer and uploads from it without
+	waiting for completion of the upload. Returns NULL if asynchronous uploads are unsupported, in which case the
+	texture must be uploaded synchronously from malloc()'ed textureMemory as usual.
+*/
+void* PsychMapTextureUploadBuffer(PsychWindowRecordType *win, PsychWindowRecordType *tex, size_t size)
+{
+	GLint	mapped = 0;
+	GLenum	rc;
+	void*	ptr;
+	int		slot;
+
+	PsychSetGLContext(win);
+	if (!glewIsSupported("GL_ARB_pixel_buffer_object") || !glewIsSupported("GL_ARB_sync")) return(NULL);
+
+	slot = win->textureUploadPBOSlot;
+	win->textureUploadPBOSlot = (slot + 1) % PSYCH_TEXTURE_UPLOAD_PBOS;
+
+	// Previous upload from this buffer still pending? Wait for its completion. This only blocks if
+	// more than PSYCH_TEXTURE_UPLOAD_PBOS uploads are in flight:
+	if (win->textureUploadPBOFence[slot]) {
+		do {
+			rc = glClientWaitSync(win->textureUploadPBOFence[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		} while (rc == GL_TIMEOUT_EXPIRED);
+		glDeleteSync(win->textureUploadPBOFence[slot]);
+		win->textureUploadPBOFence[slot] = NULL;
+	}
+
+	if (win->textureUploadPBO[slot] == 0) glGenBuffersARB(1, &(win->textureUploadPBO[slot]));
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, win->textureUploadPBO[slot]);
+
+	// Still mapped from a texture creation that failed before PsychCreateTexture()?
+	glGetBufferParameterivARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_BUFFER_MAPPED_ARB, &mapped);
+	if (mapped) glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+
+	// Buffers only grow, so they can be reused for all textures of similar size without reallocation:
+	if (win->textureUploadPBOSize[slot] < size) {
+		glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, (GLsizeiptrARB) size, NULL, GL_STREAM_DRAW_ARB);
+		win->textureUploadPBOSize[slot] = size;
+	}
+
+	ptr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+	if (NULL == ptr) {
+		// Out of memory or similar: Fall back to synchronous upload.
+		if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Failed to map buffer for asynchronous texture upload! Falling back to synchronous upload.\n");
+		win->textureUploadPBOSize[slot] = 0;
+		while (glGetError());
+		return(NULL);
+	}
+
+	tex->textureUploadBuffer = win->textureUploadPBO[slot];
+	return(ptr);
+}
+
+// Fence the just submitted asynchronous upload of texture 'win' from its upload buffer. One fence allows reuse of
+// the upload buffer by PsychMapTextureUploadBuffer(), the other one makes the first use of the texture wait for it:
+static void PsychFenceTextureUpload(PsychWindowRecordType *win)
+{
+	PsychWindowRecordType	*parent = PsychGetParentWindow(win);
+	int						slot;
+
+	for (slot = 0; slot < PSYCH_TEXTURE_UPLOAD_PBOS; slot++) {
+		if (parent->textureUploadPBO[slot] == win->textureUploadBuffer) {
+			parent->textureUploadPBOFence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			break;
+		}
+	}
+
+	win->textureUploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	win->textureUploadBuffer = 0;
+
+	// Get the upload going right away, and make the fences visible to shared contexts:
+	glFlush();
+}
+
+/*
+	PsychWaitForTextureUpload()
+
+	Make sure a pending asynchronous upload of texture 'win' is complete before the texture is used. By default
+	only the GPU waits, which is sufficient for use in any OpenGL context. 'clientwait' makes the calling thread
+	wait, e.g., for textures handed out to external code. The first use of a texture does this once.
+*/
+void PsychWaitForTextureUpload(PsychWindowRecordType *win, psych_bool clientwait)
+{
+	if (NULL == win->textureUploadFence) return;
+
+	if (clientwait) {
+		while (glClientWaitSync(win->textureUploadFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+	}
+	else {
+		glWaitSync(win->textureUploadFence, 0, GL_TIMEOUT_IGNORED);
+	}
+
+	glDeleteSync(win->textureUploadFence);
+	win->textureUploadFence = NULL;
+}
+
+// Release the ring of upload buffers of onscreen window 'win':
+static void PsychFreeTextureUploadBuffers(PsychWindowRecordType *win)
+{
+	int slot;
+
+	for (slot = 0; slot < PSYCH_TEXTURE_UPLOAD_PBOS; slot++) {
+		if (win->textureUploadPBOFence[slot]) glDeleteSync(win->textureUploadPBOFence[slot]);
+		win->textureUploadPBOFence[slot] = NULL;
+		if (win->textureUploadPBO[slot]) glDeleteBuffersARB(1, &(win->textureUploadPBO[slot]));
+		win->textureUploadPBO[slot] = 0;
+		win->textureUploadPBOSize[slot] = 0;
+	}
+}
+
+// Delete the least recently released texture object from the texture pool of onscreen window 'win':
+static void PsychTexturePoolEvictOldest(PsychWindowRecordType *win)
+{
+	glDeleteTextures(1, &(win->texturePool[0].textureNumber));
+	win->texturePoolBytes -= win->texturePool[0].sizeBytes;
+	texmemguesstimate -= (texmemguesstimate > win->texturePool[0].sizeBytes) ? win->texturePool[0].sizeBytes : texmemguesstimate;
+	win->texturePoolCount--;
+	memmove(&(win->texturePool[0]), &(win->texturePool[1]), win->texturePoolCount * sizeof(PsychTexturePoolEntry));
+	win->texturePoolEvictions++;
+}
+
+// Take a texture object which matches target, internal format, width and height of 'key' from the texture pool of
+// onscreen window 'win'. Returns TRUE and the object in 'key' on success, FALSE if there isn't a matching one:
+static psych_bool PsychTexturePoolAcquire(PsychWindowRecordType *win, PsychTexturePoolEntry *key)
+{
+	int i;
+
+	// Search most recently released objects first, they are the most likely ones to be still resident in VRAM:
+	for (i = win->texturePoolCount - 1; i >= 0; i--) {
+		if ((win->texturePool[i].texturetarget == key->texturetarget) && (win->texturePool[i].internalFormat == key->internalFormat) &&
+			(win->texturePool[i].width == key->width) && (win->texturePool[i].height == key->height)) {
+			*key = win->texturePool[i];
+			win->texturePoolBytes -= key->sizeBytes;
+			win->texturePoolCount--;
+			memmove(&(win->texturePool[i]), &(win->texturePool[i+1]), (win->texturePoolCount - i) * sizeof(PsychTexturePoolEntry));
+			win->texturePoolHits++;
+			return(TRUE);
+		}
+	}
+
+	win->texturePoolMisses++;
+	return(FALSE);
+}
+
+// Put texture object 'entry' into the texture pool of onscreen window 'win', evicting the least recently released objects
+// as needed to stay within the 'TexturePoolSizeMB' budget. Returns FALSE if the object can't be pooled and must be deleted:
+static psych_bool PsychTexturePoolRelease(PsychWindowRecordType *win, PsychTexturePoolEntry *entry)
+{
+	size_t					budget = ((size_t) PsychPrefStateGet_TexturePoolSizeMB()) * 1024 * 1024;
+	PsychTexturePoolEntry	*newpool;
+
+	// Trim pool to budget, e.g., after a reduction of the budget:
+	while ((win->texturePoolCount > 0) && (win->texturePoolBytes > budget)) PsychTexturePoolEvictOldest(win);
+
+	if (entry->sizeBytes > budget) return(FALSE);
+	while (win->texturePoolBytes + entry->sizeBytes > budget) PsychTexturePoolEvictOldest(win);
+
+	if (win->texturePoolCount == win->texturePoolCapacity) {
+		newpool = (PsychTexturePoolEntry*) realloc(win->texturePool, (win->texturePoolCapacity + 64) * sizeof(PsychTexturePoolEntry));
+		if (NULL == newpool) return(FALSE);
+		win->texturePool = newpool;
+		win->texturePoolCapacity += 64;
+	}
+
+	win->texturePool[win->texturePoolCount++] = *entry;
+	win->texturePoolBytes += entry->sizeBytes;
+	return(TRUE);
+}
+
+// Delete all texture objects in the texture pool of onscreen window 'win' and release the pool:
+static void PsychFreeTexturePool(PsychWindowRecordType *win)
+{
+	while (win->texturePoolCount > 0) PsychTexturePoolEvictOldest(win);
+	free(win->texturePool);
+	win->texturePool = NULL;
+	win->texturePoolCapacity = 0;
+	win->texturePoolBytes = 0;
+}
+
 /*
 	PsychCreateTextureForWindow()
 	
@@ -234,6 +423,9 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 	psych_bool							recycle = FALSE, avoidCPUGPUSync;
 	GLenum							glerr;
 	int								verbosity;
+	GLuint							uploadBuffer;
+	void*							uploadptr;
+	psych_bool						poolable;
 
 	verbosity = PsychPrefStateGet_Verbosity();
 	
@@ -254,6 +446,19 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 	// Make sure we don't have any dangling GL errors from other operations...
 	if (!avoidCPUGPUSync || (verbosity > 10)) PsychTestForGLErrors();
 	
+	// Asynchronous upload from a pixel buffer object, filled via PsychMapTextureUploadBuffer()?
+	uploadBuffer = win->textureUploadBuffer;
+	if (uploadBuffer) {
+		// Unmap it, so the GL can source texture data from it. Texture data pointers
+		// passed to the GL are offsets into the bound buffer from now on:
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, uploadBuffer);
+		glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		win->textureMemory = NULL;
+		win->textureMemorySizeBytes = 0;
+	}
+	uploadptr = win->textureMemory;
+
 	// Setup texture-target if not already done:
 	PsychDetectTextureTarget(win);
 	
@@ -375,7 +580,33 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 		theight=sourceHeight;
 		texmemptr=win->textureMemory;
 	}
-	
+
+	// Recycling of texture objects via the texture pool of our onscreen window possible for this texture? Client storage textures
+	// reference their system memory buffer and renderswapped textures change size after creation, so they don't qualify. Power-of-two
+	// GL_TEXTURE_2D textures only get their image region refilled, so a recycled one would keep stale content of its previous user
+	// in the padding area outside that region. They don't qualify either:
+	poolable = (win->texturePoolable && !recycle && !clientstorage && !renderswap && (texturetarget != GL_TEXTURE_2D) &&
+				(PsychPrefStateGet_TexturePoolSizeMB() > 0)) ? TRUE : FALSE;
+	win->texturePoolKey.textureNumber = 0;
+	if (poolable) {
+		win->texturePoolKey.texturetarget = texturetarget;
+		win->texturePoolKey.internalFormat = (win->textureinternalformat) ? win->textureinternalformat : ((win->depth == 8) ? GL_LUMINANCE8 : GL_RGBA8);
+		win->texturePoolKey.width = twidth;
+		win->texturePoolKey.height = theight;
+		if (PsychTexturePoolAcquire(PsychGetParentWindow(win), &(win->texturePoolKey))) {
+			// Pooled object of identical size and format available: Use it instead of our new one and
+			// just refill it via glTexSubImage2D() in stage 2 below, skipping the expensive creation:
+			glBindTexture(texturetarget, 0);
+			glDeleteTextures(1, &win->textureNumber);
+			win->textureNumber = win->texturePoolKey.textureNumber;
+			glBindTexture(texturetarget, win->textureNumber);
+			glinternalFormat = win->texturePoolKey.internalFormat;
+			win->bpc = win->texturePoolKey.bpc;
+			win->surfaceSizeBytes = win->texturePoolKey.sizeBytes;
+			recycle = TRUE;
+		}
+	}
+
 	// We only execute this pass for really new textures, not for recycled ones:
 	if (!recycle) {
 		// This is a two-pass procedure. First we check with a proxy-texture if texture
@@ -397,6 +628,9 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 			else {
 				// Restore real texture target from saved one in pass 1:
 				texturetarget = oldtexturetarget;
+
+				// Rectangle textures get their content right away, from the upload buffer if any:
+				if (uploadBuffer && (texturetarget != GL_TEXTURE_2D)) glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, uploadBuffer);
 			}
 			
 			if (win->textureinternalformat==0) {
@@ -432,6 +666,8 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 				glinternalFormat = win->textureinternalformat;
 			}
 
+			if (uploadBuffer) glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
 			// Only query real color depths per channel if either a special internal format was requested, ie., we
 			// need to query the real depths because we don't know it, or if verbosity is very high or avoidance
 			// of synchronizing calls is not disabled.
@@ -562,7 +798,14 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 		// Accounting... ...this is only a rough guesstimate:
 		win->surfaceSizeBytes = ((size_t) ((glinternalFormat==GL_RGBA8) ? 4 : win->depth / 8)) * (size_t) twidth * (size_t) theight;
 		texmemguesstimate+= win->surfaceSizeBytes;
-				
+
+		// Remember properties of new poolable texture object for its return to the pool on close:
+		if (poolable) {
+			win->texturePoolKey.textureNumber = win->textureNumber;
+			win->texturePoolKey.internalFormat = glinternalFormat;
+			win->texturePoolKey.bpc = win->bpc;
+			win->texturePoolKey.sizeBytes = win->surfaceSizeBytes;
+		}
 	}  // End of new texture creation.
 	
 	// Stage 2: If its a 2D texture or a recycled texture, fill it with content via glTexSubImage2D:
@@ -571,33 +814,38 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 	  // We only fill a subrectangle (of sourceWidth x sourceHeight size) with our images content. The
 	  // unused border contains all zero == black.
 	  // The same path is used for efficient refilling existing textures that are to be recycled:
+	  if (uploadBuffer) glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, uploadBuffer);
 	  if (win->textureinternalformat==0) {
 	    // Standard path: Derive texture format and such from requested pixeldepth:
 	    switch(win->depth) {
 	    case 8:
-	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_LUMINANCE, GL_UNSIGNED_BYTE, win->textureMemory);
+	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_LUMINANCE, GL_UNSIGNED_BYTE, uploadptr);
 	      break;
 	    
 	    case 16:
-	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, win->textureMemory);
+	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, uploadptr);
 	      break;
 	    
 	    case 24:
-	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_RGB, GL_UNSIGNED_BYTE, win->textureMemory);
+	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_RGB, GL_UNSIGNED_BYTE, uploadptr);
 	      break;
 	    
 	    case 32:
-	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_BGRA, ((win->gfxcaps & kPsychGfxCapNeedsUnsignedByteRGBATextureUpload) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_INT_8_8_8_8_REV), win->textureMemory);
+	      glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, GL_BGRA, ((win->gfxcaps & kPsychGfxCapNeedsUnsignedByteRGBATextureUpload) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_INT_8_8_8_8_REV), uploadptr);
 	      break;
 	    }
 	  }
 	  else {
 	    // Requested internal format and external data representation are explicitely requested: Use it.
-	    glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, win->textureexternalformat, win->textureexternaltype, win->textureMemory);
+	    glTexSubImage2D(texturetarget, 0, 0, 0, (GLsizei)sourceWidth, (GLsizei)sourceHeight, win->textureexternalformat, win->textureexternaltype, uploadptr);
 	    glinternalFormat = win->textureinternalformat;
 	  }
+	  if (uploadBuffer) glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 	}
 
+	// Upload submitted without waiting for its completion: Fence it for reuse of the upload buffer and for first use of the texture:
+	if (uploadBuffer) PsychFenceTextureUpload(win);
+
 	// New internal format requested?
 	if ((!avoidCPUGPUSync || (verbosity > 10)) && (!recycle && (gl_lastrequestedinternalFormat != glinternalFormat))) {
 		// Seems so...
@@ -717,57 +965,57 @@ void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
         // work for some strange reason :(
         if ((win->textureMemory) && (win->textureNumber > 0)) glFinish(); // FinishObjectAPPLE(GL_TEXTURE_2D, win->textureNumber);
 
-        // Perform standard OpenGL texture cleanup if needed:
-		if (win->textureNumber != 0) {
+        // Release fence of a still pending asynchronous upload of a texture, or the upload buffers of an onscreen window:
+		if (win->textureUploadFence) {
+			glDeleteSync(win->textureUploadFence);
+			win->textureUploadFence = NULL;
+		}
+		if (PsychIsOnscreenWindow(win)) {
+			PsychFreeTextureUploadBuffers(win);
+			PsychFreeTexturePool(win);
+		}
+
+        // The color buffer texture of a FBO backed offscreen window or texture belongs to its FBO and gets deleted or
+        // recycled together with the FBO by PsychShutdownImagingPipeline():
+		if ((win->fboCount > 0) && (win->fboTable[0]) && (win->fboTable[0]->format != 0) && (win->fboTable[0]->coltexid == win->textureNumber)) win->textureNumber = 0;
+
+        // Perform standard OpenGL texture cleanup if needed. Poolable texture objects go to the texture pool of
+        // our onscreen window for recycling instead, if it has room for them. They stay accounted for while pooled:
+		if ((win->textureNumber != 0) && !(win->texturePoolable && (win->texturePoolKey.textureNumber == win->textureNumber) &&
+											PsychTexturePoolRelease(PsychGetParentWindow(win), &(win->texturePoolKey)))) {
 			glDeleteTextures(1, &win->textureNumber);
 
 			// Accounting... ...this is only a rough guesstimate:
 			texmemguesstimate-= win->surfaceSizeBytes;
 			if (texmemguesstimate < 0) texmemguesstimate = 0;
 		}
+		win->texturePoolKey.textureNumber = 0;
 		
 		// PsychTestForGLErrors() is a GPU-CPU synchronization point, so in order to keep good
 		// parallelism, we only do it at verbosity levels of 5 and greater.
         if (PsychPrefStateGet_Verbosity() > 4) PsychTestForGLErrors();
     }
 
-    // Free system RAM backing memory buffer, if any:
-    if (win->textureMemory) free(win->textureMemory);
+    // Free system RAM backing memory buffer, if any. A mapped upload buffer, left over from a failed
+    // texture creation, is not ours to free - it gets unmapped on its next reuse:
+    if (win->textureMemory && (win->textureUploadBuffer == 0)) free(win->textureMemory);
     win->textureMemory=NULL;
+    win->textureUploadBuffer=0;
     win->textureMemorySizeBytes=0;
     win->textureNumber=0;
     return;
 }
 
 
-void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordType *target, double *sourceRect, double *targetRect,
-                               double rotationAngle, int filterMode, double globalAlpha)
+// Compute the texture coordinate range 'texcoords' = [sourceX, sourceY, sourceXEnd, sourceYEnd] which corresponds to 'sourceRect'
+// in texture 'source' with texture target 'textarget', as used by PsychBlitTextureToDisplay() and PsychBatchBlitTexturesToDisplay().
+// Returns in 'sizes' = [sourceWidth, sourceHeight, tWidth, tHeight] the size of the texture image and of the underlying power-of-two
+// texture for GL_TEXTURE_2D textures, or zero for other targets:
+static void PsychGetTextureBlitCoords(PsychWindowRecordType *source, double *sourceRect, GLenum textarget, double *texcoords, double *sizes)
 {
         GLdouble				sourceWidth, sourceHeight, tWidth, tHeight;
         GLdouble                sourceX, sourceY, sourceXEnd, sourceYEnd;
-		double                  transX, transY;
-        GLenum                  texturetarget;
-		GLint					attrib;
-		GLuint					shader = 0;
-		
-        // Enable targets framebuffer as current drawingtarget, except if this is a
-		// blit operation from a window into itself and the imaging pipe is on:
-        if ((source != target) || (target->imagingMode==0)) {
-			PsychSetDrawingTarget(target);
-		}
-		else {
-			// Activate rendering context of target window without changing drawing target:
-			PsychSetGLContext(target);
-		}
-		
-        // Setup texture-target if not already done:
-        PsychDetectTextureTarget(target);
-        
-        // Query target for this specific texture:
-        texturetarget = PsychGetTextureTarget(source);
 
-		//printf("%i\n", source->textureOrientation);
-		
         // This code allows the application of sourceRect, as it is meant to be:
         // CAUTION: This calculation with sourceHeight - xxxx  depends on if GPU texture swapping
         // is on or off!!!!
@@ -812,10 +1060,12 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
             sourceYEnd=sourceHeight - sourceRect[kPsychTop];
         }
 
+	tWidth = tHeight = 0;
+
         // Special case handling for GL_TEXTURE_2D textures. We need to map the
 	// absolute texture coordinates (in pixels) to the interval 0.0 - 1.0 where
 	// 1.0 == full extent of power of two texture...
-	if (texturetarget==GL_TEXTURE_2D) {
+	if (textarget==GL_TEXTURE_2D) {
 	  // Find size of real underlying texture (smallest power of two which is
 	  // greater than or equal to the image size:
 	  tWidth=1;
@@ -840,6 +1090,72 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 	  sourceYEnd=sourceYEnd / tHeight;
 	}
 
+	texcoords[0] = sourceX;
+	texcoords[1] = sourceY;
+	texcoords[2] = sourceXEnd;
+	texcoords[3] = sourceYEnd;
+
+	sizes[0] = sourceWidth;
+	sizes[1] = sourceHeight;
+	sizes[2] = tWidth;
+	sizes[3] = tHeight;
+}
+
+// Assign the texture coordinates 'tc' of the four corners of a blitted quad from the texture coordinate range 'texcoords',
+// in the vertex order upper left, lower left, lower right, upper right corner of the targetRect in the window:
+static void PsychGetTextureQuadCoords(PsychWindowRecordType *source, double *texcoords, double *tc)
+{
+	double sourceX = texcoords[0], sourceY = texcoords[1], sourceXEnd = texcoords[2], sourceYEnd = texcoords[3];
+
+	// matchups for inverted Y coordinate frame (which is inverted?)
+	// MK: Texture coordinate assignments have been changed.
+	// Explanation: Matlab stores matrices in column-major order, but OpenGL requires
+	// textures in row-major order. The old implementation of AWI performed row-column
+	// swapping in MakeTexture via C-Code on the CPU. This makes copy-loop implementation
+	// complex and creates "Cash trashing" effects on the processor. --> slow MakeTexture performance.
+	// Now we store the textures as provided by Matlab, simplifying MakeTexture's implementation,
+	// and let the Graphics hardware do the job of "swapping" during rendering, by drawing the texture
+	// in some rotated and mirrored order. This is way faster, as the GPU is optimized for such things...
+
+	// Coordinate assignments depend on internal texture orientation...
+	// Override for special case: Corevideo texture from Quicktime-subsystem.
+	if ((source->textureOrientation == 1 && renderswap) || source->textureOrientation == 2 || source->targetSpecific.QuickTimeGLTexture ||
+		source->textureOrientation == 3 || source->textureOrientation == 4) {
+		// NEW CODE: Uses "normal" coordinate assignments, so that the rotation == 0 deg. case
+		// is the fastest case --> Most common orientation has highest performance.
+		tc[0] = sourceX;    tc[1] = sourceYEnd;	//lower left
+		tc[2] = sourceX;    tc[3] = sourceY;		//upper left
+		tc[4] = sourceXEnd; tc[5] = sourceY;		//upper right
+		tc[6] = sourceXEnd; tc[7] = sourceYEnd;	//lower right
+	}
+	else {
+		// OLD CODE: Uses swapped texture coordinates....
+		tc[0] = sourceX;    tc[1] = sourceY;		//lower left vertex in  window
+		tc[2] = sourceXEnd; tc[3] = sourceY;		//upper left vertex in texture
+		tc[4] = sourceXEnd; tc[5] = sourceYEnd;	//upper right vertex in texture
+		tc[6] = sourceX;    tc[7] = sourceYEnd;	//lower right in texture
+	}
+}
+
+// Returns the filter- or lookup shader which is automatically applied when blitting texture 'source' with 'filterMode', or zero if none:
+static GLuint PsychGetTextureBlitShader(PsychWindowRecordType *source, int filterMode)
+{
+	// Linear filtering on non-capable hardware via shader emulation?
+	if ((filterMode > 0) && (source->textureFilterShader > 0)) return((GLuint) source->textureFilterShader);
+
+	// Optional texture lookup shader set up (in Screen('MakeTexture') or due to disabled color clamping...)
+	if (source->textureLookupShader > 0) return((GLuint) source->textureLookupShader);
+
+	return(0);
+}
+
+// Setup texture unit for blitting texture 'source' with texture target 'textarget' and 'filterMode' into 'target':
+// Enables and binds the texture, selects filter- and wrap mode and binds the automatic filter- or lookup shader, if any.
+// 'repeat' selects wrapping instead of clamping. Returns the bound shader, or zero if none.
+static GLuint PsychSetupTextureBlit(PsychWindowRecordType *source, PsychWindowRecordType *target, GLenum textarget, int filterMode, psych_bool repeat)
+{
+	GLuint shader = PsychGetTextureBlitShader(source, filterMode);
+
 	// MK: We need to reenable the proper texturing mode. This fixes bug reported in Forum message 3055,
 	// because SCREENDrawText glDisable'd GL_TEXTURE_RECTANGLE_EXT, without this routine reenabling it.
 	glDisable(GL_TEXTURE_2D);
@@ -849,51 +1165,139 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 	// enable texture mapping and just blit the quad, with interpolated
 	// texture coordinates set up for purely procedural shading.
 	if (source->textureNumber > 0) {
-		glEnable(texturetarget);
-		glBindTexture(texturetarget, source->textureNumber);
+		glEnable(textarget);
+		glBindTexture(textarget, source->textureNumber);
 	}
 	
 	// Linear filtering on non-capable hardware via shader emulation?
 	if ((filterMode > 0) && (source->textureFilterShader > 0)) {
 		// Yes. Bind the shader:
-		shader = source->textureFilterShader;
 		if (0 == PsychSetShader(target, shader)) PsychErrorExitMsg(PsychError_user, "Tried to use a bilinear texture filter shader, but your hardware doesn't support GLSL shaders.");
 
 		// Switch hardware samplers into nearest neighbour mode so we don't get any interference:
-		glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);		
+		glTexParameteri(textarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(textarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);		
 	}
 	else {
         // Standard hardware texture sampling/filtering: Select filter-mode for texturing:
         switch (filterMode) {
                 case 0: // Nearest-Neighbour filtering:
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                    glTexParameteri(textarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                    glTexParameteri(textarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
                 break;
                 
                 case 1: // Bilinear filtering:
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(textarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    glTexParameteri(textarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                 break;
 
                 case 2: // Linear filtering with nearest neighbour mipmapping: Needs external support to generate mipmaps.
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(textarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+                    glTexParameteri(textarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                 break;
 
                 case 3: // Linear filtering with linear mipmapping --> This is full trilinear filtering. Needs external support to generate mipmaps.
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(textarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                    glTexParameteri(textarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                 break;
         }
 		
 		// Optional texture lookup shader set up (in Screen('MakeTexture') or due to disabled color clamping...)
-		if (source->textureLookupShader > 0) {
-			shader = source->textureLookupShader;
+		if (shader > 0) {
 			if (0 == PsychSetShader(target, shader)) PsychErrorExitMsg(PsychError_user, "Tried to use a texture lookup shader, but your hardware doesn't support GLSL shaders.");
 		}
 	}
 
+	// Setup texture wrap-mode: We usually default to clamping - the best we can do
+	// for the rectangle textures we usually use. Special case is the intentional
+	// use of power-of-two textures with a real power-of-two size. In that case we
+	// enable wrapping mode to allow for scrolling effects -- useful for drifting
+	// gratings.
+	if (repeat) {
+	  // Special case: Scrollable real power-of-two textures. Enable wrapping.
+	  glTexParameteri(textarget, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	  glTexParameteri(textarget, GL_TEXTURE_WRAP_T, GL_REPEAT);	  
+	}
+	else {
+	  // Default: Clamp to edge.
+	  glTexParameteri(textarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	  glTexParameteri(textarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	// We use GL_MODULATE texture application mode together with the special rectangle color
+	// (1,1,1,globalAlpha) -- This way, the alpha blending value is the product of the alpha-
+	// value of each texel and the globalAlpha value. --> Can apply global alpha value for
+	// global blending without need for a texture alpha-channel...
+	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+	return(shader);
+}
+
+// Undo PsychSetupTextureBlit() after blitting texture 'source':
+static void PsychFinishTextureBlit(PsychWindowRecordType *source, GLenum textarget)
+{
+	// Only disable texture mapping if we actually enabled it.
+	if (source->textureNumber > 0) {
+		// Reset filters to nearest: This is important in case this texture
+		// is used as color buffer attachment of a FBO, because using the
+		// FBO would fail in puzzling ways if filtermode!=GL_NEAREST.
+		glTexParameteri(textarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(textarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        // Unbind texture:
+		glBindTexture(textarget, 0);
+        glDisable(textarget);
+	}
+}
+
+// Is a texture with 'sizes' = [sourceWidth, sourceHeight, tWidth, tHeight] from PsychGetTextureBlitCoords() a real
+// power-of-two GL_TEXTURE_2D texture, which gets drawn with wrapping instead of clamping?
+#define PsychIsRepeatingTexture(textarget, sizes) (((textarget) == GL_TEXTURE_2D) && ((sizes)[2] == (sizes)[0]) && ((sizes)[3] == (sizes)[1]))
+
+void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordType *target, double *sourceRect, double *targetRect,
+                               double rotationAngle, int filterMode, double globalAlpha)
+{
+        GLdouble				sourceWidth, sourceHeight;
+        GLdouble                sourceX, sourceY, sourceXEnd, sourceYEnd;
+		double                  transX, transY;
+		double					texcoords[4], sizes[4], tc[8];
+        GLenum                  texturetarget;
+		GLint					attrib;
+		GLuint					shader = 0;
+		
+        // Enable targets framebuffer as current drawingtarget, except if this is a
+		// blit operation from a window into itself and the imaging pipe is on:
+        if ((source != target) || (target->imagingMode==0)) {
+			PsychSetDrawingTarget(target);
+		}
+		else {
+			// Activate rendering context of target window without changing drawing target:
+			PsychSetGLContext(target);
+		}
+		
+        // Setup texture-target if not already done:
+        PsychDetectTextureTarget(target);
+        
+		// Asynchronously uploaded texture used for the first time?
+		PsychWaitForTextureUpload(source, FALSE);
+
+        // Query target for this specific texture:
+        texturetarget = PsychGetTextureTarget(source);
+
+		//printf("%i\n", source->textureOrientation);
+		
+		// Map sourceRect to texture coordinates:
+		PsychGetTextureBlitCoords(source, sourceRect, texturetarget, texcoords, sizes);
+		sourceX = texcoords[0];
+		sourceY = texcoords[1];
+		sourceXEnd = texcoords[2];
+		sourceYEnd = texcoords[3];
+		sourceWidth = sizes[0];
+		sourceHeight = sizes[1];
+
+	// Bind texture, setup filtering, wrapping and automatic filter- or lookup shader:
+	shader = PsychSetupTextureBlit(source, target, texturetarget, filterMode, PsychIsRepeatingTexture(texturetarget, sizes));
+
 	// Any automatic shader assigned yet?
 	if (shader > 0) {
 		// In case our texture (filter)/(lookup) shader also requests/defines a 'modulateColor'
@@ -912,32 +1316,10 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 		}
 	}
 
-	// Setup texture wrap-mode: We usually default to clamping - the best we can do
-	// for the rectangle textures we usually use. Special case is the intentional
-	// use of power-of-two textures with a real power-of-two size. In that case we
-	// enable wrapping mode to allow for scrolling effects -- useful for drifting
-	// gratings.
-	if (texturetarget==GL_TEXTURE_2D && tWidth==sourceWidth && tHeight==sourceHeight) {
-	  // Special case: Scrollable real power-of-two textures. Enable wrapping.
-	  glTexParameteri(texturetarget, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	  glTexParameteri(texturetarget, GL_TEXTURE_WRAP_T, GL_REPEAT);	  
-	}
-	else {
-	  // Default: Clamp to edge.
-	  glTexParameteri(texturetarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	  glTexParameteri(texturetarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	}
-
-	// We use GL_MODULATE texture application mode together with the special rectangle color
-	// (1,1,1,globalAlpha) -- This way, the alpha blending value is the product of the alpha-
-	// value of each texel and the globalAlpha value. --> Can apply global alpha value for
-	// global blending without need for a texture alpha-channel...
-	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-
 	// A globalAlpha of DBL_MAX means: Don't set vertex color here, higher-level code
 	// has done it already. Used in SCREENDrawTexture for a global override color...
 	if (globalAlpha != DBL_MAX) glColor4f(1, 1, 1, globalAlpha);
-	
+
 	// Apply a rotation transform for rotated drawing, either to modelview-,
 	// or texture matrix.
 	if ((rotationAngle != 0.0) && !(source->specialflags & kPsychDontDoRotation)) {
@@ -1037,57 +1419,17 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 		#endif
 	}
 
-	// matchups for inverted Y coordinate frame (which is inverted?)
-	// MK: Texture coordinate assignments have been changed.
-	// Explanation: Matlab stores matrices in column-major order, but OpenGL requires
-	// textures in row-major order. The old implementation of AWI performed row-column
-	// swapping in MakeTexture via C-Code on the CPU. This makes copy-loop implementation
-	// complex and creates "Cash trashing" effects on the processor. --> slow MakeTexture performance.
-	// Now we store the textures as provided by Matlab, simplifying MakeTexture's implementation,
-	// and let the Graphics hardware do the job of "swapping" during rendering, by drawing the texture
-	// in some rotated and mirrored order. This is way faster, as the GPU is optimized for such things...
+	// Emit the quad. See PsychGetTextureQuadCoords() for the texture coordinate assignments:
+	PsychGetTextureQuadCoords(source, texcoords, tc);
 	glBegin(GL_QUADS);
-	// Coordinate assignments depend on internal texture orientation...
-	// Override for special case: Corevideo texture from Quicktime-subsystem.
-	if ((source->textureOrientation == 1 && renderswap) || source->textureOrientation == 2 || source->targetSpecific.QuickTimeGLTexture ||
-		source->textureOrientation == 3 || source->textureOrientation == 4) {
-		// NEW CODE: Uses "normal" coordinate assignments, so that the rotation == 0 deg. case
-		// is the fastest case --> Most common orientation has highest performance.
-		//lower left
-		glTexCoord2f((GLfloat)sourceX, (GLfloat)sourceYEnd);
-		glVertex2f((GLfloat)(targetRect[kPsychLeft]), (GLfloat)(targetRect[kPsychTop]));		//upper left vertex in window
-		
-		//upper left
-		glTexCoord2f((GLfloat)sourceX, (GLfloat)sourceY);
-		glVertex2f((GLfloat)(targetRect[kPsychLeft]), (GLfloat)(targetRect[kPsychBottom]));		//lower left vertex in window
-		
-		//upper right
-		glTexCoord2f((GLfloat)sourceXEnd, (GLfloat)sourceY);
-		glVertex2f((GLfloat)(targetRect[kPsychRight]), (GLfloat)(targetRect[kPsychBottom]) );		//lower right  vertex in window
-		
-		//lower right
-		glTexCoord2f((GLfloat)sourceXEnd, (GLfloat)sourceYEnd);
-		glVertex2f((GLfloat)(targetRect[kPsychRight]), (GLfloat)(targetRect[kPsychTop]));		//upper right in window
-	}
-	else {
-		// OLD CODE: Uses swapped texture coordinates....
-		//lower left
-		glTexCoord2f((GLfloat)sourceX, (GLfloat)sourceY);						//lower left vertex in  window
-		glVertex2f((GLfloat)(targetRect[kPsychLeft]), (GLfloat)(targetRect[kPsychTop]));		//upper left vertex in window
-		
-		//upper left
-		glTexCoord2f((GLfloat)sourceXEnd, (GLfloat)sourceY);					        //upper left vertex in texture
-		glVertex2f((GLfloat)(targetRect[kPsychLeft]), (GLfloat)(targetRect[kPsychBottom]));		//lower left vertex in window
-		
-		//upper right
-		glTexCoord2f((GLfloat)sourceXEnd, (GLfloat)sourceYEnd);					//upper right vertex in texture
-		glVertex2f((GLfloat)(targetRect[kPsychRight]), (GLfloat)(targetRect[kPsychBottom]) );	        //lower right  vertex in window
-		
-		//lower right
-		glTexCoord2f((GLfloat)sourceX, (GLfloat)sourceYEnd);					        //lower right in texture
-		glVertex2f((GLfloat)(targetRect[kPsychRight]), (GLfloat)(targetRect[kPsychTop]));		//upper right in window
-	}            
-	
+	glTexCoord2f((GLfloat) tc[0], (GLfloat) tc[1]);
+	glVertex2f((GLfloat)(targetRect[kPsychLeft]), (GLfloat)(targetRect[kPsychTop]));		//upper left vertex in window
+	glTexCoord2f((GLfloat) tc[2], (GLfloat) tc[3]);
+	glVertex2f((GLfloat)(targetRect[kPsychLeft]), (GLfloat)(targetRect[kPsychBottom]));		//lower left vertex in window
+	glTexCoord2f((GLfloat) tc[4], (GLfloat) tc[5]);
+	glVertex2f((GLfloat)(targetRect[kPsychRight]), (GLfloat)(targetRect[kPsychBottom]) );	//lower right  vertex in window
+	glTexCoord2f((GLfloat) tc[6], (GLfloat) tc[7]);
+	glVertex2f((GLfloat)(targetRect[kPsychRight]), (GLfloat)(targetRect[kPsychTop]));		//upper right in window
 	glEnd();
 	
 	// Undo rotation transform, if any...
@@ -1096,18 +1438,8 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 		glMatrixMode(GL_MODELVIEW);
 	}
 	
-	// Only disable texture mapping if we actually enabled it.
-	if (source->textureNumber > 0) {
-		// Reset filters to nearest: This is important in case this texture
-		// is used as color buffer attachment of a FBO, because using the
-		// FBO would fail in puzzling ways if filtermode!=GL_NEAREST.
-		glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-        // Unbind texture:
-		glBindTexture(texturetarget, 0);
-        glDisable(texturetarget);
-	}
+	// Unbind texture and reset its filters:
+	PsychFinishTextureBlit(source, texturetarget);
 	
 	/* Dead and disabled: Left here for documentation...
 	if ((filterMode > 0 && source->textureFilterShader > 0) || (source->textureFilterShader < 0)) {
@@ -1125,6 +1457,236 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 	return;
 }
 
+/* PsychCanBatchBlitTexture()
+ *
+ * Returns TRUE if texture 'source' can be drawn into 'target' via PsychBatchBlitTexturesToDisplay(), FALSE if it
+ * needs PsychBlitTextureToDisplay(): Procedural textures and textures with user supplied shaders need per-blit
+ * shader parameters, blits of a window into itself need special drawing target setup, and the HDR draw shaders
+ * receive colors in a different way.
+ */
+psych_bool PsychCanBatchBlitTexture(PsychWindowRecordType *source, PsychWindowRecordType *target)
+{
+	return((source != target) && (source->textureNumber > 0) && (source->textureFilterShader >= 0) && (target->defaultDrawShader == 0));
+}
+
+// One texture blit in PsychBatchBlitTexturesToDisplay(): The texture, its state for the blit and its index in the batch:
+typedef struct PsychTextureBlitItem {
+	PsychWindowRecordType	*source;
+	GLenum					textarget;
+	int						filterMode;
+	GLuint					shader;
+	psych_bool				repeat;
+	int						index;
+} PsychTextureBlitItem;
+
+// Order texture blits by their state, and by their index for the same state:
+static int PsychCompareTextureBlitItems(const void *a, const void *b)
+{
+	const PsychTextureBlitItem *x = (const PsychTextureBlitItem*) a;
+	const PsychTextureBlitItem *y = (const PsychTextureBlitItem*) b;
+
+	if (x->textarget != y->textarget) return((x->textarget < y->textarget) ? -1 : 1);
+	if (x->source->textureNumber != y->source->textureNumber) return((x->source->textureNumber < y->source->textureNumber) ? -1 : 1);
+	if (x->filterMode != y->filterMode) return((x->filterMode < y->filterMode) ? -1 : 1);
+	if (x->shader != y->shader) return((x->shader < y->shader) ? -1 : 1);
+	return((x->index < y->index) ? -1 : ((x->index > y->index) ? 1 : 0));
+}
+
+// Do two texture blits need the same texture unit and shader setup?
+static psych_bool PsychSameTextureBlitState(PsychTextureBlitItem *a, PsychTextureBlitItem *b)
+{
+	return((a->source == b->source) && (a->filterMode == b->filterMode) && (a->shader == b->shader));
+}
+
+// Bounding box of a quad in PsychBatchBlitTexturesToDisplay(), for sorting by left edge:
+typedef struct PsychQuadBounds {
+	double	minX, minY, maxX, maxY;
+} PsychQuadBounds;
+
+static int PsychCompareQuadBounds(const void *a, const void *b)
+{
+	double x = ((const PsychQuadBounds*) a)->minX;
+	double y = ((const PsychQuadBounds*) b)->minX;
+
+	return((x < y) ? -1 : ((x > y) ? 1 : 0));
+}
+
+// Returns TRUE if the bounding boxes of any two of 'count' quads overlap, or if this couldn't be decided cheaply.
+// Sweeps over the boxes in order of their left edge, which is fast for the usual layouts of non-overlapping patches:
+static psych_bool PsychAnyQuadsOverlap(PsychQuadBounds *bounds, int count)
+{
+	int i, j, budget;
+
+	qsort(bounds, count, sizeof(PsychQuadBounds), PsychCompareQuadBounds);
+
+	budget = 64 * count;
+	for (i = 0; i < count; i++) {
+		for (j = i + 1; (j < count) && (bounds[j].minX < bounds[i].maxX); j++) {
+			if ((bounds[j].minY < bounds[i].maxY) && (bounds[i].minY < bounds[j].maxY)) return(TRUE);
+			if (--budget <= 0) return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/* PsychBatchBlitTexturesToDisplay()
+ *
+ * Draw 'count' textures 'sources' into 'target' with the same result as calling PsychBlitTextureToDisplay()
+ * for each of them in order, but with a minimal number of state changes and draw calls: All quads, rotation
+ * included, are computed on the CPU into one interleaved vertex array of positions, texture coordinates and
+ * RGBA modulate colors, which is submitted via PsychStreamVertexData(). Consecutive quads with the same texture, filter and shader setup are drawn with one
+ * glDrawArrays() call. If no two quads overlap, their drawing order doesn't matter, so they get sorted by their
+ * setup first.
+ *
+ * 'sourceRects' and 'targetRects' hold 4 * count rect coordinates, 'rotationAngles' and 'filterModes' hold
+ * count values and 'colors' holds 4 * count RGBA colors, which are used as modulate colors, like the vertex
+ * color in PsychBlitTextureToDisplay(). 'specialFlags' are the kPsychUseTextureMatrixForRotation and
+ * kPsychDontDoRotation flags to apply to all textures. All textures must pass PsychCanBatchBlitTexture().
+ */
+void PsychBatchBlitTexturesToDisplay(PsychWindowRecordType *target, int count, PsychWindowRecordType **sources, double *sourceRects, double *targetRects,
+									 double *rotationAngles, int *filterModes, GLfloat *colors, int specialFlags)
+{
+	PsychTextureBlitItem	*items;
+	PsychQuadBounds			*bounds;
+	GLfloat					*vertices, *sorted, *v, *base;
+	double					texcoords[4], sizes[4], tc[8], pos[8];
+	double					*rotcoords;
+	double					transX, transY, dx, dy, sa, ca;
+	GLint					attrib;
+	int						i, j, k;
+
+	if (count <= 0) return;
+
+	PsychSetDrawingTarget(target);
+
+	// Setup texture-target if not already done:
+	PsychDetectTextureTarget(target);
+
+	// 4 vertices per quad, each with x, y, s, t, r, g, b, a:
+	items = (PsychTextureBlitItem*) PsychMallocTemp(count * sizeof(PsychTextureBlitItem));
+	bounds = (PsychQuadBounds*) PsychMallocTemp(count * sizeof(PsychQuadBounds));
+	vertices = (GLfloat*) PsychMallocTemp(count * 4 * 8 * sizeof(GLfloat));
+
+	for (i = 0; i < count; i++) {
+		items[i].source = sources[i];
+		items[i].textarget = PsychGetTextureTarget(sources[i]);
+		items[i].filterMode = filterModes[i];
+		items[i].shader = PsychGetTextureBlitShader(sources[i], filterModes[i]);
+		items[i].index = i;
+		PsychWaitForTextureUpload(sources[i], FALSE);
+
+		PsychGetTextureBlitCoords(sources[i], &(sourceRects[i * 4]), items[i].textarget, texcoords, sizes);
+		PsychGetTextureQuadCoords(sources[i], texcoords, tc);
+		items[i].repeat = PsychIsRepeatingTexture(items[i].textarget, sizes);
+
+		// Quad corners in the same order as in PsychBlitTextureToDisplay():
+		pos[0] = targetRects[i * 4 + kPsychLeft];  pos[1] = targetRects[i * 4 + kPsychTop];
+		pos[2] = targetRects[i * 4 + kPsychLeft];  pos[3] = targetRects[i * 4 + kPsychBottom];
+		pos[4] = targetRects[i * 4 + kPsychRight]; pos[5] = targetRects[i * 4 + kPsychBottom];
+		pos[6] = targetRects[i * 4 + kPsychRight]; pos[7] = targetRects[i * 4 + kPsychTop];
+
+		// Rotation: Same transform as the glTranslated(), glRotated(), glTranslated() sequence in PsychBlitTextureToDisplay(),
+		// applied either to the quad corners, or to the texture coordinates:
+		if ((rotationAngles[i] != 0.0) && !(specialFlags & kPsychDontDoRotation)) {
+			sa = sin(rotationAngles[i] * 3.14159265358979323846 / 180.0);
+			ca = cos(rotationAngles[i] * 3.14159265358979323846 / 180.0);
+
+			if (!(specialFlags & kPsychUseTextureMatrixForRotation)) {
+				transX = (targetRects[i * 4 + kPsychRight] + targetRects[i * 4 + kPsychLeft]) * 0.5;
+				transY = (targetRects[i * 4 + kPsychTop] + targetRects[i * 4 + kPsychBottom]) * 0.5;
+				rotcoords = pos;
+			}
+			else {
+				transX = (texcoords[0] + texcoords[2]) * 0.5;
+				transY = (texcoords[1] + texcoords[3]) * 0.5;
+				rotcoords = tc;
+			}
+
+			for (k = 0; k < 8; k += 2) {
+				dx = rotcoords[k] - transX;
+				dy = rotcoords[k + 1] - transY;
+				rotcoords[k] = transX + ca * dx - sa * dy;
+				rotcoords[k + 1] = transY + sa * dx + ca * dy;
+			}
+		}
+
+		bounds[i].minX = bounds[i].maxX = pos[0];
+		bounds[i].minY = bounds[i].maxY = pos[1];
+		v = &(vertices[i * 32]);
+		for (k = 0; k < 4; k++) {
+			v[0] = (GLfloat) pos[k * 2];
+			v[1] = (GLfloat) pos[k * 2 + 1];
+			v[2] = (GLfloat) tc[k * 2];
+			v[3] = (GLfloat) tc[k * 2 + 1];
+			v[4] = colors[i * 4];
+			v[5] = colors[i * 4 + 1];
+			v[6] = colors[i * 4 + 2];
+			v[7] = colors[i * 4 + 3];
+			v += 8;
+
+			if (pos[k * 2] < bounds[i].minX) bounds[i].minX = pos[k * 2];
+			if (pos[k * 2] > bounds[i].maxX) bounds[i].maxX = pos[k * 2];
+			if (pos[k * 2 + 1] < bounds[i].minY) bounds[i].minY = pos[k * 2 + 1];
+			if (pos[k * 2 + 1] > bounds[i].maxY) bounds[i].maxY = pos[k * 2 + 1];
+		}
+	}
+
+	// Any state changes between consecutive quads? Then sort quads by state, if drawing order doesn't matter:
+	for (i = 1; (i < count) && PsychSameTextureBlitState(&items[i - 1], &items[i]); i++);
+	if ((i < count) && !PsychAnyQuadsOverlap(bounds, count)) {
+		qsort(items, count, sizeof(PsychTextureBlitItem), PsychCompareTextureBlitItems);
+
+		sorted = (GLfloat*) PsychMallocTemp(count * 4 * 8 * sizeof(GLfloat));
+		for (i = 0; i < count; i++) memcpy(&(sorted[i * 32]), &(vertices[items[i].index * 32]), 32 * sizeof(GLfloat));
+		vertices = sorted;
+	}
+
+	// The streaming VBO, if any, stays bound during the draw loop, for setup of the 'modulateColor' attribute arrays:
+	base = PsychStreamVertexData(target, vertices, count * 4 * 8 * sizeof(GLfloat));
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 8 * sizeof(GLfloat), base);
+	glTexCoordPointer(2, GL_FLOAT, 8 * sizeof(GLfloat), base + 2);
+	glColorPointer(4, GL_FLOAT, 8 * sizeof(GLfloat), base + 4);
+
+	// One draw call per run of quads with same setup:
+	for (i = 0; i < count; i = j) {
+		for (j = i + 1; (j < count) && PsychSameTextureBlitState(&items[i], &items[j]); j++);
+
+		PsychSetupTextureBlit(items[i].source, target, items[i].textarget, items[i].filterMode, items[i].repeat);
+
+		// Shaders get their unclamped 'modulateColor' attribute from the color array as well:
+		attrib = -1;
+		if (items[i].shader > 0) {
+			if ((attrib = glGetAttribLocationARB(items[i].shader, "modulateColor")) >= 0) {
+				glVertexAttribPointerARB(attrib, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), base + 4);
+				glEnableVertexAttribArrayARB(attrib);
+			}
+		}
+		else {
+			PsychSetShader(target, 0);
+		}
+
+		glDrawArrays(GL_QUADS, i * 4, (j - i) * 4);
+
+		if (attrib >= 0) glDisableVertexAttribArrayARB(attrib);
+
+		PsychFinishTextureBlit(items[i].source, items[i].textarget);
+	}
+
+	PsychReleaseStreamVertexData(target);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	// Current color is undefined after drawing with a color array. Leave the color of the last quad, as sequential drawing would:
+	glColor4fv(&(colors[(count - 1) * 4]));
+
+	return;
+}
+
 /* PsychGetTextureTarget
  * Returns GLenum with the texture target used for all PTB operations.
  * This way, external code can bind the correct target for given hardware.
@@ -1236,3 +1798,87 @@ void PsychMapTexCoord(PsychWindowRecordType *tex, double* tx, double* ty)
     return;
 }
 
+// Conversions of images with fewer color components than this are always done on the calling thread. Larger
+// ones get split into ranges, one per worker thread, up to this many threads:
+#define PSYCH_PARALLEL_CONVERSION_MINCOMPONENTS	(512 * 1024)
+#define PSYCH_PARALLEL_CONVERSION_MAX_THREADS	8
+
+// One range of a parallel pixel conversion:
+typedef struct PsychPixelConversionRange {
+	PsychPixelConversionFunc	convert;
+	void*						job;
+	size_t						start, end;
+} PsychPixelConversionRange;
+
+// Main routine of worker threads for parallel conversion:
+static void* PsychPixelConversionThreadMain(void* arg)
+{
+	PsychPixelConversionRange *range = (PsychPixelConversionRange*) arg;
+
+	range->convert(range->job, range->start, range->end);
+	return(NULL);
+}
+
+// Number of processor cores available for parallel conversion:
+static int PsychGetPixelConversionCPUs(void)
+{
+	static int ncpus = 0;
+
+	if (ncpus == 0) {
+		#if PSYCH_SYSTEM == PSYCH_WINDOWS
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		ncpus = (int) info.dwNumberOfProcessors;
+		#else
+		ncpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+		#endif
+		if (ncpus < 1) ncpus = 1;
+	}
+
+	return(ncpus);
+}
+
+/*	PsychRunParallelPixelConversion()
+ *
+ *	Run conversion 'job' of 'count' elements, e.g., pixels or pixel columns, with a total of 'ncomponents'
+ *	color components, by calls to 'convert'. Large conversions get split into ranges which are converted in
+ *	parallel by worker threads. The calling thread converts the first range itself. Ranges are multiples of
+ *	16 elements, so only the last one may contain partial vector or cache tiles.
+ */
+void PsychRunParallelPixelConversion(PsychPixelConversionFunc convert, void *job, size_t count, size_t ncomponents)
+{
+	PsychPixelConversionRange	ranges[PSYCH_PARALLEL_CONVERSION_MAX_THREADS];
+	psych_thread				threads[PSYCH_PARALLEL_CONVERSION_MAX_THREADS];
+	psych_bool					started[PSYCH_PARALLEL_CONVERSION_MAX_THREADS];
+	size_t						rangesize;
+	int							i, nthreads;
+
+	nthreads = (int) (ncomponents / (PSYCH_PARALLEL_CONVERSION_MINCOMPONENTS / 2));
+	if (nthreads > PsychGetPixelConversionCPUs()) nthreads = PsychGetPixelConversionCPUs();
+	if (nthreads > PSYCH_PARALLEL_CONVERSION_MAX_THREADS) nthreads = PSYCH_PARALLEL_CONVERSION_MAX_THREADS;
+
+	if (nthreads < 2) {
+		convert(job, 0, count);
+		return;
+	}
+
+	rangesize = ((count / nthreads) + 15) & ~((size_t) 15);
+	for (i = 0; i < nthreads; i++) {
+		ranges[i].convert = convert;
+		ranges[i].job = job;
+		ranges[i].start = (size_t) i * rangesize;
+		ranges[i].end = (ranges[i].start + rangesize < count) ? ranges[i].start + rangesize : count;
+		if (ranges[i].start > ranges[i].end) ranges[i].start = ranges[i].end;
+
+		// Failure to start a worker is not fatal: We'll convert its range ourselves.
+		started[i] = (i > 0) && (PsychCreateThread(&threads[i], NULL, PsychPixelConversionThreadMain, (void*) &ranges[i]) == 0);
+	}
+
+	for (i = 0; i < nthreads; i++) {
+		if (!started[i]) convert(job, ranges[i].start, ranges[i].end);
+	}
+
+	for (i = 1; i < nthreads; i++) {
+		if (started[i]) PsychDeleteThread(&threads[i]);
+	}
+}
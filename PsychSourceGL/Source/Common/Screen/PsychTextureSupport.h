@@ -29,12 +29,21 @@ void PsychInitWindowRecordTextureFields(PsychWindowRecordType *winRec);
 void PsychCreateTextureForWindow(PsychWindowRecordType *win);
 void PsychCreateTexture(PsychWindowRecordType *win);
 void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win);
+void* PsychMapTextureUploadBuffer(PsychWindowRecordType *win, PsychWindowRecordType *tex, size_t size);
+void PsychWaitForTextureUpload(PsychWindowRecordType *win, psych_bool clientwait);
 void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordType *target, double *sourceRect, double *targetRect,
                                double rotationAngle, int filterMode, double globalAlpha);
+psych_bool PsychCanBatchBlitTexture(PsychWindowRecordType *source, PsychWindowRecordType *target);
+void PsychBatchBlitTexturesToDisplay(PsychWindowRecordType *target, int count, PsychWindowRecordType **sources, double *sourceRects, double *targetRects,
+                                     double *rotationAngles, int *filterModes, GLfloat *colors, int specialFlags);
 GLenum PsychGetTextureTarget(PsychWindowRecordType *win);
 void PsychMapTexCoord(PsychWindowRecordType *tex, double* tx, double* ty);
 void PsychDetectTextureTarget(PsychWindowRecordType *win);
 
+// Callback for parallel pixel conversions: Convert elements 'start' to 'end' - 1 of conversion 'job':
+typedef void (*PsychPixelConversionFunc)(void *job, size_t start, size_t end);
+void PsychRunParallelPixelConversion(PsychPixelConversionFunc convert, void *job, size_t count, size_t ncomponents);
+
 //end include once
 #endif
 
@@ -93,6 +93,9 @@ static psych_threadid	masterthread = (psych_threadid) NULL;
 // Count of currently async-flipping onscreen windows:
 static unsigned int	asyncFlipOpsActive = 0;
 
+static double PsychFlipWindowBuffersTimed(PsychWindowRecordType *windowRecord, int multiflip, int vbl_synclevel, int dont_clear, double flipwhen, int* beamPosAtFlip, double* miss_estimate, double* time_at_flipend, double* time_at_onset, PsychFlipTimingState* timing);
+static void PsychPreFlipOperationsIntoFBO(PsychWindowRecordType *windowRecord, int clearmode, PsychFBO** targetFBO);
+
 // Return count of currently async-flipping onscreen windows:
 unsigned int PsychGetNrAsyncFlipsActive(void)
 {
@@ -1570,6 +1573,22 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
 			windowRecord->gpuRenderTimeQuery = 0;
 		}
 
+		// Delete pixel buffer objects for asynchronous Screen('GetImage') readback, if any:
+		for (i = 0; i < PSYCH_READBACK_PBOS; i++) {
+			if (windowRecord->readbackPBO[i].pbo) glDeleteBuffersARB(1, &(windowRecord->readbackPBO[i].pbo));
+			windowRecord->readbackPBO[i].pbo = 0;
+			windowRecord->readbackPBO[i].size = 0;
+			windowRecord->readbackPBO[i].pending = FALSE;
+		}
+		windowRecord->readbackPBODepth = 0;
+
+		// Delete all dot fields of Screen('CreateDotField') which live in this window's context:
+		PsychCloseDotFieldsOfWindow(windowRecord);
+
+		// Delete streaming vertex buffer of batch drawing functions, if any:
+		if (windowRecord->streamVBO) glDeleteBuffersARB(1, &(windowRecord->streamVBO));
+		windowRecord->streamVBO = 0;
+
 				// Sync and idle the pipeline again:
                 glFinish();
 
@@ -1704,11 +1723,14 @@ void PsychFlushGL(PsychWindowRecordType *windowRecord)
 void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
 {
 	PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
-	int rc;
+	int rc, i;
 	static unsigned int recursionlevel = 0;
 	
 	// Nothing to do for NULL structs:
 	if (NULL == flipRequest) return;
+
+	// An error abort while preparing a queued flip may have left asyncstate at zero with queued flips still pending:
+	if (flipRequest->queueCount > 0) flipRequest->asyncstate = 1;
 	
 	// Any async flips in progress?
 	if (flipRequest->asyncstate != 0) {
@@ -1721,10 +1743,13 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
 		if (flipRequest->asyncstate == 1) {
 			// If no recursion and flipper thread not in error state it might be safe to try a normal shutdown:
 			if (recursionlevel == 0 && flipRequest->flipperState < 4) {
-				// Operation in progress: Try to stop it the normal way...
+				// Operation in progress: Try to stop it the normal way. Each call finalizes one
+				// flip, so repeat until all queued flips are finalized as well:
 				flipRequest->opmode = 2;
 				recursionlevel++;
-				PsychFlipWindowBuffersIndirect(windowRecord);
+				do {
+					PsychFlipWindowBuffersIndirect(windowRecord);
+				} while (flipRequest->asyncstate == 1);
 				recursionlevel--;
 			}
 			else {
@@ -1733,6 +1758,7 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
 				printf("PTB-WARNING: Infinite loop detected. Trying to break out in a cruel way. This may hang, crash or go into another infinite loop...\n");
 				fflush(NULL);
 				flipRequest->asyncstate = 0;
+				flipRequest->queueCount = 0;
 
 				// Decrement the asyncFlipOpsActive count:
 				asyncFlipOpsActive--;
@@ -1803,6 +1829,17 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
 		// At this point, the thread and all other async flip resources have been terminated and released.
 	}
 
+	// Release FBO's of the flip queue, if any:
+	for (i = 0; i < kPsychMaxQueuedFlips; i++) {
+		if (flipRequest->queue[i].fbo == NULL) continue;
+
+		PsychSetGLContext(windowRecord);
+		glDeleteTextures(1, &(flipRequest->queue[i].fbo->coltexid));
+		glDeleteFramebuffersEXT(1, &(flipRequest->queue[i].fbo->fboid));
+		free(flipRequest->queue[i].fbo);
+		flipRequest->queue[i].fbo = NULL;
+	}
+
 	// Release struct:
 	free(flipRequest);
 	windowRecord->flipInfo = NULL;
@@ -1811,6 +1848,251 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
 	return;
 }
 
+// Copy flip timing bookkeeping of 'windowRecord' into 'timing':
+static void PsychGetFlipTimingState(PsychWindowRecordType *windowRecord, PsychFlipTimingState* timing)
+{
+	timing->time_at_last_vbl = windowRecord->time_at_last_vbl;
+	timing->rawtime_at_swapcompletion = windowRecord->rawtime_at_swapcompletion;
+	timing->postflip_vbltimestamp = windowRecord->postflip_vbltimestamp;
+	timing->osbuiltin_swaptime = windowRecord->osbuiltin_swaptime;
+	timing->nr_missed_deadlines = windowRecord->nr_missed_deadlines;
+	timing->flipCount = windowRecord->flipCount;
+	timing->IFIRunningSum = windowRecord->IFIRunningSum;
+	timing->nrIFISamples = windowRecord->nrIFISamples;
+}
+
+// Store flip timing bookkeeping from 'timing' into 'windowRecord'. The IFI estimate is only read during flips, so it is left alone:
+static void PsychSetFlipTimingState(PsychWindowRecordType *windowRecord, PsychFlipTimingState* timing)
+{
+	windowRecord->time_at_last_vbl = timing->time_at_last_vbl;
+	windowRecord->rawtime_at_swapcompletion = timing->rawtime_at_swapcompletion;
+	windowRecord->postflip_vbltimestamp = timing->postflip_vbltimestamp;
+	windowRecord->osbuiltin_swaptime = timing->osbuiltin_swaptime;
+	windowRecord->nr_missed_deadlines = timing->nr_missed_deadlines;
+	windowRecord->flipCount = timing->flipCount;
+}
+
+/* PsychCanQueueAsyncFlips() -- Can onscreen window 'windowRecord' queue multiple async flips?
+ *
+ * Queued async flips need the imaging pipeline with FBO backed drawBufferFBO's, so the master
+ * thread can render the finalized image of a new flip request into a FBO of the flip queue while
+ * older requests are still pending, and so the flipper thread doesn't have to clear the drawBufferFBO's
+ * after each flip. Only a single system backbuffer as final output target is supported, ie., no quad-
+ * buffered, frame-sequential or dual-window stereo and no dual-window output.
+ */
+psych_bool PsychCanQueueAsyncFlips(PsychWindowRecordType *windowRecord)
+{
+	if (PsychPrefStateGet_ConserveVRAM() & kPsychUseOldStyleAsyncFlips) return(FALSE);
+	if (!(windowRecord->imagingMode & kPsychNeedFastBackingStore) || (windowRecord->imagingMode == kPsychNeedFastOffscreenWindows)) return(FALSE);
+	if ((windowRecord->imagingMode & kPsychNeedDualWindowOutput) || (windowRecord->stereomode == kPsychOpenGLStereo) ||
+		(windowRecord->stereomode == kPsychFrameSequentialStereo) || (windowRecord->stereomode == kPsychDualWindowStereo)) return(FALSE);
+	if ((windowRecord->finalizedFBO[0] < 0) || (windowRecord->drawBufferFBO[0] == windowRecord->finalizedFBO[0])) return(FALSE);
+	if (windowRecord->fboTable[windowRecord->finalizedFBO[0]]->fboid != 0) return(FALSE);
+
+	return(TRUE);
+}
+
+/* PsychRenderQueuedFlip() -- Prepare a new queued async flip request on the master thread.
+ *
+ * Executes the preflip operations of the imaging pipeline for the flip request in windowRecord->flipInfo,
+ * but with the final output redirected from the system backbuffer into the FBO of the next free slot in
+ * the flip queue, so the backbuffer is left alone for the flipper thread and any still pending flips.
+ * Then performs the postflip clear of the drawBufferFBO's, which the flipper thread must not do for queued
+ * flips, as usercode may already draw the next frame while the flip is pending.
+ *
+ * Returns the prepared slot. It is handed over to the flipper thread by the caller.
+ */
+static PsychQueuedFlipInfo* PsychRenderQueuedFlip(PsychWindowRecordType *windowRecord)
+{
+	PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+	PsychQueuedFlipInfo* slot;
+	PsychFBO* finalizedFBO;
+	GLint redbits;
+	GLenum format;
+
+	slot = &(flipRequest->queue[(flipRequest->queueHead + flipRequest->queueCount) % kPsychMaxQueuedFlips]);
+	if (slot->state != 0) PsychErrorExitMsg(PsychError_internal, "Slot for new request in flip queue not free!");
+
+	slot->vbl_synclevel = flipRequest->vbl_synclevel;
+	slot->dont_clear = flipRequest->dont_clear;
+	slot->flipwhen = flipRequest->flipwhen;
+	slot->vbl_timestamp = -1;
+
+	finalizedFBO = windowRecord->fboTable[windowRecord->finalizedFBO[0]];
+
+	// First use of this slot? Create a FBO for the finalized image, with a format suitable for unmodified blitting into the backbuffer:
+	if (slot->fbo == NULL) {
+		PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+		PsychSetGLContext(windowRecord);
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+		glGetIntegerv(GL_RED_BITS, &redbits);
+		format = (redbits <= 8) ? GL_RGBA8 : ((windowRecord->gfxcaps & kPsychGfxCapFPFBO32) ? GL_RGBA_FLOAT32_APPLE : GL_RGBA16_SNORM);
+
+		if (!PsychCreateFBO(&(slot->fbo), format, FALSE, finalizedFBO->width, finalizedFBO->height, 0)) {
+			slot->fbo = NULL;
+			PsychErrorExitMsg(PsychError_system, "Failed to create framebuffer object for queued async flip. Try a smaller 'queueDepth'.");
+		}
+
+		if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Created framebuffer object %i for async flip queue of window %i.\n", slot->fbo->fboid, windowRecord->windowIndex);
+	}
+
+	// Execute the pipeline with its final output redirected from the system framebuffer into the queue FBO.
+	// This doesn't touch the system backbuffer, so it is allowed while older queued flips are pending.
+	// A Screen('DrawingFinished') may have executed the preflip operations into the backbuffer already, so always rerun them:
+	windowRecord->backBufferBackupDone = false;
+	PsychPreFlipOperationsIntoFBO(windowRecord, slot->dont_clear, &(slot->fbo));
+
+	// Image must be complete before the flipper threads OpenGL context reads it:
+	glFinish();
+
+	// Prepare drawBufferFBO's for drawing of the next frame:
+	PsychPostFlipOperations(windowRecord, slot->dont_clear);
+
+	// Reset flags used for avoiding redundant Pipeline flushes and backbuffer-backups for the next frame:
+	windowRecord->PipelineFlushDone = false;
+	windowRecord->backBufferBackupDone = false;
+
+	return(slot);
+}
+
+/* PsychExecuteQueuedFlips() -- Execute queued async flip requests on the flipper thread.
+ *
+ * Executes all requests in the flip queue which are waiting for execution, in FIFO order:
+ * Copies the finalized image of the request into the system backbuffer, then performs a
+ * synchronous flip for the requests deadline and stores the results in the slot. The
+ * performFlipLock is released during each flip, so the master thread can queue new
+ * requests or collect results of finished ones meanwhile. The flip updates the private
+ * timing state flipRequest->flipperTiming instead of the windowRecord, which is owned
+ * by the master thread.
+ *
+ * Called with the performFlipLock held. Returns TRUE with the lock held, or FALSE if
+ * relocking failed, in which case the lock is not held.
+ */
+static psych_bool PsychExecuteQueuedFlips(PsychWindowRecordType *windowRecord)
+{
+	PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+	PsychQueuedFlipInfo* slot;
+	int i, rc;
+
+	while (flipRequest->opmode != -1) {
+		// Find oldest request waiting for execution:
+		slot = NULL;
+		for (i = 0; i < flipRequest->queueCount; i++) {
+			if (flipRequest->queue[(flipRequest->queueHead + i) % kPsychMaxQueuedFlips].state == 1) {
+				slot = &(flipRequest->queue[(flipRequest->queueHead + i) % kPsychMaxQueuedFlips]);
+				break;
+			}
+		}
+
+		// Queue empty?
+		if (NULL == slot) break;
+
+		slot->state = 2;
+		flipRequest->flipperState = 2;
+		PsychUnlockMutex(&(flipRequest->performFlipLock));
+
+		// Setup view of our context for the full backbuffer area, as in the classic async flip path:
+		PsychSetupView(windowRecord, TRUE);
+
+		// Copy finalized image into the backbuffer. The FBO was created in the masters context, but
+		// its color texture is shared with our context, so sample from it like the frame-sequential
+		// stereo path does. This sets up its viewports, texture and fbo bindings and restores them to pre-exec state:
+		PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(slot->fbo), NULL,
+					 &(windowRecord->fboTable[windowRecord->finalizedFBO[0]]), NULL);
+
+		// Execute synchronous flip. The drawBufferFBO's were already prepared for the next frame
+		// by the master thread, so no postflip clear: This resets the framebuffer binding to 0 at exit:
+		slot->vbl_timestamp = PsychFlipWindowBuffersTimed(windowRecord, 0, slot->vbl_synclevel, 2, slot->flipwhen, &(slot->beamPosAtFlip),
+								  &(slot->miss_estimate), &(slot->time_at_flipend), &(slot->time_at_onset), &(flipRequest->flipperTiming));
+
+		// Blit from the queue FBO must be finished before the master thread may refill it:
+		glFinish();
+
+		if ((rc=PsychLockMutex(&(flipRequest->performFlipLock)))) {
+			fprintf(stderr, "PTB-ERROR: In PsychExecuteQueuedFlips(): mutex_lock after flip failed  [%s].\n", strerror(rc));
+			return(FALSE);
+		}
+
+		slot->timing = flipRequest->flipperTiming;
+		slot->state = 3;
+	}
+
+	// All queued requests executed:
+	flipRequest->flipperState = 3;
+
+	return(TRUE);
+}
+
+/* PsychCollectQueuedFlip() -- Finalize the oldest queued async flip request on the master thread.
+ *
+ * Waits (opmode 2) or polls (opmode 3) for completion of the oldest outstanding request in the
+ * flip queue, copies its results into the flipRequest struct and frees its slot. If this was
+ * the last outstanding request, the async flip is finished: asyncstate is set to 2 and we keep
+ * the performFlipLock, just as after finalizing a classic async flip. Otherwise asyncstate
+ * stays at 1 and the lock is released.
+ *
+ * Returns TRUE if a request was finalized, FALSE if polling found it not yet finished.
+ */
+static psych_bool PsychCollectQueuedFlip(PsychWindowRecordType *windowRecord)
+{
+	PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+	PsychQueuedFlipInfo* slot = &(flipRequest->queue[flipRequest->queueHead]);
+	int rc;
+
+	while (TRUE) {
+		if (flipRequest->opmode == 2) {
+			if ((rc=PsychLockMutex(&(flipRequest->performFlipLock)))) {
+				printf("PTB-ERROR: In Screen('AsyncFlipEnd'): PsychCollectQueuedFlip(): mutex_lock in wait for finish failed  [%s].\n", strerror(rc));
+				PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of async flip end!");
+			}
+		}
+		else {
+			if (PsychTryLockMutex(&(flipRequest->performFlipLock)) > 0) return(FALSE);
+		}
+
+		if (slot->state == 3) break;
+
+		if ((rc=PsychUnlockMutex(&(flipRequest->performFlipLock)))) {
+			printf("PTB-ERROR: In Screen('AsyncFlipEnd'): PsychCollectQueuedFlip(): mutex_unlock in wait/poll for finish failed  [%s].\n", strerror(rc));
+			PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of async flip end!");
+		}
+
+		if (flipRequest->opmode == 3) return(FALSE);
+
+		PsychYieldIntervalSeconds(0.001);
+	}
+
+	// Return results of this flip:
+	flipRequest->beamPosAtFlip = slot->beamPosAtFlip;
+	flipRequest->miss_estimate = slot->miss_estimate;
+	flipRequest->time_at_flipend = slot->time_at_flipend;
+	flipRequest->time_at_onset = slot->time_at_onset;
+	flipRequest->vbl_timestamp = slot->vbl_timestamp;
+
+	// Publish timing state after this flip to the window, while we still hold the lock:
+	PsychSetFlipTimingState(windowRecord, &(slot->timing));
+
+	// Free the slot:
+	slot->state = 0;
+	flipRequest->queueHead = (flipRequest->queueHead + 1) % kPsychMaxQueuedFlips;
+	flipRequest->queueCount--;
+
+	if (flipRequest->queueCount == 0) {
+		// Queue drained. The flipper thread is waiting for new work and we keep the lock:
+		flipRequest->flipperState = 1;
+		flipRequest->asyncstate = 2;
+		asyncFlipOpsActive--;
+	}
+	else {
+		PsychUnlockMutex(&(flipRequest->performFlipLock));
+	}
+
+	// Call hookchain with callbacks to be performed after successfull flip completion:
+	PsychPipelineExecuteHook(windowRecord, kPsychScreenFlipImpliedOperations, NULL, NULL, FALSE, FALSE, NULL, NULL, NULL, NULL);
+
+	return(TRUE);
+}
+
 /* PsychFlipperThreadMain() the "main()" routine of the asynchronous flip worker thread:
  *
  * This routine implements an infinite loop (well, infinite until cancellation at Screen('Close')
@@ -1929,6 +2211,19 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 				break;	
 			}
 
+			// Queued flips? Execute all of them, then wait for more work:
+			if (flipRequest->queueCount > 0) {
+				if (!PsychExecuteQueuedFlips(windowRecord)) {
+					// Commit suicide with state "error, lock not held":
+					flipRequest->flipperState = 5;
+					PsychOSUnsetGLContext(windowRecord);
+					return(NULL);
+				}
+
+				if (glBindFramebufferEXT) glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+				continue;
+			}
+
 			// Got the lock: Set our state to "executing - flip in progress":
 			flipRequest->flipperState = 2;
 
@@ -2179,6 +2474,11 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
  *      flipRequest->opmode can be one of:
  *	0 = Execute Synchronous flip, 1 = Start async flip, 2 = Finish async flip, 3 = Poll for finish of async flip.
  *
+ *	If flipRequest->queueDepth > 1, async flips are queued: Up to queueDepth requests can be outstanding, each
+ *	with its image rendered into its own FBO by PsychRenderQueuedFlip(). The flipper thread executes them in order
+ *	via PsychExecuteQueuedFlips(), and each finish or poll finalizes the oldest one via PsychCollectQueuedFlip().
+ *	The performFlipLock is only held by the master thread while no queued flips are outstanding.
+ *
  *      *	Synchronous flips are performed without changing the mutex lock flipRequest->performFlipLock. We check if
  *		there are not flip ops scheduled or executing for the window, then simply execute the flip and return its
  *		results, if none are active.
@@ -2223,6 +2523,7 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 {
 	int rc;
 	PsychFlipInfoStruct* flipRequest;
+	PsychQueuedFlipInfo* slot = NULL;
 	
 	if (NULL == windowRecord) PsychErrorExitMsg(PsychError_internal, "NULL-Ptr for windowRecord passed in PsychFlipWindowsIndirect()!!");
 	
@@ -2246,8 +2547,11 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 
 	// Asynchronous flip mode, either request to trigger one or request to finalize one:
 	if ((flipRequest->opmode == 1) || ((flipRequest->opmode == 0) && (windowRecord->stereomode == kPsychFrameSequentialStereo))) {
-		// Async flip start request, or a sync flip turned into an async flip due to kPsychFrameSequentialStereo:
-		if (flipRequest->asyncstate != 0) PsychErrorExitMsg(PsychError_internal, "Tried to invoke asynchronous flip while flip still in progress!");
+		// Async flip start request, or a sync flip turned into an async flip due to kPsychFrameSequentialStereo.
+		// Queued requests can be added while older queued ones are in progress, as long as the queue has room:
+		if ((flipRequest->asyncstate != 0) && !((flipRequest->queueDepth > 1) && (flipRequest->queueCount > 0) && (flipRequest->queueCount < flipRequest->queueDepth))) {
+			PsychErrorExitMsg(PsychError_internal, "Tried to invoke asynchronous flip while flip still in progress!");
+		}
 
 		// Current multiflip > 0 implementation is not thread-safe, so we don't support this:
 		if (flipRequest->multiflip != 0) PsychErrorExitMsg(PsychError_user, "Using a non-zero 'multiflip' flag while starting an asynchronous flip! This is forbidden! Aborted.\n");
@@ -2259,13 +2563,19 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 		// PsychPreflip operations are not thread-safe due to possible callbacks into Matlab interpreter thread
 		// as part of hookchain processing when the imaging pipeline is enabled: We perform/trigger them here
 		// before entering the async flip thread:
-		PsychPreFlipOperations(windowRecord, flipRequest->dont_clear);
+		if (flipRequest->queueDepth > 1) {
+			// Queued flip: Render into a queue FBO, as older flips may still need the backbuffer:
+			slot = PsychRenderQueuedFlip(windowRecord);
+		}
+		else {
+			PsychPreFlipOperations(windowRecord, flipRequest->dont_clear);
 
-		// Tell Flip that pipeline - flushing has been done already to avoid redundant flush:
-		windowRecord->PipelineFlushDone = TRUE;
+			// Tell Flip that pipeline - flushing has been done already to avoid redundant flush:
+			windowRecord->PipelineFlushDone = TRUE;
 
-		// ... and flush & finish the pipe:
-		glFinish();
+			// ... and flush & finish the pipe:
+			glFinish();
+		}
 
 		// First time async request? Threads already set up?
 		if (flipRequest->flipperThread == (psych_thread) NULL) {
@@ -2366,6 +2676,15 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 			// printf("FIRST TIME INIT DONE\n"); fflush(NULL);
 		}
 		
+		// Adding to a non-empty flip queue? Then the flipper thread may be busy with older requests
+		// and we don't hold the lock yet:
+		if (slot && (flipRequest->asyncstate == 1)) {
+			if ((rc=PsychLockMutex(&(flipRequest->performFlipLock)))) {
+				printf("PTB-ERROR: In Screen('FlipAsyncBegin'): PsychFlipWindowBuffersIndirect(): mutex_lock for queueing failed  [%s].\n", strerror(rc));
+				PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of async flip queueing!");
+			}
+		}
+
 		// Our flipperThread is ready to do work for us (waiting on flipperGoGoGo condition variable) and
 		// we have the lock on the flipRequest struct. The struct is already filled with all input parameters
 		// for a flip request, so we can simply release our lock and signal the thread that it should do its
@@ -2382,13 +2701,22 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 		PsychSetDrawingTarget(NULL);
 		PsychOSUnsetGLContext(windowRecord);
 		
-		// Increment the counter asyncFlipOpsActive:
-		asyncFlipOpsActive++;
+		// Increment the counter asyncFlipOpsActive, unless this window is already counted due to older queued flips:
+		if (flipRequest->asyncstate == 0) asyncFlipOpsActive++;
 
 		// printf("IN ASYNCSTART: MUTEXUNLOCK\n"); fflush(NULL);
 
-		// This is only needed for frame-sequential thread mode:
-		flipRequest->flipperState = 1;
+		if (slot) {
+			// Hand queued request over to the flipper thread. If it is idle, give it a fresh copy
+			// of the windows timing state to work on:
+			if (flipRequest->queueCount == 0) PsychGetFlipTimingState(windowRecord, &(flipRequest->flipperTiming));
+			slot->state = 1;
+			flipRequest->queueCount++;
+		}
+		else {
+			// This is only needed for frame-sequential thread mode:
+			flipRequest->flipperState = 1;
+		}
 
 		// Trigger the thread:
 		if ((rc=PsychSignalCondition(&(flipRequest->flipperGoGoGo)))) {
@@ -2426,6 +2754,9 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 		// Child protection:
 		if (flipRequest->asyncstate != 1) PsychErrorExitMsg(PsychError_internal, "Tried to invoke end of an asynchronous flip although none is in progress!");
 
+		// Queued flips finalize one request at a time, oldest first:
+		if (flipRequest->queueCount > 0) return(PsychCollectQueuedFlip(windowRecord));
+
 		// We try to get the lock, then check if flip is finished. If not, we need to wait
 		// a bit and retry:
 		while (TRUE) {
@@ -2566,7 +2897,7 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
 	-1:  Raw.
 
 */
-double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip, int vbl_synclevel, int dont_clear, double flipwhen, int* beamPosAtFlip, double* miss_estimate, double* time_at_flipend, double* time_at_onset)
+static double PsychFlipWindowBuffersTimed(PsychWindowRecordType *windowRecord, int multiflip, int vbl_synclevel, int dont_clear, double flipwhen, int* beamPosAtFlip, double* miss_estimate, double* time_at_flipend, double* time_at_onset, PsychFlipTimingState* timing)
 {
     int screenheight, screenwidth;
     GLint read_buffer, draw_buffer;
@@ -2631,8 +2962,8 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
         PsychErrorExitMsg(PsychError_internal,"Attempt to swap a single window buffer");
     
     // Retrieve estimate of interframe flip-interval:
-    if (windowRecord->nrIFISamples > 0) {
-        currentflipestimate=windowRecord->IFIRunningSum / ((double) windowRecord->nrIFISamples);
+    if (timing->nrIFISamples > 0) {
+        currentflipestimate=timing->IFIRunningSum / ((double) timing->nrIFISamples);
     }
     else {
         // We don't have a valid estimate! This will screw up all timestamping, checking and waiting code!
@@ -2919,7 +3250,7 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     }
 
     // Do we know the exact system time when a VBL happened in the past?
-    if ((windowRecord->time_at_last_vbl > 0) && (currentflipestimate > 0)) {
+    if ((timing->time_at_last_vbl > 0) && (currentflipestimate > 0)) {
       // Yes! We use this as a base-line time to compute from the current time a virtual deadline,
       // which is at the beginning of the current monitor refresh interval.
       //
@@ -2927,7 +3258,7 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
       // we should have a valid time_at_last_vbl, so this mechanism works.
       // Only on the *very first* invocation of Flip either after PTB-Startup or after a non-blocking
       // Flip, we can't do this because the time_at_last_vbl timestamp isn't available...
-      tshouldflip = windowRecord->time_at_last_vbl + ((floor((tshouldflip - windowRecord->time_at_last_vbl) / currentflipestimate)) * currentflipestimate);
+      tshouldflip = timing->time_at_last_vbl + ((floor((tshouldflip - timing->time_at_last_vbl) / currentflipestimate)) * currentflipestimate);
     }
     
     // Calculate final deadline for deadline-miss detection:
@@ -2989,19 +3320,19 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
 	//
 	// Note that this isn't needed if OS specific swap scheduling is used, as that is supposed to take
 	// care of such nuisances - and if it didn't, this wouldn't help anyway ;) :
-	if ((windowRecord->time_at_last_vbl > 0) && (vbl_synclevel!=2) && (!osspecific_asyncflip_scheduled) &&
-		((time_at_swaprequest - windowRecord->time_at_last_vbl < 0.002) || ((line_pre_swaprequest < min_line_allowed) && (line_pre_swaprequest > 0)))) {
+	if ((timing->time_at_last_vbl > 0) && (vbl_synclevel!=2) && (!osspecific_asyncflip_scheduled) &&
+		((time_at_swaprequest - timing->time_at_last_vbl < 0.002) || ((line_pre_swaprequest < min_line_allowed) && (line_pre_swaprequest > 0)))) {
 		// Less than 2 msecs passed since last bufferswap, although swap in sync with retrace requested.
 		// Some drivers seem to have a bug where a bufferswap happens anywhere in the VBL period, even
 		// if already a swap happened in a VBL --> Multiple swaps per refresh cycle if this routine is
 		// called fast enough, ie. multiple times during one single VBL period. Not good!
 		// An example is the ATI Mobility Radeon X1600 in 2nd generation MacBookPro's under OS/X 10.4.10
 		// and 10.4.11 -- probably most cards operated by the same driver have the same problem...
-		if (verbosity > 9) printf("PTB-DEBUG: Swaprequest too close to last swap vbl (%f secs) or between forbidden scanline 1 and %i. Delaying...\n", time_at_swaprequest - windowRecord->time_at_last_vbl, min_line_allowed);
+		if (verbosity > 9) printf("PTB-DEBUG: Swaprequest too close to last swap vbl (%f secs) or between forbidden scanline 1 and %i. Delaying...\n", time_at_swaprequest - timing->time_at_last_vbl, min_line_allowed);
 
 		// We try to enforce correct behaviour by waiting until at least 2 msecs have elapsed before the next
 		// bufferswap:
-		PsychWaitUntilSeconds(windowRecord->time_at_last_vbl + 0.002);
+		PsychWaitUntilSeconds(timing->time_at_last_vbl + 0.002);
 
 		// We also wait until beam leaves the forbidden area between scanline 1 and min_line_allowed, where
 		// some broken drivers allow a swap to happen although the beam is already scanning out active
@@ -3599,9 +3930,9 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
         // creation of the onscreen window from the check, as deadline-miss is expected
         // in that case. We also disable the skipped frame detection if our own home-grown
         // frame-sequential stereo mode is active, as the detector can't work sensibly with it:
-        if ((time_at_vbl > tshouldflip) && (windowRecord->time_at_last_vbl!=0) && (windowRecord->stereomode != kPsychFrameSequentialStereo)) {
+        if ((time_at_vbl > tshouldflip) && (timing->time_at_last_vbl!=0) && (windowRecord->stereomode != kPsychFrameSequentialStereo)) {
             // Deadline missed!
-            windowRecord->nr_missed_deadlines = windowRecord->nr_missed_deadlines + 1;
+            timing->nr_missed_deadlines = timing->nr_missed_deadlines + 1;
         }
         
         // Return some estimate of how much we've missed our deadline (positive value) or
@@ -3609,16 +3940,16 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
         *miss_estimate = time_at_vbl - tshouldflip;
         
         // Update timestamp of last vbl:
-        windowRecord->time_at_last_vbl = time_at_vbl;
+        timing->time_at_last_vbl = time_at_vbl;
 
 		// Store raw-timestamp of swap completion, mostly for benchmark purposes:
-		windowRecord->rawtime_at_swapcompletion = time_at_swapcompletion;
+		timing->rawtime_at_swapcompletion = time_at_swapcompletion;
 		
 		// Store optional VBL-IRQ timestamp as well:
-		windowRecord->postflip_vbltimestamp = postflip_vbltimestamp;
+		timing->postflip_vbltimestamp = postflip_vbltimestamp;
 		
 		// Store optional OS-Builtin swap timestamp as well:
-		windowRecord->osbuiltin_swaptime = tSwapComplete;
+		timing->osbuiltin_swaptime = tSwapComplete;
     }
     else {
         // syncing to vbl is disabled, time_at_vbl becomes meaningless, so we set it to a
@@ -3628,14 +3959,14 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
         *beamPosAtFlip = -1;  // Ditto for beam position...
         
         // Invalidate timestamp of last vbl:
-        windowRecord->time_at_last_vbl = 0;
-        windowRecord->rawtime_at_swapcompletion = 0;
-        windowRecord->postflip_vbltimestamp = -1;
-        windowRecord->osbuiltin_swaptime = 0;
+        timing->time_at_last_vbl = 0;
+        timing->rawtime_at_swapcompletion = 0;
+        timing->postflip_vbltimestamp = -1;
+        timing->osbuiltin_swaptime = 0;
     }
 
 	// Increment the "flips successfully completed" counter:
-	windowRecord->flipCount++;
+	timing->flipCount++;
         
     // Part 2 of workaround- /checkcode for syncing to vertical retrace:
     if (vblsyncworkaround) {
@@ -3726,6 +4057,19 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     return(time_at_vbl);
 }
 
+// Synchronous flip which updates the timing bookkeeping of the window itself. See PsychFlipWindowBuffersTimed():
+double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip, int vbl_synclevel, int dont_clear, double flipwhen, int* beamPosAtFlip, double* miss_estimate, double* time_at_flipend, double* time_at_onset)
+{
+	PsychFlipTimingState timing;
+	double time_at_vbl;
+
+	PsychGetFlipTimingState(windowRecord, &timing);
+	time_at_vbl = PsychFlipWindowBuffersTimed(windowRecord, multiflip, vbl_synclevel, dont_clear, flipwhen, beamPosAtFlip, miss_estimate, time_at_flipend, time_at_onset, &timing);
+	PsychSetFlipTimingState(windowRecord, &timing);
+
+	return(time_at_vbl);
+}
+
 /*
     PsychSetGLContext()
     
@@ -4242,6 +4586,25 @@ void PsychVisualBell(PsychWindowRecordType *windowRecord, double duration, int b
  *
  */
 void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
+{
+	PsychPreFlipOperationsIntoFBO(windowRecord, clearmode, NULL);
+}
+
+// Return the FBO to use as pipeline stage with index 'fboindex' during preflip: This is the FBO from
+// the windows fboTable, unless it is the final output stage and a redirection 'targetFBO' is given.
+static PsychFBO** PsychPreFlipFBO(PsychWindowRecordType *windowRecord, int fboindex, PsychFBO** targetFBO)
+{
+	return(((targetFBO) && (fboindex == windowRecord->finalizedFBO[0])) ? targetFBO : &(windowRecord->fboTable[fboindex]));
+}
+
+/* PsychPreFlipOperationsIntoFBO() -- PsychPreFlipOperations() with optional redirection of the output.
+ *
+ * If 'targetFBO' is non-NULL, the final output of the imaging pipeline is rendered into that FBO instead of
+ * finalizedFBO[0], ie., usually instead of the system backbuffer. This is used to prepare queued async flips
+ * while older flips are still pending on the system backbuffer. Only supported in imaging mode without
+ * quad-buffered stereo or dual-window output, see PsychCanQueueAsyncFlips().
+ */
+static void PsychPreFlipOperationsIntoFBO(PsychWindowRecordType *windowRecord, int clearmode, PsychFBO** targetFBO)
 {
     int screenwidth=(int) PsychGetWidthFromRect(windowRecord->rect);
     int screenheight=(int) PsychGetHeightFromRect(windowRecord->rect);
@@ -4275,7 +4638,8 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 
     // Make sure we don't execute on an onscreen window with pending async flip, as this would interfere
     // by touching the system backbuffer -> Corruption of the flip-pending stimulus image by the new stimulus!
-    if (windowRecord->flipInfo->asyncstate > 0) {
+    // Redirected output into a targetFBO doesn't touch the backbuffer, so that is fine:
+    if ((windowRecord->flipInfo->asyncstate > 0) && (targetFBO == NULL)) {
         PsychErrorExitMsg(PsychError_internal, "PsychPreFlipOperations() called on onscreen window with pending async flip?!? Forbidden!");
     }
     
@@ -4460,13 +4824,13 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 					// srcfbos are read-only, swizzling forbidden, 2nd srcfbo doesn't exist (only needed for stereo merge op),
 					// We provide a bounce-buffer... We could bind the 2nd channel in steromode if we wanted. Should we?
 					// TODO: Define special userdata struct, e.g., for C-Callbacks or scripting callbacks?
-					PsychPipelineExecuteHook(windowRecord, hookchainid, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->inputBufferFBO[viewid]]), NULL, &(windowRecord->fboTable[windowRecord->processedDrawBufferFBO[viewid]]),  (windowRecord->processedDrawBufferFBO[2]>=0) ? &(windowRecord->fboTable[windowRecord->processedDrawBufferFBO[2]]) : NULL);
+					PsychPipelineExecuteHook(windowRecord, hookchainid, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->inputBufferFBO[viewid]]), NULL, PsychPreFlipFBO(windowRecord, windowRecord->processedDrawBufferFBO[viewid], targetFBO),  (windowRecord->processedDrawBufferFBO[2]>=0) ? PsychPreFlipFBO(windowRecord, windowRecord->processedDrawBufferFBO[2], targetFBO) : NULL);
 				}
 				else {
 					// Hook chain disabled by userspace or doesn't contain any instructions.
 					// Execute our special identity blit chain to transfer the data from source buffer
 					// to destination buffer:
-					PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->inputBufferFBO[viewid]]), NULL, &(windowRecord->fboTable[windowRecord->processedDrawBufferFBO[viewid]]), NULL);
+					PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->inputBufferFBO[viewid]]), NULL, PsychPreFlipFBO(windowRecord, windowRecord->processedDrawBufferFBO[viewid], targetFBO), NULL);
 				}
 			}
 		}
@@ -4486,7 +4850,7 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 				// srcfbos are read-only, swizzling forbidden, 2nd srcfbo is right-eye channel, whereas 1st srcfbo is left-eye channel.
 				// We provide a bounce-buffer as well.
 				// TODO: Define special userdata struct, e.g., for C-Callbacks or scripting callbacks?
-				PsychPipelineExecuteHook(windowRecord, kPsychStereoCompositingBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->processedDrawBufferFBO[0]]), &(windowRecord->fboTable[windowRecord->processedDrawBufferFBO[1]]), &(windowRecord->fboTable[windowRecord->preConversionFBO[0]]), (windowRecord->preConversionFBO[2]>=0) ? &(windowRecord->fboTable[windowRecord->preConversionFBO[2]]) : NULL);
+				PsychPipelineExecuteHook(windowRecord, kPsychStereoCompositingBlit, NULL, NULL, TRUE, FALSE, PsychPreFlipFBO(windowRecord, windowRecord->processedDrawBufferFBO[0], targetFBO), PsychPreFlipFBO(windowRecord, windowRecord->processedDrawBufferFBO[1], targetFBO), PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[0], targetFBO), (windowRecord->preConversionFBO[2]>=0) ? PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[2], targetFBO) : NULL);
 			}
 			else {
 				// Hook chain disabled by userspace or doesn't contain any instructions.
@@ -4516,7 +4880,7 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 		     (imagingMode & kPsychNeedDualWindowOutput)) ? 2 : 1); viewid++) {
 
 			// Select final drawbuffer if our target is the system framebuffer:
-			if (windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]->fboid == 0) {
+			if ((*PsychPreFlipFBO(windowRecord, windowRecord->finalizedFBO[viewid], targetFBO))->fboid == 0) {
 				// Final target is system backbuffer:
 				if (stereo_mode == kPsychOpenGLStereo) {
 					// Quad buffered stereo: Select proper backbuffer:
@@ -4540,11 +4904,11 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 					}
 
 					// Use proper per view output formatting chain:
-					PsychPipelineExecuteHook(windowRecord, ((viewid > 0) ? kPsychFinalOutputFormattingBlit1 : kPsychFinalOutputFormattingBlit0), NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->preConversionFBO[viewid]]), NULL, &(windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]), (windowRecord->preConversionFBO[2]>=0) ? &(windowRecord->fboTable[windowRecord->preConversionFBO[2]]) : NULL);
+					PsychPipelineExecuteHook(windowRecord, ((viewid > 0) ? kPsychFinalOutputFormattingBlit1 : kPsychFinalOutputFormattingBlit0), NULL, NULL, TRUE, FALSE, PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[viewid], targetFBO), NULL, PsychPreFlipFBO(windowRecord, windowRecord->finalizedFBO[viewid], targetFBO), (windowRecord->preConversionFBO[2]>=0) ? PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[2], targetFBO) : NULL);
 				}
 				else {
 					// Single unified formatting chain to be used:
-					PsychPipelineExecuteHook(windowRecord, kPsychFinalOutputFormattingBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->preConversionFBO[viewid]]), NULL, &(windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]), (windowRecord->preConversionFBO[2]>=0) ? &(windowRecord->fboTable[windowRecord->preConversionFBO[2]]) : NULL);
+					PsychPipelineExecuteHook(windowRecord, kPsychFinalOutputFormattingBlit, NULL, NULL, TRUE, FALSE, PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[viewid], targetFBO), NULL, PsychPreFlipFBO(windowRecord, windowRecord->finalizedFBO[viewid], targetFBO), (windowRecord->preConversionFBO[2]>=0) ? PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[2], targetFBO) : NULL);
 				}
 			}
 			else {
@@ -4553,7 +4917,7 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 				// applied. In that case, the image processing stage did the final blit already.
 				if (windowRecord->preConversionFBO[viewid] != windowRecord->finalizedFBO[viewid]) {
 					if ((imagingMode & kPsychNeedOutputConversion) && (PsychPrefStateGet_Verbosity()>3)) printf("PTB-INFO: Processing chain(s) for output conversion disabled -- Using identity copy as workaround.\n");
-					PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->preConversionFBO[viewid]]), NULL, &(windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]), NULL);				
+					PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, PsychPreFlipFBO(windowRecord, windowRecord->preConversionFBO[viewid], targetFBO), NULL, PsychPreFlipFBO(windowRecord, windowRecord->finalizedFBO[viewid], targetFBO), NULL);				
 				}
 			}
 			
@@ -4563,7 +4927,7 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
 			// use them e.g., to encode a frame index, a timestamp or a trigger signal into frames as well.
 			// Encoding CLUTs for devices like the Bits++ is conceivable as well - these would be automatically
 			// synchronous to frame updates and could be injected from our own gamma-table functions.
-			PsychPipelineExecuteHook(windowRecord, (viewid==0) ? kPsychLeftFinalizerBlit : kPsychRightFinalizerBlit, NULL, NULL, TRUE, FALSE, NULL, NULL, &(windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]), NULL);				
+			PsychPipelineExecuteHook(windowRecord, (viewid==0) ? kPsychLeftFinalizerBlit : kPsychRightFinalizerBlit, NULL, NULL, TRUE, FALSE, NULL, NULL, PsychPreFlipFBO(windowRecord, windowRecord->finalizedFBO[viewid], targetFBO), NULL);				
 		}
 		
 		// At this point we should have either a valid snapshot of the framebuffer in the finalizedFBOs, or
@@ -5074,8 +5438,8 @@ void PsychSetDrawingTarget(PsychWindowRecordType *windowRecord)
 						// rendering a stimulus to the drawBufferFBO and the async flipper thread clearing
 						// the drawBufferFBO, with rather hilarious results, depending on who wins the race.
 						// We check if we have an async flip + dontclear != 2 and warn the user about possible
-						// trouble in such a config:
-						if ((windowRecord->flipInfo->dont_clear != 2) && (windowRecord->flipInfo->asyncstate > 0) &&
+						// trouble in such a config. Queued flips are safe, as the master thread clears at queueing time:
+						if ((windowRecord->flipInfo->dont_clear != 2) && (windowRecord->flipInfo->asyncstate > 0) && (windowRecord->flipInfo->queueCount == 0) &&
 						    (PsychPrefStateGet_Verbosity() > 1)) {
 							printf("PTB-WARNING: You are drawing to an onscreen window while an async flip is pending on it and the\n");
 							printf("PTB-WARNING: async flip is executed with the 'dontclear' flag set to something else than 2.\n");
@@ -55,6 +55,7 @@ double	PsychGetWhiteValueFromWindow(PsychWindowRecordType *windowRecord);
 void	PsychSwitchFixedFunctionStereoDrawbuffer(PsychWindowRecordType *windowRecord);
 int	PsychRessourceCheckAndReminder(psych_bool displayMessage);
 psych_bool	PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord);
+psych_bool	PsychCanQueueAsyncFlips(PsychWindowRecordType *windowRecord);
 void	PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord);
 int	PsychSetShader(PsychWindowRecordType *windowRecord, int shader);
 void	PsychDetectAndAssignGfxCapabilities(PsychWindowRecordType *windowRecord);
@@ -224,6 +224,9 @@ PsychError PsychModuleInit(void)
 	PsychErrorExit(PsychRegister("AddFrameToMovie", &SCREENGetImage));
 	PsychErrorExit(PsychRegister("AddAudioBufferToMovie", &SCREENAddAudioBufferToMovie));
 	PsychErrorExit(PsychRegister("GetFlipInfo", &SCREENGetFlipInfo));
+	PsychErrorExit(PsychRegister("CreateDotField", &SCREENCreateDotField));
+	PsychErrorExit(PsychRegister("StepDotField", &SCREENStepDotField));
+	PsychErrorExit(PsychRegister("CloseDotField", &SCREENCloseDotField));
     
 	PsychSetModuleAuthorByInitials("awi");
 	PsychSetModuleAuthorByInitials("dhb");
@@ -0,0 +1,519 @@
+/*
+	SCREENDotField.c
+
+	AUTHORS:
+
+		mario.kleiner@tuebingen.mpg.de  mk
+
+	PLATFORMS:
+
+		All.
+
+	HISTORY:
+
+		10/17/26	mk		Created.
+
+	DESCRIPTION:
+
+		GPU resident dot fields for random dot motion stimuli: Screen('CreateDotField') creates a field
+		of dots whose complete state - positions, directions of motion, age and the assignment to the
+		coherently moving or the noise population - is kept in a pair of floating point framebuffer
+		objects on the GPU. Screen('StepDotField') advances the simulation by rendering a full screen
+		quad from one state buffer into the other with a GLSL fragment shader, copies the new positions
+		into a pixel buffer object which doubles as vertex buffer, and draws all dots with a single
+		glDrawArrays() call. No dot data ever needs to pass through the scripting environment or the
+		bus after creation.
+
+		State layout: One RGBA float texel per dot, (x, y, age, direction). x,y are positions relative to
+		the top-left corner of the dot field rect. direction is the direction of motion in radians for
+		noise dots, or a negative value for coherently moving dots, which use the common direction.
+
+	TO DO:
+
+*/
+
+#include "Screen.h"
+
+// Maximum number of simultaneously open dot fields:
+#define PSYCH_MAX_DOTFIELDS		32
+
+// Width of the state textures in dots. Height is chosen to hold all dots:
+#define PSYCH_DOTFIELD_WIDTH	1024
+
+typedef struct PsychDotFieldType {
+	PsychWindowRecordType	*parentRecord;		// Onscreen window whose OpenGL context holds the dot field. NULL == Free slot.
+	int						nrdots;				// Number of dots.
+	int						width;				// Width of state buffers.
+	int						height;				// Height of state buffers.
+	PsychRectType			rect;				// Field rect in window coordinates.
+	PsychFBO				*fbo[2];			// Ping-pong state buffers.
+	int						current;			// Index of fbo holding the current state.
+	GLuint					pbo;				// Buffer with the current state, used as vertex buffer for drawing.
+	GLuint					stepShader;			// GLSL program for one simulation step.
+	double					speed;				// Speed in pixels per step.
+	double					direction;			// Direction of coherent motion in degrees, 0 = rightward, 90 = upward.
+	double					coherence;			// Fraction of coherently moving dots.
+	double					lifetime;			// Lifetime of dots in steps.
+	psych_bool				reassign;			// Reassign coherent and noise dots in next step?
+} PsychDotFieldType;
+
+static PsychDotFieldType	dotFields[PSYCH_MAX_DOTFIELDS];
+static psych_bool			firstTime = TRUE;
+static unsigned int			dotFieldSeed = 1;
+
+// Fragment shader for one simulation step: Reads the old state of the dot at gl_FragCoord
+// from 'State' and writes its new state:
+static char dotFieldStepShaderSrc[] =
+"\n"
+"#extension GL_ARB_texture_rectangle : enable \n"
+" \n"
+"uniform sampler2DRect State; \n"
+"uniform vec2 FieldSize; \n"
+"uniform float Speed; \n"
+"uniform float Direction; \n"
+"uniform float Coherence; \n"
+"uniform float Lifetime; \n"
+"uniform float Reassign; \n"
+"uniform float Seed; \n"
+" \n"
+"float rand(float s) \n"
+"{ \n"
+"    return(fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233)) + s) * 43758.5453)); \n"
+"} \n"
+" \n"
+"void main() \n"
+"{ \n"
+"    vec4 d = texture2DRect(State, gl_FragCoord.xy); \n"
+" \n"
+"    /* Reassignment of dots to coherent and noise population after change of coherence: */ \n"
+"    if (Reassign > 0.0) d.w = (rand(Seed + 3.0) < Coherence) ? -1.0 : rand(Seed + 4.0) * 6.2831853; \n"
+" \n"
+"    /* Move, with wrap-around at the borders of the field. Screen y-axis points downwards: */ \n"
+"    float a = (d.w < 0.0) ? Direction : d.w; \n"
+"    d.xy = mod(d.xy + Speed * vec2(cos(a), -sin(a)), FieldSize); \n"
+"    d.z += 1.0; \n"
+" \n"
+"    /* End of lifetime: Respawn at random position, with new assignment: */ \n"
+"    if (d.z >= Lifetime) { \n"
+"        d.xy = vec2(rand(Seed), rand(Seed + 1.0)) * FieldSize; \n"
+"        d.z = 0.0; \n"
+"        d.w = (rand(Seed + 3.0) < Coherence) ? -1.0 : rand(Seed + 4.0) * 6.2831853; \n"
+"    } \n"
+" \n"
+"    gl_FragColor = d; \n"
+"} \n";
+
+// Simple linear congruential random number generator for initial state and per step seeds,
+// returns values in range [0, 1):
+static double PsychDotFieldRand(void)
+{
+	dotFieldSeed = dotFieldSeed * 1103515245U + 12345U;
+	return((double) ((dotFieldSeed >> 8) & 0xffffff) / 16777216.0);
+}
+
+static void PsychInitDotFields(void)
+{
+	int i;
+	double now;
+
+	if (!firstTime) return;
+	firstTime = FALSE;
+
+	for (i = 0; i < PSYCH_MAX_DOTFIELDS; i++) dotFields[i].parentRecord = NULL;
+	PsychGetPrecisionTimerSeconds(&now);
+	dotFieldSeed = (unsigned int) (now * 1000);
+
+	return;
+}
+
+// Release all OpenGL resources of a dot field and mark its slot free. The OpenGL context
+// of its parent window must be bound:
+static void PsychDeleteDotField(PsychDotFieldType *dotField)
+{
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		if (dotField->fbo[i]) {
+			if (dotField->fbo[i]->coltexid) glDeleteTextures(1, &(dotField->fbo[i]->coltexid));
+			if (dotField->fbo[i]->fboid) glDeleteFramebuffersEXT(1, &(dotField->fbo[i]->fboid));
+			free(dotField->fbo[i]);
+			dotField->fbo[i] = NULL;
+		}
+	}
+
+	if (dotField->pbo) glDeleteBuffersARB(1, &(dotField->pbo));
+	dotField->pbo = 0;
+	if (dotField->stepShader) glDeleteProgram(dotField->stepShader);
+	dotField->stepShader = 0;
+	dotField->parentRecord = NULL;
+
+	return;
+}
+
+// Retrieve dot field for handle in argument position 'position' and check it belongs to 'windowRecord':
+static PsychDotFieldType* PsychAllocInDotFieldArg(int position, PsychWindowRecordType *windowRecord)
+{
+	int handle;
+
+	PsychInitDotFields();
+	PsychCopyInIntegerArg(position, kPsychArgRequired, &handle);
+	if (handle < 1 || handle > PSYCH_MAX_DOTFIELDS || dotFields[handle - 1].parentRecord == NULL) PsychErrorExitMsg(PsychError_user, "Invalid dot field handle provided.");
+	if (windowRecord && (PsychGetParentWindow(windowRecord) != dotFields[handle - 1].parentRecord)) PsychErrorExitMsg(PsychError_user, "Dot field belongs to a different onscreen window than the given 'windowPtr'.");
+
+	return(&dotFields[handle - 1]);
+}
+
+/* PsychCloseDotFieldsOfWindow()
+ *
+ * Called from PsychCloseWindow() for onscreen windows, with their OpenGL context bound:
+ * Deletes all dot fields which live in the context of 'windowRecord'.
+ */
+void PsychCloseDotFieldsOfWindow(PsychWindowRecordType *windowRecord)
+{
+	int i;
+
+	if (firstTime) return;
+
+	for (i = 0; i < PSYCH_MAX_DOTFIELDS; i++) {
+		if (dotFields[i].parentRecord == windowRecord) PsychDeleteDotField(&dotFields[i]);
+	}
+
+	return;
+}
+
+static char useString[] = "dotField = Screen('CreateDotField', windowPtr, nrDots [, rect] [, speed=1] [, direction=0] [, coherence=1] [, lifetime=inf]);";
+//                                                              1          2         3         4            5               6               7
+static char synopsisString[] =
+	"Create a field of 'nrDots' moving dots for random dot motion stimuli and return a handle 'dotField' to it.\n"
+	"The state of all dots is kept in GPU memory and advanced on the GPU, so even fields of millions of dots "
+	"can be animated at display rate with only one call to Screen('StepDotField') per frame.\n"
+	"This function requires support for framebuffer objects, floating point textures, GLSL shaders and "
+	"pixel buffer objects.\n"
+	"'rect' is the rectangular area of the window covered by the field, default is the full window. Dots "
+	"which leave the field on one side reenter it on the opposite side.\n"
+	"'speed' is the speed of all dots in pixels per step, 'direction' the direction of coherent motion in "
+	"degrees: 0 = rightward, 90 = upward. 'coherence' is the fraction of dots, between 0 and 1, which move "
+	"coherently in 'direction'. All other dots move in a random direction, individually chosen for each "
+	"dot. 'lifetime' is the number of steps after which a dot disappears and is reborn at a random "
+	"position, with a new random assignment to the coherent or noise population. Dots start with random "
+	"ages. The default of inf means unlimited lifetime.\n"
+	"All motion parameters can be changed for each step in Screen('StepDotField').\n"
+	"The dot field is released by Screen('CloseDotField'), or automatically when its window is closed.\n";
+
+static char seeAlsoString[] = "StepDotField CloseDotField DrawDots";
+
+PsychError SCREENCreateDotField(void)
+{
+	PsychWindowRecordType	*windowRecord, *parentRecord;
+	PsychDotFieldType		*dotField;
+	GLfloat					*state;
+	GLint					maxsize;
+	double					nrdots, speed, direction, coherence, lifetime;
+	int						i, handle;
+
+	// All sub functions should have these two lines
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(7));
+	PsychErrorExit(PsychRequireNumInputArgs(2));
+	PsychErrorExit(PsychCapNumOutputArgs(1));
+
+	PsychInitDotFields();
+
+	PsychAllocInWindowRecordArg(1, kPsychArgRequired, &windowRecord);
+	parentRecord = PsychGetParentWindow(windowRecord);
+
+	PsychCopyInDoubleArg(2, kPsychArgRequired, &nrdots);
+	if (nrdots < 1 || nrdots > 16777216) PsychErrorExitMsg(PsychError_user, "Invalid 'nrDots' provided. Must be between 1 and 16777216.");
+
+	speed = 1;
+	direction = 0;
+	coherence = 1;
+	lifetime = DBL_MAX;
+	PsychCopyInDoubleArg(4, kPsychArgOptional, &speed);
+	PsychCopyInDoubleArg(5, kPsychArgOptional, &direction);
+	PsychCopyInDoubleArg(6, kPsychArgOptional, &coherence);
+	PsychCopyInDoubleArg(7, kPsychArgOptional, &lifetime);
+	if (coherence < 0 || coherence > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'coherence' provided. Must be between 0 and 1.");
+	if (lifetime < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'lifetime' provided. Must be at least 1 step.");
+
+	// Find free slot:
+	for (handle = 0; handle < PSYCH_MAX_DOTFIELDS && dotFields[handle].parentRecord; handle++);
+	if (handle == PSYCH_MAX_DOTFIELDS) PsychErrorExitMsg(PsychError_user, "Maximum number of simultaneously open dot fields exceeded. Close some via Screen('CloseDotField').");
+	dotField = &dotFields[handle];
+
+	PsychCopyRect(dotField->rect, windowRecord->clientrect);
+	PsychCopyInRectArg(3, kPsychArgOptional, dotField->rect);
+	if (IsPsychRectEmpty(dotField->rect)) PsychErrorExitMsg(PsychError_user, "Invalid empty 'rect' provided for the dot field.");
+
+	// Enable rendering context of window:
+	PsychSetGLContext(windowRecord);
+
+	if (!glewIsSupported("GL_EXT_framebuffer_object") || !(glewIsSupported("GL_ARB_texture_float") || glewIsSupported("GL_APPLE_float_pixels")) ||
+		!glewIsSupported("GL_ARB_texture_rectangle") || !glewIsSupported("GL_ARB_pixel_buffer_object") || !glewIsSupported("GL_ARB_vertex_buffer_object") ||
+		!glewIsSupported("GL_ARB_shader_objects") || !glewIsSupported("GL_ARB_shading_language_100") || !glewIsSupported("GL_ARB_fragment_shader")) {
+		PsychErrorExitMsg(PsychError_user, "Sorry, your graphics hardware lacks support for framebuffer objects, floating point textures, GLSL or pixel buffer objects, as needed for dot fields.");
+	}
+
+	dotField->nrdots = (int) nrdots;
+	dotField->width  = (dotField->nrdots < PSYCH_DOTFIELD_WIDTH) ? dotField->nrdots : PSYCH_DOTFIELD_WIDTH;
+	dotField->height = (dotField->nrdots + dotField->width - 1) / dotField->width;
+	glGetIntegerv(GL_MAX_RECTANGLE_TEXTURE_SIZE_EXT, &maxsize);
+	if (dotField->height > maxsize) PsychErrorExitMsg(PsychError_user, "Too many dots requested for your graphics hardware.");
+
+	dotField->speed = speed;
+	dotField->direction = direction;
+	dotField->coherence = coherence;
+	dotField->lifetime = lifetime;
+	dotField->reassign = FALSE;
+	dotField->current = 0;
+	dotField->fbo[0] = dotField->fbo[1] = NULL;
+	dotField->pbo = 0;
+	dotField->stepShader = 0;
+
+	// Safe reset of drawing engine, as we'll bind our own framebuffers:
+	PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+
+	// Mark slot as used, so PsychDeleteDotField() can clean up on failure:
+	dotField->parentRecord = parentRecord;
+
+	if (!PsychCreateFBO(&(dotField->fbo[0]), GL_RGBA_FLOAT32_APPLE, FALSE, dotField->width, dotField->height, 0) ||
+		!PsychCreateFBO(&(dotField->fbo[1]), GL_RGBA_FLOAT32_APPLE, FALSE, dotField->width, dotField->height, 0)) {
+		PsychDeleteDotField(dotField);
+		PsychPipelineSetupRenderFlow(NULL, NULL, NULL, TRUE);
+		PsychErrorExitMsg(PsychError_system, "Failed to create state buffers for dot field.");
+	}
+	PsychPipelineSetupRenderFlow(NULL, NULL, NULL, TRUE);
+
+	dotField->stepShader = PsychCreateGLSLProgram(dotFieldStepShaderSrc, NULL, NULL);
+	if (dotField->stepShader == 0) {
+		PsychDeleteDotField(dotField);
+		PsychErrorExitMsg(PsychError_system, "Failed to create simulation shader for dot field.");
+	}
+
+	// Initial state: Random positions, ages and directions, assignment according to coherence:
+	state = (GLfloat*) PsychMallocTemp(sizeof(GLfloat) * 4 * dotField->width * dotField->height);
+	for (i = 0; i < dotField->width * dotField->height; i++) {
+		state[i*4 + 0] = (GLfloat) (PsychDotFieldRand() * PsychGetWidthFromRect(dotField->rect));
+		state[i*4 + 1] = (GLfloat) (PsychDotFieldRand() * PsychGetHeightFromRect(dotField->rect));
+		state[i*4 + 2] = (GLfloat) ((lifetime < 16777216) ? floor(PsychDotFieldRand() * lifetime) : 0);
+		state[i*4 + 3] = (GLfloat) ((PsychDotFieldRand() < coherence) ? -1 : PsychDotFieldRand() * 2 * 3.14159265358979323846);
+	}
+
+	glBindTexture(GL_TEXTURE_RECTANGLE_EXT, dotField->fbo[0]->coltexid);
+	glTexSubImage2D(GL_TEXTURE_RECTANGLE_EXT, 0, 0, 0, dotField->width, dotField->height, GL_RGBA, GL_FLOAT, state);
+	glBindTexture(GL_TEXTURE_RECTANGLE_EXT, 0);
+
+	// Vertex buffer for drawing, initialized with the same state:
+	glGenBuffersARB(1, &(dotField->pbo));
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, dotField->pbo);
+	glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(GLfloat) * 4 * dotField->width * dotField->height, state, GL_STREAM_COPY_ARB);
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+
+	if (glGetError() != GL_NO_ERROR) {
+		PsychDeleteDotField(dotField);
+		PsychErrorExitMsg(PsychError_system, "Failed to initialize dot field. Maybe out of graphics memory?");
+	}
+
+	if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Created dot field %i with %i dots in %i x %i state buffers.\n", handle + 1, dotField->nrdots, dotField->width, dotField->height);
+
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) (handle + 1));
+
+	return(PsychError_none);
+}
+
+static char useStepString[] = "Screen('StepDotField', windowPtr, dotField [, nrSteps=1] [, size=1] [, color] [, dot_type=0] [, speed] [, direction] [, coherence] [, lifetime]);";
+//                                                    1          2           3             4          5          6              7          8              9              10
+static char synopsisStepString[] =
+	"Advance the dots of dot field 'dotField', created by Screen('CreateDotField'), by 'nrSteps' "
+	"simulation steps on the GPU and draw all dots into window 'windowPtr'. 'windowPtr' must be "
+	"the window used for creation of the dot field, or an offscreen window or texture of it. A 'nrSteps' "
+	"of zero draws the current state without advancing it, e.g., for drawing into both views of a stereo "
+	"window.\n"
+	"'size', 'color' and 'dot_type' define how the dots are drawn, with the same meaning as in "
+	"Screen('DrawDots'), except that only one common 'size' and 'color' are supported.\n"
+	"The optional 'speed', 'direction', 'coherence' and 'lifetime' change the motion parameters "
+	"of the dot field, see help for Screen('CreateDotField'). If 'coherence' changes, all dots are "
+	"immediately reassigned to the coherent and noise populations.\n";
+
+static char seeAlsoStepString[] = "CreateDotField CloseDotField DrawDots";
+
+PsychError SCREENStepDotField(void)
+{
+	PsychWindowRecordType	*windowRecord;
+	PsychDotFieldType		*dotField;
+	PsychColorType			color;
+	GLfloat					pointsizerange[2];
+	double					nrsteps, size, dot_type, coherence, lifetime;
+	int						i;
+
+	// All sub functions should have these two lines
+	PsychPushHelp(useStepString, synopsisStepString, seeAlsoStepString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(10));
+	PsychErrorExit(PsychRequireNumInputArgs(2));
+	PsychErrorExit(PsychCapNumOutputArgs(0));
+
+	PsychAllocInWindowRecordArg(1, kPsychArgRequired, &windowRecord);
+	dotField = PsychAllocInDotFieldArg(2, windowRecord);
+
+	nrsteps = 1;
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &nrsteps);
+	if (nrsteps < 0) PsychErrorExitMsg(PsychError_user, "Invalid negative 'nrSteps' provided.");
+
+	size = 1;
+	PsychCopyInDoubleArg(4, kPsychArgOptional, &size);
+
+	if (!PsychCopyInColorArg(5, kPsychArgOptional, &color)) PsychLoadColorStruct(&color, kPsychIndexColor, PsychGetWhiteValueFromWindow(windowRecord));
+
+	dot_type = 0;
+	PsychCopyInDoubleArg(6, kPsychArgOptional, &dot_type);
+	if (dot_type < 0 || dot_type > 2) PsychErrorExitMsg(PsychError_user, "dot_type must be 0, 1 or 2");
+
+	PsychCopyInDoubleArg(7, kPsychArgOptional, &(dotField->speed));
+	PsychCopyInDoubleArg(8, kPsychArgOptional, &(dotField->direction));
+
+	coherence = dotField->coherence;
+	PsychCopyInDoubleArg(9, kPsychArgOptional, &coherence);
+	if (coherence < 0 || coherence > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'coherence' provided. Must be between 0 and 1.");
+	if (coherence != dotField->coherence) dotField->reassign = TRUE;
+	dotField->coherence = coherence;
+
+	lifetime = dotField->lifetime;
+	PsychCopyInDoubleArg(10, kPsychArgOptional, &lifetime);
+	if (lifetime < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'lifetime' provided. Must be at least 1 step.");
+	dotField->lifetime = lifetime;
+
+	if (nrsteps > 0) {
+		// Safe reset of drawing engine, as we'll bind our own framebuffers:
+		PsychSetGLContext(windowRecord);
+		PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+
+		glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
+		glDisable(GL_BLEND);
+		glDisable(GL_SCISSOR_TEST);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glLoadIdentity();
+
+		PsychSetShader(windowRecord, dotField->stepShader);
+		glUniform1i(glGetUniformLocation(dotField->stepShader, "State"), 0);
+		glUniform2f(glGetUniformLocation(dotField->stepShader, "FieldSize"), (GLfloat) PsychGetWidthFromRect(dotField->rect), (GLfloat) PsychGetHeightFromRect(dotField->rect));
+		glUniform1f(glGetUniformLocation(dotField->stepShader, "Speed"), (GLfloat) dotField->speed);
+		glUniform1f(glGetUniformLocation(dotField->stepShader, "Direction"), (GLfloat) (dotField->direction * 3.14159265358979323846 / 180.0));
+		glUniform1f(glGetUniformLocation(dotField->stepShader, "Coherence"), (GLfloat) dotField->coherence);
+		glUniform1f(glGetUniformLocation(dotField->stepShader, "Lifetime"), (GLfloat) ((dotField->lifetime < 1e30) ? dotField->lifetime : 1e30));
+
+		// One full quad over the state buffer per step, ping-ponging between both buffers:
+		for (i = 0; i < (int) nrsteps; i++) {
+			PsychPipelineSetupRenderFlow(dotField->fbo[dotField->current], NULL, dotField->fbo[1 - dotField->current], TRUE);
+			glUniform1f(glGetUniformLocation(dotField->stepShader, "Reassign"), (dotField->reassign) ? 1.0f : 0.0f);
+			glUniform1f(glGetUniformLocation(dotField->stepShader, "Seed"), (GLfloat) (PsychDotFieldRand() * 1000.0));
+			dotField->reassign = FALSE;
+
+			glBegin(GL_QUADS);
+			glVertex2i(0, 0);
+			glVertex2i(dotField->width, 0);
+			glVertex2i(dotField->width, dotField->height);
+			glVertex2i(0, dotField->height);
+			glEnd();
+
+			dotField->current = 1 - dotField->current;
+		}
+
+		// Copy new state into the vertex buffer, without round trip to host memory:
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, dotField->pbo);
+		glReadPixels(0, 0, dotField->width, dotField->height, GL_RGBA, GL_FLOAT, NULL);
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+		// Restore state and unbind our framebuffers and textures:
+		PsychSetShader(windowRecord, 0);
+		glPopMatrix();
+		glPopAttrib();
+		PsychPipelineSetupRenderFlow(NULL, NULL, NULL, TRUE);
+	}
+
+	// Draw all dots of the field:
+	PsychSetDrawingTarget(windowRecord);
+	PsychSetShader(windowRecord, -1);
+	PsychUpdateAlphaBlendingFactorLazily(windowRecord);
+	PsychCoerceColorMode(&color);
+	PsychSetGLColor(&color, windowRecord);
+
+	if (dot_type > 0) {
+		glEnable(GL_POINT_SMOOTH);
+		glGetFloatv(GL_POINT_SIZE_RANGE, (GLfloat*) &pointsizerange);
+		glHint(GL_POINT_SMOOTH_HINT, (dot_type > 1) ? GL_NICEST : GL_DONT_CARE);
+	}
+	else {
+		#ifndef GL_ALIASED_POINT_SIZE_RANGE
+		#define GL_ALIASED_POINT_SIZE_RANGE 0x846D
+		#endif
+
+		glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, (GLfloat*) &pointsizerange);
+	}
+
+	if (size > pointsizerange[1] || size < pointsizerange[0]) {
+		if (dot_type > 0) glDisable(GL_POINT_SMOOTH);
+		printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
+			   size, pointsizerange[0], pointsizerange[1]);
+		PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('StepDotField').");
+	}
+	glPointSize((GLfloat) size);
+
+	// Positions are relative to the top-left corner of the field:
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glTranslated(dotField->rect[kPsychLeft], dotField->rect[kPsychTop], 0);
+
+	// The x,y components of the state are the vertex positions:
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, dotField->pbo);
+	glVertexPointer(2, GL_FLOAT, 4 * sizeof(GLfloat), NULL);
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glDrawArrays(GL_POINTS, 0, dotField->nrdots);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_DOUBLE, 0, NULL);
+
+	glPopMatrix();
+
+	if (dot_type > 0) glDisable(GL_POINT_SMOOTH);
+	glPointSize(1);
+
+	// Mark end of drawing op. This is needed for single buffered drawing:
+	PsychFlushGL(windowRecord);
+
+	return(PsychError_none);
+}
+
+static char useCloseString[] = "Screen('CloseDotField', dotField);";
+//                                                      1
+static char synopsisCloseString[] =
+	"Release the dot field 'dotField', created by Screen('CreateDotField'), and all of its resources.\n";
+
+static char seeAlsoCloseString[] = "CreateDotField StepDotField";
+
+PsychError SCREENCloseDotField(void)
+{
+	PsychDotFieldType		*dotField;
+
+	// All sub functions should have these two lines
+	PsychPushHelp(useCloseString, synopsisCloseString, seeAlsoCloseString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(1));
+	PsychErrorExit(PsychRequireNumInputArgs(1));
+	PsychErrorExit(PsychCapNumOutputArgs(0));
+
+	dotField = PsychAllocInDotFieldArg(1, NULL);
+
+	// Need the OpenGL context of the dot field for deletion:
+	PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+	PsychSetGLContext(dotField->parentRecord);
+	PsychDeleteDotField(dotField);
+
+	return(PsychError_none);
+}
@@ -46,6 +46,8 @@
 		3/22/05     mk      Added possibility to spec vectors with individual color and size spec per dot.
 		4/29/05     mk      Bugfix for color vectors: They should also take values in range 0-255 instead of 0.0-1.0.
 		11/14/06    mk      We now also accept color vectors in uint8 format and pass them directly for higher efficiency.
+		10/17/26    mk      Submit positions as float via a streaming VBO. Draw dots of different sizes with
+							one draw call, using a vertex shader which sets the size of each point.
 		
 	TO DO:
  
@@ -54,6 +56,19 @@
 
 #include "Screen.h"
 
+// Vertex shader for dots of individual sizes: Passes through position and color,
+// and sets the point size from the per-vertex attribute 'pointSize':
+static char pointSizeVertexShaderSrc[] =
+"\n"
+"attribute float pointSize; \n"
+" \n"
+"void main() \n"
+"{ \n"
+"    gl_FrontColor = gl_Color; \n"
+"    gl_Position = ftransform(); \n"
+"    gl_PointSize = pointSize; \n"
+"} \n";
+
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
 static char useString[] = "Screen('DrawDots', windowPtr, xy [,size] [,color] [,center] [,dot_type]);";
 //                                            1          2    3       4        5         6
@@ -72,7 +87,9 @@ static char synopsisString[] =
 "0 (default) squares, 1 circles (with anti-aliasing), 2 circles (with high-quality "
 "anti-aliasing, if supported by your hardware). "
 "If you use dot_type = 1 you'll also need to set a proper blending mode with the "
-"Screen('BlendFunction') command!";  
+"Screen('BlendFunction') command!\n"
+"Dots with individual sizes are drawn with a single draw call on graphics hardware "
+"with GLSL vertex shader support, and with one call per dot otherwise.";  
 static char seeAlsoString[] = "BlendFunction";	 
 
 PsychError SCREENDrawDots(void)  
@@ -85,6 +102,10 @@ PsychError SCREENDrawDots(void)
 	unsigned char                           *bytecolors;
 	GLfloat									pointsizerange[2];
 	double									convfactor;
+	PsychWindowRecordType					*parentRecord;
+	GLfloat									*vertices, *base;
+	GLint									sizeAttrib;
+	psych_bool								usepointshader;
     
 	// All sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -160,6 +181,30 @@ PsychError SCREENDrawDots(void)
 		PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
 	}
 	
+	// Different size for each dot provided? Validate all of them before drawing anything:
+	for (i=1; (nrsize > 1) && (i < nrpoints); i++) {
+		if (size[i] > pointsizerange[1] || size[i] < pointsizerange[0]) {
+			printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
+				   size[i], pointsizerange[0], pointsizerange[1]);
+			PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
+		}
+	}
+
+	// Different sizes can be drawn in one call via our vertex shader, unless a draw shader for
+	// high precision colors is active. Create the shader on first use:
+	parentRecord = PsychGetParentWindow(windowRecord);
+	if ((nrsize > 1) && (parentRecord->pointSizeShader == 0) && !windowRecord->defaultDrawShader) {
+		if (glewIsSupported("GL_ARB_shader_objects") && glewIsSupported("GL_ARB_shading_language_100") && glewIsSupported("GL_ARB_vertex_shader")) {
+			parentRecord->pointSizeShader = (GLint) PsychCreateGLSLProgram(NULL, pointSizeVertexShaderSrc, NULL);
+		}
+
+		if (parentRecord->pointSizeShader == 0) {
+			if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Failed to create shader for drawing dots of different sizes. Using slower fallback path.\n");
+			parentRecord->pointSizeShader = -1;
+		}
+	}
+	usepointshader = ((nrsize > 1) && (parentRecord->pointSizeShader > 0) && !windowRecord->defaultDrawShader) ? TRUE : FALSE;
+
 	// Setup initial common point size for all points:
 	glPointSize(size[0]);
 	
@@ -178,34 +223,44 @@ PsychError SCREENDrawDots(void)
 	// associated with the original implementation below and is potentially
 	// optimized in specific OpenGL implementations.
 	
+	// Convert point coordinates - and individual sizes for the shader - to float, which
+	// halves the amount of data to transfer, and stream them into a VBO if possible:
+	vertices = (GLfloat*) PsychMallocTemp(sizeof(GLfloat) * ((usepointshader) ? 3 : 2) * nrpoints);
+	for (i=0; i < 2 * nrpoints; i++) vertices[i] = (GLfloat) xy[i];
+	for (i=0; usepointshader && i < nrpoints; i++) vertices[2 * nrpoints + i] = (GLfloat) size[i];
+	base = PsychStreamVertexData(windowRecord, vertices, sizeof(GLfloat) * ((usepointshader) ? 3 : 2) * nrpoints);
+
 	// Pass a pointer to the start of the point-coordinate array:
-	glVertexPointer(2, GL_DOUBLE, 0, &xy[0]);
+	glVertexPointer(2, GL_FLOAT, 0, base);
 	
 	// Enable fast rendering of arrays:
 	glEnableClientState(GL_VERTEX_ARRAY);
 	
+	if (usepointshader) {
+		// Point sizes are passed as vertex attribute to the shader:
+		PsychSetShader(windowRecord, parentRecord->pointSizeShader);
+		sizeAttrib = glGetAttribLocation(parentRecord->pointSizeShader, "pointSize");
+		glVertexAttribPointer(sizeAttrib, 1, GL_FLOAT, GL_FALSE, 0, base + 2 * nrpoints);
+		glEnableVertexAttribArray(sizeAttrib);
+		glEnable(GL_VERTEX_PROGRAM_POINT_SIZE_ARB);
+	}
+
+	PsychReleaseStreamVertexData(windowRecord);
+
 	if (usecolorvector) {
 		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
 	}
 	
 	// Render all n points, starting at point 0, render them as POINTS:
-	if (nrsize==1) {
-		// One common point size for all dots provided. Good! This is very efficiently
-		// done with one single render-call:
+	if (nrsize==1 || usepointshader) {
+		// One common point size for all dots provided, or individual sizes handled by
+		// our shader. Good! This is very efficiently done with one single render-call:
 		glDrawArrays(GL_POINTS, 0, nrpoints);
 	}
 	else {
-		// Different size for each dot provided: We have to do One GL - call per dot.
-		// This is *pretty inefficient* and should be reimplemented in the future via
-		// Point-Sprite extensions, cleverly used display lists or via vertex-shaders...
-		// For now we do it the stupid way:
+		// Different size for each dot provided, but no shader support: We have to do
+		// One GL - call per dot. This is *pretty inefficient*:
 		for (i=0; i<nrpoints; i++) {
-			if (size[i] > pointsizerange[1] || size[i] < pointsizerange[0]) {
-				printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
-					   size[i], pointsizerange[0], pointsizerange[1]);
-				PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
-			}
-			
 			// Setup point size for this point:
 			glPointSize(size[i]);
 			
@@ -214,6 +269,12 @@ PsychError SCREENDrawDots(void)
 		}
 	}
 	
+	if (usepointshader) {
+		glDisable(GL_VERTEX_PROGRAM_POINT_SIZE_ARB);
+		glDisableVertexAttribArray(sizeAttrib);
+		PsychSetShader(windowRecord, -1);
+	}
+
 	// Disable fast rendering of arrays:
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(2, GL_DOUBLE, 0, NULL);
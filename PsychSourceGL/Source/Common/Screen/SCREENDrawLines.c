@@ -51,6 +51,8 @@ SCREENDrawLines.c
 		4/22/05     mk      Small bug fix (size = PsychMallocTemp.....)
 		12/4/06		mk		Rewrite to make it functional again and to implement a similar
 							syntax to Screen('DrawDots').
+		10/17/26	mk		Submit positions as float via a streaming VBO. Draw lines of different widths
+							with one draw call, by expanding them into quads on the CPU.
 
  */
 
@@ -72,7 +74,9 @@ static char synopsisString[] =
 "line segment, PTB will generate a smooth transition of colors along the line via linear interpolation. "
 "The default color is white if colors is omitted. \"smooth\" is a flag that determines whether lines "
 "should be smoothed: 0 (default) no smoothing, 1 smoothing (with anti-aliasing). If you use smoothing, "
-"you'll also need to set a proper blending mode with Screen('BlendFunction').";
+"you'll also need to set a proper blending mode with Screen('BlendFunction').\n"
+"Non-smoothed lines with individual widths are drawn as one batch of rectangles, each exactly "
+"\"width\" pixels wide, perpendicular to the direction of the line. ";
   
 static char seeAlsoString[] = "BlendFunction";	 
 
@@ -85,7 +89,11 @@ PsychError SCREENDrawLines(void)
 	double						*xy, *size, *center, *dot_type, *colors;
 	unsigned char               *bytecolors;
 	float						linesizerange[2];
-	double						convfactor;
+	double						convfactor, dx, dy, len, w;
+	GLfloat						*vertices, *v;
+	double						*vcolors;
+	unsigned char				*vbytecolors;
+	int							j, k, nverts;
 
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -156,12 +164,57 @@ PsychError SCREENDrawLines(void)
 	// of vertices (or lines, in this case). It saves the call overhead
 	// associated with the original implementation below and is potentially
 	// optimized in specific OpenGL implementations.
-	
-	// Pass a pointer to the start of the arrays:
-	glVertexPointer(2, GL_DOUBLE, 0, &xy[0]);
-	
+
+	if (nrsize > 1 && nrsize < nrvertices/2) PsychErrorExitMsg(PsychError_user, "Width vector must contain one width value per line.");
+
+	vcolors = colors;
+	vbytecolors = bytecolors;
+
+	if (nrsize > 1 && !smooth) {
+		// Different line-width per line: Expand each line into a quad of its width, so all lines
+		// can be drawn with one call. Colors of start- and endpoint get replicated to the two
+		// corresponding vertices of each quad:
+		nverts = (nrvertices / 2) * 4;
+		vertices = (GLfloat*) PsychMallocTemp(sizeof(GLfloat) * 2 * nverts);
+		if (usecolorvector && colors) vcolors = (double*) PsychMallocTemp(sizeof(double) * mc * nverts);
+		if (usecolorvector && bytecolors) vbytecolors = (unsigned char*) PsychMallocTemp(sizeof(unsigned char) * mc * nverts);
+
+		v = vertices;
+		for (i=0; i < nrvertices/2; i++) {
+			// Offset perpendicular to the line, half the line-width long:
+			dx = xy[i*4+2] - xy[i*4];
+			dy = xy[i*4+3] - xy[i*4+1];
+			len = sqrt(dx * dx + dy * dy);
+			w = (len > 0) ? size[i] / (2 * len) : 0;
+			dx *= w;
+			dy *= w;
+
+			*(v++) = (GLfloat) (xy[i*4]   - dy);	*(v++) = (GLfloat) (xy[i*4+1] + dx);
+			*(v++) = (GLfloat) (xy[i*4]   + dy);	*(v++) = (GLfloat) (xy[i*4+1] - dx);
+			*(v++) = (GLfloat) (xy[i*4+2] + dy);	*(v++) = (GLfloat) (xy[i*4+3] - dx);
+			*(v++) = (GLfloat) (xy[i*4+2] - dy);	*(v++) = (GLfloat) (xy[i*4+3] + dx);
+
+			for (j=0; usecolorvector && j < 4; j++) {
+				for (k=0; k < mc; k++) {
+					if (colors) vcolors[(i*4+j)*mc+k] = colors[(i*2+j/2)*mc+k];
+					if (bytecolors) vbytecolors[(i*4+j)*mc+k] = bytecolors[(i*2+j/2)*mc+k];
+				}
+			}
+		}
+	}
+	else {
+		// Convert coordinates to float, which halves the amount of data to transfer:
+		nverts = nrvertices;
+		vertices = (GLfloat*) PsychMallocTemp(sizeof(GLfloat) * 2 * nverts);
+		for (i=0; i < 2 * nverts; i++) vertices[i] = (GLfloat) xy[i];
+	}
+
+	// Pass a pointer to the start of the arrays, streamed into a VBO if possible:
+	glVertexPointer(2, GL_FLOAT, 0, PsychStreamVertexData(windowRecord, vertices, sizeof(GLfloat) * 2 * nverts));
+	PsychReleaseStreamVertexData(windowRecord);
+
 	if (usecolorvector) {
-		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, vcolors, vbytecolors);
 	}
 
 	// Enable fast rendering of arrays:
@@ -171,8 +224,13 @@ PsychError SCREENDrawLines(void)
 		// Common line-width for all lines: Render all lines, starting at line 0:
 		glDrawArrays(GL_LINES, 0, nrvertices);
 	}
+	else if (!smooth) {
+		// Different line-width per line, expanded into quads: Render all of them at once:
+		glDrawArrays(GL_QUADS, 0, nverts);
+	}
 	else {
-		// Different line-width per line: Need to manually loop through this mess:
+		// Different line-width per line with smoothing: Need to manually loop through this mess,
+		// as smoothing is only applied to real lines:
 		for (i=0; i < nrvertices/2; i++) {
 	      glLineWidth(size[i]);
 
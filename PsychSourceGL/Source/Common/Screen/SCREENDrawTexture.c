@@ -235,6 +235,13 @@ PsychError SCREENDrawTextures(void)
 	int textureShader, backupShader;
 	int specialFlags = 0;
 
+	PsychWindowRecordType			**batchSources;
+	double							*batchSrcRects, *batchDstRects, *batchAngles;
+	int								*batchFilterModes;
+	GLfloat							*batchColors;
+	int								batchCount;
+	psych_bool						batchable;
+
     //all subfunctions should have these two lines.  
     PsychPushHelp(useString, synopsisString, seeAlsoString);
     if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
@@ -408,6 +415,25 @@ PsychError SCREENDrawTextures(void)
 
 	// Ok, everything consistent so far.
 	
+	// Textures which don't need per-texture shader parameters get collected into batches and drawn
+	// with few state changes and draw calls by PsychBatchBlitTexturesToDisplay(), all others get
+	// drawn one by one. A batch gets flushed before drawing any of the others to keep drawing order:
+	batchCount = 0;
+	if ((numRef > 1) && (textureShader == -1)) {
+		batchSources = (PsychWindowRecordType**) PsychMallocTemp(numRef * sizeof(PsychWindowRecordType*));
+		batchSrcRects = (double*) PsychMallocTemp(numRef * 4 * sizeof(double));
+		batchDstRects = (double*) PsychMallocTemp(numRef * 4 * sizeof(double));
+		batchAngles = (double*) PsychMallocTemp(numRef * sizeof(double));
+		batchFilterModes = (int*) PsychMallocTemp(numRef * sizeof(int));
+		batchColors = (GLfloat*) PsychMallocTemp(numRef * 4 * sizeof(GLfloat));
+	}
+	else {
+		batchSources = NULL;
+		batchSrcRects = batchDstRects = batchAngles = NULL;
+		batchFilterModes = NULL;
+		batchColors = NULL;
+	}
+
 	// Texture blitting loop:
 	for (i=0; i < numRef; i++) {
 		// Draw i'th texture:
@@ -470,6 +496,18 @@ PsychError SCREENDrawTextures(void)
 		// Disable alpha if modulateColor active:
 		if (nc > 0) globalAlpha = DBL_MAX;
 
+		// Ok, everything assigned. Check parameters:
+		if (filterMode<0 || filterMode>3) {
+			PsychErrorExitMsg(PsychError_user, "filterMode needs to be 0 for nearest neighbour filter, or 1 for bilinear filter, or 2 for mipmapped filter or 3 for mipmapped-linear filter.");    
+		}
+
+		// Can this one go into the batch? Otherwise draw the batch so far before drawing this one:
+		batchable = (batchSources != NULL) && PsychCanBatchBlitTexture(source, target);
+		if (!batchable && (batchCount > 0)) {
+			PsychBatchBlitTexturesToDisplay(target, batchCount, batchSources, batchSrcRects, batchDstRects, batchAngles, batchFilterModes, batchColors, specialFlags);
+			batchCount = 0;
+		}
+
 		// Pass auxParameters for current primitive in the auxShaderParams field.
 		target->auxShaderParamsCount = numAuxComponents;
 		if (numAuxParams > 0) {
@@ -487,11 +525,12 @@ PsychError SCREENDrawTextures(void)
 		// Multiple modulateColors provided?
 		if (nc > 1) {
 			// Yes. Set it up as current vertex color: We submit to internal currentColor for
-			// shader based color processing and via glColorXXX() for fixed pipe processing:
+			// shader based color processing and via glColorXXX() for fixed pipe processing.
+			// Batched textures get their color via the vertex color array instead:
 			if (mc==3) {
 				if (colors) {
 					// RGB double:
-					glColor3dv(&(colors[i*3]));
+					if (!batchable) glColor3dv(&(colors[i*3]));
 					target->currentColor[0]=colors[i*3 + 0];
 					target->currentColor[1]=colors[i*3 + 1];
 					target->currentColor[2]=colors[i*3 + 2];
@@ -499,7 +538,7 @@ PsychError SCREENDrawTextures(void)
 				}
 				else {
 					// RGB uint8:
-					glColor3ubv(&(bytecolors[i*3]));
+					if (!batchable) glColor3ubv(&(bytecolors[i*3]));
 					target->currentColor[0]=((double) bytecolors[i*3 + 0] / 255.0);
 					target->currentColor[1]=((double) bytecolors[i*3 + 1] / 255.0);
 					target->currentColor[2]=((double) bytecolors[i*3 + 2] / 255.0);
@@ -509,7 +548,7 @@ PsychError SCREENDrawTextures(void)
 			else {
 				if (colors) {
 					// RGBA double:
-					glColor4dv(&(colors[i*4]));
+					if (!batchable) glColor4dv(&(colors[i*4]));
 					target->currentColor[0]=colors[i*4 + 0];
 					target->currentColor[1]=colors[i*4 + 1];
 					target->currentColor[2]=colors[i*4 + 2];
@@ -517,7 +556,7 @@ PsychError SCREENDrawTextures(void)
 				}
 				else {
 					// RGBA uint8:
-					glColor4ubv(&(bytecolors[i*4]));
+					if (!batchable) glColor4ubv(&(bytecolors[i*4]));
 					target->currentColor[0]=((double) bytecolors[i*4 + 0] / 255.0);
 					target->currentColor[1]=((double) bytecolors[i*4 + 1] / 255.0);
 					target->currentColor[2]=((double) bytecolors[i*4 + 2] / 255.0);
@@ -526,9 +565,18 @@ PsychError SCREENDrawTextures(void)
 			}			
 		}
 		
-		// Ok, everything assigned. Check parameters:
-		if (filterMode<0 || filterMode>3) {
-			PsychErrorExitMsg(PsychError_user, "filterMode needs to be 0 for nearest neighbour filter, or 1 for bilinear filter, or 2 for mipmapped filter or 3 for mipmapped-linear filter.");    
+		if (batchable) {
+			// Append to batch, with the modulateColor, or the globalAlpha as modulate color:
+			batchSources[batchCount] = source;
+			PsychCopyRect(&(batchSrcRects[batchCount * 4]), sourceRect);
+			PsychCopyRect(&(batchDstRects[batchCount * 4]), targetRect);
+			batchAngles[batchCount] = rotationAngle;
+			batchFilterModes[batchCount] = (int) filterMode;
+			for (j = 0; j < 4; j++) batchColors[batchCount * 4 + j] = (GLfloat) ((nc > 0) ? target->currentColor[j] : ((j < 3) ? 1.0 : globalAlpha));
+			batchCount++;
+
+			// Next one...
+			continue;
 		}
 
 		// Set rotation mode flag for texture matrix rotation if secialFlags is set accordingly:
@@ -552,6 +600,9 @@ PsychError SCREENDrawTextures(void)
 		// Next one...
 	}
 
+	// Draw remaining batch:
+	if (batchCount > 0) PsychBatchBlitTexturesToDisplay(target, batchCount, batchSources, batchSrcRects, batchDstRects, batchAngles, batchFilterModes, batchColors, specialFlags);
+
 	target->auxShaderParams = NULL;
 	target->auxShaderParamsCount = 0;
 
@@ -19,6 +19,7 @@
 		10/12/04	awi		In useString: changed "SCREEN" to "Screen", and moved commas to inside [].
 		1/15/05		awi		Removed GL_BLEND setting a MK's suggestion.  
 		2/25/05		awi		Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
+		10/17/26	mk		Draw all ovals with one call to the PsychDrawOvals() batch renderer.
 		
 
 	TO DO:
@@ -30,7 +31,7 @@
 #include "Screen.h"
 
 // If you change useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] = "Screen('FillOval', windowPtr [,color] [,rect] [,perfectUpToMaxDiameter]);";
+static char useString[] = "Screen('FillOval', windowPtr [,color] [,rect] [,perfectUpToMaxDiameter] [,smooth]);";
 static char synopsisString[] = 
         "Fills an ellipse with the given color, inscribed within \"rect\".\"color\" is the "
         "clut index (scalar or [r g b] triplet) that you want to poke into each pixel; "
@@ -48,33 +49,32 @@ static char synopsisString[] =
 		"is chosen to be the full display size, so all ovals will look perfect, at a possible "
 		"speed penalty. If you know your ovals will never be bigger than a certain diameter, "
 		"you can provide that diameter as a hint via 'perfectUpToMaxDiameter' to allow for "
-		"some potential speedup when drawing filled ovals. ";
+		"some potential speedup when drawing filled ovals. On graphics hardware with GLSL shader "
+		"support, ovals are computed per pixel and always look perfect.\n"
+		"\"smooth\" is a flag that determines whether the edges of ovals should be anti-aliased: "
+		"0 (default) no smoothing, 1 smoothing. Smoothing needs graphics hardware with GLSL shader "
+		"support and alpha blending enabled via Screen('BlendFunction'), otherwise it is ignored.";
 
 static char seeAlsoString[] = "FrameOval";	
 
 PsychError SCREENFillOval(void)  
 {
 	
-	PsychColorType			color;
 	PsychRectType			rect;
-	double					numSlices, radius, xScale, yScale, xTranslate, yTranslate, rectY, rectX;
 	PsychWindowRecordType	*windowRecord;
-	int						whiteValue;
-	psych_bool					isArgThere;
-	GLdouble				dVals[4]; 
-    double					*xy, *colors;
+	psych_bool				isArgThere;
+	double					*xy, *colors;
 	unsigned char			*bytecolors;
-	int						numRects, i, nc, mc, nrsize;
-	GLUquadricObj			*diskQuadric;
+	int						numRects, nc, mc, nrsize;
 	double					perfectUpToMaxDiameter;
-	static double			perfectUpToMaxDiameterOld = 0;
+	int						smooth;
 
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);}
 	
 	//check for superfluous arguments
-	PsychErrorExit(PsychCapNumInputArgs(4));   //The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(5));   //The maximum number of inputs
 	PsychErrorExit(PsychCapNumOutputArgs(0));  //The maximum number of outputs
 
 	//get the window record from the window record argument and get info from the window record
@@ -83,34 +83,11 @@ PsychError SCREENFillOval(void)
 	perfectUpToMaxDiameter = PsychGetWidthFromRect(windowRecord->clientrect);
 	if (PsychGetHeightFromRect(windowRecord->clientrect) < perfectUpToMaxDiameter) perfectUpToMaxDiameter = PsychGetHeightFromRect(windowRecord->clientrect);
 	PsychCopyInDoubleArg(4, kPsychArgOptional, &perfectUpToMaxDiameter);
-	
-	if ((perfectUpToMaxDiameter != perfectUpToMaxDiameterOld) || (windowRecord->fillOvalDisplayList == 0)) {
-		perfectUpToMaxDiameterOld = perfectUpToMaxDiameter;
-
-		// Compute number of subdivisions (slices) to provide a perfect oval, i.e., one subdivision for each
-		// distance unit on the circumference of the oval.
-		numSlices=3.14159265358979323846 * perfectUpToMaxDiameter;
-
-		// Destroy old display list so it gets rebuilt with the new numSlices setting:
-		if (windowRecord->fillOvalDisplayList != 0) {
-			glDeleteLists(windowRecord->fillOvalDisplayList, 1);
-			windowRecord->fillOvalDisplayList = 0;
-		}
-	}
-
-	// Already cached display list for filled ovals for this windowRecord available?
-	if (windowRecord->fillOvalDisplayList == 0) {
-		// Nope. Create our prototypical filled oval:
-		// Generate a filled disk of that radius and subdivision and store it in a display list:
-		diskQuadric=gluNewQuadric();
-		windowRecord->fillOvalDisplayList = glGenLists(1);
-		glNewList(windowRecord->fillOvalDisplayList, GL_COMPILE);
-		gluDisk(diskQuadric, 0, 1, numSlices, 1);
-		glEndList();	
-		gluDeleteQuadric(diskQuadric);
-		// Display list ready for use in this and all future drawing calls for this windowRecord.
-	}
 
+	smooth = 0;
+	PsychCopyInIntegerArg(5, kPsychArgOptional, &smooth);
+	if (smooth < 0 || smooth > 1) PsychErrorExitMsg(PsychError_user, "smooth must be 0 or 1");
+	
 	// Query, allocate and copy in all vectors...
 	numRects = 4;
 	nrsize = 0;
@@ -129,59 +106,11 @@ PsychError SCREENFillOval(void)
 		isArgThere=PsychCopyInRectArg(kPsychUseDefaultArgPosition, FALSE, rect);	
 		if (isArgThere && IsPsychRectEmpty(rect)) return(PsychError_none);
 		numRects = 1;
+		xy = rect;
 	}
-	else {
-		// Multiple ovals provided. Set up the first one:
-		PsychCopyRect(rect, &xy[0]);
-	}
-
-	// Draw all ovals (one or multiple):
-	for (i=0; i<numRects;) {
-		// Per oval color provided? If so then set it up. If only one common color
-		// was provided then PsychPrepareRenderBatch() has already set it up.
-		if (nc>1) {
-			// Yes. Set color for this specific item:
-			PsychSetArrayColor(windowRecord, i, mc, colors, bytecolors);
-		}
-
-		// Compute drawing parameters for ellipse:
-		if (!IsPsychRectEmpty(rect)) {
-			//The glu disk object location and size with a  center point and a radius,   
-			//whereas FillOval accepts a bounding rect.   Converting from one set of parameters
-			//to the other we should careful what we do for rects size of even number of pixels in length.
-			PsychGetCenterFromRectAbsolute(rect, &xTranslate, &yTranslate);
-			rectY=PsychGetHeightFromRect(rect);
-			rectX=PsychGetWidthFromRect(rect);
-			if(rectX == rectY){
-				xScale=1; 
-				yScale=1;
-				radius=rectX/2;
-			}else if(rectX > rectY){ 
-				xScale=1;
-				yScale=rectY/rectX;
-				radius=rectX/2;
-			}else if(rectY > rectX){
-				yScale=1;
-				xScale=rectX/rectY;
-				radius=rectY/2;
-			}
-						
-			// Draw: Set up position, scale and size via matrix transform:
-			glPushMatrix();
-			glTranslated(xTranslate,yTranslate,0);
-			glScaled(xScale * radius, yScale * radius, 1);
-			// Draw cached disk object (stored in display list):
-			glCallList(windowRecord->fillOvalDisplayList);
-			// Done.
-			glPopMatrix();
-		}
-		
-		// Done with this one. Set up the next one, if any...
-		i++;
-		if (i < numRects) PsychCopyRect(rect, &xy[i*4]);
 
-		// Next oval.
-	}
+	// Draw all ovals (one or multiple) in one batch:
+	PsychDrawOvals(windowRecord, numRects, xy, 0, NULL, nc, mc, colors, bytecolors, perfectUpToMaxDiameter, (smooth) ? TRUE : FALSE);
 	
 	// Mark end of drawing op. This is needed for single buffered drawing:
 	PsychFlushGL(windowRecord);
@@ -17,6 +17,8 @@
 	01/12/05     mk     Added a slow-path that draws concave and self-intersecting polygons correctly.
 	02/25/05	awi		Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
 	11/01/08	 mk		Improved speed of slow-path. Still pretty slow -> Most time spent inside gluTesselator(), nothing we could do.
+	10/17/26	 mk		Use vertex arrays on all paths. Cache tesselation results of concave polygons, so repeatedly drawn
+						shapes only get tesselated once.
  
 	TO DO:
  
@@ -41,20 +43,59 @@ static unsigned int			combinerCacheSlot = 0;
 static double*				tempv = NULL;
 static int					tempvsize = 0;
 
+// Output buffer for triangles generated by the tesselator: Pairs of (x,y) vertex positions:
+static double*				tessTriangles = NULL;
+static int					tessTrianglesSize = 0;
+static int					tessTrianglesCount = 0;
+
+// Cache of tesselated polygons: Each entry stores the normalized pointList of a concave polygon
+// and the resulting triangle list. Polygons are normalized to their bounding box, so translated
+// or scaled versions of a cached polygon reuse the same tesselation:
+#define PSYCH_POLYCACHE_SIZE	64
+
+typedef struct PsychPolyCacheEntry {
+	unsigned int	hash;
+	int				npoints;
+	double			*points;
+	double			*triangles;
+	int				ntrivertices;
+	double			lastUse;
+} PsychPolyCacheEntry;
+
+static PsychPolyCacheEntry	polyCache[PSYCH_POLYCACHE_SIZE];
+static int					polyCacheCount = 0;
+static double				polyCacheTick = 0;
+
 // Callback-Routines for the GLU-Tesselator functions used on the FillPoly - Slow - path:
+// As we register an edge flag callback, the tesselator only outputs independent triangles,
+// which we collect in tessTriangles for drawing with a single glDrawArrays() call:
 void APIENTRY PsychtcbBegin(GLenum prim)
 {
-    glBegin(prim);
+	return;
+}
+
+void APIENTRY PsychtcbEdgeFlag(GLboolean flag)
+{
+	return;
 }
 
 void APIENTRY PsychtcbVertex(void *data)
 {
-    glVertex3dv((GLdouble *)data);
+	// Need to grow output buffer?
+	if (tessTrianglesCount >= tessTrianglesSize) {
+		tessTrianglesSize = ((tessTrianglesCount / 1000) + 1) * 1000;
+		tessTriangles = (double*) realloc((void*) tessTriangles, sizeof(double) * 2 * tessTrianglesSize);
+		if (NULL == tessTriangles) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory condition in Screen('FillPoly')! Not enough space.");
+	}
+
+	tessTriangles[tessTrianglesCount * 2]     = ((GLdouble *) data)[0];
+	tessTriangles[tessTrianglesCount * 2 + 1] = ((GLdouble *) data)[1];
+	tessTrianglesCount++;
 }
 
 void APIENTRY PsychtcbEnd(void)
 {
-    glEnd();
+	return;
 }
 
 void APIENTRY PsychtcbCombine(GLdouble c[3], void *d[4], GLfloat w[4], void **out)
@@ -79,11 +120,88 @@ void APIENTRY PsychtcbCombine(GLdouble c[3], void *d[4], GLfloat w[4], void **ou
 	combinerCacheSlot++;
 }
 
+// Compute hash for the normalized point list 'npoints' of length 'mSize' vertices.
+// Coordinates are quantized before hashing, so tiny rounding differences from the
+// normalization don't matter in most cases. Returns the hash value:
+static unsigned int PsychHashPolygon(double *npoints, int mSize)
+{
+	unsigned int hash = 2166136261U;
+	int i;
+	long q;
+	
+	for (i = 0; i < 2 * mSize; i++) {
+		q = (long) floor(npoints[i] * 1048576.0 + 0.5);
+		hash = (hash ^ (unsigned int) (q & 0xffffffff)) * 16777619U;
+	}
+	
+	hash = (hash ^ (unsigned int) mSize) * 16777619U;
+	return(hash);
+}
+
+// Lookup the tesselation of the normalized polygon 'npoints' in the cache. Returns
+// the cache entry on hit, NULL on miss:
+static PsychPolyCacheEntry* PsychLookupPolyCache(double *npoints, int mSize, unsigned int hash)
+{
+	int i, j;
+	
+	for (i = 0; i < polyCacheCount; i++) {
+		if ((polyCache[i].hash != hash) || (polyCache[i].npoints != mSize)) continue;
+		
+		// Hash matches: Compare point lists within a tolerance far below a pixel:
+		for (j = 0; j < 2 * mSize; j++) if (fabs(polyCache[i].points[j] - npoints[j]) > 1e-9) break;
+		if (j == 2 * mSize) {
+			polyCache[i].lastUse = ++polyCacheTick;
+			return(&polyCache[i]);
+		}
+	}
+	
+	return(NULL);
+}
+
+// Store the triangles in tessTriangles as tesselation for the normalized polygon 'npoints'
+// in the cache, replacing the least recently used entry if the cache is full:
+static void PsychStorePolyCache(double *npoints, int mSize, unsigned int hash)
+{
+	PsychPolyCacheEntry *entry;
+	int i;
+	
+	if (polyCacheCount < PSYCH_POLYCACHE_SIZE) {
+		entry = &polyCache[polyCacheCount++];
+	}
+	else {
+		entry = &polyCache[0];
+		for (i = 1; i < polyCacheCount; i++) if (polyCache[i].lastUse < entry->lastUse) entry = &polyCache[i];
+		free(entry->points);
+		free(entry->triangles);
+	}
+	
+	entry->points = (double*) malloc(sizeof(double) * 2 * mSize);
+	entry->triangles = (double*) malloc(sizeof(double) * 2 * ((tessTrianglesCount > 0) ? tessTrianglesCount : 1));
+	if (NULL == entry->points || NULL == entry->triangles) {
+		// Drop entry on out of memory. Not fatal, we just don't cache:
+		free(entry->points);
+		free(entry->triangles);
+		*entry = polyCache[--polyCacheCount];
+		return;
+	}
+
+	memcpy(entry->points, npoints, sizeof(double) * 2 * mSize);
+	memcpy(entry->triangles, tessTriangles, sizeof(double) * 2 * tessTrianglesCount);
+	entry->ntrivertices = tessTrianglesCount;
+	entry->npoints = mSize;
+	entry->hash = hash;
+	entry->lastUse = ++polyCacheTick;
+	
+	return;
+}
+
 // Cleanup routine for our tesselators and other data structures. Called from
 // ScreenExit.c at Screen shutdown. May be called without OpenGL active! Don't
 // use any GL calls here, just plain C-level operations!!
 void PsychCleanupSCREENFillPoly(void)
 {
+	int i;
+
 	// Release tesselator object and associated data structures, if any:
 	if (tess) {
 		gluDeleteTess(tess);
@@ -95,7 +213,20 @@ void PsychCleanupSCREENFillPoly(void)
 		tempv = NULL;
 		tempvsize = 0;
 	}
-	
+
+	if (tessTriangles) {
+		free(tessTriangles);
+		tessTriangles = NULL;
+		tessTrianglesSize = 0;
+	}
+
+	// Release all cached tesselations:
+	for (i = 0; i < polyCacheCount; i++) {
+		free(polyCache[i].points);
+		free(polyCache[i].triangles);
+	}
+	polyCacheCount = 0;
+
 	return;
 }
 
@@ -116,7 +247,10 @@ static char synopsisString[] =
 "it might be a good idea to preprocess them in some way and maybe break them up into "
 "a sequence of more convex/regular polygons before submitting them to 'FillPoly'. Or "
 "you may want to use some custom written drawing function for your purpose which is "
-"optimized for drawing your type of polygons. ";
+"optimized for drawing your type of polygons.\n"
+"The results of breaking up concave polygons are cached for the most recently drawn "
+"shapes, so redrawing the same concave polygon, or a shifted or scaled version of it, "
+"in following frames is almost as fast as drawing a convex polygon. ";
 
 static char seeAlsoString[] = "FramePoly";	
 
@@ -131,8 +265,10 @@ PsychError SCREENFillPoly(void)
 	double						isConvex;
 	int							j,k;
 	int							flag;
-	double						z;
-	GLuint						tessglList;
+	double						z, minx, miny, maxx, maxy, sx, sy;
+	double						*vertices, *npoints;
+	unsigned int				hash;
+	PsychPolyCacheEntry			*entry;
 	
 	combinerCacheSlot = 0;
 	combinerCacheSize = 0;
@@ -220,54 +356,114 @@ PsychError SCREENFillPoly(void)
 	////// Switch between fast path and slow path, depending on convexity of polygon:
 	if (isConvex > 0) {
 		// Convex, non-self-intersecting polygon - Take the fast-path:
-		//draw the rect
-		glBegin(GL_POLYGON);
-		for(i=0;i<mSize;i++) glVertex2d((GLdouble)pointList[i], (GLdouble)pointList[i+mSize]);
-		glEnd();
+		// Reshape the pointList from column-major (all x, then all y) into (x,y) vertex pairs
+		// and draw it from a vertex array:
+		vertices = (double*) PsychMallocTemp(sizeof(double) * 2 * mSize);
+		for(i=0;i<mSize;i++) {
+			vertices[i*2]   = pointList[i];
+			vertices[i*2+1] = pointList[i+mSize];
+		}
+
+		glVertexPointer(2, GL_DOUBLE, 0, vertices);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glDrawArrays(GL_POLYGON, 0, mSize);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glVertexPointer(2, GL_DOUBLE, 0, NULL);
 	}
 	else {
 		// Possibly concave and/or self-intersecting polygon - At least we couldn't prove it is convex.
 		// Take the slow, but safe, path using GLU-Tesselators to break it up into a couple of convex, simple
 		// polygons:
+
+		// Normalize the polygon to its bounding box, so the tesselation of translated and scaled versions
+		// of the same shape can be shared via our cache. Tesselation is invariant under such transforms:
+		minx = maxx = pointList[0];
+		miny = maxy = pointList[mSize];
+		for(i=1; i < mSize; i++) {
+			if (pointList[i] < minx) minx = pointList[i];
+			if (pointList[i] > maxx) maxx = pointList[i];
+			if (pointList[i+mSize] < miny) miny = pointList[i+mSize];
+			if (pointList[i+mSize] > maxy) maxy = pointList[i+mSize];
+		}
+		sx = (maxx > minx) ? (maxx - minx) : 1;
+		sy = (maxy > miny) ? (maxy - miny) : 1;
 		
-		// Create and initialize a new GLU-Tesselator object, if needed:
-		if (NULL == tess) {
-			// Create tesselator:
-			tess = gluNewTess();
-			if (NULL == tess) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory condition in Screen('FillPoly')! Not enough space.");
-
-			// Assign our callback-functions:
-			gluTessCallback(tess, GLU_TESS_BEGIN, PsychtcbBegin);
-			gluTessCallback(tess, GLU_TESS_VERTEX, PsychtcbVertex);
-			gluTessCallback(tess, GLU_TESS_END, PsychtcbEnd);
-			gluTessCallback(tess, GLU_TESS_COMBINE, PsychtcbCombine);
-
-			// Define all to be tesselated polygons to lie in the x-y plane:
-			gluTessNormal(tess, 0, 0, 1);
-		}	  
-
-		// We need to hold the values in a temporary array:
-		if (tempvsize < mSize) {
-			tempvsize = ((mSize / 1000) + 1) * 1000;
-			tempv = (double*) realloc((void*) tempv, sizeof(double) * 3 * tempvsize);
-			if (NULL == tempv) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory condition in Screen('FillPoly')! Not enough space.");
+		npoints = (double*) PsychMallocTemp(sizeof(double) * 2 * mSize);
+		for(i=0; i < mSize; i++) {
+			npoints[i*2]   = (pointList[i] - minx) / sx;
+			npoints[i*2+1] = (pointList[i+mSize] - miny) / sy;
 		}
+		
+		// Already tesselated this shape recently?
+		hash = PsychHashPolygon(npoints, mSize);
+		entry = PsychLookupPolyCache(npoints, mSize, hash);
+		if (NULL == entry) {
+			// Nope. Tesselate it now:
 
-		// Now submit our Polygon for tesselation:
-		gluTessBeginPolygon(tess, NULL);
-		gluTessBeginContour(tess);
+			// Create and initialize a new GLU-Tesselator object, if needed:
+			if (NULL == tess) {
+				// Create tesselator:
+				tess = gluNewTess();
+				if (NULL == tess) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory condition in Screen('FillPoly')! Not enough space.");
 
-		for(i=0; i < mSize; i++) {
-			tempv[i*3]=(GLdouble) pointList[i];
-			tempv[i*3+1]=(GLdouble) pointList[i+mSize];
-			tempv[i*3+2]=0;
-			gluTessVertex(tess, (GLdouble*) &(tempv[i*3]), (void*) &(tempv[i*3]));
+				// Assign our callback-functions:
+				gluTessCallback(tess, GLU_TESS_BEGIN, PsychtcbBegin);
+				gluTessCallback(tess, GLU_TESS_EDGE_FLAG, PsychtcbEdgeFlag);
+				gluTessCallback(tess, GLU_TESS_VERTEX, PsychtcbVertex);
+				gluTessCallback(tess, GLU_TESS_END, PsychtcbEnd);
+				gluTessCallback(tess, GLU_TESS_COMBINE, PsychtcbCombine);
+
+				// Define all to be tesselated polygons to lie in the x-y plane:
+				gluTessNormal(tess, 0, 0, 1);
+			}	  
+
+			// We need to hold the values in a temporary array:
+			if (tempvsize < mSize) {
+				tempvsize = ((mSize / 1000) + 1) * 1000;
+				tempv = (double*) realloc((void*) tempv, sizeof(double) * 3 * tempvsize);
+				if (NULL == tempv) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory condition in Screen('FillPoly')! Not enough space.");
+			}
+
+			// Now submit our normalized Polygon for tesselation:
+			tessTrianglesCount = 0;
+			gluTessBeginPolygon(tess, NULL);
+			gluTessBeginContour(tess);
+
+			for(i=0; i < mSize; i++) {
+				tempv[i*3]=(GLdouble) npoints[i*2];
+				tempv[i*3+1]=(GLdouble) npoints[i*2+1];
+				tempv[i*3+2]=0;
+				gluTessVertex(tess, (GLdouble*) &(tempv[i*3]), (void*) &(tempv[i*3]));
+			}
+			
+			// Process and finalize it by calling our callback-functions, which collect the triangles:
+			gluTessEndContour(tess);
+			gluTessEndPolygon (tess);
+			
+			// Cache the result for reuse in future calls:
+			PsychStorePolyCache(npoints, mSize, hash);
+			vertices = tessTriangles;
+			j = tessTrianglesCount;
+		}
+		else {
+			// Yes. Reuse cached triangles:
+			vertices = entry->triangles;
+			j = entry->ntrivertices;
 		}
 		
-		// Process, finalize and render it by calling our callback-functions:
-		gluTessEndContour(tess);
-		gluTessEndPolygon (tess);
-		
+		// Draw all triangles with one call, mapped back from the normalized bounding box:
+		if (j > 0) {
+			glPushMatrix();
+			glTranslated(minx, miny, 0);
+			glScaled(sx, sy, 1);
+			glVertexPointer(2, GL_DOUBLE, 0, vertices);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glDrawArrays(GL_TRIANGLES, 0, j);
+			glDisableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(2, GL_DOUBLE, 0, NULL);
+			glPopMatrix();
+		}
+
 		// Done with drawing the filled polygon. (Slow-Path)
 	}
 	
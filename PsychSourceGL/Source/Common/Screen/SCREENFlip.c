@@ -64,7 +64,7 @@ PsychError SCREENFlip(void)
 	"- it can report false positives and also false negatives, although it should work fairly well with most experimental setups. "
 	"If you are picky about timing, please use the provided timestamps or additional methods to exercise your own tests. ";
 
-	static char useString1[] = "[VBLTimestamp StimulusOnsetTime FlipTimestamp Missed Beampos] = Screen('AsyncFlipBegin', windowPtr [, when] [, dontclear] [, dontsync] [, multiflip]);";
+	static char useString1[] = "[VBLTimestamp StimulusOnsetTime FlipTimestamp Missed Beampos] = Screen('AsyncFlipBegin', windowPtr [, when] [, dontclear] [, dontsync] [, multiflip] [, queueDepth]);";
 	static char synopsisString1[] = 
 	"Schedule an asynchronous flip of front and back display surfaces for given onscreen window. "
 	"\"windowPtr\" is the id of the onscreen window whose content should be shown at flip time. "
@@ -79,6 +79,17 @@ PsychError SCREENFlip(void)
     "the execution of your script and your flip timing, you will rather want to use one of the finalizer "
 	"commands Screen('AsyncFlipCheckEnd') or Screen('AsyncFlipEnd') mentioned below "
 	"to collect information about the final result and timing of the asynchronous flip operation.\n\n"
+	"\"queueDepth\" allows to queue multiple async flips if set to a value greater than 1 (default 1), "
+	"up to a maximum of 8: As long as less than \"queueDepth\" async flips are pending, the new flip is "
+	"appended to the queue of pending flips without waiting, so your script can run multiple frames ahead and "
+	"schedule each frame for its own presentation deadline 'when'. Only if the queue is full, the command waits "
+	"for the oldest pending flip to finish and returns its results. Each call to Screen('AsyncFlipEnd') or "
+	"Screen('AsyncFlipCheckEnd') finalizes and returns the results of the oldest pending flip, so call them once "
+	"for each queued flip. A synchronous Screen('Flip') waits for all queued flips to finish. Queueing requires "
+	"the imaging pipeline to be enabled (see 'help PsychImaging') and is not supported for quad-buffered, "
+	"frame-sequential or dual-window stereo, or dual-window output. Each queue slot needs additional video "
+	"memory for one full window sized image. If queueing is unsupported, \"queueDepth\" is ignored. "
+	"'WaitUntilAsyncFlipCertain' can't be used with queued flips.\n\n"
 	"The difference between Screen('AsyncFlipBegin',...); and the more commonly used Screen('Flip', ...); "
 	"is that Screen('Flip') operates synchronously: Execution of your code is paused until the flip operation "
 	"has finished, ie. at least until the requested onset deadline 'when' has passed.\n\n"
@@ -167,6 +178,7 @@ PsychError SCREENFlip(void)
 	double time_at_onset;
 	unsigned int opmode;
 	psych_bool flipstate;
+	int queueDepth;
 
 	// Change our "personality" depending on the name with which we were called:
 	if (PsychMatch(PsychGetFunctionName(), "AsyncFlipBegin")) {
@@ -201,7 +213,7 @@ PsychError SCREENFlip(void)
 	// Give online help, if requested:
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
 
-	PsychErrorExit(PsychCapNumInputArgs((opmode < 2)  ? 5 : 1));		// The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs((opmode < 2)  ? ((opmode == 1) ? 6 : 5) : 1));		// The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1));						// The required number of inputs
 	PsychErrorExit(PsychCapNumOutputArgs(5));							// The maximum number of outputs
 	
@@ -265,29 +277,47 @@ PsychError SCREENFlip(void)
 			PsychErrorExitMsg(PsychError_user, "\nYou specified a 'when' value to Flip that's over 1000 seconds in the future?!? Aborting, assuming that's an error.\n\n");
 		}
 
+		// Query optional queueDepth argument of async flips: 1 (default) No queueing, k > 1 = Allow up to k pending async flips:
+		queueDepth = 1;
+		if (opmode == 1) PsychCopyInIntegerArg(6, FALSE, &queueDepth);
+		if (queueDepth < 1 || queueDepth > kPsychMaxQueuedFlips) {
+			PsychErrorExitMsg(PsychError_user, "Only 'queueDepth' values 1 (== no queueing) to 8 are supported");
+		}
+
 		// Pack all parameters of the fliprequest into the flipinfo struct:
 		// At least our part of the struct. Initial setup of threds and locks etc. is done by the actual
 		// PsychFlipWindowBuffersIndirect() routine:
 		flipRequest = windowRecord->flipInfo;
 
-		if (flipRequest->asyncstate != 0) {
-			// Started, executing or finalized async flip in progress. We can't trigger a new flip request
-			// before the current one has finished. Perform a blocking wait for flip completion, basically
-			// a Screen('AsyncFlipEnd') op, collect its results for return to usercode, then continue with
-			// scheduling the new flip request:
+		if ((queueDepth > 1) && !PsychCanQueueAsyncFlips(windowRecord)) {
+			if (!flipRequest->queueWarningDone && (PsychPrefStateGet_Verbosity() > 1)) {
+				printf("PTB-WARNING: Screen('AsyncFlipBegin'): Queueing of async flips via 'queueDepth' > 1 is not supported for this window.\n");
+				printf("PTB-WARNING: It needs the imaging pipeline and can't be used with quad-buffered, frame-sequential or dual-window\n");
+				printf("PTB-WARNING: stereo, or dual-window output. Ignoring 'queueDepth' and using a single async flip instead.\n");
+			}
+			flipRequest->queueWarningDone = TRUE;
+			queueDepth = 1;
+		}
+
+		// No async flip -- Fake a "success", so cached results from
+		// previous flips can be returned:
+		flipstate = TRUE;
+
+		// Started, executing or finalized async flip in progress? We can't trigger a new flip request
+		// before the current one has finished, unless we queue it and the queue of pending flips has
+		// room for it. Otherwise perform a blocking wait for flip completion, basically a Screen('AsyncFlipEnd')
+		// op, collect its results for return to usercode, then continue with scheduling the new flip request.
+		// A non-queued flip waits for all pending queued flips:
+		while ((flipRequest->asyncstate != 0) &&
+		       !((queueDepth > 1) && (flipRequest->queueCount > 0) && (flipRequest->queueCount < queueDepth))) {
 			flipRequest->opmode = 2;
 			flipstate = PsychFlipWindowBuffersIndirect(windowRecord);
 
-			// Reset state to zero, ie. ready for new adventures ;-)
-			if (flipstate) flipRequest->asyncstate = 0;
+			// Reset state to zero, ie. ready for new adventures ;-) if this was the last pending flip:
+			if (flipstate && (flipRequest->asyncstate == 2)) flipRequest->asyncstate = 0;
 
 			// Ok, async flip completed. Its completion data is stored in flipRequest.
 		}
-		else {
-			// No async flip -- Fake a "success", so cached results from
-			// previous flips can be returned:
-			flipstate = TRUE;
-		}
 
 		// If this is a Screen('AsyncFlipBegin') aka opmode 1, we can return the
 		// completion data of previous async flips to usercode.
@@ -314,6 +344,7 @@ PsychError SCREENFlip(void)
 		}
 
 		// This info needs to be provided for flip mechanism:
+		flipRequest->queueDepth		= queueDepth;
 		flipRequest->opmode		= opmode;
 		flipRequest->dont_clear		= dont_clear;
 		flipRequest->flipwhen		= flipwhen;
@@ -326,8 +357,9 @@ PsychError SCREENFlip(void)
 		// not -1, then the routine can simply skip its wait op and take values from
 		// the initialized timestamps of the flipperThread, as we know that that
 		// thread already has detected swap-completion and done all the timestamping
-		// work:
-		flipRequest->vbl_timestamp = -1;
+		// work. Queued flips keep their timestamps in their queue slot, so we keep
+		// the cached results of the last finalized flip:
+		if (queueDepth <= 1) flipRequest->vbl_timestamp = -1;
 		
 		// Ok, the struct is filled with spec for a synchronous or asynchronous flip...
 		
@@ -376,14 +408,14 @@ PsychError SCREENFlip(void)
 	// Only have return args in synchronous mode or in return path from end/successfull poll of async flip:
 	if (opmode != 1) {
 		// Async flip is either zero in synchronous mode, or it's 2 if an async flip
-		// successfully finished:
-		if ((flipRequest->asyncstate!=0) && (flipRequest->asyncstate!=2) && (flipstate)) {
+		// successfully finished, or 1 if a queued flip finished and more are pending:
+		if ((flipRequest->asyncstate!=0) && (flipRequest->asyncstate!=2) && (flipstate) && (flipRequest->queueCount == 0)) {
 			printf("PTB-ERROR: flipRequest->asyncState has impossible value %i at end of flipop! This is a PTB DESIGN BUG!", flipRequest->asyncstate);
 			PsychErrorExitMsg(PsychError_internal, "flipRequest->asyncState has impossible value at end of flipop! This is a PTB DESIGN BUG!");
 		}
 		
 		// Reset it to zero, ie. ready for new adventures ;-)
-		if (flipstate) flipRequest->asyncstate=0;
+		if (flipstate && (flipRequest->asyncstate == 2)) flipRequest->asyncstate=0;
 		
 		// Return return arguments from flip: We return a zero vbl_timestamp in case a poll for flip completion failed.
 		// That indicates that flip not yet finished and all other return values are invalid:
@@ -466,6 +498,10 @@ PsychError SCREENWaitUntilAsyncFlipCertain(void)
 	
 	// Just if we are called on a window for which an async flip operation is active.
 	// The routine can only be used for active async flips, so bail out on anything else.
+	if ((windowRecord->flipInfo != NULL) && (windowRecord->flipInfo->queueCount > 0)) {
+		PsychErrorExitMsg(PsychError_user, "WaitUntilAsyncFlipCertain can't be used with queued async flips, ie., a 'queueDepth' greater than 1 in Screen('AsyncFlipBegin')!");
+	}
+
 	if ((windowRecord->flipInfo == NULL) || (windowRecord->flipInfo->asyncstate == 0)) {
 		// No async flip operation active: Either no flip triggered at all, or at least not an async one:
 		PsychErrorExitMsg(PsychError_user, "WaitUntilAsyncFlipCertain only works for async flips: May only be called between Screen('AsyncFlipBegin') and Screen('AsyncFlipEnd') or Screen('AsyncFlipCheckEnd')!");		
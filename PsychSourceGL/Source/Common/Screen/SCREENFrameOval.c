@@ -20,6 +20,7 @@
 		1/25/05		awi		Really removed GL_BLEND.  Correction provide by mk.
 		2/25/05		awi		Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
 		6/14/09      mk		Add batch-drawing support, just as with FillOval et al.
+		10/17/26	mk		Draw all ovals with one call to the PsychDrawOvals() batch renderer.
 
     TO DO:
     
@@ -42,15 +43,16 @@
 		MK: All these proposals are not workable solutions, because they would either be awfully slow,
 			or have significant side-effects on things like HDR drawing or alpha blending.
 			
-			On modern GPU's a shader based solution would be perfect and fast.
+			On modern GPU's a shader based solution would be perfect and fast. PsychDrawOvals() now
+			uses one, but keeps the scaled pen width for backwards compatibility.
 
 */
 
 #include "Screen.h"
 
 // If you change useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] = "Screen('FrameOval', windowPtr [,color] [,rect] [,penWidth] [,penHeight] [,penMode]);";
-//                                             1           2        3      4            5            6
+static char useString[] = "Screen('FrameOval', windowPtr [,color] [,rect] [,penWidth] [,penHeight] [,penMode] [,smooth]);";
+//                                             1           2        3      4            5            6          7
 static char synopsisString[] = 
             "Draw the outline of an oval inscribed in \"rect\". \"color\" is the clut index (scalar or [r g b] "
             "triplet) that you want to poke into each pixel; default produces white with the "
@@ -59,6 +61,9 @@ static char synopsisString[] =
             "equal the penHeight.  If non-equal arguments are given, FrameOval will choose the maximum "
             "value of both. The pen width will be non-uniform for non-circular ovals, this is a known "
 			"limitation.\n"
+			"\"smooth\" is a flag that determines whether the edges of ovals should be anti-aliased: "
+			"0 (default) no smoothing, 1 smoothing. Smoothing needs graphics hardware with GLSL shader "
+			"support and alpha blending enabled via Screen('BlendFunction'), otherwise it is ignored.\n"
 			"Instead of drawing one oval, you can also specify a list of multiple ovals to be "
 			"drawn - this is faster when you need to draw many ovals per frame. To draw n "
 			"ovals, provide \"rect\" as a 4 rows by n columns matrix, each column specifying one "
@@ -74,30 +79,30 @@ static char seeAlsoString[] = "FillOval";
             
 PsychError SCREENFrameOval(void)  
 {
-	PsychColorType			color;
 	PsychRectType			rect;
-	double					numSlices, outerRadius, xScale, yScale, xTranslate, yTranslate, rectY, rectX, penWidth, penHeight, penSize, innerRadius;
+	double					penWidth, penHeight, penSize;
 	PsychWindowRecordType	*windowRecord;
-	int						whiteValue;
-	psych_bool					isArgThere;
-	GLdouble				dVals[4]; 
-    double					*xy, *colors;
+	psych_bool				isArgThere;
+	double					*xy, *colors;
 	unsigned char			*bytecolors;
 	double*					penSizes;
-	int						numRects, i, nc, mc, nrsize;
-	GLUquadricObj			*diskQuadric;
+	int						numRects, nc, mc, nrsize, smooth;
 
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);}
 	
 	//check for superfluous arguments
-	PsychErrorExit(PsychCapNumInputArgs(6));   //The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(7));   //The maximum number of inputs
 	PsychErrorExit(PsychCapNumOutputArgs(0));  //The maximum number of outputs
 
 	//get the window record from the window record argument and get info from the window record
 	PsychAllocInWindowRecordArg(kPsychUseDefaultArgPosition, TRUE, &windowRecord);
 
+	smooth = 0;
+	PsychCopyInIntegerArg(7, kPsychArgOptional, &smooth);
+	if (smooth < 0 || smooth > 1) PsychErrorExitMsg(PsychError_user, "smooth must be 0 or 1");
+
 	// Query, allocate and copy in all vectors...
 	numRects = 4;
 	nrsize = 0;
@@ -116,6 +121,7 @@ PsychError SCREENFrameOval(void)
 		isArgThere=PsychCopyInRectArg(kPsychUseDefaultArgPosition, FALSE, rect);	
 		if (isArgThere && IsPsychRectEmpty(rect)) return(PsychError_none);
 		numRects = 1;
+		xy = rect;
 
 		// Get the pen width and height arguments
 		penWidth=1;
@@ -123,77 +129,12 @@ PsychError SCREENFrameOval(void)
 		PsychCopyInDoubleArg(4, FALSE, &penWidth);
 		PsychCopyInDoubleArg(5, FALSE, &penHeight);
 		penSize = (penWidth > penHeight) ? penWidth : penHeight;
-	}
-	else {
-		// Multiple ovals provided. Set up the first one:
-		PsychCopyRect(rect, &xy[0]);
-		penSize = penSizes[0];
-	}
-
-	// Create quadric object:
-	diskQuadric=gluNewQuadric();
-
-	// Draw all ovals (one or multiple):
-	for (i=0; i < numRects;) {
-		// Per oval color provided? If so then set it up. If only one common color
-		// was provided then PsychPrepareRenderBatch() has already set it up.
-		if (nc>1) {
-			// Yes. Set color for this specific item:
-			PsychSetArrayColor(windowRecord, i, mc, colors, bytecolors);
-		}
-
-		// Per oval penSize provided? If so, set it up. Otherwise keep at default size
-		// common for all ovals, set by code outside loop:
-		if (nrsize > 1) penSize = penSizes[i];
-
-		// Compute drawing parameters for ellipse:
-		if (!IsPsychRectEmpty(rect)) {
-			//The glu disk object location and size with a  center point and a radius,   
-			//whereas FrameOval accepts a bounding rect. Converting from one set of parameters
-			//to the other we should careful what we do for rects size of even number of pixels in length.
-			PsychGetCenterFromRectAbsolute(rect, &xTranslate, &yTranslate);
-			rectY=PsychGetHeightFromRect(rect);
-			rectX=PsychGetWidthFromRect(rect);
-			if(rectX == rectY){
-				xScale=1; 
-				yScale=1;
-				outerRadius=rectX/2;
-			}else if(rectX > rectY){ 
-				xScale=1;
-				yScale=rectY/rectX;
-				outerRadius=rectX/2;
-			}else if(rectY > rectX){
-				yScale=1;
-				xScale=rectX/rectY;
-				outerRadius=rectY/2;
-			}
-			
-			numSlices   =   3.14159265358979323846  * 2 * outerRadius;
-			innerRadius = outerRadius - penSize;
-			innerRadius = (innerRadius < 0) ? 0 : innerRadius;         
-			
-			// Draw: Set up position, scale and size via matrix transform:
-			glPushMatrix();
-			glTranslated(xTranslate, yTranslate, 0);
-			glScaled(xScale, yScale, 1);
-
-			// Compute disk quadric for given params: This is awfully slow and would
-			// benefit a lot from shader magic on modern GPUs:
-			gluDisk(diskQuadric, innerRadius, outerRadius, numSlices, 1);
-
-			// Done.
-			glPopMatrix();
-		}
-		
-		// Done with this one. Set up the next one, if any...
-		i++;
-		if (i < numRects) PsychCopyRect(rect, &xy[i*4]);
-
-		// Next oval.
+		penSizes = &penSize;
+		nrsize = 1;
 	}
 
-	// Release quadric object:
-	gluDeleteQuadric(diskQuadric);
+	// Draw all ovals (one or multiple) in one batch. Ovals look perfect up to the full display size:
+	PsychDrawOvals(windowRecord, numRects, xy, nrsize, penSizes, nc, mc, colors, bytecolors, DBL_MAX, (smooth) ? TRUE : FALSE);
 
 	// Mark end of drawing op. This is needed for single buffered drawing:
 	PsychFlushGL(windowRecord);
@@ -14,6 +14,7 @@
 		07/24/04	awi		Created.
 		10/12/04	awi		In useString: moved commas to inside [].
 		2/25/05		awi		Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
+		10/17/26	mk		Draw from a vertex array instead of immediate mode.
 		
 	TO DO:
 
@@ -47,7 +48,7 @@ PsychError SCREENFramePoly(void)
 	int								whiteValue;
 	int								i, mSize, nSize, pSize;
 	psych_bool							isArgThere;
-	double							penSize, *pointList;
+	double							penSize, *pointList, *vertices;
     
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -92,10 +93,20 @@ PsychError SCREENFramePoly(void)
 
 	PsychUpdateAlphaBlendingFactorLazily(windowRecord);
 	PsychSetGLColor(&color, windowRecord);
-	glBegin(GL_LINE_LOOP);
-		for(i=0;i<mSize;i++)
-			glVertex2d((GLdouble)pointList[i], (GLdouble)pointList[i+mSize]);
-	glEnd();
+
+	// Reshape the pointList from column-major (all x, then all y) into (x,y) vertex pairs
+	// and draw it from a vertex array:
+	vertices = (double*) PsychMallocTemp(sizeof(double) * 2 * mSize);
+	for(i=0;i<mSize;i++) {
+		vertices[i*2]   = pointList[i];
+		vertices[i*2+1] = pointList[i+mSize];
+	}
+
+	glVertexPointer(2, GL_DOUBLE, 0, vertices);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glDrawArrays(GL_LINE_LOOP, 0, mSize);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_DOUBLE, 0, NULL);
 
 	glLineWidth((GLfloat) 1);
 
@@ -14,12 +14,8 @@
 		01/08/03  	awi		Created.
 		10/12/04	awi		In useString: moved commas to inside [].
 		03/20/11	mk		Made 64-bit clean.
-
-	TO DO:
-    
-		We could probably speed this up by using a single call to glReadPixels instead of three.  It doesn't matter what we pack the result into,
-		since we have to iterate over and copy out from the memory which glReadPixels fills so to rearrange correclty into the return matrix. None
-		of the glReadPixels modes will fill the return matrix in the same format that MATLAB wants.  
+		10/17/26	mk		Single glReadPixels call for all channels, tiled SSE2 and multi-threaded conversion into the Matlab
+							image layout. Optional asynchronous readback via a ring of pixel buffer objects.
 */
 
 
@@ -27,8 +23,8 @@
 #include "Screen.h"
 
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] =  "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3])";
-//                                                        1           2       3				4				   5
+static char useString[] =  "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3] [,queueDepth=0])";
+//                                                        1           2       3				4				   5				6
 
 static char synopsisString[] =
 "Slowly copy an image from a window or texture to Matlab/Octave, by default returning a uint8 array.\n\n"
@@ -64,7 +60,14 @@ static char synopsisString[] =
 "is selected (ie. more than 8bpc framebuffer).\n"
 "\"nrchannels\" Number of color channels to return. By default, 3 channels (RGB) are "
 "returned. Specify 1 for Red/Luminance only, 2 for Red+Green or Luminance+Alpha, 3 for "
-"RGB and 4 for RGBA.\n\n";
+"RGB and 4 for RGBA.\n"
+"\"queueDepth\" If you set this optional argument to a value k between 1 and 8, readback is asynchronous "
+"and doesn't stall the graphics pipeline: The image is queued for readback into one of a ring of k OpenGL "
+"pixel buffer objects and the image queued by the call k calls ago is returned instead, i.e., if you call "
+"GetImage after each Screen('Flip'), you get the image of frame N-k in frame N. The first k calls return an "
+"empty matrix. A negative value returns the oldest queued image without queueing a new readback, or an "
+"empty matrix if the queue is empty, so you can collect the last k images at the end of a session. Changing "
+"k discards all queued images. Asynchronous readback is only supported for onscreen windows.\n\n";
 
 static char useString2[] = "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1])";
 //                                                    1           2       3				4			  5
@@ -106,6 +109,272 @@ static char synopsisString2[] =
 "See Screen('CreateMovie?') for help on movie creation.\n";
 
 static char seeAlsoString[] = "PutImage CopyWindow CreateMovie FinalizeMovie";
+
+// Images are read back with a single glReadPixels call into an interleaved buffer, then converted into the planar,
+// column-major and vertically flipped layout of Matlab/Octave matrices. Large images get converted in parallel
+// ranges of pixel columns by PsychRunParallelPixelConversion().
+
+// Use SSE2 vectorized transposition of uint8 images? SSE2 must be enabled at compile time:
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PSYCH_GETIMAGE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Description of one conversion from a readback buffer into a Matlab/Octave image matrix:
+typedef struct PsychImageReadback {
+	psych_bool		floatprecision;	// Float readback into double matrix? Otherwise uint8 into uint8 matrix.
+	int				nrchannels;		// Number of color channels to return, i.e., image planes of output matrix.
+	int				ncomponents;	// Number of color components per pixel in readback buffer.
+	size_t			width, height;	// Size of image in pixels.
+	const void*		src;			// Interleaved readback buffer, bottom row first.
+	void*			dst;			// Planar column-major output matrix, top row first.
+} PsychImageReadback;
+
+// Setup readback description 'rb' for an image of 'width' x 'height' pixels. uint8 images are read as RGBA, except
+// for single channel images, float images with exactly the requested channels:
+static void PsychSetupImageReadback(PsychImageReadback *rb, psych_bool floatprecision, int nrchannels, size_t width, size_t height)
+{
+	rb->floatprecision = floatprecision;
+	rb->nrchannels = nrchannels;
+	rb->ncomponents = (floatprecision || (nrchannels == 1)) ? nrchannels : 4;
+	rb->width = width;
+	rb->height = height;
+	rb->src = NULL;
+	rb->dst = NULL;
+}
+
+// Size of the readback buffer for 'rb' in bytes:
+static size_t PsychGetImageReadbackSize(PsychImageReadback *rb)
+{
+	return(rb->width * rb->height * (size_t) rb->ncomponents * ((rb->floatprecision) ? sizeof(float) : 1));
+}
+
+// Read the image for 'rb' from the current read buffer, with bottom-left corner at (x, y) in OpenGL window coordinates,
+// into 'buffer'. 'buffer' is an offset into the bound pixel pack buffer when reading into a pixel buffer object:
+static void PsychReadImagePixels(PsychImageReadback *rb, int x, int y, void *buffer)
+{
+	static const GLenum floatformats[4] = { GL_RED, GL_LUMINANCE_ALPHA, GL_RGB, GL_RGBA };
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	if (!rb->floatprecision) {
+		glReadPixels(x, y, (int) rb->width, (int) rb->height, (rb->ncomponents == 1) ? GL_RED : GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+	}
+	else {
+		glReadPixels(x, y, (int) rb->width, (int) rb->height, floatformats[rb->nrchannels - 1], GL_FLOAT, buffer);
+	}
+}
+
+// Allocate the returned image matrix for 'rb', or an empty matrix if 'rb' is NULL:
+static void PsychAllocOutReadbackImage(PsychImageReadback *rb)
+{
+	ubyte	*bytes;
+	double	*doubles;
+
+	if (NULL == rb) {
+		PsychAllocOutDoubleMatArg(1, TRUE, 0, 0, 0, &doubles);
+	}
+	else if (!rb->floatprecision) {
+		PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) rb->height, (int) rb->width, (int) rb->nrchannels, &bytes);
+		rb->dst = (void*) bytes;
+	}
+	else {
+		PsychAllocOutDoubleMatArg(1, TRUE, (int) rb->height, (int) rb->width, (int) rb->nrchannels, &doubles);
+		rb->dst = (void*) doubles;
+	}
+}
+
+#ifdef PSYCH_GETIMAGE_USE_SSE2
+// Transpose, flip and deinterleave the uint8 tile of 16 x 16 pixels with top-left corner at column 'tx', row 'ty' of the
+// returned image:
+static void PsychTransposeImageTileSSE2(PsychImageReadback *rb, size_t tx, size_t ty)
+{
+	__m128i					rows[4][16], scratch[16];
+	__m128i					*in, *out, *tmp;
+	__m128i					t0, t1, t2, t3, u0, u1, u2, u3;
+	const unsigned char		*src;
+	unsigned char			*dst;
+	int						k, c, round;
+
+	for (k = 0; k < 16; k++) {
+		// Row k of the tile, with bottom row first in the readback buffer:
+		src = (const unsigned char*) rb->src + (tx + (rb->height - 1 - (ty + (size_t) k)) * rb->width) * (size_t) rb->ncomponents;
+		if (rb->ncomponents == 1) {
+			rows[0][k] = _mm_loadu_si128((const __m128i*) src);
+			continue;
+		}
+
+		// Deinterleave 16 RGBA pixels into one vector of 16 bytes per channel:
+		t0 = _mm_loadu_si128((const __m128i*) src);
+		t1 = _mm_loadu_si128((const __m128i*) (src + 16));
+		t2 = _mm_loadu_si128((const __m128i*) (src + 32));
+		t3 = _mm_loadu_si128((const __m128i*) (src + 48));
+		u0 = _mm_unpacklo_epi8(t0, t1);
+		u1 = _mm_unpackhi_epi8(t0, t1);
+		u2 = _mm_unpacklo_epi8(t2, t3);
+		u3 = _mm_unpackhi_epi8(t2, t3);
+		t0 = _mm_unpacklo_epi8(u0, u1);
+		t1 = _mm_unpackhi_epi8(u0, u1);
+		t2 = _mm_unpacklo_epi8(u2, u3);
+		t3 = _mm_unpackhi_epi8(u2, u3);
+		u0 = _mm_unpacklo_epi8(t0, t1);
+		u1 = _mm_unpackhi_epi8(t0, t1);
+		u2 = _mm_unpacklo_epi8(t2, t3);
+		u3 = _mm_unpackhi_epi8(t2, t3);
+		rows[0][k] = _mm_unpacklo_epi64(u0, u2);
+		rows[1][k] = _mm_unpackhi_epi64(u0, u2);
+		rows[2][k] = _mm_unpacklo_epi64(u1, u3);
+		rows[3][k] = _mm_unpackhi_epi64(u1, u3);
+	}
+
+	for (c = 0; c < rb->nrchannels; c++) {
+		// Interleaving the bytes of rows k and k + 8 rotates the 8 bit row:column index of each byte by one bit,
+		// so four rounds transpose the 16 x 16 bytes:
+		in = rows[c];
+		out = scratch;
+		for (round = 0; round < 4; round++) {
+			for (k = 0; k < 8; k++) {
+				out[2 * k] = _mm_unpacklo_epi8(in[k], in[k + 8]);
+				out[2 * k + 1] = _mm_unpackhi_epi8(in[k], in[k + 8]);
+			}
+			tmp = in; in = out; out = tmp;
+		}
+
+		// Each row is now 16 consecutive pixels of one column of the returned image:
+		dst = (unsigned char*) rb->dst + (size_t) c * rb->width * rb->height + tx * rb->height + ty;
+		for (k = 0; k < 16; k++) _mm_storeu_si128((__m128i*) (dst + (size_t) k * rb->height), in[k]);
+	}
+}
+#endif
+
+// Convert pixel columns 'start' to 'end' - 1 of readback 'rb', in tiles of 16 x 16 pixels for cache efficiency:
+static void PsychConvertImageColumns(PsychImageReadback *rb, size_t start, size_t end)
+{
+	const unsigned char	*bsrc = (const unsigned char*) rb->src;
+	const float			*fsrc = (const float*) rb->src;
+	unsigned char		*bdst = (unsigned char*) rb->dst;
+	double				*ddst = (double*) rb->dst;
+	size_t				planesize = rb->width * rb->height;
+	size_t				nc = (size_t) rb->ncomponents;
+	size_t				tx, ty, ix, iy, xend, yend, si, di;
+	int					c;
+
+	for (tx = start; tx < end; tx += 16) {
+		xend = (tx + 16 < end) ? tx + 16 : end;
+		for (ty = 0; ty < rb->height; ty += 16) {
+			yend = (ty + 16 < rb->height) ? ty + 16 : rb->height;
+
+			#ifdef PSYCH_GETIMAGE_USE_SSE2
+			if (!rb->floatprecision && (xend - tx == 16) && (yend - ty == 16)) {
+				PsychTransposeImageTileSSE2(rb, tx, ty);
+				continue;
+			}
+			#endif
+
+			for (ix = tx; ix < xend; ix++) {
+				for (iy = ty; iy < yend; iy++) {
+					si = (ix + (rb->height - 1 - iy) * rb->width) * nc;
+					di = ix * rb->height + iy;
+					if (!rb->floatprecision) {
+						for (c = 0; c < rb->nrchannels; c++) bdst[di + (size_t) c * planesize] = bsrc[si + (size_t) c];
+					}
+					else {
+						for (c = 0; c < rb->nrchannels; c++) ddst[di + (size_t) c * planesize] = (double) fsrc[si + (size_t) c];
+					}
+				}
+			}
+		}
+	}
+}
+
+// Parallel conversion callback: Convert pixel columns 'start' to 'end' - 1 of readback 'job':
+static void PsychConvertImageColumnsRange(void *job, size_t start, size_t end)
+{
+	PsychConvertImageColumns((PsychImageReadback*) job, start, end);
+}
+
+// Convert readback 'rb' into the returned image matrix, in parallel ranges of pixel columns for large images:
+static void PsychConvertImageReadback(PsychImageReadback *rb)
+{
+	PsychRunParallelPixelConversion(PsychConvertImageColumnsRange, (void*) rb, rb->width, rb->width * rb->height * (size_t) rb->nrchannels);
+}
+
+// Asynchronous readback via the ring of pixel buffer objects of onscreen window 'win': Returns the image queued by
+// the call 'queueDepth' calls ago and queues readback 'rb' of the current image with bottom-left corner (x, y), if
+// 'queueDepth' is positive. Returns the oldest queued image without queueing a new one if 'queueDepth' is negative.
+// Returns an empty matrix if there isn't any image to return yet:
+static void PsychGetImageAsync(PsychWindowRecordType *win, int queueDepth, PsychImageReadback *rb, int x, int y)
+{
+	PsychImageReadback	queued;
+	PsychReadbackPBO	*slot;
+	void				*ptr;
+	size_t				size;
+	int					i, s;
+
+	// New queue depth? Discard all queued readbacks and start over:
+	if ((queueDepth > 0) && (queueDepth != win->readbackPBODepth)) {
+		for (i = 0; i < PSYCH_READBACK_PBOS; i++) win->readbackPBO[i].pending = FALSE;
+		win->readbackPBODepth = queueDepth;
+		win->readbackPBOSlot = 0;
+	}
+
+	// The next slot holds the readback of 'queueDepth' calls ago, if any. When draining the queue,
+	// the oldest pending readback is in the first pending slot from there on:
+	s = win->readbackPBOSlot;
+	if (queueDepth < 0) {
+		for (i = 0; i < win->readbackPBODepth; i++) {
+			if (win->readbackPBO[(s + i) % win->readbackPBODepth].pending) break;
+		}
+		if (i < win->readbackPBODepth) s = (s + i) % win->readbackPBODepth;
+	}
+
+	slot = &(win->readbackPBO[s]);
+	if (slot->pending) {
+		// Mapping waits for completion of the readback, which should be long done by now:
+		PsychSetupImageReadback(&queued, slot->floatprecision, slot->nrchannels, (size_t) slot->width, (size_t) slot->height);
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, slot->pbo);
+		ptr = glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+		if (ptr) {
+			PsychAllocOutReadbackImage(&queued);
+			queued.src = ptr;
+			PsychConvertImageReadback(&queued);
+			glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+		}
+		else {
+			if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: In Screen('GetImage'): Failed to map readback buffer! Returning empty image.\n");
+			PsychAllocOutReadbackImage(NULL);
+			while (glGetError());
+		}
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+		slot->pending = FALSE;
+	}
+	else {
+		PsychAllocOutReadbackImage(NULL);
+	}
+
+	if (queueDepth < 0) return;
+
+	// Queue readback of the current image into the now free slot. Buffers only grow, so they get reused without reallocation:
+	slot = &(win->readbackPBO[win->readbackPBOSlot]);
+	size = PsychGetImageReadbackSize(rb);
+	if (slot->pbo == 0) glGenBuffersARB(1, &(slot->pbo));
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, slot->pbo);
+	if (slot->size < size) {
+		glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, (GLsizeiptrARB) size, NULL, GL_STREAM_READ_ARB);
+		slot->size = size;
+	}
+	PsychReadImagePixels(rb, x, y, NULL);
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+	slot->width = (int) rb->width;
+	slot->height = (int) rb->height;
+	slot->nrchannels = rb->nrchannels;
+	slot->floatprecision = rb->floatprecision;
+	slot->pending = TRUE;
+	win->readbackPBOSlot = (win->readbackPBOSlot + 1) % win->readbackPBODepth;
+
+	// Get the readback going right away:
+	glFlush();
+}
 	
 // This also works as 'AddFrameToMovie', as almost all code is shared with 'GetImage'.
 // Only difference is where the fetched pixeldata is sent: To the movie encoder or to
@@ -114,11 +383,12 @@ PsychError SCREENGetImage(void)
 {
 	PsychRectType   windowRect, sampleRect;
 	int 			nrchannels, invertedY;
-	size_t			ix, iy, sampleRectWidth, sampleRectHeight, redReturnIndex, greenReturnIndex, blueReturnIndex, alphaReturnIndex, planeSize;
-	int				viewid;
-	ubyte 			*returnArrayBase, *redPlane, *greenPlane, *bluePlane, *alphaPlane;
-	float 			*dredPlane;
-	double 			*returnArrayBaseDouble;
+	size_t			sampleRectWidth, sampleRectHeight;
+	int				viewid = 0;
+	int				queueDepth = 0;
+	static psych_bool	asyncwarned = FALSE;
+	PsychImageReadback	readback;
+	void			*readbuffer;
 	PsychWindowRecordType	*windowRecord;
 	GLboolean		isDoubleBuffer, isStereo;
 	char*           buffername = NULL;
@@ -142,7 +412,7 @@ PsychError SCREENGetImage(void)
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
 	
 	//cap the numbers of inputs and outputs
-	PsychErrorExit(PsychCapNumInputArgs(5));   //The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs((isAddMovieFrame) ? 5 : 6));   //The maximum number of inputs
 	PsychErrorExit(PsychCapNumOutputArgs(1));  //The maximum number of outputs
 	
 	// Get windowRecord for this window:
@@ -336,76 +606,36 @@ PsychError SCREENGetImage(void)
 		PsychCopyInIntegerArg(5, FALSE, &nrchannels);
 		if (nrchannels < 1 || nrchannels > 4) PsychErrorExitMsg(PsychError_user, "Number of requested channels 'nrchannels' must be between 1 and 4!");
 		
-		if (!floatprecision) {
-			// Readback of standard 8bpc uint8 pixels:  
-			PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBase);
-			redPlane  = (ubyte*) PsychMallocTemp((size_t) nrchannels * sampleRectWidth * sampleRectHeight);
-			planeSize = sampleRectWidth * sampleRectHeight;
-			greenPlane= redPlane + planeSize;
-			bluePlane = redPlane + 2 * planeSize;
-			alphaPlane= redPlane + 3 * planeSize; 
+		// Get optional queue depth for asynchronous readback:
+		PsychCopyInIntegerArg(6, FALSE, &queueDepth);
+		if (queueDepth < -PSYCH_READBACK_PBOS || queueDepth > PSYCH_READBACK_PBOS) PsychErrorExitMsg(PsychError_user, "Invalid 'queueDepth' provided. Must be between -8 and 8!");
+		if ((queueDepth != 0) && !PsychIsOnscreenWindow(windowRecord)) PsychErrorExitMsg(PsychError_user, "Asynchronous readback via 'queueDepth' is only supported for onscreen windows!");
 
-			glPixelStorei(GL_PACK_ALIGNMENT,1);
-			invertedY = windowRect[kPsychBottom] - sampleRect[kPsychBottom];
+		PsychSetupImageReadback(&readback, floatprecision, nrchannels, sampleRectWidth, sampleRectHeight);
+		invertedY = (int) (windowRect[kPsychBottom] - sampleRect[kPsychBottom]);
 
-			glReadPixels(sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_UNSIGNED_BYTE, redPlane); 
-			if (nrchannels>1) glReadPixels(sampleRect[kPsychLeft],invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_GREEN, GL_UNSIGNED_BYTE, greenPlane);
-			if (nrchannels>2) glReadPixels(sampleRect[kPsychLeft],invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_BLUE, GL_UNSIGNED_BYTE, bluePlane);
-			if (nrchannels>3) glReadPixels(sampleRect[kPsychLeft],invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_ALPHA, GL_UNSIGNED_BYTE, alphaPlane);
-			
-			//in one pass transpose and flip what we read with glReadPixels before returning.  
-			//-glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
-			//-the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.     
-			for(ix=0; ix < sampleRectWidth; ix++){
-				for(iy=0; iy < sampleRectHeight; iy++){
-					// Compute write-indices for returned data:
-					redReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth, nrchannels, iy, ix, 0);
-					greenReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 1);
-					blueReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 2);
-					alphaReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 3);
-					
-					// Always return RED/LUMINANCE channel:
-					returnArrayBase[redReturnIndex] = redPlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];  
-					// Other channels on demand:
-					if (nrchannels>1) returnArrayBase[greenReturnIndex] = greenPlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];
-					if (nrchannels>2) returnArrayBase[blueReturnIndex]  = bluePlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];
-					if (nrchannels>3) returnArrayBase[alphaReturnIndex] = alphaPlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];
-				}
-			}		
+		if ((queueDepth != 0) && glewIsSupported("GL_ARB_pixel_buffer_object")) {
+			PsychGetImageAsync(windowRecord, queueDepth, &readback, (int) sampleRect[kPsychLeft], invertedY);
+		}
+		else if (queueDepth < 0) {
+			// No pixel buffer objects, so nothing ever gets queued:
+			PsychAllocOutReadbackImage(NULL);
 		}
 		else {
-			// Readback of standard 32bpc float pixels into a double matrix:  
-			PsychAllocOutDoubleMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBaseDouble);
-			dredPlane = (float*) PsychMallocTemp((size_t) nrchannels * sizeof(float) * sampleRectWidth * sampleRectHeight);
-			planeSize = sampleRectWidth * sampleRectHeight * sizeof(float);
-
-			glPixelStorei(GL_PACK_ALIGNMENT, 1);
-			invertedY=windowRect[kPsychBottom]-sampleRect[kPsychBottom];
-
-			if (nrchannels==1) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_FLOAT, dredPlane); 
-			if (nrchannels==2) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_LUMINANCE_ALPHA, GL_FLOAT, dredPlane);
-			if (nrchannels==3) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGB, GL_FLOAT, dredPlane);
-			if (nrchannels==4) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_FLOAT, dredPlane);
-			
-			//in one pass transpose and flip what we read with glReadPixels before returning.  
-			//-glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
-			//-the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.     
-			for(ix=0; ix < sampleRectWidth; ix++){
-				for(iy=0; iy < sampleRectHeight; iy++){
-					// Compute write-indices for returned data:
-					redReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth, nrchannels, iy, ix, 0);
-					greenReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 1);
-					blueReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 2);
-					alphaReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 3);
-					
-					// Always return RED/LUMINANCE channel:
-					returnArrayBaseDouble[redReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 0];  
-					// Other channels on demand:
-					if (nrchannels>1) returnArrayBaseDouble[greenReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 1];
-					if (nrchannels>2) returnArrayBaseDouble[blueReturnIndex]  = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 2];
-					if (nrchannels>3) returnArrayBaseDouble[alphaReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 3];
-				}
-			}		
+			// No pixel buffer objects? Fall back to synchronous readback of the current image:
+			if ((queueDepth > 0) && !asyncwarned && (PsychPrefStateGet_Verbosity() > 1)) {
+				printf("PTB-WARNING: In Screen('GetImage'): Asynchronous readback unsupported by your system. Reading back synchronously.\n");
+				asyncwarned = TRUE;
+			}
+
+			// Synchronous readback of all channels with a single call, then transpose and flip what we read:
+			// -glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
+			// -the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.
+			PsychAllocOutReadbackImage(&readback);
+			readbuffer = PsychMallocTemp(PsychGetImageReadbackSize(&readback));
+			PsychReadImagePixels(&readback, (int) sampleRect[kPsychLeft], invertedY, readbuffer);
+			readback.src = readbuffer;
+			PsychConvertImageReadback(&readback);
 		}
 	}
 	
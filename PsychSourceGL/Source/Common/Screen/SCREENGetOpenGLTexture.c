@@ -65,6 +65,17 @@ PsychError SCREENGetOpenGLTexture(void)
     // Query optional y-pos:
     PsychCopyInDoubleArg(4, FALSE, &y);
 
+    // External code may use the texture in its own OpenGL context right away, so a pending
+    // asynchronous upload of the texture must be complete:
+    if (textureRecord->textureUploadFence) {
+        PsychSetGLContext(textureRecord);
+        PsychWaitForTextureUpload(textureRecord, TRUE);
+    }
+
+    // External code may modify the texture object in arbitrary ways, so it must not get recycled
+    // via the texture pool once the texture is closed:
+    textureRecord->texturePoolable = FALSE;
+
     // Return the OpenGL texture handle:
     PsychCopyOutDoubleArg(1, FALSE, (double) textureRecord->textureNumber);
     
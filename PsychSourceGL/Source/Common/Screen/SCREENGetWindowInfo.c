@@ -200,6 +200,15 @@ static char synopsisString[] =
 	"VBLStartLine, VBLEndline: Start/Endline of vertical blanking interval. The VBLEndline value is not available/valid on all GPU's.\n"
 	"SwapGroup: Swap group id of the swap group to which this window is assigned. Zero for none.\n"
 	"SwapBarrier: Swap barrier id of the swap barrier to which this windows swap group is assigned. Zero for none.\n"
+	"TexturePoolHits, TexturePoolMisses: Number of textures created from recycled texture objects of closed textures via the "
+	"texture pool of the onscreen window, and number of textures which needed a new texture object. TexturePoolEvictions: Number of "
+	"texture objects deleted to stay within the pool size. TexturePoolCount, TexturePoolMB: Number and estimated memory consumption "
+	"of currently pooled texture objects. See Screen('Preference', 'TexturePoolSizeMB') to enable the pool.\n"
+	"FBOPoolHits, FBOPoolMisses, FBOPoolEvictions, FBOPoolCount, FBOPoolMB: The same for the pool of framebuffer objects of closed "
+	"offscreen windows and textures, which shares the 'TexturePoolSizeMB' budget.\n"
+	"FBOMB: Estimated memory consumption of all framebuffer objects of the imaging pipeline and of the offscreen windows and textures "
+	"of the onscreen window. FBOPeakMB: Peak memory consumption of framebuffer objects in use and pooled. FBOAliasedMB: Memory saved "
+	"by sharing framebuffer objects between imaging pipeline stages which don't need them at the same time.\n"
 	"\n"
 	"The following settings are derived from a builtin detection heuristic, which works on most common GPU's:\n\n"
 	"GPUCoreId: Symbolic name string that roughly describes the name of the GPU core of the graphics card. This string is arbitrarily\n"
@@ -225,8 +234,10 @@ PsychError SCREENGetWindowInfo(void)
 							   "VBLTimePostFlip", "OSSwapTimestamp", "GPULastFrameRenderTime", "StereoMode", "ImagingMode", "MultiSampling", "MissedDeadlines", "FlipCount", "StereoDrawBuffer",
 							   "GuesstimatedMemoryUsageMB", "VBLStartline", "VBLEndline", "VideoRefreshFromBeamposition", "GLVendor", "GLRenderer", "GLVersion", "GPUCoreId", 
 							   "GLSupportsFBOUpToBpc", "GLSupportsBlendingUpToBpc", "GLSupportsTexturesUpToBpc", "GLSupportsFilteringUpToBpc", "GLSupportsPrecisionColors",
-							   "GLSupportsFP32Shading", "BitsPerColorComponent", "IsFullscreen", "SpecialFlags", "SwapGroup", "SwapBarrier" };
-    const int fieldCount = 35;
+							   "GLSupportsFP32Shading", "BitsPerColorComponent", "IsFullscreen", "SpecialFlags", "SwapGroup", "SwapBarrier",
+							   "TexturePoolHits", "TexturePoolMisses", "TexturePoolEvictions", "TexturePoolCount", "TexturePoolMB",
+							   "FBOPoolHits", "FBOPoolMisses", "FBOPoolEvictions", "FBOPoolCount", "FBOPoolMB", "FBOMB", "FBOPeakMB", "FBOAliasedMB" };
+    const int fieldCount = 48;
     PsychGenericScriptType *s;
 
     PsychWindowRecordType *windowRecord;
@@ -516,6 +527,23 @@ PsychError SCREENGetWindowInfo(void)
 		PsychSetStructArrayDoubleElement("SwapGroup", 0, windowRecord->swapGroup, s);
 		PsychSetStructArrayDoubleElement("SwapBarrier", 0, windowRecord->swapBarrier, s);
 
+		// Texture pool statistics of the associated onscreen window:
+		PsychSetStructArrayDoubleElement("TexturePoolHits", 0, PsychGetParentWindow(windowRecord)->texturePoolHits, s);
+		PsychSetStructArrayDoubleElement("TexturePoolMisses", 0, PsychGetParentWindow(windowRecord)->texturePoolMisses, s);
+		PsychSetStructArrayDoubleElement("TexturePoolEvictions", 0, PsychGetParentWindow(windowRecord)->texturePoolEvictions, s);
+		PsychSetStructArrayDoubleElement("TexturePoolCount", 0, PsychGetParentWindow(windowRecord)->texturePoolCount, s);
+		PsychSetStructArrayDoubleElement("TexturePoolMB", 0, (double) PsychGetParentWindow(windowRecord)->texturePoolBytes / 1024 / 1024, s);
+
+		// FBO pool statistics and FBO memory consumption of the associated onscreen window:
+		PsychSetStructArrayDoubleElement("FBOPoolHits", 0, PsychGetParentWindow(windowRecord)->fboPoolHits, s);
+		PsychSetStructArrayDoubleElement("FBOPoolMisses", 0, PsychGetParentWindow(windowRecord)->fboPoolMisses, s);
+		PsychSetStructArrayDoubleElement("FBOPoolEvictions", 0, PsychGetParentWindow(windowRecord)->fboPoolEvictions, s);
+		PsychSetStructArrayDoubleElement("FBOPoolCount", 0, PsychGetParentWindow(windowRecord)->fboPoolCount, s);
+		PsychSetStructArrayDoubleElement("FBOPoolMB", 0, (double) PsychGetParentWindow(windowRecord)->fboPoolBytes / 1024 / 1024, s);
+		PsychSetStructArrayDoubleElement("FBOMB", 0, (double) PsychGetParentWindow(windowRecord)->fboBytes / 1024 / 1024, s);
+		PsychSetStructArrayDoubleElement("FBOPeakMB", 0, (double) PsychGetParentWindow(windowRecord)->fboPeakBytes / 1024 / 1024, s);
+		PsychSetStructArrayDoubleElement("FBOAliasedMB", 0, (double) PsychGetParentWindow(windowRecord)->fboAliasedBytes / 1024 / 1024, s);
+
 		// Which basic GPU architecture is this?
 		PsychSetStructArrayStringElement("GPUCoreId", 0, windowRecord->gpuCoreId, s);
 
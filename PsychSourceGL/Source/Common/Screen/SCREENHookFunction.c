@@ -12,6 +12,7 @@
     HISTORY:
     
 		12/05/06	mk		Wrote it.
+		10/17/26	mk		Native C plugins for 'CFunction' slots, loaded from shared libraries.
 	
     DESCRIPTION:
 
@@ -83,10 +84,16 @@ static char synopsisString[] =
 	"Same as 'AppendShader' but add shader slot to beginning of the hook chain. It's recommended that you prepend slots instead of "
 	"appending them, because PTB itself may add special slots at the end of a chain."
 	"\n\n"
-	"Screen('HookFunction', windowPtr, 'AppendCFunction', hookname, idString, voidfunctionptr); \n"
-	"Screen('HookFunction', windowPtr, 'PrependCFunction', hookname, idString, voidfunctionptr); \n"
-	"Attach a C callable function to the chain. voidfunctionptr is a double value which encodes a memory pointer to the function in "
-	"memory. Encoding of the pointer and requirements to the function are non-trivial, so this is for expert developers only!"
+	"Screen('HookFunction', windowPtr, 'AppendCFunction', hookname, idString, pluginLibrary [, configString] [, entryPointName]); \n"
+	"Screen('HookFunction', windowPtr, 'PrependCFunction', hookname, idString, pluginLibrary [, configString] [, entryPointName]); \n"
+	"Attach a native C plugin function to the chain. 'pluginLibrary' is the filename of a shared library which implements the "
+	"plugin interface defined in the header file PsychImagingPluginAPI.h of the Screen source code. It is searched as given, "
+	"then in the Psychtoolbox/PsychBasic/PsychPlugins/ folder. 'configString' is an optional string which gets passed to the "
+	"plugin at each invocation. 'entryPointName' is the name of the plugin function, by default 'PsychImagingPluginMain'. "
+	"The plugin gets called with the source and destination framebuffers of the processing step and info about the window, "
+	"and can do arbitrary OpenGL rendering, so its processing runs at the full speed of native code. "
+	"Instead of 'pluginLibrary' you can also pass a double value which encodes a memory pointer to a function which implements "
+	"the same interface. This is for expert developers only!"
 	"\n\n"
 	"Screen('HookFunction', windowPtr, 'AppendMFunction', hookname, idString, fevalstring); \n"
 	"Screen('HookFunction', windowPtr, 'PrependMFunction', hookname, idString, fevalstring); \n"
@@ -139,12 +146,13 @@ PsychError SCREENHookFunction(void)
 {
 	PsychWindowRecordType	*windowRecord;
 	char					numString[10];
-	char					*cmdString, *hookString, *idString, *blitterString, *insertString;
+	char					*cmdString, *hookString, *idString, *blitterString, *insertString, *pluginString, *entryString;
 	int						i, cmd, slotid, whereloc = 0;
 	double					doubleptr;
 	double					shaderid, luttexid1 = 0;
 
 	blitterString = NULL;
+	entryString = NULL;
 
     // All subfunctions should have these two lines.  
     PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -217,11 +225,24 @@ PsychError SCREENHookFunction(void)
 				// First the id string:
 				PsychAllocInCharArg(4, kPsychArgRequired, &idString);
 				
-				// Then the void* to the function, encoded as a double value:
-				PsychCopyInDoubleArg(5, TRUE, &doubleptr);
-				
-				// Add the function void* to the chain:
-				PsychPipelineAddCFunctionToHook(windowRecord, hookString, idString, whereloc, PsychDoubleToPtr(doubleptr));
+				if (PsychGetArgType(5)==PsychArgType_char) {
+					// Then the filename of the plugin library:
+					PsychAllocInCharArg(5, TRUE, &pluginString);
+
+					// Optional config string and name of entry point:
+					PsychAllocInCharArg(6, FALSE, &blitterString);
+					PsychAllocInCharArg(7, FALSE, &entryString);
+
+					// Load the plugin and add its entry point to the chain:
+					PsychPipelineAddCPluginToHook(windowRecord, hookString, idString, whereloc, pluginString, blitterString, entryString);
+				}
+				else {
+					// Then the void* to the function, encoded as a double value:
+					PsychCopyInDoubleArg(5, TRUE, &doubleptr);
+
+					// Add the function void* to the chain:
+					PsychPipelineAddCFunctionToHook(windowRecord, hookString, idString, whereloc, PsychDoubleToPtr(doubleptr));
+				}
 				
 			}
 			else if(strstr(cmdString, "MFunction")) {
@@ -256,6 +277,8 @@ PsychError SCREENHookFunction(void)
 		break;
 		
 		case 3: // Reset hook-chain:
+			// Native C plugins may need the OpenGL context to release their resources at detach time:
+			if (PsychIsOnscreenWindow(windowRecord)) PsychSetGLContext(windowRecord);
 			PsychPipelineResetHook(windowRecord, hookString);
 		break;
 
@@ -339,6 +362,8 @@ PsychError SCREENHookFunction(void)
 		
 		case 13: // Remove slot at given index.
 			PsychCopyInIntegerArg(4, TRUE, &slotid);
+			// Native C plugins may need the OpenGL context to release their resources at detach time:
+			if (PsychIsOnscreenWindow(windowRecord)) PsychSetGLContext(windowRecord);
 			PsychPipelineDeleteHookSlot(windowRecord, hookString, slotid);
 		break;
 	}
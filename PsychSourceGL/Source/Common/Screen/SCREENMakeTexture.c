@@ -18,6 +18,9 @@
 		1/19/05		awi		Removed unused variables to eliminate compiler warnings.
 		1/26/05		awi		Added StoreNowTime() calls.
 		3/19/11		mk		Make 64-bit clean.
+		10/17/26	mk		SSE2 vectorized conversion routines, parallel conversion of large images on multiple cores.
+							Optional asynchronous texture upload via pixel buffer objects (specialFlags 8).
+							Recycling of texture objects of closed textures via the texture pool.
 
 	DESCRIPTION:
 
@@ -59,6 +62,15 @@ static char synopsisString[] =
 	"as well. Your mileage may vary, so only use this flag if you need extra speed and after verifying your stimuli still look "
 	"correct. The biggest speedup is expected for creation of standard 8 bit integer textures from uint8 input matrices, "
 	"e.g., images from imread(), but also for 8 bit integer Luminance+Alpha and RGB textures from double format input matrices.\n"
+	"If 'specialFlags' is set to 8 then PTB uploads the texture asynchronously to the graphics card: The image is converted "
+	"into one of a small ring of OpenGL pixel buffer objects and MakeTexture returns without waiting for the upload to "
+	"complete, so creation of textures overlaps with ongoing rendering, e.g., of the current trial. The first drawing of the "
+	"texture waits for completion of the upload on the GPU. This needs support for the GL_ARB_pixel_buffer_object and "
+	"GL_ARB_sync extensions, otherwise the flag is ignored. Flags can be combined by adding them, e.g., 1 + 8 = 9.\n"
+	"If you create and close many textures of the same size and format, e.g., one per trial, you can enable the texture "
+	"pool via Screen('Preference', 'TexturePoolSizeMB', sizeMB): Texture objects of closed textures are then kept up to "
+	"a total of 'sizeMB' Megabytes and recycled for new textures of identical size and format, which is faster than "
+	"creating new ones. Textures whose handles were queried via Screen('GetOpenGLTexture') are never recycled.\n"
 	"'floatprecision' defines the precision with which the texture should be stored and processed. Default value is zero, "
 	"which asks to store textures with 8 bit per color component precision, a suitable format for standard images read via "
 	"imread(). A non-zero value will store the textures color component values as floating point precision numbers, useful "
@@ -89,6 +101,207 @@ static char synopsisString[] =
 	"real data matrix associated with it -- all content is generated on the fly.\n";
 
 static char seeAlsoString[] = "DrawTexture TransformTexture BlendFunction";
+
+// Types of pixel conversions from Matlab/Octave image matrices into texture buffers:
+#define kPsychTexConvDoubleToByte	0
+#define kPsychTexConvByteToByte		1
+#define kPsychTexConvDoubleToFloat	2
+
+// Use SSE2 vectorized conversion kernels? SSE2 must be enabled at compile time:
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PSYCH_MAKETEXTURE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Description of one conversion from a planar column-major Matlab/Octave image matrix into interleaved texture memory:
+typedef struct PsychTextureConversion {
+	int				type;			// One of the kPsychTexConv conversion types.
+	int				nplanes;		// Number of image planes in input == number of color components per output texel.
+	int				order[4];		// Color component k of each output texel gets taken from input plane order[k].
+	size_t			planesize;		// Number of pixels per image plane.
+	const void*		src;			// Planar input image matrix.
+	void*			dst;			// Interleaved output buffer.
+	psych_bool		flushtiny;		// Set float results of magnitude smaller than 1e-9 to zero?
+} PsychTextureConversion;
+
+// Setup 'conv' for conversion of a 'nplanes' image of 'planesize' pixels per plane. 'order' can be NULL for identity mapping of planes:
+static void PsychSetupTextureConversion(PsychTextureConversion *conv, int type, int nplanes, const int *order, const void *src, void *dst, size_t planesize)
+{
+	int k;
+
+	conv->type = type;
+	conv->nplanes = nplanes;
+	for (k = 0; k < nplanes; k++) conv->order[k] = (order) ? order[k] : k;
+	conv->planesize = planesize;
+	conv->src = src;
+	conv->dst = dst;
+	conv->flushtiny = FALSE;
+}
+
+#if PSYCH_MAKETEXTURE_USE_SSE2
+// Convert 8 doubles into the lower 8 bytes of the result, with the same truncation and modulo 256 wraparound as a (GLubyte) cast:
+static __m128i PsychDoublesToBytesSSE2(const double *src)
+{
+	__m128i mask = _mm_set1_epi32(0xff);
+	__m128i a = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_loadu_pd(src)), _mm_cvttpd_epi32(_mm_loadu_pd(src + 2)));
+	__m128i b = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_loadu_pd(src + 4)), _mm_cvttpd_epi32(_mm_loadu_pd(src + 6)));
+
+	a = _mm_packs_epi32(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+	return(_mm_packus_epi16(a, a));
+}
+
+// Convert 4 doubles into 4 floats, optionally setting results of magnitude smaller than 1e-9 to zero:
+static __m128 PsychDoublesToFloatsSSE2(const double *src, psych_bool flushtiny)
+{
+	__m128 f = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src)), _mm_cvtpd_ps(_mm_loadu_pd(src + 2)));
+
+	// 1e-9f is the largest float below 1e-9, so this is the same test as the scalar fabs((double) f) < 1e-9:
+	if (flushtiny) f = _mm_andnot_ps(_mm_cmple_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), f), _mm_set1_ps(1e-9f)), f);
+	return(f);
+}
+
+// Convert pixels 'start' to 'end' of 'conv' in blocks of 8 pixels. Returns index of first pixel that is left for the scalar code:
+static size_t PsychConvertTexturePixelsSSE2(PsychTextureConversion *conv, const double **dp, const GLubyte **bp, size_t start, size_t end)
+{
+	__m128i			c[4], t01, t23;
+	__m128			f[4];
+	GLubyte			tmp[4][8];
+	GLubyte			*db = (GLubyte*) conv->dst;
+	GLfloat			*df = (GLfloat*) conv->dst;
+	size_t			ix;
+	int				k, i, np = conv->nplanes;
+
+	for (ix = start; ix + 8 <= end; ix += 8) {
+		if (conv->type == kPsychTexConvDoubleToFloat) {
+			// Two blocks of 4 pixels, each transposed from planar to interleaved:
+			for (i = 0; i < 8; i += 4) {
+				for (k = 0; k < np; k++) f[k] = PsychDoublesToFloatsSSE2(&(dp[k][ix + i]), conv->flushtiny);
+				switch (np) {
+					case 1:
+						_mm_storeu_ps(&(df[ix + i]), f[0]);
+					break;
+
+					case 2:
+						_mm_storeu_ps(&(df[(ix + i) * 2]), _mm_unpacklo_ps(f[0], f[1]));
+						_mm_storeu_ps(&(df[(ix + i) * 2 + 4]), _mm_unpackhi_ps(f[0], f[1]));
+					break;
+
+					case 3:
+						// Transpose with a dummy 4th plane, write 4 floats per RGB pixel, each overwriting
+						// the dummy of its predecessor. The last pixel must not write beyond its 3 floats:
+						f[3] = _mm_setzero_ps();
+						_MM_TRANSPOSE4_PS(f[0], f[1], f[2], f[3]);
+						_mm_storeu_ps(&(df[(ix + i) * 3]), f[0]);
+						_mm_storeu_ps(&(df[(ix + i) * 3 + 3]), f[1]);
+						_mm_storeu_ps(&(df[(ix + i) * 3 + 6]), f[2]);
+						_mm_storel_pi((__m64*) &(df[(ix + i) * 3 + 9]), f[3]);
+						_mm_store_ss(&(df[(ix + i) * 3 + 11]), _mm_movehl_ps(f[3], f[3]));
+					break;
+
+					case 4:
+						_MM_TRANSPOSE4_PS(f[0], f[1], f[2], f[3]);
+						_mm_storeu_ps(&(df[(ix + i) * 4]), f[0]);
+						_mm_storeu_ps(&(df[(ix + i) * 4 + 4]), f[1]);
+						_mm_storeu_ps(&(df[(ix + i) * 4 + 8]), f[2]);
+						_mm_storeu_ps(&(df[(ix + i) * 4 + 12]), f[3]);
+					break;
+				}
+			}
+			continue;
+		}
+
+		// 8 bytes per plane, either converted from double or loaded from uint8 input:
+		for (k = 0; k < np; k++) c[k] = (conv->type == kPsychTexConvDoubleToByte) ? PsychDoublesToBytesSSE2(&(dp[k][ix])) : _mm_loadl_epi64((const __m128i*) &(bp[k][ix]));
+
+		switch (np) {
+			case 1:
+				_mm_storel_epi64((__m128i*) &(db[ix]), c[0]);
+			break;
+
+			case 2:
+				_mm_storeu_si128((__m128i*) &(db[ix * 2]), _mm_unpacklo_epi8(c[0], c[1]));
+			break;
+
+			case 3:
+				// SSE2 has no byte shuffles, so interleave RGB in scalar code:
+				for (k = 0; k < 3; k++) _mm_storel_epi64((__m128i*) tmp[k], c[k]);
+				for (i = 0; i < 8; i++) {
+					db[(ix + i) * 3]     = tmp[0][i];
+					db[(ix + i) * 3 + 1] = tmp[1][i];
+					db[(ix + i) * 3 + 2] = tmp[2][i];
+				}
+			break;
+
+			case 4:
+				t01 = _mm_unpacklo_epi8(c[0], c[1]);
+				t23 = _mm_unpacklo_epi8(c[2], c[3]);
+				_mm_storeu_si128((__m128i*) &(db[ix * 4]), _mm_unpacklo_epi16(t01, t23));
+				_mm_storeu_si128((__m128i*) &(db[ix * 4 + 16]), _mm_unpackhi_epi16(t01, t23));
+			break;
+		}
+	}
+
+	return(ix);
+}
+#endif
+
+// Convert pixels 'start' to 'end' of conversion 'conv':
+static void PsychConvertTexturePixels(PsychTextureConversion *conv, size_t start, size_t end)
+{
+	const double	*dp[4];
+	const GLubyte	*bp[4];
+	GLubyte			*db = (GLubyte*) conv->dst;
+	GLfloat			*df = (GLfloat*) conv->dst;
+	size_t			ix = start;
+	int				k, np = conv->nplanes;
+
+	// Plain copy if no conversion and no interleaving needed:
+	if ((conv->type == kPsychTexConvByteToByte) && (np == 1)) {
+		memcpy(&(db[start]), &(((const GLubyte*) conv->src)[start]), end - start);
+		return;
+	}
+
+	for (k = 0; k < np; k++) {
+		dp[k] = ((const double*) conv->src) + (size_t) conv->order[k] * conv->planesize;
+		bp[k] = ((const GLubyte*) conv->src) + (size_t) conv->order[k] * conv->planesize;
+	}
+
+	#if PSYCH_MAKETEXTURE_USE_SSE2
+	ix = PsychConvertTexturePixelsSSE2(conv, dp, bp, start, end);
+	#endif
+
+	// Scalar code for remaining pixels:
+	for (; ix < end; ix++) {
+		for (k = 0; k < np; k++) {
+			switch (conv->type) {
+				case kPsychTexConvDoubleToByte:
+					db[ix * np + k] = (GLubyte) dp[k][ix];
+				break;
+
+				case kPsychTexConvByteToByte:
+					db[ix * np + k] = bp[k][ix];
+				break;
+
+				case kPsychTexConvDoubleToFloat:
+					df[ix * np + k] = (GLfloat) dp[k][ix];
+					if (conv->flushtiny && (fabs((double) df[ix * np + k]) < 1e-9)) df[ix * np + k] = 0.0;
+				break;
+			}
+		}
+	}
+}
+
+// Parallel conversion callback: Convert pixels 'start' to 'end' - 1 of conversion 'job':
+static void PsychConvertTexturePixelsRange(void *job, size_t start, size_t end)
+{
+	PsychConvertTexturePixels((PsychTextureConversion*) job, start, end);
+}
+
+// Perform conversion 'conv', in parallel tiles of consecutive pixels for large images:
+static void PsychConvertTexture(PsychTextureConversion *conv)
+{
+	PsychRunParallelPixelConversion(PsychConvertTexturePixelsRange, (void*) conv, conv->planesize, conv->planesize * (size_t) conv->nplanes);
+}
 	 
 PsychError SCREENMakeTexture(void) 
 {
@@ -101,14 +314,16 @@ PsychError SCREENMakeTexture(void)
     unsigned char						*byteMatrix;
     double								*doubleMatrix;
     GLuint								*texturePointer;
-    GLubyte								*texturePointer_b;
 	GLfloat								*texturePointer_f;
-    double								*rp, *gp, *bp, *ap;
-    GLubyte								*rpb, *gpb, *bpb, *apb;
+    GLubyte								*rpb;
     int									usepoweroftwo, usefloatformat, assume_texorientation, textureShader;
     double								optimized_orientation;
     psych_bool							bigendian;
 	psych_bool							planar_storage = FALSE;
+	psych_bool							asyncupload;
+	PsychTextureConversion				conv;
+	static const int					bgraorder[4] = { 2, 1, 0, 3 };
+	static const int					argborder[4] = { 3, 0, 1, 2 };
 
     // Detect endianity (byte-order) of machine:
     ix=255;
@@ -216,7 +431,7 @@ PsychError SCREENMakeTexture(void)
 	// Is texture storage in planar format explicitely requested by usercode? Do the gpu and its size
 	// constraints on textures support planar storage for this image?
 	// Can a proper planar -> interleaved remapping GLSL shader be generated and assigned for this texture?
-	if ((usepoweroftwo == 4) && (numMatrixPlanes > 1) && (windowRecord->gfxcaps & kPsychGfxCapFBO) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) &&
+	if (((usepoweroftwo & ~8) == 4) && (numMatrixPlanes > 1) && (windowRecord->gfxcaps & kPsychGfxCapFBO) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) &&
 		(ySize * numMatrixPlanes <= windowRecord->maxTextureSize) && PsychAssignPlanarTextureShaders(textureRecord, windowRecord, numMatrixPlanes)) {
 		// Yes: Use the planar texture storage fast-path.
 		planar_storage = TRUE;
@@ -237,10 +452,15 @@ PsychError SCREENMakeTexture(void)
 		textureRecord->textureMemorySizeBytes = (size_t) numMatrixPlanes * (size_t) xSize * (size_t) ySize;
     }
 
+	// Asynchronous upload requested? Not for client storage textures, which don't get uploaded, and not
+	// for planar uint8 textures, which don't need any conversion:
+	asyncupload = ((usepoweroftwo & 8) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) && !(isImageMatrixBytes && planar_storage)) ? TRUE : FALSE;
+
 	// We allocate our own intermediate conversion buffer unless this is
 	// creation of a single-layer luminance8 integer texture from a single
-	// layer uint8 input matrix and client storage is disabled. In that case, we can use a zero-copy path:
-	if ((isImageMatrixBytes && (numMatrixPlanes == 1) && (!usefloatformat) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures)) ||
+	// layer uint8 input matrix and client storage is disabled. In that case, we can use a zero-copy path,
+	// unless asynchronous upload needs a copy in an upload buffer:
+	if ((isImageMatrixBytes && (numMatrixPlanes == 1) && (!usefloatformat) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) && !asyncupload) ||
 		(isImageMatrixBytes && planar_storage)) {
 		// Zero copy path:
 		texturePointer = NULL;
@@ -248,7 +468,8 @@ PsychError SCREENMakeTexture(void)
 	else {
 		// Allocate memory:
 		if(PsychPrefStateGet_DebugMakeTexture()) StoreNowTime();
-		textureRecord->textureMemory = malloc(textureRecord->textureMemorySizeBytes);
+		textureRecord->textureMemory = (asyncupload) ? PsychMapTextureUploadBuffer(windowRecord, textureRecord, textureRecord->textureMemorySizeBytes) : NULL;
+		if (NULL == textureRecord->textureMemory) textureRecord->textureMemory = malloc(textureRecord->textureMemorySizeBytes);
 		if(PsychPrefStateGet_DebugMakeTexture()) StoreNowTime();
 		texturePointer = textureRecord->textureMemory;
 	}
@@ -295,10 +516,9 @@ PsychError SCREENMakeTexture(void)
 
 				// Perform copy with double -> float cast:
 				iters = (size_t) xSize * (size_t) ySize * (size_t) numMatrixPlanes;
-				texturePointer_f = (GLfloat*) texturePointer;
-				for(ix = 0; ix < iters; ix++) {
-					*(texturePointer_f++) = (GLfloat) *(doubleMatrix++);
-				}
+				PsychSetupTextureConversion(&conv, kPsychTexConvDoubleToFloat, 1, NULL, doubleMatrix, texturePointer, iters);
+				conv.flushtiny = ((usefloatformat == 1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16)) ? TRUE : FALSE;
+				PsychConvertTexture(&conv);
 				iters = (size_t) xSize * (size_t) ySize;
 			}
 			else {
@@ -308,10 +528,8 @@ PsychError SCREENMakeTexture(void)
 				textureRecord->textureinternalformat = GL_LUMINANCE8;
 
 				iters = (size_t) xSize * (size_t) ySize * (size_t) numMatrixPlanes;
-				texturePointer_b = (GLubyte*) texturePointer;
-				for(ix = 0; ix < iters; ix++) {
-					*(texturePointer_b++) = (GLubyte) *(doubleMatrix++);
-				}
+				PsychSetupTextureConversion(&conv, kPsychTexConvDoubleToByte, 1, NULL, doubleMatrix, texturePointer, iters);
+				PsychConvertTexture(&conv);
 				iters = (size_t) xSize * (size_t) ySize;
 			}
 		}
@@ -321,14 +539,14 @@ PsychError SCREENMakeTexture(void)
 		// Our input is always double matrices...
 		iters = (size_t) xSize * (size_t) ySize;
 
-		// Our input buffer is always of GL_FLOAT precision:
+		// Our input buffer is always of GL_FLOAT precision. Convert from planar double to interleaved float.
+		// See below for the reason to flush tiny values to zero for 16 bpc float:
 		textureRecord->textureexternaltype = GL_FLOAT;
-		texturePointer_f=(GLfloat*) texturePointer;
-		
+		PsychSetupTextureConversion(&conv, kPsychTexConvDoubleToFloat, numMatrixPlanes, NULL, doubleMatrix, texturePointer, iters);
+		conv.flushtiny = ((usefloatformat == 1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16)) ? TRUE : FALSE;
+		PsychConvertTexture(&conv);
+
 		if(numMatrixPlanes==1) {
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(doubleMatrix++);  
-			}
 			textureRecord->depth=(usefloatformat==1) ? 16 : 32;
 
 			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_FLOAT16_APPLE : GL_LUMINANCE_FLOAT32_APPLE; 
@@ -339,13 +557,6 @@ PsychError SCREENMakeTexture(void)
 		}
 
 		if(numMatrixPlanes==2) {
-			rp=(double*) ((size_t) doubleMatrix);
-			ap=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(rp++);  
-				*(texturePointer_f++)= (GLfloat) *(ap++);  
-			}
 			textureRecord->depth=(usefloatformat==1) ? 32 : 64;
 			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_ALPHA_FLOAT16_APPLE : GL_LUMINANCE_ALPHA_FLOAT32_APPLE; 
 			textureRecord->textureexternalformat = GL_LUMINANCE_ALPHA;
@@ -355,15 +566,6 @@ PsychError SCREENMakeTexture(void)
 		}
 		
 		if(numMatrixPlanes==3) {
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(rp++);  
-				*(texturePointer_f++)= (GLfloat) *(gp++);  
-				*(texturePointer_f++)= (GLfloat) *(bp++);  
-			}
 			textureRecord->depth=(usefloatformat==1) ? 48 : 96;
 			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGB_FLOAT16_APPLE : GL_RGB_FLOAT32_APPLE; 
 			textureRecord->textureexternalformat = GL_RGB;
@@ -373,17 +575,6 @@ PsychError SCREENMakeTexture(void)
 		}
 		
 		if(numMatrixPlanes==4) {
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-			ap=(double*) ((size_t) bp + (size_t) iters * sizeof(double));
-
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(rp++);  
-				*(texturePointer_f++)= (GLfloat) *(gp++);  
-				*(texturePointer_f++)= (GLfloat) *(bp++);  
-				*(texturePointer_f++)= (GLfloat) *(ap++);  
-			}			
 			textureRecord->depth=(usefloatformat==1) ? 64 : 128;
 			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGBA_FLOAT16_APPLE : GL_RGBA_FLOAT32_APPLE; 
 			textureRecord->textureexternalformat = GL_RGBA;
@@ -397,150 +588,27 @@ PsychError SCREENMakeTexture(void)
 		// Standard LDR texture 8 bpc conversion routines -- Fast path.
 		iters = (size_t) xSize * (size_t) ySize;
 
-		// Improved implementation: Takes 13 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==1){
-			texturePointer_b=(GLubyte*) texturePointer;
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= (GLubyte) *(doubleMatrix++);  
-			}
-			textureRecord->depth=8;
-		}
-		
-		// Improved version: Takes 3 ms on a 800x800 texture...
-		// NB: Implementing memcpy manually by a for-loop takes 10 ms! This is a huge difference.
-		// -> That's because memcpy on MacOS-X is implemented with hand-coded, highly tuned Assembler code for PowerPC.
-		// -> It's always wise to use system-routines if available, instead of coding it by yourself!
-		if(isImageMatrixBytes && numMatrixPlanes==1) {
-			if (texturePointer) {
-				// Need to do a copy. Use optimized memcpy():
-				memcpy((void*) texturePointer, (void*) byteMatrix, iters);
-				
-				//texturePointer_b=(GLubyte*) texturePointer;
-				//for(ix=0;ix<iters;ix++){
-				//	*(texturePointer_b++) = *(byteMatrix++);  
-				//}
-			}
-			else {
-				// Zero-Copy path. Just pass a pointer to our input matrix:
-				texturePointer = (GLuint*) byteMatrix;
-				textureRecord->textureMemory = texturePointer;
-				// Set size to zero, so PsychCreateTexture() does not free() our
-				// input buffer:
-				textureRecord->textureMemorySizeBytes = 0;
-			}
-
-			textureRecord->depth=8;
-		}
-		
-		// New version: Takes 33 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==2){
-			texturePointer_b=(GLubyte*) texturePointer;
-			rp=(double*) ((size_t) doubleMatrix);
-			ap=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= (GLubyte) *(rp++);  
-				*(texturePointer_b++)= (GLubyte) *(ap++);  
-			}
-			textureRecord->depth=16;
-		}
-		
-		// New version: Takes 20 ms on a 800x800 texture...
-		if(isImageMatrixBytes && numMatrixPlanes==2){
-			texturePointer_b=(GLubyte*) texturePointer;
-			rpb=(GLubyte*) ((size_t) byteMatrix);
-			apb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= *(rpb++);  
-				*(texturePointer_b++)= *(apb++);  
-			}
-			textureRecord->depth=16;
-		}
-		
-		// Improved version: Takes 43 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==3){
-			texturePointer_b=(GLubyte*) texturePointer;
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= (GLubyte) *(rp++);  
-				*(texturePointer_b++)= (GLubyte) *(gp++);  
-				*(texturePointer_b++)= (GLubyte) *(bp++);  
-			}
-			textureRecord->depth=24;
-		}
-		
-		// Improved version: Takes 25 ms on a 800x800 texture...
-		if(isImageMatrixBytes && numMatrixPlanes==3){
-			texturePointer_b=(GLubyte*) texturePointer;			
-			rpb=(GLubyte*) ((size_t) byteMatrix);
-			gpb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-			bpb=(GLubyte*) ((size_t) gpb + (size_t) iters);
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= *(rpb++);  
-				*(texturePointer_b++)= *(gpb++);  
-				*(texturePointer_b++)= *(bpb++);  
-			}
-			textureRecord->depth=24;
-		}
-		
-		// Improved version: Takes 55 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==4){
-			texturePointer_b=(GLubyte*) texturePointer;			
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-			ap=(double*) ((size_t) bp + (size_t) iters * sizeof(double));
-			if (bigendian) {
-				// Code for big-endian machines like PowerPC:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= (GLubyte) *(ap++);  
-					*(texturePointer_b++)= (GLubyte) *(rp++);  
-					*(texturePointer_b++)= (GLubyte) *(gp++);  
-					*(texturePointer_b++)= (GLubyte) *(bp++);  
-				}
-			}
-			else {
-				// Code for little-endian machines like Intel Pentium:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= (GLubyte) *(bp++);  
-					*(texturePointer_b++)= (GLubyte) *(gp++);  
-					*(texturePointer_b++)= (GLubyte) *(rp++);  
-					*(texturePointer_b++)= (GLubyte) *(ap++);  
-				}
-			}
-			
-			textureRecord->depth=32;
+		// Single layer uint8 input without client storage needs no conversion at all:
+		if(isImageMatrixBytes && numMatrixPlanes==1 && texturePointer == NULL) {
+			// Zero-Copy path. Just pass a pointer to our input matrix:
+			texturePointer = (GLuint*) byteMatrix;
+			textureRecord->textureMemory = texturePointer;
+			// Set size to zero, so PsychCreateTexture() does not free() our
+			// input buffer:
+			textureRecord->textureMemorySizeBytes = 0;
 		}
-		
-		// Improved version: Takes 33 ms on a 800x800 texture...
-		if(isImageMatrixBytes && numMatrixPlanes==4){
-			texturePointer_b=(GLubyte*) texturePointer;			
-			rpb=(GLubyte*) ((size_t) byteMatrix);
-			gpb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-			bpb=(GLubyte*) ((size_t) gpb + (size_t) iters);
-			apb=(GLubyte*) ((size_t) bpb + (size_t) iters);
-			if (bigendian) {
-				// Code for big-endian machines like PowerPC:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= *(apb++);  
-					*(texturePointer_b++)= *(rpb++);  
-					*(texturePointer_b++)= *(gpb++);  
-					*(texturePointer_b++)= *(bpb++);  
-				}
-			}
-			else {
-				// Code for little-endian machines like Intel Pentium:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= *(bpb++);  
-					*(texturePointer_b++)= *(gpb++);  
-					*(texturePointer_b++)= *(rpb++);  
-					*(texturePointer_b++)= *(apb++);  
-				}
-			}
-			
-			textureRecord->depth=32;
+		else {
+			// Interleave planes, casting from double if needed. 4 layer RGBA matrices are stored in BGRA
+			// order on little-endian machines like Intel Pentium and in ARGB order on big-endian machines
+			// like PowerPC. Single layer uint8 input is copied with memcpy(). Large images are converted
+			// in parallel on multiple cores, see PsychConvertTexture():
+			PsychSetupTextureConversion(&conv, (isImageMatrixDoubles) ? kPsychTexConvDoubleToByte : kPsychTexConvByteToByte, numMatrixPlanes,
+										(numMatrixPlanes == 4) ? ((bigendian) ? argborder : bgraorder) : NULL,
+										(isImageMatrixDoubles) ? (void*) doubleMatrix : (void*) byteMatrix, texturePointer, iters);
+			PsychConvertTexture(&conv);
 		}
+
+		textureRecord->depth = 8 * numMatrixPlanes;
 	} // End of 8 bpc texture conversion code (fast-path for LDR textures)
     
 	// Override for missing floating point texture support?
@@ -578,13 +646,8 @@ PsychError SCREENMakeTexture(void)
 	// This is a special workaround for bugs in FLOAT16 texture creation on Mac OS/X 10.4.x and 10.5.x.
 	// The OpenGL fails to properly flush very small values (< 1e-9) to zero when creating a FLOAT16
 	// type texture. Instead it seems to initialize with trash data, corrupting the texture.
-	// Therefore, if FLOAT16 texture creation is requested, we loop over the whole input buffer and
-	// set all values with magnitude smaller than 1e-9 to zero. Better safe than sorry...
-	if ((usefloatformat==1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16)) {
-		texturePointer_f=(GLfloat*) texturePointer;
-		iters = iters * (size_t) numMatrixPlanes;
-		for(ix=0; ix<iters; ix++, texturePointer_f++) if(fabs((double) *texturePointer_f) < 1e-9) { *texturePointer_f = 0.0; }
-	}
+	// Therefore, if FLOAT16 texture creation is requested, all values with magnitude smaller than
+	// 1e-9 got set to zero during conversion above via conv.flushtiny. Better safe than sorry...
 
     // The memory buffer now contains our texture data in a format ready to submit to OpenGL.
     
@@ -597,6 +660,9 @@ PsychError SCREENMakeTexture(void)
 	// This is our best guess about the number of image channels:
 	textureRecord->nrchannels = numMatrixPlanes;
 
+	// Texture object may be recycled from, and returned to, the texture pool of the onscreen window:
+	textureRecord->texturePoolable = TRUE;
+
 	if (planar_storage) {
 		// Setup special rect to fake PsychCreateTexture() into creating a luminance
 		// texture numMatrixPlanes times the height (in rows) of the texture, to store the
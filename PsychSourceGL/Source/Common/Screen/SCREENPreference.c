@@ -18,6 +18,7 @@
 		5/30/05		mk		New preference setting screenVisualDebugLevel.
 		3/07/05		awi		New preference SuppressAllWarnings.
                 11/15/06        mk              New preference vbl & flip timestamping mode.
+		10/17/26	mk		New preference TexturePoolSizeMB.
  
 	DESCRIPTION:
   
@@ -128,6 +129,7 @@ static char synopsisString[] =
 	"\noldMode = Screen('Preference', 'DefaultVideocaptureEngine', [newmode (0=Quicktime-SequenceGrabbers, 1=LibDC1394-Firewire, 2=LibARVideo, 3=GStreamer)]);"
 	"\noldMode = Screen('Preference', 'OverrideMultimediaEngine', [newmode (0=System default, 1=GStreamer)]);"
 	"\noldLevel = Screen('Preference', 'WindowShieldingLevel', [newLevel (0 = Behind all other windows - 2000 = In front of all other windows, the default)]);"
+	"\noldSizeMB = Screen('Preference', 'TexturePoolSizeMB', [newSizeMB (0 = Disabled, the default)]);"
 	"\nresiduals = Screen('Preference', 'SynchronizeDisplays', syncMethod [, screenId]);"
 	"\noldMappings = Screen('Preference', 'ScreenToHead', screenId [, newHeadId, newCrtcId][, rank=0]);"
 
@@ -383,6 +385,14 @@ PsychError SCREENPreference(void)
 					PsychPrefStateSet_WindowShieldingLevel(tempInt);
 				}
 			preferenceNameArgumentValid=TRUE;
+		}else
+			if(PsychMatch(preferenceName, "TexturePoolSizeMB")){
+				PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_TexturePoolSizeMB());
+				if(numInputArgs==2){
+					PsychCopyInIntegerArg(2, kPsychArgRequired, &tempInt);
+					PsychPrefStateSet_TexturePoolSizeMB(tempInt);
+				}
+			preferenceNameArgumentValid=TRUE;
 		}else 
 			if(PsychMatch(preferenceName, "ConserveVRAM") || PsychMatch(preferenceName, "Workarounds1")){
 					PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_ConserveVRAM());
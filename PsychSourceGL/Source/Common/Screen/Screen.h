@@ -117,6 +117,12 @@ char		*PsychGetGLErrorNameString(GLenum errorConstant);
 void		PsychTestForGLErrorsC(int lineNum, const char *funcName, const char *fileName);
 GLdouble	*PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdouble *vertex);
 void		PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size);
+GLfloat*	PsychStreamVertexData(PsychWindowRecordType *windowRecord, GLfloat *data, size_t size);
+void		PsychReleaseStreamVertexData(PsychWindowRecordType *windowRecord);
+void		PsychDrawOvals(PsychWindowRecordType *windowRecord, int numRects, double *rects, int nrsize, double *penSizes, int nc, int mc, double *colors, unsigned char *bytecolors, double maxDiameter, psych_bool smooth);
+
+// Release dot fields of an onscreen window at window close time: Defined in SCREENDotField.c
+void PsychCloseDotFieldsOfWindow(PsychWindowRecordType *windowRecord);
 
 // Helper routines for vertically compressed stereo displays: Defined in SCREENSelectStereoDrawBuffer.c
 int PsychSwitchCompressedStereoDrawBuffer(PsychWindowRecordType *windowRecord, int newbuffer);
@@ -238,6 +244,9 @@ PsychError	SCREENFinalizeMovie(void);
 PsychError      SCREENAddAudioBufferToMovie(void);
 PsychError      SCREENGetFlipInfo(void);
 PsychError      SCREENConfigureDisplay(void);
+PsychError	SCREENCreateDotField(void);
+PsychError	SCREENStepDotField(void);
+PsychError	SCREENCloseDotField(void);
 
 //PsychError SCREENSetGLSynchronous(void);		//SCREENSetGLSynchronous.c
 
@@ -94,6 +94,7 @@ static int								videoCaptureEngineId;			// Default video capture engine: 0 = Q
 static int								windowShieldingLevel;			// Level of priority of windowed onscreen window wrt. other windows:
 																		// From 0 for "behind everything" to 2000 for "in front of everything. Exact meaning of
 																		// number is OS specific. This value is used at window open time for each window.
+static int								texturePoolSizeMB;				// Budget in MB for recycling of texture objects of closed textures. Zero = Disabled.
 static double							frameRectLadderCorrection;		// Tweak factor to apply in SCREENFrameRect.c for different GPU's.
 static psych_bool						suppressAllWarnings;
 
@@ -140,6 +141,7 @@ void PrepareScreenPreferences(void)
 	screenVBLEndlineOverride=-1;
 	videoCaptureEngineId=PTB_DEFAULTVIDCAPENGINE;
 	windowShieldingLevel=2000;
+	texturePoolSizeMB=0;
 	frameRectLadderCorrection=-1.0;
 	suppressAllWarnings=FALSE;
 	Verbosity=3;
@@ -420,6 +422,18 @@ void PsychPrefStateSet_WindowShieldingLevel(int level)
     windowShieldingLevel = level;
 }
 
+// Budget for the per-window pool of recycled texture objects:
+int PsychPrefStateGet_TexturePoolSizeMB(void)
+{
+	return(texturePoolSizeMB);
+}
+
+void PsychPrefStateSet_TexturePoolSizeMB(int sizeMB)
+{
+	if (sizeMB < 0) PsychErrorExitMsg(PsychError_user, "Invalid (negative) texture pool size provided!");
+	texturePoolSizeMB = sizeMB;
+}
+
 // Correction tweak offset for proper Screen('FrameRect') behaviour:
 void PsychPrefStateSet_FrameRectCorrection(double level)
 {
@@ -107,6 +107,10 @@ void PsychPrefStateSet_VideoCaptureEngine(int mode);
 void PsychPrefStateSet_WindowShieldingLevel(int level);
 int PsychPrefStateGet_WindowShieldingLevel(void);
 
+// Budget for the per-window pool of recycled texture objects:
+int PsychPrefStateGet_TexturePoolSizeMB(void);
+void PsychPrefStateSet_TexturePoolSizeMB(int sizeMB);
+
 // Correction tweak offset for proper Screen('FrameRect') behaviour:
 void PsychPrefStateSet_FrameRectCorrection(double level);
 double PsychPrefStateGet_FrameRectCorrection(void);
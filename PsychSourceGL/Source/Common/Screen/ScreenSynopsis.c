@@ -92,8 +92,8 @@ void InitializeSynopsis()
 	synopsis[i++] = "Screen('FillArc',windowPtr,[color],[rect],startAngle,arcAngle)";
 	synopsis[i++] = "Screen('FillRect', windowPtr [,color] [,rect] );";
 	synopsis[i++] = "Screen('FrameRect', windowPtr [,color] [,rect] [,penWidth]);";
-	synopsis[i++] = "Screen('FillOval', windowPtr [,color] [,rect] [,perfectUpToMaxDiameter]);";
-	synopsis[i++] = "Screen('FrameOval', windowPtr [,color] [,rect] [,penWidth] [,penHeight] [,penMode]);";
+	synopsis[i++] = "Screen('FillOval', windowPtr [,color] [,rect] [,perfectUpToMaxDiameter] [,smooth]);";
+	synopsis[i++] = "Screen('FrameOval', windowPtr [,color] [,rect] [,penWidth] [,penHeight] [,penMode] [,smooth]);";
 	synopsis[i++] = "Screen('FramePoly', windowPtr [,color], pointList [,penWidth]);";
 	synopsis[i++] = "Screen('FillPoly', windowPtr [,color], pointList [, isConvex]);";	
 	
@@ -103,6 +103,9 @@ void InitializeSynopsis()
 	synopsis[i++] = "Screen('gluDisk', windowPtr, color, x, y [,size]);";
 	synopsis[i++] = "Screen('DrawDots', windowPtr, xy [,size] [,color] [,center] [,dot_type]);";
 	synopsis[i++] = "Screen('DrawLines', windowPtr, xy [,width] [,colors] [,center] [,smooth]);";
+	synopsis[i++] = "dotField = Screen('CreateDotField', windowPtr, nrDots [, rect] [, speed=1] [, direction=0] [, coherence=1] [, lifetime=inf]);";
+	synopsis[i++] = "Screen('StepDotField', windowPtr, dotField [, nrSteps=1] [, size=1] [, color] [, dot_type=0] [, speed] [, direction] [, coherence] [, lifetime]);";
+	synopsis[i++] = "Screen('CloseDotField', dotField);";
 	synopsis[i++] = "[sourceFactorOld, destinationFactorOld, colorMaskOld]=Screen('BlendFunction', windowIndex, [sourceFactorNew], [destinationFactorNew], [colorMaskNew]);";
 
 	// Draw Text in windows
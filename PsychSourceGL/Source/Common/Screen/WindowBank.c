@@ -278,9 +278,52 @@ void PsychCreateWindowRecord(PsychWindowRecordType **winRec)
 	(*winRec)->inBlueTable = NULL;
 	(*winRec)->loadGammaTableOnNextFlip = 0;
 	
-	// Set cached display list handles for drawing functions to "uninitialized":
-	(*winRec)->fillOvalDisplayList = 0;
-	(*winRec)->frameOvalDisplayList = 0;
+	// Set cached GL objects for drawing functions to "uninitialized":
+	(*winRec)->ovalShader = 0;
+	(*winRec)->pointSizeShader = 0;
+	(*winRec)->streamVBO = 0;
+
+	// No asynchronous texture upload buffers or pending uploads yet:
+	for (i = 0; i < PSYCH_TEXTURE_UPLOAD_PBOS; i++) {
+		(*winRec)->textureUploadPBO[i] = 0;
+		(*winRec)->textureUploadPBOSize[i] = 0;
+		(*winRec)->textureUploadPBOFence[i] = NULL;
+	}
+	(*winRec)->textureUploadPBOSlot = 0;
+	(*winRec)->textureUploadBuffer = 0;
+	(*winRec)->textureUploadFence = NULL;
+
+	// No texture pool yet, texture objects not poolable by default:
+	(*winRec)->texturePool = NULL;
+	(*winRec)->texturePoolCount = 0;
+	(*winRec)->texturePoolCapacity = 0;
+	(*winRec)->texturePoolBytes = 0;
+	(*winRec)->texturePoolHits = 0;
+	(*winRec)->texturePoolMisses = 0;
+	(*winRec)->texturePoolEvictions = 0;
+	(*winRec)->texturePoolable = FALSE;
+	(*winRec)->texturePoolKey.textureNumber = 0;
+
+	// No FBO's and no FBO pool yet:
+	(*winRec)->fboBytes = 0;
+	(*winRec)->fboPeakBytes = 0;
+	(*winRec)->fboAliasedBytes = 0;
+	(*winRec)->fboPool = NULL;
+	(*winRec)->fboPoolCount = 0;
+	(*winRec)->fboPoolCapacity = 0;
+	(*winRec)->fboPoolBytes = 0;
+	(*winRec)->fboPoolHits = 0;
+	(*winRec)->fboPoolMisses = 0;
+	(*winRec)->fboPoolEvictions = 0;
+
+	// No asynchronous readback buffers yet:
+	for (i = 0; i < PSYCH_READBACK_PBOS; i++) {
+		(*winRec)->readbackPBO[i].pbo = 0;
+		(*winRec)->readbackPBO[i].size = 0;
+		(*winRec)->readbackPBO[i].pending = FALSE;
+	}
+	(*winRec)->readbackPBODepth = 0;
+	(*winRec)->readbackPBOSlot = 0;
 
 	// No special flags set by default:
 	(*winRec)->specialflags = 0;
@@ -68,12 +68,33 @@ TO DO:
 // Maximum number of slots in windowRecords fboTable:
 #define MAX_FBOTABLE_SLOTS 2+2+3+4+2
 
+// Number of pixel buffer objects in the ring of upload buffers for asynchronous texture uploads of an onscreen window:
+#define PSYCH_TEXTURE_UPLOAD_PBOS 4
+
+// Maximum number of pixel buffer objects in the ring for asynchronous Screen('GetImage') readback of an onscreen window:
+#define PSYCH_READBACK_PBOS 8
+
 // Type of hook function attached to a specific hook chain slot:
 #define kPsychShaderFunc	0
 #define kPsychCFunc			1
 #define kPsychMFunc			2
 #define kPsychBuiltinFunc	3
 
+// Resolved operation of a precompiled hook chain slot, see PsychPipelineCompileHookChain():
+#define kPsychHookOpUnknown				0	// Unknown builtin: Fails at execution time.
+#define kPsychHookOpShader				1	// GLSL shader blit.
+#define kPsychHookOpCFunc				2	// C callback function.
+#define kPsychHookOpMFunc				3	// Runtime environment function.
+#define kPsychHookOpFlipFBOs			4	// Builtin:FlipFBOs
+#define kPsychHookOpScissorROI			5	// Builtin:RestrictToScissorROI
+#define kPsychHookOpIdentityBlit		6	// Builtin:IdentityBlit
+#define kPsychHookOpClutBitsPlusPlus	7	// Builtin:RenderClutBits++
+#define kPsychHookOpClutViaRuntime		8	// Builtin:RenderClutViaRuntime
+#define kPsychHookOpStereoSyncLine		9	// Builtin:RenderStereoSyncLine
+
+// Maximum number of texture bindings in the parameter string of a single hook slot, more are rejected as parse error:
+#define kPsychMaxHookTextures			8
+
 // Detected capabilities of the gfx-hardware, as interrogated by PsychDetectAndAssignGfxCapabilities()
 // at onscreen window creation time and stored in windowRecord->gfxcaps as part of a bitfield:
 #define kPsychGfxCapFBO			1			// Hw supports OpenGL FBOs as rendertargets.
@@ -149,6 +170,26 @@ typedef struct PsychHookFunction {
 	void*					cprocfunc;
 	unsigned int			shaderid;
 	unsigned int			luttexid1;
+	void*					pluginLibrary;							// Shared library handle of a CFunction plugin, NULL if cprocfunc was passed as memory pointer.
+	void*					pluginData;								// Private per-slot data of a CFunction plugin, see PsychImagingPluginAPI.h.
+	psych_bool				pluginDetached;							// CFunction plugin already received kPsychImagingPluginDetach.
+	// Precompiled form of this slot, set up by PsychPipelineCompileHookChain() from the fields above:
+	int						opcode;									// Resolved operation kPsychHookOpXXX.
+	const char*				parseError;								// Error message if pString1 failed to parse, NULL otherwise.
+	int						parseErrorType;							// PsychError type to report parseError with, PsychError_none = just fail the slot.
+	void*					blitterfunc;							// Override blitter from 'Blitter:' spec in pString1, NULL = Use master or default blitter.
+	int						numTextures;							// Number of textures to bind for blit, from 'TEXTUREXXX(unit)=id' specs:
+	GLenum					texTarget[kPsychMaxHookTextures];
+	GLenum					texUnit[kPsychMaxHookTextures];
+	GLuint					texId[kPsychMaxHookTextures];
+	int						ovrWidth, ovrHeight;					// Blitter 'OvrSize:' override size, zero if none.
+	psych_bool				bilinear;								// Blitter 'Bilinear' filtering.
+	int						offsetX, offsetY;						// Blitter 'Offset:'.
+	float					scaleX, scaleY;							// Blitter 'Scaling:'.
+	GLuint					gllist;									// Display list 'Handle:' for Blitter:DisplayListBlit.
+	int						iParams[4];								// Integer parameters of builtins: Scissor rectangle, Bits++ x and y position.
+	float					fParams[5];								// Float parameters of builtins: Stereo sync line yPosition, hFraction, color.
+	psych_bool				hasYPosition;							// Stereo sync line: yPosition= was specified.
 } PsychHookFunction;
 
 // Definition of an OpenGL Framebuffer object (FBO) for internal use.
@@ -160,10 +201,66 @@ typedef struct PsychFBO {
 	int						width;		// Width of FBO.
 	int						height;		// Height of FBO.
 	int						multisample; // Multisampling level of FBO: 0 == No multisampling. > 0 means Multisampled.
+	GLenum					format;		// Internal format of color buffer, if the FBO owns its color buffer. Zero if the color buffer belongs to someone else.
 } PsychFBO;
 
+// Definition of a texture object for recycling via the texture pool of an onscreen window, see PsychCreateTexture().
+// Also used as the key to match requests for new textures against pooled ones:
+typedef struct PsychTexturePoolEntry {
+	GLuint					textureNumber;		// OpenGL texture handle. Zero for none.
+	GLenum					texturetarget;		// Texture target (GL_TEXTURE_2D or GL_TEXTURE_RECTANGLE_EXT).
+	GLint					internalFormat;		// OpenGL internal format of texture.
+	int						width;				// Real width of texture object, e.g., power-of-two width.
+	int						height;				// Real height of texture object.
+	int						bpc;				// Bits per color component, as detected at creation time.
+	size_t					sizeBytes;			// Estimated memory consumption.
+} PsychTexturePoolEntry;
+
+// Definition of a pixel buffer object for asynchronous Screen('GetImage') readback, and of the pending readback into it:
+typedef struct PsychReadbackPBO {
+	GLuint					pbo;				// Buffer handle, zero if not yet created.
+	size_t					size;				// Allocated size of buffer in bytes.
+	psych_bool				pending;			// TRUE = Buffer contains a queued readback which was not yet returned.
+	int						width;				// Width of queued image in pixels.
+	int						height;				// Height of queued image in pixels.
+	int						nrchannels;			// Number of channels to return.
+	psych_bool				floatprecision;		// Return as double matrix instead of uint8 matrix?
+} PsychReadbackPBO;
+
 // Typedefs for WindowRecord in WindowBank.h
 
+// Maximum number of async flip requests which can be queued via the 'queueDepth' argument of Screen('AsyncFlipBegin'):
+#define kPsychMaxQueuedFlips	8
+
+// Flip timing bookkeeping of an onscreen window, as updated by PsychFlipWindowBuffers(). While async flips
+// are queued, the flipper thread works on a private copy of this state, which is published into the
+// windowRecord by the master thread when it collects the results of each flip:
+typedef struct PsychFlipTimingState {
+	double					time_at_last_vbl;
+	double					rawtime_at_swapcompletion;
+	double					postflip_vbltimestamp;
+	double					osbuiltin_swaptime;
+	int						nr_missed_deadlines;
+	int						flipCount;
+	double					IFIRunningSum;		// Only read by PsychFlipWindowBuffers(), not updated.
+	int						nrIFISamples;		// Only read by PsychFlipWindowBuffers(), not updated.
+} PsychFlipTimingState;
+
+// One queued async flip request: Its parameters, its finalized stimulus image and the results of the flip:
+typedef struct PsychQueuedFlipInfo {
+	int						state;				// 0 = Free, 1 = Queued, 2 = Executing, 3 = Finished, but results not yet collected.
+	int						vbl_synclevel;
+	int						dont_clear;
+	double					flipwhen;
+	int						beamPosAtFlip;
+	double					miss_estimate;
+	double					time_at_flipend;
+	double					time_at_onset;
+	double					vbl_timestamp;
+	PsychFlipTimingState	timing;				// Timing state of the window after this flip.
+	PsychFBO*				fbo;				// FBO with the finalized image for this request. Allocated at first use of the slot.
+} PsychQueuedFlipInfo;
+
 // This support structure for async flips is supported on all non-Windows platforms, aka all Unix platforms:
 // It gets attached to the asyncFlipInfo* of a windowRecord whenever async flips are used.
 typedef struct PsychFlipInfoStruct {
@@ -185,6 +282,14 @@ typedef struct PsychFlipInfoStruct {
 	psych_thread			flipperThread;		// Thread handle for background flipping thread.
 	psych_mutex				performFlipLock;	// Primary lock.
 	psych_condition			flipperGoGoGo;		// Signalling condition variable to trigger execution of a flip request by the flipper thread.
+
+	// FIFO of queued async flip requests, see PsychFlipWindowBuffersIndirect(). Only used if queueDepth > 1:
+	int						queueDepth;			// Max. number of outstanding queued requests for current AsyncFlipBegin. 1 = Classic single async flip.
+	int						queueHead;			// Index of oldest outstanding request in queue[].
+	int						queueCount;			// Number of outstanding requests, ie. queued, executing or finished but not yet collected.
+	psych_bool				queueWarningDone;	// Warning about unsupported queueing printed already?
+	PsychFlipTimingState	flipperTiming;		// Private timing state of the flipper thread while executing queued flips.
+	PsychQueuedFlipInfo		queue[kPsychMaxQueuedFlips];
 } PsychFlipInfoStruct;
 
 
@@ -284,6 +389,10 @@ typedef struct _PsychWindowRecordType_{
 		GLint				textureLookupShader;	// Optional GLSL handle for nearest neighbour texture drawing shader.
 		GLint				textureByteAligned;		// 0 = No knowledge about byte alignment of texture data. > 1, texture rows are x byte aligned.
 		GLint				texturePlanarShader[4]; // Optional GLSL program handles for shaders to apply to planar storage textures - 4 handles for 4 possible channel counts.
+		GLuint				textureUploadBuffer;	// Pixel buffer object mapped as textureMemory for asynchronous upload by PsychCreateTexture(), zero if none.
+		GLsync				textureUploadFence;		// Fence of a pending asynchronous upload, checked on first use of the texture. NULL if none.
+		psych_bool			texturePoolable;		// TRUE = Texture object can be taken from, and returned to, the texture pool of the parent window.
+		PsychTexturePoolEntry texturePoolKey;		// Properties of texture object, for return to the pool on close.
 
 	//line stipple attributes, for windows not textures.
 	GLushort				stipplePattern;
@@ -343,6 +452,9 @@ typedef struct _PsychWindowRecordType_{
 	int						imagingMode;							// Master mode switch for imaging and callback hook pipeline.
 	PtrPsychHookFunction	HookChain[MAX_SCREEN_HOOKS];			// Array of pointers to the hook-chains for different hooks.
 	psych_bool					HookChainEnabled[MAX_SCREEN_HOOKS];		// Array of Booleans to en-/disable single chains temporarily.
+	PtrPsychHookFunction*	HookChainCompiled[MAX_SCREEN_HOOKS];	// Precompiled flat arrays of the slots of each hook-chain, in chain order.
+	int						HookChainSlotCount[MAX_SCREEN_HOOKS];	// Number of slots in each precompiled hook-chain.
+	int						HookChainPingPongs[MAX_SCREEN_HOOKS];	// Number of Builtin:FlipFBOs ping-pong swaps in each precompiled hook-chain.
 
 	// Indices into our FBO table: The special value -1 means: Don't use.
 	int						drawBufferFBO[2];						// Storage for drawing FBOs: These are the targets of all drawing operations before
@@ -366,9 +478,43 @@ typedef struct _PsychWindowRecordType_{
 	PsychFBO*				fboTable[MAX_FBOTABLE_SLOTS];			// This array contains pointers to the FBO structs which are referenced by the indices above.
 	int						fboCount;								// This contains the number of FBO's in fboTable.
 	
-	// Cached handles for display lists -- used for recycling in compute intense drawing functions:
-	GLuint					fillOvalDisplayList;
-	GLuint					frameOvalDisplayList;
+	// Cached GL objects -- used for recycling in compute intense drawing functions:
+	GLint					ovalShader;							// GLSL program for analytic drawing of ovals: 0 = Not yet created, -1 = Unsupported.
+	GLint					pointSizeShader;					// GLSL program for per-dot sizes in Screen('DrawDots'): 0 = Not yet created, -1 = Unsupported.
+	GLuint					streamVBO;							// Streaming vertex buffer for float vertex data of batch drawing functions, 0 if unused.
+
+	// Ring of pixel buffer objects for asynchronous texture uploads, see PsychMapTextureUploadBuffer():
+	GLuint					textureUploadPBO[PSYCH_TEXTURE_UPLOAD_PBOS];		// Buffer handles, zero if not yet created.
+	size_t					textureUploadPBOSize[PSYCH_TEXTURE_UPLOAD_PBOS];	// Allocated size of each buffer in bytes.
+	GLsync					textureUploadPBOFence[PSYCH_TEXTURE_UPLOAD_PBOS];	// Fence of last upload from each buffer, NULL if none pending.
+	int						textureUploadPBOSlot;								// Next buffer to use.
+
+	// Pool of texture objects of closed textures for recycling, see PsychCreateTexture(). Ordered from least to most recently released:
+	PsychTexturePoolEntry*	texturePool;			// Array of pooled objects, or NULL.
+	int						texturePoolCount;		// Number of pooled objects.
+	int						texturePoolCapacity;	// Number of allocated slots in texturePool.
+	size_t					texturePoolBytes;		// Estimated memory consumption of all pooled objects.
+	double					texturePoolHits;		// Statistics: Creations served from the pool,
+	double					texturePoolMisses;		// creations not served from the pool,
+	double					texturePoolEvictions;	// and objects deleted to stay within the pool size budget.
+
+	// Memory accounting for framebuffer objects of the imaging pipeline and of child offscreen windows and textures,
+	// and pool of FBO's of closed offscreen windows and textures for recycling, see PsychCreatePooledFBO():
+	size_t					fboBytes;				// Estimated memory consumption of all FBO's in use.
+	size_t					fboPeakBytes;			// Peak of fboBytes + fboPoolBytes.
+	size_t					fboAliasedBytes;		// Memory saved by sharing FBO's between imaging pipeline stages.
+	PsychFBO**				fboPool;				// Array of pooled FBO's, ordered from least to most recently released, or NULL.
+	int						fboPoolCount;			// Number of pooled FBO's.
+	int						fboPoolCapacity;		// Number of allocated slots in fboPool.
+	size_t					fboPoolBytes;			// Estimated memory consumption of all pooled FBO's.
+	double					fboPoolHits;			// Statistics: Creations served from the pool,
+	double					fboPoolMisses;			// creations not served from the pool,
+	double					fboPoolEvictions;		// and FBO's deleted to stay within the pool size budget.
+
+	// Ring of pixel buffer objects for asynchronous Screen('GetImage') readback:
+	PsychReadbackPBO		readbackPBO[PSYCH_READBACK_PBOS];
+	int						readbackPBODepth;		// Number of buffers in use, i.e., queue depth. Zero if async readback wasn't used yet.
+	int						readbackPBOSlot;		// Next buffer to use for queueing a readback.
 
 	// Pointer to double-array of auxiliary parameters for bound shaders - or NULL by default.
 	double*					auxShaderParams;
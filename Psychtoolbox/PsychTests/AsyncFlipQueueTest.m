@@ -0,0 +1,115 @@
+function AsyncFlipQueueTest(screenid, queueDepth, nrframes)
+% AsyncFlipQueueTest([screenid=max][, queueDepth=3][, nrframes=300])
+%
+% Test queueing of multiple async flips via the 'queueDepth' argument of
+% Screen('AsyncFlipBegin').
+%
+% Opens a window with the imaging pipeline enabled, as queueing needs it,
+% and then schedules 'nrframes' stimulus frames for presentation at
+% consecutive video refresh cycles. Up to 'queueDepth' flips are kept
+% pending at any time: Each new frame is drawn and queued via
+% Screen('AsyncFlipBegin') while older frames are still waiting for their
+% presentation deadline. Screen('AsyncFlipEnd') returns the results of
+% the oldest pending flip, so frames are collected in the order they were
+% queued.
+%
+% You should see a smooth horizontal motion of a white bar over a
+% flickering gray background. Stuttering motion or irregular flicker means
+% that presentation deadlines were missed.
+%
+% At the end, the number of missed deadlines is printed and the measured
+% stimulus onset intervals and deadline misses are plotted.
+%
+% screenid   = Which screen to run on. Default = max screen.
+% queueDepth = Maximum number of pending async flips, 2 to 8. Default = 3.
+% nrframes   = Number of frames to present. Default = 300.
+%
+
+% History:
+% 10/17/2026 Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(queueDepth)
+    queueDepth = 3;
+end
+
+if nargin < 3 || isempty(nrframes)
+    nrframes = 300;
+end
+
+if queueDepth < 2 || queueDepth > 8
+    error('queueDepth must be between 2 and 8.');
+end
+
+AssertOpenGL;
+
+try
+    % Queued async flips need the imaging pipeline with FBO backed drawbuffers:
+    PsychImaging('PrepareConfiguration');
+    PsychImaging('AddTask', 'General', 'UseFastOffscreenWindows');
+    win = PsychImaging('OpenWindow', screenid, 0);
+    [w, h] = Screen('WindowSize', win);
+    ifi = Screen('GetFlipInterval', win);
+
+    onsets = zeros(1, nrframes);
+    missed = zeros(1, nrframes);
+    deadlines = zeros(1, nrframes);
+    nqueued = 0;
+    ncollected = 0;
+
+    % Start with a synchronous flip to get a timebase:
+    vbl = Screen('Flip', win);
+
+    for i = 1:nrframes
+        % Draw frame i while up to queueDepth - 1 older frames are pending:
+        Screen('FillRect', win, mod(i, 2) * 64 + 64);
+        x = mod(i * 8, w - 50);
+        Screen('FillRect', win, 255, [x, 0, x + 50, h]);
+
+        % Queue it for presentation in the i'th refresh cycle from now.
+        % This blocks if queueDepth flips are already pending:
+        deadlines(i) = vbl + (i - 0.5) * ifi;
+        Screen('AsyncFlipBegin', win, deadlines(i), 0, 0, 0, queueDepth);
+        nqueued = nqueued + 1;
+
+        % Collect results of all finished flips, without blocking:
+        while ncollected < nqueued
+            [vblt, onset, flipt, miss] = Screen('AsyncFlipCheckEnd', win);
+            if vblt == 0
+                break;
+            end
+            ncollected = ncollected + 1;
+            onsets(ncollected) = onset;
+            missed(ncollected) = miss;
+        end
+    end
+
+    % Wait for all still pending flips, oldest first:
+    while ncollected < nqueued
+        [vblt, onset, flipt, miss] = Screen('AsyncFlipEnd', win);
+        ncollected = ncollected + 1;
+        onsets(ncollected) = onset;
+        missed(ncollected) = miss;
+    end
+
+    sca;
+catch
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+fprintf('Presented %i frames with queueDepth %i: %i deadlines missed.\n', nrframes, queueDepth, sum(missed > 0));
+fprintf('Mean stimulus onset interval %f msecs, expected %f msecs.\n', mean(diff(onsets)) * 1000, ifi * 1000);
+
+figure;
+subplot(2, 1, 1);
+plot(diff(onsets) * 1000);
+title('Stimulus onset intervals [msecs]');
+subplot(2, 1, 2);
+plot(missed);
+title('Deadline miss estimates [secs], positive = missed');
+
+return;
@@ -9,11 +9,13 @@
 %   AlphaMultiplicationTest         - Test alpha multiplication by 0 and 1 for perfect precision.
 %   AlphaMultiplicationAccuracyTest - Test precision of alpha multiplication for values between 0 and 1.
 %   AnalyzeTiming                   - Analyze timing logs from FlipTimingWithRTBoxPhotoDiodeTest.
+%   AsyncFlipQueueTest              - Test queueing of multiple async flips via Screen('AsyncFlipBegin') 'queueDepth'.
 %   AsyncFlipTest                   - Test robustness and performance of Screen('AsyncFlipBegin') et al.
 %   BatchAnalyzeTiming              - Batch version of AnalyzeTiming.
 %   CIEConeFundamentalsTest         - Test/demonstrate routines for producing cone fundamentals according to CIE 170-1:2006
 %   ConvolutionKernelTest           - Test routine for correctness, accuracy and speed of PTB imaging convolution shaders.
 %   DeinterlacerTest                - Simple correctness test for GLSL video image deinterlacer. INCOMPLETE.
+%   DrawDotsLinesBenchmark          - Benchmark DrawDots and DrawLines with common vs. individual dot sizes and line widths.
 %   DrawingIntoTexturesTest         - Tests if using a texture as an offscreen window, i.e., for drawing, works.
 %   DriftTexturePrecisionTest       - Test subpixel accuracy of texture interpolators: What is the smallest
 %                                     fraction of a pixel that one can scroll, using built-in bilinear interpolation?
@@ -37,6 +39,7 @@
 %   HIDIntervalTest                 - Sample HID keyboard and mouse, plot distribution of detected event times.
 %   HighColorPrecisionDrawingTest   - Test drawing precision of a variety of Screen() functions, esp. wrt. high precision framebuffers.
 %   HighPrecisionLuminanceOutputDriversImagingPipelineTest - Test precision of a variety of high precision luminance device output drivers.
+%   ImagingPipelineCPluginTest      - Test native C plugins for 'CFunction' slots of the imaging pipeline.
 %   JavaClockTest                   - Timing test of clock used by Java functions (e.g. GetChar)
 %   KeyboardLatencyTest             - Get a feeling for keyboard and mouse latency via some sound-based measurement procedure.
 %   LabLuvTest                      - Test routines that convert to CIELAB and CIELUV.
@@ -53,6 +56,7 @@
 %   PsychHIDTest                    - PsychHID MEX file for HID-compliant USB devices.
 %   PupilDiameterTest               - Test functions that compute pupil diameter from luminance.
 %   PsychPortAudioDataPixxTimingTest - Test PsychPortAudio's timing with a DataPixx device and a audio line cable.
+%   PsychPortAudioSlaveMixBenchmark - Benchmark PsychPortAudio master device mixing of many slave devices.
 %   PsychPortAudioTimingTest        - Testsignal generator for test of PsychPortAudios timing with external measurement equipment.
 %   QuestTest                       - Some Quest simulations, more elaborate than QuestDemo.
 %   ResolutionTest                  - Use Screen Resolutions to print table of display resolutions.
@@ -0,0 +1,113 @@
+function results = DrawDotsLinesBenchmark(nrdots, nrframes, screenid)
+% results = DrawDotsLinesBenchmark([nrdots=50000] [, nrframes=300] [, screenid=max])
+%
+% Benchmark for Screen('DrawDots') and Screen('DrawLines') with a common
+% size for all primitives versus individual sizes per dot or line.
+%
+% Opens a window on screen 'screenid' and draws 'nrdots' randomly placed
+% dots of random color for 'nrframes' frames in each of the following
+% modes:
+%
+% 1. DrawDots with one common dot size.
+% 2. DrawDots with an individual size for each dot. On graphics hardware
+%    with GLSL vertex shader support, this is drawn with a single draw call.
+% 3. DrawDots with an individual size for each dot, submitted as one call
+%    per dot. This mimics the old per primitive drawing loop and is only
+%    run for a few frames, as it is very slow.
+% 4. DrawLines with one common line width.
+% 5. DrawLines with an individual width for each line, drawn as one batch
+%    of quads.
+%
+% Flips are executed without sync to the vertical retrace, so the results
+% reflect drawing speed, not the refresh rate of the display. Prints the
+% average duration of a frame in each mode and returns a struct array
+% 'results' with one element per mode.
+%
+
+% History:
+% 10/17/2026 Written.
+
+if nargin < 1 || isempty(nrdots)
+    nrdots = 50000;
+end
+
+if nargin < 2 || isempty(nrframes)
+    nrframes = 300;
+end
+
+if nargin < 3 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+AssertOpenGL;
+
+try
+    win = Screen('OpenWindow', screenid, 0);
+    [w, h] = Screen('WindowSize', win);
+    Screen('BlendFunction', win, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    % Random positions, colors and sizes, lines with a length of up to 20 pixels:
+    xy = [rand(1, nrdots) * w ; rand(1, nrdots) * h];
+    colors = uint8(rand(3, nrdots) * 255);
+    sizes = 1 + rand(1, nrdots) * 9;
+    lxy = zeros(2, 2 * nrdots);
+    lxy(:, 1:2:end) = xy;
+    lxy(:, 2:2:end) = xy + (rand(2, nrdots) - 0.5) * 20;
+    lcolors = uint8(zeros(3, 2 * nrdots));
+    lcolors(:, 1:2:end) = colors;
+    lcolors(:, 2:2:end) = colors;
+
+    modes = {'DrawDots, common size', 'DrawDots, per-dot sizes', 'DrawDots, one call per dot', ...
+             'DrawLines, common width', 'DrawLines, per-line widths'};
+    results = [];
+
+    for mode = 1:length(modes)
+        % The one call per dot mode is very slow, so only run a few frames of it:
+        if mode == 3
+            n = min(nrframes, 3);
+        else
+            n = nrframes;
+        end
+
+        % Warmup and sync to GPU:
+        Screen('Flip', win);
+        tstart = GetSecs;
+
+        for frame = 1:n
+            switch mode
+                case 1
+                    Screen('DrawDots', win, xy, 5, colors);
+                case 2
+                    Screen('DrawDots', win, xy, sizes, colors);
+                case 3
+                    for i = 1:nrdots
+                        Screen('DrawDots', win, xy(:, i), sizes(i), colors(:, i));
+                    end
+                case 4
+                    Screen('DrawLines', win, lxy, 5, lcolors);
+                case 5
+                    Screen('DrawLines', win, lxy, sizes, lcolors);
+            end
+
+            Screen('Flip', win, 0, 0, 2);
+        end
+
+        % Wait for GPU to finish all drawing:
+        Screen('DrawingFinished', win, 0, 1);
+        telapsed = GetSecs - tstart;
+
+        r.mode = modes{mode};
+        r.frames = n;
+        r.msecsPerFrame = 1000 * telapsed / n;
+        results = [results, r]; %#ok<AGROW>
+
+        fprintf('%s: %d primitives, %f msecs per frame.\n', r.mode, nrdots, r.msecsPerFrame);
+    end
+
+    sca;
+catch %#ok<CTCH>
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+return;
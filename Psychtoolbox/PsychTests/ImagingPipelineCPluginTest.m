@@ -0,0 +1,83 @@
+function ImagingPipelineCPluginTest(screenid)
+% ImagingPipelineCPluginTest([screenid=max])
+%
+% Test native C plugins for 'CFunction' slots of the imaging pipeline, as
+% attached via Screen('HookFunction', ..., 'AppendCFunction', ...).
+%
+% Uses the example plugin libptbimagingplugin_example, whose source code
+% and build instructions are in the PsychSourceGL/Cohorts/ImagingPluginExample/
+% folder. It needs to be built and copied into the PsychBasic/PsychPlugins/
+% folder before running this test.
+%
+% The plugin gets attached as output formatter of an onscreen window and
+% multiplies the color channels of the final image by the gains given in
+% its configuration string. The test draws a known color, reads back the
+% output image and checks that the gains were applied. It then replaces
+% the plugin slot by one with different gains, to verify that detaching
+% and re-attaching a plugin works.
+%
+% screenid = Which screen to run on. Default = max screen.
+%
+
+% History:
+% 10/17/2026 Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+AssertOpenGL;
+
+if IsWin
+    pluginName = 'libptbimagingplugin_example.dll';
+elseif IsOSX
+    pluginName = 'libptbimagingplugin_example.dylib';
+else
+    pluginName = 'libptbimagingplugin_example.so.1';
+end
+
+if ~exist([PsychtoolboxRoot 'PsychBasic' filesep 'PsychPlugins' filesep pluginName], 'file')
+    error('Example plugin %s not found in PsychBasic/PsychPlugins/. Build it first, see PsychSourceGL/Cohorts/ImagingPluginExample/.', pluginName);
+end
+
+color = [200 100 50];
+
+try
+    win = Screen('OpenWindow', screenid, 0, [], [], [], [], [], mor(kPsychNeedFastBackingStore, kPsychNeedOutputConversion));
+
+    % First plugin instance, halves the red channel:
+    Screen('HookFunction', win, 'AppendCFunction', 'FinalOutputFormattingBlit', 'ExampleGain', pluginName, 'Gain=0.5 1 1');
+    Screen('HookFunction', win, 'Enable', 'FinalOutputFormattingBlit');
+    checkOutput(win, color, color .* [0.5 1 1]);
+
+    % Replace by a second instance, which must get its own fresh configuration:
+    slot = Screen('HookFunction', win, 'Query', 'FinalOutputFormattingBlit', 'ExampleGain');
+    Screen('HookFunction', win, 'Remove', 'FinalOutputFormattingBlit', slot);
+    Screen('HookFunction', win, 'AppendCFunction', 'FinalOutputFormattingBlit', 'ExampleGain', pluginName, 'Gain=1 0.5 2');
+    checkOutput(win, color, min(color .* [1 0.5 2], 255));
+
+    sca;
+catch
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+fprintf('ImagingPipelineCPluginTest: Native C plugin interface works.\n');
+
+return;
+
+function checkOutput(win, color, expected)
+% Draw 'color', run the imaging pipeline and compare its output to 'expected':
+Screen('FillRect', win, color);
+Screen('DrawingFinished', win, 0, 1);
+img = double(Screen('GetImage', win, [0 0 16 16], 'backBuffer'));
+Screen('Flip', win);
+
+for c = 1:3
+    err = max(max(abs(img(:, :, c) - expected(c))));
+    if err > 1
+        error('Output of plugin wrong in channel %i: Expected %f, got error of %f.', c, expected(c), err);
+    end
+end
+
+return;
@@ -0,0 +1,129 @@
+function results = PsychPortAudioSlaveMixBenchmark(nrslaves, freq, nrchannels, duration, deviceid, nrworkers)
+% results = PsychPortAudioSlaveMixBenchmark([nrslaves=32] [, freq=96000] [, nrchannels=8] [, duration=5] [, deviceid=[]] [, nrworkers=0])
+%
+% Microbenchmark for the mixing code of PsychPortAudio master devices.
+%
+% Opens a master device with 'nrchannels' output channels on audio device
+% 'deviceid' and attaches 'nrslaves' playback slave devices to it. The
+% slaves use a mix of channel layouts: Identity mapping to all master
+% channels, stereo pairs, contiguous blocks of four channels and scattered
+% channel mappings. Each slave plays white noise at a very low volume in an
+% endless loop, so all slaves are active in every callback of the master.
+%
+% The benchmark is run once for each type of mixing kernel supported by
+% PsychPortAudio, see help for PsychPortAudio('EngineTunables?'), parameter
+% 'mixerSIMD'. For each type, it samples the 'CPULoad' of the master for
+% 'duration' seconds and prints the average load, as well as the resulting
+% average processing time per callback.
+%
+% If 'nrworkers' is greater than zero, the slaves are rendered in parallel
+% on 'nrworkers' worker threads, see PsychPortAudio('EngineTunables?'),
+% parameter 'slaveWorkerThreads'.
+%
+% Returns a struct array 'results' with one element per kernel type.
+%
+
+% History:
+% 10/17/2026 Written.
+
+if nargin < 1 || isempty(nrslaves)
+    nrslaves = 32;
+end
+
+if nargin < 2 || isempty(freq)
+    freq = 96000;
+end
+
+if nargin < 3 || isempty(nrchannels)
+    nrchannels = 8;
+end
+
+if nargin < 4 || isempty(duration)
+    duration = 5;
+end
+
+if nargin < 5
+    deviceid = [];
+end
+
+if nargin < 6 || isempty(nrworkers)
+    nrworkers = 0;
+end
+
+if nrchannels < 4
+    error('nrchannels must be at least 4 for this benchmark.');
+end
+
+InitializePsychSound(1);
+
+% Query default and best supported mixer kernel type and number of worker threads:
+[yi, me, lc, as, defaultSIMD, oldworkers] = PsychPortAudio('EngineTunables');
+
+kernelNames = {'Plain C', 'SSE2', 'AVX'};
+results = [];
+
+for simd = 0:defaultSIMD
+    % Select kernel type. Only allowed while no device is open:
+    PsychPortAudio('EngineTunables', [], [], [], [], simd, nrworkers);
+
+    % Open master for playback in low-latency mode:
+    pamaster = PsychPortAudio('Open', deviceid, 1+8, 1, freq, nrchannels);
+    PsychPortAudio('Start', pamaster, 0, 0, 1);
+
+    slaves = zeros(1, nrslaves);
+    for i = 1:nrslaves
+        switch mod(i - 1, 4)
+            case 0
+                % Identity mapping to all master channels:
+                selectchannels = 1:nrchannels;
+            case 1
+                % Stereo pair:
+                base = 2 * mod(i, floor(nrchannels / 2));
+                selectchannels = base + [1, 2];
+            case 2
+                % Contiguous block of 4 channels:
+                base = mod(i, nrchannels - 3);
+                selectchannels = base + (1:4);
+            case 3
+                % Scattered channels:
+                selectchannels = [nrchannels, 1];
+        end
+
+        slaves(i) = PsychPortAudio('OpenSlave', pamaster, 1, length(selectchannels), selectchannels);
+        PsychPortAudio('FillBuffer', slaves(i), 0.001 * (rand(length(selectchannels), freq) - 0.5));
+        PsychPortAudio('Start', slaves(i), 0, 0, 1);
+    end
+
+    % Let things settle:
+    WaitSecs(0.5);
+
+    % Sample master load:
+    loads = [];
+    tend = GetSecs + duration;
+    while GetSecs < tend
+        s = PsychPortAudio('GetStatus', pamaster);
+        loads(end+1) = s.CPULoad; %#ok<AGROW>
+        WaitSecs(0.1);
+    end
+
+    s = PsychPortAudio('GetStatus', pamaster);
+
+    % Shut down all slaves and the master:
+    PsychPortAudio('Close');
+
+    r.kernel = kernelNames{simd + 1};
+    r.workers = nrworkers;
+    r.cpuLoad = mean(loads);
+    r.bufferSize = s.BufferSize;
+    r.xruns = s.XRuns;
+    r.msecsPerCallback = 1000 * r.cpuLoad * s.BufferSize / s.SampleRate;
+    results = [results, r]; %#ok<AGROW>
+
+    fprintf('%d slaves, %d channels, %d Hz, %d workers, %s kernels: CPULoad %f, %f msecs per callback of %d frames, %d xruns.\n', ...
+            nrslaves, nrchannels, freq, nrworkers, r.kernel, r.cpuLoad, r.msecsPerCallback, r.bufferSize, r.xruns);
+end
+
+% Restore default kernel type and worker threads:
+PsychPortAudio('EngineTunables', [], [], [], [], defaultSIMD, oldworkers);
+
+return;